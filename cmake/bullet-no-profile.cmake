@@ -0,0 +1,3 @@
+# included at the end of project() of Bullet Physics to disable its built-in profiler (CProfileManager)
+# that is shared in the process without locking, since nanoem steps multiple worlds concurrently
+add_definitions(-DBT_NO_PROFILE=1)
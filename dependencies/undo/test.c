@@ -176,6 +176,36 @@ undoTestDeleteOldestCommandAtFill(void)
     GREATEST_PASS();
 }
 
+GREATEST_TEST
+undoTestDropOldestCommand(void)
+{
+    undo_stack_t *stack = undoStackCreate();
+    undo_command_t *command = undoCommandCreate();
+    int destroyed_count = 0;
+    GREATEST_ASSERT_FALSE(undoStackDropOldestCommand(stack));
+    GREATEST_ASSERT_EQ(NULL, undoStackGetOldestCommand(stack));
+    undoCommandSetOnDestroyCallback(command, undoTestHandleOnDestroyOldest);
+    undoCommandSetOpaqueData(command, &destroyed_count);
+    undoStackPushCommand(stack, command);
+    undoStackPushCommand(stack, undoCommandCreate());
+    undoStackPushCommand(stack, undoCommandCreate());
+    undoStackUndo(stack);
+    GREATEST_ASSERT_EQ(command, undoStackGetOldestCommand(stack));
+    GREATEST_ASSERT(undoStackDropOldestCommand(stack));
+    GREATEST_ASSERT(command != undoStackGetOldestCommand(stack));
+    GREATEST_ASSERT_EQ(1, destroyed_count);
+    GREATEST_ASSERT_EQ(2, undoStackCountCommands(stack));
+    GREATEST_ASSERT_EQ(1, undoStackGetOffset(stack));
+    GREATEST_ASSERT_EQ(undo_true, undoStackCanRedo(stack));
+    GREATEST_ASSERT(undoStackDropOldestCommand(stack));
+    GREATEST_ASSERT_EQ(0, undoStackGetOffset(stack));
+    GREATEST_ASSERT_FALSE(undoStackDropOldestCommand(stack));
+    GREATEST_ASSERT_EQ(1, undoStackCountCommands(stack));
+    GREATEST_ASSERT_EQ(undo_true, undoStackIsDirty(stack));
+    undoStackDestroy(stack);
+    GREATEST_PASS();
+}
+
 GREATEST_TEST
 undoTestClearStack(void)
 {
@@ -230,6 +260,7 @@ GREATEST_SUITE(undo)
     GREATEST_RUN_TEST(undoTestUndoRedo);
     GREATEST_RUN_TEST(undoTestClearUndo);
     GREATEST_RUN_TEST(undoTestDeleteOldestCommandAtFill);
+    GREATEST_RUN_TEST(undoTestDropOldestCommand);
     GREATEST_RUN_TEST(undoTestClearStack);
     GREATEST_RUN_TEST(undoTestPushPop);
 }
@@ -273,6 +273,31 @@ undoStackClear(undo_stack_t *stack)
     stack->is_dirty = 0;
 }
 
+undo_bool_t APIENTRY
+undoStackDropOldestCommand(undo_stack_t *stack)
+{
+    undo_command_t *command;
+    undo_bool_t rc = 0;
+    if (undoStackCanUndo(stack)) {
+        command = stack->commands[0];
+        memmove(&stack->commands[0], &stack->commands[1], (stack->num_commands - 1) * sizeof(stack->commands[0]));
+        stack->commands[--stack->num_commands] = NULL;
+        stack->current_index--;
+        /* saved state becomes unreachable when it was before the dropped command */
+        stack->saved_index--;
+        undoCommandDestroy(command);
+        undoStackUpdateDirty(stack);
+        rc = 1;
+    }
+    return rc;
+}
+
+const undo_command_t *APIENTRY
+undoStackGetOldestCommand(const undo_stack_t *stack)
+{
+    return undo_is_not_null(stack) && stack->num_commands > 0 ? stack->commands[0] : NULL;
+}
+
 int APIENTRY
 undoStackCountCommands(const undo_stack_t *stack)
 {
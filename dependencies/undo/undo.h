@@ -206,6 +206,10 @@ UNDO_DECL_API void APIENTRY
 undoStackSetOffset(undo_stack_t *stack, int value);
 UNDO_DECL_API void APIENTRY
 undoStackClear(undo_stack_t *stack);
+UNDO_DECL_API undo_bool_t APIENTRY
+undoStackDropOldestCommand(undo_stack_t *stack);
+UNDO_DECL_API const undo_command_t *APIENTRY
+undoStackGetOldestCommand(const undo_stack_t *stack);
 UNDO_DECL_API int APIENTRY
 undoStackCountCommands(const undo_stack_t *stack);
 UNDO_DECL_API int APIENTRY
@@ -0,0 +1,34 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../test/common.h"
+
+#include "emapp/BezierCurve.h"
+#include "nanoem/benchmark/common.h"
+
+using namespace nanoem;
+
+TEST_CASE("benchmark_beziercurve_value", "[emapp][benchmark]")
+{
+    static const nanoem_rsize_t kNumCurves = 64, kNumSteps = 1024;
+    benchmark::Random random(0x62657a69u);
+    std::vector<std::unique_ptr<BezierCurve>> curves;
+    for (nanoem_rsize_t i = 0; i < kNumCurves; i++) {
+        const Vector2U8 c0(random.next() % 128, random.next() % 128), c1(random.next() % 128, random.next() % 128);
+        curves.emplace_back(new BezierCurve(c0, c1, nanoem_frame_index_t(1 + random.next() % 300)));
+    }
+    benchmark::setThroughput(kNumCurves * kNumSteps, 0);
+    BENCHMARK("BezierCurve::value")
+    {
+        nanoem_f32_t sum = 0;
+        for (const auto &curve : curves) {
+            for (nanoem_rsize_t i = 0; i < kNumSteps; i++) {
+                sum += curve->value(i / nanoem_f32_t(kNumSteps - 1));
+            }
+        }
+        return sum;
+    };
+}
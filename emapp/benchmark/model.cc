@@ -0,0 +1,109 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../test/common.h"
+
+#include "emapp/Model.h"
+#include "emapp/model/Bone.h"
+#include "emapp/model/Morph.h"
+#include "nanoem/benchmark/common.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static Model *
+createSyntheticModel(Project *project, const benchmark::ModelParameters &parameters)
+{
+    nanoem_mutable_model_t *mutableModel = benchmark::generateModel(project->unicodeStringFactory(), parameters);
+    benchmark::Bytes bytes;
+    benchmark::saveModel(mutableModel, bytes);
+    nanoemMutableModelDestroy(mutableModel);
+    Model *model = project->createModel();
+    Error error;
+    if (model->load(bytes.data(), bytes.size(), error)) {
+        model->setupAllBindings();
+        model->upload();
+        model->setVisible(true);
+        project->addModel(model);
+    }
+    else {
+        WARN(error.reasonConstString());
+        project->destroyModel(model);
+        model = nullptr;
+    }
+    return model;
+}
+
+static void
+randomizeAllBones(Model *model, benchmark::Random &random)
+{
+    nanoem_rsize_t numBones;
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(model->data(), &numBones);
+    for (nanoem_rsize_t i = 0; i < numBones; i++) {
+        const Vector3 axis(random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1));
+        const nanoem_f32_t angle = random.uniform(-1, 1);
+        model::Bone::cast(bones[i])->setLocalUserOrientation(
+            glm::angleAxis(angle, glm::normalize(axis + Vector3(0, 0, 1e-3f))));
+    }
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("benchmark_model_perform_all_bones_transform", "[emapp][benchmark]")
+{
+    TestScope scope;
+    ProjectPtr o = scope.createProject();
+    const benchmark::ModelParameters parameters(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0);
+    Model *model = createSyntheticModel(o->m_project, parameters);
+    REQUIRE(model);
+    benchmark::Random random(parameters.m_seed);
+    randomizeAllBones(model, random);
+    benchmark::setThroughput(parameters.m_numBones, 0);
+    BENCHMARK("Model::performAllBonesTransform")
+    {
+        model->performAllBonesTransform();
+    };
+}
+
+TEST_CASE("benchmark_model_deform_all_morphs", "[emapp][benchmark]")
+{
+    TestScope scope;
+    ProjectPtr o = scope.createProject();
+    const benchmark::ModelParameters parameters(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0);
+    Model *model = createSyntheticModel(o->m_project, parameters);
+    REQUIRE(model);
+    benchmark::Random random(parameters.m_seed);
+    nanoem_rsize_t numMorphs;
+    nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(model->data(), &numMorphs);
+    for (nanoem_rsize_t i = 0; i < numMorphs; i++) {
+        model::Morph::cast(morphs[i])->setWeight(random.uniform(0, 1));
+    }
+    benchmark::setThroughput(parameters.m_numMorphs * parameters.m_numMorphVertices, 0);
+    BENCHMARK("Model::deformAllMorphs")
+    {
+        model->deformAllMorphs(false);
+    };
+}
+
+TEST_CASE("benchmark_model_skinning", "[emapp][benchmark]")
+{
+    TestScope scope;
+    ProjectPtr o = scope.createProject();
+    const benchmark::ModelParameters parameters(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0);
+    Model *model = createSyntheticModel(o->m_project, parameters);
+    REQUIRE(model);
+    benchmark::Random random(parameters.m_seed);
+    randomizeAllBones(model, random);
+    model->performAllBonesTransform();
+    benchmark::setThroughput(parameters.m_numVertices, 0);
+    BENCHMARK("Model::updateStagingVertexBuffer")
+    {
+        model->markStagingVertexBufferDirty();
+        model->updateStagingVertexBuffer();
+    };
+}
@@ -0,0 +1,106 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../test/common.h"
+
+#include "emapp/internal/VideoEncodingPipeline.h"
+#include "nanoem/benchmark/common.h"
+
+using namespace nanoem;
+using namespace internal;
+
+namespace {
+
+static const nanoem_u32_t kWidth = 1920;
+static const nanoem_u32_t kHeight = 1080;
+static const nanoem_frame_index_t kNumFrames = 30;
+
+/* stands in for an encoder plugin by touching every byte of the frame */
+class NullEncoder : public VideoEncodingPipeline::IEncoder {
+public:
+    NullEncoder()
+        : m_checksum(0)
+    {
+    }
+    bool
+    encodeAudioFrame(nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) NANOEM_DECL_OVERRIDE
+    {
+        BX_UNUSED_2(pts, error);
+        m_checksum += digest(data, size);
+        return true;
+    }
+    bool
+    encodeVideoFrame(nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) NANOEM_DECL_OVERRIDE
+    {
+        BX_UNUSED_2(pts, error);
+        m_checksum += digest(data, size);
+        return true;
+    }
+    static nanoem_u32_t
+    digest(const nanoem_u8_t *data, size_t size)
+    {
+        nanoem_u32_t value = 2166136261u;
+        for (size_t i = 0; i < size; i++) {
+            value = (value ^ data[i]) * 16777619u;
+        }
+        return value;
+    }
+    nanoem_u32_t m_checksum;
+};
+
+/* stands in for rendering and reading back the frame */
+static void
+renderFrame(ByteArray &bytes, nanoem_frame_index_t pts)
+{
+    bytes.resize(kWidth * kHeight * 4);
+    nanoem_u32_t *pixels = reinterpret_cast<nanoem_u32_t *>(bytes.data());
+    for (nanoem_u32_t i = 0, numPixels = kWidth * kHeight; i < numPixels; i++) {
+        pixels[i] = (i + pts) * 2654435761u;
+    }
+    VideoEncodingPipeline::swizzleRGBA8(bytes.data(), bytes.size());
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("benchmark_video_encoding_sequential", "[emapp][benchmark]")
+{
+    benchmark::setThroughput(kNumFrames, nanoem_u64_t(kNumFrames) * kWidth * kHeight * 4);
+    BENCHMARK_ADVANCED("encode 30 frames in lockstep")(Catch::Benchmark::Chronometer meter)
+    {
+        NullEncoder encoder;
+        ByteArray bytes;
+        Error error;
+        meter.measure([&encoder, &bytes, &error] {
+            for (nanoem_frame_index_t i = 0; i < kNumFrames; i++) {
+                renderFrame(bytes, i);
+                encoder.encodeVideoFrame(i, bytes.data(), bytes.size(), error);
+            }
+            return encoder.m_checksum;
+        });
+    };
+}
+
+TEST_CASE("benchmark_video_encoding_pipelined", "[emapp][benchmark]")
+{
+    benchmark::setThroughput(kNumFrames, nanoem_u64_t(kNumFrames) * kWidth * kHeight * 4);
+    BENCHMARK_ADVANCED("encode 30 frames with the encoder thread")(Catch::Benchmark::Chronometer meter)
+    {
+        NullEncoder encoder;
+        Error error;
+        meter.measure([&encoder, &error] {
+            VideoEncodingPipeline pipeline(&encoder, VideoEncodingPipeline::kDefaultNumFrames);
+            pipeline.start();
+            for (nanoem_frame_index_t i = 0; i < kNumFrames; i++) {
+                VideoEncodingPipeline::Frame *frame = pipeline.acquire();
+                frame->m_pts = i;
+                renderFrame(frame->m_videoData, i);
+                pipeline.submit(frame);
+            }
+            pipeline.finish(error);
+            return encoder.m_checksum;
+        });
+    };
+}
@@ -13,6 +13,7 @@
 #include "emapp/BoundingBox.h"
 #include "emapp/IDrawable.h"
 #include "emapp/IEffect.h"
+#include "emapp/MotionKeyframeCursor.h"
 #include "emapp/URI.h"
 
 #include "nanodxm/nanodxm.h"
@@ -223,6 +224,7 @@ private:
     BoundingBox m_boundingBox;
     UserData m_userData;
     StringMap m_annotations;
+    MotionKeyframeCursor m_motionCursor;
     sg_buffer m_vertexBuffer;
     sg_buffer m_indexBuffer;
     Vector3List m_normals;
@@ -24,6 +24,7 @@ public:
         kHighDPIViewportModeMaxEnum
     };
     static const int kUndoSoftLimitDefaultValue;
+    static const int kUndoMemoryBudgetDefaultValue;
     static const int kGFXBufferPoolSizeDefaultValue;
     static const int kGFXImagePoolSizeDefaultValue;
     static const int kGFXShaderPoolSizeDefaultValue;
@@ -59,6 +60,8 @@ public:
     void setGFXUniformBufferSize(int value);
     int undoSoftLimit() const NANOEM_DECL_NOEXCEPT;
     void setUndoSoftLimit(int value);
+    int undoMemoryBudget() const NANOEM_DECL_NOEXCEPT;
+    void setUndoMemoryBudget(int value);
     bool isModelEditingEnabled() const NANOEM_DECL_NOEXCEPT;
     void setModelEditingEnabled(bool value);
     bool isAnalyticsEnabled() const NANOEM_DECL_NOEXCEPT;
@@ -67,6 +70,8 @@ public:
     void setResettingAnalyticsUUIDRequired(bool value);
     bool isSkinDeformAcceleratorEnabled() const NANOEM_DECL_NOEXCEPT;
     void setSkinDeformAcceleratorEnabled(bool value);
+    bool isPhysicsIslandEnabled() const NANOEM_DECL_NOEXCEPT;
+    void setPhysicsIslandEnabled(bool value);
     bool isCrashReportEnabled() const NANOEM_DECL_NOEXCEPT;
     void setCrashReportEnabled(bool value);
     bool isEffectEnabled() const NANOEM_DECL_NOEXCEPT;
@@ -46,13 +46,22 @@ public:
     Archiver(ISeekableWriter *writer);
     ~Archiver() NANOEM_DECL_NOEXCEPT;
 
+    static bool isIncompressible(const nanoem_u8_t *data, nanoem_rsize_t size) NANOEM_DECL_NOEXCEPT;
+
     bool open(Error &error);
     bool close(Error &error);
+    /* compressed on worker threads and written in order at flush, so an error may be reported by later calls */
     bool addEntry(const Entry &entry, const ByteArray &bytes, Error &error);
     bool addEntry(const Entry &entry, IReader *reader, Error &error);
+    bool flush(Error &error);
     bool findEntry(const String &location, Entry &entry, Error &error) const;
     bool extract(const Entry &entry, ByteArray &bytes, Error &error) const;
     bool extract(const Entry &entry, IWriter *writer, Error &error) const;
+    /*
+     * entries are located by m_path and read in order but inflated on worker threads. missing or broken ones become
+     * empty and all of them are reported to error without stopping extraction of the rest
+     */
+    bool extractAll(const EntryList &entries, ByteArrayList &bytesList, Error &error) const;
     EntryList allEntries(Error &error) const;
     EntryList entries(const String &entry, Error &error) const;
 
@@ -31,20 +31,17 @@ public:
 
 private:
     typedef tinystl::vector<Vector2, nanoem::TinySTLAllocator> PointList;
-    struct Hash {
-        union {
-            nanoem_u64_t c0x : 7;
-            nanoem_u64_t c0y : 7;
-            nanoem_u64_t c1x : 7;
-            nanoem_u64_t c1y : 7;
-            nanoem_u64_t interval : 36;
-        };
-        nanoem_u64_t value;
-    };
     static void splitBezierCurve(const PointList &points, nanoem_f32_t t, PointList &left, PointList &right);
     static const Vector2 kP0;
     static const Vector2 kP1;
-    PointList m_parameters;
+    static const int kNumSamples = 64;
+    nanoem_f32_t solve(
+        nanoem_f32_t x, nanoem_f32_t t, nanoem_f32_t lower, nanoem_f32_t upper) const NANOEM_DECL_NOEXCEPT;
+    Vector2 m_a;
+    Vector2 m_b;
+    Vector2 m_c;
+    /* parameter t at uniformly distributed x to start solving the curve */
+    nanoem_f32_t m_samples[kNumSamples + 1];
     Vector2U8 m_c0;
     Vector2U8 m_c1;
     nanoem_frame_index_t m_interval;
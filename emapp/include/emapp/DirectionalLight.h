@@ -9,6 +9,7 @@
 #define NANOEM_EMAPP_DIRECTIONALLIGHT_H_
 
 #include "emapp/ILight.h"
+#include "emapp/MotionKeyframeCursor.h"
 
 struct undo_stack_t;
 
@@ -46,6 +47,7 @@ public:
 private:
     Project *m_project;
     undo_stack_t *m_undoStack;
+    MotionKeyframeCursor m_motionCursor;
     Vector3 m_color;
     Vector3 m_direction;
     bool m_translucent;
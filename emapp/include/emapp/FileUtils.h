@@ -10,13 +10,12 @@
 
 #include "bx/readerwriter.h"
 
-#include "emapp/Forward.h"
+#include "emapp/URI.h"
 
 namespace nanoem {
 
 class Error;
 class ITranslator;
-class URI;
 
 class ISeekable {
 public:
@@ -111,6 +110,39 @@ private:
     nanoem_i64_t m_offset;
 };
 
+/*
+ * maps a regular file read-only to borrow its bytes without copying, or falls back to reading whole of the file.
+ * only files on fixed local storage are mapped since truncating the mapped file or removing its storage raises
+ * SIGBUS (or EXCEPTION_IN_PAGE_ERROR) on reading the bytes, and files on removable or network storage are read
+ * instead. the risk remains when another process truncates a local file while it's being loaded.
+ */
+class MappedFileReader NANOEM_DECL_SEALED : public IFileReader, private NonCopyable {
+public:
+    MappedFileReader(const ITranslator *translator);
+    ~MappedFileReader() NANOEM_DECL_NOEXCEPT_OVERRIDE;
+
+    bool open(const URI &fileURI, Error &error) NANOEM_DECL_OVERRIDE;
+    bool close(Error &error) NANOEM_DECL_OVERRIDE;
+    nanoem_i32_t read(void *data, nanoem_i32_t size, Error &error) NANOEM_DECL_OVERRIDE;
+    nanoem_rsize_t size() NANOEM_DECL_OVERRIDE;
+    nanoem_i64_t seek(nanoem_i64_t offset, SeekType whence, Error &error) NANOEM_DECL_OVERRIDE;
+    URI fileURI() const NANOEM_DECL_OVERRIDE;
+
+    const nanoem_u8_t *bytes() const NANOEM_DECL_NOEXCEPT;
+    bool isMapped() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    bool map(const URI &fileURI) NANOEM_DECL_NOEXCEPT;
+    void unmap() NANOEM_DECL_NOEXCEPT;
+
+    const ITranslator *m_translator;
+    URI m_fileURI;
+    ByteArray m_fallbackBytes;
+    void *m_address;
+    nanoem_rsize_t m_mappedSize;
+    nanoem_i64_t m_offset;
+};
+
 class MemoryWriter NANOEM_DECL_SEALED : public ISeekableWriter, private NonCopyable {
 public:
     MemoryWriter(ByteArray *bytes);
@@ -138,6 +170,8 @@ public:
 
     static nanoem_u64_t timestamp(const char *filePath) NANOEM_DECL_NOEXCEPT;
     static nanoem_u64_t timestamp(const URI &fileURI) NANOEM_DECL_NOEXCEPT;
+    static nanoem_u64_t fileSize(const char *filePath) NANOEM_DECL_NOEXCEPT;
+    static nanoem_u64_t fileSize(const URI &fileURI) NANOEM_DECL_NOEXCEPT;
     static bool exists(const char *filePath) NANOEM_DECL_NOEXCEPT;
     static bool exists(const URI &fileURI) NANOEM_DECL_NOEXCEPT;
     static bool deleteFile(const char *filePath);
@@ -57,6 +57,7 @@ public:
     virtual void addMorphKeyframes(
         const nanoem_model_morph_t *morph, nanoem_frame_index_t start, nanoem_frame_index_t end) = 0;
     virtual void addSelfShadowKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end) = 0;
+    virtual void shiftAllKeyframes(nanoem_u32_t flags, nanoem_frame_index_t from, int delta) = 0;
 };
 
 } /* namespace nanoem */
@@ -9,6 +9,7 @@
 #define NANOEM_EMAPP_IMAGELOADER_H_
 
 #include "emapp/IImageView.h"
+#include "emapp/internal/DecodedImageCache.h"
 
 #include "bimg/bimg.h"
 
@@ -20,6 +21,10 @@ class IFileReader;
 class Project;
 class URI;
 
+namespace internal {
+class ParallelTaskDispatcher;
+} /* namespace internal */
+
 enum {
     APNG_DISPOSE_OP_NONE = 0,
     APNG_DISPOSE_OP_BACKGROUND,
@@ -131,45 +136,46 @@ public:
     static void fill1x1TransparentPixelImage(sg_image_desc &desc) NANOEM_DECL_NOEXCEPT;
     static void flipImage(nanoem_u8_t *source, nanoem_u32_t width, nanoem_u32_t height, nanoem_u32_t bpp);
 
+    /*
+     * Collects images of the drawable to decode all of them on worker threads at once, and each of them is uploaded
+     * on the render thread later in the added order. Decoded images are shared through the cache of the loader.
+     */
+    class Batch NANOEM_DECL_SEALED : private NonCopyable {
+    public:
+        Batch(ImageLoader *loader, IDrawable *drawable);
+        ~Batch() NANOEM_DECL_NOEXCEPT;
+
+        void add(const URI &fileURI, sg_wrap wrap, nanoem_u32_t flags);
+        void add(const ByteArray &bytes, const String &filename, sg_wrap wrap, nanoem_u32_t flags);
+        void decodeAll();
+        IImageView *upload(nanoem_rsize_t index, Error &error);
+        nanoem_rsize_t numItems() const NANOEM_DECL_NOEXCEPT;
+
+    private:
+        struct Item;
+        typedef tinystl::vector<Item *, TinySTLAllocator> ItemList;
+        static void handleDecodingItem(void *opaque, size_t index);
+
+        ImageLoader *m_loader;
+        IDrawable *m_drawable;
+        ItemList m_items;
+    };
+
     ImageLoader(const Project *project);
     ~ImageLoader();
 
     IImageView *load(const URI &fileURI, IDrawable *drawable, sg_wrap wrap, nanoem_u32_t flags, Error &error);
     IImageView *decode(const ByteArray &bytes, const String &filename, IDrawable *drawable, sg_wrap wrap,
         nanoem_u32_t flags, Error &error);
+    internal::DecodedImageCache *decodedImageCache() NANOEM_DECL_NOEXCEPT;
 
 private:
     struct ImmutableImageContainer {
-        ImmutableImageContainer(const String &name, const nanoem_u8_t *dataPtr, const size_t dataSize,
-            const Vector2UI16 &size, sg_wrap wrap, int anisotropy, nanoem_u32_t flags)
+        ImmutableImageContainer(
+            const String &name, const nanoem_u8_t *dataPtr, const size_t dataSize, nanoem_u32_t flags)
             : m_name(name)
             , m_dataPtr(dataPtr)
             , m_dataSize(dataSize)
-            , m_size(size)
-            , m_wrap(wrap)
-            , m_anisotropy(anisotropy)
-            , m_flags(flags)
-        {
-        }
-        ImmutableImageContainer(const String &name, const ByteArray &bytes, const Vector2UI16 &size, sg_wrap wrap,
-            int anisotropy, nanoem_u32_t flags)
-            : m_name(name)
-            , m_dataPtr(bytes.data())
-            , m_dataSize(bytes.size())
-            , m_size(size)
-            , m_wrap(wrap)
-            , m_anisotropy(anisotropy)
-            , m_flags(flags)
-        {
-        }
-        ImmutableImageContainer(const String &name, const bimg::ImageContainer *containerPtr, sg_wrap wrap,
-            int anisotropy, nanoem_u32_t flags)
-            : m_name(name)
-            , m_dataPtr(static_cast<const nanoem_u8_t *>(containerPtr->m_data))
-            , m_dataSize(containerPtr->m_size)
-            , m_size(containerPtr->m_width, containerPtr->m_height)
-            , m_wrap(wrap)
-            , m_anisotropy(anisotropy)
             , m_flags(flags)
         {
         }
@@ -179,13 +185,9 @@ private:
         const String m_name;
         const nanoem_u8_t *m_dataPtr;
         const size_t m_dataSize;
-        const Vector2UI16 m_size;
-        const sg_wrap m_wrap;
-        const int m_anisotropy;
         const nanoem_u32_t m_flags;
     };
-    static IImageView *decodeImageContainer(
-        const ImmutableImageContainer &textureData, IDrawable *drawable, Error &error);
+    static internal::DecodedImage *decodeImageContainer(const ImmutableImageContainer &container, Error &error);
     static void generateMipmapImagesRGBA32F(const bimg::ImageContainer *container, int numMips, bool flip,
         ByteArrayList &mipmapPayloads, sg_image_desc &descRef);
     static void generateMipmapImagesRGBA8(const bimg::ImageContainer *container, int numMips, bool flip,
@@ -193,7 +195,17 @@ private:
     static void ensureRGBA8ImageData(const bimg::ImageContainer *decodedImageContainer, bool needsRGBA8Conversion,
         ByteArray &decodedRGBA8, sg_image_desc &desc);
 
+    nanoem_u32_t resolveFlags(nanoem_u32_t flags) const NANOEM_DECL_NOEXCEPT;
+    const internal::DecodedImage *decodeFile(const URI &fileURI, const String &filename, nanoem_u32_t flags,
+        internal::ParallelTaskDispatcher *dispatcher, Error &error);
+    const internal::DecodedImage *decodeCached(const String &filename, const nanoem_u8_t *dataPtr,
+        nanoem_rsize_t dataSize, nanoem_u32_t flags, internal::ParallelTaskDispatcher *dispatcher, Error &error);
+    IImageView *uploadDecodedImage(
+        const String &filename, const internal::DecodedImage *image, sg_wrap wrap, IDrawable *drawable) const;
+
     const Project *m_project;
+    internal::DecodedImageCache m_decodedImageCache;
+    internal::ParallelTaskDispatcher *m_dispatcher;
 };
 
 } /* namespace nanoem */
@@ -13,6 +13,7 @@
 #include "emapp/IDrawable.h"
 #include "emapp/IEffect.h"
 #include "emapp/ITranslator.h"
+#include "emapp/MotionKeyframeCursor.h"
 #include "emapp/PhysicsEngine.h"
 #include "emapp/URI.h"
 #include "emapp/model/Bone.h"
@@ -46,6 +47,8 @@ class Vertex;
 
 namespace internal {
 class LineDrawer;
+class ParallelTaskDispatcher;
+class SkinningBatchTester;
 } /* namespace internal */
 
 namespace model {
@@ -53,6 +56,7 @@ struct BindPose;
 class IGizmo;
 class IVertexWeightPainter;
 class ISkinDeformer;
+class Validator;
 } /* namespace model */
 
 class Model NANOEM_DECL_SEALED : public IDrawable, private NonCopyable {
@@ -76,6 +80,20 @@ public:
         kEditActionTypeCreateTargetBone,
         kEditActionTypeMaxEnum
     };
+    enum EditObjectType {
+        kEditObjectTypeFirstEnum,
+        kEditObjectTypeModel = kEditObjectTypeFirstEnum,
+        kEditObjectTypeVertex,
+        kEditObjectTypeFace,
+        kEditObjectTypeMaterial,
+        kEditObjectTypeBone,
+        kEditObjectTypeMorph,
+        kEditObjectTypeLabel,
+        kEditObjectTypeRigidBody,
+        kEditObjectTypeJoint,
+        kEditObjectTypeSoftBody,
+        kEditObjectTypeMaxEnum
+    };
     enum TransformCoordinateType {
         kTransformCoordinateTypeFirstEnum,
         kTransformCoordinateTypeGlobal = kTransformCoordinateTypeFirstEnum,
@@ -109,7 +127,7 @@ public:
         VertexUnit() NANOEM_DECL_NOEXCEPT;
         ~VertexUnit() NANOEM_DECL_NOEXCEPT;
         void setUVA(const model::Vertex *vertex) NANOEM_DECL_NOEXCEPT;
-        void performSkinning(nanoem_f32_t edgeSize, const model::Vertex *vertex) NANOEM_DECL_NOEXCEPT;
+        void updateAttributes(nanoem_f32_t edgeSize, const model::Vertex *vertex) NANOEM_DECL_NOEXCEPT;
         void prepareSkinning(const model::Material::BoneIndexHashMap *indexHashMap, const model::Vertex *vertex)
             NANOEM_DECL_NOEXCEPT;
         static bx::simd128_t swizzleWeight(const model::Vertex *vertex, nanoem_rsize_t index) NANOEM_DECL_NOEXCEPT;
@@ -203,6 +221,14 @@ public:
     void destroy();
     void synchronizeMotion(const Motion *motion, nanoem_frame_index_t frameIndex, nanoem_f32_t amount,
         PhysicsEngine::SimulationTimingType timing);
+    void synchronizeModelMotion(const Motion *motion, nanoem_frame_index_t frameIndex);
+    void synchronizeSkeletonMotion(const Motion *motion, nanoem_frame_index_t frameIndex, nanoem_f32_t amount,
+        PhysicsEngine::SimulationTimingType timing);
+    void synchronizeRigidBodyMotion(
+        const Motion *motion, nanoem_frame_index_t frameIndex, PhysicsEngine::SimulationTimingType timing);
+    void resolveAllMotionTracks(const Motion *motion);
+    void resolveAllBezierCurves(const Motion *motion, nanoem_frame_index_t frameIndex);
+    void resolveAllConstraintJoints();
     void synchronizeAllRigidBodiesTransformFeedbackFromSimulation(PhysicsEngine::RigidBodyFollowBoneType followType);
     void synchronizeAllRigidBodiesTransformFeedbackToSimulation();
     void rebuildAllVertexBuffers(bool enableSkinFactory);
@@ -214,6 +240,9 @@ public:
     bool isStagingVertexBufferDirty() const NANOEM_DECL_NOEXCEPT;
     void markStagingVertexBufferDirty();
     void updateStagingVertexBuffer();
+    bool beginStagingVertexBufferUpdate();
+    void performStagingVertexBufferUpdate();
+    void endStagingVertexBufferUpdate();
     void resetLanguage();
     void registerUpdateActiveBoneTransformCommand(const Vector3 &translation, const Quaternion &orientation);
     void registerResetBoneSetTransformCommand(
@@ -230,7 +259,15 @@ public:
     bool isFaceEditingMasked(nanoem_rsize_t index) const NANOEM_DECL_NOEXCEPT;
     void setFaceEditingMasked(nanoem_rsize_t index, bool value);
     void pushUndo(undo_command_t *command);
+    nanoem_u32_t editGeneration() const NANOEM_DECL_NOEXCEPT;
+    nanoem_u32_t lastEditGeneration(EditObjectType type) const NANOEM_DECL_NOEXCEPT;
+    nanoem_u32_t allObjectsEditGeneration() const NANOEM_DECL_NOEXCEPT;
+    void getAllEditedVertexObjects(nanoem_u32_t generation, model::Vertex::List &vertices) const;
+    void markObjectEdited(EditObjectType type, const void *object);
+    void markAllObjectsEdited();
+    void markAllObjectsEditedIfUntracked(const undo_stack_t *stack, nanoem_u32_t generation);
     void solveAllConstraints();
+    void setAllConstraintIterationResultsCaptured(bool value);
 
     void reset() NANOEM_DECL_OVERRIDE;
     void draw(DrawType type) NANOEM_DECL_OVERRIDE;
@@ -295,6 +332,7 @@ public:
     ICamera *localCamera() NANOEM_DECL_NOEXCEPT;
     const IModelObjectSelection *selection() const NANOEM_DECL_NOEXCEPT;
     IModelObjectSelection *selection() NANOEM_DECL_NOEXCEPT;
+    model::Validator *validator();
     nanoem_u16_t handle() const NANOEM_DECL_NOEXCEPT_OVERRIDE;
     String name() const NANOEM_DECL_OVERRIDE;
     const char *nameConstString() const NANOEM_DECL_NOEXCEPT_OVERRIDE;
@@ -311,6 +349,8 @@ public:
     const nanoem_model_t *data() const NANOEM_DECL_NOEXCEPT;
     nanoem_model_t *data() NANOEM_DECL_NOEXCEPT;
     model::Bone *sharedFallbackBone();
+    void invalidateAllSkinningBatches();
+    void invalidateAllMorphVertexDeltas();
     const nanoem_model_bone_t *activeBone() const NANOEM_DECL_NOEXCEPT;
     void setActiveBone(const nanoem_model_bone_t *value);
     const nanoem_model_constraint_t *activeConstraint() const NANOEM_DECL_NOEXCEPT;
@@ -431,6 +471,8 @@ public:
     tinystl::unordered_map<const nanoem_model_label_t *, bool, TinySTLAllocator> checkedState;
 
 private:
+    /* compares the skinning batches with the per vertex skinning in the test */
+    friend class internal::SkinningBatchTester;
     struct LoadingImageItem;
     typedef tinystl::vector<sg::LineVertexUnit, TinySTLAllocator> LineVertexList;
     typedef tinystl::vector<LoadingImageItem *, TinySTLAllocator> LoadingImageItemList;
@@ -440,18 +482,31 @@ private:
     typedef tinystl::unordered_map<const nanoem_model_bone_t *, const nanoem_model_constraint_t *, TinySTLAllocator>
         ConstraintMap;
     typedef tinystl::unordered_map<nanoem_u32_t, Vector2UI16, TinySTLAllocator> ImageSizeMap;
+    typedef tinystl::unordered_map<const nanoem_model_vertex_t *, nanoem_u32_t, TinySTLAllocator>
+        VertexEditGenerationMap;
     typedef tinystl::pair<int, model::Vertex::List> BoneVertexPair;
+    typedef tinystl::vector<nanoem_u32_t, TinySTLAllocator> SkinningIndexList;
+    struct SkinningBatch {
+        nanoem_model_vertex_type_t m_type;
+        nanoem_rsize_t m_offset;
+        nanoem_rsize_t m_size;
+        bool m_stale;
+    };
+    typedef tinystl::vector<SkinningBatch, TinySTLAllocator> SkinningBatchList;
     struct ParallelSkinningTaskData {
         ParallelSkinningTaskData(Model *model, const IDrawable::DrawType type, nanoem_f32_t edgeSizeFactor);
         ~ParallelSkinningTaskData() NANOEM_DECL_NOEXCEPT;
         const Model *m_model;
         const IDrawable::DrawType m_drawType;
         const nanoem_f32_t m_edgeSizeScaleFactor;
-        model::Material::BoneIndexHashMap *m_boneIndices;
         nanoem_u8_t *m_output;
         nanoem_model_material_t *const *m_materials;
         nanoem_model_vertex_t *const *m_vertices;
         nanoem_rsize_t m_numVertices;
+        SkinningBatch *m_batches;
+        const nanoem_u8_t *m_bones;
+        const nanoem_u32_t *m_vertexIndices;
+        const nanoem_u32_t *m_boneIndices;
     };
     struct DrawArrayBuffer {
         DrawArrayBuffer();
@@ -493,7 +548,9 @@ private:
     typedef void (*DispatchParallelTasksIterator)(void *, size_t);
 
     static int compareBoneVertexList(const void *a, const void *b);
-    static void handlePerformSkinningVertexTransform(void *opaque, size_t index);
+    static void handlePerformSkinningBatchTransform(void *opaque, size_t index);
+    static void performSkinningBatchVertex(
+        const ParallelSkinningTaskData *s, SkinningBatch &batch, nanoem_rsize_t offset) NANOEM_DECL_NOEXCEPT;
     static void setCommonPipelineDescription(sg_pipeline_desc &desc);
 
     const IEffect *activeEffect(const model::Material *material) const NANOEM_DECL_NOEXCEPT;
@@ -508,13 +565,20 @@ private:
     void splitBonesPerMaterial(model::Material::BoneIndexHashMap &boneIndexHash) const;
     void bindConstraint(nanoem_model_constraint_t *constraintPtr);
     void applyAllBonesTransform(PhysicsEngine::SimulationTimingType timing);
+    void applyBoneTransform(const nanoem_model_bone_t *bonePtr, model::Bone *bone);
+    bool isBoneTransformDirty(const nanoem_model_bone_t *bonePtr, const model::Bone *bone) const NANOEM_DECL_NOEXCEPT;
     void internalClear();
     void internalSetOutsideParent(const nanoem_model_bone_t *key, const StringPair &value);
     void initializeAllStagingVertexBuffers();
     void initializeStagingIndexBuffer();
     void initializeVertexBufferByteArray();
     void createAllStagingVertexBuffers();
-    void internalUpdateStagingVertexBuffer(nanoem_u8_t *ptr, nanoem_rsize_t numVertices);
+    void synchronizeAllSoftBodiesTransformFeedbackFromSimulation(nanoem_u8_t *ptr, nanoem_rsize_t numVertices);
+    void synchronizeAllSoftBodiesTransformFeedbackToSimulation(nanoem_u8_t *ptr, nanoem_rsize_t numVertices);
+    void rebuildAllSkinningBatches(nanoem_model_vertex_t *const *vertices, nanoem_rsize_t numVertices);
+    void performAllSkinningBatches(nanoem_u8_t *ptr, nanoem_rsize_t numVertices);
+    void updateAllSkinningBones();
+    bool containsSkinningBatch(nanoem_model_vertex_type_t type) const NANOEM_DECL_NOEXCEPT;
     void clearAllLoadingImageItems();
     void setAllPhysicsObjectsEnabled(bool value);
     void predeformMorph(const nanoem_model_morph_t *morphPtr);
@@ -562,6 +626,7 @@ private:
     model::ISkinDeformer *m_skinDeformer;
     model::IGizmo *m_gizmo;
     model::IVertexWeightPainter *m_vertexWeightPainter;
+    model::Validator *m_validator;
     OffscreenPassiveRenderTargetEffectMap m_offscreenPassiveRenderTargetEffects;
     DrawArrayBuffer m_drawAllVertexNormals;
     DrawArrayBuffer m_drawAllVertexPoints;
@@ -577,6 +642,10 @@ private:
     const nanoem_model_material_t *m_activeMaterialPtr;
     const nanoem_model_bone_t *m_hoveredBonePtr;
     ByteArray m_vertexBufferData;
+    ByteArray m_skinningBones;
+    SkinningBatchList m_skinningBatches;
+    SkinningIndexList m_skinningVertexIndices;
+    SkinningIndexList m_skinningBoneIndices;
     VertexIndexList m_faceStates;
     tinystl::pair<const nanoem_model_bone_t *, const nanoem_model_bone_t *> m_activeBonePairPtr;
     tinystl::pair<IEffect *, IEffect *> m_activeEffectPtrPair;
@@ -590,6 +659,7 @@ private:
     StringList m_redoBoneNames;
     StringList m_redoMorphNames;
     model::Bone::OutsideParentMap m_outsideParents;
+    VertexEditGenerationMap m_vertexEditGenerations;
     FileEntityMap m_imageURIs;
     FileEntityMap m_attachmentURIs;
     BoneBoundRigidBodyMap m_boneBoundRigidBodies;
@@ -601,6 +671,7 @@ private:
     BoundingBox m_boundingBox;
     UserData m_userData;
     StringMap m_annotations;
+    MotionKeyframeCursor m_modelKeyframeCursor;
     sg_buffer m_vertexBuffers[2];
     sg_buffer m_indexBuffer;
     Vector4 m_edgeColor;
@@ -612,9 +683,14 @@ private:
     String m_comment;
     String m_canonicalName;
     nanoem_u32_t m_states;
+    nanoem_u64_t m_boneTransformSequence;
+    nanoem_u32_t m_objectEditGenerations[kEditObjectTypeMaxEnum];
+    nanoem_u32_t m_allObjectsEditGeneration;
+    nanoem_u32_t m_editGeneration;
     nanoem_f32_t m_edgeSizeScaleFactor;
     nanoem_f32_t m_opacity;
-    void *m_dispatchParallelTaskQueue;
+    internal::ParallelTaskDispatcher *m_parallelTaskDispatcher;
+    nanoem_u8_t *m_stagingVertexBufferPtr;
     mutable int m_countVertexSkinningNeeded;
     int m_stageVertexBufferIndex;
 };
@@ -214,6 +214,7 @@ public:
     nanoem_u16_t handle() const NANOEM_DECL_NOEXCEPT;
     bool isDirty() const NANOEM_DECL_NOEXCEPT;
     void setDirty(bool value);
+    nanoem_u32_t generation() const NANOEM_DECL_NOEXCEPT;
 
     static nanoem_f32_t coefficient(const nanoem_motion_accessory_keyframe_t *prev,
         const nanoem_motion_accessory_keyframe_t *next, nanoem_frame_index_t frameIndex) NANOEM_DECL_NOEXCEPT;
@@ -231,8 +232,6 @@ public:
         nanoem_motion_bone_keyframe_interpolation_type_t index, nanoem_f32_t value) const;
 
 private:
-    typedef tinystl::unordered_map<const nanoem_motion_bone_keyframe_t *, BezierCurve *, TinySTLAllocator>
-        KeyframeBezierCurveMap;
     static nanoem_f32_t coefficient(nanoem_frame_index_t prevFrameIndex, nanoem_frame_index_t nextFrameIndex,
         nanoem_frame_index_t frameIndex) NANOEM_DECL_NOEXCEPT;
     static void copyAccessoryOutsideParent(const nanoem_motion_accessory_keyframe_t *keyframe,
@@ -248,12 +247,11 @@ private:
     Project *m_project;
     IMotionKeyframeSelection *m_selection;
     nanoem_motion_t *m_opaque;
-    mutable BezierCurve::Map m_bezierCurvesData;
-    mutable KeyframeBezierCurveMap m_keyframeBezierCurves;
     StringMap m_annotations;
     URI m_fileURI;
     nanoem_motion_format_type_t m_formatType;
     nanoem_u16_t m_handle;
+    nanoem_u32_t m_generation;
     bool m_dirty;
 };
 
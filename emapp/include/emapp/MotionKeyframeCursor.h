@@ -0,0 +1,37 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_MOTIONKEYFRAMECURSOR_H_
+#define NANOEM_EMAPP_MOTIONKEYFRAMECURSOR_H_
+
+#include "emapp/Forward.h"
+
+namespace nanoem {
+
+class Motion;
+
+/*
+ * Remembers the last keyframe pair found in a track to find the next pair by a few steps while playing back.
+ * The cursor is reset when another motion is given or the motion has been changed since the last lookup.
+ */
+class MotionKeyframeCursor NANOEM_DECL_SEALED {
+public:
+    MotionKeyframeCursor() NANOEM_DECL_NOEXCEPT;
+    ~MotionKeyframeCursor() NANOEM_DECL_NOEXCEPT;
+
+    nanoem_motion_keyframe_cursor_t *resolve(const Motion *motion) NANOEM_DECL_NOEXCEPT;
+    void reset() NANOEM_DECL_NOEXCEPT;
+
+private:
+    nanoem_motion_keyframe_cursor_t m_opaque;
+    const Motion *m_motion;
+    nanoem_u32_t m_generation;
+};
+
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_MOTIONKEYFRAMECURSOR_H_ */
@@ -10,6 +10,7 @@
 
 #include "emapp/BezierCurve.h"
 #include "emapp/ICamera.h"
+#include "emapp/MotionKeyframeCursor.h"
 
 struct undo_stack_t;
 
@@ -88,13 +89,10 @@ private:
     nanoem_f32_t bezierCurve(const nanoem_motion_camera_keyframe_t *prev, const nanoem_motion_camera_keyframe_t *next,
         nanoem_motion_camera_keyframe_interpolation_type_t index, nanoem_f32_t value) const;
 
-    typedef tinystl::unordered_map<const nanoem_motion_camera_keyframe_t *, BezierCurve *, TinySTLAllocator>
-        KeyframeBezierCurveMap;
-    mutable BezierCurve::Map m_bezierCurvesData;
-    mutable KeyframeBezierCurveMap m_keyframeBezierCurves;
     Project *m_project;
     undo_stack_t *m_undoStack;
     StringPair m_outsideParent;
+    MotionKeyframeCursor m_motionCursor;
     TransformCoordinateType m_transformCoordinateType;
     Matrix4x4 m_viewMatrix;
     Matrix4x4 m_projectionMatrix;
@@ -69,6 +69,16 @@ public:
     const nanoem_physics_world_t *worldOpaque() const NANOEM_DECL_NOEXCEPT;
     nanoem_physics_world_t *worldOpaque();
 
+    /*
+     * Islands give each model its own world to step all of them concurrently. Rigid bodies and joints are moved
+     * to the world of the model owning them and models following each other are merged into the same island.
+     * Models having soft bodies are kept in the shared world since soft bodies are bound to the world created with.
+     */
+    bool isIslandEnabled() const NANOEM_DECL_NOEXCEPT;
+    void setIslandEnabled(bool value);
+    void mergeIslands(const nanoem_model_t *left, const nanoem_model_t *right);
+    nanoem_rsize_t numIslands() const NANOEM_DECL_NOEXCEPT;
+
     nanoem_physics_rigid_body_t *createRigidBody(const nanoem_model_rigid_body_t *value, nanoem_status_t &status);
     nanoem_physics_motion_state_t *motionState(const nanoem_physics_rigid_body_t *value);
     void getWorldTransform(const nanoem_physics_rigid_body_t *body, nanoem_f32_t *value) NANOEM_DECL_NOEXCEPT;
@@ -13,6 +13,7 @@
 #include "emapp/IEffect.h"
 #include "emapp/ITranslator.h"
 #include "emapp/Motion.h"
+#include "emapp/MotionKeyframeCursor.h"
 #include "emapp/PhysicsEngine.h"
 #include "emapp/PixelFormat.h"
 #include "emapp/TimelineSegment.h"
@@ -27,6 +28,7 @@
 #include "bimg/bimg.h"
 
 struct Nanoem__Application__Command;
+struct Nanoem__Project__Project;
 
 struct undo_command_t;
 struct undo_stack_t;
@@ -65,6 +67,7 @@ namespace effect {
 struct GlobalUniform;
 class RenderPassScope;
 class RenderTargetColorImageContainer;
+class SourceCache;
 } /* namespace effect */
 
 namespace model {
@@ -80,6 +83,12 @@ namespace internal {
 class BlitPass;
 class ClearPass;
 class DebugDrawer;
+class FileContentDigestCache;
+class ParallelTaskDispatcher;
+class PhysicsBakeCache;
+namespace project {
+class RedoJournal;
+} /* namespace project */
 } /* namespace internal */
 
 class Project NANOEM_DECL_SEALED : private NonCopyable {
@@ -205,6 +214,7 @@ public:
     typedef tinystl::vector<IDrawable *, TinySTLAllocator> DrawableList;
     typedef tinystl::vector<ITrack *, TinySTLAllocator> TrackList;
     typedef tinystl::vector<Model *, TinySTLAllocator> ModelList;
+    typedef tinystl::vector<nanoem_rsize_t, TinySTLAllocator> ModelTransformLevelList;
     typedef tinystl::vector<Accessory *, TinySTLAllocator> AccessoryList;
     typedef tinystl::vector<Motion *, TinySTLAllocator> MotionList;
     typedef tinystl::vector<Effect *, TinySTLAllocator> EffectList;
@@ -222,6 +232,8 @@ public:
     static const nanoem_frame_index_t kMinimumBaseDuration;
     static const nanoem_frame_index_t kMaximumBaseDuration;
     static const nanoem_f32_t kDefaultCircleRadiusSize;
+    static const nanoem_u64_t kDefaultUndoSnapshotMemoryBudget;
+    static const nanoem_u32_t kDefaultRedoCheckpointInterval;
 
     static URI resolveArchiveURI(const URI &fileURI, const String &filename);
     static String resolveNameConfliction(const IDrawable *drawable, StringSet &reservedNameSet);
@@ -236,6 +248,7 @@ public:
     static void setAddBlendMode(sg_color_state &state) NANOEM_DECL_NOEXCEPT;
     static void setStandardDepthStencilState(sg_depth_state &ds, sg_stencil_state &ss) NANOEM_DECL_NOEXCEPT;
     static void setShadowDepthStencilState(sg_depth_state &ds, sg_stencil_state &ss) NANOEM_DECL_NOEXCEPT;
+    static void computeAllModelTransformLevels(const ModelList &models, ModelTransformLevelList &levels);
 
     struct Injector {
         const IUnicodeStringFactoryRepository *m_unicodeStringFactoryRepository;
@@ -334,6 +347,7 @@ public:
     void destroyState(SaveState *&state);
     void writeRedoMessage();
     void writeRedoMessage(const Nanoem__Application__Command *command, Error &error);
+    void writeRedoCheckpoint();
     void setWritingRedoMessageDisabled(bool value);
     Vector4UI16 queryDevicePixelRectangle(RectangleType type, const Vector2UI16 &offset) const NANOEM_DECL_NOEXCEPT;
     Vector4UI16 queryLogicalPixelRectangle(RectangleType type, const Vector2UI16 &offset) const NANOEM_DECL_NOEXCEPT;
@@ -353,11 +367,18 @@ public:
     void update();
     bool resetAllPasses();
     void pushUndo(undo_command_t *command);
+    void trimUndoStack(undo_stack_t *stack);
     bool canSeek() const NANOEM_DECL_NOEXCEPT;
 
     void resetPhysicsSimulation();
     void resetAllModelEdges();
     void performPhysicsSimulationOnce();
+    void bakePhysicsSimulation(nanoem_frame_index_t from, nanoem_frame_index_t to);
+    void clearBakedPhysicsSimulation();
+    bool hasBakedPhysicsSimulation(nanoem_frame_index_t from, nanoem_frame_index_t to) const;
+    bool hasAnyBakedPhysicsSimulation() const NANOEM_DECL_NOEXCEPT;
+    bool loadBakedPhysicsSimulation(IReader *reader, Error &error);
+    bool saveBakedPhysicsSimulation(IWriter *writer, Error &error) const;
     void synchronizeAllMotions(
         nanoem_frame_index_t frameIndex, nanoem_f32_t amount, PhysicsEngine::SimulationTimingType timing);
     void setRenderPassName(sg_pass pass, const char *value);
@@ -368,6 +389,7 @@ public:
     ImageLoader *sharedImageLoader();
     internal::BlitPass *sharedImageBlitter();
     internal::DebugDrawer *sharedDebugDrawer();
+    internal::FileContentDigestCache *fileContentDigestCache();
 
     void drawAllOffscreenRenderTargets();
     void drawShadowMap();
@@ -531,6 +553,7 @@ public:
     Motion *resolveMotion(IDrawable *drawable) NANOEM_DECL_NOEXCEPT;
     const IDrawable *resolveDrawable(const Motion *motion) const NANOEM_DECL_NOEXCEPT;
     IDrawable *resolveDrawable(Motion *motion) NANOEM_DECL_NOEXCEPT;
+    const BezierCurve *resolveBezierCurve(const nanoem_u8_t *parameters, nanoem_frame_index_t interval);
     const Motion *cameraMotion() const NANOEM_DECL_NOEXCEPT;
     Motion *cameraMotion() NANOEM_DECL_NOEXCEPT;
     const Motion *lightMotion() const NANOEM_DECL_NOEXCEPT;
@@ -553,6 +576,9 @@ public:
     void clearAllIndicesOfMaterialToAttachEffect(nanoem_u16_t handle);
     URI redoFileURI() const;
     void setRedoFileURI(const URI &value);
+    void flushRedoJournal(Error &error);
+    nanoem_u32_t redoCheckpointInterval() const NANOEM_DECL_NOEXCEPT;
+    void setRedoCheckpointInterval(nanoem_u32_t value);
     Vector4SI32 backgroundVideoRect() const NANOEM_DECL_NOEXCEPT;
     void setBackgroundVideoRect(const Vector4SI32 &value);
     Vector2SI32 deviceScaleMovingCursorPosition() const NANOEM_DECL_NOEXCEPT;
@@ -702,6 +728,15 @@ public:
     void setEffectPluginEnabled(bool value);
     bool isCompiledEffectCacheEnabled() const NANOEM_DECL_NOEXCEPT;
     void setCompiledEffectCacheEnabled(bool value);
+    nanoem_u32_t nextUndoSnapshotSequence() NANOEM_DECL_NOEXCEPT;
+    nanoem_u32_t nextUndoCommandSequence() NANOEM_DECL_NOEXCEPT;
+    void addUndoSnapshotMemoryUsage(nanoem_rsize_t value) NANOEM_DECL_NOEXCEPT;
+    void removeUndoSnapshotMemoryUsage(nanoem_rsize_t value) NANOEM_DECL_NOEXCEPT;
+    const ByteArray *findMotionUndoSnapshot(const Motion *motion, nanoem_u16_t modelHandle) const NANOEM_DECL_NOEXCEPT;
+    void setMotionUndoSnapshot(const Motion *motion, nanoem_u16_t modelHandle, const ByteArray &value);
+    nanoem_u64_t undoSnapshotMemoryUsage() const NANOEM_DECL_NOEXCEPT;
+    nanoem_u64_t undoSnapshotMemoryBudget() const NANOEM_DECL_NOEXCEPT;
+    void setUndoSnapshotMemoryBudget(nanoem_u64_t value);
     bool isViewportCaptured() const NANOEM_DECL_NOEXCEPT;
     void setViewportCaptured(bool value);
     bool isViewportHovered() const NANOEM_DECL_NOEXCEPT;
@@ -754,6 +789,11 @@ private:
         sg_image m_colorImage;
         sg_image m_depthImage;
     };
+    struct MotionUndoSnapshot {
+        ByteArray m_bytes;
+        nanoem_u32_t m_generation;
+        nanoem_u16_t m_modelHandle;
+    };
     struct FPSUnit {
         FPSUnit() NANOEM_DECL_NOEXCEPT;
         ~FPSUnit() NANOEM_DECL_NOEXCEPT;
@@ -804,6 +844,11 @@ private:
         SharedRenderTargetImageContainerMap;
     typedef tinystl::unordered_map<Motion *, IDrawable *, TinySTLAllocator> DrawableMotionSet;
     typedef tinystl::unordered_map<nanoem_u32_t, nanoem_u16_t, TinySTLAllocator> RedoObjectHandleMap;
+    typedef tinystl::unordered_map<const Motion *, tinystl::pair<nanoem_u32_t, nanoem_u64_t>, TinySTLAllocator>
+        MotionDigestMap;
+    typedef tinystl::unordered_map<nanoem_u16_t, nanoem_u64_t, TinySTLAllocator> ModelDigestMap;
+    typedef tinystl::unordered_map<const Motion *, MotionUndoSnapshot, TinySTLAllocator> MotionUndoSnapshotMap;
+    typedef tinystl::vector<Matrix4x4, TinySTLAllocator> Matrix4x4List;
     typedef tinystl::vector<const effect::OffscreenRenderTargetOption *, TinySTLAllocator>
         SortedOffscreenRenderTargetOptionList;
     typedef tinystl::unordered_map<String, tinystl::pair<Effect *, int>, TinySTLAllocator> EffectReferenceMap;
@@ -845,7 +890,15 @@ private:
     void synchronizeLight(nanoem_frame_index_t frameIndex, nanoem_f32_t amount);
     void synchronizeSelfShadow(nanoem_frame_index_t frameIndex);
     void markAllModelsDirty();
+    undo_stack_t *findOldestUndoStack(const undo_stack_t *pushedStack);
+    void writeRedoSavePointMessage(Nanoem__Project__Project *snapshot);
+    internal::project::RedoJournal *redoJournal();
     void internalPerformPhysicsSimulation(nanoem_f32_t delta);
+    void internalSynchronizeAllRigidBodiesFromSimulation();
+    void recordBakedPhysicsSimulation(nanoem_frame_index_t frameIndex);
+    bool restoreBakedPhysicsSimulation(nanoem_frame_index_t frameIndex, nanoem_f32_t amount);
+    bool containsBakedPhysicsSimulation(nanoem_frame_index_t frameIndex) const;
+    nanoem_u64_t bakedPhysicsSimulationSignature(const Model *model) const;
     void removeDrawable(IDrawable *drawable);
     void internalResizeUniformedViewportImage(const Vector2UI16 &value);
     void internalResetAllRenderTargets(const Vector2UI16 &size);
@@ -868,7 +921,7 @@ private:
     void preparePlaying();
     void prepareStopping(bool forceSeek);
     bool loadAttachedDrawableEffect(IDrawable *drawable, bool enableSourceCache, Progress &progress, Error &error);
-    URI resolveSourceEffectCachePath(const URI &fileURI);
+    effect::SourceCache *sharedSourceEffectCache();
     bool findSourceEffectCache(const URI &fileURI, ByteArray &cache, Error &error);
     void setSourceEffectCache(const URI &fileURI, const ByteArray &cache, Error &error);
     void addLoadedEffectSet(Effect *value);
@@ -888,6 +941,7 @@ private:
     ISharedResourceRepository *m_sharedResourceRepository;
     ITranslator *m_translator;
     ImageLoader *m_sharedImageLoader;
+    internal::FileContentDigestCache *m_fileContentDigestCache;
     DrawableList m_drawableOrderList;
     ModelList m_transformModelOrderList;
     tinystl::pair<Model *, Model *> m_activeModelPairPtr;
@@ -901,6 +955,7 @@ private:
     Motion *m_cameraMotionPtr;
     Motion *m_lightMotionPtr;
     Motion *m_selfShadowMotionPtr;
+    MotionKeyframeCursor m_selfShadowKeyframeCursor;
     ShadowCamera *m_shadowCamera;
     undo_stack_t *m_undoStack;
     ModelList m_allModelPtrs;
@@ -908,6 +963,7 @@ private:
     MotionList m_allMotions;
     MotionHashMap m_drawable2MotionPtrs;
     TrackList m_allTracks;
+    BezierCurve::Map m_bezierCurves;
     ITrack *m_selectedTrack;
     SaveState *m_lastSaveState;
     DrawQueue *m_drawQueue;
@@ -919,6 +975,14 @@ private:
     internal::BlitPass *m_sharedImageBlitter;
     internal::ClearPass *m_renderPassCleaner;
     internal::DebugDrawer *m_sharedDebugDrawer;
+    internal::ParallelTaskDispatcher *m_parallelTaskDispatcher;
+    internal::PhysicsBakeCache *m_physicsBakeCache;
+    internal::project::RedoJournal *m_redoJournal;
+    mutable MotionDigestMap m_bakedPhysicsMotionDigests;
+    mutable ModelDigestMap m_bakedPhysicsModelDigests;
+    MotionUndoSnapshotMap m_motionUndoSnapshots;
+    Matrix4x4List m_bakedPhysicsTransforms[2];
+    effect::SourceCache *m_sourceEffectCache;
     tinystl::pair<sg_pixel_format, sg_pixel_format> m_viewportPixelFormat;
     model::BindPose m_lastBindPose;
     model::RigidBody::VisualizationClause m_rigidBodyVisualizationClause;
@@ -987,11 +1051,16 @@ private:
     tinystl::pair<nanoem_u32_t, nanoem_u32_t> m_sampleLevel;
     nanoem_u64_t m_stateFlags;
     nanoem_u64_t m_confirmSeekFlags;
+    tinystl::pair<nanoem_u64_t, nanoem_u64_t> m_undoSnapshotMemory;
+    nanoem_u32_t m_undoSnapshotSequence;
+    nanoem_u32_t m_undoCommandSequence;
     nanoem_u32_t m_lastPhysicsDebugFlags;
     nanoem_u32_t m_coordinationSystem;
     nanoem_u32_t m_cursorModifiers;
     nanoem_u32_t m_actualFPS;
     nanoem_u32_t m_actionSequence;
+    nanoem_u32_t m_redoCheckpointInterval;
+    bool m_bakedPhysicsRestored;
     bool m_active;
 };
 
@@ -9,6 +9,7 @@
 #define NANOEM_EMAPP_THREADEDAPPLICATIONCLIENT_H_
 
 #include "emapp/BaseApplicationClient.h"
+#include "emapp/internal/MessageBatch.h"
 
 namespace nanoem {
 
@@ -20,11 +21,15 @@ public:
     void connect();
     void receiveAllEventMessages();
     void close();
+    const internal::MessageBatch::Statistics &eventStatistics() const NANOEM_DECL_NOEXCEPT;
 
 private:
+    static void handleEventMessage(void *userData, const nanoem_u8_t *data, size_t size);
+
     void sendCommandMessage(const Nanoem__Application__Command *command) NANOEM_DECL_OVERRIDE;
     void handleSocketError(const char *prefix);
 
+    internal::MessageBatch::Statistics m_eventStatistics;
     int m_commandStreamSocket;
     int m_eventStreamSocket;
 };
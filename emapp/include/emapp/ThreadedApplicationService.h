@@ -12,7 +12,9 @@
 #include "emapp/IFileManager.h"
 #include "emapp/ModalDialogFactory.h"
 #include "emapp/PluginFactory.h"
+#include "emapp/internal/MessageBatch.h"
 
+#include "bx/mutex.h"
 #include "bx/thread.h"
 
 struct Nanoem__Application__Command;
@@ -44,6 +46,7 @@ public:
     void setNativeView(void *opaque);
     void setNativeSwapChain(void *opaque);
     void setNativeSwapChainDescription(void *opaque);
+    internal::MessageBatch::Statistics eventStatistics() const;
 
 protected:
     virtual URI recoverableRedoFileURI() const;
@@ -69,15 +72,20 @@ private:
     class EventPublisher;
     static IModalDialog *handleAcceptOnRecovery(void *userData, Project *project);
     static int run(bx::Thread *thread, void *opaque);
+    static nanoem_u32_t coalescingKey(const Nanoem__Application__Event *event) NANOEM_DECL_NOEXCEPT;
 
     ICancelPublisher *createCancelPublisher() NANOEM_DECL_OVERRIDE;
     void receiveAllCommandMessages(int &exitCode);
     void handleSocketError(const char *prefix);
     void performRedo(undo_command_t *commandPtr, Project *project, undo_command_t *&commandPtrRef);
+    void flushAllEventMessages();
     void closeAllSockets();
     IModalDialog *startRecoveryFromRedo(const URI &fileURI);
 
     bx::Thread m_thread;
+    internal::MessageBatch m_eventBatch;
+    internal::MessageBatch::Statistics m_eventStatistics;
+    mutable bx::Mutex m_eventBatchLock;
     int m_recvmsgFlags;
     int m_commandStreamSocket;
     int m_eventStreamSocket;
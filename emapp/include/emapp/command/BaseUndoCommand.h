@@ -23,6 +23,7 @@ class BaseUndoCommand : public IUndoCommand, private NonCopyable {
 public:
     const Project *currentProject() const NANOEM_DECL_NOEXCEPT;
     Project *currentProject() NANOEM_DECL_OVERRIDE;
+    nanoem_u32_t sequence() const NANOEM_DECL_NOEXCEPT;
 
     virtual void read(const void *messagePtr) = 0;
     virtual void write(void *messagePtr) = 0;
@@ -37,6 +38,24 @@ protected:
         bool inflate(ByteArray &output) const;
         bool inflate(ProtobufCBinaryData *binary) const;
     };
+    /*
+     * Keeps deltas between the last and the current snapshot for both directions instead of whole of them so that
+     * each step of the undo stack costs as much as changed ranges. Every kCheckpointInterval snapshots of the same
+     * target and snapshots changed too widely keep whole of both snapshots as a checkpoint instead.
+     */
+    struct SnapshotData {
+        static const nanoem_u32_t kCheckpointInterval = 16;
+        SnapshotData();
+        void save(const ByteArray &last, const ByteArray &current, bool checkpoint);
+        bool restoreLast(const ByteArray &current, ByteArray &output) const;
+        bool restoreCurrent(const ByteArray &last, ByteArray &output) const;
+        bool restoreAll(const ByteArray &present, ByteArray &last, ByteArray &current) const;
+        static void copy(const ByteArray &bytes, ProtobufCBinaryData *binary);
+        nanoem_rsize_t memoryUsage() const NANOEM_DECL_NOEXCEPT;
+        LZ4Data m_forward;
+        LZ4Data m_backward;
+        bool m_checkpoint;
+    };
     BaseUndoCommand(Project *project);
 
     undo_command_t *createCommand(bool enablePersistence = true);
@@ -52,6 +71,7 @@ private:
     static void onDestroy(const undo_command_t *command);
 
     Project *m_project;
+    nanoem_u32_t m_sequence;
 };
 
 } /* namespace command */
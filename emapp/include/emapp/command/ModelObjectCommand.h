@@ -44,139 +44,158 @@ struct ScopedMutableModel {
     nanoem_mutable_model_t *m_model;
 };
 
+/* constructed with the model, the referred object is marked as edited on destruction to be revalidated. commands
+   holding it as a member pass nullptr as they may outlive the model */
 struct ScopedMutableVertex {
     ScopedMutableVertex(Model *model);
-    ScopedMutableVertex(nanoem_model_vertex_t *vertexPtr);
+    ScopedMutableVertex(Model *model, nanoem_model_vertex_t *vertexPtr);
     ~ScopedMutableVertex() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_vertex_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_vertex_t *m_vertex;
+    Model *m_model;
 };
 
 struct ScopedMutableMaterial {
     ScopedMutableMaterial(Model *model);
-    ScopedMutableMaterial(nanoem_model_material_t *materialPtr);
+    ScopedMutableMaterial(Model *model, nanoem_model_material_t *materialPtr);
     ~ScopedMutableMaterial() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_material_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_material_t *m_material;
+    Model *m_model;
 };
 
 struct ScopedMutableBone {
     ScopedMutableBone(Model *model);
-    ScopedMutableBone(nanoem_model_bone_t *bonePtr);
+    ScopedMutableBone(Model *model, nanoem_model_bone_t *bonePtr);
     ~ScopedMutableBone() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_bone_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_bone_t *m_bone;
+    Model *m_model;
 };
 
 struct ScopedMutableConstraint {
     ScopedMutableConstraint(Model *model);
-    ScopedMutableConstraint(nanoem_model_constraint_t *constraintPtr);
+    ScopedMutableConstraint(Model *model, nanoem_model_constraint_t *constraintPtr);
     ~ScopedMutableConstraint() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_constraint_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_constraint_t *m_constraint;
+    Model *m_model;
 };
 
 struct ScopedMutableConstraintJoint {
-    ScopedMutableConstraintJoint(nanoem_model_constraint_joint_t *jointPtr);
+    ScopedMutableConstraintJoint(Model *model, nanoem_model_constraint_joint_t *jointPtr);
     ~ScopedMutableConstraintJoint() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_constraint_joint_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_constraint_joint_t *m_joint;
+    Model *m_model;
 };
 
 struct ScopedMutableMorph {
     ScopedMutableMorph(Model *model);
-    ScopedMutableMorph(nanoem_model_morph_t *morphPtr);
+    ScopedMutableMorph(Model *model, nanoem_model_morph_t *morphPtr);
     ~ScopedMutableMorph() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphBone {
     ScopedMutableMorphBone(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphBone(nanoem_model_morph_bone_t *morphPtr);
+    ScopedMutableMorphBone(Model *model, nanoem_model_morph_bone_t *morphPtr);
     ~ScopedMutableMorphBone() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_bone_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_bone_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphFlip {
     ScopedMutableMorphFlip(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphFlip(nanoem_model_morph_flip_t *morphPtr);
+    ScopedMutableMorphFlip(Model *model, nanoem_model_morph_flip_t *morphPtr);
     ~ScopedMutableMorphFlip() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_flip_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_flip_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphGroup {
     ScopedMutableMorphGroup(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphGroup(nanoem_model_morph_group_t *morphPtr);
+    ScopedMutableMorphGroup(Model *model, nanoem_model_morph_group_t *morphPtr);
     ~ScopedMutableMorphGroup() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_group_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_group_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphImpulse {
     ScopedMutableMorphImpulse(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphImpulse(nanoem_model_morph_impulse_t *morphPtr);
+    ScopedMutableMorphImpulse(Model *model, nanoem_model_morph_impulse_t *morphPtr);
     ~ScopedMutableMorphImpulse() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_impulse_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_impulse_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphMaterial {
     ScopedMutableMorphMaterial(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphMaterial(nanoem_model_morph_material_t *morphPtr);
+    ScopedMutableMorphMaterial(Model *model, nanoem_model_morph_material_t *morphPtr);
     ~ScopedMutableMorphMaterial() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_material_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_material_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphUV {
     ScopedMutableMorphUV(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphUV(nanoem_model_morph_uv_t *morphPtr);
+    ScopedMutableMorphUV(Model *model, nanoem_model_morph_uv_t *morphPtr);
     ~ScopedMutableMorphUV() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_uv_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_uv_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableMorphVertex {
     ScopedMutableMorphVertex(nanoem_mutable_model_morph_t *morphPtr);
-    ScopedMutableMorphVertex(nanoem_model_morph_vertex_t *morphPtr);
+    ScopedMutableMorphVertex(Model *model, nanoem_model_morph_vertex_t *morphPtr);
     ~ScopedMutableMorphVertex() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_morph_vertex_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_morph_vertex_t *m_morph;
+    Model *m_model;
 };
 
 struct ScopedMutableLabel {
     ScopedMutableLabel(Model *model);
-    ScopedMutableLabel(nanoem_model_label_t *labelPtr);
+    ScopedMutableLabel(Model *model, nanoem_model_label_t *labelPtr);
     ~ScopedMutableLabel() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_label_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_label_t *m_label;
+    Model *m_model;
 };
 
 struct ScopedMutableRigidBody {
     ScopedMutableRigidBody(Model *model);
-    ScopedMutableRigidBody(nanoem_model_rigid_body_t *rigidBodyPtr);
+    ScopedMutableRigidBody(Model *model, nanoem_model_rigid_body_t *rigidBodyPtr);
     ~ScopedMutableRigidBody() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_rigid_body_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_rigid_body_t *m_rigidBody;
+    Model *m_model;
 };
 
 struct ScopedMutableJoint {
     ScopedMutableJoint(Model *model);
-    ScopedMutableJoint(nanoem_model_joint_t *jointPtr);
+    ScopedMutableJoint(Model *model, nanoem_model_joint_t *jointPtr);
     ~ScopedMutableJoint() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_joint_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_joint_t *m_joint;
+    Model *m_model;
 };
 
 struct ScopedMutableSoftBody {
     ScopedMutableSoftBody(Model *model);
-    ScopedMutableSoftBody(nanoem_model_soft_body_t *softBodyPtr);
+    ScopedMutableSoftBody(Model *model, nanoem_model_soft_body_t *softBodyPtr);
     ~ScopedMutableSoftBody() NANOEM_DECL_NOEXCEPT;
     operator nanoem_mutable_model_soft_body_t *() NANOEM_DECL_NOEXCEPT;
     nanoem_mutable_model_soft_body_t *m_softBody;
+    Model *m_model;
 };
 
 class DeletingMaterialState : private NonCopyable {
@@ -26,7 +26,8 @@ public:
     const char *name() const NANOEM_DECL_NOEXCEPT;
 
 private:
-    void execute(const LZ4Data &input, Error &error);
+    bool resolvePresent(ByteArray &present, Error &error);
+    void execute(const ByteArray &input, Error &error);
 
     ModelSnapshotCommand(Project *project);
     ModelSnapshotCommand(Model *model, const ByteArray &snapshot);
@@ -36,7 +37,8 @@ private:
     void release(void *messagePtr);
 
     Model *m_model;
-    tinystl::pair<LZ4Data, LZ4Data> m_snapshot;
+    SnapshotData m_snapshot;
+    ByteArray m_pendingCurrent;
 };
 
 } /* namespace command */
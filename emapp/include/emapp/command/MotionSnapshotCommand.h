@@ -26,7 +26,8 @@ public:
     const char *name() const NANOEM_DECL_NOEXCEPT;
 
 private:
-    void execute(const LZ4Data &input, Error &error);
+    bool resolvePresent(ByteArray &present, Error &error);
+    void execute(const ByteArray &input, Error &error);
     MotionSnapshotCommand(Project *project);
     MotionSnapshotCommand(Motion *motion, const Model *model, const ByteArray &snapshot, nanoem_u32_t types);
 
@@ -36,7 +37,9 @@ private:
 
     Motion *m_motion;
     Motion::SelectionState *m_state;
-    tinystl::pair<LZ4Data, LZ4Data> m_snapshot;
+    SnapshotData m_snapshot;
+    ByteArray m_pendingCurrent;
+    nanoem_u16_t m_modelHandle;
     nanoem_u32_t m_types;
 };
 
@@ -0,0 +1,32 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_COMMAND_SNAPSHOTDELTA_H_
+#define NANOEM_EMAPP_COMMAND_SNAPSHOTDELTA_H_
+
+#include "emapp/Forward.h"
+
+namespace nanoem {
+namespace command {
+
+/*
+ * Binary delta between two serialized snapshots. The target is described as ranges copied from the base and literal
+ * bytes, found by matching fixed size blocks of the base with rolling hash so that both in-place edits and
+ * insertions or removals of keyframes and model objects are encoded as small as changed ranges. Sizes and checksums
+ * of both base and target are stored to refuse applying the delta to the different base.
+ */
+class SnapshotDelta NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    static nanoem_u32_t checksum(const ByteArray &bytes) NANOEM_DECL_NOEXCEPT;
+    static void encode(const ByteArray &base, const ByteArray &target, ByteArray &delta);
+    static bool decode(const ByteArray &base, const ByteArray &delta, ByteArray &target);
+};
+
+} /* namespace command */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_COMMAND_SNAPSHOTDELTA_H_ */
@@ -0,0 +1,94 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_EFFECT_SOURCECACHE_H_
+#define NANOEM_EMAPP_EFFECT_SOURCECACHE_H_
+
+#include "emapp/URI.h"
+
+namespace nanoem {
+
+class Error;
+class ITranslator;
+
+namespace effect {
+
+/*
+ * Compiled effects are stored by the digest of the source closure (the main source, all sources reachable by
+ * #include and the compiler environment) so that moving a project keeps its cache and editing an included source
+ * invalidates it. A manifest keyed by the source path remembers the closure to skip rehashing when sizes and
+ * timestamps of all sources are unchanged, and blobs are evicted in least recently used order over the capacity
+ * together with the manifests pointing them. A source with any #include not found beside it is never cached since
+ * its closure cannot be known.
+ */
+class SourceCache NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    static const nanoem_rsize_t kDigestSize = 32;
+    static const nanoem_u64_t kDefaultCapacity = 256 * 1024 * 1024;
+    struct Digest {
+        nanoem_u8_t m_value[kDigestSize];
+    };
+    struct Dependency {
+        String m_path;
+        nanoem_u64_t m_size;
+        nanoem_u64_t m_timestamp;
+    };
+    typedef tinystl::vector<Dependency, TinySTLAllocator> DependencyList;
+    typedef tinystl::vector<Digest, TinySTLAllocator> DigestList;
+
+    static bool digestAllSources(const URI &fileURI, const String &environment, const ITranslator *translator,
+        DependencyList &dependencies, Digest &digest, Error &error);
+    static void parseAllIncludes(const ByteArray &bytes, StringList &includes);
+
+    SourceCache(const URI &directoryURI, const ITranslator *translator);
+    ~SourceCache() NANOEM_DECL_NOEXCEPT;
+
+    bool find(const URI &fileURI, ByteArray &output, Error &error);
+    void save(const URI &fileURI, const ByteArray &output, Error &error);
+    URI resolveManifestFileURI(const URI &fileURI) const;
+
+    String environment() const;
+    void setEnvironment(const String &value);
+    nanoem_u64_t capacity() const NANOEM_DECL_NOEXCEPT;
+    void setCapacity(nanoem_u64_t value);
+    nanoem_u64_t usage() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    struct Entry {
+        Digest m_key;
+        DigestList m_sourceKeys;
+        nanoem_u64_t m_size;
+        nanoem_u64_t m_sequence;
+    };
+    typedef tinystl::vector<Entry, TinySTLAllocator> EntryList;
+
+    static bool isUpToDate(const DependencyList &dependencies) NANOEM_DECL_NOEXCEPT;
+    URI resolveFileURI(const Digest &key, const char *extension) const;
+    void resolveSourceKey(const URI &fileURI, Digest &key) const;
+    bool readManifest(const Digest &sourceKey, Digest &contentKey, DependencyList &dependencies);
+    void writeManifest(const Digest &sourceKey, const Digest &contentKey, const DependencyList &dependencies,
+        Error &error);
+    bool readBlob(const Digest &contentKey, ByteArray &output, nanoem_u64_t &size);
+    void writeBlob(const Digest &contentKey, const ByteArray &input, nanoem_u64_t &size, Error &error);
+    void loadIndex();
+    void saveIndex(Error &error);
+    void touch(const Digest &contentKey, const Digest &sourceKey, nanoem_u64_t size);
+    void evict();
+
+    const ITranslator *m_translator;
+    const URI m_directoryURI;
+    String m_environment;
+    EntryList m_entries;
+    nanoem_u64_t m_capacity;
+    nanoem_u64_t m_sequence;
+    bool m_indexLoaded;
+};
+
+} /* namespace effect */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_EFFECT_SOURCECACHE_H_ */
@@ -12,6 +12,7 @@
 #include "emapp/ModalDialogFactory.h"
 #include "emapp/Project.h"
 #include "emapp/URI.h"
+#include "emapp/internal/VideoEncodingPipeline.h"
 
 namespace nanoem {
 
@@ -77,6 +78,7 @@ protected:
         kConfigured,
         kReady,
         kBlitted,
+        kDraining,
         kFinished,
         kDestroyReady,
         kCancelled,
@@ -131,7 +133,8 @@ private:
     static IModalDialog *handleCancelExportingImage(void *userData, Project *project);
 };
 
-class CapturingPassAsVideoState NANOEM_DECL_SEALED : public CapturingPassState {
+class CapturingPassAsVideoState NANOEM_DECL_SEALED : public CapturingPassState,
+                                                     private VideoEncodingPipeline::IEncoder {
 public:
     static const char kExportVideoEnableNativeKey[];
     static const char kExportAudioCodecKey[];
@@ -147,6 +150,7 @@ public:
     IModalDialog *createDialog() NANOEM_DECL_OVERRIDE;
     bool capture(Project *project, Error &error) NANOEM_DECL_OVERRIDE;
     void cancel() NANOEM_DECL_OVERRIDE;
+    void save(Project *project) NANOEM_DECL_OVERRIDE;
     void restore(Project *project) NANOEM_DECL_OVERRIDE;
 
     void setEncoderPlugin(plugin::EncoderPlugin *value);
@@ -155,6 +159,8 @@ public:
 
 private:
     class ModalDialog;
+    typedef tinystl::vector<sg_buffer, TinySTLAllocator> StagingBufferList;
+    static const nanoem_rsize_t kNumStagingBuffers = 3;
 
     static IModalDialog *handleCancelExportingVideo(void *userData, Project * /* project */);
     static void calculateFrameIndex(
@@ -166,7 +172,12 @@ private:
     void handleCaptureViaEncoderPlugin(Project *project, nanoem_frame_index_t frameIndex,
         nanoem_frame_index_t videoFrameIndex, nanoem_frame_index_t durationFrameIndices, nanoem_f32_t deltaScaleFactor,
         Error &error);
-    bool encodeVideoFrame(const ByteArray &frameData, nanoem_frame_index_t pts, Error &error);
+    bool encodeAudioFrame(
+        nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) NANOEM_DECL_OVERRIDE;
+    bool encodeVideoFrame(
+        nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) NANOEM_DECL_OVERRIDE;
+    void createAllStagingBuffers();
+    void enqueueFrame(VideoEncodingPipeline::Frame *frame);
     void seekAndProgress(Project *project, nanoem_frame_index_t frameIndex, nanoem_frame_index_t durationFrameIndices);
     void finishEncoding();
     void stopEncoding(Error &error);
@@ -175,6 +186,10 @@ private:
     plugin::EncoderPlugin *m_encoderPluginPtr;
     IVideoRecorder *m_videoRecorder;
     IVideoRecorder *m_destroyingVideoRecorder;
+    VideoEncodingPipeline *m_pipeline;
+    StagingBufferList m_stagingBuffers;
+    nanoem_rsize_t m_stagingBufferOffset;
+    nanoem_rsize_t m_numInflightReads;
     nanoem_frame_index_t m_endFrameIndex;
     nanoem_f32_t m_amount;
 };
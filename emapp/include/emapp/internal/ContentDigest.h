@@ -0,0 +1,62 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_CONTENTDIGEST_H_
+#define NANOEM_EMAPP_INTERNAL_CONTENTDIGEST_H_
+
+#include "emapp/FileUtils.h"
+
+namespace nanoem {
+namespace internal {
+
+class ParallelTaskDispatcher;
+
+/*
+ * Calculates the digest of contents incrementally. SHA-256 is used where the file format stores it and Fast128 is
+ * a non-cryptographic 128bit hash for cache keys and change detection. Fast128 hashes each chunk independently and
+ * then hashes the chunk digests with the total length, so the same digest is produced whether the contents are
+ * streamed or hashed at once with chunks processed in parallel.
+ */
+class ContentDigest NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    enum AlgorithmType {
+        kAlgorithmTypeFirstEnum,
+        kAlgorithmTypeSHA256 = kAlgorithmTypeFirstEnum,
+        kAlgorithmTypeFast128,
+        kAlgorithmTypeMaxEnum
+    };
+    static const nanoem_rsize_t kMaxDigestSize = 32;
+    static const nanoem_rsize_t kFastChunkSize = 1024 * 1024;
+
+    static nanoem_rsize_t digestSize(AlgorithmType value) NANOEM_DECL_NOEXCEPT;
+    /* dispatcher may be nullptr and is used only for Fast128 contents larger than a chunk */
+    static void calculate(AlgorithmType algorithm, const nanoem_u8_t *data, nanoem_rsize_t size,
+        ParallelTaskDispatcher *dispatcher, nanoem_u8_t *digest);
+
+    ContentDigest(AlgorithmType algorithm);
+    ~ContentDigest() NANOEM_DECL_NOEXCEPT;
+
+    void update(const nanoem_u8_t *data, nanoem_rsize_t size);
+    /* writes digestSize(algorithm()) bytes to digest and must be called once */
+    void finalize(nanoem_u8_t *digest);
+
+    AlgorithmType algorithm() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    void appendChunkDigest(const nanoem_u8_t *data, nanoem_rsize_t size);
+
+    const AlgorithmType m_algorithm;
+    void *m_context;
+    ByteArray m_pendingChunk;
+    ByteArray m_chunkDigests;
+    nanoem_u64_t m_totalSize;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_CONTENTDIGEST_H_ */
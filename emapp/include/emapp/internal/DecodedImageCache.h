@@ -0,0 +1,86 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_DECODEDIMAGECACHE_H_
+#define NANOEM_EMAPP_INTERNAL_DECODEDIMAGECACHE_H_
+
+#include "emapp/Forward.h"
+
+#include "bx/mutex.h"
+
+namespace nanoem {
+namespace internal {
+
+class ParallelTaskDispatcher;
+
+/* pixels of the decoded image on CPU side that are owned by the image itself to be uploaded on any later time */
+struct DecodedImage {
+    DecodedImage();
+    void assign(const sg_image_desc &desc);
+    nanoem_rsize_t sizeInBytes() const NANOEM_DECL_NOEXCEPT;
+
+    sg_image_desc m_description;
+    ByteArrayList m_payloads;
+};
+
+/*
+ * Decoded images are stored by the digest of their encoded bytes and the flags affecting decoding so the same
+ * texture referred from models, accessories or effects is decoded once. Entries are reference counted while they
+ * are being uploaded and unreferenced ones are kept up to the budget for the next load in least recently used order.
+ * All of the functions are safe to call from worker threads.
+ */
+class DecodedImageCache NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    static const nanoem_rsize_t kDigestSize = 16;
+    static const nanoem_rsize_t kDefaultBudget = 128 * 1024 * 1024;
+    struct Key {
+        /* the fast digest is enough to identify the image and the dispatcher may be nullptr on worker threads */
+        static Key create(
+            const nanoem_u8_t *data, nanoem_rsize_t size, nanoem_u32_t flags, ParallelTaskDispatcher *dispatcher);
+        bool equals(const Key &value) const NANOEM_DECL_NOEXCEPT;
+        nanoem_u8_t m_digest[kDigestSize];
+        nanoem_u32_t m_flags;
+    };
+
+    DecodedImageCache(nanoem_rsize_t budget);
+    ~DecodedImageCache() NANOEM_DECL_NOEXCEPT;
+
+    const DecodedImage *acquire(const Key &key);
+    const DecodedImage *insert(const Key &key, DecodedImage *image);
+    void release(const DecodedImage *image);
+    void purge();
+
+    nanoem_rsize_t budget() const NANOEM_DECL_NOEXCEPT;
+    void setBudget(nanoem_rsize_t value);
+    nanoem_rsize_t memoryUsage() const NANOEM_DECL_NOEXCEPT;
+    nanoem_rsize_t numEntries() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    struct Entry {
+        Key m_key;
+        DecodedImage *m_image;
+        nanoem_rsize_t m_size;
+        nanoem_u64_t m_sequence;
+        int m_numReferences;
+    };
+    typedef tinystl::vector<Entry *, TinySTLAllocator> EntryList;
+
+    Entry *findEntry(const Key &key) NANOEM_DECL_NOEXCEPT;
+    void evictUnreferencedEntries(nanoem_rsize_t budget);
+    void destroyEntry(nanoem_rsize_t index);
+
+    mutable bx::Mutex m_mutex;
+    EntryList m_entries;
+    nanoem_rsize_t m_budget;
+    nanoem_rsize_t m_memoryUsage;
+    nanoem_u64_t m_sequence;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_DECODEDIMAGECACHE_H_ */
@@ -0,0 +1,79 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_FILECONTENTDIGESTCACHE_H_
+#define NANOEM_EMAPP_INTERNAL_FILECONTENTDIGESTCACHE_H_
+
+#include "emapp/FileUtils.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
+
+namespace nanoem {
+namespace internal {
+
+/*
+ * SHA-256 digests of the files referred from the project keyed by their absolute paths. Each entry also records the
+ * size and Fast128 digest of the contents, and SHA-256 is calculated again only when either of them differs, so the
+ * modification is detected by the contents rather than by the timestamp of the file.
+ * Files prefetched on loading the project are kept mapped until releaseAllMappedFiles is called, so the loaders use
+ * the same bytes whose digests are tested without reading the files again.
+ * All of the functions must be called from the main thread.
+ */
+class FileContentDigestCache NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    static const nanoem_rsize_t kDigestSize = 32;
+    typedef tinystl::vector<URI, TinySTLAllocator> URIList;
+
+    FileContentDigestCache();
+    ~FileContentDigestCache() NANOEM_DECL_NOEXCEPT;
+
+    /* maps and hashes all of the files concurrently, files that cannot be opened are skipped */
+    void prefetch(const URIList &fileURIs);
+    bool calculate(const URI &fileURI, nanoem_u8_t *digest, Error &error);
+    void update(const URI &fileURI, const nanoem_u8_t *data, nanoem_rsize_t size);
+    MappedFileReader *findMappedFile(const URI &fileURI) NANOEM_DECL_NOEXCEPT;
+    void releaseAllMappedFiles();
+    void clear();
+
+    nanoem_rsize_t numEntries() const NANOEM_DECL_NOEXCEPT;
+    nanoem_rsize_t numMappedFiles() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    static const nanoem_rsize_t kFastDigestSize = 16;
+    struct Entry {
+        nanoem_u64_t m_size;
+        nanoem_u8_t m_fastDigest[kFastDigestSize];
+        nanoem_u8_t m_digest[kDigestSize];
+    };
+    struct PrefetchingFile {
+        URI m_fileURI;
+        MappedFileReader *m_reader;
+        Entry m_cachedEntry;
+        Entry m_entry;
+        bool m_hasCachedEntry;
+        bool m_mapped;
+    };
+    typedef tinystl::unordered_map<String, Entry, TinySTLAllocator> EntryMap;
+    typedef tinystl::unordered_map<String, MappedFileReader *, TinySTLAllocator> MappedFileMap;
+    typedef tinystl::vector<PrefetchingFile, TinySTLAllocator> PrefetchingFileList;
+
+    static bool isCacheable(const URI &fileURI) NANOEM_DECL_NOEXCEPT;
+    static void calculateEntry(const nanoem_u8_t *data, nanoem_rsize_t size, const Entry *cachedEntry,
+        ParallelTaskDispatcher *dispatcher, Entry &entry);
+    static void handlePrefetchFile(void *opaque, size_t index);
+
+    const Entry *findEntry(const URI &fileURI) const;
+    void insertEntry(const URI &fileURI, const Entry &entry);
+
+    ParallelTaskDispatcher m_dispatcher;
+    EntryMap m_entries;
+    MappedFileMap m_mappedFiles;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_FILECONTENTDIGESTCACHE_H_ */
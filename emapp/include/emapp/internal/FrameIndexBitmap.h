@@ -0,0 +1,61 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_FRAMEINDEXBITMAP_H_
+#define NANOEM_EMAPP_INTERNAL_FRAMEINDEXBITMAP_H_
+
+#include "emapp/Motion.h"
+
+namespace nanoem {
+namespace internal {
+
+/*
+ * Set of frame indices stored as 64 bits words ordered by the word offset and only non empty words are kept, so
+ * range operations touch one word per 64 frames and iteration is in ascending order of the frame index.
+ */
+class FrameIndexBitmap NANOEM_DECL_SEALED {
+public:
+    static const nanoem_frame_index_t kNumBitsPerWord = 64;
+
+    FrameIndexBitmap();
+    ~FrameIndexBitmap() NANOEM_DECL_NOEXCEPT;
+
+    bool contains(nanoem_frame_index_t frameIndex) const NANOEM_DECL_NOEXCEPT;
+    void set(nanoem_frame_index_t frameIndex);
+    void reset(nanoem_frame_index_t frameIndex);
+    void setRange(nanoem_frame_index_t from, nanoem_frame_index_t to);
+    void resetRange(nanoem_frame_index_t from, nanoem_frame_index_t to);
+    void shift(nanoem_frame_index_t from, int delta);
+    void getAll(Motion::FrameIndexList &frameIndices) const;
+    void clear();
+    nanoem_frame_index_t first() const NANOEM_DECL_NOEXCEPT;
+    nanoem_rsize_t count() const NANOEM_DECL_NOEXCEPT;
+    bool isEmpty() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    struct Word {
+        Word(nanoem_frame_index_t offset)
+            : m_offset(offset)
+            , m_bits(0)
+        {
+        }
+        nanoem_frame_index_t m_offset;
+        nanoem_u64_t m_bits;
+    };
+    typedef tinystl::vector<Word, TinySTLAllocator> WordList;
+
+    static nanoem_u64_t mask(nanoem_frame_index_t from, nanoem_frame_index_t to) NANOEM_DECL_NOEXCEPT;
+    nanoem_rsize_t lowerBound(nanoem_frame_index_t offset) const NANOEM_DECL_NOEXCEPT;
+    void assign(nanoem_frame_index_t from, nanoem_frame_index_t to, bool value);
+
+    WordList m_words;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_FRAMEINDEXBITMAP_H_ */
@@ -460,6 +460,7 @@ private:
     int m_modalDialogPressedButton;
     int m_projectKeyframeSelectorIndex;
     int m_modelKeyframeSelectorIndex;
+    nanoem_u16_t m_constraintHeatmapModelHandle;
     bool m_requestClearAllModalDialogs;
     bool m_draggingTimelineScrollBar;
     bool m_lastKeyframeSelection;
@@ -0,0 +1,71 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_MESSAGEBATCH_H_
+#define NANOEM_EMAPP_INTERNAL_MESSAGEBATCH_H_
+
+#include "emapp/Forward.h"
+
+namespace nanoem {
+namespace internal {
+
+/*
+ * Packs serialized messages into one frame so that a socket is written once per frame instead of once per message.
+ * A message appended with non zero coalescing key supersedes the pending one with the same key, and the latest one
+ * is sent at its appended position.
+ */
+class MessageBatch NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    struct Statistics {
+        Statistics();
+        nanoem_u64_t m_numBatches;
+        nanoem_u64_t m_numMessages;
+        nanoem_u64_t m_numCoalescedMessages;
+        nanoem_u64_t m_totalLatency;
+        nanoem_u64_t m_maxLatency;
+    };
+    typedef void (*pfn_dispatchMessage)(void *userData, const nanoem_u8_t *data, size_t size);
+    static const nanoem_u32_t kSignature;
+
+    static bool dispatchAll(
+        const nanoem_u8_t *data, size_t size, pfn_dispatchMessage callback, void *userData, nanoem_u64_t *timestamp);
+
+    MessageBatch();
+    ~MessageBatch() NANOEM_DECL_NOEXCEPT;
+
+    nanoem_u8_t *allocate(nanoem_rsize_t size, nanoem_u32_t coalescingKey);
+    nanoem_rsize_t encodedSize() const NANOEM_DECL_NOEXCEPT;
+    void encode(nanoem_u64_t timestamp, nanoem_u8_t *data);
+    void clear();
+    nanoem_rsize_t numMessages() const NANOEM_DECL_NOEXCEPT;
+    nanoem_rsize_t numCoalescedMessages() const NANOEM_DECL_NOEXCEPT;
+    bool isEmpty() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    struct Header {
+        nanoem_u32_t m_signature;
+        nanoem_u32_t m_numMessages;
+        nanoem_u64_t m_timestamp;
+    };
+    struct Entry {
+        nanoem_rsize_t m_offset;
+        nanoem_rsize_t m_size;
+        bool m_superseded;
+    };
+    typedef tinystl::vector<Entry, TinySTLAllocator> EntryList;
+    typedef tinystl::unordered_map<nanoem_u32_t, nanoem_rsize_t, TinySTLAllocator> EntryIndexMap;
+
+    ByteArray m_payload;
+    EntryList m_entries;
+    EntryIndexMap m_coalescingEntryIndices;
+    nanoem_rsize_t m_numCoalescedMessages;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_MESSAGEBATCH_H_ */
@@ -9,6 +9,7 @@
 #define NANOEM_EMAPP_INTERNAL_MOTIONKEYFRAMESELECTION_H_
 
 #include "emapp/IMotionKeyframeSelection.h"
+#include "emapp/internal/FrameIndexBitmap.h"
 
 namespace nanoem {
 namespace internal {
@@ -58,18 +59,34 @@ public:
     void addMorphKeyframes(
         const nanoem_model_morph_t *morph, nanoem_frame_index_t start, nanoem_frame_index_t end) NANOEM_DECL_OVERRIDE;
     void addSelfShadowKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end) NANOEM_DECL_OVERRIDE;
+    void shiftAllKeyframes(nanoem_u32_t flags, nanoem_frame_index_t from, int delta) NANOEM_DECL_OVERRIDE;
 
 private:
+    /* selected keyframes are stored as frame indices of the track so these survive keyframe objects to be recreated */
+    struct Track {
+        Track()
+            : m_track(nullptr)
+        {
+        }
+        const nanoem_motion_track_t *m_track;
+        FrameIndexBitmap m_frameIndices;
+    };
+    typedef tinystl::unordered_map<nanoem_u32_t, Track, TinySTLAllocator> TrackMap;
+
+    static void shiftAllTracks(TrackMap &tracks, nanoem_frame_index_t from, int delta);
+    static bool hasAnyTrack(const TrackMap &tracks) NANOEM_DECL_NOEXCEPT;
+    Track *resolveBoneTrack(const nanoem_motion_bone_keyframe_t *keyframe);
+    Track *resolveMorphTrack(const nanoem_motion_morph_keyframe_t *keyframe);
     bool isParentOf(const nanoem_motion_keyframe_object_t *ko) const NANOEM_DECL_NOEXCEPT;
 
     Motion *m_parent;
-    Motion::AccessoryKeyframeSet m_accessoryKeyframeSelection;
-    Motion::BoneKeyframeSet m_boneKeyframeSelection;
-    Motion::CameraKeyframeSet m_cameraKeyframeSelection;
-    Motion::LightKeyframeSet m_lightKeyframeSelection;
-    Motion::ModelKeyframeSet m_modelKeyframeSelection;
-    Motion::MorphKeyframeSet m_morphKeyframeSelection;
-    Motion::SelfShadowKeyframeSet m_selfShadowKeyframeSelection;
+    FrameIndexBitmap m_accessoryKeyframeSelection;
+    TrackMap m_boneKeyframeSelection;
+    FrameIndexBitmap m_cameraKeyframeSelection;
+    FrameIndexBitmap m_lightKeyframeSelection;
+    FrameIndexBitmap m_modelKeyframeSelection;
+    TrackMap m_morphKeyframeSelection;
+    FrameIndexBitmap m_selfShadowKeyframeSelection;
 };
 
 } /* namespace internal */
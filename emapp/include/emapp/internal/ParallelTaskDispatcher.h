@@ -0,0 +1,33 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_PARALLELTASKDISPATCHER_H_
+#define NANOEM_EMAPP_INTERNAL_PARALLELTASKDISPATCHER_H_
+
+#include "emapp/Forward.h"
+
+namespace nanoem {
+namespace internal {
+
+class ParallelTaskDispatcher NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    typedef void (*Iterator)(void *, size_t);
+
+    ParallelTaskDispatcher(const char *label);
+    ~ParallelTaskDispatcher() NANOEM_DECL_NOEXCEPT;
+
+    /* runs iterator(opaque, 0..iterations-1) on TBB, GCD or OpenMP and returns after all of them are done */
+    void dispatch(Iterator iterator, void *opaque, size_t iterations);
+
+private:
+    void *m_queue;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_PARALLELTASKDISPATCHER_H_ */
@@ -0,0 +1,93 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_PHYSICSBAKECACHE_H_
+#define NANOEM_EMAPP_INTERNAL_PHYSICSBAKECACHE_H_
+
+#include "emapp/Forward.h"
+
+namespace nanoem {
+
+class Error;
+class IReader;
+class IWriter;
+
+namespace internal {
+
+/*
+ * Stores simulated world transforms of all rigid bodies per frame for each model to replay physics without stepping
+ * the simulation. Each transform is quantized to a 16bit normalized quaternion with a position and frames are
+ * compressed with LZ4 every kNumFramesPerChunk frames. A track is valid while its signature covering the motion and
+ * the physics environment is unchanged and the number of rigid bodies matches. Tracks are keyed by the model handle
+ * so renaming a model keeps its track and models sharing the same name never collide. As handles are remapped in
+ * each session, tracks are saved with the name given by the caller and are mapped back to handles on load.
+ */
+class PhysicsBakeCache NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    static const nanoem_u32_t kNumFramesPerChunk = 64;
+    static const nanoem_u64_t kInitialDigest = 14695981039346656037ull;
+    typedef tinystl::unordered_map<nanoem_u16_t, String, TinySTLAllocator> HandleNameMap;
+    typedef tinystl::unordered_map<String, nanoem_u16_t, TinySTLAllocator> NameHandleMap;
+
+    static nanoem_u64_t digest(const void *data, nanoem_rsize_t size, nanoem_u64_t seed) NANOEM_DECL_NOEXCEPT;
+
+    PhysicsBakeCache();
+    ~PhysicsBakeCache() NANOEM_DECL_NOEXCEPT;
+
+    void begin(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies);
+    void record(nanoem_u16_t handle, nanoem_frame_index_t frameIndex, const Matrix4x4 *transforms);
+    void commit();
+    bool contains(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies,
+        nanoem_frame_index_t frameIndex) const NANOEM_DECL_NOEXCEPT;
+    bool restore(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies,
+        nanoem_frame_index_t frameIndex, Matrix4x4 *transforms);
+    void invalidate(nanoem_u16_t handle);
+    void clear();
+
+    bool load(IReader *reader, const NameHandleMap &handles, Error &error);
+    bool save(IWriter *writer, const HandleNameMap &names, Error &error) const;
+
+    nanoem_rsize_t numTracks() const NANOEM_DECL_NOEXCEPT;
+    nanoem_rsize_t memoryUsage() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    struct Chunk {
+        Chunk();
+        bool contains(nanoem_frame_index_t offset) const NANOEM_DECL_NOEXCEPT;
+        ByteArray m_deflatedBytes;
+        ByteArray m_inflatedBytes;
+        nanoem_u64_t m_frameMask;
+        nanoem_u32_t m_inflatedSize;
+    };
+    typedef tinystl::unordered_map<nanoem_u32_t, Chunk *, TinySTLAllocator> ChunkMap;
+    struct Track {
+        Track(nanoem_u64_t signature, nanoem_rsize_t numRigidBodies);
+        ~Track() NANOEM_DECL_NOEXCEPT;
+        nanoem_rsize_t frameSize() const NANOEM_DECL_NOEXCEPT;
+        const Chunk *findChunk(nanoem_frame_index_t frameIndex) const NANOEM_DECL_NOEXCEPT;
+        ChunkMap m_chunks;
+        nanoem_u64_t m_signature;
+        nanoem_u32_t m_numFrames;
+        nanoem_rsize_t m_numRigidBodies;
+    };
+    typedef tinystl::unordered_map<nanoem_u16_t, Track *, TinySTLAllocator> TrackMap;
+
+    static bool loadTrack(IReader *reader, nanoem_rsize_t &rest, Track *track, Error &error);
+    static void deflateChunk(Chunk *chunk);
+    static bool inflateChunk(const Chunk *chunk, ByteArray &bytes);
+    const Track *findTrack(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies) const
+        NANOEM_DECL_NOEXCEPT;
+
+    TrackMap m_tracks;
+    ByteArray m_inflatedBytes;
+    const Chunk *m_inflatedChunk;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_PHYSICSBAKECACHE_H_ */
@@ -0,0 +1,91 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_EMAPP_INTERNAL_VIDEOENCODINGPIPELINE_H_
+#define NANOEM_EMAPP_INTERNAL_VIDEOENCODINGPIPELINE_H_
+
+#include "emapp/Error.h"
+
+#include "bx/mutex.h"
+#include "bx/os.h"
+#if BX_CONFIG_SUPPORTS_THREADING
+#include "bx/thread.h"
+#else
+#include "emapp/internal/Stub.h"
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+
+namespace nanoem {
+namespace internal {
+
+/*
+ * Encodes frames on a dedicated thread in the submitted order. Frames and their audio slices are pooled and the
+ * pool bounds frames in flight, so the caller renders and reads back the next frame while the previous one is being
+ * encoded and waits (or skips advancing with tryAcquire) only when the encoder falls behind.
+ */
+class VideoEncodingPipeline NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    class IEncoder {
+    public:
+        virtual ~IEncoder() NANOEM_DECL_NOEXCEPT
+        {
+        }
+        virtual bool encodeAudioFrame(nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) = 0;
+        virtual bool encodeVideoFrame(nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) = 0;
+    };
+    struct Frame {
+        ByteArray m_videoData;
+        ByteArray m_audioData;
+        nanoem_frame_index_t m_pts;
+    };
+    static const nanoem_rsize_t kDefaultNumFrames = 6;
+
+    /* swaps R and B channels of RGBA8 pixels in place */
+    static void swizzleRGBA8(nanoem_u8_t *data, nanoem_rsize_t size) NANOEM_DECL_NOEXCEPT;
+
+    VideoEncodingPipeline(IEncoder *encoder, nanoem_rsize_t numFrames);
+    ~VideoEncodingPipeline() NANOEM_DECL_NOEXCEPT;
+
+    void start();
+    Frame *acquire();
+    Frame *tryAcquire();
+    void submit(Frame *frame);
+    void discard(Frame *frame);
+    void cancel();
+    bool finish(Error &error);
+    bool isFailed() const NANOEM_DECL_NOEXCEPT;
+
+private:
+    typedef tinystl::vector<Frame *, TinySTLAllocator> FrameList;
+#if BX_CONFIG_SUPPORTS_THREADING
+    static nanoem_i32_t execute(bx::Thread *thread, void *userData);
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+
+    Frame *popFreeFrame();
+    void encode(Frame *frame);
+
+    IEncoder *m_encoder;
+    FrameList m_allFrames;
+    FrameList m_freeFrames;
+    FrameList m_queuedFrames;
+#if BX_CONFIG_SUPPORTS_THREADING
+    bx::Thread m_thread;
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    mutable bx::Mutex m_mutex;
+    bx::Semaphore m_freeSemaphore;
+    bx::Semaphore m_queueSemaphore;
+    /* m_error, m_cancelled and m_failed are shared with the encoder thread and guarded by m_mutex */
+    Error m_error;
+    bool m_cancelled;
+    bool m_failed;
+    /* touched only by the caller thread */
+    bool m_running;
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+#endif /* NANOEM_EMAPP_INTERNAL_VIDEOENCODINGPIPELINE_H_ */
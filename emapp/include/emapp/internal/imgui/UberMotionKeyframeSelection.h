@@ -59,6 +59,8 @@ public:
     void addMorphKeyframes(const nanoem_model_morph_t * /* morph */, nanoem_frame_index_t /* start */,
         nanoem_frame_index_t /* end */) NANOEM_DECL_OVERRIDE;
     void addSelfShadowKeyframes(nanoem_frame_index_t /* start */, nanoem_frame_index_t /* end */) NANOEM_DECL_OVERRIDE;
+    void shiftAllKeyframes(
+        nanoem_u32_t /* flags */, nanoem_frame_index_t /* from */, int /* delta */) NANOEM_DECL_OVERRIDE;
 
 private:
     Motion::AccessoryKeyframeSet m_accessoryKeyframeSelection;
@@ -51,7 +51,7 @@ private:
     bool loadAllModels(const Archiver::EntryList &modelList, Error &error);
     bool loadModel(const String &entryPath, Error &error);
     bool loadAllMotions(const Archiver::EntryList &motionList, Error &error);
-    bool loadMotion(const Archiver::Entry &entry, Error &error);
+    bool loadMotion(const Archiver::Entry &entry, const ByteArray &bytes, Error &error);
     bool loadAllEffects(Native &native, Error &error);
     bool loadAllOffscreenEffectAttachments(Native &native, plugin::EffectPlugin *plugin, Error &error);
     bool loadOffscreenEffectAttachment(
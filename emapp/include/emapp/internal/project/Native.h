@@ -10,6 +10,8 @@
 
 #include "emapp/Project.h"
 
+struct Nanoem__Project__Project;
+
 namespace nanoem {
 namespace internal {
 namespace project {
@@ -33,11 +35,16 @@ public:
     typedef tinystl::vector<OffscreenRenderTargetEffectAttachment, TinySTLAllocator>
         OffscreenRenderTargetEffectAttachmentList;
 
+    /* the captured message owns all of its contents so it can be packed without the project */
+    static bool pack(const Nanoem__Project__Project *message, ByteArray &bytes);
+    static void release(Nanoem__Project__Project *message) NANOEM_DECL_NOEXCEPT;
+
     Native(Project *project);
     ~Native() NANOEM_DECL_NOEXCEPT;
 
     bool load(const nanoem_u8_t *data, size_t size, FileType type, Error &error, Project::IDiagnostics *diagsnotics);
     bool save(ByteArray &bytes, FileType type, Error &error);
+    Nanoem__Project__Project *capture(FileType type, Error &error);
 
     const Project::IncludeEffectSourceMap *findIncludeEffectSource(const IDrawable *drawable) const;
     Project::IncludeEffectSourceMap *findMutableIncludeEffectSource(const IDrawable *drawable);
@@ -4,14 +4,23 @@
    This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
 */
 
-#include "emapp/Forward.h"
+#include "emapp/Error.h"
+#include "emapp/URI.h"
+
+#include "bx/mutex.h"
+#include "bx/os.h"
+#if BX_CONFIG_SUPPORTS_THREADING
+#include "bx/thread.h"
+#else
+#include "emapp/internal/Stub.h"
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
 
 struct Nanoem__Application__Command;
+struct Nanoem__Project__Project;
 
 namespace nanoem {
 
 class BaseApplicationService;
-class Error;
 class ISeekableReader;
 class IWriter;
 class IModalDialog;
@@ -20,20 +29,43 @@ class Project;
 namespace internal {
 namespace project {
 
+/*
+ * Each record is the sequence, the type and the size followed by its payload. Command records contain the LZ4
+ * compressed command, checkpoint records contain the compressed project snapshot and the save point to restore
+ * drawable handles, and every group commit ends with an index record pointing the last checkpoint or save point.
+ */
 class Redo NANOEM_DECL_SEALED : private NonCopyable {
 public:
     static const nanoem_u32_t kFileMagic;
+    static const nanoem_u32_t kIndexMagic;
+    static const nanoem_u16_t kRecordTypeCheckpoint;
+    static const nanoem_u16_t kRecordTypeIndex;
+
+    static void writeCommandRecord(
+        IWriter *writer, nanoem_u32_t sequence, nanoem_u16_t type, const ByteArray &command, Error &error);
+    static void writeCheckpointRecord(IWriter *writer, nanoem_u32_t sequence, const ByteArray &snapshot,
+        nanoem_rsize_t snapshotSize, Error &error);
+    static void writeIndexRecord(IWriter *writer, nanoem_u32_t sequence, nanoem_i64_t restartOffset, Error &error);
+    static nanoem_i64_t findRestartOffset(ISeekableReader *reader, Error &error);
 
     Redo(Project *project);
     ~Redo() NANOEM_DECL_NOEXCEPT;
 
+    nanoem_i64_t restoreCheckpoint(ISeekableReader *reader, BaseApplicationService *application, Error &error);
     void loadAll(ISeekableReader *reader, BaseApplicationService *application, Error &error);
-    void loadAllAsync(ISeekableReader *reader, IModalDialog *dialog, bool *cancelled, Error &error);
+    void loadAllAsync(
+        ISeekableReader *reader, nanoem_i64_t offset, IModalDialog *dialog, bool *cancelled, Error &error);
     bool save(IWriter *writer, nanoem_u32_t sequence, const Nanoem__Application__Command *command, Error &error);
 
 private:
+    struct RecordHeader;
+    struct Index;
     static bool isAccepted(nanoem_u32_t value) NANOEM_DECL_NOEXCEPT;
-    static void getCountOffset(ISeekableReader *reader, nanoem_u32_t &count, nanoem_u32_t &offset, Error &error);
+    static bool readRecordHeader(ISeekableReader *reader, RecordHeader &header, Error &error);
+    static bool readIndex(ISeekableReader *reader, Index &index, Error &error);
+    static void scanAllRecords(ISeekableReader *reader, Index &index, Error &error);
+    static void findIndex(ISeekableReader *reader, Index &index, Error &error);
+    bool restoreSnapshot(const ByteArray &payload, BaseApplicationService *application, Error &error);
     void inflateChunk(const ByteArray &input, ByteArray &output);
     void sendCommandMessage(int commandStreamSocket, const ByteArray &inflated, nanoem_u16_t commandType,
         IWriter *writer, nanoem_u32_t sequence);
@@ -43,6 +75,64 @@ private:
     Project *m_project;
 };
 
+/*
+ * Appends redo records to the file on a dedicated thread. Records queued while the previous ones are being written
+ * are group committed with one open and write, so the caller only packs the command and never waits for the disk.
+ * Checkpoints take the ownership of the captured project and it is packed on the writer thread as well.
+ * flush must be called before reading the file or writing it from elsewhere.
+ */
+class RedoJournal NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    RedoJournal(const URI &fileURI, nanoem_u32_t checkpointInterval);
+    ~RedoJournal() NANOEM_DECL_NOEXCEPT;
+
+    void start();
+    void append(nanoem_u32_t sequence, const Nanoem__Application__Command *command, Error &error);
+    void appendCheckpoint(nanoem_u32_t sequence, const Nanoem__Application__Command *command,
+        Nanoem__Project__Project *snapshot, Error &error);
+    void flush(Error &error);
+    void stop();
+    bool isCheckpointRequired() const NANOEM_DECL_NOEXCEPT;
+    nanoem_u32_t checkpointInterval() const NANOEM_DECL_NOEXCEPT;
+    void setCheckpointInterval(nanoem_u32_t value);
+
+private:
+    struct Record {
+        ByteArray m_body;
+        Nanoem__Project__Project *m_snapshot;
+        nanoem_u32_t m_sequence;
+        nanoem_u16_t m_type;
+    };
+    typedef tinystl::vector<Record *, TinySTLAllocator> RecordList;
+#if BX_CONFIG_SUPPORTS_THREADING
+    static nanoem_i32_t execute(bx::Thread *thread, void *userData);
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+
+    static void destroyAllRecords(const RecordList &records) NANOEM_DECL_NOEXCEPT;
+
+    void enqueue(Record *record, Error &error);
+    void writeAllRecords(const RecordList &records);
+
+    const URI m_fileURI;
+    RecordList m_queuedRecords;
+#if BX_CONFIG_SUPPORTS_THREADING
+    bx::Thread m_thread;
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    bx::Mutex m_mutex;
+    bx::Semaphore m_queueSemaphore;
+    bx::Semaphore m_flushSemaphore;
+    Error m_error;
+    nanoem_u32_t m_numRecordsSinceRestart;
+    nanoem_u32_t m_checkpointInterval;
+    nanoem_u32_t m_numPendingRecords;
+    nanoem_u32_t m_numFlushWaiters;
+    bool m_running;
+    /* read and written only by writeAllRecords on the writer thread (or the caller without threading) */
+    nanoem_i64_t m_endOffset;
+    nanoem_i64_t m_restartOffset;
+    nanoem_u32_t m_lastSequence;
+};
+
 } /* namespace project */
 } /* namespace internal */
 } /* namespace nanoem */
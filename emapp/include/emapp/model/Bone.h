@@ -9,6 +9,7 @@
 #define NANOEM_EMAPP_MODEL_BONE_H_
 
 #include "emapp/Forward.h"
+#include "emapp/MotionKeyframeCursor.h"
 #include "emapp/model/Constraint.h"
 
 #include "bx/float4x4_t.h"
@@ -51,8 +52,13 @@ public:
     void resetLocalTransform() NANOEM_DECL_NOEXCEPT;
     void resetUserTransform() NANOEM_DECL_NOEXCEPT;
     void resetMorphTransform() NANOEM_DECL_NOEXCEPT;
+    void resolveMorphTransform() NANOEM_DECL_NOEXCEPT;
     void synchronizeMotion(const Motion *motion, const nanoem_model_bone_t *bone,
         const nanoem_model_rigid_body_t *rigidBodyPtr, nanoem_frame_index_t frameIndex, nanoem_f32_t amount);
+    void resolveMotionTrack(const Motion *motion, const nanoem_model_bone_t *bone) NANOEM_DECL_NOEXCEPT;
+    const nanoem_motion_track_t *motionTrack(
+        const Motion *motion, const nanoem_model_bone_t *bone) NANOEM_DECL_NOEXCEPT;
+    nanoem_motion_keyframe_cursor_t *motionKeyframeCursor(const Motion *motion) NANOEM_DECL_NOEXCEPT;
     void updateLocalOrientation(const nanoem_model_bone_t *bone, const Model *model) NANOEM_DECL_NOEXCEPT;
     void updateLocalTranslation(const nanoem_model_bone_t *bone) NANOEM_DECL_NOEXCEPT;
     void updateLocalMorphTransform(const nanoem_model_morph_bone_t *morph, nanoem_f32_t weight) NANOEM_DECL_NOEXCEPT;
@@ -71,6 +77,10 @@ public:
     void setDirty(bool value);
     bool isEditingMasked() const NANOEM_DECL_NOEXCEPT;
     void setEditingMasked(bool value);
+    bool isTransformDirty() const NANOEM_DECL_NOEXCEPT;
+    void setTransformDirty(bool value) NANOEM_DECL_NOEXCEPT;
+    nanoem_u64_t transformSequence() const NANOEM_DECL_NOEXCEPT;
+    void setTransformSequence(nanoem_u64_t value) NANOEM_DECL_NOEXCEPT;
 
     static void constrainOrientation(
         const Vector3 &upperLimit, const Vector3 &lowerLimit, Quaternion &orientation) NANOEM_DECL_NOEXCEPT;
@@ -137,17 +147,16 @@ private:
         bool m_enableLinearInterpolation[NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_MAX_ENUM];
     };
     static void destroy(void *opaque, nanoem_model_object_t *object) NANOEM_DECL_NOEXCEPT;
-    static void synchronizeTransform(const Motion *motion, const nanoem_model_bone_t *bone,
+    static void synchronizeTransform(const Motion *motion, const nanoem_motion_track_t *track,
+        nanoem_motion_keyframe_cursor_t *cursor, const nanoem_model_bone_t *bone,
         const nanoem_model_rigid_body_t *rigidBodyPtr, nanoem_frame_index_t frameIndex, FrameTransform &transform);
     static void createConstraintUnitAxes(const Vector3 &radians, const Vector3 &lowerLimit, const Vector3 &upperLimit,
         Quaternion &x, Quaternion &y, Quaternion &z) NANOEM_DECL_NOEXCEPT;
-    static void constrainOrientation(
-        const nanoem_model_constraint_joint_t *joint, Quaternion &orientation) NANOEM_DECL_NOEXCEPT;
     static Vector3 toVector3(const nanoem_f32_t *value) NANOEM_DECL_NOEXCEPT;
     static Quaternion toQuaternion(const nanoem_f32_t *value) NANOEM_DECL_NOEXCEPT;
 
-    void solveConstraint(const nanoem_model_constraint_t *constraintPtr, int numIterations);
-    void solveConstraint(const nanoem_model_bone_t *bone);
+    void solveConstraint(const nanoem_model_constraint_t *constraintPtr, int numIterations, const Model *model);
+    void solveConstraint(const nanoem_model_bone_t *bone, const Model *model);
     Bone(const PlaceHolder &holder) NANOEM_DECL_NOEXCEPT;
 
     String m_name;
@@ -163,6 +172,11 @@ private:
     Vector3 m_localMorphTranslation;
     Vector3 m_localUserTranslation;
     Vector4U8 m_bezierControlPoints[NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_MAX_ENUM];
+    const nanoem_motion_t *m_resolvedMotion;
+    const nanoem_motion_track_t *m_motionTrack;
+    MotionKeyframeCursor m_motionCursor;
+    nanoem_rsize_t m_numResolvedMotionTracks;
+    nanoem_u64_t m_transformSequence;
     nanoem_u32_t m_states;
 };
 
@@ -13,6 +13,8 @@
 namespace nanoem {
 namespace model {
 
+class Bone;
+
 class Constraint NANOEM_DECL_SEALED : private NonCopyable {
 public:
     typedef tinystl::vector<const nanoem_model_constraint_t *, TinySTLAllocator> List;
@@ -37,6 +39,18 @@ public:
         Vector3 m_axis;
         nanoem_f32_t m_angle;
     };
+    struct ResolvedJoint {
+        const nanoem_model_constraint_joint_t *m_opaque;
+        const nanoem_model_bone_t *m_bonePtr;
+        Bone *m_bone;
+        Vector3 m_upperLimit;
+        Vector3 m_lowerLimit;
+        Vector3 m_fixedAxis;
+        Vector3 m_limitedAxis;
+        bool m_hasAngleLimit;
+        bool m_hasUnitXConstraint;
+    };
+    typedef tinystl::vector<ResolvedJoint, TinySTLAllocator> ResolvedJointList;
     typedef tinystl::vector<Joint, TinySTLAllocator> JointIteration;
     typedef tinystl::unordered_map<const nanoem_model_constraint_joint_t *, JointIteration, TinySTLAllocator>
         JointIterationResult;
@@ -54,6 +68,7 @@ public:
         const Vector4 &targetPosition, Joint *result) NANOEM_DECL_NOEXCEPT;
     static bool hasUnitXConstraint(
         const nanoem_model_bone_t *bone, nanoem_unicode_string_factory_t *factory) NANOEM_DECL_NOEXCEPT;
+    static bool isConverged(const Vector3 &effectorPosition, const Vector3 &targetPosition) NANOEM_DECL_NOEXCEPT;
 
     void bind(nanoem_model_constraint_t *constraintPtr);
     void resetLanguage(const nanoem_model_constraint_t *constraintPtr, nanoem_unicode_string_factory_t *factory,
@@ -64,12 +79,19 @@ public:
     const JointIterationResult *effectorIterationResult() const NANOEM_DECL_NOEXCEPT;
     Joint *jointIterationResult(const nanoem_model_constraint_joint_t *joint, nanoem_rsize_t offset);
     Joint *effectorIterationResult(const nanoem_model_constraint_joint_t *joint, nanoem_rsize_t offset);
+    const ResolvedJointList &resolveAllJoints(
+        const nanoem_model_constraint_t *constraintPtr, nanoem_unicode_string_factory_t *factory);
+    void invalidateAllJoints();
     String name() const;
     String canonicalName() const;
     const char *nameConstString() const NANOEM_DECL_NOEXCEPT;
     const char *canonicalNameConstString() const NANOEM_DECL_NOEXCEPT;
     bool isEnabled() const NANOEM_DECL_NOEXCEPT;
     void setEnabled(bool value);
+    bool isIterationResultCaptured() const NANOEM_DECL_NOEXCEPT;
+    void setIterationResultCaptured(bool value);
+    nanoem_rsize_t numSolvedIterations() const NANOEM_DECL_NOEXCEPT;
+    void setNumSolvedIterations(nanoem_rsize_t value);
 
 private:
     struct PlaceHolder {
@@ -77,10 +99,12 @@ private:
     static void destroy(void *opaque, nanoem_model_object_t *constraint) NANOEM_DECL_NOEXCEPT;
     Constraint(const PlaceHolder &holder) NANOEM_DECL_NOEXCEPT;
 
+    ResolvedJointList m_resolvedJoints;
     JointIterationResult m_jointIterationResult;
     JointIterationResult m_effectorIterationResult;
     String m_name;
     String m_canonicalName;
+    nanoem_rsize_t m_numSolvedIterations;
     nanoem_u32_t m_states;
 };
 
@@ -9,6 +9,9 @@
 #define NANOEM_EMAPP_MODEL_MORPH_H_
 
 #include "emapp/Forward.h"
+#include "emapp/MotionKeyframeCursor.h"
+
+#include "bx/float4x4_t.h"
 
 namespace nanoem {
 
@@ -16,6 +19,8 @@ class Motion;
 
 namespace model {
 
+class Vertex;
+
 class Morph NANOEM_DECL_SEALED : private NonCopyable {
 public:
     typedef tinystl::vector<const nanoem_model_morph_t *, TinySTLAllocator> List;
@@ -31,6 +36,11 @@ public:
     void reset() NANOEM_DECL_NOEXCEPT;
     void synchronizeMotion(const Motion *motion, const nanoem_unicode_string_t *name, nanoem_frame_index_t frameIndex,
         nanoem_f32_t amount);
+    void resolveMotionTrack(const Motion *motion, const nanoem_unicode_string_t *name) NANOEM_DECL_NOEXCEPT;
+    void deformAllVertices(const nanoem_model_morph_t *morph, nanoem_f32_t weight);
+    void invalidateAllVertexDeltas();
+    const nanoem_motion_track_t *motionTrack(
+        const Motion *motion, const nanoem_unicode_string_t *name) NANOEM_DECL_NOEXCEPT;
 
     static int index(const nanoem_model_morph_t *morphPtr) NANOEM_DECL_NOEXCEPT;
     static const char *nameConstString(
@@ -55,14 +65,27 @@ private:
     struct PlaceHolder {
     };
     static void destroy(void *opaque, nanoem_model_object_t *morph) NANOEM_DECL_NOEXCEPT;
-    static void synchronizeWeight(const Motion *motion, nanoem_frame_index_t frameIndex,
-        const nanoem_unicode_string_t *name, nanoem_f32_t &weight);
+    static void synchronizeWeight(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor,
+        nanoem_frame_index_t frameIndex, nanoem_f32_t &weight);
+    typedef tinystl::vector<Vertex *, TinySTLAllocator> VertexList;
+    typedef tinystl::vector<bx::simd128_t, TinySTLAllocator> DeltaList;
     Morph(const PlaceHolder &holder) NANOEM_DECL_NOEXCEPT;
 
+    void resolveAllVertexDeltas(const nanoem_model_morph_t *morph);
+
     String m_name;
     String m_canonicalName;
+    const nanoem_motion_t *m_resolvedMotion;
+    const nanoem_unicode_string_t *m_resolvedName;
+    const nanoem_motion_track_t *m_motionTrack;
+    MotionKeyframeCursor m_motionCursor;
+    nanoem_rsize_t m_numResolvedMotionTracks;
+    VertexList m_deltaVertices;
+    DeltaList m_deltas;
+    int m_deltaIndex;
     nanoem_f32_t m_weight;
     bool m_dirty;
+    bool m_deltaResolved;
 };
 
 } /* namespace model */
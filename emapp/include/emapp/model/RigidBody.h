@@ -81,6 +81,7 @@ public:
     PhysicsEngine *physicsEngine() const NANOEM_DECL_NOEXCEPT;
     nanoem_physics_rigid_body_t *physicsRigidBody() const NANOEM_DECL_NOEXCEPT;
     Matrix4x4 worldTransform() const NANOEM_DECL_NOEXCEPT;
+    void setWorldTransform(const Matrix4x4 &value) NANOEM_DECL_NOEXCEPT;
     Matrix4x4 initialTransform() const NANOEM_DECL_NOEXCEPT;
     bool isKinematic() const NANOEM_DECL_NOEXCEPT;
     bool isEditingMasked() const NANOEM_DECL_NOEXCEPT;
@@ -8,12 +8,15 @@
 #ifndef NANOEM_EMAPP_MODEL_VALIDATOR_H_
 #define NANOEM_EMAPP_MODEL_VALIDATOR_H_
 
-#include "emapp/Forward.h"
+#include "emapp/Model.h"
 
 namespace nanoem {
 
 class ITranslator;
-class Model;
+
+namespace internal {
+class ParallelTaskDispatcher;
+} /* namespace internal */
 
 namespace model {
 
@@ -104,6 +107,8 @@ public:
         } u;
     };
     typedef tinystl::vector<Diagnostics, TinySTLAllocator> DiagnosticsList;
+    static const nanoem_rsize_t kNumVerticesPerChunk;
+    static const nanoem_rsize_t kNumFacesPerChunk;
 
     static bool validateParentBone(
         const nanoem_model_bone_t *bonePtr, const nanoem_model_bone_t *parentBonePtr) NANOEM_DECL_NOEXCEPT;
@@ -128,13 +133,44 @@ public:
     Validator();
     ~Validator() NANOEM_DECL_NOEXCEPT;
 
+    /*
+     * vertices and faces are validated in chunks on worker threads and the result of the previous call is reused
+     * for objects not edited since then, so diagnostics are always in the same order as validating serially
+     */
     void validate(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
+    void invalidate();
     void format(const Diagnostics &diag, const ITranslator *translator, String &text);
 
 private:
+    struct Task {
+        Model::EditObjectType m_type;
+        const Model *m_model;
+        nanoem_rsize_t m_offset;
+        nanoem_rsize_t m_size;
+        nanoem_u32_t m_filter;
+        DiagnosticsList *m_result;
+    };
+    typedef tinystl::vector<Task, TinySTLAllocator> TaskList;
+    typedef tinystl::vector<DiagnosticsList, TinySTLAllocator> DiagnosticsListArray;
+    typedef tinystl::vector<const void *, TinySTLAllocator> ObjectList;
+    typedef tinystl::vector<nanoem_u32_t, TinySTLAllocator> VertexIndexList;
+
+    static void handleValidationTask(void *opaque, size_t index);
+    static void validateAllVertexObjects(const Model *model, nanoem_rsize_t offset, nanoem_rsize_t size,
+        nanoem_u32_t filter, DiagnosticsList &result);
+    static void validateAllFaces(const Model *model, nanoem_rsize_t offset, nanoem_rsize_t size, nanoem_u32_t filter,
+        DiagnosticsList &result);
+    static void validateAllUnusedVertexObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
+    static void appendAllDiagnostics(const DiagnosticsListArray &source, DiagnosticsList &result);
+    static void appendAllDiagnostics(const DiagnosticsList &source, DiagnosticsList &result);
+    static bool updateObjectList(const void *const *objects, nanoem_rsize_t numObjects, ObjectList &cachedObjects);
+    static bool updateVertexIndexList(
+        const nanoem_u32_t *indices, nanoem_rsize_t numIndices, VertexIndexList &cachedIndices);
+
+    bool isEdited(const Model *model, Model::EditObjectType type) const NANOEM_DECL_NOEXCEPT;
+    void addAllVertexTasks(const Model *model, nanoem_u32_t filter, bool structureChanged, TaskList &tasks);
+    void addAllFaceTasks(const Model *model, nanoem_u32_t filter, TaskList &tasks);
     void validateModelInfo(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
-    void validateAllVertexObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
-    void validateAllFaces(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
     void validateAllMaterialObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
     void validateAllBoneObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
     void validateAllMorphObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
@@ -142,6 +178,16 @@ private:
     void validateAllRigidBodyObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
     void validateAllJointObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
     void validateAllSoftBodyObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result);
+
+    internal::ParallelTaskDispatcher *m_dispatcher;
+    const Model *m_model;
+    ObjectList m_objects[Model::kEditObjectTypeMaxEnum];
+    VertexIndexList m_vertexIndices;
+    DiagnosticsList m_diagnostics[Model::kEditObjectTypeMaxEnum];
+    DiagnosticsListArray m_vertexChunkDiagnostics;
+    DiagnosticsListArray m_faceChunkDiagnostics;
+    nanoem_u32_t m_filter;
+    nanoem_u32_t m_generation;
 };
 
 } /* namespace model */
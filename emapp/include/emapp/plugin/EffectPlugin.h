@@ -32,6 +32,8 @@ public:
     bool compile(const String &input, ByteArray &output);
     void addIncludeSource(const String &path, const nanoem_u8_t *data, nanoem_rsize_t size);
     StringList availableExtensions() const;
+    /* changes whenever the compiler binary is replaced, used to invalidate compiled effect caches */
+    nanoem_u64_t revision() const NANOEM_DECL_NOEXCEPT;
 
     const char *failureReason() const NANOEM_DECL_NOEXCEPT_OVERRIDE;
     const char *recoverySuggestion() const NANOEM_DECL_NOEXCEPT_OVERRIDE;
@@ -64,6 +66,7 @@ private:
     typedef void(APIENTRY *PFN_nanoemApplicationPluginEffectCompilerTerminate)();
 
     nanoem_application_plugin_effect_compiler_t *m_compiler;
+    nanoem_u64_t m_revision;
     PFN_nanoemApplicationPluginEffectCompilerInitialize _effectCompilerInitialize;
     PFN_nanoemApplicationPluginEffectCompilerCreate _effectCompilerCreate;
     PFN_nanoemApplicationPluginEffectCompilerGetOption _effectCompilerGetOption;
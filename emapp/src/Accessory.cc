@@ -359,24 +359,39 @@ Accessory::uploadArchive(const String &entryPoint, const Archiver &archiver, Pro
     bool succeeded = false;
     if (archiver.findEntry(entryPoint, entry, error)) {
         ByteArray bytes;
-        archiver.extract(entry, bytes, error);
         if (archiver.extract(entry, bytes, error) && !bytes.empty() && load(bytes.data(), bytes.size(), error)) {
             SG_PUSH_GROUPF("Accessory::uploadArchive(name=%s)", canonicalNameConstString());
             upload();
-            ImageLoader *imageLoader = m_project->sharedImageLoader();
+            Archiver::EntryList entries;
+            ByteArrayList bytesList;
+            ImageLoader::Batch batch(m_project->sharedImageLoader(), this);
             for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
                  it != end; ++it) {
+                Archiver::Entry imageEntry;
+                imageEntry.m_path = (*it)->m_fileURI.fragment();
+                entries.push_back(imageEntry);
+            }
+            /*
+             * the archiver cannot be shared with worker threads so all entries are extracted before decoding.
+             * missing images fall back to 1x1 pixel images below so their extraction errors are not propagated
+             */
+            Error extractError;
+            archiver.extractAll(entries, bytesList, extractError);
+            nanoem_rsize_t index = 0;
+            for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
+                 it != end; ++it, ++index) {
+                batch.add(bytesList[index], (*it)->m_filename, SG_WRAP_REPEAT, 0);
+            }
+            batch.decodeAll();
+            index = 0;
+            for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
+                 it != end; ++it, ++index) {
                 const LoadingImageItem *item = *it;
-                const URI &fileURI = item->m_fileURI;
-                const String &filename = fileURI.fragment();
-                if (!progress.tryLoadingItem(fileURI)) {
+                if (!progress.tryLoadingItem(item->m_fileURI)) {
                     error = Error::cancelled();
                     break;
                 }
-                else if (archiver.findEntry(filename, entry, error) && archiver.extract(entry, bytes, error)) {
-                    imageLoader->decode(bytes, item->m_filename, this, SG_WRAP_REPEAT, 0, error);
-                }
-                else {
+                else if (!batch.upload(index, error)) {
                     sg_image_desc desc;
                     const nanoem_u32_t pixel = item->m_usingWhiteFallback ? 0xffffffff : 0x0;
                     ImageLoader::fill1x1PixelImage(&pixel, desc);
@@ -409,16 +424,23 @@ void
 Accessory::loadAllImages(Progress &progress, Error &error)
 {
     SG_PUSH_GROUPF("Accessory::loadAllImages(name=%s)", canonicalNameConstString());
-    ImageLoader *imageLoader = m_project->sharedImageLoader();
+    ImageLoader::Batch batch(m_project->sharedImageLoader(), this);
     for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
          it != end; ++it) {
         const LoadingImageItem *item = *it;
-        const URI &fileURI = item->m_fileURI;
-        if (!progress.tryLoadingItem(fileURI)) {
+        batch.add(item->m_fileURI, SG_WRAP_REPEAT, ImageLoader::kFlagsEnableMipmap);
+    }
+    /* decodes on worker threads and only uploads to the device from this thread */
+    batch.decodeAll();
+    nanoem_rsize_t index = 0;
+    for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
+         it != end; ++it, ++index) {
+        const LoadingImageItem *item = *it;
+        if (!progress.tryLoadingItem(item->m_fileURI)) {
             error = Error::cancelled();
             break;
         }
-        else if (!imageLoader->load(fileURI, this, SG_WRAP_REPEAT, ImageLoader::kFlagsEnableMipmap, error)) {
+        else if (!batch.upload(index, error)) {
             sg_image_desc desc;
             const nanoem_u32_t pixel = item->m_usingWhiteFallback ? 0xffffffff : 0x0;
             ImageLoader::fill1x1PixelImage(&pixel, desc);
@@ -507,7 +529,8 @@ Accessory::synchronizeMotion(const Motion *motion, nanoem_frame_index_t frameInd
 {
     const nanoem_motion_accessory_keyframe_t *keyframe;
     if (motion) {
-        keyframe = motion->findAccessoryKeyframe(frameIndex);
+        nanoem_motion_keyframe_cursor_t *cursor = m_motionCursor.resolve(motion);
+        keyframe = nanoemMotionFindAccessoryKeyframeObjectWithCursor(motion->data(), cursor, frameIndex);
         m_outsideParent = StringPair();
         if (keyframe) {
             setTranslation(glm::make_vec3(nanoemMotionAccessoryKeyframeGetTranslation(keyframe)));
@@ -527,7 +550,8 @@ Accessory::synchronizeMotion(const Motion *motion, nanoem_frame_index_t frameInd
         }
         else {
             nanoem_motion_accessory_keyframe_t *prevKeyframe, *nextKeyframe;
-            nanoemMotionSearchClosestAccessoryKeyframes(motion->data(), frameIndex, &prevKeyframe, &nextKeyframe);
+            nanoemMotionSearchClosestAccessoryKeyframesWithCursor(
+                motion->data(), cursor, frameIndex, &prevKeyframe, &nextKeyframe);
             if (prevKeyframe && nextKeyframe) {
                 const nanoem_f32_t &coef = Motion::coefficient(prevKeyframe, nextKeyframe, frameIndex);
                 setTranslation(glm::mix(glm::make_vec3(nanoemMotionAccessoryKeyframeGetTranslation(prevKeyframe)),
@@ -25,6 +25,8 @@ static const char kPreferredEditingFPS[] = "editing.motion.fps";
 static const char kSkinDeformAcceleratorEnabled[] = "renderer.sda.enabled";
 static const char kCrashReporterEnabled[] = "crashReporter.enabled";
 static const char kUndoSoftLimit[] = "undo.limit";
+static const char kUndoMemoryBudget[] = "undo.memory";
+static const char kPhysicsIslandEnabled[] = "physics.island.enabled";
 static const char kEffectEnabled[] = "effect.enabled";
 static const char kEffectCacheEnabled[] = "effect.cached";
 static const char kHighDPIViewportMode[] = "viewport.highDPI";
@@ -39,6 +41,7 @@ static const int kBufferSize = 128;
 } /* namespace anonymous */
 
 const int ApplicationPreference::kUndoSoftLimitDefaultValue = 64;
+const int ApplicationPreference::kUndoMemoryBudgetDefaultValue = 256;
 const int ApplicationPreference::kGFXBufferPoolSizeDefaultValue = 0x2000;
 const int ApplicationPreference::kGFXImagePoolSizeDefaultValue = 0x8000;
 const int ApplicationPreference::kGFXShaderPoolSizeDefaultValue = 0x2000;
@@ -238,6 +241,18 @@ ApplicationPreference::setUndoSoftLimit(int value)
     writeInt(kUndoSoftLimit, value);
 }
 
+int
+ApplicationPreference::undoMemoryBudget() const NANOEM_DECL_NOEXCEPT
+{
+    return glm::clamp(readInt(kUndoMemoryBudget, kUndoMemoryBudgetDefaultValue), 16, 0x4000);
+}
+
+void
+ApplicationPreference::setUndoMemoryBudget(int value)
+{
+    writeInt(kUndoMemoryBudget, value);
+}
+
 bool
 ApplicationPreference::isModelEditingEnabled() const NANOEM_DECL_NOEXCEPT
 {
@@ -286,6 +301,18 @@ ApplicationPreference::setSkinDeformAcceleratorEnabled(bool value)
     writeBool(kSkinDeformAcceleratorEnabled, value);
 }
 
+bool
+ApplicationPreference::isPhysicsIslandEnabled() const NANOEM_DECL_NOEXCEPT
+{
+    return readBool(kPhysicsIslandEnabled, false);
+}
+
+void
+ApplicationPreference::setPhysicsIslandEnabled(bool value)
+{
+    writeBool(kPhysicsIslandEnabled, value);
+}
+
 bool
 ApplicationPreference::isCrashReportEnabled() const NANOEM_DECL_NOEXCEPT
 {
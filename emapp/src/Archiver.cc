@@ -9,6 +9,7 @@
 #include "emapp/Error.h"
 #include "emapp/FileUtils.h"
 #include "emapp/StringUtils.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
 #include "emapp/private/CommonInclude.h"
 
 #include "mz.h"
@@ -20,6 +21,167 @@
 namespace nanoem {
 
 struct Archiver::Opaque : mz_stream {
+    /* bounds memory of the entries kept until they are compressed and written */
+    static const nanoem_rsize_t kMaxPendingEntryBytes = 64 * 1024 * 1024;
+
+    struct PendingEntry {
+        PendingEntry(const Entry &entry, const ByteArray &bytes)
+            : m_entry(entry)
+            , m_bytes(bytes)
+        {
+        }
+        Entry m_entry;
+        ByteArray m_bytes;
+        ByteArray m_compressed;
+    };
+    typedef tinystl::vector<PendingEntry *, TinySTLAllocator> PendingEntryList;
+    struct ExtractingEntry {
+        ExtractingEntry(const Entry *entryPtr, ByteArray *bytesPtr, nanoem_u32_t crc, nanoem_u16_t method)
+            : m_entryPtr(entryPtr)
+            , m_bytesPtr(bytesPtr)
+            , m_crc(crc)
+            , m_method(method)
+            , m_result(MZ_OK)
+        {
+        }
+        ByteArray m_compressed;
+        const Entry *m_entryPtr;
+        ByteArray *m_bytesPtr;
+        nanoem_u32_t m_crc;
+        nanoem_u16_t m_method;
+        int m_result;
+    };
+    typedef tinystl::vector<ExtractingEntry *, TinySTLAllocator> ExtractingEntryList;
+
+    static nanoem_u32_t
+    checksum(const ByteArray &bytes) NANOEM_DECL_NOEXCEPT
+    {
+        return nanoem_u32_t(crc32(crc32(0, Z_NULL, 0), bytes.data(), uInt(bytes.size())));
+    }
+    static void
+    compressEntry(void *opaque, size_t index)
+    {
+        PendingEntry *pending = static_cast<PendingEntry **>(opaque)[index];
+        Entry &entry = pending->m_entry;
+        const ByteArray &bytes = pending->m_bytes;
+        const nanoem_rsize_t size = bytes.size();
+        entry.m_crc = checksum(bytes);
+        entry.m_uncompressedSize = entry.m_compressedSize = size;
+        if (entry.m_method == Z_DEFLATED && size > 0 && !isIncompressible(bytes.data(), size)) {
+            z_stream stream;
+            Inline::clearZeroMemory(stream);
+            if (deflateInit2(&stream, entry.m_level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) == Z_OK) {
+                ByteArray &compressed = pending->m_compressed;
+                compressed.resize(deflateBound(&stream, uLong(size)));
+                stream.next_in = const_cast<Bytef *>(bytes.data());
+                stream.avail_in = uInt(size);
+                stream.next_out = compressed.data();
+                stream.avail_out = uInt(compressed.size());
+                /* stored as is when deflate does not make it smaller */
+                if (deflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out < size) {
+                    compressed.resize(stream.total_out);
+                    entry.m_compressedSize = stream.total_out;
+                }
+                else {
+                    compressed.clear();
+                }
+                deflateEnd(&stream);
+            }
+        }
+        if (pending->m_compressed.empty()) {
+            entry.m_method = MZ_COMPRESS_METHOD_STORE;
+        }
+        entry.m_raw = 1;
+    }
+    static void
+    decompressEntry(void *opaque, size_t index)
+    {
+        ExtractingEntry *extracting = static_cast<ExtractingEntry **>(opaque)[index];
+        const ByteArray &compressed = extracting->m_compressed;
+        ByteArray &bytes = *extracting->m_bytesPtr;
+        int rc = MZ_OK;
+        if (bytes.empty()) {
+            /* nothing to inflate */
+        }
+        else if (extracting->m_method == MZ_COMPRESS_METHOD_STORE) {
+            if (compressed.size() == bytes.size()) {
+                memcpy(bytes.data(), compressed.data(), bytes.size());
+            }
+            else {
+                rc = MZ_FORMAT_ERROR;
+            }
+        }
+        else {
+            z_stream stream;
+            Inline::clearZeroMemory(stream);
+            rc = MZ_DATA_ERROR;
+            if (inflateInit2(&stream, -MAX_WBITS) == Z_OK) {
+                stream.next_in = const_cast<Bytef *>(compressed.data());
+                stream.avail_in = uInt(compressed.size());
+                stream.next_out = bytes.data();
+                stream.avail_out = uInt(bytes.size());
+                if (inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out == bytes.size()) {
+                    rc = MZ_OK;
+                }
+                inflateEnd(&stream);
+            }
+        }
+        if (rc == MZ_OK && checksum(bytes) != extracting->m_crc) {
+            rc = MZ_CRC_ERROR;
+        }
+        extracting->m_result = rc;
+    }
+    static int
+    readEntry(void *file, nanoem_u8_t raw, ByteArray &bytes)
+    {
+        int rc = mz_zip_entry_read_open(file, raw, nullptr);
+        if (rc == MZ_OK) {
+            nanoem_rsize_t offset = 0, size = bytes.size();
+            while (offset < size) {
+                const nanoem_i32_t read =
+                    mz_zip_entry_read(file, bytes.data() + offset, Inline::saturateInt32(size - offset));
+                if (read <= 0) {
+                    rc = read < 0 ? read : MZ_READ_ERROR;
+                    break;
+                }
+                offset += read;
+            }
+            const int closed = mz_zip_entry_close(file);
+            if (rc == MZ_OK) {
+                rc = closed;
+            }
+        }
+        return rc;
+    }
+    static void
+    appendFailedEntry(const Entry &entry, nanoem_rsize_t &numFailedEntries, String &failedPaths)
+    {
+        if (numFailedEntries > 0) {
+            failedPaths.append(", ");
+        }
+        failedPaths.append(entry.m_path.empty() ? "(empty)" : entry.m_path.c_str());
+        numFailedEntries++;
+    }
+    static bool
+    isMPEGAudioFrameHeader(const nanoem_u8_t *data) NANOEM_DECL_NOEXCEPT
+    {
+        bool result = false;
+        if (data[0] == 0xff && (data[1] & 0xf6) == 0xf0) {
+            /* AAC ADTS with a valid sampling frequency index */
+            result = ((data[2] >> 2) & 0xf) < 13;
+        }
+        else if (data[0] == 0xff && (data[1] & 0xe0) == 0xe0) {
+            /*
+             * MPEG audio Layer II/III only, the reserved version, bitrate and sampling rate are rejected. Layer I
+             * is excluded as its sync word overlaps with UTF-16LE BOM (FF FE) and FF FF padding.
+             */
+            const nanoem_u8_t version = (data[1] >> 3) & 0x3, layer = (data[1] >> 1) & 0x3,
+                              bitrate = (data[2] >> 4) & 0xf, samplingRate = (data[2] >> 2) & 0x3;
+            result = version != 1 && (layer == 1 || layer == 2) && bitrate != 0 && bitrate != 0xf &&
+                samplingRate != 3;
+        }
+        return result;
+    }
     static nanoem_i32_t
     internalSeek(ISeekable *seekable, int64_t offset, int origin)
     {
@@ -118,6 +280,10 @@ struct Archiver::Opaque : mz_stream {
         info.extrafield_size = Opaque::saturateInt16(entry.m_fileExtraField.size());
         info.filename = entry.m_path.c_str();
         info.filename_size = Opaque::saturateInt16(entry.m_path.size());
+        if (entry.m_raw) {
+            info.compressed_size = int64_t(entry.m_compressedSize);
+            info.uncompressed_size = int64_t(entry.m_uncompressedSize);
+        }
     }
     static void
     toEntry(const mz_zip_file *info, Archiver::Entry &entry)
@@ -133,6 +299,8 @@ struct Archiver::Opaque : mz_stream {
         : m_reader(reader)
         , m_writer(nullptr)
         , m_zip(nullptr)
+        , m_dispatcher(nullptr)
+        , m_numPendingEntryBytes(0)
     {
         initialize();
     }
@@ -140,13 +308,17 @@ struct Archiver::Opaque : mz_stream {
         : m_reader(nullptr)
         , m_writer(writer)
         , m_zip(nullptr)
+        , m_dispatcher(nullptr)
+        , m_numPendingEntryBytes(0)
     {
         initialize();
     }
     ~Opaque() NANOEM_DECL_NOEXCEPT
     {
         Error error;
+        handleFlush(error);
         handleClose(error);
+        nanoem_delete_safe(m_dispatcher);
     }
     bool
     handleOpen(Error &error)
@@ -173,6 +345,66 @@ struct Archiver::Opaque : mz_stream {
         return m_zip && rc == MZ_OK;
     }
     bool
+    handleFlush(Error &error)
+    {
+        int rc = MZ_OK;
+        if (!m_pendingEntries.empty()) {
+            dispatcher()->dispatch(compressEntry, m_pendingEntries.data(), m_pendingEntries.size());
+            for (PendingEntryList::const_iterator it = m_pendingEntries.begin(), end = m_pendingEntries.end();
+                 it != end; ++it) {
+                PendingEntry *pending = *it;
+                if (rc == MZ_OK) {
+                    rc = writeRawEntry(pending);
+                    if (rc != MZ_OK && !error.hasReason()) {
+                        char buffer[Inline::kLongNameStackBufferSize];
+                        StringUtils::format(buffer, sizeof(buffer), "Cannot add file entry to the zip: %s",
+                            pending->m_entry.m_path.c_str());
+                        error = Error(buffer, rc, Error::kDomainTypeMinizip);
+                    }
+                }
+                nanoem_delete(pending);
+            }
+            m_pendingEntries.clear();
+            m_numPendingEntryBytes = 0;
+        }
+        return rc == MZ_OK;
+    }
+    int
+    writeRawEntry(const PendingEntry *pending)
+    {
+        int rc = MZ_PARAM_ERROR;
+        if (void *file = m_zip) {
+            const Entry &entry = pending->m_entry;
+            const ByteArray &bytes = pending->m_compressed.empty() ? pending->m_bytes : pending->m_compressed;
+            mz_zip_file info;
+            fromEntry(entry, info);
+            rc = mz_zip_entry_write_open(file, &info, entry.m_level, entry.m_raw, nullptr);
+            nanoem_rsize_t offset = 0, size = bytes.size();
+            while (rc == MZ_OK && offset < size) {
+                const nanoem_i32_t written =
+                    mz_zip_entry_write(file, bytes.data() + offset, Inline::saturateInt32(size - offset));
+                if (written <= 0) {
+                    rc = written < 0 ? written : MZ_WRITE_ERROR;
+                }
+                else {
+                    offset += written;
+                }
+            }
+            if (rc == MZ_OK) {
+                rc = mz_zip_entry_close_raw(file, int64_t(entry.m_uncompressedSize), entry.m_crc);
+            }
+        }
+        return rc;
+    }
+    internal::ParallelTaskDispatcher *
+    dispatcher()
+    {
+        if (!m_dispatcher) {
+            m_dispatcher = nanoem_new(internal::ParallelTaskDispatcher("com.github.nanoem.gcd.archiver"));
+        }
+        return m_dispatcher;
+    }
+    bool
     handleClose(Error &error)
     {
         int rc = MZ_OK;
@@ -210,6 +442,9 @@ struct Archiver::Opaque : mz_stream {
     ISeekableWriter *m_writer;
     Error m_error;
     void *m_zip;
+    internal::ParallelTaskDispatcher *m_dispatcher;
+    PendingEntryList m_pendingEntries;
+    nanoem_rsize_t m_numPendingEntryBytes;
 };
 
 Archiver::Entry::Entry()
@@ -310,6 +545,37 @@ Archiver::~Archiver() NANOEM_DECL_NOEXCEPT
     nanoem_delete_safe(m_opaque);
 }
 
+bool
+Archiver::isIncompressible(const nanoem_u8_t *data, nanoem_rsize_t size) NANOEM_DECL_NOEXCEPT
+{
+    static const nanoem_u8_t kPNGSignature[] = { 0x89, 'P', 'N', 'G', 0x0d, 0x0a, 0x1a, 0x0a };
+    static const nanoem_u8_t kMatroskaSignature[] = { 0x1a, 0x45, 0xdf, 0xa3 };
+    static const nanoem_u8_t kXZSignature[] = { 0xfd, '7', 'z', 'X', 'Z', 0x00 };
+    static const nanoem_u32_t kDDSPixelFormatFourCC = 0x4;
+    bool result = false;
+    if (size >= 12) {
+        const char *ptr = reinterpret_cast<const char *>(data);
+        if (memcmp(data, kPNGSignature, sizeof(kPNGSignature)) == 0 || (data[0] == 0xff && data[1] == 0xd8) ||
+            memcmp(ptr, "GIF8", 4) == 0 || memcmp(ptr, "PK\x03\x04", 4) == 0 || memcmp(ptr, "OggS", 4) == 0 ||
+            memcmp(ptr, "fLaC", 4) == 0 || memcmp(ptr, "ID3", 3) == 0 || memcmp(ptr, "7z\xbc\xaf", 4) == 0 ||
+            memcmp(ptr + 4, "ftyp", 4) == 0 || memcmp(data, kMatroskaSignature, sizeof(kMatroskaSignature)) == 0 ||
+            memcmp(data, kXZSignature, sizeof(kXZSignature)) == 0 || (data[0] == 0x1f && data[1] == 0x8b) ||
+            (memcmp(ptr, "RIFF", 4) == 0 && memcmp(ptr + 8, "WEBP", 4) == 0)) {
+            result = true;
+        }
+        else if (isMPEGAudioFrameHeader(data)) {
+            result = true;
+        }
+        else if (size >= 128 && memcmp(ptr, "DDS ", 4) == 0) {
+            /* only block compressed textures, uncompressed ones still deflate well */
+            nanoem_u32_t flags;
+            memcpy(&flags, data + 80, sizeof(flags));
+            result = (flags & kDDSPixelFormatFourCC) != 0;
+        }
+    }
+    return result;
+}
+
 bool
 Archiver::open(Error &error)
 {
@@ -319,52 +585,68 @@ Archiver::open(Error &error)
 bool
 Archiver::close(Error &error)
 {
-    return m_opaque->handleClose(error);
+    bool succeeded = m_opaque->handleFlush(error);
+    succeeded &= m_opaque->handleClose(error);
+    return succeeded;
 }
 
 bool
 Archiver::addEntry(const Entry &entry, const ByteArray &bytes, Error &error)
 {
-    int rc = MZ_PARAM_ERROR;
-    if (void *file = m_opaque->m_zip) {
-        mz_zip_file info;
-        Opaque::fromEntry(entry, info);
-        rc = mz_zip_entry_write_open(file, &info, entry.m_level, entry.m_raw, nullptr);
-        if (rc == MZ_OK) {
-            int size = Inline::saturateInt32(bytes.size());
-            rc = mz_zip_entry_write(file, bytes.data(), size);
-            if (rc == size) {
-                rc = mz_zip_entry_close(file);
+    bool succeeded = false;
+    if (m_opaque->m_writer && !entry.m_raw &&
+        (entry.m_method == Z_DEFLATED || entry.m_method == MZ_COMPRESS_METHOD_STORE)) {
+        m_opaque->m_pendingEntries.push_back(nanoem_new(Opaque::PendingEntry(entry, bytes)));
+        m_opaque->m_numPendingEntryBytes += bytes.size();
+        succeeded = m_opaque->m_numPendingEntryBytes < Opaque::kMaxPendingEntryBytes || m_opaque->handleFlush(error);
+    }
+    else if (m_opaque->handleFlush(error)) {
+        int rc = MZ_PARAM_ERROR;
+        if (void *file = m_opaque->m_zip) {
+            mz_zip_file info;
+            Opaque::fromEntry(entry, info);
+            rc = mz_zip_entry_write_open(file, &info, entry.m_level, entry.m_raw, nullptr);
+            if (rc == MZ_OK) {
+                int size = Inline::saturateInt32(bytes.size());
+                rc = mz_zip_entry_write(file, bytes.data(), size);
+                if (rc == size) {
+                    rc = mz_zip_entry_close(file);
+                }
             }
         }
+        if (rc != MZ_OK) {
+            char buffer[Inline::kLongNameStackBufferSize];
+            StringUtils::format(buffer, sizeof(buffer), "Cannot add file entry to the zip: %s", entry.m_path.c_str());
+            error = Error(buffer, rc, Error::kDomainTypeMinizip);
+        }
+        succeeded = rc == MZ_OK;
     }
-    if (rc != MZ_OK) {
-        char buffer[Inline::kLongNameStackBufferSize];
-        StringUtils::format(buffer, sizeof(buffer), "Cannot add file entry to the zip: %s", entry.m_path.c_str());
-        error = Error(buffer, rc, Error::kDomainTypeMinizip);
-    }
-    return rc == MZ_OK;
+    return succeeded;
 }
 
 bool
 Archiver::addEntry(const Entry &entry, IReader *reader, Error &error)
 {
     int rc = MZ_PARAM_ERROR;
-    if (void *file = m_opaque->m_zip) {
+    if (!m_opaque->handleFlush(error)) {
+        /* entries added before must be written first to keep the order */
+    }
+    else if (void *file = m_opaque->m_zip) {
+        nanoem_u8_t buffer[Inline::kReadingFileContentsBufferSize];
+        nanoem_i32_t read = FileUtils::read(reader, buffer, sizeof(buffer), error);
         mz_zip_file info;
         Opaque::fromEntry(entry, info);
+        /* streamed entries such as background videos are sniffed by the head of the contents */
+        if (!entry.m_raw && read > 0 && isIncompressible(buffer, nanoem_rsize_t(read))) {
+            info.compression_method = MZ_COMPRESS_METHOD_STORE;
+        }
         rc = mz_zip_entry_write_open(file, &info, entry.m_level, entry.m_raw, nullptr);
         if (rc == MZ_OK) {
-            nanoem_u8_t buffer[Inline::kReadingFileContentsBufferSize];
-            while (!error.hasReason()) {
-                rc = FileUtils::read(reader, buffer, sizeof(buffer), error);
-                if (rc > 0) {
-                    mz_zip_entry_write(file, buffer, rc);
-                }
-                else if (rc <= 0) {
-                    break;
-                }
+            while (!error.hasReason() && read > 0) {
+                mz_zip_entry_write(file, buffer, read);
+                read = FileUtils::read(reader, buffer, sizeof(buffer), error);
             }
+            rc = error.hasReason() ? MZ_STREAM_ERROR : read;
             if (rc == MZ_OK) {
                 rc = mz_zip_entry_close(file);
             }
@@ -382,7 +664,11 @@ bool
 Archiver::findEntry(const String &location, Entry &entry, Error &error) const
 {
     int rc = MZ_PARAM_ERROR;
-    if (void *file = m_opaque->m_zip) {
+    /* entries are not visible to minizip until they are written */
+    if (!m_opaque->handleFlush(error)) {
+        rc = MZ_WRITE_ERROR;
+    }
+    else if (void *file = m_opaque->m_zip) {
         rc = mz_zip_locate_entry(file, location.c_str(), 0);
         if (rc == MZ_OK) {
             MutableString filename, comment;
@@ -454,6 +740,78 @@ Archiver::extract(const Entry &entry, IWriter *writer, Error &error) const
     return rc == MZ_OK;
 }
 
+bool
+Archiver::extractAll(const EntryList &entries, ByteArrayList &bytesList, Error &error) const
+{
+    int lastRC = MZ_OK;
+    nanoem_rsize_t numFailedEntries = 0;
+    String failedPaths;
+    bytesList.clear();
+    bytesList.resize(entries.size());
+    if (void *file = m_opaque->m_zip) {
+        Opaque::ExtractingEntryList extractingEntries;
+        /* a failed entry is left empty and reported together, the rest are still extracted */
+        for (nanoem_rsize_t i = 0, numEntries = entries.size(); i < numEntries; i++) {
+            const Entry &entry = entries[i];
+            ByteArray &bytes = bytesList[i];
+            mz_zip_file *info = nullptr;
+            int rc = entry.m_path.empty() ? MZ_PARAM_ERROR : mz_zip_locate_entry(file, entry.m_path.c_str(), 0);
+            if (rc == MZ_OK) {
+                rc = mz_zip_entry_get_info(file, &info);
+            }
+            if (rc == MZ_OK) {
+                bytes.resize(size_t(info->uncompressed_size));
+                if ((info->flag & MZ_ZIP_FLAG_ENCRYPTED) == 0 &&
+                    (info->compression_method == MZ_COMPRESS_METHOD_STORE ||
+                        info->compression_method == MZ_COMPRESS_METHOD_DEFLATE)) {
+                    Opaque::ExtractingEntry *extracting =
+                        nanoem_new(Opaque::ExtractingEntry(&entry, &bytes, info->crc, info->compression_method));
+                    extracting->m_compressed.resize(size_t(info->compressed_size));
+                    rc = Opaque::readEntry(file, 1, extracting->m_compressed);
+                    if (rc == MZ_OK) {
+                        extractingEntries.push_back(extracting);
+                    }
+                    else {
+                        nanoem_delete(extracting);
+                    }
+                }
+                else {
+                    /* other methods are left to minizip on this thread */
+                    rc = Opaque::readEntry(file, 0, bytes);
+                }
+            }
+            if (rc != MZ_OK) {
+                bytes.clear();
+                Opaque::appendFailedEntry(entry, numFailedEntries, failedPaths);
+                lastRC = rc;
+            }
+        }
+        if (!extractingEntries.empty()) {
+            m_opaque->dispatcher()->dispatch(
+                Opaque::decompressEntry, extractingEntries.data(), extractingEntries.size());
+        }
+        for (nanoem_rsize_t i = 0, numEntries = extractingEntries.size(); i < numEntries; i++) {
+            Opaque::ExtractingEntry *extracting = extractingEntries[i];
+            if (extracting->m_result != MZ_OK) {
+                extracting->m_bytesPtr->clear();
+                Opaque::appendFailedEntry(*extracting->m_entryPtr, numFailedEntries, failedPaths);
+                lastRC = extracting->m_result;
+            }
+            nanoem_delete(extracting);
+        }
+    }
+    else {
+        lastRC = MZ_PARAM_ERROR;
+    }
+    if (lastRC != MZ_OK) {
+        char buffer[Inline::kLongNameStackBufferSize];
+        StringUtils::format(buffer, sizeof(buffer), "Cannot extract %d file entries to the zip: %s",
+            Inline::saturateInt32(numFailedEntries), failedPaths.c_str());
+        error = Error(buffer, lastRC, Error::kDomainTypeMinizip);
+    }
+    return lastRC == MZ_OK;
+}
+
 Archiver::EntryList
 Archiver::allEntries(Error &error) const
 {
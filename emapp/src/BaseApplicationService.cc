@@ -1738,6 +1738,8 @@ BaseApplicationService::createProject(const Vector2UI16 &logicalPixelWindowSize,
     }
     project->setEffectPluginEnabled(preference.isEffectEnabled());
     project->setCompiledEffectCacheEnabled(preference.isEffectCacheEnabled());
+    project->setUndoSnapshotMemoryBudget(nanoem_u64_t(preference.undoMemoryBudget()) * 1024 * 1024);
+    project->physicsEngine()->setIslandEnabled(preference.isPhysicsIslandEnabled());
     const Vector2UI16 devicePixelWindowSize(Vector2(logicalPixelWindowSize) * project->windowDevicePixelRatio());
     m_window->resizeDevicePixelWindowSize(devicePixelWindowSize);
     if (g_sentryAvailable) {
@@ -2195,14 +2197,15 @@ BaseApplicationService::dispatchMenuItemAction(Project *project, nanoem_u32_t ty
         break;
     }
     case ApplicationMenuBuilder::kMenuItemTypeModelPerformValidation: {
-        if (const Model *activeModel = project->activeModel()) {
-            model::Validator validator;
+        if (Model *activeModel = project->activeModel()) {
+            /* the validator owned by the model reuses diagnostics of objects not edited since the last validation */
+            model::Validator *validator = activeModel->validator();
             model::Validator::DiagnosticsList diagnostics;
             nanoem_u32_t filter = model::Validator::kSeverityTypeFatal | model::Validator::kSeverityTypeError;
             if (project->isModelEditingEnabled()) {
                 filter |= model::Validator::kSeverityTypeWarning;
             }
-            validator.validate(activeModel, filter, diagnostics);
+            validator->validate(activeModel, filter, diagnostics);
             String text;
             if (diagnostics.empty()) {
                 text = m_translatorPtr->translate("nanoem.model.validator.result.success");
@@ -2214,7 +2217,7 @@ BaseApplicationService::dispatchMenuItemAction(Project *project, nanoem_u32_t ty
                 for (model::Validator::DiagnosticsList::const_iterator it = diagnostics.begin(),
                                                                        end = diagnostics.end();
                      it != end; ++it) {
-                    validator.format(*it, m_translatorPtr, text);
+                    validator->format(*it, m_translatorPtr, text);
                 }
             }
             char title[Inline::kLongNameStackBufferSize];
@@ -3369,9 +3372,11 @@ BaseApplicationService::handleCommandMessage(Nanoem__Application__Command *comma
     }
     case NANOEM__APPLICATION__COMMAND__TYPE_SAVE_POINT: {
         const Nanoem__Application__SavePointCommand *c = command->save_point;
-        const Nanoem__Application__URI *uri = c->file_uri;
-        const URI &fileURI = URI::createFromFilePath(uri->absolute_path, uri->fragment);
-        succeeded = loadFromFile(fileURI, project, IFileManager::kDialogTypeOpenProject, error);
+        /* the save point of the redo checkpoint has no file as the project is already restored from the snapshot */
+        if (const Nanoem__Application__URI *uri = c->file_uri) {
+            const URI &fileURI = URI::createFromFilePath(uri->absolute_path, uri->fragment);
+            succeeded = loadFromFile(fileURI, project, IFileManager::kDialogTypeOpenProject, error);
+        }
         if (succeeded) {
             for (size_t i = 0; i < c->n_accessories; i++) {
                 const Nanoem__Application__RedoLoadAccessoryCommand *handle = c->accessories[i];
@@ -18,17 +18,16 @@ BezierCurve::BezierCurve(const Vector2U8 &c0, const Vector2U8 &c1, nanoem_frame_
     , m_c1(c1)
     , m_interval(interval)
 {
-    interval = glm::max(interval, nanoem_frame_index_t(16));
-    m_parameters.resize(interval + 1);
-    const Vector2 c0f(c0), c1f(c1);
-    const nanoem_f32_t intervalFloat = nanoem_f32_t(interval);
-    for (nanoem_frame_index_t i = 0; i <= interval; i++) {
-        const nanoem_f32_t t = i / intervalFloat;
-        const nanoem_f32_t it = 1.0f - t;
-        const Vector2 &v = ((kP0 * glm::pow(it, 3.0f)) + (c0f * t * glm::pow(it, 2.0f) * 3.0f) +
-                               (c1f * it * glm::pow(t, 2.0f) * 3.0f) + (kP1 * glm::pow(t, 3.0f))) /
-            kP1;
-        m_parameters[i] = v;
+    /* B(t) = a * t^3 + b * t^2 + c * t (P0 = (0, 0) and P3 = (1, 1)) */
+    const Vector2 c0f(Vector2(c0) / kP1), c1f(Vector2(c1) / kP1);
+    m_c = c0f * 3.0f;
+    m_b = (c1f - c0f * 2.0f) * 3.0f;
+    m_a = Vector2(1) - m_c - m_b;
+    m_samples[0] = 0.0f;
+    m_samples[kNumSamples] = 1.0f;
+    for (int i = 1; i < kNumSamples; i++) {
+        const nanoem_f32_t x = i / nanoem_f32_t(kNumSamples);
+        m_samples[i] = solve(x, x, m_samples[i - 1], 1.0f);
     }
 }
 
@@ -39,21 +38,17 @@ BezierCurve::~BezierCurve() NANOEM_DECL_NOEXCEPT
 nanoem_f32_t
 BezierCurve::value(nanoem_f32_t value) const NANOEM_DECL_NOEXCEPT
 {
-    const nanoem_frame_index_t interval(length());
-    Vector2 nearest(kP1);
-    for (nanoem_frame_index_t i = 0; i < interval; i++) {
-        const Vector2 v(m_parameters[i]);
-        if (glm::abs(nearest.x - value) > glm::abs(v.x - value)) {
-            nearest = v;
-        }
-    }
-    return nearest.y;
+    const nanoem_f32_t x = glm::clamp(value, 0.0f, 1.0f), position = x * kNumSamples;
+    const int offset = glm::min(int(position), kNumSamples - 1);
+    const nanoem_f32_t lower = m_samples[offset], upper = m_samples[offset + 1];
+    const nanoem_f32_t t = solve(x, glm::mix(lower, upper, position - offset), lower, upper);
+    return ((m_a.y * t + m_b.y) * t + m_c.y) * t;
 }
 
 nanoem_frame_index_t
 BezierCurve::length() const NANOEM_DECL_NOEXCEPT
 {
-    return nanoem_frame_index_t(m_parameters.size());
+    return m_interval;
 }
 
 BezierCurve::Pair
@@ -92,14 +87,8 @@ BezierCurve::c1() const NANOEM_DECL_NOEXCEPT
 nanoem_u64_t
 BezierCurve::toHash(const nanoem_u8_t *parameters, nanoem_frame_index_t interval) NANOEM_DECL_NOEXCEPT
 {
-    Hash hash;
-    hash.value = 0;
-    hash.c0x = parameters[0];
-    hash.c0y = parameters[1];
-    hash.c1x = parameters[2];
-    hash.c1y = parameters[3];
-    hash.interval = interval;
-    return hash.value;
+    return nanoem_u64_t(parameters[0]) | (nanoem_u64_t(parameters[1]) << 8) | (nanoem_u64_t(parameters[2]) << 16) |
+        (nanoem_u64_t(parameters[3]) << 24) | (nanoem_u64_t(interval) << 32);
 }
 
 void
@@ -122,4 +111,27 @@ BezierCurve::splitBezierCurve(const PointList &points, nanoem_f32_t t, PointList
     }
 }
 
+nanoem_f32_t
+BezierCurve::solve(nanoem_f32_t x, nanoem_f32_t t, nanoem_f32_t lower, nanoem_f32_t upper) const NANOEM_DECL_NOEXCEPT
+{
+    /* newton's method guarded by bisection (x of the curve is monotonically increasing in [0, 1]) */
+    static const nanoem_f32_t kEpsilon = 1e-6f;
+    static const int kMaxIterations = 16;
+    for (int i = 0; i < kMaxIterations; i++) {
+        const nanoem_f32_t delta = ((m_a.x * t + m_b.x) * t + m_c.x) * t - x;
+        if (glm::abs(delta) < kEpsilon) {
+            break;
+        }
+        else if (delta > 0) {
+            upper = t;
+        }
+        else {
+            lower = t;
+        }
+        const nanoem_f32_t derivative = (m_a.x * 3.0f * t + m_b.x * 2.0f) * t + m_c.x, next = t - delta / derivative;
+        t = (derivative > kEpsilon && next > lower && next < upper) ? next : (lower + upper) * 0.5f;
+    }
+    return t;
+}
+
 } /* namespace nanoem */
@@ -1146,6 +1146,8 @@ CommandRegistrator::internalMoveAllSelectedAccessoryKeyframes(
             Motion::AccessoryKeyframeList keyframes;
             IMotionKeyframeSelection *selection = motion->selection();
             selection->getAll(keyframes, nullptr);
+            /* selection is keyed by the frame index so moved keyframes are selected again after moving */
+            selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ACCESSORY);
             if (!keyframes.empty()) {
                 Motion::AccessoryKeyframeSet deleted;
                 motion->save(bytes, nullptr, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
@@ -1174,6 +1176,7 @@ CommandRegistrator::internalMoveAllSelectedAccessoryKeyframes(
                             }
                             nanoemMutableMotionAddAccessoryKeyframe(
                                 mutableMotion, foundKeyframe, newFrameIndex, &status);
+                            selection->add(nanoemMutableMotionAccessoryKeyframeGetOriginObject(foundKeyframe));
                         }
                         else {
                             nanoem_mutable_motion_accessory_keyframe_t *duplicatedKeyframe =
@@ -1183,13 +1186,13 @@ CommandRegistrator::internalMoveAllSelectedAccessoryKeyframes(
                             nanoemMutableMotionAddAccessoryKeyframe(
                                 mutableMotion, duplicatedKeyframe, newFrameIndex, &status);
                             nanoemMutableMotionAccessoryKeyframeDestroy(duplicatedKeyframe);
+                            selection->add(keyframe);
                         }
                         nanoemMutableMotionAccessoryKeyframeDestroy(foundKeyframe);
                     }
-                }
-                for (Motion::AccessoryKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end;
-                     ++it) {
-                    selection->remove(*it);
+                    else {
+                        selection->add(keyframe);
+                    }
                 }
                 nanoemMutableMotionDestroy(mutableMotion);
                 commands.push_back(command::MotionSnapshotCommand::create(
@@ -1211,6 +1214,7 @@ CommandRegistrator::internalMoveAllSelectedCameraKeyframes(
         Motion::CameraKeyframeList keyframes;
         IMotionKeyframeSelection *selection = motion->selection();
         selection->getAll(keyframes, nullptr);
+        selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_CAMERA);
         if (!keyframes.empty()) {
             Motion::CameraKeyframeSet deleted;
             motion->save(bytes, nullptr, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
@@ -1238,6 +1242,7 @@ CommandRegistrator::internalMoveAllSelectedCameraKeyframes(
                             nanoemMutableMotionCameraKeyframeDestroy(removingKeyframe);
                         }
                         nanoemMutableMotionAddCameraKeyframe(mutableMotion, foundKeyframe, newFrameIndex, &status);
+                        selection->add(nanoemMutableMotionCameraKeyframeGetOriginObject(foundKeyframe));
                     }
                     else {
                         nanoem_mutable_motion_camera_keyframe_t *duplicatedKeyframe =
@@ -1246,12 +1251,13 @@ CommandRegistrator::internalMoveAllSelectedCameraKeyframes(
                             duplicatedKeyframe, nanoemMutableMotionCameraKeyframeGetOriginObject(foundKeyframe));
                         nanoemMutableMotionAddCameraKeyframe(mutableMotion, duplicatedKeyframe, newFrameIndex, &status);
                         nanoemMutableMotionCameraKeyframeDestroy(duplicatedKeyframe);
+                        selection->add(keyframe);
                     }
                     nanoemMutableMotionCameraKeyframeDestroy(foundKeyframe);
                 }
-            }
-            for (Motion::CameraKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end; ++it) {
-                selection->remove(*it);
+                else {
+                    selection->add(keyframe);
+                }
             }
             nanoemMutableMotionDestroy(mutableMotion);
             commands.push_back(command::MotionSnapshotCommand::create(
@@ -1272,6 +1278,7 @@ CommandRegistrator::internalMoveAllSelectedLightKeyframes(
         Motion::LightKeyframeList keyframes;
         IMotionKeyframeSelection *selection = motion->selection();
         selection->getAll(keyframes, nullptr);
+        selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_LIGHT);
         if (!keyframes.empty()) {
             Motion::LightKeyframeSet deleted;
             motion->save(bytes, nullptr, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
@@ -1299,6 +1306,7 @@ CommandRegistrator::internalMoveAllSelectedLightKeyframes(
                             nanoemMutableMotionLightKeyframeDestroy(removingKeyframe);
                         }
                         nanoemMutableMotionAddLightKeyframe(mutableMotion, foundKeyframe, newFrameIndex, &status);
+                        selection->add(nanoemMutableMotionLightKeyframeGetOriginObject(foundKeyframe));
                     }
                     else {
                         nanoem_mutable_motion_light_keyframe_t *duplicatedKeyframe =
@@ -1307,12 +1315,13 @@ CommandRegistrator::internalMoveAllSelectedLightKeyframes(
                             duplicatedKeyframe, nanoemMutableMotionLightKeyframeGetOriginObject(foundKeyframe));
                         nanoemMutableMotionAddLightKeyframe(mutableMotion, duplicatedKeyframe, newFrameIndex, &status);
                         nanoemMutableMotionLightKeyframeDestroy(duplicatedKeyframe);
+                        selection->add(keyframe);
                     }
                     nanoemMutableMotionLightKeyframeDestroy(foundKeyframe);
                 }
-            }
-            for (Motion::LightKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end; ++it) {
-                selection->remove(*it);
+                else {
+                    selection->add(keyframe);
+                }
             }
             nanoemMutableMotionDestroy(mutableMotion);
             commands.push_back(command::MotionSnapshotCommand::create(
@@ -1338,6 +1347,7 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
             Motion::ModelKeyframeSet deleted;
             Motion::ModelKeyframeList keyframes;
             selection->getAll(keyframes, nullptr);
+            selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MODEL);
             Motion::sortAllKeyframes(keyframes, direction);
             for (Motion::ModelKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
                  ++it) {
@@ -1361,6 +1371,7 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
                             nanoemMutableMotionModelKeyframeDestroy(removingKeyframe);
                         }
                         nanoemMutableMotionAddModelKeyframe(mutableMotion, foundKeyframe, newFrameIndex, &status);
+                        selection->add(nanoemMutableMotionModelKeyframeGetOriginObject(foundKeyframe));
                     }
                     else {
                         nanoem_mutable_motion_model_keyframe_t *duplicatedKeyframe =
@@ -1369,18 +1380,20 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
                             nanoemMutableMotionModelKeyframeGetOriginObject(foundKeyframe), &status);
                         nanoemMutableMotionAddModelKeyframe(mutableMotion, duplicatedKeyframe, newFrameIndex, &status);
                         nanoemMutableMotionModelKeyframeDestroy(duplicatedKeyframe);
+                        selection->add(keyframe);
                     }
                     nanoemMutableMotionModelKeyframeDestroy(foundKeyframe);
                 }
-            }
-            for (Motion::ModelKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end; ++it) {
-                selection->remove(*it);
+                else {
+                    selection->add(keyframe);
+                }
             }
         }
         {
             Motion::BoneKeyframeSet deleted;
             Motion::BoneKeyframeList keyframes;
             selection->getAll(keyframes, nullptr);
+            selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_BONE);
             Motion::sortAllKeyframes(keyframes, direction);
             for (Motion::BoneKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
                  ++it) {
@@ -1404,6 +1417,7 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
                             nanoemMutableMotionBoneKeyframeDestroy(removingKeyframe);
                         }
                         nanoemMutableMotionAddBoneKeyframe(mutableMotion, foundKeyframe, name, newFrameIndex, &status);
+                        selection->add(nanoemMutableMotionBoneKeyframeGetOriginObject(foundKeyframe));
                     }
                     else {
                         nanoem_mutable_motion_bone_keyframe_t *duplicatedKeyframe =
@@ -1413,18 +1427,20 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
                         nanoemMutableMotionAddBoneKeyframe(
                             mutableMotion, duplicatedKeyframe, name, newFrameIndex, &status);
                         nanoemMutableMotionBoneKeyframeDestroy(duplicatedKeyframe);
+                        selection->add(keyframe);
                     }
                     nanoemMutableMotionBoneKeyframeDestroy(foundKeyframe);
                 }
-            }
-            for (Motion::BoneKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end; ++it) {
-                selection->remove(*it);
+                else {
+                    selection->add(keyframe);
+                }
             }
         }
         {
             Motion::MorphKeyframeSet deleted;
             Motion::MorphKeyframeList keyframes;
             selection->getAll(keyframes, nullptr);
+            selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MORPH);
             Motion::sortAllKeyframes(keyframes, direction);
             for (Motion::MorphKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
                  ++it) {
@@ -1449,6 +1465,7 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
                             nanoemMutableMotionMorphKeyframeDestroy(removingKeyframe);
                         }
                         nanoemMutableMotionAddMorphKeyframe(mutableMotion, foundKeyframe, name, newFrameIndex, &status);
+                        selection->add(nanoemMutableMotionMorphKeyframeGetOriginObject(foundKeyframe));
                     }
                     else {
                         nanoem_mutable_motion_morph_keyframe_t *duplicatedKeyframe =
@@ -1458,12 +1475,13 @@ CommandRegistrator::internalMoveAllSelectedModelKeyframes(
                         nanoemMutableMotionAddMorphKeyframe(
                             mutableMotion, duplicatedKeyframe, name, newFrameIndex, &status);
                         nanoemMutableMotionMorphKeyframeDestroy(duplicatedKeyframe);
+                        selection->add(keyframe);
                     }
                     nanoemMutableMotionMorphKeyframeDestroy(foundKeyframe);
                 }
-            }
-            for (Motion::MorphKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end; ++it) {
-                selection->remove(*it);
+                else {
+                    selection->add(keyframe);
+                }
             }
         }
         nanoemMutableMotionDestroy(mutableMotion);
@@ -1485,6 +1503,7 @@ CommandRegistrator::internalMoveAllSelectedSelfShadowKeyframes(
         Motion::SelfShadowKeyframeList keyframes;
         IMotionKeyframeSelection *selection = motion->selection();
         selection->getAll(keyframes, nullptr);
+        selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_SELFSHADOW);
         if (!keyframes.empty()) {
             Motion::SelfShadowKeyframeSet deleted;
             motion->save(bytes, nullptr, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
@@ -1512,6 +1531,7 @@ CommandRegistrator::internalMoveAllSelectedSelfShadowKeyframes(
                             nanoemMutableMotionSelfShadowKeyframeDestroy(removingKeyframe);
                         }
                         nanoemMutableMotionAddSelfShadowKeyframe(mutableMotion, foundKeyframe, newFrameIndex, &status);
+                        selection->add(nanoemMutableMotionSelfShadowKeyframeGetOriginObject(foundKeyframe));
                     }
                     else {
                         nanoem_mutable_motion_self_shadow_keyframe_t *duplicatedKeyframe =
@@ -1521,13 +1541,13 @@ CommandRegistrator::internalMoveAllSelectedSelfShadowKeyframes(
                         nanoemMutableMotionAddSelfShadowKeyframe(
                             mutableMotion, duplicatedKeyframe, newFrameIndex, &status);
                         nanoemMutableMotionSelfShadowKeyframeDestroy(duplicatedKeyframe);
+                        selection->add(keyframe);
                     }
                     nanoemMutableMotionSelfShadowKeyframeDestroy(foundKeyframe);
                 }
-            }
-            for (Motion::SelfShadowKeyframeSet::const_iterator it = deleted.begin(), end = deleted.end(); it != end;
-                 ++it) {
-                selection->remove(*it);
+                else {
+                    selection->add(keyframe);
+                }
             }
             nanoemMutableMotionDestroy(mutableMotion);
             commands.push_back(command::MotionSnapshotCommand::create(
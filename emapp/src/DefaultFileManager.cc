@@ -25,6 +25,7 @@
 #include "emapp/Project.h"
 #include "emapp/ResourceBundle.h"
 #include "emapp/StringUtils.h"
+#include "emapp/internal/FileContentDigestCache.h"
 #include "emapp/internal/ModelEffectSetting.h"
 #include "emapp/plugin/DecoderPlugin.h"
 #include "emapp/plugin/EncoderPlugin.h"
@@ -169,6 +170,14 @@ setEffectCallback(Effect *effect, Project *project, Error &error)
     project->attachEffectToSelectedDrawable(effect, error);
 }
 
+static URI
+bakedPhysicsSimulationFileURI(const URI &fileURI)
+{
+    String path(fileURI.absolutePath());
+    path.append(".physics");
+    return URI::createFromFilePath(path);
+}
+
 } /* namespace anonymous */
 
 DefaultFileManager::DefaultFileManager(BaseApplicationService *applicationPtr)
@@ -469,74 +478,72 @@ DefaultFileManager::loadVideoFile(const URI &fileURI, Project *project, Error &e
 bool
 DefaultFileManager::loadProject(const URI &fileURI, Project *project, Error &error)
 {
-    FileReaderScope scope(&m_translator);
+    MappedFileReader reader(&m_translator);
     bool succeeded = false;
-    if (scope.open(fileURI, error)) {
+    if (reader.open(fileURI, error)) {
         if (Project::isArchiveURI(fileURI)) {
-            succeeded = project->loadFromArchive(scope.reader(), fileURI, error);
+            succeeded = project->loadFromArchive(&reader, fileURI, error);
         }
         else {
             const String extension(fileURI.pathExtension());
-            ByteArray bytes;
-            FileUtils::read(scope, bytes, error);
-            if (!error.hasReason()) {
-                project->setFileURI(fileURI);
-                struct Diagnostics : Project::IDiagnostics {
-                    void
-                    addNotFoundFileURI(const URI &fileURI) NANOEM_DECL_OVERRIDE
-                    {
-                        m_fileURIsNotFound.push_back(fileURI);
-                    }
-                    void
-                    addDigestMismatchFileURI(const URI &fileURI) NANOEM_DECL_OVERRIDE
-                    {
-                        m_fileURIsMismatch.push_back(fileURI);
-                    }
-                    void
-                    addModalDialog(BaseApplicationService *service)
-                    {
-                        if (!m_fileURIsNotFound.empty() || !m_fileURIsMismatch.empty()) {
-                            String message;
-                            const ITranslator *translator = service->translator();
-                            StringUtils::format(
-                                message, "%s\n\n", translator->translate("nanoem.project.diagnostics.message.main"));
-                            if (!m_fileURIsNotFound.empty()) {
-                                StringUtils::format(message, "%s\n",
-                                    translator->translate("nanoem.project.diagnostics.message.not-found"));
-                                for (URIList::const_iterator it = m_fileURIsNotFound.begin(),
-                                                             end = m_fileURIsNotFound.end();
-                                     it != end; ++it) {
-                                    message.append(it->absolutePathConstString());
-                                    message.append("\n");
-                                }
+            const nanoem_u8_t *bytes = reader.bytes();
+            const nanoem_rsize_t size = reader.size();
+            project->setFileURI(fileURI);
+            struct Diagnostics : Project::IDiagnostics {
+                void
+                addNotFoundFileURI(const URI &fileURI) NANOEM_DECL_OVERRIDE
+                {
+                    m_fileURIsNotFound.push_back(fileURI);
+                }
+                void
+                addDigestMismatchFileURI(const URI &fileURI) NANOEM_DECL_OVERRIDE
+                {
+                    m_fileURIsMismatch.push_back(fileURI);
+                }
+                void
+                addModalDialog(BaseApplicationService *service)
+                {
+                    if (!m_fileURIsNotFound.empty() || !m_fileURIsMismatch.empty()) {
+                        String message;
+                        const ITranslator *translator = service->translator();
+                        StringUtils::format(
+                            message, "%s\n\n", translator->translate("nanoem.project.diagnostics.message.main"));
+                        if (!m_fileURIsNotFound.empty()) {
+                            StringUtils::format(message, "%s\n",
+                                translator->translate("nanoem.project.diagnostics.message.not-found"));
+                            for (URIList::const_iterator it = m_fileURIsNotFound.begin(),
+                                                         end = m_fileURIsNotFound.end();
+                                 it != end; ++it) {
+                                message.append(it->absolutePathConstString());
                                 message.append("\n");
                             }
-                            if (!m_fileURIsMismatch.empty()) {
-                                StringUtils::format(message, "%s\n",
-                                    translator->translate("nanoem.project.diagnostics.message.digest-mismatch"));
-                                for (URIList::const_iterator it = m_fileURIsMismatch.begin(),
-                                                             end = m_fileURIsMismatch.end();
-                                     it != end; ++it) {
-                                    message.append(it->absolutePathConstString());
-                                    message.append("\n");
-                                }
+                            message.append("\n");
+                        }
+                        if (!m_fileURIsMismatch.empty()) {
+                            StringUtils::format(message, "%s\n",
+                                translator->translate("nanoem.project.diagnostics.message.digest-mismatch"));
+                            for (URIList::const_iterator it = m_fileURIsMismatch.begin(),
+                                                         end = m_fileURIsMismatch.end();
+                                 it != end; ++it) {
+                                message.append(it->absolutePathConstString());
+                                message.append("\n");
                             }
-                            IModalDialog *dialog = ModalDialogFactory::createDisplayPlainTextDialog(
-                                service, translator->translate("nanoem.project.diagnostics.title"), message);
-                            service->addModalDialog(dialog);
                         }
+                        IModalDialog *dialog = ModalDialogFactory::createDisplayPlainTextDialog(
+                            service, translator->translate("nanoem.project.diagnostics.title"), message);
+                        service->addModalDialog(dialog);
                     }
-                    URIList m_fileURIsNotFound;
-                    URIList m_fileURIsMismatch;
-                };
-                Diagnostics diagnostics;
-                if ((StringUtils::equals(extension.c_str(), Project::kFileSystemBasedNativeFormatFileExtension) &&
-                        project->loadFromBinary(bytes, Project::kBinaryFormatNative, error, &diagnostics)) ||
-                    (StringUtils::equals(extension.c_str(), Project::kPolygonMovieMakerFileExtension) &&
-                        project->loadFromBinary(bytes, Project::kBinaryFormatPMM, error, &diagnostics))) {
-                    succeeded = !error.isCancelled();
-                    diagnostics.addModalDialog(m_applicationPtr);
                 }
+                URIList m_fileURIsNotFound;
+                URIList m_fileURIsMismatch;
+            };
+            Diagnostics diagnostics;
+            if ((StringUtils::equals(extension.c_str(), Project::kFileSystemBasedNativeFormatFileExtension) &&
+                    project->loadFromBinary(bytes, size, Project::kBinaryFormatNative, error, &diagnostics)) ||
+                (StringUtils::equals(extension.c_str(), Project::kPolygonMovieMakerFileExtension) &&
+                    project->loadFromBinary(bytes, size, Project::kBinaryFormatPMM, error, &diagnostics))) {
+                succeeded = !error.isCancelled();
+                diagnostics.addModalDialog(m_applicationPtr);
             }
         }
     }
@@ -556,6 +563,15 @@ DefaultFileManager::loadProject(const URI &fileURI, Project *project, Error &err
         }
         succeeded = !error.hasReason();
     }
+    if (succeeded) {
+        /* the baked physics is optional and can be baked again so loading it never fails loading the project */
+        const URI bakedFileURI(bakedPhysicsSimulationFileURI(fileURI));
+        FileReaderScope scope(&m_translator);
+        Error bakedError;
+        if (FileUtils::exists(bakedFileURI) && scope.open(bakedFileURI, bakedError)) {
+            project->loadBakedPhysicsSimulation(scope.reader(), bakedError);
+        }
+    }
     return succeeded;
 }
 
@@ -1015,15 +1031,19 @@ DefaultFileManager::loadModel(const URI &fileURI, Model *model, Error &error)
 {
     nanoem_parameter_assert(!fileURI.isEmpty(), "must NOT be empty");
     nanoem_parameter_assert(model, "must NOT be nullptr");
-    FileReaderScope scope(&m_translator);
+    internal::FileContentDigestCache *cache = model->project()->fileContentDigestCache();
+    /* the file prefetched on loading the project is loaded from the same bytes whose digest is already tested */
+    MappedFileReader localReader(&m_translator), *reader = cache->findMappedFile(fileURI);
     bool succeeded = false;
-    if (scope.open(fileURI, error)) {
-        ByteArray bytes;
-        FileUtils::read(scope, bytes, error);
-        if (!error.hasReason() && model->load(bytes, error)) {
-            model->setFileURI(fileURI);
-            succeeded = true;
+    if (!reader && localReader.open(fileURI, error)) {
+        reader = &localReader;
+    }
+    if (reader && model->load(reader->bytes(), reader->size(), error)) {
+        if (reader == &localReader) {
+            cache->update(fileURI, reader->bytes(), reader->size());
         }
+        model->setFileURI(fileURI);
+        succeeded = true;
     }
     return succeeded;
 }
@@ -1033,20 +1053,24 @@ DefaultFileManager::loadAccessory(const URI &fileURI, Accessory *accessory, Prog
 {
     nanoem_parameter_assert(!fileURI.isEmpty(), "must NOT be empty");
     nanoem_parameter_assert(accessory, "must not be nullptr");
-    FileReaderScope scope(&m_translator);
+    internal::FileContentDigestCache *cache = accessory->project()->fileContentDigestCache();
+    /* the file prefetched on loading the project is loaded from the same bytes whose digest is already tested */
+    MappedFileReader localReader(&m_translator), *reader = cache->findMappedFile(fileURI);
     bool succeeded = false;
     progress.tryLoadingItem(fileURI);
-    if (scope.open(fileURI, error)) {
-        ByteArray bytes;
-        FileUtils::read(scope, bytes, error);
-        if (!error.hasReason() && accessory->load(bytes, error)) {
-            accessory->setFileURI(fileURI);
-            accessory->upload();
-            accessory->loadAllImages(progress, error);
-            succeeded = !error.isCancelled();
-            if (succeeded) {
-                accessory->writeLoadCommandMessage(error);
-            }
+    if (!reader && localReader.open(fileURI, error)) {
+        reader = &localReader;
+    }
+    if (reader && accessory->load(reader->bytes(), reader->size(), error)) {
+        if (reader == &localReader) {
+            cache->update(fileURI, reader->bytes(), reader->size());
+        }
+        accessory->setFileURI(fileURI);
+        accessory->upload();
+        accessory->loadAllImages(progress, error);
+        succeeded = !error.isCancelled();
+        if (succeeded) {
+            accessory->writeLoadCommandMessage(error);
         }
     }
     return succeeded;
@@ -1153,13 +1177,9 @@ DefaultFileManager::loadModelMotion(const URI &fileURI, Project *project, Error
             project->destroyMotion(lastMotionPtr);
         }
         else if (model::BindPose::isLoadableExtension(fileURI)) {
-            FileReaderScope scope(&m_translator);
-            if (scope.open(fileURI, error)) {
-                ByteArray bytes;
-                FileUtils::read(scope, bytes, error);
-                if (!error.hasReason()) {
-                    succeeded = model->loadPose(bytes, error);
-                }
+            MappedFileReader reader(&m_translator);
+            if (reader.open(fileURI, error)) {
+                succeeded = model->loadPose(reader.bytes(), reader.size(), error);
             }
         }
     }
@@ -1176,17 +1196,13 @@ DefaultFileManager::loadMotion(const URI &fileURI, Motion *motion, nanoem_frame_
 {
     nanoem_parameter_assert(!fileURI.isEmpty(), "must NOT be empty");
     nanoem_parameter_assert(motion, "must not be nullptr");
-    FileReaderScope scope(&m_translator);
+    MappedFileReader reader(&m_translator);
     bool succeeded = false;
-    if (scope.open(fileURI, error)) {
-        ByteArray bytes;
-        FileUtils::read(scope, bytes, error);
-        if (!error.hasReason()) {
-            motion->setFormat(fileURI);
-            succeeded = motion->load(bytes, offset, error);
-            if (succeeded) {
-                motion->setFileURI(fileURI);
-            }
+    if (reader.open(fileURI, error)) {
+        motion->setFormat(fileURI);
+        succeeded = motion->load(reader.bytes(), reader.size(), offset, error);
+        if (succeeded) {
+            motion->setFileURI(fileURI);
         }
     }
     return succeeded;
@@ -1309,6 +1325,18 @@ DefaultFileManager::saveProject(const URI &fileURI, Project *project, Error &err
             if (succeeded) {
                 project->writeRedoMessage();
             }
+            if (succeeded && project->hasAnyBakedPhysicsSimulation()) {
+                /* saved beside the project as the baked frames may be far larger than the project itself */
+                FileWriterScope scope;
+                Error bakedError;
+                if (scope.open(bakedPhysicsSimulationFileURI(fileURI), bakedError) &&
+                    project->saveBakedPhysicsSimulation(scope.writer(), bakedError)) {
+                    scope.commit(bakedError);
+                }
+                else {
+                    scope.rollback(bakedError);
+                }
+            }
         }
     }
     FileUtils::TransientPath transientPath;
@@ -57,13 +57,16 @@ void
 DirectionalLight::synchronizeParameters(const Motion *motion, const nanoem_frame_index_t frameIndex)
 {
     nanoem_parameter_assert(motion, "must not be nullptr");
-    if (const nanoem_motion_light_keyframe_t *keyframe = motion->findLightKeyframe(frameIndex)) {
+    nanoem_motion_keyframe_cursor_t *cursor = m_motionCursor.resolve(motion);
+    if (const nanoem_motion_light_keyframe_t *keyframe =
+            nanoemMotionFindLightKeyframeObjectWithCursor(motion->data(), cursor, frameIndex)) {
         setColor(glm::make_vec3(nanoemMotionLightKeyframeGetColor(keyframe)));
         setDirection(glm::make_vec3(nanoemMotionLightKeyframeGetDirection(keyframe)));
     }
     else {
         nanoem_motion_light_keyframe_t *prevKeyframe, *nextKeyframe;
-        nanoemMotionSearchClosestLightKeyframes(motion->data(), frameIndex, &prevKeyframe, &nextKeyframe);
+        nanoemMotionSearchClosestLightKeyframesWithCursor(
+            motion->data(), cursor, frameIndex, &prevKeyframe, &nextKeyframe);
         if (prevKeyframe && nextKeyframe) {
             const nanoem_f32_t &coef = Motion::coefficient(prevKeyframe, nextKeyframe, frameIndex);
             const Vector3 color0(glm::make_vec3(nanoemMotionLightKeyframeGetColor(prevKeyframe)));
@@ -17,8 +17,15 @@
 #include <errno.h>
 #include <fcntl.h>
 #include <limits.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <unistd.h>
+#if BX_PLATFORM_LINUX
+#include <sys/vfs.h>
+#elif BX_PLATFORM_OSX || BX_PLATFORM_IOS
+#include <sys/mount.h>
+#include <sys/param.h>
+#endif
 #endif
 
 namespace nanoem {
@@ -592,6 +599,54 @@ PosixFileWriter::writeDestinationURI() const
 
 #endif /* BX_PLATFORM_WINDOWS */
 
+#if BX_PLATFORM_WINDOWS
+static bool
+isMappableStorage(const wchar_t *path) NANOEM_DECL_NOEXCEPT
+{
+    /* reading a view of removable or network storage raises EXCEPTION_IN_PAGE_ERROR when it becomes unavailable */
+    wchar_t root[MAX_PATH];
+    return GetVolumePathNameW(path, root, ARRAYSIZE(root)) && GetDriveTypeW(root) == DRIVE_FIXED;
+}
+#else
+static bool
+isMappableStorage(int fd) NANOEM_DECL_NOEXCEPT
+{
+    /*
+     * touching a page of the truncated or unavailable file raises SIGBUS, so only fixed local storage is mapped
+     * and removable (typically FAT) or network storage is read with the regular reader instead
+     */
+    bool mappable = false;
+#if BX_PLATFORM_LINUX
+    struct statfs st;
+    if (::fstatfs(fd, &st) == 0) {
+        switch (static_cast<nanoem_u32_t>(st.f_type)) {
+        case 0x00006969: /* nfs */
+        case 0x0000517b: /* smb */
+        case 0xff534d42: /* cifs */
+        case 0xfe534d42: /* smb2 */
+        case 0x01021997: /* 9p */
+        case 0x65735546: /* fuse */
+        case 0x00004d44: /* msdos */
+        case 0x2011bab0: /* exfat */
+            break;
+        default:
+            mappable = true;
+            break;
+        }
+    }
+#elif BX_PLATFORM_OSX || BX_PLATFORM_IOS
+    struct statfs st;
+    if (::fstatfs(fd, &st) == 0) {
+        mappable = (st.f_flags & MNT_LOCAL) != 0 &&
+            (StringUtils::equals(st.f_fstypename, "apfs") || StringUtils::equals(st.f_fstypename, "hfs"));
+    }
+#else
+    BX_UNUSED_1(fd);
+#endif
+    return mappable;
+}
+#endif /* BX_PLATFORM_WINDOWS */
+
 } /* namespace anonymous */
 
 FileReaderScope::FileReaderScope(const ITranslator *translator)
@@ -725,6 +780,161 @@ MemoryReader::seek(nanoem_i64_t offset, SeekType whence, Error & /*error */)
     return ret;
 }
 
+MappedFileReader::MappedFileReader(const ITranslator *translator)
+    : m_translator(translator)
+    , m_address(nullptr)
+    , m_mappedSize(0)
+    , m_offset(0)
+{
+}
+
+MappedFileReader::~MappedFileReader() NANOEM_DECL_NOEXCEPT
+{
+    unmap();
+}
+
+bool
+MappedFileReader::open(const URI &fileURI, Error &error)
+{
+    bool succeeded = false;
+    unmap();
+    m_fallbackBytes.clear();
+    m_offset = 0;
+    if (map(fileURI)) {
+        m_fileURI = fileURI;
+        succeeded = true;
+    }
+    else {
+        /* not a regular file or mapping is not available, read whole of the file with the regular reader instead */
+        FileReaderScope scope(m_translator);
+        if (scope.open(fileURI, error)) {
+            FileUtils::read(scope, m_fallbackBytes, error);
+            if (!error.hasReason()) {
+                m_fileURI = fileURI;
+                succeeded = true;
+            }
+        }
+    }
+    return succeeded;
+}
+
+bool
+MappedFileReader::close(Error & /* error */)
+{
+    unmap();
+    m_fallbackBytes.clear();
+    m_offset = 0;
+    return true;
+}
+
+nanoem_i32_t
+MappedFileReader::read(void *data, nanoem_i32_t size, Error & /* error */)
+{
+    nanoem_rsize_t rest = this->size() - nanoem_rsize_t(m_offset),
+                   actual = glm::min(static_cast<nanoem_rsize_t>(size), rest);
+    if (actual > 0) {
+        memcpy(data, bytes() + m_offset, actual);
+        m_offset += actual;
+    }
+    return Inline::saturateInt32(actual);
+}
+
+nanoem_rsize_t
+MappedFileReader::size()
+{
+    return m_address ? m_mappedSize : m_fallbackBytes.size();
+}
+
+nanoem_i64_t
+MappedFileReader::seek(nanoem_i64_t offset, SeekType whence, Error & /* error */)
+{
+    const nanoem_i64_t ret = m_offset, length = static_cast<nanoem_i64_t>(size());
+    switch (whence) {
+    case kSeekTypeBegin:
+        m_offset = offset;
+        break;
+    case kSeekTypeCurrent:
+        m_offset = m_offset + offset;
+        break;
+    case kSeekTypeEnd:
+        m_offset = length + offset;
+        break;
+    }
+    m_offset = glm::clamp(m_offset, nanoem_i64_t(0), length);
+    return ret;
+}
+
+URI
+MappedFileReader::fileURI() const
+{
+    return m_fileURI;
+}
+
+const nanoem_u8_t *
+MappedFileReader::bytes() const NANOEM_DECL_NOEXCEPT
+{
+    return m_address ? static_cast<const nanoem_u8_t *>(m_address) : m_fallbackBytes.data();
+}
+
+bool
+MappedFileReader::isMapped() const NANOEM_DECL_NOEXCEPT
+{
+    return m_address != nullptr;
+}
+
+bool
+MappedFileReader::map(const URI &fileURI) NANOEM_DECL_NOEXCEPT
+{
+#if BX_PLATFORM_WINDOWS
+    MutableWideString ws;
+    StringUtils::getWideCharString(fileURI.absolutePathConstString(), ws);
+    HANDLE file = CreateFileW(ws.data(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_READONLY | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file != INVALID_HANDLE_VALUE) {
+        LARGE_INTEGER size;
+        if (GetFileType(file) == FILE_TYPE_DISK && isMappableStorage(ws.data()) && GetFileSizeEx(file, &size) &&
+            size.QuadPart > 0 && static_cast<nanoem_u64_t>(size.QuadPart) <= SIZE_MAX) {
+            if (HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr)) {
+                /* the view keeps the mapping object alive so both handles can be closed here */
+                m_address = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+                m_mappedSize = m_address ? static_cast<nanoem_rsize_t>(size.QuadPart) : 0;
+                CloseHandle(mapping);
+            }
+        }
+        CloseHandle(file);
+    }
+#else
+    int fd = ::open(fileURI.absolutePathConstString(), O_RDONLY);
+    if (fd != -1) {
+        struct stat st;
+        if (::fstat(fd, &st) != -1 && S_ISREG(st.st_mode) && st.st_size > 0 && isMappableStorage(fd)) {
+            /* the mapping remains valid after closing the file descriptor */
+            void *address = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (address != MAP_FAILED) {
+                m_address = address;
+                m_mappedSize = static_cast<nanoem_rsize_t>(st.st_size);
+            }
+        }
+        ::close(fd);
+    }
+#endif
+    return m_address != nullptr;
+}
+
+void
+MappedFileReader::unmap() NANOEM_DECL_NOEXCEPT
+{
+    if (m_address) {
+#if BX_PLATFORM_WINDOWS
+        UnmapViewOfFile(m_address);
+#else
+        ::munmap(m_address, m_mappedSize);
+#endif
+        m_address = nullptr;
+        m_mappedSize = 0;
+    }
+}
+
 MemoryWriter::MemoryWriter(ByteArray *bytes)
     : m_bytesPtr(bytes)
     , m_offset(0)
@@ -792,16 +1002,24 @@ FileUtils::timestamp(const char *filePath) NANOEM_DECL_NOEXCEPT
 #if BX_PLATFORM_WINDOWS
     MutableWideString newPath;
     StringUtils::getWideCharString(filePath, newPath);
-    FILETIME time;
-    GetFileTime(newPath.data(), nullptr, nullptr, &time);
-    ULARGE_INTEGER ul;
-    ul.HighPart = time.dwHighDateTime;
-    ul.LowPart = time.dwLowDateTime;
-    value = ul.QuadPart;
-#elif BX_PLATFORM_OSX || BX_PLATFORM_IOS
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (GetFileAttributesExW(newPath.data(), GetFileExInfoStandard, &data)) {
+        ULARGE_INTEGER ul;
+        ul.HighPart = data.ftLastWriteTime.dwHighDateTime;
+        ul.LowPart = data.ftLastWriteTime.dwLowDateTime;
+        value = ul.QuadPart;
+    }
+#else
     struct stat st;
-    ::stat(filePath, &st);
-    value = static_cast<nanoem_u64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+    if (::stat(filePath, &st) == 0) {
+#if BX_PLATFORM_OSX || BX_PLATFORM_IOS
+        value = static_cast<nanoem_u64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif BX_PLATFORM_LINUX || BX_PLATFORM_ANDROID
+        value = static_cast<nanoem_u64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+        value = static_cast<nanoem_u64_t>(st.st_mtime) * 1000000000;
+#endif
+    }
 #endif
     return value;
 }
@@ -812,6 +1030,35 @@ FileUtils::timestamp(const URI &fileURI) NANOEM_DECL_NOEXCEPT
     return timestamp(fileURI.absolutePathConstString());
 }
 
+nanoem_u64_t
+FileUtils::fileSize(const char *filePath) NANOEM_DECL_NOEXCEPT
+{
+    nanoem_u64_t value = 0;
+#if BX_PLATFORM_WINDOWS
+    MutableWideString newPath;
+    StringUtils::getWideCharString(filePath, newPath);
+    WIN32_FILE_ATTRIBUTE_DATA data;
+    if (GetFileAttributesExW(newPath.data(), GetFileExInfoStandard, &data)) {
+        ULARGE_INTEGER ul;
+        ul.HighPart = data.nFileSizeHigh;
+        ul.LowPart = data.nFileSizeLow;
+        value = ul.QuadPart;
+    }
+#else
+    struct stat st;
+    if (::stat(filePath, &st) == 0) {
+        value = static_cast<nanoem_u64_t>(st.st_size);
+    }
+#endif
+    return value;
+}
+
+nanoem_u64_t
+FileUtils::fileSize(const URI &fileURI) NANOEM_DECL_NOEXCEPT
+{
+    return fileSize(fileURI.absolutePathConstString());
+}
+
 bool
 FileUtils::exists(const char *filePath) NANOEM_DECL_NOEXCEPT
 {
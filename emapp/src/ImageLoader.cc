@@ -13,6 +13,7 @@
 #include "emapp/Project.h"
 #include "emapp/StringUtils.h"
 #include "emapp/URI.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
 #include "emapp/private/CommonInclude.h"
 
 #include "bimg/decode.h"
@@ -798,13 +799,112 @@ APNGImage::seek(nanoem_f32_t seconds) const
     return offset;
 }
 
+struct ImageLoader::Batch::Item {
+    Item(const URI &fileURI, const String &filename, sg_wrap wrap, nanoem_u32_t flags)
+        : m_fileURI(fileURI)
+        , m_filename(filename)
+        , m_wrap(wrap)
+        , m_flags(flags)
+        , m_image(nullptr)
+    {
+    }
+    URI m_fileURI;
+    String m_filename;
+    ByteArray m_bytes;
+    sg_wrap m_wrap;
+    nanoem_u32_t m_flags;
+    const internal::DecodedImage *m_image;
+    Error m_error;
+};
+
+ImageLoader::Batch::Batch(ImageLoader *loader, IDrawable *drawable)
+    : m_loader(loader)
+    , m_drawable(drawable)
+{
+}
+
+ImageLoader::Batch::~Batch() NANOEM_DECL_NOEXCEPT
+{
+    for (ItemList::const_iterator it = m_items.begin(), end = m_items.end(); it != end; ++it) {
+        Item *item = *it;
+        m_loader->m_decodedImageCache.release(item->m_image);
+        nanoem_delete(item);
+    }
+    m_items.clear();
+}
+
+void
+ImageLoader::Batch::add(const URI &fileURI, sg_wrap wrap, nanoem_u32_t flags)
+{
+    nanoem_parameter_assert(!fileURI.isEmpty(), "must NOT be empty");
+    const String filename(FileUtils::relativePath(
+        fileURI.absolutePath(), m_drawable->fileURI().absolutePathByDeletingLastPathComponent()));
+    m_items.push_back(nanoem_new(Item(fileURI, filename, wrap, m_loader->resolveFlags(flags))));
+}
+
+void
+ImageLoader::Batch::add(const ByteArray &bytes, const String &filename, sg_wrap wrap, nanoem_u32_t flags)
+{
+    Item *item = nanoem_new(Item(URI(), filename, wrap, flags));
+    item->m_bytes = bytes;
+    m_items.push_back(item);
+}
+
+void
+ImageLoader::Batch::decodeAll()
+{
+    m_loader->m_dispatcher->dispatch(handleDecodingItem, this, m_items.size());
+}
+
+IImageView *
+ImageLoader::Batch::upload(nanoem_rsize_t index, Error &error)
+{
+    IImageView *imageView = nullptr;
+    if (index < m_items.size()) {
+        const Item *item = m_items[index];
+        if (item->m_image) {
+            imageView = m_loader->uploadDecodedImage(item->m_filename, item->m_image, item->m_wrap, m_drawable);
+        }
+        else if (item->m_error.hasReason()) {
+            error = item->m_error;
+        }
+    }
+    return imageView;
+}
+
+nanoem_rsize_t
+ImageLoader::Batch::numItems() const NANOEM_DECL_NOEXCEPT
+{
+    return m_items.size();
+}
+
+void
+ImageLoader::Batch::handleDecodingItem(void *opaque, size_t index)
+{
+    Batch *self = static_cast<Batch *>(opaque);
+    Item *item = self->m_items[index];
+    /* items are already decoded in parallel so each key is hashed on the worker thread without dispatching */
+    if (!item->m_bytes.empty()) {
+        item->m_image = self->m_loader->decodeCached(
+            item->m_filename, item->m_bytes.data(), item->m_bytes.size(), item->m_flags, nullptr, item->m_error);
+    }
+    else if (!item->m_fileURI.isEmpty()) {
+        item->m_image =
+            self->m_loader->decodeFile(item->m_fileURI, item->m_filename, item->m_flags, nullptr, item->m_error);
+    }
+}
+
 ImageLoader::ImageLoader(const Project *project)
     : m_project(project)
+    , m_decodedImageCache(internal::DecodedImageCache::kDefaultBudget)
+    , m_dispatcher(nullptr)
 {
+    m_dispatcher = nanoem_new(internal::ParallelTaskDispatcher("com.github.nanoem.gcd.image"));
 }
 
 ImageLoader::~ImageLoader()
 {
+    nanoem_delete_safe(m_dispatcher);
 }
 
 IImageView *
@@ -814,21 +914,9 @@ ImageLoader::load(const URI &fileURI, IDrawable *drawable, sg_wrap wrap, nanoem_
     IImageView *imageView = nullptr;
     const String filename(
         FileUtils::relativePath(fileURI.absolutePath(), drawable->fileURI().absolutePathByDeletingLastPathComponent()));
-    const char lastChr = filename.empty() ? 0 : *(filename.c_str() + filename.size() - 1);
-    if (lastChr != '/' && FileUtils::exists(fileURI)) {
-        FileReaderScope scope(nullptr);
-        if (scope.open(fileURI, error)) {
-            ByteArray bytes;
-            FileUtils::read(scope, bytes, error);
-            if (!error.hasReason()) {
-                if (!m_project->isMipmapEnabled()) {
-                    flags &= ~ImageLoader::kFlagsEnableMipmap;
-                }
-                const ImmutableImageContainer container(
-                    filename, bytes, Vector2UI16(), wrap, m_project->maxAnisotropyValue(), flags);
-                imageView = decodeImageContainer(container, drawable, error);
-            }
-        }
+    if (const internal::DecodedImage *image = decodeFile(fileURI, filename, resolveFlags(flags), m_dispatcher, error)) {
+        imageView = uploadDecodedImage(filename, image, wrap, drawable);
+        m_decodedImageCache.release(image);
     }
     return imageView;
 }
@@ -837,17 +925,79 @@ IImageView *
 ImageLoader::decode(
     const ByteArray &bytes, const String &filename, IDrawable *drawable, sg_wrap wrap, nanoem_u32_t flags, Error &error)
 {
-    const ImageLoader::ImmutableImageContainer container(
-        filename, bytes, Vector2UI16(), wrap, m_project->maxAnisotropyValue(), flags);
-    return decodeImageContainer(container, drawable, error);
+    IImageView *imageView = nullptr;
+    if (const internal::DecodedImage *image =
+            decodeCached(filename, bytes.data(), bytes.size(), flags, m_dispatcher, error)) {
+        imageView = uploadDecodedImage(filename, image, wrap, drawable);
+        m_decodedImageCache.release(image);
+    }
+    return imageView;
+}
+
+internal::DecodedImageCache *
+ImageLoader::decodedImageCache() NANOEM_DECL_NOEXCEPT
+{
+    return &m_decodedImageCache;
+}
+
+nanoem_u32_t
+ImageLoader::resolveFlags(nanoem_u32_t flags) const NANOEM_DECL_NOEXCEPT
+{
+    if (!m_project->isMipmapEnabled()) {
+        flags &= ~ImageLoader::kFlagsEnableMipmap;
+    }
+    return flags;
+}
+
+const internal::DecodedImage *
+ImageLoader::decodeFile(const URI &fileURI, const String &filename, nanoem_u32_t flags,
+    internal::ParallelTaskDispatcher *dispatcher, Error &error)
+{
+    const internal::DecodedImage *image = nullptr;
+    const char lastChr = filename.empty() ? 0 : *(filename.c_str() + filename.size() - 1);
+    if (lastChr != '/' && FileUtils::exists(fileURI)) {
+        MappedFileReader reader(nullptr);
+        if (reader.open(fileURI, error)) {
+            image = decodeCached(filename, reader.bytes(), reader.size(), flags, dispatcher, error);
+        }
+    }
+    return image;
+}
+
+const internal::DecodedImage *
+ImageLoader::decodeCached(const String &filename, const nanoem_u8_t *dataPtr, nanoem_rsize_t dataSize,
+    nanoem_u32_t flags, internal::ParallelTaskDispatcher *dispatcher, Error &error)
+{
+    /* fallback flags only matter to the caller so they are excluded from the key to share decoded images */
+    const nanoem_u32_t decodingFlags = flags & (kFlagsEnableMipmap | kFlagsEnableFlipY);
+    const internal::DecodedImageCache::Key key(
+        internal::DecodedImageCache::Key::create(dataPtr, dataSize, decodingFlags, dispatcher));
+    const internal::DecodedImage *image = m_decodedImageCache.acquire(key);
+    if (!image) {
+        const ImmutableImageContainer container(filename, dataPtr, dataSize, Vector2UI16(), decodingFlags);
+        if (internal::DecodedImage *decodedImage = decodeImageContainer(container, error)) {
+            image = m_decodedImageCache.insert(key, decodedImage);
+        }
+    }
+    return image;
 }
 
 IImageView *
-ImageLoader::decodeImageContainer(const ImmutableImageContainer &container, IDrawable *drawable, Error &error)
+ImageLoader::uploadDecodedImage(
+    const String &filename, const internal::DecodedImage *image, sg_wrap wrap, IDrawable *drawable) const
+{
+    sg_image_desc desc(image->m_description);
+    desc.max_anisotropy = m_project->maxAnisotropyValue();
+    desc.wrap_u = desc.wrap_v = wrap;
+    return drawable->uploadImage(filename, desc);
+}
+
+internal::DecodedImage *
+ImageLoader::decodeImageContainer(const ImmutableImageContainer &container, Error &error)
 {
     bx::Error err;
     sg_image_desc desc;
-    IImageView *imageView = nullptr;
+    internal::DecodedImage *image = nullptr;
     int width, height, components;
     Inline::clearZeroMemory(desc);
     if (stbi_uc *data = stbi_load_from_memory(
@@ -857,12 +1007,11 @@ ImageLoader::decodeImageContainer(const ImmutableImageContainer &container, IDra
         desc.pixel_format = SG_PIXELFORMAT_RGBA8;
         desc.min_filter = SG_FILTER_LINEAR;
         desc.mag_filter = SG_FILTER_LINEAR;
-        desc.max_anisotropy = container.m_anisotropy;
-        desc.wrap_u = desc.wrap_v = container.m_wrap;
         sg_range &content = desc.data.subimage[0][0];
         content.ptr = data;
         content.size = nanoem_rsize_t(4) * width * height;
-        imageView = drawable->uploadImage(container.m_name, desc);
+        image = nanoem_new(internal::DecodedImage);
+        image->assign(desc);
         stbi_image_free(data);
     }
     else if (bimg::ImageContainer *decodedImageContainer = bimg::imageParse(g_bimg_allocator, container.m_dataPtr,
@@ -897,17 +1046,17 @@ ImageLoader::decodeImageContainer(const ImmutableImageContainer &container, IDra
                 }
                 desc.min_filter = SG_FILTER_LINEAR;
             }
-            bimg::imageFree(decodedImageContainer);
             desc.mag_filter = SG_FILTER_LINEAR;
-            desc.max_anisotropy = container.m_anisotropy;
-            desc.wrap_u = desc.wrap_v = container.m_wrap;
-            imageView = drawable->uploadImage(container.m_name, desc);
+            /* must be copied before freeing the container because mipmaps of it may be referred directly */
+            image = nanoem_new(internal::DecodedImage);
+            image->assign(desc);
         }
+        bimg::imageFree(decodedImageContainer);
     }
     else {
         error = Error(err.getMessage().getPtr(), err.get().code, Error::kDomainTypeOS);
     }
-    return imageView;
+    return image;
 }
 
 void
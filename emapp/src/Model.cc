@@ -33,6 +33,7 @@
 #include "emapp/internal/DebugDrawer.h"
 #include "emapp/internal/LineDrawer.h"
 #include "emapp/internal/ModelObjectSelection.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
 #include "emapp/model/BindPose.h"
 #include "emapp/model/Exporter.h"
 #include "emapp/model/IGizmo.h"
@@ -43,6 +44,7 @@
 #include "emapp/model/Label.h"
 #include "emapp/model/RigidBody.h"
 #include "emapp/model/SoftBody.h"
+#include "emapp/model/Validator.h"
 #include "emapp/model/Vertex.h"
 #include "emapp/private/CommonInclude.h"
 
@@ -59,12 +61,6 @@
 #define PAR_SHAPES_T uint32_t
 #include "par/par_shapes.h"
 
-#if defined(NANOEM_ENABLE_TBB)
-#include "tbb/tbb.h"
-#endif /* NANOEM_ENABLE_TBB */
-#if defined(__APPLE__)
-#include <dispatch/dispatch.h>
-#endif /* __APPLE__ */
 
 namespace nanoem {
 namespace {
@@ -97,6 +93,8 @@ enum PrivateStateFlags {
     kPrivateStateShowAllVertexWeights = 1 << 21,
     kPrivateStateBlendingVertexWeightsEnabled = 1 << 22,
     kPrivateStateShowAllVertexNormals = 1 << 23,
+    kPrivateStateDirtySkinningBatch = 1 << 24,
+    kPrivateStateMappedStagingBuffer = 1 << 25,
     kPrivateStateReserved = 1 << 31,
 };
 static const nanoem_u32_t kPrivateStateInitialValue = kPrivateStatePhysicsSimulation | kPrivateStateEnableGroundShadow;
@@ -128,6 +126,240 @@ struct PrivateModelUtils : private NonCopyable {
     }
 };
 
+BX_ALIGN_DECL_16(struct)
+SkinningBoneUnit
+{
+    bx::float4x4_t m_skinningTransform;
+    bx::float4x4_t m_normalTransform;
+    bx::float4x4_t m_positionDualQuaternion;
+    bx::float4x4_t m_normalDualQuaternion;
+    Quaternion m_orientation;
+};
+
+struct PrivateSkinningUtils : private NonCopyable {
+    static inline nanoem_rsize_t
+    bucketIndex(const nanoem_model_vertex_t *vertexPtr) NANOEM_DECL_NOEXCEPT
+    {
+        /* vertices of unknown type are put to the last bucket to update attributes only */
+        const nanoem_model_vertex_type_t type = nanoemModelVertexGetType(vertexPtr);
+        return type >= NANOEM_MODEL_VERTEX_TYPE_FIRST_ENUM && type < NANOEM_MODEL_VERTEX_TYPE_MAX_ENUM
+            ? nanoem_rsize_t(type)
+            : nanoem_rsize_t(NANOEM_MODEL_VERTEX_TYPE_MAX_ENUM);
+    }
+    static inline void
+    performBdef1(const SkinningBoneUnit *bones, const nanoem_u32_t *indices, const bx::simd128_t op,
+        const bx::simd128_t on, bx::simd128_t *p, bx::simd128_t *n) NANOEM_DECL_NOEXCEPT
+    {
+        const SkinningBoneUnit &bone = bones[indices[0]];
+        bx::simd_st(p, bx::simd_mul_xyz1(op, &bone.m_skinningTransform));
+        bx::simd_st(n, bx::simd_mul_xyz1(on, &bone.m_normalTransform));
+    }
+    static inline void
+    performBdef2(const SkinningBoneUnit *bones, const nanoem_u32_t *indices, const bx::simd128_t weights,
+        const bx::simd128_t op, const bx::simd128_t on, bx::simd128_t *p, bx::simd128_t *n) NANOEM_DECL_NOEXCEPT
+    {
+        const bx::simd128_t weight = bx::simd_swiz_xxxx(weights);
+        if (bx::simd_test_all_x(bx::simd_cmpeq(weight, bx::simd_zero()))) {
+            const SkinningBoneUnit &bone1 = bones[indices[1]];
+            bx::simd_st(p, bx::simd_mul_xyz1(op, &bone1.m_skinningTransform));
+            bx::simd_st(n, bx::simd_mul_xyz1(on, &bone1.m_normalTransform));
+        }
+        else if (bx::simd_test_all_x(bx::simd_cmpeq(weight, bx::simd_splat(1.0f)))) {
+            const SkinningBoneUnit &bone0 = bones[indices[0]];
+            bx::simd_st(p, bx::simd_mul_xyz1(op, &bone0.m_skinningTransform));
+            bx::simd_st(n, bx::simd_mul_xyz1(on, &bone0.m_normalTransform));
+        }
+        else {
+            const SkinningBoneUnit &bone0 = bones[indices[0]], &bone1 = bones[indices[1]];
+            const bx::simd128_t p0 = bx::simd_mul_xyz1(op, &bone0.m_skinningTransform);
+            const bx::simd128_t p1 = bx::simd_mul_xyz1(op, &bone1.m_skinningTransform);
+            const bx::simd128_t n0 = bx::simd_mul_xyz1(on, &bone0.m_normalTransform);
+            const bx::simd128_t n1 = bx::simd_mul_xyz1(on, &bone1.m_normalTransform);
+            bx::simd_st(p, bx::simd_lerp_ni(p1, p0, weight));
+            bx::simd_st(n, bx::simd_lerp_ni(n1, n0, weight));
+        }
+    }
+    static inline void
+    performBdef4(const SkinningBoneUnit *bones, const nanoem_u32_t *indices, const bx::simd128_t weights,
+        const bx::simd128_t op, const bx::simd128_t on, bx::simd128_t *p, bx::simd128_t *n) NANOEM_DECL_NOEXCEPT
+    {
+        const bx::simd128_t w[] = { bx::simd_swiz_xxxx(weights), bx::simd_swiz_yyyy(weights),
+            bx::simd_swiz_zzzz(weights), bx::simd_swiz_wwww(weights) };
+        bx::simd128_t p0 = bx::simd_zero(), n0 = bx::simd_zero();
+        for (int i = 0; i < 4; i++) {
+            const SkinningBoneUnit &bone = bones[indices[i]];
+            p0 = bx::simd_madd_ni(bx::simd_mul_xyz1(op, &bone.m_skinningTransform), w[i], p0);
+            n0 = bx::simd_madd_ni(bx::simd_mul_xyz1(on, &bone.m_normalTransform), w[i], n0);
+        }
+        bx::simd_st(p, p0);
+        bx::simd_st(n, n0);
+    }
+    static inline void
+    performQdef(const SkinningBoneUnit *bones, const nanoem_u32_t *indices, const bx::simd128_t weights,
+        const bx::simd128_t op, const bx::simd128_t on, bx::simd128_t *p, bx::simd128_t *n) NANOEM_DECL_NOEXCEPT
+    {
+#if GLM_VERSION >= 960
+        const bx::simd128_t w[] = { bx::simd_swiz_xxxx(weights), bx::simd_swiz_yyyy(weights),
+            bx::simd_swiz_zzzz(weights), bx::simd_swiz_wwww(weights) };
+        bx::simd128_t p0 = bx::simd_zero(), n0 = bx::simd_zero();
+        for (int i = 0; i < 4; i++) {
+            const SkinningBoneUnit &bone = bones[indices[i]];
+            p0 = bx::simd_madd_ni(bx::simd_mul_xyz1(op, &bone.m_positionDualQuaternion), w[i], p0);
+            n0 = bx::simd_madd_ni(bx::simd_mul_xyz1(on, &bone.m_normalDualQuaternion), w[i], n0);
+        }
+        bx::simd_st(p, p0);
+        bx::simd_st(n, n0);
+#else
+        performBdef4(bones, indices, weights, op, on, p, n);
+#endif
+    }
+    static inline void
+    performSdef(const SkinningBoneUnit *bones, const nanoem_u32_t *indices, const nanoem_model_vertex_t *vertexPtr,
+        const bx::simd128_t weights, const bx::simd128_t op, const bx::simd128_t on, bx::simd128_t *p,
+        bx::simd128_t *n) NANOEM_DECL_NOEXCEPT
+    {
+#if defined(NANOEM_ENABLE_SDEF)
+        const SkinningBoneUnit &bone0 = bones[indices[0]], &bone1 = bones[indices[1]];
+        const bx::simd128_t sdefC = bx::simd_ld(nanoemModelVertexGetSdefC(vertexPtr));
+        const bx::simd128_t sdefR0 = bx::simd_ld(nanoemModelVertexGetSdefR0(vertexPtr));
+        const bx::simd128_t sdefR1 = bx::simd_ld(nanoemModelVertexGetSdefR1(vertexPtr));
+        const bx::simd128_t w0 = bx::simd_swiz_xxxx(weights);
+        const bx::simd128_t w1 = bx::simd_swiz_yyyy(weights);
+        const bx::simd128_t sdefI = bx::simd_add(bx::simd_mul(sdefR0, w0), bx::simd_mul(sdefR1, w1));
+        const bx::simd128_t sdefR0N = bx::simd_add(sdefC, bx::simd_sub(sdefR0, sdefI));
+        const bx::simd128_t sdefR1N = bx::simd_add(sdefC, bx::simd_sub(sdefR1, sdefI));
+        const bx::simd128_t r0 = bx::simd_mul_xyz1(sdefR0N, &bone0.m_skinningTransform);
+        const bx::simd128_t r1 = bx::simd_mul_xyz1(sdefR1N, &bone1.m_skinningTransform);
+        const bx::simd128_t c0 = bx::simd_mul_xyz1(sdefC, &bone0.m_skinningTransform);
+        const bx::simd128_t c1 = bx::simd_mul_xyz1(sdefC, &bone1.m_skinningTransform);
+        const bx::simd128_t delta = bx::simd_add(bx::simd_mul(bx::simd_sub(bx::simd_add(r0, c0), sdefC), w0),
+            bx::simd_mul(bx::simd_sub(bx::simd_add(r1, c1), sdefC), w1));
+        const bx::simd128_t t = bx::simd_mul(bx::simd_add(sdefC, delta), bx::simd_splat(0.5f));
+        const Matrix4x4 m0(glm::mat4_cast(glm::slerp(bone0.m_orientation, bone1.m_orientation, bx::simd_x(w1))));
+        const bx::float4x4_t m1 = *reinterpret_cast<const bx::float4x4_t *>(&m0);
+        bx::simd_st(p, bx::simd_add(bx::simd_mul_xyz1(bx::simd_sub(op, sdefC), &m1), t));
+        bx::simd_st(n, bx::simd_mul_xyz1(on, &m1));
+#else
+        BX_UNUSED_1(vertexPtr);
+        performBdef2(bones, indices, weights, op, on, p, n);
+#endif /* NANOEM_ENABLE_SDEF */
+    }
+    static inline void
+    performByType(nanoem_model_vertex_type_t type, const SkinningBoneUnit *bones, const nanoem_u32_t *indices,
+        const model::Vertex *vertex, bx::simd128_t *p, bx::simd128_t *n) NANOEM_DECL_NOEXCEPT
+    {
+        const bx::simd128_t op = bx::simd_add(vertex->m_simd.m_origin, vertex->m_simd.m_delta),
+                            on = vertex->m_simd.m_normal, weights = vertex->m_simd.m_weights;
+        switch (type) {
+        case NANOEM_MODEL_VERTEX_TYPE_BDEF1: {
+            performBdef1(bones, indices, op, on, p, n);
+            break;
+        }
+        case NANOEM_MODEL_VERTEX_TYPE_BDEF2: {
+            performBdef2(bones, indices, weights, op, on, p, n);
+            break;
+        }
+        case NANOEM_MODEL_VERTEX_TYPE_BDEF4: {
+            performBdef4(bones, indices, weights, op, on, p, n);
+            break;
+        }
+        case NANOEM_MODEL_VERTEX_TYPE_SDEF: {
+            performSdef(bones, indices, vertex->data(), weights, op, on, p, n);
+            break;
+        }
+        case NANOEM_MODEL_VERTEX_TYPE_QDEF: {
+            performQdef(bones, indices, weights, op, on, p, n);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    static inline bool
+    hasLaneKernel(nanoem_model_vertex_type_t type) NANOEM_DECL_NOEXCEPT
+    {
+        return type == NANOEM_MODEL_VERTEX_TYPE_BDEF1 || type == NANOEM_MODEL_VERTEX_TYPE_BDEF2;
+    }
+    static inline void
+    transposeLanes(const bx::simd128_t a, const bx::simd128_t b, const bx::simd128_t c, const bx::simd128_t d,
+        bx::simd128_t *lanes) NANOEM_DECL_NOEXCEPT
+    {
+        const bx::simd128_t t0 = bx::simd_shuf_xAyB(a, b), t1 = bx::simd_shuf_xAyB(c, d);
+        const bx::simd128_t t2 = bx::simd_shuf_zCwD(a, b), t3 = bx::simd_shuf_zCwD(c, d);
+        lanes[0] = bx::simd_shuf_xyAB(t0, t1);
+        lanes[1] = bx::simd_shuf_zwCD(t0, t1);
+        lanes[2] = bx::simd_shuf_xyAB(t2, t3);
+        lanes[3] = bx::simd_shuf_zwCD(t2, t3);
+    }
+    static inline void
+    multiplyLanes(const bx::simd128_t *v, const bx::float4x4_t *const *m, bx::simd128_t *result) NANOEM_DECL_NOEXCEPT
+    {
+        /* same operation order as bx::simd_mul_xyz1 so that each lane equals to the per vertex skinning */
+        bx::simd128_t columns[4][4];
+        for (int i = 0; i < 4; i++) {
+            transposeLanes(m[0]->col[i], m[1]->col[i], m[2]->col[i], m[3]->col[i], columns[i]);
+        }
+        for (int i = 0; i < 4; i++) {
+            const bx::simd128_t c0 = bx::simd_mul(columns[0][i], v[0]);
+            const bx::simd128_t c1 = bx::simd_mul(columns[1][i], v[1]);
+            const bx::simd128_t c2 = bx::simd_madd(columns[2][i], v[2], c0);
+            const bx::simd128_t c3 = bx::simd_add(columns[3][i], c1);
+            result[i] = bx::simd_add(c2, c3);
+        }
+    }
+    static inline void
+    blendLanes(const bx::simd128_t weight, const bx::simd128_t *v1, bx::simd128_t *v0) NANOEM_DECL_NOEXCEPT
+    {
+        /* picks either bone as performBdef2 does when the weight is exactly 0 or 1 */
+        const bx::simd128_t first = bx::simd_cmpeq(weight, bx::simd_splat(1.0f)),
+                            second = bx::simd_cmpeq(weight, bx::simd_zero());
+        for (int i = 0; i < 4; i++) {
+            const bx::simd128_t value = bx::simd_madd(bx::simd_sub(v0[i], v1[i]), weight, v1[i]);
+            v0[i] = bx::simd_selb(second, v1[i], bx::simd_selb(first, v0[i], value));
+        }
+    }
+    static inline void
+    performLanes(nanoem_model_vertex_type_t type, const SkinningBoneUnit *bones, const nanoem_u32_t *indices,
+        const model::Vertex *const *vertices, bx::simd128_t *const *p, bx::simd128_t *const *n) NANOEM_DECL_NOEXCEPT
+    {
+        /* four vertices of the same type are transposed to the SoA registers and skinned at once */
+        bx::simd128_t op[4], on[4], weights[4], pl[4], nl[4];
+        const bx::float4x4_t *pm[4], *nm[4];
+        for (int i = 0; i < 4; i++) {
+            const model::Vertex *vertex = vertices[i];
+            const SkinningBoneUnit &bone = bones[indices[i * 4]];
+            op[i] = bx::simd_add(vertex->m_simd.m_origin, vertex->m_simd.m_delta);
+            on[i] = vertex->m_simd.m_normal;
+            weights[i] = vertex->m_simd.m_weights;
+            pm[i] = &bone.m_skinningTransform;
+            nm[i] = &bone.m_normalTransform;
+        }
+        transposeLanes(op[0], op[1], op[2], op[3], op);
+        transposeLanes(on[0], on[1], on[2], on[3], on);
+        multiplyLanes(op, pm, pl);
+        multiplyLanes(on, nm, nl);
+        if (type == NANOEM_MODEL_VERTEX_TYPE_BDEF2) {
+            bx::simd128_t pl1[4], nl1[4];
+            for (int i = 0; i < 4; i++) {
+                const SkinningBoneUnit &bone = bones[indices[i * 4 + 1]];
+                pm[i] = &bone.m_skinningTransform;
+                nm[i] = &bone.m_normalTransform;
+            }
+            multiplyLanes(op, pm, pl1);
+            multiplyLanes(on, nm, nl1);
+            transposeLanes(weights[0], weights[1], weights[2], weights[3], weights);
+            blendLanes(weights[0], pl1, pl);
+            blendLanes(weights[0], nl1, nl);
+        }
+        transposeLanes(pl[0], pl[1], pl[2], pl[3], pl);
+        transposeLanes(nl[0], nl[1], nl[2], nl[3], nl);
+        for (int i = 0; i < 4; i++) {
+            bx::simd_st(p[i], pl[i]);
+            bx::simd_st(n[i], nl[i]);
+        }
+    }
+};
+
 struct DummyLight : ILight {
     DummyLight(Project *project)
         : m_project(project)
@@ -255,11 +487,8 @@ Model::VertexUnit::setUVA(const model::Vertex *vertex) NANOEM_DECL_NOEXCEPT
 }
 
 void
-Model::VertexUnit::performSkinning(nanoem_f32_t edgeSizeFactor, const model::Vertex *vertex) NANOEM_DECL_NOEXCEPT
+Model::VertexUnit::updateAttributes(nanoem_f32_t edgeSizeFactor, const model::Vertex *vertex) NANOEM_DECL_NOEXCEPT
 {
-    if (!vertex->hasSoftBody()) {
-        performSkinningByType(vertex, &m_position, &m_normal);
-    }
     m_edge = bx::simd_madd(m_normal, bx::simd_splat(bx::simd_x(vertex->m_simd.m_info) * edgeSizeFactor), m_position);
     m_texcoord = bx::simd_add(vertex->m_simd.m_texcoord, vertex->m_simd.m_deltaUVA[0]);
     setUVA(vertex);
@@ -531,11 +760,14 @@ Model::ParallelSkinningTaskData::ParallelSkinningTaskData(
     : m_model(model)
     , m_drawType(type)
     , m_edgeSizeScaleFactor(edgeSizeFactor)
-    , m_boneIndices(0)
     , m_output(0)
     , m_materials(nullptr)
     , m_vertices(nullptr)
     , m_numVertices(0)
+    , m_batches(nullptr)
+    , m_bones(nullptr)
+    , m_vertexIndices(nullptr)
+    , m_boneIndices(nullptr)
 {
     const nanoem_model_t *opaque = model->data();
     nanoem_rsize_t numMaterials;
@@ -862,6 +1094,7 @@ Model::Model(Project *project, nanoem_u16_t handle)
     , m_skinDeformer(nullptr)
     , m_gizmo(nullptr)
     , m_vertexWeightPainter(nullptr)
+    , m_validator(nullptr)
     , m_opaque(nullptr)
     , m_undoStack(nullptr)
     , m_editingUndoStack(nullptr)
@@ -877,14 +1110,19 @@ Model::Model(Project *project, nanoem_u16_t handle)
     , m_transformAxisType(kAxisTypeNone)
     , m_transformCoordinateType(kTransformCoordinateTypeLocal)
     , m_states(kPrivateStateInitialValue)
+    , m_boneTransformSequence(0)
+    , m_allObjectsEditGeneration(0)
+    , m_editGeneration(0)
     , m_edgeSizeScaleFactor(1.0f)
     , m_opacity(1.0f)
-    , m_dispatchParallelTaskQueue(nullptr)
+    , m_parallelTaskDispatcher(nullptr)
+    , m_stagingVertexBufferPtr(nullptr)
     , m_countVertexSkinningNeeded(0)
     , m_stageVertexBufferIndex(0)
 {
     nanoem_assert(m_project, "must not be nullptr");
     Inline::clearZeroMemory(m_activeMorphPtr);
+    Inline::clearZeroMemory(m_objectEditGenerations);
     m_vertexBuffers[0] = m_vertexBuffers[1] = m_indexBuffer = { SG_INVALID_ID };
     m_activeEffectPtrPair.first = m_project->sharedResourceRepository()->modelProgramBundle();
     m_activeEffectPtrPair.second = nullptr;
@@ -910,6 +1148,8 @@ Model::~Model() NANOEM_DECL_NOEXCEPT
     nanoem_delete_safe(m_skinDeformer);
     nanoem_delete_safe(m_gizmo);
     nanoem_delete_safe(m_vertexWeightPainter);
+    nanoem_delete_safe(m_parallelTaskDispatcher);
+    nanoem_delete_safe(m_validator);
     nanoem_delete_safe(m_selection);
     nanoem_delete_safe(m_screenImage);
     undoStackDestroy(m_undoStack);
@@ -934,6 +1174,7 @@ Model::load(const nanoem_u8_t *bytes, size_t length, Error &error)
     nanoem_parameter_assert(bytes, "must not be nullptr");
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     nanoem_buffer_t *buffer = nanoemBufferCreate(bytes, length, &status);
+    nanoemModelSetArenaEnabled(m_opaque, nanoem_true);
     nanoemModelLoadFromBuffer(m_opaque, buffer, &status);
     nanoemBufferDestroy(buffer);
     bool succeeded = status == NANOEM_STATUS_SUCCESS;
@@ -1374,19 +1615,8 @@ Model::upload()
     initializeAllStagingVertexBuffers();
     initializeStagingIndexBuffer();
     setActiveEffect(m_project->sharedResourceRepository()->modelProgramBundle());
-#if defined(__APPLE__)
-#ifdef NDEBUG
-#define GCD_LABEL(a) nullptr
-#else
-#define GCD_LABEL(a) a
-#endif /* NDEBUG */
-    if (dispatch_queue_t queue = static_cast<dispatch_queue_t>(m_dispatchParallelTaskQueue)) {
-        dispatch_release(queue);
-    }
-    m_dispatchParallelTaskQueue =
-        dispatch_queue_create(GCD_LABEL("com.github.nanoem.gcd.model"), DISPATCH_QUEUE_CONCURRENT);
-#undef GCD_LABEL
-#endif /* __APPLE__ */
+    nanoem_delete_safe(m_parallelTaskDispatcher);
+    m_parallelTaskDispatcher = nanoem_new(internal::ParallelTaskDispatcher("com.github.nanoem.gcd.model"));
     EnumUtils::setEnabled(kPrivateStateUploaded, m_states, true);
     setDirty(true);
     SG_POP_GROUP();
@@ -1396,22 +1626,37 @@ void
 Model::uploadArchive(const Archiver &archiver, Progress &progress, Error &error)
 {
     SG_PUSH_GROUPF("Model::uploadArchive(name=%s)", canonicalNameConstString());
-    ByteArray bytes;
-    Archiver::Entry entry;
-    ImageLoader *imageLoader = m_project->sharedImageLoader();
+    Archiver::EntryList entries;
+    ByteArrayList bytesList;
+    ImageLoader::Batch batch(m_project->sharedImageLoader(), this);
     for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
          it != end; ++it) {
+        Archiver::Entry entry;
+        entry.m_path = (*it)->m_fileURI.fragment();
+        entries.push_back(entry);
+    }
+    /*
+     * the archiver cannot be shared with worker threads so all entries are extracted before decoding.
+     * missing images fall back to 1x1 pixel images below so their extraction errors are not propagated
+     */
+    Error extractError;
+    archiver.extractAll(entries, bytesList, extractError);
+    nanoem_rsize_t index = 0;
+    for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
+         it != end; ++it, ++index) {
         const LoadingImageItem *item = *it;
-        const URI &fileURI = item->m_fileURI;
-        const String &filename = fileURI.fragment();
-        if (!progress.tryLoadingItem(fileURI)) {
+        batch.add(bytesList[index], item->m_filename, item->m_wrap, item->m_flags);
+    }
+    batch.decodeAll();
+    index = 0;
+    for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
+         it != end; ++it, ++index) {
+        const LoadingImageItem *item = *it;
+        if (!progress.tryLoadingItem(item->m_fileURI)) {
             error = Error::cancelled();
             break;
         }
-        else if (archiver.findEntry(filename, entry, error) && archiver.extract(entry, bytes, error)) {
-            imageLoader->decode(bytes, item->m_filename, this, item->m_wrap, item->m_flags, error);
-        }
-        else {
+        else if (!batch.upload(index, error)) {
             sg_image_desc desc;
             if (EnumUtils::isEnabled(item->m_flags, ImageLoader::kFlagsFallbackWhiteOpaque)) {
                 ImageLoader::fill1x1WhitePixelImage(desc);
@@ -1449,16 +1694,23 @@ void
 Model::loadAllImages(Progress &progress, Error &error)
 {
     SG_PUSH_GROUPF("Model::loadAllImages(name=%s)", canonicalNameConstString());
-    ImageLoader *imageLoader = m_project->sharedImageLoader();
+    ImageLoader::Batch batch(m_project->sharedImageLoader(), this);
     for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
          it != end; ++it) {
         const LoadingImageItem *item = *it;
-        const URI &fileURI = item->m_fileURI;
-        if (!progress.tryLoadingItem(fileURI)) {
+        batch.add(item->m_fileURI, item->m_wrap, item->m_flags);
+    }
+    /* decodes on worker threads and only uploads to the device from this thread */
+    batch.decodeAll();
+    nanoem_rsize_t index = 0;
+    for (LoadingImageItemList::const_iterator it = m_loadingImageItems.begin(), end = m_loadingImageItems.end();
+         it != end; ++it, ++index) {
+        const LoadingImageItem *item = *it;
+        if (!progress.tryLoadingItem(item->m_fileURI)) {
             error = Error::cancelled();
             break;
         }
-        else if (!imageLoader->load(fileURI, this, item->m_wrap, item->m_flags, error)) {
+        else if (!batch.upload(index, error)) {
             sg_image_desc desc;
             if (EnumUtils::isEnabled(item->m_flags, ImageLoader::kFlagsFallbackWhiteOpaque)) {
                 ImageLoader::fill1x1WhitePixelImage(desc);
@@ -1636,12 +1888,8 @@ Model::destroy()
     if (UserDataDestructor destructor = m_userData.second) {
         destructor(m_userData.first, this);
     }
-#if defined(__APPLE__)
-    if (dispatch_queue_t queue = static_cast<dispatch_queue_t>(m_dispatchParallelTaskQueue)) {
-        m_dispatchParallelTaskQueue = 0;
-        dispatch_release(queue);
-    }
-#endif /* __APPLE__ */
+    nanoem_delete_safe(m_parallelTaskDispatcher);
+    nanoem_delete_safe(m_validator);
     internalClear();
     SG_POP_GROUP();
 }
@@ -1650,65 +1898,157 @@ void
 Model::synchronizeMotion(const Motion *motion, nanoem_frame_index_t frameIndex, nanoem_f32_t amount,
     PhysicsEngine::SimulationTimingType timing)
 {
-    const nanoem_motion_model_keyframe_t *keyframe = nullptr;
-    bool visible = true;
     if (motion && timing == PhysicsEngine::kSimulationTimingBefore) {
-        keyframe = motion->findModelKeyframe(frameIndex);
-        if (keyframe) {
-            setEdgeColor(glm::make_vec4(nanoemMotionModelKeyframeGetEdgeColor(keyframe)));
-            setEdgeSizeScaleFactor(nanoemMotionModelKeyframeGetEdgeScaleFactor(keyframe));
-            if (IEffect *effect = activeEffect()) {
-                nanoem_rsize_t numParameters;
-                nanoem_motion_effect_parameter_t *const *parameters =
-                    nanoemMotionModelKeyframeGetAllEffectParameterObjects(keyframe, &numParameters);
-                effect->setAllParameterObjects(parameters, numParameters);
-            }
+        synchronizeModelMotion(motion, frameIndex);
+    }
+    resolveAllConstraintJoints();
+    synchronizeSkeletonMotion(motion, frameIndex, amount, timing);
+    synchronizeRigidBodyMotion(motion, frameIndex, timing);
+}
+
+void
+Model::synchronizeModelMotion(const Motion *motion, nanoem_frame_index_t frameIndex)
+{
+    nanoem_parameter_assert(motion, "must not be nullptr");
+    nanoem_motion_keyframe_cursor_t *cursor = m_modelKeyframeCursor.resolve(motion);
+    const nanoem_motion_model_keyframe_t *keyframe =
+        nanoemMotionFindModelKeyframeObjectWithCursor(motion->data(), cursor, frameIndex);
+    if (keyframe) {
+        setEdgeColor(glm::make_vec4(nanoemMotionModelKeyframeGetEdgeColor(keyframe)));
+        setEdgeSizeScaleFactor(nanoemMotionModelKeyframeGetEdgeScaleFactor(keyframe));
+        if (IEffect *effect = activeEffect()) {
+            nanoem_rsize_t numParameters;
+            nanoem_motion_effect_parameter_t *const *parameters =
+                nanoemMotionModelKeyframeGetAllEffectParameterObjects(keyframe, &numParameters);
+            effect->setAllParameterObjects(parameters, numParameters);
         }
-        else {
-            nanoem_motion_model_keyframe_t *prevKeyframe, *nextKeyframe;
-            nanoemMotionSearchClosestModelKeyframes(motion->data(), frameIndex, &prevKeyframe, &nextKeyframe);
-            if (prevKeyframe && nextKeyframe) {
-                keyframe = prevKeyframe;
-                const nanoem_f32_t &coef = Motion::coefficient(prevKeyframe, nextKeyframe, frameIndex);
-                setEdgeColor(glm::mix(glm::make_vec4(nanoemMotionModelKeyframeGetEdgeColor(prevKeyframe)),
-                    glm::make_vec4(nanoemMotionModelKeyframeGetEdgeColor(nextKeyframe)), coef));
-                setEdgeSizeScaleFactor(glm::mix(nanoemMotionModelKeyframeGetEdgeScaleFactor(prevKeyframe),
-                    nanoemMotionModelKeyframeGetEdgeScaleFactor(nextKeyframe), coef));
-                if (IEffect *effect = activeEffect()) {
-                    nanoem_rsize_t numFromParameters, numToParameters;
-                    nanoem_motion_effect_parameter_t *const *fromParameters =
-                        nanoemMotionModelKeyframeGetAllEffectParameterObjects(prevKeyframe, &numFromParameters);
-                    nanoem_motion_effect_parameter_t *const *toParameters =
-                        nanoemMotionModelKeyframeGetAllEffectParameterObjects(nextKeyframe, &numToParameters);
-                    effect->setAllParameterObjects(
-                        fromParameters, numFromParameters, toParameters, numToParameters, coef);
-                }
+    }
+    else {
+        nanoem_motion_model_keyframe_t *prevKeyframe, *nextKeyframe;
+        nanoemMotionSearchClosestModelKeyframesWithCursor(
+            motion->data(), cursor, frameIndex, &prevKeyframe, &nextKeyframe);
+        if (prevKeyframe && nextKeyframe) {
+            keyframe = prevKeyframe;
+            const nanoem_f32_t &coef = Motion::coefficient(prevKeyframe, nextKeyframe, frameIndex);
+            setEdgeColor(glm::mix(glm::make_vec4(nanoemMotionModelKeyframeGetEdgeColor(prevKeyframe)),
+                glm::make_vec4(nanoemMotionModelKeyframeGetEdgeColor(nextKeyframe)), coef));
+            setEdgeSizeScaleFactor(glm::mix(nanoemMotionModelKeyframeGetEdgeScaleFactor(prevKeyframe),
+                nanoemMotionModelKeyframeGetEdgeScaleFactor(nextKeyframe), coef));
+            if (IEffect *effect = activeEffect()) {
+                nanoem_rsize_t numFromParameters, numToParameters;
+                nanoem_motion_effect_parameter_t *const *fromParameters =
+                    nanoemMotionModelKeyframeGetAllEffectParameterObjects(prevKeyframe, &numFromParameters);
+                nanoem_motion_effect_parameter_t *const *toParameters =
+                    nanoemMotionModelKeyframeGetAllEffectParameterObjects(nextKeyframe, &numToParameters);
+                effect->setAllParameterObjects(fromParameters, numFromParameters, toParameters, numToParameters, coef);
             }
         }
-        if (keyframe) {
-            visible = nanoemMotionModelKeyframeIsVisible(keyframe) != 0;
-            setPhysicsSimulationEnabled(nanoemMotionModelKeyframeIsPhysicsSimulationEnabled(keyframe) != 0);
-            setVisible(visible);
-            synchronizeAllConstraintStates(keyframe);
-            synchronizeAllOutsideParents(keyframe);
+    }
+    if (keyframe) {
+        setPhysicsSimulationEnabled(nanoemMotionModelKeyframeIsPhysicsSimulationEnabled(keyframe) != 0);
+        setVisible(nanoemMotionModelKeyframeIsVisible(keyframe) != 0);
+        synchronizeAllConstraintStates(keyframe);
+        synchronizeAllOutsideParents(keyframe);
+    }
+}
+
+void
+Model::synchronizeSkeletonMotion(const Motion *motion, nanoem_frame_index_t frameIndex, nanoem_f32_t amount,
+    PhysicsEngine::SimulationTimingType timing)
+{
+    if (motion && timing == PhysicsEngine::kSimulationTimingBefore && isVisible()) {
+        m_boundingBox.reset();
+        resetAllMaterials();
+        resetAllBoneLocalTransform();
+        synchronizeMorphMotion(motion, frameIndex, amount);
+        synchronizeBoneMotion(motion, frameIndex, amount, timing);
+        solveAllConstraints();
+    }
+    else if (motion && timing == PhysicsEngine::kSimulationTimingAfter) {
+        synchronizeBoneMotion(motion, frameIndex, amount, timing);
+    }
+}
+
+void
+Model::synchronizeRigidBodyMotion(
+    const Motion *motion, nanoem_frame_index_t frameIndex, PhysicsEngine::SimulationTimingType timing)
+{
+    if (motion && timing == PhysicsEngine::kSimulationTimingBefore && isVisible()) {
+        synchronizeAllRigidBodyKinematics(motion, frameIndex);
+        synchronizeAllRigidBodiesTransformFeedbackToSimulation();
+    }
+}
+
+void
+Model::resolveAllMotionTracks(const Motion *motion)
+{
+    nanoem_rsize_t numObjects;
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(m_opaque, &numObjects);
+    for (nanoem_rsize_t i = 0; i < numObjects; i++) {
+        const nanoem_model_bone_t *bonePtr = bones[i];
+        if (model::Bone *bone = model::Bone::cast(bonePtr)) {
+            bone->motionTrack(motion, bonePtr);
         }
-        else {
-            visible = isVisible();
+    }
+    nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(m_opaque, &numObjects);
+    for (nanoem_rsize_t i = 0; i < numObjects; i++) {
+        const nanoem_model_morph_t *morphPtr = morphs[i];
+        if (model::Morph *morph = model::Morph::cast(morphPtr)) {
+            morph->motionTrack(motion, nanoemModelMorphGetName(morphPtr, NANOEM_LANGUAGE_TYPE_FIRST_ENUM));
         }
     }
-    if (motion && visible) {
-        if (timing == PhysicsEngine::kSimulationTimingBefore) {
-            m_boundingBox.reset();
-            resetAllMaterials();
-            resetAllBoneLocalTransform();
-            synchronizeMorphMotion(motion, frameIndex, amount);
-            synchronizeBoneMotion(motion, frameIndex, amount, timing);
-            solveAllConstraints();
-            synchronizeAllRigidBodyKinematics(motion, frameIndex);
-            synchronizeAllRigidBodiesTransformFeedbackToSimulation();
+}
+
+void
+Model::resolveAllConstraintJoints()
+{
+    /* resolving joints converts names with the shared unicode factory so it must not be done in solving constraints
+       that may run concurrently with the other models */
+    nanoem_rsize_t numConstraints;
+    nanoem_unicode_string_factory_t *factory = m_project->unicodeStringFactory();
+    const bool editing = m_project->isModelEditingEnabled();
+    nanoem_model_constraint_t *const *constraints = nanoemModelGetAllConstraintObjects(m_opaque, &numConstraints);
+    for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+        const nanoem_model_constraint_t *constraintPtr = constraints[i];
+        if (model::Constraint *constraint = model::Constraint::cast(constraintPtr)) {
+            /* joints may be edited at any time in editing mode so these are resolved again each time */
+            if (editing) {
+                constraint->invalidateAllJoints();
+            }
+            constraint->resolveAllJoints(constraintPtr, factory);
         }
-        else if (timing == PhysicsEngine::kSimulationTimingAfter) {
-            synchronizeBoneMotion(motion, frameIndex, amount, timing);
+    }
+}
+
+void
+Model::resolveAllBezierCurves(const Motion *motion, nanoem_frame_index_t frameIndex)
+{
+    /* resolves curves of both frames bones may interpolate so synchronizing bones never inserts the shared cache */
+    nanoem_rsize_t numBones;
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(m_opaque, &numBones);
+    for (nanoem_rsize_t i = 0; i < numBones; i++) {
+        const nanoem_model_bone_t *bonePtr = bones[i];
+        if (model::Bone *bone = model::Bone::cast(bonePtr)) {
+            const nanoem_motion_track_t *track = bone->motionTrack(motion, bonePtr);
+            for (nanoem_frame_index_t offset = 0; track && offset < 2; offset++) {
+                nanoem_motion_bone_keyframe_t *prevKeyframe, *nextKeyframe;
+                nanoemMotionTrackSearchClosestBoneKeyframes(track, frameIndex + offset, &prevKeyframe, &nextKeyframe);
+                if (!prevKeyframe || !nextKeyframe) {
+                    continue;
+                }
+                const nanoem_frame_index_t interval =
+                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(nextKeyframe)) -
+                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(prevKeyframe));
+                for (int j = NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_FIRST_ENUM;
+                     j < NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_MAX_ENUM; j++) {
+                    const nanoem_motion_bone_keyframe_interpolation_type_t type =
+                        nanoem_motion_bone_keyframe_interpolation_type_t(j);
+                    if (!nanoemMotionBoneKeyframeIsLinearInterpolation(nextKeyframe, type)) {
+                        m_project->resolveBezierCurve(
+                            nanoemMotionBoneKeyframeGetInterpolation(nextKeyframe, type), interval);
+                    }
+                }
+            }
         }
     }
 }
@@ -1722,6 +2062,15 @@ Model::synchronizeAllRigidBodiesTransformFeedbackFromSimulation(PhysicsEngine::R
         const nanoem_model_rigid_body_t *rigidBodyPtr = rigidBodies[i];
         if (model::RigidBody *rigidBody = model::RigidBody::cast(rigidBodyPtr)) {
             rigidBody->synchronizeTransformFeedbackFromSimulation(rigidBodyPtr, followType);
+            model::Bone *bone = model::Bone::cast(nanoemModelRigidBodyGetBoneObject(rigidBodyPtr));
+            if (bone && bone->isTransformDirty()) {
+                /*
+                 * the feedback writes the matrices of the bone directly so the sequence is advanced to evaluate its
+                 * dependents again. the bone itself stays dirty to be evaluated from the written local transform
+                 */
+                bone->setTransformSequence(++m_boneTransformSequence);
+                bone->setTransformDirty(true);
+            }
         }
     }
 }
@@ -1764,6 +2113,8 @@ Model::rebuildAllVertexBuffers(bool enableSkinFactory)
             }
         }
     }
+    /* vertices and offsets may be edited so the packed deltas pointing to them are resolved again */
+    invalidateAllMorphVertexDeltas();
     if (enableSkinFactory) {
         initializeAllStagingVertexBuffers();
     }
@@ -1794,6 +2145,7 @@ Model::clearAllDrawVertexBuffers()
 void
 Model::performAllBonesTransform()
 {
+    resolveAllConstraintJoints();
     applyAllBonesTransform(PhysicsEngine::kSimulationTimingBefore);
     solveAllConstraints();
     PhysicsEngine *engine = m_project->physicsEngine();
@@ -1921,26 +2273,71 @@ Model::markStagingVertexBufferDirty()
 void
 Model::updateStagingVertexBuffer()
 {
+    if (beginStagingVertexBufferUpdate()) {
+        performStagingVertexBufferUpdate();
+    }
+    endStagingVertexBufferUpdate();
+}
+
+bool
+Model::beginStagingVertexBufferUpdate()
+{
+    m_stagingVertexBufferPtr = nullptr;
     if (EnumUtils::isEnabled(kPrivateStateDirtyStagingBuffer, m_states)) {
         sg_buffer stagingVertexBuffer = m_vertexBuffers[m_stageVertexBufferIndex];
         if (sg::is_valid(stagingVertexBuffer)) {
-            SG_PUSH_GROUPF("Model::updateStagingVertexBuffer(name=%s)", canonicalNameConstString());
+            SG_PUSH_GROUPF("Model::beginStagingVertexBufferUpdate(name=%s)", canonicalNameConstString());
             if (m_skinDeformer) {
                 m_skinDeformer->execute(m_stageVertexBufferIndex);
             }
             else if (nanoem_u8_t *ptr = static_cast<nanoem_u8_t *>(sg::map_buffer(stagingVertexBuffer))) {
-                internalUpdateStagingVertexBuffer(ptr, m_vertexBufferData.size() / sizeof(VertexUnit));
-                sg::unmap_buffer(stagingVertexBuffer, ptr);
+                m_stagingVertexBufferPtr = ptr;
+                EnumUtils::setEnabled(kPrivateStateMappedStagingBuffer, m_states, true);
             }
             else if (!m_vertexBufferData.empty()) {
+                m_stagingVertexBufferPtr = m_vertexBufferData.data();
+            }
+            if (m_stagingVertexBufferPtr) {
+                synchronizeAllSoftBodiesTransformFeedbackFromSimulation(
+                    m_stagingVertexBufferPtr, m_vertexBufferData.size() / sizeof(VertexUnit));
+            }
+            SG_POP_GROUP();
+        }
+    }
+    return m_stagingVertexBufferPtr != nullptr;
+}
+
+void
+Model::performStagingVertexBufferUpdate()
+{
+    /* touches nothing but this model so this may be called for each model concurrently */
+    if (m_stagingVertexBufferPtr) {
+        performAllSkinningBatches(m_stagingVertexBufferPtr, m_vertexBufferData.size() / sizeof(VertexUnit));
+    }
+}
+
+void
+Model::endStagingVertexBufferUpdate()
+{
+    if (EnumUtils::isEnabled(kPrivateStateDirtyStagingBuffer, m_states)) {
+        sg_buffer stagingVertexBuffer = m_vertexBuffers[m_stageVertexBufferIndex];
+        if (sg::is_valid(stagingVertexBuffer)) {
+            if (nanoem_u8_t *ptr = m_stagingVertexBufferPtr) {
                 const size_t size = m_vertexBufferData.size();
-                internalUpdateStagingVertexBuffer(m_vertexBufferData.data(), size / sizeof(VertexUnit));
-                sg::update_buffer(stagingVertexBuffer, m_vertexBufferData.data(), Inline::saturateInt32(size));
+                synchronizeAllSoftBodiesTransformFeedbackToSimulation(ptr, size / sizeof(VertexUnit));
+                if (EnumUtils::isEnabled(kPrivateStateMappedStagingBuffer, m_states)) {
+                    sg::unmap_buffer(stagingVertexBuffer, ptr);
+                }
+                else {
+                    sg::update_buffer(stagingVertexBuffer, ptr, Inline::saturateInt32(size));
+                }
             }
             m_stageVertexBufferIndex = 1 - m_stageVertexBufferIndex;
-            SG_POP_GROUP();
         }
-        EnumUtils::setEnabled(kPrivateStateDirtyStagingBuffer | kPrivateStateDirtyMorph, m_states, false);
+        EnumUtils::setEnabled(
+            kPrivateStateDirtyStagingBuffer | kPrivateStateDirtyMorph | kPrivateStateMappedStagingBuffer, m_states,
+            false);
+        m_stagingVertexBufferPtr = nullptr;
     }
 }
 
@@ -2247,7 +2644,10 @@ Model::pushUndo(undo_command_t *command)
         else {
             stackPtr = editingUndoStack();
         }
+        const nanoem_u32_t generation = m_editGeneration;
         undoStackPushCommand(stackPtr, command);
+        markAllObjectsEditedIfUntracked(stackPtr, generation);
+        m_project->trimUndoStack(stackPtr);
         m_project->eventPublisher()->publishPushUndoCommandEvent(command);
     }
     else {
@@ -2255,6 +2655,81 @@ Model::pushUndo(undo_command_t *command)
     }
 }
 
+nanoem_u32_t
+Model::editGeneration() const NANOEM_DECL_NOEXCEPT
+{
+    return m_editGeneration;
+}
+
+nanoem_u32_t
+Model::lastEditGeneration(EditObjectType type) const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_u32_t generation = m_allObjectsEditGeneration;
+    if (type >= kEditObjectTypeFirstEnum && type < kEditObjectTypeMaxEnum) {
+        generation = glm::max(m_objectEditGenerations[type], generation);
+    }
+    return generation;
+}
+
+nanoem_u32_t
+Model::allObjectsEditGeneration() const NANOEM_DECL_NOEXCEPT
+{
+    return m_allObjectsEditGeneration;
+}
+
+void
+Model::getAllEditedVertexObjects(nanoem_u32_t generation, model::Vertex::List &vertices) const
+{
+    for (VertexEditGenerationMap::const_iterator it = m_vertexEditGenerations.begin(),
+                                                 end = m_vertexEditGenerations.end();
+         it != end; ++it) {
+        if (it->second > generation) {
+            vertices.push_back(it->first);
+        }
+    }
+}
+
+void
+Model::markObjectEdited(EditObjectType type, const void *object)
+{
+    m_editGeneration++;
+    if (type >= kEditObjectTypeFirstEnum && type < kEditObjectTypeMaxEnum) {
+        m_objectEditGenerations[type] = m_editGeneration;
+        if (type == kEditObjectTypeVertex && object) {
+            m_vertexEditGenerations[static_cast<const nanoem_model_vertex_t *>(object)] = m_editGeneration;
+        }
+    }
+}
+
+void
+Model::markAllObjectsEdited()
+{
+    m_allObjectsEditGeneration = ++m_editGeneration;
+    /* edited objects may have been destroyed so these are no longer tracked individually */
+    m_vertexEditGenerations.clear();
+}
+
+void
+Model::markAllObjectsEditedIfUntracked(const undo_stack_t *stack, nanoem_u32_t generation)
+{
+    /* only the editing undo stack changes the model and most of its commands do not tell which objects are edited */
+    if (stack == m_editingUndoStack && generation == m_editGeneration) {
+        markAllObjectsEdited();
+    }
+}
+
+void
+Model::setAllConstraintIterationResultsCaptured(bool value)
+{
+    nanoem_rsize_t numConstraints;
+    nanoem_model_constraint_t *const *constraints = nanoemModelGetAllConstraintObjects(m_opaque, &numConstraints);
+    for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+        if (model::Constraint *constraint = model::Constraint::cast(constraints[i])) {
+            constraint->setIterationResultCaptured(value);
+        }
+    }
+}
+
 void
 Model::solveAllConstraints()
 {
@@ -2833,25 +3308,80 @@ Model::compareBoneVertexList(const void *a, const void *b)
 }
 
 void
-Model::handlePerformSkinningVertexTransform(void *opaque, size_t index)
+Model::handlePerformSkinningBatchTransform(void *opaque, size_t index)
 {
     const ParallelSkinningTaskData *s = static_cast<const ParallelSkinningTaskData *>(opaque);
-    model::Vertex *vertex = model::Vertex::cast(s->m_vertices[index]);
-    VertexUnit &p = reinterpret_cast<VertexUnit *>(s->m_output)[index];
-    switch (s->m_drawType) {
-    case IDrawable::kDrawTypeColor:
-    case IDrawable::kDrawTypeEdge:
-    case IDrawable::kDrawTypeGroundShadow:
-    case IDrawable::kDrawTypeShadowMap:
-    case IDrawable::kDrawTypeScriptExternalColor:
-        p.performSkinning(s->m_edgeSizeScaleFactor, vertex);
-        vertex->reset();
-        break;
-    default:
-        break;
+    SkinningBatch &batch = s->m_batches[index];
+    const SkinningBoneUnit *bones = reinterpret_cast<const SkinningBoneUnit *>(s->m_bones);
+    const nanoem_u32_t *vertexIndices = s->m_vertexIndices + batch.m_offset,
+                       *boneIndices = s->m_boneIndices + batch.m_offset * 4;
+    VertexUnit *units = reinterpret_cast<VertexUnit *>(s->m_output);
+    nanoem_rsize_t offset = 0;
+    if (PrivateSkinningUtils::hasLaneKernel(batch.m_type)) {
+        for (; offset + 4 <= batch.m_size; offset += 4) {
+            model::Vertex *vertices[4];
+            bx::simd128_t *positions[4], *normals[4];
+            bool lane = true;
+            for (nanoem_rsize_t i = 0; lane && i < 4; i++) {
+                const nanoem_u32_t vertexIndex = vertexIndices[offset + i];
+                if (vertexIndex < s->m_numVertices) {
+                    const nanoem_model_vertex_t *vertexPtr = s->m_vertices[vertexIndex];
+                    vertices[i] = model::Vertex::cast(vertexPtr);
+                    positions[i] = &units[vertexIndex].m_position;
+                    normals[i] = &units[vertexIndex].m_normal;
+                    lane = !vertices[i]->hasSoftBody() && nanoemModelVertexGetType(vertexPtr) == batch.m_type;
+                }
+                else {
+                    lane = false;
+                }
+            }
+            if (lane) {
+                PrivateSkinningUtils::performLanes(
+                    batch.m_type, bones, boneIndices + offset * 4, vertices, positions, normals);
+                for (nanoem_rsize_t i = 0; i < 4; i++) {
+                    units[vertexIndices[offset + i]].updateAttributes(s->m_edgeSizeScaleFactor, vertices[i]);
+                    vertices[i]->reset();
+                }
+            }
+            else {
+                for (nanoem_rsize_t i = 0; i < 4; i++) {
+                    performSkinningBatchVertex(s, batch, offset + i);
+                }
+            }
+        }
+    }
+    for (; offset < batch.m_size; offset++) {
+        performSkinningBatchVertex(s, batch, offset);
     }
 }
 
+void
+Model::performSkinningBatchVertex(
+    const ParallelSkinningTaskData *s, SkinningBatch &batch, nanoem_rsize_t offset) NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_u32_t vertexIndex = s->m_vertexIndices[batch.m_offset + offset];
+    if (vertexIndex >= s->m_numVertices) {
+        return;
+    }
+    const SkinningBoneUnit *bones = reinterpret_cast<const SkinningBoneUnit *>(s->m_bones);
+    const nanoem_model_vertex_t *vertexPtr = s->m_vertices[vertexIndex];
+    model::Vertex *vertex = model::Vertex::cast(vertexPtr);
+    VertexUnit &p = reinterpret_cast<VertexUnit *>(s->m_output)[vertexIndex];
+    if (!vertex->hasSoftBody()) {
+        if (nanoemModelVertexGetType(vertexPtr) == batch.m_type) {
+            PrivateSkinningUtils::performByType(batch.m_type, bones, s->m_boneIndices + (batch.m_offset + offset) * 4,
+                vertex, &p.m_position, &p.m_normal);
+        }
+        else {
+            /* the vertex type is changed after bucketing so skin it in the slow path and rebuild next time */
+            VertexUnit::performSkinningByType(vertex, &p.m_position, &p.m_normal);
+            batch.m_stale = true;
+        }
+    }
+    p.updateAttributes(s->m_edgeSizeScaleFactor, vertex);
+    vertex->reset();
+}
+
 void
 Model::setCommonPipelineDescription(sg_pipeline_desc &desc)
 {
@@ -3157,14 +3687,50 @@ Model::applyAllBonesTransform(PhysicsEngine::SimulationTimingType timing)
         const nanoem_model_bone_t *bonePtr = bones[i];
         if ((nanoemModelBoneIsAffectedByPhysicsSimulation(bonePtr) != 0) == timing) {
             if (model::Bone *bone = model::Bone::cast(bonePtr)) {
-                bone->applyAllLocalTransform(bonePtr, this);
-                bone->applyOutsideParentTransform(bonePtr, this);
-                m_boundingBox.set(bone->worldTransformOrigin());
+                applyBoneTransform(bonePtr, bone);
             }
         }
     }
 }
 
+void
+Model::applyBoneTransform(const nanoem_model_bone_t *bonePtr, model::Bone *bone)
+{
+    bone->resolveMorphTransform();
+    if (isBoneTransformDirty(bonePtr, bone)) {
+        bone->applyAllLocalTransform(bonePtr, this);
+        bone->applyOutsideParentTransform(bonePtr, this);
+        bone->setTransformSequence(++m_boneTransformSequence);
+    }
+    m_boundingBox.set(bone->worldTransformOrigin());
+}
+
+bool
+Model::isBoneTransformDirty(const nanoem_model_bone_t *bonePtr, const model::Bone *bone) const NANOEM_DECL_NOEXCEPT
+{
+    /*
+     * constraints and outside parents depend on bones out of the hierarchy and the bone origins are editable in
+     * model editing mode so these are always evaluated. the rest is evaluated only if any of its inputs is changed
+     * or any of its parent, inherent parent and its effector is evaluated after the last evaluation of the bone
+     */
+    bool dirty = bone->isTransformDirty() || m_project->isModelEditingEnabled() || hasOutsideParent(bonePtr) ||
+        nanoemModelBoneHasConstraint(bonePtr) || isConstraintJointBone(bonePtr) || isConstraintEffectorBone(bonePtr);
+    if (!dirty) {
+        const nanoem_u64_t sequence = bone->transformSequence();
+        const model::Bone *parentBone = model::Bone::cast(nanoemModelBoneGetParentBoneObject(bonePtr));
+        dirty = parentBone && parentBone->transformSequence() > sequence;
+        if (!dirty &&
+            (nanoemModelBoneHasInherentOrientation(bonePtr) || nanoemModelBoneHasInherentTranslation(bonePtr))) {
+            const model::Bone *inherentParentBone =
+                model::Bone::cast(nanoemModelBoneGetInherentParentBoneObject(bonePtr));
+            const model::Bone *effectorBone = model::Bone::cast(nanoemModelBoneGetEffectorBoneObject(bonePtr));
+            dirty = (inherentParentBone && inherentParentBone->transformSequence() > sequence) ||
+                (effectorBone && effectorBone->transformSequence() > sequence);
+        }
+    }
+    return dirty;
+}
+
 void
 Model::internalClear()
 {
@@ -3231,6 +3797,10 @@ Model::internalSetOutsideParent(const nanoem_model_bone_t *key, const StringPair
     if (!activeOutsideParentSubjectBone()) {
         setActiveOutsideParentSubjectBone(key);
     }
+    if (const Model *parent = m_project->findModelByName(value.first)) {
+        /* rigid bodies following another model may collide with it so both must be in the same physics island */
+        m_project->physicsEngine()->mergeIslands(m_opaque, parent->data());
+    }
 }
 
 void
@@ -3336,10 +3906,10 @@ Model::initializeStagingIndexBuffer()
 void
 Model::initializeVertexBufferByteArray()
 {
-    ParallelSkinningTaskData s(this, m_project->drawType(), edgeSize());
-    m_vertexBufferData.resize(sizeof(Model::VertexUnit) * glm::max(s.m_numVertices, nanoem_rsize_t(1)));
-    s.m_output = m_vertexBufferData.data();
-    dispatchParallelTasks(&Model::handlePerformSkinningVertexTransform, &s, s.m_numVertices);
+    nanoem_rsize_t numVertices;
+    nanoemModelGetAllVertexObjects(m_opaque, &numVertices);
+    m_vertexBufferData.resize(sizeof(Model::VertexUnit) * glm::max(numVertices, nanoem_rsize_t(1)));
+    performAllSkinningBatches(m_vertexBufferData.data(), numVertices);
 }
 
 void
@@ -3368,32 +3938,162 @@ Model::createAllStagingVertexBuffers()
 }
 
 void
-Model::internalUpdateStagingVertexBuffer(nanoem_u8_t *ptr, nanoem_rsize_t numVertices)
+Model::synchronizeAllSoftBodiesTransformFeedbackFromSimulation(nanoem_u8_t *ptr, nanoem_rsize_t numVertices)
 {
     nanoem_rsize_t numSoftBodies;
     nanoem_model_soft_body_t *const *softBodies = nanoemModelGetAllSoftBodyObjects(m_opaque, &numSoftBodies);
-    if (softBodies && numSoftBodies > 0) {
-        VertexUnit *vertexUnits = reinterpret_cast<VertexUnit *>(ptr);
-        for (nanoem_rsize_t i = 0; i < numSoftBodies; i++) {
-            const nanoem_model_soft_body_t *softBodyPtr = softBodies[i];
-            if (model::SoftBody *softBody = model::SoftBody::cast(softBodyPtr)) {
-                softBody->synchronizeTransformFeedbackFromSimulation(vertexUnits, numVertices);
-            }
+    VertexUnit *vertexUnits = reinterpret_cast<VertexUnit *>(ptr);
+    for (nanoem_rsize_t i = 0; i < numSoftBodies; i++) {
+        const nanoem_model_soft_body_t *softBodyPtr = softBodies[i];
+        if (model::SoftBody *softBody = model::SoftBody::cast(softBodyPtr)) {
+            softBody->synchronizeTransformFeedbackFromSimulation(vertexUnits, numVertices);
         }
-        ParallelSkinningTaskData s(this, m_project->drawType(), edgeSize());
-        s.m_output = ptr;
-        dispatchParallelTasks(&Model::handlePerformSkinningVertexTransform, &s, numVertices);
-        for (nanoem_rsize_t i = 0; i < numSoftBodies; i++) {
-            const nanoem_model_soft_body_t *softBodyPtr = softBodies[i];
-            if (model::SoftBody *softBody = model::SoftBody::cast(softBodyPtr)) {
-                softBody->synchronizeTransformFeedbackToSimulation(softBodyPtr, vertexUnits, numVertices);
-            }
+    }
+}
+
+void
+Model::synchronizeAllSoftBodiesTransformFeedbackToSimulation(nanoem_u8_t *ptr, nanoem_rsize_t numVertices)
+{
+    nanoem_rsize_t numSoftBodies;
+    nanoem_model_soft_body_t *const *softBodies = nanoemModelGetAllSoftBodyObjects(m_opaque, &numSoftBodies);
+    VertexUnit *vertexUnits = reinterpret_cast<VertexUnit *>(ptr);
+    for (nanoem_rsize_t i = 0; i < numSoftBodies; i++) {
+        const nanoem_model_soft_body_t *softBodyPtr = softBodies[i];
+        if (model::SoftBody *softBody = model::SoftBody::cast(softBodyPtr)) {
+            softBody->synchronizeTransformFeedbackToSimulation(softBodyPtr, vertexUnits, numVertices);
         }
     }
-    else {
-        ParallelSkinningTaskData s(this, m_project->drawType(), edgeSize());
-        s.m_output = ptr;
-        dispatchParallelTasks(&Model::handlePerformSkinningVertexTransform, &s, numVertices);
+}
+
+void
+Model::rebuildAllSkinningBatches(nanoem_model_vertex_t *const *vertices, nanoem_rsize_t numVertices)
+{
+    typedef tinystl::unordered_map<const model::Bone *, nanoem_u32_t, TinySTLAllocator> BonePaletteIndexMap;
+    static const nanoem_rsize_t kMaxBatchSize = 1024;
+    static const nanoem_rsize_t kNumBuckets = NANOEM_MODEL_VERTEX_TYPE_MAX_ENUM + 1;
+    nanoem_rsize_t numBones;
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(m_opaque, &numBones);
+    BonePaletteIndexMap paletteIndices;
+    for (nanoem_rsize_t i = 0; i < numBones; i++) {
+        if (const model::Bone *bone = model::Bone::cast(bones[i])) {
+            paletteIndices.insert(tinystl::make_pair(bone, nanoem_u32_t(i)));
+        }
+    }
+    nanoem_rsize_t offsets[kNumBuckets + 1] = {};
+    for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+        offsets[PrivateSkinningUtils::bucketIndex(vertices[i]) + 1]++;
+    }
+    m_skinningBatches.clear();
+    for (nanoem_rsize_t i = 0; i < kNumBuckets; i++) {
+        const nanoem_rsize_t offset = offsets[i], size = offsets[i + 1];
+        for (nanoem_rsize_t j = 0; j < size; j += kMaxBatchSize) {
+            SkinningBatch batch;
+            batch.m_type = i < NANOEM_MODEL_VERTEX_TYPE_MAX_ENUM ? static_cast<nanoem_model_vertex_type_t>(i)
+                                                                : NANOEM_MODEL_VERTEX_TYPE_UNKNOWN;
+            batch.m_offset = offset + j;
+            batch.m_size = glm::min(size - j, kMaxBatchSize);
+            batch.m_stale = false;
+            m_skinningBatches.push_back(batch);
+        }
+        offsets[i + 1] += offset;
+    }
+    m_skinningVertexIndices.resize(numVertices);
+    m_skinningBoneIndices.resize(numVertices * 4);
+    const nanoem_u32_t fallbackIndex = Inline::saturateInt32U(numBones);
+    for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+        const nanoem_model_vertex_t *vertexPtr = vertices[i];
+        const nanoem_rsize_t offset = offsets[PrivateSkinningUtils::bucketIndex(vertexPtr)]++;
+        const model::Vertex *vertex = model::Vertex::cast(vertexPtr);
+        m_skinningVertexIndices[offset] = Inline::saturateInt32U(i);
+        for (nanoem_rsize_t j = 0; j < 4; j++) {
+            BonePaletteIndexMap::const_iterator it = paletteIndices.find(vertex->bone(j));
+            m_skinningBoneIndices[offset * 4 + j] = it != paletteIndices.end() ? it->second : fallbackIndex;
+        }
+    }
+}
+
+bool
+Model::containsSkinningBatch(nanoem_model_vertex_type_t type) const NANOEM_DECL_NOEXCEPT
+{
+    bool found = false;
+    for (SkinningBatchList::const_iterator it = m_skinningBatches.begin(), end = m_skinningBatches.end();
+         !found && it != end; ++it) {
+        found = it->m_type == type;
+    }
+    return found;
+}
+
+void
+Model::updateAllSkinningBones()
+{
+    nanoem_rsize_t numBones;
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(m_opaque, &numBones);
+#if GLM_VERSION >= 960
+    const bool hasQdef = containsSkinningBatch(NANOEM_MODEL_VERTEX_TYPE_QDEF);
+#endif /* GLM_VERSION >= 960 */
+#if defined(NANOEM_ENABLE_SDEF)
+    const bool hasSdef = containsSkinningBatch(NANOEM_MODEL_VERTEX_TYPE_SDEF);
+#endif /* NANOEM_ENABLE_SDEF */
+    /* the last unit is reserved for the shared fallback bone */
+    m_skinningBones.resize(sizeof(SkinningBoneUnit) * (numBones + 1));
+    SkinningBoneUnit *units = reinterpret_cast<SkinningBoneUnit *>(m_skinningBones.data());
+    for (nanoem_rsize_t i = 0; i <= numBones; i++) {
+        const model::Bone *bone = i < numBones ? model::Bone::cast(bones[i]) : nullptr;
+        if (!bone) {
+            bone = sharedFallbackBone();
+        }
+        SkinningBoneUnit &unit = units[i];
+        unit.m_skinningTransform = bone->skinningTransformMatrix();
+        unit.m_normalTransform = bone->normalTransformMatrix();
+#if GLM_VERSION >= 960
+        if (hasQdef) {
+            const Quaternion orientation(bone->localOrientation());
+            const Matrix4x4 pdq(glm::mat3x4_cast(glm::dualquat(orientation, bone->localTranslation())));
+            const Matrix4x4 ndq(glm::mat3x4_cast(glm::dualquat(orientation, Constants::kZeroV3)));
+            unit.m_positionDualQuaternion = *reinterpret_cast<const bx::float4x4_t *>(glm::value_ptr(pdq));
+            unit.m_normalDualQuaternion = *reinterpret_cast<const bx::float4x4_t *>(glm::value_ptr(ndq));
+        }
+#endif /* GLM_VERSION >= 960 */
+#if defined(NANOEM_ENABLE_SDEF)
+        if (hasSdef) {
+            unit.m_orientation = glm::quat_cast(bone->skinningTransform());
+        }
+#endif /* NANOEM_ENABLE_SDEF */
+    }
+}
+
+void
+Model::performAllSkinningBatches(nanoem_u8_t *ptr, nanoem_rsize_t numVertices)
+{
+    ParallelSkinningTaskData s(this, m_project->drawType(), edgeSize());
+    switch (s.m_drawType) {
+    case IDrawable::kDrawTypeColor:
+    case IDrawable::kDrawTypeEdge:
+    case IDrawable::kDrawTypeGroundShadow:
+    case IDrawable::kDrawTypeShadowMap:
+    case IDrawable::kDrawTypeScriptExternalColor:
+        break;
+    default:
+        return;
+    }
+    if (EnumUtils::isEnabled(kPrivateStateDirtySkinningBatch, m_states) ||
+        m_skinningVertexIndices.size() != s.m_numVertices) {
+        rebuildAllSkinningBatches(s.m_vertices, s.m_numVertices);
+        EnumUtils::setEnabled(kPrivateStateDirtySkinningBatch, m_states, false);
+    }
+    updateAllSkinningBones();
+    s.m_output = ptr;
+    s.m_numVertices = glm::min(s.m_numVertices, numVertices);
+    s.m_batches = m_skinningBatches.data();
+    s.m_bones = m_skinningBones.data();
+    s.m_vertexIndices = m_skinningVertexIndices.data();
+    s.m_boneIndices = m_skinningBoneIndices.data();
+    dispatchParallelTasks(&Model::handlePerformSkinningBatchTransform, &s, m_skinningBatches.size());
+    for (SkinningBatchList::iterator it = m_skinningBatches.begin(), end = m_skinningBatches.end(); it != end; ++it) {
+        if (it->m_stale) {
+            EnumUtils::setEnabled(kPrivateStateDirtySkinningBatch, m_states, true);
+            it->m_stale = false;
+        }
     }
 }
 
@@ -3528,7 +4228,7 @@ void
 Model::deformMorph(const nanoem_model_morph_t *morphPtr, bool checkDirty)
 {
     nanoem_parameter_assert(morphPtr, "must not be nullptr");
-    const model::Morph *morph = model::Morph::cast(morphPtr);
+    model::Morph *morph = model::Morph::cast(morphPtr);
     if (morph && (!checkDirty || (checkDirty && morph->isDirty()))) {
         const nanoem_f32_t weight = morph->weight();
         const nanoem_model_morph_type_t type = nanoemModelMorphGetType(morphPtr);
@@ -3617,15 +4317,22 @@ Model::deformMorph(const nanoem_model_morph_t *morphPtr, bool checkDirty)
             break;
         }
         case NANOEM_MODEL_MORPH_TYPE_VERTEX: {
-            nanoem_rsize_t numChildren;
-            const nanoem_model_morph_vertex_t *const *children =
-                nanoemModelMorphGetAllVertexMorphObjects(morphPtr, &numChildren);
-            for (nanoem_rsize_t i = 0; i < numChildren; i++) {
-                const nanoem_model_morph_vertex_t *child = children[i];
-                const nanoem_model_vertex_t *vertexPtr = nanoemModelMorphVertexGetVertexObject(child);
-                if (model::Vertex *vertex = model::Vertex::cast(vertexPtr)) {
-                    vertex->deform(child, weight);
+            if (m_project->isModelEditingEnabled()) {
+                /* offsets and vertices are editable so the packed deltas are resolved again after editing */
+                nanoem_rsize_t numChildren;
+                const nanoem_model_morph_vertex_t *const *children =
+                    nanoemModelMorphGetAllVertexMorphObjects(morphPtr, &numChildren);
+                for (nanoem_rsize_t i = 0; i < numChildren; i++) {
+                    const nanoem_model_morph_vertex_t *child = children[i];
+                    const nanoem_model_vertex_t *vertexPtr = nanoemModelMorphVertexGetVertexObject(child);
+                    if (model::Vertex *vertex = model::Vertex::cast(vertexPtr)) {
+                        vertex->deform(child, weight);
+                    }
                 }
+                morph->invalidateAllVertexDeltas();
+            }
+            else if (glm::abs(weight) > 0.0f) {
+                morph->deformAllVertices(morphPtr, weight);
             }
             break;
         }
@@ -3634,17 +4341,23 @@ Model::deformMorph(const nanoem_model_morph_t *morphPtr, bool checkDirty)
         case NANOEM_MODEL_MORPH_TYPE_UVA2:
         case NANOEM_MODEL_MORPH_TYPE_UVA3:
         case NANOEM_MODEL_MORPH_TYPE_UVA4: {
-            nanoem_rsize_t numChildren;
-            int index =
-                static_cast<int>(nanoemModelMorphGetType(morphPtr)) - static_cast<int>(NANOEM_MODEL_MORPH_TYPE_TEXTURE);
-            const nanoem_model_morph_uv_t *const *children =
-                nanoemModelMorphGetAllUVMorphObjects(morphPtr, &numChildren);
-            for (nanoem_rsize_t i = 0; i < numChildren; i++) {
-                const nanoem_model_morph_uv_t *child = children[i];
-                const nanoem_model_vertex_t *vertexPtr = nanoemModelMorphUVGetVertexObject(child);
-                if (model::Vertex *vertex = model::Vertex::cast(vertexPtr)) {
-                    vertex->deform(child, index, weight);
+            if (m_project->isModelEditingEnabled()) {
+                nanoem_rsize_t numChildren;
+                int index = static_cast<int>(nanoemModelMorphGetType(morphPtr)) -
+                    static_cast<int>(NANOEM_MODEL_MORPH_TYPE_TEXTURE);
+                const nanoem_model_morph_uv_t *const *children =
+                    nanoemModelMorphGetAllUVMorphObjects(morphPtr, &numChildren);
+                for (nanoem_rsize_t i = 0; i < numChildren; i++) {
+                    const nanoem_model_morph_uv_t *child = children[i];
+                    const nanoem_model_vertex_t *vertexPtr = nanoemModelMorphUVGetVertexObject(child);
+                    if (model::Vertex *vertex = model::Vertex::cast(vertexPtr)) {
+                        vertex->deform(child, index, weight);
+                    }
                 }
+                morph->invalidateAllVertexDeltas();
+            }
+            else if (glm::abs(weight) > 0.0f) {
+                morph->deformAllVertices(morphPtr, weight);
             }
             break;
         }
@@ -3660,27 +4373,30 @@ Model::solveConstraint(
 {
     nanoem_parameter_assert(constraintPtr, "must not be nullptr");
     nanoem_parameter_assert(factory, "must not be nullptr");
-    nanoem_rsize_t numJoints;
-    nanoem_model_constraint_joint_t *const *joints = nanoemModelConstraintGetAllJointObjects(constraintPtr, &numJoints);
     const nanoem_model_bone_t *targetBonePtr = nanoemModelConstraintGetTargetBoneObject(constraintPtr);
     const nanoem_model_bone_t *effectorBonePtr = nanoemModelConstraintGetEffectorBoneObject(constraintPtr);
     nanoem_f32_t angleLimit = nanoemModelConstraintGetAngleLimit(constraintPtr);
     const model::Bone *targetBone = model::Bone::cast(targetBonePtr);
     model::Bone *effectorBone = model::Bone::cast(effectorBonePtr);
     model::Constraint *constraint = model::Constraint::cast(constraintPtr);
+    const model::Constraint::ResolvedJointList &joints = constraint->resolveAllJoints(constraintPtr, factory);
+    const nanoem_rsize_t numJoints = joints.size();
+    const bool captured = constraint->isIterationResultCaptured();
     const Vector4 effectorBonePosition(effectorBone->worldTransformOrigin(), 1),
         targetBonePosition(targetBone->worldTransformOrigin(), 1);
+    model::Constraint::Joint scratch;
+    int numSolvedIterations = numIterations;
     for (int i = 0; i < numIterations; i++) {
         const bool firstIteration = i == 0;
         for (nanoem_rsize_t j = 0; j < numJoints; j++) {
-            const nanoem_model_constraint_joint_t *joint = joints[j];
-            const nanoem_model_bone_t *jointBonePtr = nanoemModelConstraintJointGetBoneObject(joint);
-            model::Bone *jointBone = model::Bone::cast(jointBonePtr);
-            model::Constraint::Joint *jointResult = constraint->jointIterationResult(joint, i);
+            const model::Constraint::ResolvedJoint &joint = joints[j];
+            model::Bone *jointBone = joint.m_bone;
+            model::Constraint::Joint *jointResult =
+                captured ? constraint->jointIterationResult(joint.m_opaque, i) : &scratch;
             if (!model::Constraint::solveAxisAngle(
                     jointBone->worldTransform(), effectorBonePosition, targetBonePosition, jointResult)) {
                 nanoem_f32_t newAngleLimit = angleLimit * (j + 1);
-                const bool hasUnitXConstraint = model::Constraint::hasUnitXConstraint(jointBonePtr, factory);
+                const bool hasUnitXConstraint = joint.m_hasUnitXConstraint;
                 if (firstIteration && hasUnitXConstraint) {
                     jointResult->setAxis(Constants::kUnitX);
                 }
@@ -3700,19 +4416,26 @@ Model::solveConstraint(
                 }
                 jointBone->setConstraintJointOrientation(mixedOrientation);
                 for (int k = Inline::saturateInt32(j); k >= 0; k--) {
-                    const nanoem_model_constraint_joint_t *upperJoint = joints[k];
-                    const nanoem_model_bone_t *upperJointBonePtr = nanoemModelConstraintJointGetBoneObject(upperJoint);
-                    model::Bone *upperJointBone = model::Bone::cast(upperJointBonePtr);
-                    upperJointBone->updateLocalTransform(upperJointBonePtr, upperJointBone->localTranslation(),
+                    const model::Constraint::ResolvedJoint &upperJoint = joints[k];
+                    model::Bone *upperJointBone = upperJoint.m_bone;
+                    upperJointBone->updateLocalTransform(upperJoint.m_bonePtr, upperJointBone->localTranslation(),
                         upperJointBone->constraintJointOrientation());
                 }
-                jointResult->setTransform(jointBone->worldTransform());
                 effectorBone->updateLocalTransform(effectorBonePtr);
-                model::Constraint::Joint *effectorResult = constraint->effectorIterationResult(joint, i);
-                effectorResult->setTransform(effectorBone->worldTransform());
+                if (captured) {
+                    jointResult->setTransform(jointBone->worldTransform());
+                    model::Constraint::Joint *effectorResult = constraint->effectorIterationResult(joint.m_opaque, i);
+                    effectorResult->setTransform(effectorBone->worldTransform());
+                }
             }
         }
+        /* the same test is applied while capturing so the result never depends on showing the iterations */
+        if (model::Constraint::isConverged(effectorBone->worldTransformOrigin(), targetBone->worldTransformOrigin())) {
+            numSolvedIterations = i + 1;
+            break;
+        }
     }
+    constraint->setNumSolvedIterations(numSolvedIterations);
 }
 
 void
@@ -3738,9 +4461,7 @@ Model::synchronizeBoneMotion(const Motion *motion, nanoem_frame_index_t frameInd
         const nanoem_model_bone_t *bonePtr = bones[i];
         if ((nanoemModelBoneIsAffectedByPhysicsSimulation(bonePtr) != 0) == timing) {
             if (model::Bone *bone = model::Bone::cast(bonePtr)) {
-                bone->applyAllLocalTransform(bonePtr, this);
-                bone->applyOutsideParentTransform(bonePtr, this);
-                m_boundingBox.set(bone->worldTransformOrigin());
+                applyBoneTransform(bonePtr, bone);
             }
         }
     }
@@ -3821,13 +4542,17 @@ Model::synchronizeAllRigidBodyKinematics(const Motion *motion, nanoem_frame_inde
 {
     nanoem_rsize_t numBodies;
     nanoem_model_rigid_body_t *const *bodies = nanoemModelGetAllRigidBodyObjects(m_opaque, &numBodies);
-    const nanoem_motion_t *opaque = motion->data();
     for (nanoem_rsize_t i = 0; i < numBodies; i++) {
         const nanoem_model_rigid_body_t *rigidBodyPtr = bodies[i];
-        if (const nanoem_model_bone_t *bonePtr = nanoemModelRigidBodyGetBoneObject(rigidBodyPtr)) {
-            const nanoem_unicode_string_t *name = nanoemModelBoneGetName(bonePtr, NANOEM_LANGUAGE_TYPE_FIRST_ENUM);
-            const nanoem_motion_bone_keyframe_t *prevKeyframe = motion->findBoneKeyframe(name, frameIndex),
-                                                *nextKeyframe = motion->findBoneKeyframe(name, frameIndex + 1);
+        const nanoem_model_bone_t *bonePtr = nanoemModelRigidBodyGetBoneObject(rigidBodyPtr);
+        model::Bone *bone = model::Bone::cast(bonePtr);
+        if (bonePtr && bone) {
+            const nanoem_motion_track_t *track = bone->motionTrack(motion, bonePtr);
+            nanoem_motion_keyframe_cursor_t *cursor = bone->motionKeyframeCursor(motion);
+            const nanoem_motion_bone_keyframe_t *prevKeyframe =
+                nanoemMotionTrackFindBoneKeyframeObjectWithCursor(track, cursor, frameIndex);
+            const nanoem_motion_bone_keyframe_t *nextKeyframe =
+                nanoemMotionTrackFindBoneKeyframeObjectWithCursor(track, cursor, frameIndex + 1);
             if (prevKeyframe && nextKeyframe) {
                 model::RigidBody *rigidBody = model::RigidBody::cast(rigidBodyPtr);
                 if (rigidBody && nanoemMotionBoneKeyframeIsPhysicsSimulationEnabled(prevKeyframe) &&
@@ -3838,7 +4563,8 @@ Model::synchronizeAllRigidBodyKinematics(const Motion *motion, nanoem_frame_inde
             else {
                 nanoem_motion_bone_keyframe_t *mutPrevKeyframe, *mutNextKeyframe;
                 model::RigidBody *rigidBody = model::RigidBody::cast(rigidBodyPtr);
-                nanoemMotionSearchClosestBoneKeyframes(opaque, name, frameIndex, &mutPrevKeyframe, &mutNextKeyframe);
+                nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(
+                    track, cursor, frameIndex, &mutPrevKeyframe, &mutNextKeyframe);
                 if (rigidBody && nanoemMotionBoneKeyframeIsPhysicsSimulationEnabled(mutPrevKeyframe) &&
                     !nanoemMotionBoneKeyframeIsPhysicsSimulationEnabled(mutNextKeyframe)) {
                     rigidBody->enableKinematic();
@@ -3851,39 +4577,14 @@ Model::synchronizeAllRigidBodyKinematics(const Motion *motion, nanoem_frame_inde
 void
 Model::dispatchParallelTasks(DispatchParallelTasksIterator iterator, void *opaque, size_t iterations)
 {
-#if defined(NANOEM_ENABLE_TBB)
-    struct ParallelExecutor {
-        typedef void (*DispatchParallelTasksIterator)(void *, size_t);
-        ParallelExecutor(DispatchParallelTasksIterator iterator, void *opaque)
-            : m_iterator(iterator)
-            , m_opaque(opaque)
-        {
-        }
-        void
-        operator()(const tbb::blocked_range<size_t> &range) const
-        {
-            for (size_t it = range.begin(), end = range.end(); it != end; ++it) {
-                m_iterator(m_opaque, it);
-            }
+    if (m_parallelTaskDispatcher) {
+        m_parallelTaskDispatcher->dispatch(iterator, opaque, iterations);
+    }
+    else {
+        for (size_t i = 0; i < iterations; i++) {
+            iterator(opaque, i);
         }
-        DispatchParallelTasksIterator m_iterator;
-        void *m_opaque;
-    } executor(iterator, opaque);
-    tbb::parallel_for(tbb::blocked_range<size_t>(0, iterations), executor);
-#elif defined(__APPLE__)
-    dispatch_queue_t queue = static_cast<dispatch_queue_t>(m_dispatchParallelTaskQueue);
-    dispatch_apply_f(iterations, queue, opaque, iterator);
-#else /* NANOEM_ENABLE_TBB */
-#if defined(NANOEM_ENABLE_OPENMP)
-    const int numIterations = Inline::saturatedInt(iterations);
-#pragma omp parallel for
-    for (int i = 0; i < numIterations; i++) {
-#else
-    for (size_t i = 0; i < iterations; i++) {
-#endif /* NANOEM_ENABLE_OPENMP */
-        iterator(opaque, i);
     }
-#endif /* NANOEM_ENABLE_TBB */
 }
 
 bool
@@ -4746,10 +5447,12 @@ Model::drawConstraintsHeatMap(IPrimitive2D *primitive, const nanoem_model_constr
     const nanoem_rsize_t numIterations = nanoem_rsize_t(nanoemModelConstraintGetNumIterations(constraintPtr));
     model::Constraint *constraint = model::Constraint::cast(constraintPtr);
     nanoem_model_constraint_joint_t *const *joints = nanoemModelConstraintGetAllJointObjects(constraintPtr, &numJoints);
+    /* iterations after the convergence are not solved so these have no results to draw */
+    const nanoem_rsize_t numSolvedIterations = glm::min(numIterations, constraint->numSolvedIterations());
     nanoem_f32_t extent = radius * 2;
     for (nanoem_rsize_t j = 0; j < numJoints; j++) {
         const nanoem_model_constraint_joint_t *joint = joints[j];
-        for (nanoem_rsize_t k = 0; k < numIterations; k++) {
+        for (nanoem_rsize_t k = 0; k < numSolvedIterations; k++) {
             {
                 const model::Constraint::Joint *jointResult = constraint->jointIterationResult(joint, k);
                 const Vector2 jointCoord(camera->toDeviceScreenCoordinateInViewport(jointResult->m_translation));
@@ -4829,6 +5532,15 @@ Model::selection() NANOEM_DECL_NOEXCEPT
     return m_selection;
 }
 
+model::Validator *
+Model::validator()
+{
+    if (!m_validator) {
+        m_validator = nanoem_new(model::Validator);
+    }
+    return m_validator;
+}
+
 String
 Model::name() const
 {
@@ -4942,6 +5654,24 @@ Model::sharedFallbackBone()
     return m_sharedFallbackBone;
 }
 
+void
+Model::invalidateAllSkinningBatches()
+{
+    EnumUtils::setEnabled(kPrivateStateDirtySkinningBatch, m_states, true);
+}
+
+void
+Model::invalidateAllMorphVertexDeltas()
+{
+    nanoem_rsize_t numMorphs;
+    nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(m_opaque, &numMorphs);
+    for (nanoem_rsize_t i = 0; i < numMorphs; i++) {
+        if (model::Morph *morph = model::Morph::cast(morphs[i])) {
+            morph->invalidateAllVertexDeltas();
+        }
+    }
+}
+
 const nanoem_model_bone_t *
 Model::activeBone() const NANOEM_DECL_NOEXCEPT
 {
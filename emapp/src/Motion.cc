@@ -1098,6 +1098,7 @@ Motion::Motion(Project *project, nanoem_u16_t handle)
     , m_opaque(nullptr)
     , m_formatType(NANOEM_MOTION_FORMAT_TYPE_NMD)
     , m_handle(handle)
+    , m_generation(0)
     , m_dirty(false)
 {
     nanoem_assert(m_project, "must not be nullptr");
@@ -1107,12 +1108,7 @@ Motion::Motion(Project *project, nanoem_u16_t handle)
 
 Motion::~Motion() NANOEM_DECL_NOEXCEPT
 {
-    for (BezierCurve::Map::const_iterator it = m_bezierCurvesData.begin(), end = m_bezierCurvesData.end(); it != end;
-         ++it) {
-        nanoem_delete(it->second);
-    }
     nanoem_delete_safe(m_selection);
-    m_bezierCurvesData.clear();
     nanoemMotionDestroy(m_opaque);
     m_opaque = nullptr;
 }
@@ -1412,16 +1408,13 @@ Motion::overrideAllKeyframes(const Motion *source, bool reverse)
 void
 Motion::clearAllKeyframes()
 {
-    for (BezierCurve::Map::const_iterator it = m_bezierCurvesData.begin(), end = m_bezierCurvesData.end(); it != end;
-         ++it) {
-        nanoem_delete(it->second);
-    }
-    m_bezierCurvesData.clear();
-    m_keyframeBezierCurves.clear();
     m_selection->clearAllKeyframes(NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL);
-    nanoemMotionDestroy(m_opaque);
+    /* create new one before destroying so that resolved motion tracks never point the same (reused) address */
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-    m_opaque = nanoemMotionCreate(m_project->unicodeStringFactory(), &status);
+    nanoem_motion_t *opaque = nanoemMotionCreate(m_project->unicodeStringFactory(), &status);
+    nanoemMotionDestroy(m_opaque);
+    m_opaque = opaque;
+    m_generation++;
     m_dirty = false;
 }
 
@@ -2016,6 +2009,16 @@ void
 Motion::setDirty(bool value)
 {
     m_dirty = value;
+    if (value) {
+        /* all of keyframe commands mark the motion dirty so cursors of tracks are invalidated here */
+        m_generation++;
+    }
+}
+
+nanoem_u32_t
+Motion::generation() const NANOEM_DECL_NOEXCEPT
+{
+    return m_generation;
 }
 
 nanoem_f32_t
@@ -2089,29 +2092,19 @@ Motion::bezierCurve(const nanoem_motion_bone_keyframe_t *prev, const nanoem_moti
     nanoem_motion_bone_keyframe_interpolation_type_t index, nanoem_f32_t value) const
 {
     const nanoem_u8_t *parameters = nanoemMotionBoneKeyframeGetInterpolation(next, index);
-    BezierCurve *curve;
-    KeyframeBezierCurveMap::const_iterator it = m_keyframeBezierCurves.find(next);
-    if (it != m_keyframeBezierCurves.end()) {
-        curve = it->second;
+    const nanoem_frame_index_t interval =
+        nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(next)) -
+        nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(prev));
+    nanoem_f32_t result;
+    if (const BezierCurve *curve = m_project->resolveBezierCurve(parameters, interval)) {
+        result = curve->value(value);
     }
     else {
-        const nanoem_frame_index_t interval =
-            nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(next)) -
-            nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(prev));
-        const nanoem_u64_t hash = BezierCurve::toHash(parameters, interval);
-        BezierCurve::Map::const_iterator it2 = m_bezierCurvesData.find(hash);
-        if (it2 != m_bezierCurvesData.end()) {
-            curve = it2->second;
-            m_keyframeBezierCurves.insert(tinystl::make_pair(next, curve));
-        }
-        else {
-            const Vector2 c0(parameters[0], parameters[1]), c1(parameters[2], parameters[3]);
-            curve = nanoem_new(BezierCurve(c0, c1, interval));
-            m_bezierCurvesData.insert(tinystl::make_pair(hash, curve));
-            m_keyframeBezierCurves.insert(tinystl::make_pair(next, curve));
-        }
+        const BezierCurve curve(
+            Vector2U8(parameters[0], parameters[1]), Vector2U8(parameters[2], parameters[3]), interval);
+        result = curve.value(value);
     }
-    return curve->value(value);
+    return result;
 }
 
 nanoem_f32_t
@@ -0,0 +1,43 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/MotionKeyframeCursor.h"
+
+#include "emapp/Motion.h"
+#include "emapp/private/CommonInclude.h"
+
+namespace nanoem {
+
+MotionKeyframeCursor::MotionKeyframeCursor() NANOEM_DECL_NOEXCEPT : m_motion(nullptr), m_generation(0)
+{
+    nanoemMotionKeyframeCursorReset(&m_opaque);
+}
+
+MotionKeyframeCursor::~MotionKeyframeCursor() NANOEM_DECL_NOEXCEPT
+{
+}
+
+nanoem_motion_keyframe_cursor_t *
+MotionKeyframeCursor::resolve(const Motion *motion) NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_u32_t generation = motion ? motion->generation() : 0;
+    if (motion != m_motion || generation != m_generation) {
+        nanoemMotionKeyframeCursorReset(&m_opaque);
+        m_motion = motion;
+        m_generation = generation;
+    }
+    return &m_opaque;
+}
+
+void
+MotionKeyframeCursor::reset() NANOEM_DECL_NOEXCEPT
+{
+    nanoemMotionKeyframeCursorReset(&m_opaque);
+    m_motion = nullptr;
+    m_generation = 0;
+}
+
+} /* namespace nanoem */
@@ -68,11 +68,6 @@ PerspectiveCamera::PerspectiveCamera(Project *project)
 
 PerspectiveCamera::~PerspectiveCamera() NANOEM_DECL_NOEXCEPT
 {
-    for (BezierCurve::Map::const_iterator it = m_bezierCurvesData.begin(), end = m_bezierCurvesData.end(); it != end;
-         ++it) {
-        nanoem_delete(it->second);
-    }
-    m_bezierCurvesData.clear();
     undoStackDestroy(m_undoStack);
     m_undoStack = nullptr;
 }
@@ -138,7 +133,9 @@ PerspectiveCamera::synchronizeParameters(const Motion *motion, const nanoem_fram
     static const nanoem_f32_t kDistanceFactor = -1.0f;
     nanoem_parameter_assert(motion, "must not be nullptr");
     m_outsideParent = StringPair();
-    if (const nanoem_motion_camera_keyframe_t *keyframe = motion->findCameraKeyframe(frameIndex)) {
+    nanoem_motion_keyframe_cursor_t *cursor = m_motionCursor.resolve(motion);
+    if (const nanoem_motion_camera_keyframe_t *keyframe =
+            nanoemMotionFindCameraKeyframeObjectWithCursor(motion->data(), cursor, frameIndex)) {
         setLookAt(glm::make_vec3(nanoemMotionCameraKeyframeGetLookAt(keyframe)));
         setAngle(glm::make_vec3(nanoemMotionCameraKeyframeGetAngle(keyframe)));
         setFov(nanoemMotionCameraKeyframeGetFov(keyframe));
@@ -160,7 +157,8 @@ PerspectiveCamera::synchronizeParameters(const Motion *motion, const nanoem_fram
     }
     else {
         nanoem_motion_camera_keyframe_t *prevKeyframe, *nextKeyframe;
-        nanoemMotionSearchClosestCameraKeyframes(motion->data(), frameIndex, &prevKeyframe, &nextKeyframe);
+        nanoemMotionSearchClosestCameraKeyframesWithCursor(
+            motion->data(), cursor, frameIndex, &prevKeyframe, &nextKeyframe);
         if (prevKeyframe && nextKeyframe) {
             const nanoem_motion_camera_keyframe_t *interpolateKeyframe = nextKeyframe;
             const nanoem_f32_t coef = Motion::coefficient(prevKeyframe, nextKeyframe, frameIndex);
@@ -608,29 +606,10 @@ PerspectiveCamera::bezierCurve(const nanoem_motion_camera_keyframe_t *prev, cons
     nanoem_motion_camera_keyframe_interpolation_type_t index, nanoem_f32_t value) const
 {
     const nanoem_u8_t *parameters = nanoemMotionCameraKeyframeGetInterpolation(next, index);
-    BezierCurve *curve;
-    KeyframeBezierCurveMap::const_iterator it = m_keyframeBezierCurves.find(next);
-    if (it != m_keyframeBezierCurves.end()) {
-        curve = it->second;
-    }
-    else {
-        const nanoem_frame_index_t interval =
-            nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(next)) -
-            nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(prev));
-        const nanoem_u64_t hash = BezierCurve::toHash(parameters, interval);
-        BezierCurve::Map::const_iterator it2 = m_bezierCurvesData.find(hash);
-        if (it2 != m_bezierCurvesData.end()) {
-            curve = it2->second;
-            m_keyframeBezierCurves.insert(tinystl::make_pair(next, curve));
-        }
-        else {
-            const Vector2 c0(parameters[0], parameters[1]), c1(parameters[2], parameters[3]);
-            curve = nanoem_new(BezierCurve(c0, c1, interval));
-            m_bezierCurvesData.insert(tinystl::make_pair(hash, curve));
-            m_keyframeBezierCurves.insert(tinystl::make_pair(next, curve));
-        }
-    }
-    return curve->value(value);
+    const nanoem_frame_index_t interval =
+        nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(next)) -
+        nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(prev));
+    return m_project->resolveBezierCurve(parameters, interval)->value(value);
 }
 
 } /* namespace nanoem */
@@ -8,6 +8,7 @@
 
 #include "bx/os.h"
 #include "emapp/Constants.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
 #include "emapp/private/CommonInclude.h"
 
 #ifndef DLL
@@ -119,8 +120,73 @@ struct PhysicsEngine::PrivateContext {
     typedef void(APIENTRY *PFN_nanoemPhysicsSoftBodySetVisualizeEnabled)(
         nanoem_physics_soft_body_t *soft_body, nanoem_bool_t value);
 
+    struct Island {
+        typedef tinystl::unordered_set<nanoem_physics_rigid_body_t *, TinySTLAllocator> RigidBodySet;
+        typedef tinystl::unordered_set<nanoem_physics_joint_t *, TinySTLAllocator> JointSet;
+        Island(nanoem_physics_world_t *world)
+            : m_world(world)
+        {
+        }
+        bool
+        isEmpty() const NANOEM_DECL_NOEXCEPT
+        {
+            return m_rigidBodies.empty() && m_joints.empty();
+        }
+        nanoem_physics_world_t *m_world;
+        RigidBodySet m_rigidBodies;
+        JointSet m_joints;
+    };
+    typedef tinystl::vector<Island *, TinySTLAllocator> IslandList;
+    typedef tinystl::vector<nanoem_physics_rigid_body_t *, TinySTLAllocator> RigidBodyList;
+    typedef tinystl::vector<nanoem_physics_joint_t *, TinySTLAllocator> JointList;
+    typedef tinystl::unordered_map<const nanoem_model_t *, Island *, TinySTLAllocator> OwnerIslandMap;
+    typedef tinystl::unordered_map<const void *, const nanoem_model_t *, TinySTLAllocator> ObjectOwnerMap;
+    typedef tinystl::unordered_map<const void *, Island *, TinySTLAllocator> ObjectIslandMap;
+    typedef tinystl::unordered_set<const nanoem_model_t *, TinySTLAllocator> OwnerSet;
+    typedef tinystl::unordered_map<const nanoem_physics_rigid_body_t *, nanoem_f32_t, TinySTLAllocator>
+        RigidBodyRadiusMap;
+    typedef tinystl::vector<nanoem_physics_debug_geometry_t *, TinySTLAllocator> DebugGeometryList;
+
+    static void
+    stepIsland(void *opaque, size_t index)
+    {
+        PrivateContext *self = static_cast<PrivateContext *>(opaque);
+        Island *island = self->m_steppingIslands[index];
+        /* bullet must be built with BT_NO_PROFILE as its profiler is shared in the process without locking */
+        self->worldStepSimulation(island->m_world, self->m_stepDelta);
+    }
+    static const nanoem_model_t *
+    parentModel(const nanoem_model_object_t *object) NANOEM_DECL_NOEXCEPT
+    {
+        return nanoemModelObjectGetParentModel(object);
+    }
+    static nanoem_f32_t
+    boundingRadius(const nanoem_model_rigid_body_t *value) NANOEM_DECL_NOEXCEPT
+    {
+        const Vector3 size(glm::make_vec3(nanoemModelRigidBodyGetShapeSize(value)));
+        nanoem_f32_t radius;
+        switch (nanoemModelRigidBodyGetShapeType(value)) {
+        case NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_SPHERE: {
+            radius = size.x;
+            break;
+        }
+        case NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_CAPSULE: {
+            radius = size.x + size.y * 0.5f;
+            break;
+        }
+        default:
+            radius = glm::length(size);
+            break;
+        }
+        return glm::abs(radius);
+    }
+
     PrivateContext()
         : m_opaque(nullptr)
+        , m_sharedIsland(nullptr)
+        , m_islandDispatcher(nullptr)
+        , m_stepDelta(0)
+        , m_islandEnabled(false)
         , m_mode(PhysicsEngine::kSimulationModeDisable)
         , m_direction(-Constants::kUnitY)
         , m_acceleration(9.8f)
@@ -191,6 +257,281 @@ struct PhysicsEngine::PrivateContext {
     }
     ~PrivateContext() NANOEM_DECL_NOEXCEPT
     {
+        nanoem_delete_safe(m_islandDispatcher);
+    }
+
+    void
+    createSharedIsland(nanoem_status_t &status)
+    {
+        m_opaque = worldCreate(nullptr, &status);
+        m_sharedIsland = nanoem_new(Island(m_opaque));
+        m_allIslands.push_back(m_sharedIsland);
+        m_islandDispatcher = nanoem_new(internal::ParallelTaskDispatcher("com.github.nanoem.gcd.physics"));
+    }
+    void
+    destroyAllIslands() NANOEM_DECL_NOEXCEPT
+    {
+        for (IslandList::const_iterator it = m_allIslands.begin(), end = m_allIslands.end(); it != end; ++it) {
+            Island *island = *it;
+            if (island != m_sharedIsland) {
+                worldDestroy(island->m_world);
+            }
+            nanoem_delete(island);
+        }
+        worldDestroy(m_opaque);
+        m_allIslands.clear();
+        m_ownerIslands.clear();
+        m_objectIslands.clear();
+        m_sharedIsland = nullptr;
+        m_opaque = nullptr;
+        nanoem_delete_safe(m_islandDispatcher);
+    }
+    Island *
+    resolveIsland(const nanoem_model_t *owner)
+    {
+        Island *island = m_sharedIsland;
+        if (m_islandEnabled && owner && m_sharedIsland) {
+            OwnerIslandMap::const_iterator it = m_ownerIslands.find(owner);
+            if (it != m_ownerIslands.end()) {
+                island = it->second;
+            }
+            else {
+                nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+                if (nanoem_physics_world_t *world = worldCreate(nullptr, &status)) {
+                    /* follows the shared world including its ground as all of islands are in the same space. the ground
+                       is a static collision object that cannot belong to multiple worlds so each island has its own */
+                    worldSetGravity(world, worldGetGravity(m_opaque));
+                    worldSetActive(world, worldIsActive(m_opaque));
+                    worldSetGroundEnabled(world, worldIsGroundEnabled(m_opaque));
+                    worldSetDebugGeomtryFlags(world, worldGetDebugGeomtryFlags(m_opaque));
+                    island = nanoem_new(Island(world));
+                    m_allIslands.push_back(island);
+                }
+                m_ownerIslands.insert(tinystl::make_pair(owner, island));
+            }
+        }
+        return island;
+    }
+    Island *
+    findIsland(const void *object) const NANOEM_DECL_NOEXCEPT
+    {
+        ObjectIslandMap::const_iterator it = m_objectIslands.find(object);
+        return it != m_objectIslands.end() ? it->second : m_sharedIsland;
+    }
+    const nanoem_model_t *
+    findOwner(const void *object) const NANOEM_DECL_NOEXCEPT
+    {
+        ObjectOwnerMap::const_iterator it = m_objectOwners.find(object);
+        return it != m_objectOwners.end() ? it->second : nullptr;
+    }
+    void
+    forgetOwner(const void *object)
+    {
+        ObjectOwnerMap::const_iterator it = m_objectOwners.find(object);
+        if (it != m_objectOwners.end()) {
+            m_objectOwners.erase(it);
+        }
+    }
+    void
+    forgetRadius(const nanoem_physics_rigid_body_t *value)
+    {
+        RigidBodyRadiusMap::const_iterator it = m_rigidBodyRadiuses.find(value);
+        if (it != m_rigidBodyRadiuses.end()) {
+            m_rigidBodyRadiuses.erase(it);
+        }
+    }
+    void
+    forgetIsland(const void *object)
+    {
+        ObjectIslandMap::const_iterator it = m_objectIslands.find(object);
+        if (it != m_objectIslands.end()) {
+            m_objectIslands.erase(it);
+        }
+    }
+    void
+    addRigidBody(Island *island, nanoem_physics_rigid_body_t *value)
+    {
+        if (island) {
+            worldAddRigidBody(island->m_world, value);
+            island->m_rigidBodies.insert(value);
+            m_objectIslands[value] = island;
+        }
+    }
+    void
+    removeRigidBody(nanoem_physics_rigid_body_t *value)
+    {
+        if (Island *island = findIsland(value)) {
+            worldRemoveRigidBody(island->m_world, value);
+            island->m_rigidBodies.erase(value);
+            forgetIsland(value);
+        }
+    }
+    void
+    addJoint(Island *island, nanoem_physics_joint_t *value)
+    {
+        if (island) {
+            worldAddJoint(island->m_world, value);
+            island->m_joints.insert(value);
+            m_objectIslands[value] = island;
+        }
+    }
+    void
+    removeJoint(nanoem_physics_joint_t *value)
+    {
+        if (Island *island = findIsland(value)) {
+            worldRemoveJoint(island->m_world, value);
+            island->m_joints.erase(value);
+            forgetIsland(value);
+        }
+    }
+    void
+    mergeIslands(Island *left, Island *right)
+    {
+        if (left != right) {
+            /* the shared island must survive as soft bodies cannot be moved */
+            if (right == m_sharedIsland) {
+                moveIsland(left, right);
+            }
+            else {
+                moveIsland(right, left);
+            }
+        }
+    }
+    bool
+    computeIslandBounds(const Island *island, Vector3 &minValue, Vector3 &maxValue) const NANOEM_DECL_NOEXCEPT
+    {
+        bool found = false;
+        for (Island::RigidBodySet::const_iterator it = island->m_rigidBodies.begin(), end = island->m_rigidBodies.end();
+             it != end; ++it) {
+            const nanoem_physics_rigid_body_t *body = *it;
+            RigidBodyRadiusMap::const_iterator it2 = m_rigidBodyRadiuses.find(body);
+            const Vector3 extent(it2 != m_rigidBodyRadiuses.end() ? it2->second : 0.0f);
+            Matrix4x4 transform;
+            rigidBodyGetWorldTransform(body, glm::value_ptr(transform));
+            const Vector3 origin(transform[3]);
+            minValue = found ? glm::min(minValue, origin - extent) : origin - extent;
+            maxValue = found ? glm::max(maxValue, origin + extent) : origin + extent;
+            found = true;
+        }
+        return found;
+    }
+    void
+    mergeAllOverlappingIslands()
+    {
+        /* rigid bodies of the different models collide each other so these must be stepped in the same world */
+        IslandList islands;
+        tinystl::vector<Vector3, TinySTLAllocator> minValues, maxValues;
+        bool merged = true;
+        while (merged) {
+            merged = false;
+            islands.clear();
+            minValues.clear();
+            maxValues.clear();
+            for (IslandList::const_iterator it = m_allIslands.begin(), end = m_allIslands.end(); it != end; ++it) {
+                Vector3 minValue, maxValue;
+                if (computeIslandBounds(*it, minValue, maxValue)) {
+                    islands.push_back(*it);
+                    minValues.push_back(minValue);
+                    maxValues.push_back(maxValue);
+                }
+            }
+            for (nanoem_rsize_t i = 0, numIslands = islands.size(); !merged && i < numIslands; i++) {
+                for (nanoem_rsize_t j = i + 1; !merged && j < numIslands; j++) {
+                    if (glm::all(glm::lessThanEqual(minValues[i], maxValues[j])) &&
+                        glm::all(glm::lessThanEqual(minValues[j], maxValues[i]))) {
+                        mergeIslands(islands[i], islands[j]);
+                        merged = true;
+                    }
+                }
+            }
+        }
+    }
+    void
+    moveIsland(Island *source, Island *dest)
+    {
+        RigidBodyList rigidBodies;
+        JointList joints;
+        detachAll(source, rigidBodies, joints);
+        attachAll(dest, rigidBodies, joints);
+        for (OwnerIslandMap::iterator it = m_ownerIslands.begin(), end = m_ownerIslands.end(); it != end; ++it) {
+            if (it->second == source) {
+                it->second = dest;
+            }
+        }
+    }
+    void
+    detachAll(Island *island, RigidBodyList &rigidBodies, JointList &joints)
+    {
+        /* constraints must be removed before and added after rigid bodies they refer */
+        const nanoem_rsize_t offsetOfJoints = joints.size(), offsetOfRigidBodies = rigidBodies.size();
+        for (Island::JointSet::const_iterator it = island->m_joints.begin(), end = island->m_joints.end(); it != end;
+             ++it) {
+            joints.push_back(*it);
+        }
+        for (Island::RigidBodySet::const_iterator it = island->m_rigidBodies.begin(), end = island->m_rigidBodies.end();
+             it != end; ++it) {
+            rigidBodies.push_back(*it);
+        }
+        for (nanoem_rsize_t i = offsetOfJoints, numJoints = joints.size(); i < numJoints; i++) {
+            removeJoint(joints[i]);
+        }
+        for (nanoem_rsize_t i = offsetOfRigidBodies, numRigidBodies = rigidBodies.size(); i < numRigidBodies; i++) {
+            removeRigidBody(rigidBodies[i]);
+        }
+    }
+    void
+    attachAll(Island *island, const RigidBodyList &rigidBodies, const JointList &joints)
+    {
+        for (RigidBodyList::const_iterator it = rigidBodies.begin(), end = rigidBodies.end(); it != end; ++it) {
+            nanoem_physics_rigid_body_t *body = *it;
+            addRigidBody(island ? island : resolveIsland(findOwner(body)), body);
+        }
+        for (JointList::const_iterator it = joints.begin(), end = joints.end(); it != end; ++it) {
+            nanoem_physics_joint_t *joint = *it;
+            addJoint(island ? island : resolveIsland(findOwner(joint)), joint);
+        }
+    }
+    void
+    rebuildAllIslands()
+    {
+        RigidBodyList rigidBodies;
+        JointList joints;
+        /* emptied islands are kept until the engine is destroyed since joints may refer their null rigid body */
+        for (IslandList::const_iterator it = m_allIslands.begin(), end = m_allIslands.end(); it != end; ++it) {
+            detachAll(*it, rigidBodies, joints);
+        }
+        m_ownerIslands.clear();
+        if (m_islandEnabled) {
+            for (OwnerSet::const_iterator it = m_softBodyOwners.begin(), end = m_softBodyOwners.end(); it != end;
+                 ++it) {
+                m_ownerIslands.insert(tinystl::make_pair(*it, m_sharedIsland));
+            }
+            attachAll(nullptr, rigidBodies, joints);
+        }
+        else {
+            attachAll(m_sharedIsland, rigidBodies, joints);
+        }
+    }
+    void
+    stepAllIslands(nanoem_f32_t delta)
+    {
+        if (m_islandEnabled) {
+            mergeAllOverlappingIslands();
+        }
+        m_steppingIslands.clear();
+        for (IslandList::const_iterator it = m_allIslands.begin(), end = m_allIslands.end(); it != end; ++it) {
+            Island *island = *it;
+            if (island == m_sharedIsland || !island->isEmpty()) {
+                m_steppingIslands.push_back(island);
+            }
+        }
+        m_stepDelta = delta;
+        if (m_steppingIslands.size() > 1) {
+            m_islandDispatcher->dispatch(stepIsland, this, m_steppingIslands.size());
+        }
+        else {
+            worldStepSimulation(m_opaque, delta);
+        }
     }
 
     bool
@@ -331,6 +672,18 @@ struct PhysicsEngine::PrivateContext {
     }
 
     nanoem_physics_world_t *m_opaque;
+    Island *m_sharedIsland;
+    IslandList m_allIslands;
+    IslandList m_steppingIslands;
+    OwnerIslandMap m_ownerIslands;
+    ObjectOwnerMap m_objectOwners;
+    RigidBodyRadiusMap m_rigidBodyRadiuses;
+    ObjectIslandMap m_objectIslands;
+    OwnerSet m_softBodyOwners;
+    DebugGeometryList m_debugGeometries;
+    internal::ParallelTaskDispatcher *m_islandDispatcher;
+    nanoem_f32_t m_stepDelta;
+    bool m_islandEnabled;
     PhysicsEngine::SimulationModeType m_mode;
     Vector3 m_direction;
     nanoem_f32_t m_acceleration;
@@ -428,26 +781,28 @@ PhysicsEngine::initialize(const char *dllPath)
 void
 PhysicsEngine::create(nanoem_status_t &status)
 {
-    m_context->m_opaque = m_context->worldCreate(nullptr, &status);
+    m_context->createSharedIsland(status);
 }
 
 void
 PhysicsEngine::destroy() NANOEM_DECL_NOEXCEPT
 {
-    m_context->worldDestroy(m_context->m_opaque);
-    m_context->m_opaque = nullptr;
+    m_context->destroyAllIslands();
 }
 
 void
 PhysicsEngine::reset() NANOEM_DECL_NOEXCEPT
 {
-    m_context->worldReset(m_context->m_opaque);
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        m_context->worldReset((*it)->m_world);
+    }
 }
 
 void
 PhysicsEngine::stepSimulation(nanoem_f32_t delta)
 {
-    m_context->worldStepSimulation(m_context->m_opaque, delta);
+    m_context->stepAllIslands(delta);
 }
 
 PhysicsEngine::SimulationModeType
@@ -477,10 +832,51 @@ PhysicsEngine::worldOpaque()
     return m_context->m_opaque;
 }
 
+bool
+PhysicsEngine::isIslandEnabled() const NANOEM_DECL_NOEXCEPT
+{
+    return m_context->m_islandEnabled;
+}
+
+void
+PhysicsEngine::setIslandEnabled(bool value)
+{
+    if (m_context->m_islandEnabled != value) {
+        m_context->m_islandEnabled = value;
+        m_context->rebuildAllIslands();
+    }
+}
+
+void
+PhysicsEngine::mergeIslands(const nanoem_model_t *left, const nanoem_model_t *right)
+{
+    if (m_context->m_islandEnabled && left && right) {
+        m_context->mergeIslands(m_context->resolveIsland(left), m_context->resolveIsland(right));
+    }
+}
+
+nanoem_rsize_t
+PhysicsEngine::numIslands() const NANOEM_DECL_NOEXCEPT
+{
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    nanoem_rsize_t numIslands = 0;
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        const PrivateContext::Island *island = *it;
+        numIslands += island == m_context->m_sharedIsland || !island->isEmpty() ? 1 : 0;
+    }
+    return numIslands;
+}
+
 nanoem_physics_rigid_body_t *
 PhysicsEngine::createRigidBody(const nanoem_model_rigid_body_t *value, nanoem_status_t &status)
 {
-    return m_context->rigidBodyCreate(value, nullptr, &status);
+    nanoem_physics_rigid_body_t *body = m_context->rigidBodyCreate(value, nullptr, &status);
+    if (body) {
+        m_context->m_objectOwners[body] =
+            PrivateContext::parentModel(nanoemModelRigidBodyGetModelObject(value));
+        m_context->m_rigidBodyRadiuses[body] = PrivateContext::boundingRadius(value);
+    }
+    return body;
 }
 
 nanoem_physics_motion_state_t *
@@ -504,18 +900,20 @@ PhysicsEngine::setWorldTransform(nanoem_physics_rigid_body_t *body, const nanoem
 void
 PhysicsEngine::addRigidBody(nanoem_physics_rigid_body_t *value)
 {
-    m_context->worldAddRigidBody(m_context->m_opaque, value);
+    m_context->addRigidBody(m_context->resolveIsland(m_context->findOwner(value)), value);
 }
 
 void
 PhysicsEngine::removeRigidBody(nanoem_physics_rigid_body_t *value)
 {
-    m_context->worldRemoveRigidBody(m_context->m_opaque, value);
+    m_context->removeRigidBody(value);
 }
 
 void
 PhysicsEngine::destroyRigidBody(nanoem_physics_rigid_body_t *value)
 {
+    m_context->forgetOwner(value);
+    m_context->forgetRadius(value);
     m_context->rigidBodyDestroy(value);
 }
 
@@ -546,13 +944,17 @@ PhysicsEngine::setVisualizedEnabled(nanoem_physics_soft_body_t *body, bool value
 nanoem_physics_joint_t *
 PhysicsEngine::createJoint(const nanoem_model_joint_t *value, void *opaque, nanoem_status_t &status)
 {
-    return m_context->jointCreate(value, opaque, &status);
+    nanoem_physics_joint_t *joint = m_context->jointCreate(value, opaque, &status);
+    if (joint) {
+        m_context->m_objectOwners[joint] = PrivateContext::parentModel(nanoemModelJointGetModelObject(value));
+    }
+    return joint;
 }
 
 void
 PhysicsEngine::addJoint(nanoem_physics_joint_t *value)
 {
-    m_context->worldAddJoint(m_context->m_opaque, value);
+    m_context->addJoint(m_context->resolveIsland(m_context->findOwner(value)), value);
 }
 
 void
@@ -570,19 +972,35 @@ PhysicsEngine::getCalculatedTransformB(nanoem_physics_joint_t *joint, nanoem_f32
 void
 PhysicsEngine::removeJoint(nanoem_physics_joint_t *value) NANOEM_DECL_NOEXCEPT
 {
-    m_context->worldRemoveJoint(m_context->m_opaque, value);
+    m_context->removeJoint(value);
 }
 
 void
 PhysicsEngine::destroyJoint(nanoem_physics_joint_t *value) NANOEM_DECL_NOEXCEPT
 {
+    m_context->forgetOwner(value);
     m_context->jointDestroy(value);
 }
 
 nanoem_physics_debug_geometry_t *const *
 PhysicsEngine::debugGeometryObjects(int *numObjects) const NANOEM_DECL_NOEXCEPT
 {
-    return m_context->worldGetDebugGeomtryObjects(m_context->m_opaque, numObjects);
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    if (islands.size() <= 1) {
+        return m_context->worldGetDebugGeomtryObjects(m_context->m_opaque, numObjects);
+    }
+    PrivateContext::DebugGeometryList &geometries = m_context->m_debugGeometries;
+    geometries.clear();
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        int numIslandObjects = 0;
+        nanoem_physics_debug_geometry_t *const *objects =
+            m_context->worldGetDebugGeomtryObjects((*it)->m_world, &numIslandObjects);
+        for (int i = 0; i < numIslandObjects; i++) {
+            geometries.push_back(objects[i]);
+        }
+    }
+    *numObjects = Inline::saturateInt32(geometries.size());
+    return geometries.data();
 }
 
 const nanoem_f32_t *
@@ -606,6 +1024,16 @@ PhysicsEngine::geometryToPosition(const nanoem_physics_debug_geometry_t *value)
 nanoem_physics_soft_body_t *
 PhysicsEngine::createSoftBody(const nanoem_model_soft_body_t *body, nanoem_status_t &status)
 {
+    const nanoem_model_t *owner = PrivateContext::parentModel(nanoemModelSoftBodyGetModelObject(body));
+    if (owner && m_context->m_sharedIsland) {
+        /* soft bodies are always created in the shared world so the owner of them must be simulated in it */
+        PrivateContext::Island *island = m_context->resolveIsland(owner);
+        if (island != m_context->m_sharedIsland) {
+            m_context->moveIsland(island, m_context->m_sharedIsland);
+        }
+        m_context->m_ownerIslands[owner] = m_context->m_sharedIsland;
+        m_context->m_softBodyOwners.insert(owner);
+    }
     return m_context->softBodyCreate(body, m_context->m_opaque, &status);
 }
 
@@ -728,7 +1156,10 @@ PhysicsEngine::gravity() const NANOEM_DECL_NOEXCEPT
 void
 PhysicsEngine::setGravity(const nanoem_f32_t *value)
 {
-    m_context->worldSetGravity(m_context->m_opaque, value);
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        m_context->worldSetGravity((*it)->m_world, value);
+    }
 }
 
 nanoem_u32_t
@@ -740,7 +1171,10 @@ PhysicsEngine::debugGeometryFlags() const NANOEM_DECL_NOEXCEPT
 void
 PhysicsEngine::setDebugGeometryFlags(nanoem_u32_t value)
 {
-    m_context->worldSetDebugGeomtryFlags(m_context->m_opaque, value);
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        m_context->worldSetDebugGeomtryFlags((*it)->m_world, value);
+    }
 }
 
 bool
@@ -752,7 +1186,10 @@ PhysicsEngine::isActive() const NANOEM_DECL_NOEXCEPT
 void
 PhysicsEngine::setActive(bool value)
 {
-    m_context->worldSetActive(m_context->m_opaque, value);
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        m_context->worldSetActive((*it)->m_world, value);
+    }
 }
 
 void
@@ -840,7 +1277,10 @@ PhysicsEngine::isGroundEnabled() const NANOEM_DECL_NOEXCEPT
 void
 PhysicsEngine::setGroundEnabled(bool value)
 {
-    m_context->worldSetGroundEnabled(m_context->m_opaque, value);
+    const PrivateContext::IslandList &islands = m_context->m_allIslands;
+    for (PrivateContext::IslandList::const_iterator it = islands.begin(), end = islands.end(); it != end; ++it) {
+        m_context->worldSetGroundEnabled((*it)->m_world, value);
+    }
 }
 
 } /* namespace nanoem */
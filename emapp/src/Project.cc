@@ -41,9 +41,13 @@
 #include "emapp/command/BatchUndoCommandListCommand.h"
 #include "emapp/command/MotionSnapshotCommand.h"
 #include "emapp/command/TransformBoneCommand.h"
+#include "emapp/effect/SourceCache.h"
 #include "emapp/internal/BlitPass.h"
 #include "emapp/internal/ClearPass.h"
 #include "emapp/internal/DebugDrawer.h"
+#include "emapp/internal/FileContentDigestCache.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
+#include "emapp/internal/PhysicsBakeCache.h"
 #include "emapp/internal/project/Archive.h"
 #include "emapp/internal/project/JSON.h"
 #include "emapp/internal/project/Native.h"
@@ -51,6 +55,7 @@
 #include "emapp/internal/project/Redo.h"
 #include "emapp/internal/project/Track.h"
 #include "emapp/model/Morph.h"
+#include "emapp/plugin/EffectPlugin.h"
 #include "emapp/private/CommonInclude.h"
 #include "protoc/application.pb-c.h"
 
@@ -58,7 +63,6 @@
 #include "bx/hash.h"
 #include "bx/timer.h"
 
-#include "lz4/lib/lz4.h"
 #include "sokol/sokol_time.h"
 #include "undo/undo.h"
 #include "zlib.h"
@@ -102,6 +106,7 @@ static const nanoem_u64_t kEnableImageMipmap = 1ull << 28;
 static const nanoem_u64_t kEnablePowerSaving = 1ull << 29;
 static const nanoem_u64_t kEnableModelEditing = 1ull << 30;
 static const nanoem_u64_t kViewportWindowDetached = 1ull << 31;
+static const nanoem_u64_t kSynchronizingMotionsInParallel = 1ull << 32;
 
 static const nanoem_u64_t kPrivateStateInitialValue = kDisplayTransformHandle | kDisplayUserInterface |
     kEnableMotionMerge | kEnableUniformedViewportImageSize | kEnableFPSCounter | kEnablePerformanceMonitor |
@@ -285,6 +290,74 @@ compareOffscreenRenderTargetOption(const void *left, const void *right)
 static const Vector2UI16 kDefaultViewportImageSize = Vector2UI16(640, 360);
 static const nanoem_u32_t kTimeBasedAudioSourceDefaultSampleRate = 1440;
 
+struct SynchronizeSkeletonMotionTask {
+    static void
+    execute(void *opaque, size_t index)
+    {
+        const SynchronizeSkeletonMotionTask *task = static_cast<const SynchronizeSkeletonMotionTask *>(opaque);
+        const nanoem_rsize_t offset = task->m_offsets[index];
+        task->m_models[offset]->synchronizeSkeletonMotion(
+            task->m_motions[offset], task->m_frameIndex, task->m_amount, task->m_timing);
+    }
+    Project::ModelList m_models;
+    Project::MotionList m_motions;
+    Project::ModelTransformLevelList m_offsets;
+    nanoem_frame_index_t m_frameIndex;
+    nanoem_f32_t m_amount;
+    PhysicsEngine::SimulationTimingType m_timing;
+};
+
+static void
+performStagingVertexBufferUpdate(void *opaque, size_t index)
+{
+    Model *const *models = static_cast<Model *const *>(opaque);
+    models[index]->performStagingVertexBufferUpdate();
+}
+
+static nanoem_u64_t
+digestAllRigidBodiesAndJoints(const nanoem_model_t *model, nanoem_u64_t signature)
+{
+    nanoem_rsize_t numRigidBodies, numJoints;
+    nanoem_model_rigid_body_t *const *rigidBodies = nanoemModelGetAllRigidBodyObjects(model, &numRigidBodies);
+    for (nanoem_rsize_t i = 0; i < numRigidBodies; i++) {
+        const nanoem_model_rigid_body_t *rigidBodyPtr = rigidBodies[i];
+        const nanoem_f32_t *origin = nanoemModelRigidBodyGetOrigin(rigidBodyPtr),
+                           *orientation = nanoemModelRigidBodyGetOrientation(rigidBodyPtr),
+                           *size = nanoemModelRigidBodyGetShapeSize(rigidBodyPtr);
+        const nanoem_f32_t parameters[] = { origin[0], origin[1], origin[2], orientation[0], orientation[1],
+            orientation[2], size[0], size[1], size[2], nanoemModelRigidBodyGetMass(rigidBodyPtr),
+            nanoemModelRigidBodyGetLinearDamping(rigidBodyPtr), nanoemModelRigidBodyGetAngularDamping(rigidBodyPtr),
+            nanoemModelRigidBodyGetFriction(rigidBodyPtr), nanoemModelRigidBodyGetRestitution(rigidBodyPtr),
+            nanoem_f32_t(nanoemModelRigidBodyGetShapeType(rigidBodyPtr)),
+            nanoem_f32_t(nanoemModelRigidBodyGetTransformType(rigidBodyPtr)),
+            nanoem_f32_t(nanoemModelRigidBodyGetCollisionGroupId(rigidBodyPtr)),
+            nanoem_f32_t(nanoemModelRigidBodyGetCollisionMask(rigidBodyPtr)),
+            nanoem_f32_t(nanoemModelObjectGetIndex(
+                nanoemModelBoneGetModelObject(nanoemModelRigidBodyGetBoneObject(rigidBodyPtr)))),
+            nanoemModelRigidBodyIsBoneRelativePosition(rigidBodyPtr) ? 1.0f : 0.0f };
+        signature = internal::PhysicsBakeCache::digest(parameters, sizeof(parameters), signature);
+    }
+    nanoem_model_joint_t *const *joints = nanoemModelGetAllJointObjects(model, &numJoints);
+    for (nanoem_rsize_t i = 0; i < numJoints; i++) {
+        const nanoem_model_joint_t *jointPtr = joints[i];
+        const nanoem_f32_t *vectors[] = { nanoemModelJointGetOrigin(jointPtr),
+            nanoemModelJointGetOrientation(jointPtr), nanoemModelJointGetLinearUpperLimit(jointPtr),
+            nanoemModelJointGetLinearLowerLimit(jointPtr), nanoemModelJointGetLinearStiffness(jointPtr),
+            nanoemModelJointGetAngularUpperLimit(jointPtr), nanoemModelJointGetAngularLowerLimit(jointPtr),
+            nanoemModelJointGetAngularStiffness(jointPtr) };
+        const nanoem_f32_t parameters[] = { nanoem_f32_t(nanoemModelJointGetType(jointPtr)),
+            nanoem_f32_t(nanoemModelObjectGetIndex(
+                nanoemModelRigidBodyGetModelObject(nanoemModelJointGetRigidBodyAObject(jointPtr)))),
+            nanoem_f32_t(nanoemModelObjectGetIndex(
+                nanoemModelRigidBodyGetModelObject(nanoemModelJointGetRigidBodyBObject(jointPtr)))) };
+        signature = internal::PhysicsBakeCache::digest(parameters, sizeof(parameters), signature);
+        for (nanoem_rsize_t j = 0; j < BX_COUNTOF(vectors); j++) {
+            signature = internal::PhysicsBakeCache::digest(vectors[j], sizeof(*vectors[j]) * 3, signature);
+        }
+    }
+    return signature;
+}
+
 } /* namespace anonymous */
 
 #include "sha256.h"
@@ -298,6 +371,8 @@ const char *const Project::kViewportSecondaryName = "@nanoem/Viewport/Secondary"
 const nanoem_frame_index_t Project::kMinimumBaseDuration = 300u;
 const nanoem_frame_index_t Project::kMaximumBaseDuration = (1u << 31) - 1; // INT32_MAX
 const nanoem_f32_t Project::kDefaultCircleRadiusSize = 7.5f;
+const nanoem_u64_t Project::kDefaultUndoSnapshotMemoryBudget = 256 * 1024 * 1024;
+const nanoem_u32_t Project::kDefaultRedoCheckpointInterval = 256;
 
 struct Project::DrawQueue {
     enum CommandType {
@@ -1183,6 +1258,41 @@ Project::setShadowDepthStencilState(sg_depth_state &ds, sg_stencil_state &ss) NA
     ss.front.pass_op = ss.back.pass_op = SG_STENCILOP_REPLACE;
 }
 
+/* a model referring bones of the other model as outside parent must be transformed after it when the other model
+   precedes in the transform order, otherwise it reads the previous transform and must be transformed before */
+void
+Project::computeAllModelTransformLevels(const ModelList &models, ModelTransformLevelList &levels)
+{
+    const nanoem_rsize_t numModels = models.size();
+    levels.resize(numModels);
+    for (nanoem_rsize_t i = 0; i < numModels; i++) {
+        levels[i] = 0;
+    }
+    for (nanoem_rsize_t i = 0; i < numModels; i++) {
+        const Model *model = models[i];
+        const model::Bone::OutsideParentMap outsideParents(model->allOutsideParents());
+        for (model::Bone::OutsideParentMap::const_iterator it = outsideParents.begin(), end = outsideParents.end();
+             it != end; ++it) {
+            const Model *parentModel = model->project()->findModelByName(it->second.first);
+            for (nanoem_rsize_t j = 0; j < i; j++) {
+                if (models[j] == parentModel) {
+                    levels[i] = glm::max(levels[i], levels[j] + 1);
+                }
+            }
+        }
+        /* levels of the preceding models are fixed at this point so the following ones can be bumped safely */
+        for (model::Bone::OutsideParentMap::const_iterator it = outsideParents.begin(), end = outsideParents.end();
+             it != end; ++it) {
+            const Model *parentModel = model->project()->findModelByName(it->second.first);
+            for (nanoem_rsize_t j = i + 1; j < numModels; j++) {
+                if (models[j] == parentModel) {
+                    levels[j] = glm::max(levels[j], levels[i] + 1);
+                }
+            }
+        }
+    }
+}
+
 Project::Project(const Injector &injector)
     : m_unicodeStringFactoryRepository(injector.m_unicodeStringFactoryRepository)
     , m_applicationConfiguration(injector.m_applicationConfiguration)
@@ -1197,6 +1307,7 @@ Project::Project(const Injector &injector)
     , m_sharedResourceRepository(injector.m_sharedResourceRepositoryPtr)
     , m_translator(injector.m_translatorPtr)
     , m_sharedImageLoader(nullptr)
+    , m_fileContentDigestCache(nullptr)
     , m_activeModelPairPtr(nullptr, nullptr)
     , m_activeAccessoryPtr(nullptr)
     , m_audioPlayer(injector.m_audioPlayer)
@@ -1220,6 +1331,10 @@ Project::Project(const Injector &injector)
     , m_sharedImageBlitter(nullptr)
     , m_renderPassCleaner(nullptr)
     , m_sharedDebugDrawer(nullptr)
+    , m_parallelTaskDispatcher(nullptr)
+    , m_physicsBakeCache(nullptr)
+    , m_redoJournal(nullptr)
+    , m_sourceEffectCache(nullptr)
     , m_viewportPixelFormat(injector.m_pixelFormat, injector.m_pixelFormat)
     , m_drawType(IDrawable::kDrawTypeColor)
     , m_editingMode(kEditingModeNone)
@@ -1255,10 +1370,15 @@ Project::Project(const Injector &injector)
     , m_sampleLevel(0, 0)
     , m_stateFlags(kPrivateStateInitialValue)
     , m_confirmSeekFlags(0)
+    , m_undoSnapshotMemory(0, kDefaultUndoSnapshotMemoryBudget)
+    , m_undoSnapshotSequence(0)
+    , m_undoCommandSequence(0)
     , m_lastPhysicsDebugFlags(0)
     , m_coordinationSystem(GLM_LEFT_HANDED)
     , m_actualFPS(0)
     , m_actionSequence(0)
+    , m_redoCheckpointInterval(kDefaultRedoCheckpointInterval)
+    , m_bakedPhysicsRestored(false)
     , m_active(false)
 {
     const bool topLeft = sg::query_features().origin_top_left;
@@ -1279,6 +1399,8 @@ Project::Project(const Injector &injector)
     m_drawQueue->m_project = this;
     m_batchDrawQueue = nanoem_new(BatchDrawQueue(m_drawQueue));
     m_serialDrawQueue = nanoem_new(SerialDrawQueue(m_drawQueue));
+    m_parallelTaskDispatcher = nanoem_new(internal::ParallelTaskDispatcher("com.github.nanoem.gcd.project"));
+    m_physicsBakeCache = nanoem_new(internal::PhysicsBakeCache);
     m_undoStack = undoStackCreateWithSoftLimit(glm::clamp(injector.m_preferredUndoCount, 64, undoStackGetHardLimit()));
     nanoem_assert(m_audioPlayer, "must not be nullptr");
     nanoem_assert(m_backgroundVideoRenderer, "must not be nullptr");
@@ -1312,6 +1434,10 @@ Project::~Project() NANOEM_DECL_NOEXCEPT
         nanoem_delete(*it);
     }
     m_allTracks.clear();
+    for (BezierCurve::Map::const_iterator it = m_bezierCurves.begin(), end = m_bezierCurves.end(); it != end; ++it) {
+        nanoem_delete(it->second);
+    }
+    m_bezierCurves.clear();
     m_drawable2MotionPtrs.clear();
     undoStackDestroy(m_undoStack);
     m_undoStack = nullptr;
@@ -1328,7 +1454,14 @@ Project::~Project() NANOEM_DECL_NOEXCEPT
     nanoem_delete_safe(m_light);
     nanoem_delete_safe(m_physicsEngine);
     nanoem_delete_safe(m_sharedDebugDrawer);
+    nanoem_delete_safe(m_parallelTaskDispatcher);
+    nanoem_delete_safe(m_physicsBakeCache);
+#if defined(NANOEM_ENABLE_NANOMSG)
+    nanoem_delete_safe(m_redoJournal);
+#endif
+    nanoem_delete_safe(m_sourceEffectCache);
     nanoem_delete_safe(m_sharedImageLoader);
+    nanoem_delete_safe(m_fileContentDigestCache);
     nanoem_delete_safe(m_renderPassBlitter);
     nanoem_delete_safe(m_sharedImageBlitter);
     nanoem_delete_safe(m_renderPassCleaner);
@@ -1580,16 +1713,14 @@ Project::loadEffectFromBinary(const URI &fileURI, Effect *effect, Progress &prog
     nanoem_parameter_assert(effect, "must not be nullptr");
     bool succeeded = false;
     if (FileUtils::exists(fileURI)) {
-        FileReaderScope scope(m_translator);
-        if (scope.open(fileURI, error)) {
-            ByteArray bytes;
-            FileUtils::read(scope, bytes, error);
-            if (!error.hasReason()) {
-                effect->setName(fileURI.lastPathComponent());
-                if (effect->load(bytes, progress, error)) {
-                    effect->setFileURI(fileURI);
-                    succeeded = effect->upload(effect::kAttachmentTypeNone, progress, error);
-                }
+        MappedFileReader reader(m_translator);
+        if (reader.open(fileURI, error)) {
+            effect->setName(fileURI.lastPathComponent());
+            if (effect->load(reader.bytes(), reader.size(), progress, error)) {
+                /* the digest is recorded from the loaded bytes to save the project without reading it again */
+                fileContentDigestCache()->update(fileURI, reader.bytes(), reader.size());
+                effect->setFileURI(fileURI);
+                succeeded = effect->upload(effect::kAttachmentTypeNone, progress, error);
             }
         }
     }
@@ -1871,6 +2002,8 @@ Project::addModel(Model *model)
     m_transformModelOrderList.push_back(model);
     m_allModelPtrs.push_back(model);
     addEffectOrderSet(model);
+    /* rigid bodies of the new model may collide with others so all of baked frames are no longer valid */
+    clearBakedPhysicsSimulation();
     eventPublisher()->publishAddModelEvent(model);
     Motion *motion = createMotion();
     undoStackClear(model->undoStack());
@@ -2099,6 +2232,7 @@ Project::addModelMotion(Motion *motion, Model *model)
         }
     }
     motion->initialize(model);
+    model->resolveAllMotionTracks(motion);
     undoStackClear(model->undoStack());
     m_drawable2MotionPtrs.insert(tinystl::make_pair(static_cast<IDrawable *>(model), motion));
     m_allMotions.push_back(motion);
@@ -2119,6 +2253,7 @@ Project::removeModel(Model *model)
     ListUtils::removeItem(model, m_transformModelOrderList);
     IEventPublisher *publisher = eventPublisher();
     if (ListUtils::removeItem(model, m_allModelPtrs)) {
+        clearBakedPhysicsSimulation();
         MotionHashMap::iterator it2 = m_drawable2MotionPtrs.find(model);
         if (it2 != m_drawable2MotionPtrs.end()) {
             Motion *motion = it2->second;
@@ -2345,6 +2480,12 @@ Project::destroyState(SaveState *&state)
 
 void
 Project::writeRedoMessage()
+{
+    writeRedoSavePointMessage(nullptr);
+}
+
+void
+Project::writeRedoSavePointMessage(Nanoem__Project__Project *snapshot)
 {
     const URI &fileURI = this->fileURI();
     Nanoem__Application__SavePointCommand base = NANOEM__APPLICATION__SAVE_POINT_COMMAND__INIT;
@@ -2354,7 +2495,8 @@ Project::writeRedoMessage()
     Nanoem__Application__URI uri = NANOEM__APPLICATION__URI__INIT;
     uri.absolute_path = absolutePath.data();
     uri.fragment = fragment.data();
-    base.file_uri = &uri;
+    /* the checkpoint embeds the project itself instead of the saved file */
+    base.file_uri = snapshot ? nullptr : &uri;
     MutableStringList names, absolutePaths, fragments, boneNames, morphNames;
     nanoem_u32_t handleIndex = 0, stringIndex = 0, boneIndex = 0, morphIndex = 0;
     names.resize(m_allAccessoryPtrs.size() + m_allModelPtrs.size() + m_allMotions.size());
@@ -2426,7 +2568,14 @@ Project::writeRedoMessage()
     command.type_case = NANOEM__APPLICATION__COMMAND__TYPE_SAVE_POINT;
     command.save_point = &base;
     Error ignorable;
-    writeRedoMessage(&command, ignorable);
+    if (snapshot) {
+#if defined(NANOEM_ENABLE_NANOMSG)
+        m_redoJournal->appendCheckpoint(m_actionSequence++, &command, snapshot, ignorable);
+#endif
+    }
+    else {
+        writeRedoMessage(&command, ignorable);
+    }
     handleIndex = 0;
     for (AccessoryList::const_iterator it = m_allAccessoryPtrs.begin(), end = m_allAccessoryPtrs.end(); it != end;
          ++it) {
@@ -2457,14 +2606,8 @@ Project::writeRedoMessage(const Nanoem__Application__Command *command, Error &er
 {
 #if defined(NANOEM_ENABLE_NANOMSG)
     if (!EnumUtils::isEnabled(kLoadingRedoFile, m_stateFlags)) {
-        const URI &fileURI = redoFileURI();
-        if (!fileURI.isEmpty()) {
-            FileWriterScope scope;
-            if (scope.open(fileURI, true, error)) {
-                internal::project::Redo redo(this);
-                nanoem_u32_t sequence = m_actionSequence++;
-                redo.save(scope.writer(), sequence, command, error);
-            }
+        if (internal::project::RedoJournal *journal = redoJournal()) {
+            journal->append(m_actionSequence++, command, error);
         }
     }
 #else
@@ -2472,6 +2615,38 @@ Project::writeRedoMessage(const Nanoem__Application__Command *command, Error &er
 #endif
 }
 
+void
+Project::writeRedoCheckpoint()
+{
+#if defined(NANOEM_ENABLE_NANOMSG)
+    if (m_redoJournal && m_redoJournal->isCheckpointRequired() &&
+        !EnumUtils::isEnabled(kLoadingRedoFile, m_stateFlags)) {
+        /* saving as the native format marks all of them as saved so dirty states must be kept to confirm saving */
+        ModelList dirtyModels;
+        for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+            Model *model = *it;
+            if (model->isDirty()) {
+                dirtyModels.push_back(model);
+            }
+        }
+        const bool cameraDirty = m_camera->isDirty(), lightDirty = m_light->isDirty(),
+                   shadowCameraDirty = m_shadowCamera->isDirty();
+        /* only the state is captured here and the journal packs and compresses it on its own thread */
+        internal::project::Native saver(this);
+        Error error;
+        if (Nanoem__Project__Project *snapshot = saver.capture(internal::project::Native::kFileTypeData, error)) {
+            writeRedoSavePointMessage(snapshot);
+        }
+        for (ModelList::const_iterator it = dirtyModels.begin(), end = dirtyModels.end(); it != end; ++it) {
+            (*it)->setDirty(true);
+        }
+        m_camera->setDirty(cameraDirty);
+        m_light->setDirty(lightDirty);
+        m_shadowCamera->setDirty(shadowCameraDirty);
+    }
+#endif
+}
+
 void
 Project::setWritingRedoMessageDisabled(bool value)
 {
@@ -2678,9 +2853,18 @@ Project::update()
     if (m_skinDeformerFactory) {
         m_skinDeformerFactory->begin();
     }
+    /* only skinning runs concurrently, mapping buffers and soft bodies must be done in serial */
+    ModelList stagingModels;
     for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
         Model *model = *it;
-        model->updateStagingVertexBuffer();
+        if (model->beginStagingVertexBufferUpdate()) {
+            stagingModels.push_back(model);
+        }
+    }
+    m_parallelTaskDispatcher->dispatch(performStagingVertexBufferUpdate, stagingModels.data(), stagingModels.size());
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        Model *model = *it;
+        model->endStagingVertexBufferUpdate();
     }
     for (LoadedEffectSet::const_iterator it = m_loadedEffectSet.begin(), end = m_loadedEffectSet.end(); it != end;
          ++it) {
@@ -2741,6 +2925,7 @@ Project::pushUndo(undo_command_t *command)
     nanoem_assert(!isPlaying(), "must not be called while playing");
     if (!isPlaying()) {
         undoStackPushCommand(undoStack(), command);
+        trimUndoStack(undoStack());
         eventPublisher()->publishPushUndoCommandEvent(command);
     }
     else {
@@ -2748,6 +2933,47 @@ Project::pushUndo(undo_command_t *command)
     }
 }
 
+void
+Project::trimUndoStack(undo_stack_t *stack)
+{
+    /* snapshots are accounted per project so the oldest command is dropped from whichever stack holds it */
+    while (m_undoSnapshotMemory.first > m_undoSnapshotMemory.second) {
+        undo_stack_t *oldestStack = findOldestUndoStack(stack);
+        if (!oldestStack || !undoStackDropOldestCommand(oldestStack)) {
+            break;
+        }
+    }
+}
+
+undo_stack_t *
+Project::findOldestUndoStack(const undo_stack_t *pushedStack)
+{
+    typedef tinystl::vector<undo_stack_t *, TinySTLAllocator> UndoStackList;
+    UndoStackList stacks;
+    stacks.push_back(m_undoStack);
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        Model *model = *it;
+        stacks.push_back(model->undoStack());
+        stacks.push_back(model->editingUndoStack());
+    }
+    undo_stack_t *oldestStack = nullptr;
+    nanoem_u32_t oldestSequence = 0;
+    for (UndoStackList::const_iterator it = stacks.begin(), end = stacks.end(); it != end; ++it) {
+        undo_stack_t *stack = *it;
+        /* the latest command of the pushed stack must be kept to undo */
+        const int minimumOffset = stack == pushedStack ? 1 : 0;
+        if (undoStackGetOffset(stack) > minimumOffset) {
+            const command::BaseUndoCommand *command = static_cast<const command::BaseUndoCommand *>(
+                undoCommandGetOpaqueData(undoStackGetOldestCommand(stack)));
+            if (!oldestStack || command->sequence() < oldestSequence) {
+                oldestStack = stack;
+                oldestSequence = command->sequence();
+            }
+        }
+    }
+    return oldestStack;
+}
+
 bool
 Project::canSeek() const NANOEM_DECL_NOEXCEPT
 {
@@ -2800,16 +3026,155 @@ Project::performPhysicsSimulationOnce()
     internalPerformPhysicsSimulation(physicsSimulationTimeStep());
 }
 
+void
+Project::bakePhysicsSimulation(nanoem_frame_index_t from, nanoem_frame_index_t to)
+{
+    if (isPhysicsSimulationEnabled() && from <= to) {
+        SG_PUSH_GROUPF("Project::bakePhysicsSimulation(from=%d, to=%d)", from, to);
+        const nanoem_frame_index_t frameIndexAt = currentLocalFrameIndex();
+        const nanoem_u32_t fpsRate = preferredMotionFPS() / baseFPS();
+        const nanoem_f32_t delta = fpsRate * physicsSimulationTimeStep();
+        for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+            const Model *model = *it;
+            if (model->isPhysicsSimulationEnabled()) {
+                nanoem_rsize_t numRigidBodies;
+                nanoemModelGetAllRigidBodyObjects(model->data(), &numRigidBodies);
+                m_physicsBakeCache->begin(model->handle(), bakedPhysicsSimulationSignature(model), numRigidBodies);
+            }
+        }
+        /* steps the same as restarting at the first frame and seeking frame by frame while exporting video */
+        synchronizeAllMotions(from, 0, PhysicsEngine::kSimulationTimingBefore);
+        for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+            Model *model = *it;
+            model->initializeAllRigidBodiesTransformFeedback();
+            model->initializeAllSoftBodiesTransformFeedback();
+        }
+        for (nanoem_frame_index_t frameIndex = from; frameIndex <= to; frameIndex++) {
+            if (frameIndex > from) {
+                synchronizeAllMotions(frameIndex, 0, PhysicsEngine::kSimulationTimingBefore);
+            }
+            m_physicsEngine->stepSimulation(frameIndex > from ? delta : physicsSimulationTimeStep());
+            recordBakedPhysicsSimulation(frameIndex);
+            internalSynchronizeAllRigidBodiesFromSimulation();
+            synchronizeAllMotions(frameIndex, 0, PhysicsEngine::kSimulationTimingAfter);
+        }
+        m_physicsBakeCache->commit();
+        m_bakedPhysicsRestored = false;
+        restart(frameIndexAt);
+        SG_POP_GROUP();
+    }
+}
+
+void
+Project::clearBakedPhysicsSimulation()
+{
+    m_physicsBakeCache->clear();
+    m_bakedPhysicsMotionDigests.clear();
+    m_bakedPhysicsModelDigests.clear();
+}
+
+bool
+Project::hasBakedPhysicsSimulation(nanoem_frame_index_t from, nanoem_frame_index_t to) const
+{
+    bool contained = from <= to;
+    for (nanoem_frame_index_t frameIndex = from; contained && frameIndex <= to; frameIndex++) {
+        contained = containsBakedPhysicsSimulation(frameIndex);
+    }
+    return contained;
+}
+
+bool
+Project::hasAnyBakedPhysicsSimulation() const NANOEM_DECL_NOEXCEPT
+{
+    return m_physicsBakeCache->numTracks() > 0;
+}
+
+bool
+Project::loadBakedPhysicsSimulation(IReader *reader, Error &error)
+{
+    /* models sharing the same canonical name cannot be told apart so their tracks are skipped */
+    internal::PhysicsBakeCache::NameHandleMap handles;
+    StringSet duplicatedNames;
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        const Model *model = *it;
+        const String &name = model->canonicalName();
+        if (!handles.insert(tinystl::make_pair(name, model->handle())).second) {
+            duplicatedNames.insert(name);
+        }
+    }
+    for (StringSet::const_iterator it = duplicatedNames.begin(), end = duplicatedNames.end(); it != end; ++it) {
+        handles.erase(handles.find(*it));
+    }
+    m_bakedPhysicsRestored = false;
+    return m_physicsBakeCache->load(reader, handles, error);
+}
+
+bool
+Project::saveBakedPhysicsSimulation(IWriter *writer, Error &error) const
+{
+    internal::PhysicsBakeCache::HandleNameMap names;
+    tinystl::unordered_map<String, nanoem_rsize_t, TinySTLAllocator> numModels;
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        numModels[(*it)->canonicalName()]++;
+    }
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        const Model *model = *it;
+        const String &name = model->canonicalName();
+        if (numModels[name] == 1) {
+            names.insert(tinystl::make_pair(model->handle(), name));
+        }
+    }
+    return m_physicsBakeCache->save(writer, names, error);
+}
+
 void
 Project::synchronizeAllMotions(
     nanoem_frame_index_t frameIndex, nanoem_f32_t amount, PhysicsEngine::SimulationTimingType timing)
 {
+    SynchronizeSkeletonMotionTask task;
     for (ModelList::const_iterator it = m_transformModelOrderList.begin(), end = m_transformModelOrderList.end();
          it != end; ++it) {
         Model *model = *it;
         if (Motion *motion = resolveMotion(model)) {
-            model->synchronizeMotion(motion, frameIndex, amount, timing);
+            if (timing == PhysicsEngine::kSimulationTimingBefore) {
+                model->synchronizeModelMotion(motion, frameIndex);
+            }
+            /* tracks and curves are resolved lazily so resolve them here to avoid resolving them concurrently */
+            model->resolveAllMotionTracks(motion);
+            model->resolveAllBezierCurves(motion, frameIndex);
+            model->resolveAllConstraintJoints();
+            task.m_models.push_back(model);
+            task.m_motions.push_back(motion);
+        }
+    }
+    task.m_frameIndex = frameIndex;
+    task.m_amount = amount;
+    task.m_timing = timing;
+    const nanoem_rsize_t numModels = task.m_models.size();
+    if (numModels > 1) {
+        ModelTransformLevelList levels;
+        computeAllModelTransformLevels(task.m_models, levels);
+        nanoem_rsize_t maxLevel = 0;
+        for (nanoem_rsize_t i = 0; i < numModels; i++) {
+            maxLevel = glm::max(maxLevel, levels[i]);
+        }
+        EnumUtils::setEnabled(kSynchronizingMotionsInParallel, m_stateFlags, true);
+        for (nanoem_rsize_t level = 0; level <= maxLevel; level++) {
+            task.m_offsets.clear();
+            for (nanoem_rsize_t i = 0; i < numModels; i++) {
+                if (levels[i] == level) {
+                    task.m_offsets.push_back(i);
+                }
+            }
+            m_parallelTaskDispatcher->dispatch(SynchronizeSkeletonMotionTask::execute, &task, task.m_offsets.size());
         }
+        EnumUtils::setEnabled(kSynchronizingMotionsInParallel, m_stateFlags, false);
+    }
+    else if (numModels > 0) {
+        task.m_models[0]->synchronizeSkeletonMotion(task.m_motions[0], frameIndex, amount, timing);
+    }
+    for (nanoem_rsize_t i = 0; i < numModels; i++) {
+        task.m_models[i]->synchronizeRigidBodyMotion(task.m_motions[i], frameIndex, timing);
     }
     if (timing == PhysicsEngine::kSimulationTimingAfter) {
         for (AccessoryList::const_iterator it = m_allAccessoryPtrs.begin(), end = m_allAccessoryPtrs.end(); it != end;
@@ -2874,6 +3239,15 @@ Project::sharedImageLoader()
     return m_sharedImageLoader;
 }
 
+internal::FileContentDigestCache *
+Project::fileContentDigestCache()
+{
+    if (!m_fileContentDigestCache) {
+        m_fileContentDigestCache = nanoem_new(internal::FileContentDigestCache);
+    }
+    return m_fileContentDigestCache;
+}
+
 internal::BlitPass *
 Project::sharedImageBlitter()
 {
@@ -3852,7 +4226,15 @@ void
 Project::handleUndoAction()
 {
     if (canUndo()) {
-        undoStackUndo(activeUndoStack());
+        undo_stack_t *stack = activeUndoStack();
+        if (Model *model = activeModel()) {
+            const nanoem_u32_t generation = model->editGeneration();
+            undoStackUndo(stack);
+            model->markAllObjectsEditedIfUntracked(stack, generation);
+        }
+        else {
+            undoStackUndo(stack);
+        }
         eventPublisher()->publishUndoEvent(canUndo(), canRedo());
     }
 }
@@ -3861,7 +4243,15 @@ void
 Project::handleRedoAction()
 {
     if (canRedo()) {
-        undoStackRedo(activeUndoStack());
+        undo_stack_t *stack = activeUndoStack();
+        if (Model *model = activeModel()) {
+            const nanoem_u32_t generation = model->editGeneration();
+            undoStackRedo(stack);
+            model->markAllObjectsEditedIfUntracked(stack, generation);
+        }
+        else {
+            undoStackRedo(stack);
+        }
         eventPublisher()->publishRedoEvent(canRedo(), canUndo());
     }
 }
@@ -4179,6 +4569,14 @@ Project::destroyMotion(Motion *motion)
         if (it != m_motionHandleMap.end()) {
             m_motionHandleMap.erase(it);
         }
+        MotionDigestMap::const_iterator it2 = m_bakedPhysicsMotionDigests.find(motion);
+        if (it2 != m_bakedPhysicsMotionDigests.end()) {
+            m_bakedPhysicsMotionDigests.erase(it2);
+        }
+        MotionUndoSnapshotMap::const_iterator it3 = m_motionUndoSnapshots.find(motion);
+        if (it3 != m_motionUndoSnapshots.end()) {
+            m_motionUndoSnapshots.erase(it3);
+        }
         m_objectHandleAllocator->free(handle);
         nanoem_delete(motion);
     }
@@ -4565,6 +4963,25 @@ Project::resolveDrawable(Motion *motion) NANOEM_DECL_NOEXCEPT
     return drawable;
 }
 
+const BezierCurve *
+Project::resolveBezierCurve(const nanoem_u8_t *parameters, nanoem_frame_index_t interval)
+{
+    /* curves are shared by all motions and cameras with the same control points and keyframe interval */
+    const nanoem_u64_t hash = BezierCurve::toHash(parameters, interval);
+    BezierCurve::Map::const_iterator it = m_bezierCurves.find(hash);
+    BezierCurve *curve = nullptr;
+    if (it != m_bezierCurves.end()) {
+        curve = it->second;
+    }
+    /* the cache is read only while motions are synchronized in parallel as these are resolved beforehand */
+    else if (!EnumUtils::isEnabled(kSynchronizingMotionsInParallel, m_stateFlags)) {
+        const Vector2U8 c0(parameters[0], parameters[1]), c1(parameters[2], parameters[3]);
+        curve = nanoem_new(BezierCurve(c0, c1, interval));
+        m_bezierCurves.insert(tinystl::make_pair(hash, curve));
+    }
+    return curve;
+}
+
 const Motion *
 Project::cameraMotion() const NANOEM_DECL_NOEXCEPT
 {
@@ -4715,9 +5132,56 @@ Project::redoFileURI() const
 void
 Project::setRedoFileURI(const URI &value)
 {
+#if defined(NANOEM_ENABLE_NANOMSG)
+    /* all of pending records are written to the previous file before switching */
+    Error error;
+    flushRedoJournal(error);
+    nanoem_delete_safe(m_redoJournal);
+#endif
     m_redoFileURI = value;
 }
 
+void
+Project::flushRedoJournal(Error &error)
+{
+#if defined(NANOEM_ENABLE_NANOMSG)
+    if (m_redoJournal) {
+        m_redoJournal->flush(error);
+    }
+#else
+    BX_UNUSED_1(error);
+#endif
+}
+
+nanoem_u32_t
+Project::redoCheckpointInterval() const NANOEM_DECL_NOEXCEPT
+{
+    return m_redoCheckpointInterval;
+}
+
+void
+Project::setRedoCheckpointInterval(nanoem_u32_t value)
+{
+    m_redoCheckpointInterval = value;
+#if defined(NANOEM_ENABLE_NANOMSG)
+    if (m_redoJournal) {
+        m_redoJournal->setCheckpointInterval(value);
+    }
+#endif
+}
+
+internal::project::RedoJournal *
+Project::redoJournal()
+{
+#if defined(NANOEM_ENABLE_NANOMSG)
+    if (!m_redoJournal && !m_redoFileURI.isEmpty()) {
+        m_redoJournal = nanoem_new(internal::project::RedoJournal(m_redoFileURI, m_redoCheckpointInterval));
+        m_redoJournal->start();
+    }
+#endif
+    return m_redoJournal;
+}
+
 Vector4SI32
 Project::backgroundVideoRect() const NANOEM_DECL_NOEXCEPT
 {
@@ -5959,6 +6423,68 @@ Project::setCompiledEffectCacheEnabled(bool value)
     }
 }
 
+nanoem_u32_t
+Project::nextUndoSnapshotSequence() NANOEM_DECL_NOEXCEPT
+{
+    return m_undoSnapshotSequence++;
+}
+
+nanoem_u32_t
+Project::nextUndoCommandSequence() NANOEM_DECL_NOEXCEPT
+{
+    return m_undoCommandSequence++;
+}
+
+void
+Project::addUndoSnapshotMemoryUsage(nanoem_rsize_t value) NANOEM_DECL_NOEXCEPT
+{
+    m_undoSnapshotMemory.first += value;
+}
+
+void
+Project::removeUndoSnapshotMemoryUsage(nanoem_rsize_t value) NANOEM_DECL_NOEXCEPT
+{
+    m_undoSnapshotMemory.first -= glm::min(nanoem_u64_t(value), m_undoSnapshotMemory.first);
+}
+
+const ByteArray *
+Project::findMotionUndoSnapshot(const Motion *motion, nanoem_u16_t modelHandle) const NANOEM_DECL_NOEXCEPT
+{
+    MotionUndoSnapshotMap::const_iterator it = m_motionUndoSnapshots.find(motion);
+    const MotionUndoSnapshot *snapshot = it != m_motionUndoSnapshots.end() ? &it->second : nullptr;
+    /* every keyframe command bumps the generation so the snapshot is stale once the motion is edited */
+    return snapshot && snapshot->m_generation == motion->generation() && snapshot->m_modelHandle == modelHandle
+        ? &snapshot->m_bytes
+        : nullptr;
+}
+
+void
+Project::setMotionUndoSnapshot(const Motion *motion, nanoem_u16_t modelHandle, const ByteArray &value)
+{
+    MotionUndoSnapshot &snapshot = m_motionUndoSnapshots[motion];
+    snapshot.m_bytes = value;
+    snapshot.m_generation = motion->generation();
+    snapshot.m_modelHandle = modelHandle;
+}
+
+nanoem_u64_t
+Project::undoSnapshotMemoryUsage() const NANOEM_DECL_NOEXCEPT
+{
+    return m_undoSnapshotMemory.first;
+}
+
+nanoem_u64_t
+Project::undoSnapshotMemoryBudget() const NANOEM_DECL_NOEXCEPT
+{
+    return m_undoSnapshotMemory.second;
+}
+
+void
+Project::setUndoSnapshotMemoryBudget(nanoem_u64_t value)
+{
+    m_undoSnapshotMemory.second = value;
+}
+
 bool
 Project::isViewportCaptured() const NANOEM_DECL_NOEXCEPT
 {
@@ -6172,6 +6698,14 @@ Project::setModelEditingEnabled(bool value)
 {
     Model *model = activeModel();
     if (model && isModelEditingEnabled() != value) {
+        /* rigid bodies and joints may be edited */
+        m_physicsBakeCache->invalidate(model->handle());
+        ModelDigestMap::const_iterator it = m_bakedPhysicsModelDigests.find(model->handle());
+        if (it != m_bakedPhysicsModelDigests.end()) {
+            m_bakedPhysicsModelDigests.erase(it);
+        }
+        /* morphs keep raw pointers to the vertices that may be added or removed while editing */
+        model->invalidateAllMorphVertexDeltas();
         model->rebuildAllVertexBuffers(value ? false : true);
         undoStackClear(model->editingUndoStack());
         EnumUtils::setEnabled(kEnableModelEditing, m_stateFlags, value);
@@ -6675,11 +7209,16 @@ Project::internalSeek(nanoem_frame_index_t frameIndex, nanoem_f32_t amount, nano
         }
         resetTransformPerformedAt();
     }
-    if (frameIndex < currentLocalFrameIndex()) {
+    const bool baked = containsBakedPhysicsSimulation(frameIndex);
+    /* the simulation does not follow replayed frames so it must be restarted when leaving them */
+    if (!baked && (frameIndex < currentLocalFrameIndex() || m_bakedPhysicsRestored)) {
         restart(frameIndex);
     }
     synchronizeAllMotions(frameIndex, amount, PhysicsEngine::kSimulationTimingBefore);
-    internalPerformPhysicsSimulation(delta);
+    m_bakedPhysicsRestored = baked && restoreBakedPhysicsSimulation(frameIndex, amount);
+    if (!m_bakedPhysicsRestored) {
+        internalPerformPhysicsSimulation(delta);
+    }
     synchronizeAllMotions(frameIndex, amount, PhysicsEngine::kSimulationTimingAfter);
     markAllModelsDirty();
     ILight *light = globalLight();
@@ -6751,8 +7290,9 @@ Project::synchronizeLight(nanoem_frame_index_t frameIndex, nanoem_f32_t amount)
 void
 Project::synchronizeSelfShadow(nanoem_frame_index_t frameIndex)
 {
+    nanoem_motion_keyframe_cursor_t *cursor = m_selfShadowKeyframeCursor.resolve(m_selfShadowMotionPtr);
     if (const nanoem_motion_self_shadow_keyframe_t *keyframe =
-            m_selfShadowMotionPtr->findSelfShadowKeyframe(frameIndex)) {
+            nanoemMotionFindSelfShadowKeyframeObjectWithCursor(m_selfShadowMotionPtr->data(), cursor, frameIndex)) {
         m_shadowCamera->setDistance(nanoemMotionSelfShadowKeyframeGetDistance(keyframe));
         m_shadowCamera->setCoverageMode(
             static_cast<ShadowCamera::CoverageModeType>(nanoemMotionSelfShadowKeyframeGetMode(keyframe)));
@@ -6775,16 +7315,145 @@ Project::internalPerformPhysicsSimulation(nanoem_f32_t delta)
 {
     if (isPhysicsSimulationEnabled()) {
         m_physicsEngine->stepSimulation(delta);
-        for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
-            Model *model = *it;
-            if (model->isPhysicsSimulationEnabled()) {
-                model->synchronizeAllRigidBodiesTransformFeedbackFromSimulation(
-                    PhysicsEngine::kRigidBodyFollowBonePerform);
+        internalSynchronizeAllRigidBodiesFromSimulation();
+    }
+}
+
+void
+Project::internalSynchronizeAllRigidBodiesFromSimulation()
+{
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        Model *model = *it;
+        if (model->isPhysicsSimulationEnabled()) {
+            model->synchronizeAllRigidBodiesTransformFeedbackFromSimulation(PhysicsEngine::kRigidBodyFollowBonePerform);
+        }
+    }
+}
+
+void
+Project::recordBakedPhysicsSimulation(nanoem_frame_index_t frameIndex)
+{
+    Matrix4x4List &transforms = m_bakedPhysicsTransforms[0];
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); it != end; ++it) {
+        const Model *model = *it;
+        if (model->isPhysicsSimulationEnabled()) {
+            nanoem_rsize_t numRigidBodies;
+            nanoem_model_rigid_body_t *const *rigidBodies =
+                nanoemModelGetAllRigidBodyObjects(model->data(), &numRigidBodies);
+            transforms.resize(numRigidBodies);
+            for (nanoem_rsize_t i = 0; i < numRigidBodies; i++) {
+                const model::RigidBody *rigidBody = model::RigidBody::cast(rigidBodies[i]);
+                transforms[i] = rigidBody ? rigidBody->worldTransform() : Constants::kIdentity;
             }
+            m_physicsBakeCache->record(model->handle(), frameIndex, transforms.data());
         }
     }
 }
 
+bool
+Project::restoreBakedPhysicsSimulation(nanoem_frame_index_t frameIndex, nanoem_f32_t amount)
+{
+    Matrix4x4List &transforms = m_bakedPhysicsTransforms[0], &nextTransforms = m_bakedPhysicsTransforms[1];
+    bool restored = true;
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); restored && it != end;
+         ++it) {
+        const Model *model = *it;
+        if (model->isPhysicsSimulationEnabled()) {
+            const nanoem_u16_t handle = model->handle();
+            const nanoem_u64_t signature = bakedPhysicsSimulationSignature(model);
+            nanoem_rsize_t numRigidBodies;
+            nanoem_model_rigid_body_t *const *rigidBodies =
+                nanoemModelGetAllRigidBodyObjects(model->data(), &numRigidBodies);
+            transforms.resize(numRigidBodies);
+            nextTransforms.resize(numRigidBodies);
+            restored = m_physicsBakeCache->restore(handle, signature, numRigidBodies, frameIndex, transforms.data());
+            /* the next frame may not be baked at the end of the range so the current frame is used as is */
+            if (restored && amount > 0 &&
+                m_physicsBakeCache->restore(handle, signature, numRigidBodies, frameIndex + 1, nextTransforms.data())) {
+                for (nanoem_rsize_t i = 0; i < numRigidBodies; i++) {
+                    const Matrix4x4 &current = transforms[i], &next = nextTransforms[i];
+                    const Quaternion orientation(glm::slerp(
+                        glm::quat_cast(Matrix3x3(current)), glm::quat_cast(Matrix3x3(next)), amount));
+                    const Vector4 position(glm::mix(current[3], next[3], amount));
+                    transforms[i] = glm::mat4_cast(orientation);
+                    transforms[i][3] = position;
+                }
+            }
+            for (nanoem_rsize_t i = 0; restored && i < numRigidBodies; i++) {
+                if (model::RigidBody *rigidBody = model::RigidBody::cast(rigidBodies[i])) {
+                    rigidBody->setWorldTransform(transforms[i]);
+                }
+            }
+        }
+    }
+    if (restored) {
+        internalSynchronizeAllRigidBodiesFromSimulation();
+    }
+    return restored;
+}
+
+bool
+Project::containsBakedPhysicsSimulation(nanoem_frame_index_t frameIndex) const
+{
+    bool contained = isPhysicsSimulationEnabled() && m_physicsBakeCache->numTracks() > 0;
+    for (ModelList::const_iterator it = m_allModelPtrs.begin(), end = m_allModelPtrs.end(); contained && it != end;
+         ++it) {
+        const Model *model = *it;
+        if (model->isPhysicsSimulationEnabled()) {
+            nanoem_rsize_t numRigidBodies;
+            nanoemModelGetAllRigidBodyObjects(model->data(), &numRigidBodies);
+            contained = m_physicsBakeCache->contains(
+                model->handle(), bakedPhysicsSimulationSignature(model), numRigidBodies, frameIndex);
+        }
+    }
+    return contained;
+}
+
+nanoem_u64_t
+Project::bakedPhysicsSimulationSignature(const Model *model) const
+{
+    nanoem_u64_t signature = internal::PhysicsBakeCache::kInitialDigest;
+    if (const Motion *motion = resolveMotion(model)) {
+        /* digests the content instead of the generation to keep the track after undoing back to the baked motion */
+        MotionDigestMap::const_iterator it = m_bakedPhysicsMotionDigests.find(motion);
+        if (it != m_bakedPhysicsMotionDigests.end() && it->second.first == motion->generation()) {
+            signature = it->second.second;
+        }
+        else {
+            ByteArray bytes;
+            Error error;
+            motion->save(bytes, model,
+                NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_BONE | NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MODEL |
+                    NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MORPH,
+                error);
+            signature = internal::PhysicsBakeCache::digest(bytes.data(), bytes.size(), signature);
+            m_bakedPhysicsMotionDigests[motion] = tinystl::make_pair(motion->generation(), signature);
+        }
+    }
+    const Vector3 direction(m_physicsEngine->direction());
+    const nanoem_f32_t parameters[] = { m_physicsEngine->acceleration(), direction.x, direction.y, direction.z,
+        m_physicsEngine->isNoiseEnabled() ? m_physicsEngine->noise() : 0.0f,
+        m_physicsEngine->isGroundEnabled() ? 1.0f : 0.0f, physicsSimulationTimeStep() };
+    signature = internal::PhysicsBakeCache::digest(parameters, sizeof(parameters), signature);
+    /*
+     * rigid bodies and joints may be edited while the number of them is unchanged. they can be edited only in the
+     * model editing mode so the digest is cached until the mode is toggled and computed every time while editing
+     */
+    const nanoem_u16_t handle = model->handle();
+    ModelDigestMap::const_iterator it = m_bakedPhysicsModelDigests.find(handle);
+    nanoem_u64_t modelDigest;
+    if (it != m_bakedPhysicsModelDigests.end()) {
+        modelDigest = it->second;
+    }
+    else {
+        modelDigest = digestAllRigidBodiesAndJoints(model->data(), internal::PhysicsBakeCache::kInitialDigest);
+        if (!(isModelEditingEnabled() && model == activeModel())) {
+            m_bakedPhysicsModelDigests.insert(tinystl::make_pair(handle, modelDigest));
+        }
+    }
+    return internal::PhysicsBakeCache::digest(&modelDigest, sizeof(modelDigest), signature);
+}
+
 void
 Project::removeDrawable(IDrawable *drawable)
 {
@@ -7235,68 +7904,44 @@ Project::internalAttachOffscreenRenderTargetEffect(IDrawable *drawable, Effect *
     }
 }
 
-URI
-Project::resolveSourceEffectCachePath(const URI &fileURI)
-{
-    nanoem_u8_t digest[SHA256_BLOCK_SIZE];
-    char buffer[40];
-    const String &filePath = fileURI.absolutePath();
-    SHA256_CTX ctx;
-    sha256_init(&ctx);
-    nanoem_u32_t renderer = static_cast<nanoem_u32_t>(sg::query_backend());
-    sha256_update(&ctx, reinterpret_cast<const nanoem_u8_t *>(&renderer), sizeof(renderer));
-    sha256_update(
-        &ctx, reinterpret_cast<const nanoem_u8_t *>(filePath.c_str()), Inline::saturateInt32(filePath.size()));
-    sha256_final(&ctx, digest);
-    for (nanoem_rsize_t i = 0; i < BX_COUNTOF(digest); i++) {
-        nanoem_rsize_t offset = 2 * i;
-        StringUtils::format(buffer + offset, Inline::saturateInt32(sizeof(buffer) - offset), "%02x", digest[i]);
-    }
-    const URI &directoryURI = m_fileManager->sharedSourceEffectCacheDirectory();
-    String cachePath(directoryURI.absolutePath());
-    cachePath.append("/");
-    cachePath.append(buffer);
-    return URI::createFromFilePath(cachePath);
+effect::SourceCache *
+Project::sharedSourceEffectCache()
+{
+    if (!m_sourceEffectCache) {
+        const URI &directoryURI = m_fileManager->sharedSourceEffectCacheDirectory();
+        if (!directoryURI.isEmpty()) {
+            m_sourceEffectCache = nanoem_new(effect::SourceCache(directoryURI, m_translator));
+            const JSON_Object *config = json_object(m_applicationConfiguration);
+            const nanoem_f64_t capacity = json_object_dotget_number(config, "plugin.effect.cache.capacity");
+            if (capacity > 0) {
+                m_sourceEffectCache->setCapacity(static_cast<nanoem_u64_t>(capacity * 1024 * 1024));
+            }
+        }
+    }
+    if (m_sourceEffectCache) {
+        /* the compiler binary and its options change the output so they are parts of the digest */
+        const plugin::EffectPlugin *plugin = m_fileManager->sharedEffectPlugin();
+        const nanoem_u64_t revision = plugin ? plugin->revision() : 0;
+        char environment[Inline::kLongNameStackBufferSize];
+        StringUtils::format(environment, sizeof(environment), "backend=%d;mipmap=%d;compiler=%08x%08x",
+            sg::query_backend(), isMipmapEnabled(), static_cast<nanoem_u32_t>(revision >> 32),
+            static_cast<nanoem_u32_t>(revision));
+        m_sourceEffectCache->setEnvironment(environment);
+    }
+    return m_sourceEffectCache;
 }
 
 bool
 Project::findSourceEffectCache(const URI &fileURI, ByteArray &cache, Error &error)
 {
     const String &extension = fileURI.pathExtension();
+    bool found = false;
     if (!Accessory::isLoadableExtension(extension) && !Model::isLoadableExtension(extension)) {
-        const URI &cacheURI = resolveSourceEffectCachePath(fileURI);
-        FileReaderScope scope(m_translator);
-        if (scope.open(cacheURI, error)) {
-            ByteArray deflated;
-            nanoem_u32_t signature, inflatedSize, deflatedSize;
-            IFileReader *reader = scope.reader();
-            FileUtils::readTyped(reader, signature, error);
-            if (signature == nanoem_fourcc('n', 'm', 'C', 'E')) {
-                FileUtils::readTyped(reader, inflatedSize, error);
-                FileUtils::readTyped(reader, deflatedSize, error);
-                deflated.resize(deflatedSize);
-                cache.resize(inflatedSize);
-                nanoem_u8_t expectedDigest[SHA256_BLOCK_SIZE];
-                FileUtils::readTyped(reader, expectedDigest, error);
-                FileUtils::read(reader, deflated.data(), deflatedSize, error);
-                SHA256_CTX ctx;
-                sha256_init(&ctx);
-                nanoem_u64_t timestamp = FileUtils::timestamp(fileURI);
-                sha256_update(&ctx, reinterpret_cast<const nanoem_u8_t *>(&timestamp), sizeof(timestamp));
-                sha256_update(&ctx, deflated.data(), deflatedSize);
-                nanoem_u8_t actualDigest[SHA256_BLOCK_SIZE];
-                sha256_final(&ctx, actualDigest);
-                if (memcmp(actualDigest, expectedDigest, BX_COUNTOF(actualDigest)) == 0) {
-                    int actualSize = LZ4_decompress_safe(reinterpret_cast<const char *>(deflated.data()),
-                        reinterpret_cast<char *>(cache.data()), deflatedSize, inflatedSize);
-                    if (actualSize < 0 || Inline::saturateInt32U(actualSize) != inflatedSize) {
-                        cache.resize(0);
-                    }
-                }
-            }
+        if (effect::SourceCache *cachePtr = sharedSourceEffectCache()) {
+            found = cachePtr->find(fileURI, cache, error);
         }
     }
-    return !error.hasReason() && !cache.empty();
+    return found;
 }
 
 void
@@ -7304,29 +7949,8 @@ Project::setSourceEffectCache(const URI &fileURI, const ByteArray &cache, Error
 {
     const String &extension = fileURI.pathExtension();
     if (!Accessory::isLoadableExtension(extension) && !Model::isLoadableExtension(extension)) {
-        FileWriterScope scope;
-        if (scope.open(resolveSourceEffectCachePath(fileURI), error)) {
-            ByteArray deflated;
-            int inflatedSize = Inline::saturateInt32(cache.size());
-            deflated.reserve(LZ4_compressBound(inflatedSize));
-            int deflatedSize = LZ4_compress_fast(reinterpret_cast<const char *>(cache.data()),
-                reinterpret_cast<char *>(deflated.data()), inflatedSize, Inline::saturateInt32(deflated.capacity()), 1);
-            if (deflatedSize > 0) {
-                SHA256_CTX ctx;
-                sha256_init(&ctx);
-                nanoem_u64_t timestamp = FileUtils::timestamp(fileURI);
-                sha256_update(&ctx, reinterpret_cast<const nanoem_u8_t *>(&timestamp), sizeof(timestamp));
-                sha256_update(&ctx, deflated.data(), deflatedSize);
-                nanoem_u8_t digest[SHA256_BLOCK_SIZE];
-                sha256_final(&ctx, digest);
-                ISeekableWriter *writer = scope.writer();
-                FileUtils::write(writer, nanoem_fourcc('n', 'm', 'C', 'E'), error);
-                FileUtils::write(writer, Inline::saturateInt32U(inflatedSize), error);
-                FileUtils::write(writer, Inline::saturateInt32U(deflatedSize), error);
-                FileUtils::write(writer, digest, BX_COUNTOF(digest), error);
-                FileUtils::write(writer, deflated.data(), deflatedSize, error);
-                scope.commit(error);
-            }
+        if (effect::SourceCache *cachePtr = sharedSourceEffectCache()) {
+            cachePtr->save(fileURI, cache, error);
         }
     }
 }
@@ -79,8 +79,18 @@ ThreadedApplicationClient::receiveAllEventMessages()
                 break;
             }
             else {
+                nanoem_u64_t timestamp = 0;
                 receivedBodySize = size_t(rc);
-                dispatchEventMessage(body, receivedBodySize);
+                if (internal::MessageBatch::dispatchAll(body, receivedBodySize, handleEventMessage, this, &timestamp)) {
+                    const nanoem_u64_t latency = stm_since(timestamp);
+                    m_eventStatistics.m_numBatches++;
+                    m_eventStatistics.m_totalLatency += latency;
+                    m_eventStatistics.m_maxLatency = glm::max(m_eventStatistics.m_maxLatency, latency);
+                }
+                else {
+                    dispatchEventMessage(body, receivedBodySize);
+                    m_eventStatistics.m_numMessages++;
+                }
                 nn_freemsg(body);
                 nn_freemsg(control);
             }
@@ -101,6 +111,20 @@ ThreadedApplicationClient::close()
     }
 }
 
+const internal::MessageBatch::Statistics &
+ThreadedApplicationClient::eventStatistics() const NANOEM_DECL_NOEXCEPT
+{
+    return m_eventStatistics;
+}
+
+void
+ThreadedApplicationClient::handleEventMessage(void *userData, const nanoem_u8_t *data, size_t size)
+{
+    ThreadedApplicationClient *self = static_cast<ThreadedApplicationClient *>(userData);
+    self->dispatchEventMessage(data, size);
+    self->m_eventStatistics.m_numMessages++;
+}
+
 void
 ThreadedApplicationClient::sendCommandMessage(const Nanoem__Application__Command *command)
 {
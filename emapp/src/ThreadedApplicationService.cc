@@ -74,7 +74,7 @@ struct RecoveryCallbackArgument {
 struct RecoveryWorker : tbb::task {
     static IModalDialog *cancel(void *userData, Project *project);
 
-    RecoveryWorker(ThreadedApplicationService *service, Project *project, const URI &fileURI);
+    RecoveryWorker(ThreadedApplicationService *service, Project *project, const URI &fileURI, nanoem_i64_t offset);
     ~RecoveryWorker() NANOEM_DECL_NOEXCEPT;
 
     tbb::task *execute();
@@ -84,6 +84,7 @@ struct RecoveryWorker : tbb::task {
     IModalDialog *m_dialog;
     bx::Thread m_thread;
     URI m_fileURI;
+    nanoem_i64_t m_offset;
     bool m_cancelled;
 };
 
@@ -95,11 +96,13 @@ RecoveryWorker::cancel(void *userData, Project * /* project */)
     return nullptr;
 }
 
-RecoveryWorker::RecoveryWorker(ThreadedApplicationService *service, Project *project, const URI &fileURI)
+RecoveryWorker::RecoveryWorker(
+    ThreadedApplicationService *service, Project *project, const URI &fileURI, nanoem_i64_t offset)
     : m_service(service)
     , m_project(project)
     , m_dialog(nullptr)
     , m_fileURI(fileURI)
+    , m_offset(offset)
     , m_cancelled(false)
 {
 }
@@ -115,7 +118,7 @@ RecoveryWorker::execute()
     Error error;
     if (scope.open(m_fileURI, error)) {
         internal::project::Redo redo(m_project);
-        redo.loadAllAsync(scope.reader(), m_dialog, &m_cancelled, error);
+        redo.loadAllAsync(scope.reader(), m_offset, m_dialog, &m_cancelled, error);
     }
     if (!m_cancelled) {
         m_service->clearAllModalDialog();
@@ -404,6 +407,7 @@ ThreadedApplicationService::run()
         executeRunUnit(exitCode);
     }
     handleDestructApplicationThread();
+    flushAllEventMessages();
     return exitCode;
 }
 
@@ -443,6 +447,13 @@ ThreadedApplicationService::setNativeSwapChainDescription(void *opaque)
     m_nativeSwapChainDescription = opaque;
 }
 
+internal::MessageBatch::Statistics
+ThreadedApplicationService::eventStatistics() const
+{
+    bx::MutexScope locker(m_eventBatchLock);
+    return m_eventStatistics;
+}
+
 URI
 ThreadedApplicationService::recoverableRedoFileURI() const
 {
@@ -480,6 +491,11 @@ ThreadedApplicationService::executeRunUnit(int &exitCode)
 {
     drawDefaultPass();
     receiveAllCommandMessages(exitCode);
+    if (Project *project = projectHolder()->currentProject()) {
+        /* all commands of the frame are done here so the snapshot is consistent with the written records */
+        project->writeRedoCheckpoint();
+    }
+    flushAllEventMessages();
 }
 
 int
@@ -577,20 +593,15 @@ ThreadedApplicationService::handleCommandMessage(Nanoem__Application__Command *c
 void
 ThreadedApplicationService::sendEventMessage(const Nanoem__Application__Event *event)
 {
-    size_t size = nanoem__application__event__get_packed_size(event);
-    nanoem_u8_t stackBuffer[128];
-    void *msg = nn_allocmsg(size, 0);
-    if (size < sizeof(stackBuffer)) {
-        nanoem__application__event__pack(event, stackBuffer);
-        memcpy(msg, stackBuffer, size);
-    }
-    else {
-        ByteArray heapBuffer(size);
-        nanoem__application__event__pack(event, heapBuffer.data());
-        memcpy(msg, heapBuffer.data(), size);
+    /* events are sent at once by flushAllEventMessages per frame and might be sent from the worker thread */
+    const size_t size = nanoem__application__event__get_packed_size(event);
+    {
+        bx::MutexScope locker(m_eventBatchLock);
+        nanoem__application__event__pack(event, m_eventBatch.allocate(size, coalescingKey(event)));
     }
-    if (nn_send(m_eventStreamSocket, &msg, NN_MSG, 0) < 0) {
-        handleSocketError("nn_send");
+    /* no frame runs while deactivated so events are sent immediately */
+    if ((m_recvmsgFlags & NN_DONTWAIT) == 0) {
+        flushAllEventMessages();
     }
 }
 
@@ -613,6 +624,30 @@ ThreadedApplicationService::handleAcceptOnRecovery(void *userData, Project * /*
     return dialog;
 }
 
+nanoem_u32_t
+ThreadedApplicationService::coalescingKey(const Nanoem__Application__Event *event) NANOEM_DECL_NOEXCEPT
+{
+    nanoem_u32_t key = 0;
+    /* responses to the request must be delivered each so only notifications replaced by the latest one are merged */
+    if (event->requested_timestamp == 0) {
+        switch (event->type_case) {
+        case NANOEM__APPLICATION__EVENT__TYPE_UNDO_CHANGE:
+        case NANOEM__APPLICATION__EVENT__TYPE_SEEK:
+        case NANOEM__APPLICATION__EVENT__TYPE_UPDATE_PROGRESS:
+        case NANOEM__APPLICATION__EVENT__TYPE_CAN_COPY_EVENT:
+        case NANOEM__APPLICATION__EVENT__TYPE_CAN_PASTE_EVENT:
+        case NANOEM__APPLICATION__EVENT__TYPE_SET_WINDOW_DEVICE_PIXEL_RATIO_EVENT:
+        case NANOEM__APPLICATION__EVENT__TYPE_SET_VIEWPORT_DEVICE_PIXEL_RATIO_EVENT: {
+            key = nanoem_u32_t(event->type_case);
+            break;
+        }
+        default:
+            break;
+        }
+    }
+    return key;
+}
+
 ICancelPublisher *
 ThreadedApplicationService::createCancelPublisher()
 {
@@ -628,6 +663,10 @@ ThreadedApplicationService::receiveAllCommandMessages(int &exitCode)
         void *control = nullptr;
         struct nn_msghdr hdr = { &iov, 1, &control, NN_MSG };
         size_t receivedBodySize;
+        if ((m_recvmsgFlags & NN_DONTWAIT) == 0) {
+            /* pending events must be sent before blocking to wait next command */
+            flushAllEventMessages();
+        }
         int rc = nn_recvmsg(m_commandStreamSocket, &hdr, m_recvmsgFlags);
         if (rc < 0) {
             if (nn_errno() != EAGAIN) {
@@ -653,6 +692,24 @@ ThreadedApplicationService::handleSocketError(const char *prefix)
     bx::debugPrintf("%s -> %d: %s\n", prefix, err, nn_strerror(err));
 }
 
+void
+ThreadedApplicationService::flushAllEventMessages()
+{
+    bx::MutexScope locker(m_eventBatchLock);
+    if (!m_eventBatch.isEmpty() && m_eventStreamSocket != -1) {
+        const nanoem_rsize_t size = m_eventBatch.encodedSize();
+        m_eventStatistics.m_numBatches++;
+        m_eventStatistics.m_numMessages += m_eventBatch.numMessages();
+        m_eventStatistics.m_numCoalescedMessages += m_eventBatch.numCoalescedMessages();
+        void *msg = nn_allocmsg(size, 0);
+        m_eventBatch.encode(stm_now(), static_cast<nanoem_u8_t *>(msg));
+        if (nn_send(m_eventStreamSocket, &msg, NN_MSG, 0) < 0) {
+            handleSocketError("nn_send");
+            nn_freemsg(msg);
+        }
+    }
+}
+
 void
 ThreadedApplicationService::closeAllSockets()
 {
@@ -680,8 +737,18 @@ ThreadedApplicationService::startRecoveryFromRedo(const URI &fileURI)
     const ITranslator *tr = translator();
     const String &title = tr->translate("nanoem.window.dialog.redo.progress.title");
     const String &message = tr->translate("nanoem.window.dialog.redo.progress.message");
-    RecoveryWorker *worker =
-        new (tbb::task::allocate_root()) RecoveryWorker(this, projectHolder()->currentProject(), fileURI);
+    Project *project = projectHolder()->currentProject();
+    nanoem_i64_t offset = 0;
+    {
+        /* the checkpoint replaces the project so it must be restored here and the worker replays only the tail */
+        FileReaderScope scope(translator());
+        Error error;
+        if (scope.open(fileURI, error)) {
+            internal::project::Redo redo(project);
+            offset = redo.restoreCheckpoint(scope.reader(), this, error);
+        }
+    }
+    RecoveryWorker *worker = new (tbb::task::allocate_root()) RecoveryWorker(this, project, fileURI, offset);
     worker->m_dialog = ModalDialogFactory::createProgressDialog(this, title, message, RecoveryWorker::cancel, worker);
     tbb::task::spawn(*worker);
     IModalDialog *dialog = nullptr;
@@ -37,6 +37,7 @@ struct MOObject : public BaseModelObjectCommand::Object {
     {
         return m_undoFunction;
     }
+    virtual Model::EditObjectType editObjectType() const = 0;
     const BaseModelObjectCommand::Function m_undoFunction;
     const BaseModelObjectCommand::Function m_redoFunction;
     void *m_opaque;
@@ -58,6 +59,11 @@ struct MOModel : MOObject {
     {
         nanoemMutableModelDestroy(static_cast<nanoem_mutable_model_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeModel;
+    }
 };
 
 struct MOVertex : MOObject {
@@ -77,6 +83,11 @@ struct MOVertex : MOObject {
     {
         nanoemMutableModelVertexDestroy(static_cast<nanoem_mutable_model_vertex_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeVertex;
+    }
 };
 
 struct MOMaterial : MOObject {
@@ -96,6 +107,11 @@ struct MOMaterial : MOObject {
     {
         nanoemMutableModelMaterialDestroy(static_cast<nanoem_mutable_model_material_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeMaterial;
+    }
 };
 
 struct MOBone : MOObject {
@@ -115,6 +131,11 @@ struct MOBone : MOObject {
     {
         nanoemMutableModelBoneDestroy(static_cast<nanoem_mutable_model_bone_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeBone;
+    }
 };
 
 struct MOMorph : MOObject {
@@ -134,6 +155,11 @@ struct MOMorph : MOObject {
     {
         nanoemMutableModelMorphDestroy(static_cast<nanoem_mutable_model_morph_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeMorph;
+    }
 };
 
 struct MOLabel : MOObject {
@@ -153,6 +179,11 @@ struct MOLabel : MOObject {
     {
         nanoemMutableModelLabelDestroy(static_cast<nanoem_mutable_model_label_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeLabel;
+    }
 };
 
 struct MORigidBody : MOObject {
@@ -173,6 +204,11 @@ struct MORigidBody : MOObject {
     {
         nanoemMutableModelRigidBodyDestroy(static_cast<nanoem_mutable_model_rigid_body_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeRigidBody;
+    }
 };
 
 struct MOJoint : MOObject {
@@ -192,6 +228,11 @@ struct MOJoint : MOObject {
     {
         nanoemMutableModelJointDestroy(static_cast<nanoem_mutable_model_joint_t *>(opaque));
     }
+    Model::EditObjectType
+    editObjectType() const NANOEM_DECL_OVERRIDE
+    {
+        return Model::kEditObjectTypeJoint;
+    }
 };
 }
 
@@ -408,6 +449,7 @@ BaseModelObjectCommand::ExecutionBlock::execute(const Value &v, const Function &
         break;
     }
     object->destroyOpaque(opaque);
+    m_model->markObjectEdited(object->editObjectType(), object->m_opaque);
     m_model->setDirty(true);
 }
 
@@ -8,6 +8,7 @@
 
 #include "emapp/Accessory.h"
 #include "emapp/EnumUtils.h"
+#include "emapp/IMotionKeyframeSelection.h"
 #include "emapp/private/CommonInclude.h"
 
 #include "../CommandMessage.inl"
@@ -115,6 +116,7 @@ BaseShiftingAllKeyframesCommand::shiftAllKeyframesBackward(Error &error)
         }
         nanoemMutableMotionSortAllKeyframes(mutableMotion);
         nanoemMutableMotionDestroy(mutableMotion);
+        m_motion->selection()->shiftAllKeyframes(m_types, m_localFrameIndex, 1);
         m_motion->setDirty(true);
         assignError(status, error);
     }
@@ -149,6 +151,8 @@ BaseShiftingAllKeyframesCommand::shiftAllKeyframesForward(Error &error)
         }
         nanoemMutableMotionSortAllKeyframes(mutableMotion);
         nanoemMutableMotionDestroy(mutableMotion);
+        /* selection of removed keyframes at the frame index is dropped and the rest follows shifted keyframes */
+        m_motion->selection()->shiftAllKeyframes(m_types, m_localFrameIndex + 1, -1);
         m_motion->setDirty(true);
         assignError(status, error);
     }
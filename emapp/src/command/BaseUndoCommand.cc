@@ -10,6 +10,7 @@
 #include "../protoc/command.pb-c.h"
 #include "emapp/Error.h"
 #include "emapp/Project.h"
+#include "emapp/command/SnapshotDelta.h"
 #include "emapp/private/CommonInclude.h"
 
 #include "lz4/lib/lz4.h"
@@ -62,8 +63,92 @@ BaseUndoCommand::LZ4Data::inflate(ProtobufCBinaryData *binary) const
     return result;
 }
 
+BaseUndoCommand::SnapshotData::SnapshotData()
+    : m_checkpoint(true)
+{
+    m_forward.m_inflatedSize = m_backward.m_inflatedSize = 0;
+}
+
+void
+BaseUndoCommand::SnapshotData::save(const ByteArray &last, const ByteArray &current, bool checkpoint)
+{
+    if (!checkpoint) {
+        ByteArray forward, backward;
+        SnapshotDelta::encode(last, current, forward);
+        SnapshotDelta::encode(current, last, backward);
+        checkpoint = forward.size() + backward.size() > (last.size() + current.size()) / 2;
+        if (!checkpoint) {
+            m_forward.deflate(forward);
+            m_backward.deflate(backward);
+        }
+    }
+    if (checkpoint) {
+        m_forward.deflate(current);
+        m_backward.deflate(last);
+    }
+    m_checkpoint = checkpoint;
+}
+
+bool
+BaseUndoCommand::SnapshotData::restoreLast(const ByteArray &current, ByteArray &output) const
+{
+    bool result = false;
+    if (m_checkpoint) {
+        result = m_backward.inflate(output);
+    }
+    else {
+        ByteArray delta;
+        result = m_backward.inflate(delta) && SnapshotDelta::decode(current, delta, output);
+    }
+    return result;
+}
+
+bool
+BaseUndoCommand::SnapshotData::restoreCurrent(const ByteArray &last, ByteArray &output) const
+{
+    bool result = false;
+    if (m_checkpoint) {
+        result = m_forward.inflate(output);
+    }
+    else {
+        ByteArray delta;
+        result = m_forward.inflate(delta) && SnapshotDelta::decode(last, delta, output);
+    }
+    return result;
+}
+
+bool
+BaseUndoCommand::SnapshotData::restoreAll(const ByteArray &present, ByteArray &last, ByteArray &current) const
+{
+    bool result = false;
+    if (restoreLast(present, last)) {
+        current = present;
+        result = true;
+    }
+    else if (restoreCurrent(present, current)) {
+        last = present;
+        result = true;
+    }
+    return result;
+}
+
+void
+BaseUndoCommand::SnapshotData::copy(const ByteArray &bytes, ProtobufCBinaryData *binary)
+{
+    binary->data = new nanoem_u8_t[bytes.size()];
+    memcpy(binary->data, bytes.data(), bytes.size());
+    binary->len = bytes.size();
+}
+
+nanoem_rsize_t
+BaseUndoCommand::SnapshotData::memoryUsage() const NANOEM_DECL_NOEXCEPT
+{
+    return m_forward.m_deflatedBytes.size() + m_backward.m_deflatedBytes.size();
+}
+
 BaseUndoCommand::BaseUndoCommand(Project *project)
     : m_project(project)
+    , m_sequence(project ? project->nextUndoCommandSequence() : 0)
 {
 }
 
@@ -79,6 +164,12 @@ BaseUndoCommand::currentProject()
     return m_project;
 }
 
+nanoem_u32_t
+BaseUndoCommand::sequence() const NANOEM_DECL_NOEXCEPT
+{
+    return m_sequence;
+}
+
 undo_command_t *
 BaseUndoCommand::createCommand(bool enablePersistence)
 {
@@ -54,13 +54,15 @@ nanoem::command::ScopedMutableModel::operator nanoem_mutable_model_t *() NANOEM_
 
 ScopedMutableVertex::ScopedMutableVertex(Model *model)
     : m_vertex(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_vertex = nanoemMutableModelVertexCreate(model->data(), &status);
 }
 
-ScopedMutableVertex::ScopedMutableVertex(nanoem_model_vertex_t *vertexPtr)
+ScopedMutableVertex::ScopedMutableVertex(Model *model, nanoem_model_vertex_t *vertexPtr)
     : m_vertex(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_vertex = nanoemMutableModelVertexCreateAsReference(vertexPtr, &status);
@@ -68,6 +70,9 @@ ScopedMutableVertex::ScopedMutableVertex(nanoem_model_vertex_t *vertexPtr)
 
 ScopedMutableVertex::~ScopedMutableVertex() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeVertex, nanoemMutableModelVertexGetOriginObject(m_vertex));
+    }
     nanoemMutableModelVertexDestroy(m_vertex);
     m_vertex = nullptr;
 }
@@ -79,13 +84,15 @@ nanoem::command::ScopedMutableVertex::operator nanoem_mutable_model_vertex_t *()
 
 ScopedMutableMaterial::ScopedMutableMaterial(Model *model)
     : m_material(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_material = nanoemMutableModelMaterialCreate(model->data(), &status);
 }
 
-ScopedMutableMaterial::ScopedMutableMaterial(nanoem_model_material_t *materialPtr)
+ScopedMutableMaterial::ScopedMutableMaterial(Model *model, nanoem_model_material_t *materialPtr)
     : m_material(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_material = nanoemMutableModelMaterialCreateAsReference(materialPtr, &status);
@@ -93,6 +100,10 @@ ScopedMutableMaterial::ScopedMutableMaterial(nanoem_model_material_t *materialPt
 
 ScopedMutableMaterial::~ScopedMutableMaterial() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(
+            Model::kEditObjectTypeMaterial, nanoemMutableModelMaterialGetOriginObject(m_material));
+    }
     nanoemMutableModelMaterialDestroy(m_material);
     m_material = nullptr;
 }
@@ -104,13 +115,15 @@ nanoem::command::ScopedMutableMaterial::operator nanoem_mutable_model_material_t
 
 ScopedMutableBone::ScopedMutableBone(Model *model)
     : m_bone(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_bone = nanoemMutableModelBoneCreate(model->data(), &status);
 }
 
-ScopedMutableBone::ScopedMutableBone(nanoem_model_bone_t *bonePtr)
+ScopedMutableBone::ScopedMutableBone(Model *model, nanoem_model_bone_t *bonePtr)
     : m_bone(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_bone = nanoemMutableModelBoneCreateAsReference(bonePtr, &status);
@@ -118,6 +131,9 @@ ScopedMutableBone::ScopedMutableBone(nanoem_model_bone_t *bonePtr)
 
 ScopedMutableBone::~ScopedMutableBone() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeBone, nanoemMutableModelBoneGetOriginObject(m_bone));
+    }
     nanoemMutableModelBoneDestroy(m_bone);
     m_bone = nullptr;
 }
@@ -129,13 +145,15 @@ nanoem::command::ScopedMutableBone::operator nanoem_mutable_model_bone_t *() NAN
 
 ScopedMutableConstraint::ScopedMutableConstraint(Model *model)
     : m_constraint(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_constraint = nanoemMutableModelConstraintCreate(model->data(), &status);
 }
 
-ScopedMutableConstraint::ScopedMutableConstraint(nanoem_model_constraint_t *constraintPtr)
+ScopedMutableConstraint::ScopedMutableConstraint(Model *model, nanoem_model_constraint_t *constraintPtr)
     : m_constraint(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_constraint = nanoemMutableModelConstraintCreateAsReference(constraintPtr, &status);
@@ -143,6 +161,10 @@ ScopedMutableConstraint::ScopedMutableConstraint(nanoem_model_constraint_t *cons
 
 ScopedMutableConstraint::~ScopedMutableConstraint() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(
+            Model::kEditObjectTypeBone, nanoemMutableModelConstraintGetOriginObject(m_constraint));
+    }
     nanoemMutableModelConstraintDestroy(m_constraint);
     m_constraint = nullptr;
 }
@@ -152,8 +174,9 @@ nanoem::command::ScopedMutableConstraint::operator nanoem_mutable_model_constrai
     return m_constraint;
 }
 
-ScopedMutableConstraintJoint::ScopedMutableConstraintJoint(nanoem_model_constraint_joint_t *jointPtr)
+ScopedMutableConstraintJoint::ScopedMutableConstraintJoint(Model *model, nanoem_model_constraint_joint_t *jointPtr)
     : m_joint(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_joint = nanoemMutableModelConstraintJointCreateAsReference(jointPtr, &status);
@@ -161,6 +184,10 @@ ScopedMutableConstraintJoint::ScopedMutableConstraintJoint(nanoem_model_constrai
 
 ScopedMutableConstraintJoint::~ScopedMutableConstraintJoint() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(
+            Model::kEditObjectTypeBone, nanoemMutableModelConstraintJointGetOriginObject(m_joint));
+    }
     nanoemMutableModelConstraintJointDestroy(m_joint);
     m_joint = nullptr;
 }
@@ -172,13 +199,15 @@ nanoem::command::ScopedMutableConstraintJoint::operator nanoem_mutable_model_con
 
 ScopedMutableMorph::ScopedMutableMorph(Model *model)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphCreate(model->data(), &status);
 }
 
-ScopedMutableMorph::ScopedMutableMorph(nanoem_model_morph_t *morphPtr)
+ScopedMutableMorph::ScopedMutableMorph(Model *model, nanoem_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphCreateAsReference(morphPtr, &status);
@@ -186,6 +215,9 @@ ScopedMutableMorph::ScopedMutableMorph(nanoem_model_morph_t *morphPtr)
 
 ScopedMutableMorph::~ScopedMutableMorph() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -197,13 +229,15 @@ nanoem::command::ScopedMutableMorph::operator nanoem_mutable_model_morph_t *() N
 
 ScopedMutableMorphBone::ScopedMutableMorphBone(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphBoneCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphBone::ScopedMutableMorphBone(nanoem_model_morph_bone_t *morphPtr)
+ScopedMutableMorphBone::ScopedMutableMorphBone(Model *model, nanoem_model_morph_bone_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphBoneCreateAsReference(morphPtr, &status);
@@ -211,6 +245,9 @@ ScopedMutableMorphBone::ScopedMutableMorphBone(nanoem_model_morph_bone_t *morphP
 
 ScopedMutableMorphBone::~ScopedMutableMorphBone() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphBoneGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphBoneDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -222,13 +259,15 @@ nanoem::command::ScopedMutableMorphBone::operator nanoem_mutable_model_morph_bon
 
 ScopedMutableMorphFlip::ScopedMutableMorphFlip(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphFlipCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphFlip::ScopedMutableMorphFlip(nanoem_model_morph_flip_t *morphPtr)
+ScopedMutableMorphFlip::ScopedMutableMorphFlip(Model *model, nanoem_model_morph_flip_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphFlipCreateAsReference(morphPtr, &status);
@@ -236,6 +275,9 @@ ScopedMutableMorphFlip::ScopedMutableMorphFlip(nanoem_model_morph_flip_t *morphP
 
 ScopedMutableMorphFlip::~ScopedMutableMorphFlip() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphFlipGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphFlipDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -247,13 +289,15 @@ nanoem::command::ScopedMutableMorphFlip::operator nanoem_mutable_model_morph_fli
 
 ScopedMutableMorphGroup::ScopedMutableMorphGroup(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphGroupCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphGroup::ScopedMutableMorphGroup(nanoem_model_morph_group_t *morphPtr)
+ScopedMutableMorphGroup::ScopedMutableMorphGroup(Model *model, nanoem_model_morph_group_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphGroupCreateAsReference(morphPtr, &status);
@@ -261,6 +305,9 @@ ScopedMutableMorphGroup::ScopedMutableMorphGroup(nanoem_model_morph_group_t *mor
 
 ScopedMutableMorphGroup::~ScopedMutableMorphGroup() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphGroupGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphGroupDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -272,13 +319,15 @@ nanoem::command::ScopedMutableMorphGroup::operator nanoem_mutable_model_morph_gr
 
 ScopedMutableMorphImpulse::ScopedMutableMorphImpulse(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphImpulseCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphImpulse::ScopedMutableMorphImpulse(nanoem_model_morph_impulse_t *morphPtr)
+ScopedMutableMorphImpulse::ScopedMutableMorphImpulse(Model *model, nanoem_model_morph_impulse_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphImpulseCreateAsReference(morphPtr, &status);
@@ -286,6 +335,9 @@ ScopedMutableMorphImpulse::ScopedMutableMorphImpulse(nanoem_model_morph_impulse_
 
 ScopedMutableMorphImpulse::~ScopedMutableMorphImpulse() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphImpulseGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphImpulseDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -297,13 +349,15 @@ nanoem::command::ScopedMutableMorphImpulse::operator nanoem_mutable_model_morph_
 
 ScopedMutableMorphMaterial::ScopedMutableMorphMaterial(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphMaterialCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphMaterial::ScopedMutableMorphMaterial(nanoem_model_morph_material_t *morphPtr)
+ScopedMutableMorphMaterial::ScopedMutableMorphMaterial(Model *model, nanoem_model_morph_material_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphMaterialCreateAsReference(morphPtr, &status);
@@ -311,6 +365,9 @@ ScopedMutableMorphMaterial::ScopedMutableMorphMaterial(nanoem_model_morph_materi
 
 ScopedMutableMorphMaterial::~ScopedMutableMorphMaterial() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphMaterialGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphMaterialDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -322,13 +379,15 @@ nanoem::command::ScopedMutableMorphMaterial::operator nanoem_mutable_model_morph
 
 ScopedMutableMorphUV::ScopedMutableMorphUV(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphUVCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphUV::ScopedMutableMorphUV(nanoem_model_morph_uv_t *morphPtr)
+ScopedMutableMorphUV::ScopedMutableMorphUV(Model *model, nanoem_model_morph_uv_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphUVCreateAsReference(morphPtr, &status);
@@ -336,6 +395,9 @@ ScopedMutableMorphUV::ScopedMutableMorphUV(nanoem_model_morph_uv_t *morphPtr)
 
 ScopedMutableMorphUV::~ScopedMutableMorphUV() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphUVGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphUVDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -347,13 +409,15 @@ nanoem::command::ScopedMutableMorphUV::operator nanoem_mutable_model_morph_uv_t
 
 ScopedMutableMorphVertex::ScopedMutableMorphVertex(nanoem_mutable_model_morph_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphVertexCreate(morphPtr, &status);
 }
 
-ScopedMutableMorphVertex::ScopedMutableMorphVertex(nanoem_model_morph_vertex_t *morphPtr)
+ScopedMutableMorphVertex::ScopedMutableMorphVertex(Model *model, nanoem_model_morph_vertex_t *morphPtr)
     : m_morph(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_morph = nanoemMutableModelMorphVertexCreateAsReference(morphPtr, &status);
@@ -361,6 +425,9 @@ ScopedMutableMorphVertex::ScopedMutableMorphVertex(nanoem_model_morph_vertex_t *
 
 ScopedMutableMorphVertex::~ScopedMutableMorphVertex() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeMorph, nanoemMutableModelMorphVertexGetOriginObject(m_morph));
+    }
     nanoemMutableModelMorphVertexDestroy(m_morph);
     m_morph = nullptr;
 }
@@ -372,13 +439,15 @@ nanoem::command::ScopedMutableMorphVertex::operator nanoem_mutable_model_morph_v
 
 ScopedMutableLabel::ScopedMutableLabel(Model *model)
     : m_label(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_label = nanoemMutableModelLabelCreate(model->data(), &status);
 }
 
-ScopedMutableLabel::ScopedMutableLabel(nanoem_model_label_t *labelPtr)
+ScopedMutableLabel::ScopedMutableLabel(Model *model, nanoem_model_label_t *labelPtr)
     : m_label(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_label = nanoemMutableModelLabelCreateAsReference(labelPtr, &status);
@@ -386,6 +455,9 @@ ScopedMutableLabel::ScopedMutableLabel(nanoem_model_label_t *labelPtr)
 
 ScopedMutableLabel::~ScopedMutableLabel() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeLabel, nanoemMutableModelLabelGetOriginObject(m_label));
+    }
     nanoemMutableModelLabelDestroy(m_label);
     m_label = nullptr;
 }
@@ -397,13 +469,15 @@ nanoem::command::ScopedMutableLabel::operator nanoem_mutable_model_label_t *() N
 
 ScopedMutableRigidBody::ScopedMutableRigidBody(Model *model)
     : m_rigidBody(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_rigidBody = nanoemMutableModelRigidBodyCreate(model->data(), &status);
 }
 
-ScopedMutableRigidBody::ScopedMutableRigidBody(nanoem_model_rigid_body_t *rigidBodyPtr)
+ScopedMutableRigidBody::ScopedMutableRigidBody(Model *model, nanoem_model_rigid_body_t *rigidBodyPtr)
     : m_rigidBody(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_rigidBody = nanoemMutableModelRigidBodyCreateAsReference(rigidBodyPtr, &status);
@@ -411,6 +485,10 @@ ScopedMutableRigidBody::ScopedMutableRigidBody(nanoem_model_rigid_body_t *rigidB
 
 ScopedMutableRigidBody::~ScopedMutableRigidBody() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(
+            Model::kEditObjectTypeRigidBody, nanoemMutableModelRigidBodyGetOriginObject(m_rigidBody));
+    }
     nanoemMutableModelRigidBodyDestroy(m_rigidBody);
     m_rigidBody = nullptr;
 }
@@ -422,13 +500,15 @@ nanoem::command::ScopedMutableRigidBody::operator nanoem_mutable_model_rigid_bod
 
 ScopedMutableJoint::ScopedMutableJoint(Model *model)
     : m_joint(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_joint = nanoemMutableModelJointCreate(model->data(), &status);
 }
 
-ScopedMutableJoint::ScopedMutableJoint(nanoem_model_joint_t *jointPtr)
+ScopedMutableJoint::ScopedMutableJoint(Model *model, nanoem_model_joint_t *jointPtr)
     : m_joint(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_joint = nanoemMutableModelJointCreateAsReference(jointPtr, &status);
@@ -436,6 +516,9 @@ ScopedMutableJoint::ScopedMutableJoint(nanoem_model_joint_t *jointPtr)
 
 ScopedMutableJoint::~ScopedMutableJoint() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(Model::kEditObjectTypeJoint, nanoemMutableModelJointGetOriginObject(m_joint));
+    }
     nanoemMutableModelJointDestroy(m_joint);
     m_joint = nullptr;
 }
@@ -447,13 +530,15 @@ nanoem::command::ScopedMutableJoint::operator nanoem_mutable_model_joint_t *() N
 
 ScopedMutableSoftBody::ScopedMutableSoftBody(Model *model)
     : m_softBody(nullptr)
+    , m_model(nullptr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_softBody = nanoemMutableModelSoftBodyCreate(model->data(), &status);
 }
 
-ScopedMutableSoftBody::ScopedMutableSoftBody(nanoem_model_soft_body_t *softBodyPtr)
+ScopedMutableSoftBody::ScopedMutableSoftBody(Model *model, nanoem_model_soft_body_t *softBodyPtr)
     : m_softBody(nullptr)
+    , m_model(model)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     m_softBody = nanoemMutableModelSoftBodyCreateAsReference(softBodyPtr, &status);
@@ -461,6 +546,10 @@ ScopedMutableSoftBody::ScopedMutableSoftBody(nanoem_model_soft_body_t *softBodyP
 
 ScopedMutableSoftBody::~ScopedMutableSoftBody() NANOEM_DECL_NOEXCEPT
 {
+    if (m_model) {
+        m_model->markObjectEdited(
+            Model::kEditObjectTypeSoftBody, nanoemMutableModelSoftBodyGetOriginObject(m_softBody));
+    }
     nanoemMutableModelSoftBodyDestroy(m_softBody);
     m_softBody = nullptr;
 }
@@ -1181,8 +1270,8 @@ MergeMaterialCommand::MergeMaterialCommand(
     Model *activeModel, nanoem_model_material_t *const *materials, nanoem_rsize_t materialIndex)
     : BaseUndoCommand(activeModel->project())
     , m_activeModel(activeModel)
-    , m_baseMaterial(materials[materialIndex - 1])
-    , m_deletingMaterial(materials[materialIndex])
+    , m_baseMaterial(nullptr, materials[materialIndex - 1])
+    , m_deletingMaterial(nullptr, materials[materialIndex])
     , m_materialIndex(materialIndex)
 {
 }
@@ -1257,7 +1346,7 @@ DeleteMaterialCommand::DeleteMaterialCommand(
     Model *activeModel, nanoem_model_material_t *const *materials, nanoem_rsize_t materialIndex)
     : BaseUndoCommand(activeModel->project())
     , m_activeModel(activeModel)
-    , m_deletingMaterial(materials[materialIndex])
+    , m_deletingMaterial(nullptr, materials[materialIndex])
     , m_deletingVertexIndexOffset(0)
     , m_materialIndex(materialIndex)
 {
@@ -1357,7 +1446,7 @@ BaseMoveMaterialCommand::BaseMoveMaterialCommand(
     Model *activeModel, nanoem_model_material_t *const *materials, nanoem_rsize_t materialIndex)
     : BaseUndoCommand(activeModel->project())
     , m_activeModel(activeModel)
-    , m_movingMaterial(materials[materialIndex])
+    , m_movingMaterial(nullptr, materials[materialIndex])
 {
 }
 
@@ -1869,7 +1958,7 @@ CreateBoneAsStagingChildCommand::CreateBoneAsStagingChildCommand(Model *activeMo
     , m_parent(nanoemModelBoneGetParentBoneObject(base))
     , m_activeModel(activeModel)
     , m_creatingBone(m_activeModel)
-    , m_baseBone(base)
+    , m_baseBone(nullptr, base)
     , m_boneIndex(model::Bone::index(base))
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
@@ -2092,7 +2181,7 @@ AddBoneToConstraintCommand::create(Model *activeModel, nanoem_model_constraint_t
 AddBoneToConstraintCommand::AddBoneToConstraintCommand(Model *activeModel, nanoem_model_constraint_t *constraintPtr)
     : BaseUndoCommand(activeModel->project())
     , m_activeModel(activeModel)
-    , m_mutableConstraint(constraintPtr)
+    , m_mutableConstraint(nullptr, constraintPtr)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     const model::Bone::Set *boneSet = m_activeModel->selection()->allBoneSet();
@@ -2266,7 +2355,7 @@ BaseMoveBoneCommand::move(nanoem_rsize_t fromIndex, nanoem_rsize_t toIndex, Erro
     nanoem_rsize_t numBones;
     nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(m_activeModel->data(), &numBones);
     nanoem_model_bone_t *fromBone = bones[fromIndex];
-    ScopedMutableBone bone(fromBone);
+    ScopedMutableBone bone(m_activeModel, fromBone);
     DeletingBoneState state;
     state.save(m_activeModel, fromBone, &status);
     nanoemMutableModelRemoveBoneObject(model, bone, &status);
@@ -2645,7 +2734,7 @@ CreateVertexMorphFromModelCommand::name() const NANOEM_DECL_NOEXCEPT
 BaseAddToMorphCommand::BaseAddToMorphCommand(Model *activeModel, nanoem_model_morph_t *morphPtr)
     : BaseUndoCommand(activeModel->project())
     , m_activeModel(activeModel)
-    , m_mutableMorph(morphPtr)
+    , m_mutableMorph(nullptr, morphPtr)
 {
 }
 
@@ -3201,7 +3290,7 @@ BaseMoveMorphCommand::move(nanoem_rsize_t fromIndex, nanoem_rsize_t toIndex, Err
     nanoem_rsize_t numMorphs;
     nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(m_activeModel->data(), &numMorphs);
     nanoem_model_morph_t *fromMorph = morphs[fromIndex];
-    ScopedMutableMorph morph(fromMorph);
+    ScopedMutableMorph morph(m_activeModel, fromMorph);
     DeletingMorphState state;
     state.save(m_activeModel, fromMorph, &status);
     nanoemMutableModelRemoveMorphObject(model, morph, &status);
@@ -3380,7 +3469,7 @@ CreateLabelCommand::name() const NANOEM_DECL_NOEXCEPT
 BaseAddToLabelCommand::BaseAddToLabelCommand(Model *activeModel, nanoem_model_label_t *labelPtr)
     : BaseUndoCommand(activeModel->project())
     , m_activeModel(activeModel)
-    , m_mutableLabel(labelPtr)
+    , m_mutableLabel(nullptr, labelPtr)
 {
 }
 
@@ -3912,7 +4001,7 @@ BaseMoveRigidBodyCommand::move(nanoem_rsize_t fromIndex, nanoem_rsize_t toIndex,
     nanoem_model_rigid_body_t *const *rigidBodies =
         nanoemModelGetAllRigidBodyObjects(m_activeModel->data(), &numRigidBodies);
     nanoem_model_rigid_body_t *fromRigidBody = rigidBodies[fromIndex];
-    ScopedMutableRigidBody rigidBody(fromRigidBody);
+    ScopedMutableRigidBody rigidBody(m_activeModel, fromRigidBody);
     DeletingRigidBodyState state;
     state.save(m_activeModel, fromRigidBody, &status);
     nanoemMutableModelRemoveRigidBodyObject(model, rigidBody, &status);
@@ -4700,7 +4789,7 @@ BatchChangeAllVertexObjectsCommand::undo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableVertex vertex(it->first);
+        ScopedMutableVertex vertex(m_activeModel, it->first);
         restore(it->second, vertex);
     }
     assignError(status, error);
@@ -4711,7 +4800,7 @@ BatchChangeAllVertexObjectsCommand::redo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableVertex vertex(it->first);
+        ScopedMutableVertex vertex(m_activeModel, it->first);
         restore(m_newParameter, vertex);
     }
     assignError(status, error);
@@ -4818,7 +4907,7 @@ BatchChangeAllMaterialObjectsCommand::undo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableMaterial vertex(it->first);
+        ScopedMutableMaterial vertex(m_activeModel, it->first);
         restore(it->second, vertex);
     }
     assignError(status, error);
@@ -4829,7 +4918,7 @@ BatchChangeAllMaterialObjectsCommand::redo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableMaterial vertex(it->first);
+        ScopedMutableMaterial vertex(m_activeModel, it->first);
         restore(m_newParameter, vertex);
     }
     assignError(status, error);
@@ -4943,7 +5032,7 @@ BatchChangeAllBoneObjectsCommand::undo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableBone bone(it->first);
+        ScopedMutableBone bone(m_activeModel, it->first);
         restore(it->second, bone);
     }
     assignError(status, error);
@@ -4954,7 +5043,7 @@ BatchChangeAllBoneObjectsCommand::redo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableBone bone(it->first);
+        ScopedMutableBone bone(m_activeModel, it->first);
         restore(m_newParameter, bone);
     }
     assignError(status, error);
@@ -5027,7 +5116,7 @@ BatchChangeAllMorphObjectsCommand::undo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableMorph morph(it->first);
+        ScopedMutableMorph morph(m_activeModel, it->first);
         restore(it->second, morph);
     }
     assignError(status, error);
@@ -5038,7 +5127,7 @@ BatchChangeAllMorphObjectsCommand::redo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableMorph morph(it->first);
+        ScopedMutableMorph morph(m_activeModel, it->first);
         restore(m_newParameter, morph);
     }
     assignError(status, error);
@@ -5240,7 +5329,7 @@ BatchChangeAllJointObjectsCommand::undo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableJoint joint(it->first);
+        ScopedMutableJoint joint(m_activeModel, it->first);
         restore(it->second, joint);
     }
     assignError(status, error);
@@ -5251,7 +5340,7 @@ BatchChangeAllJointObjectsCommand::redo(Error &error)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     for (ParameterMap::const_iterator it = m_objects.begin(), end = m_objects.end(); it != end; ++it) {
-        ScopedMutableJoint joint(it->first);
+        ScopedMutableJoint joint(m_activeModel, it->first);
         restore(m_newParameter, joint);
     }
     assignError(status, error);
@@ -16,6 +16,7 @@ namespace command {
 
 ModelSnapshotCommand::~ModelSnapshotCommand() NANOEM_DECL_NOEXCEPT
 {
+    currentProject()->removeUndoSnapshotMemoryUsage(m_snapshot.memoryUsage());
 }
 
 undo_command_t *
@@ -36,13 +37,37 @@ ModelSnapshotCommand::create(Model *model, const ByteArray &snapshot)
 void
 ModelSnapshotCommand::undo(Error &error)
 {
-    execute(m_snapshot.second, error);
+    ByteArray present, last;
+    if (resolvePresent(present, error)) {
+        if (m_snapshot.restoreLast(present, last)) {
+            execute(last, error);
+        }
+        else {
+            error = Error("Cannot restore the last model snapshot", nullptr, Error::kDomainTypeApplication);
+        }
+    }
 }
 
 void
 ModelSnapshotCommand::redo(Error &error)
 {
-    execute(m_snapshot.first, error);
+    if (!m_pendingCurrent.empty()) {
+        /* the first redo just after pushing the command doesn't need to resolve the current snapshot */
+        execute(m_pendingCurrent, error);
+        m_pendingCurrent.clear();
+        m_pendingCurrent.shrink_to_fit();
+    }
+    else {
+        ByteArray present, current;
+        if (resolvePresent(present, error)) {
+            if (m_snapshot.restoreCurrent(present, current)) {
+                execute(current, error);
+            }
+            else {
+                error = Error("Cannot restore the current model snapshot", nullptr, Error::kDomainTypeApplication);
+            }
+        }
+    }
 }
 
 void
@@ -50,8 +75,11 @@ ModelSnapshotCommand::read(const void *messagePtr)
 {
     if (const Nanoem__Application__RedoSaveModelSnapshotCommand *command =
             static_cast<const Nanoem__Application__Command *>(messagePtr)->redo_save_model_snapshot) {
-        m_snapshot.first.deflate(command->current_model.data, command->current_model.len);
-        m_snapshot.second.deflate(command->last_model.data, command->last_model.len);
+        const ProtobufCBinaryData &currentModel = command->current_model, &lastModel = command->last_model;
+        const ByteArray current(currentModel.data, currentModel.data + currentModel.len),
+            last(lastModel.data, lastModel.data + lastModel.len);
+        m_snapshot.save(last, current, true);
+        currentProject()->addUndoSnapshotMemoryUsage(m_snapshot.memoryUsage());
     }
 }
 
@@ -61,8 +89,12 @@ ModelSnapshotCommand::write(void *messagePtr)
     Nanoem__Application__RedoSaveModelSnapshotCommand *command =
         nanoem_new(Nanoem__Application__RedoSaveModelSnapshotCommand);
     nanoem__application__redo_save_model_snapshot_command__init(command);
-    m_snapshot.first.inflate(&command->current_model);
-    m_snapshot.second.inflate(&command->last_model);
+    ByteArray present, last, current;
+    Error error;
+    if (resolvePresent(present, error) && m_snapshot.restoreAll(present, last, current)) {
+        SnapshotData::copy(current, &command->current_model);
+        SnapshotData::copy(last, &command->last_model);
+    }
     command->handle = m_model->handle();
     writeCommandMessage(command, NANOEM__APPLICATION__COMMAND__TYPE_REDO_SAVE_MOTION_SNAPSHOT, messagePtr);
 }
@@ -83,36 +115,47 @@ ModelSnapshotCommand::name() const NANOEM_DECL_NOEXCEPT
     return "ModelSnapshotCommand";
 }
 
+bool
+ModelSnapshotCommand::resolvePresent(ByteArray &present, Error &error)
+{
+    bool result = false;
+    if (!m_pendingCurrent.empty()) {
+        present = m_pendingCurrent;
+        result = true;
+    }
+    else if (m_model) {
+        result = m_model->save(present, error);
+    }
+    return result;
+}
+
 void
-ModelSnapshotCommand::execute(const LZ4Data &input, Error &error)
+ModelSnapshotCommand::execute(const ByteArray &input, Error &error)
 {
     if (m_model) {
         Project *project = currentProject();
         Progress progress(project, 0);
-        ByteArray inflated;
-        if (input.inflate(inflated)) {
-            nanoem_frame_index_t frameIndex = project->currentLocalFrameIndex();
-            const Motion *motion = project->resolveMotion(m_model);
-            /* preserve editing mode because setActiveModel changes editing mode */
-            const Project::EditingMode mode = project->editingMode();
-            project->setActiveModel(0);
-            m_model->clear();
-            m_model->load(inflated, error);
-            m_model->setupAllBindings();
-            if (!project->isHiddenBoneBoundsRigidBodyDisabled()) {
-                m_model->createAllBoneBoundsRigidBodies();
-            }
-            m_model->createAllImages();
-            m_model->upload();
-            m_model->loadAllImages(progress, error);
-            if (Motion *motion = project->resolveMotion(m_model)) {
-                motion->initialize(m_model);
-            }
-            m_model->synchronizeMotion(motion, frameIndex, 0, PhysicsEngine::kSimulationTimingBefore);
-            m_model->setDirty(false);
-            project->setActiveModel(m_model);
-            project->setEditingMode(mode);
+        nanoem_frame_index_t frameIndex = project->currentLocalFrameIndex();
+        const Motion *motion = project->resolveMotion(m_model);
+        /* preserve editing mode because setActiveModel changes editing mode */
+        const Project::EditingMode mode = project->editingMode();
+        project->setActiveModel(0);
+        m_model->clear();
+        m_model->load(input, error);
+        m_model->setupAllBindings();
+        if (!project->isHiddenBoneBoundsRigidBodyDisabled()) {
+            m_model->createAllBoneBoundsRigidBodies();
+        }
+        m_model->createAllImages();
+        m_model->upload();
+        m_model->loadAllImages(progress, error);
+        if (Motion *motion = project->resolveMotion(m_model)) {
+            motion->initialize(m_model);
         }
+        m_model->synchronizeMotion(motion, frameIndex, 0, PhysicsEngine::kSimulationTimingBefore);
+        m_model->setDirty(false);
+        project->setActiveModel(m_model);
+        project->setEditingMode(mode);
     }
 }
 
@@ -120,19 +163,19 @@ ModelSnapshotCommand::ModelSnapshotCommand(Project *project)
     : BaseUndoCommand(project)
     , m_model(0)
 {
-    m_snapshot.first.m_inflatedSize = m_snapshot.second.m_inflatedSize = 0;
 }
 
 ModelSnapshotCommand::ModelSnapshotCommand(Model *model, const ByteArray &snapshot)
     : BaseUndoCommand(model->project())
     , m_model(model)
 {
-    ByteArray current;
+    Project *project = currentProject();
     Error error;
-    model->save(current, error);
-    m_snapshot.first.deflate(current);
-    m_snapshot.second.deflate(snapshot);
-    error.notify(currentProject()->eventPublisher());
+    model->save(m_pendingCurrent, error);
+    m_snapshot.save(snapshot, m_pendingCurrent,
+        project->nextUndoSnapshotSequence() % SnapshotData::kCheckpointInterval == 0);
+    project->addUndoSnapshotMemoryUsage(m_snapshot.memoryUsage());
+    error.notify(project->eventPublisher());
 }
 
 } /* namespace command */
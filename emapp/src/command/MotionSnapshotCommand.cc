@@ -11,6 +11,7 @@
 #include "emapp/Accessory.h"
 #include "emapp/EnumUtils.h"
 #include "emapp/Error.h"
+#include "emapp/Model.h"
 #include "emapp/private/CommonInclude.h"
 
 namespace nanoem {
@@ -18,6 +19,7 @@ namespace command {
 
 MotionSnapshotCommand::~MotionSnapshotCommand() NANOEM_DECL_NOEXCEPT
 {
+    currentProject()->removeUndoSnapshotMemoryUsage(m_snapshot.memoryUsage());
 }
 
 undo_command_t *
@@ -38,13 +40,37 @@ MotionSnapshotCommand::create(Motion *motion, const Model *model, const ByteArra
 void
 MotionSnapshotCommand::undo(Error &error)
 {
-    execute(m_snapshot.second, error);
+    ByteArray present, last;
+    if (resolvePresent(present, error)) {
+        if (m_snapshot.restoreLast(present, last)) {
+            execute(last, error);
+        }
+        else {
+            error = Error("Cannot restore the last motion snapshot", nullptr, Error::kDomainTypeApplication);
+        }
+    }
 }
 
 void
 MotionSnapshotCommand::redo(Error &error)
 {
-    execute(m_snapshot.first, error);
+    if (!m_pendingCurrent.empty()) {
+        /* the first redo just after pushing the command doesn't need to resolve the current snapshot */
+        execute(m_pendingCurrent, error);
+        m_pendingCurrent.clear();
+        m_pendingCurrent.shrink_to_fit();
+    }
+    else {
+        ByteArray present, current;
+        if (resolvePresent(present, error)) {
+            if (m_snapshot.restoreCurrent(present, current)) {
+                execute(current, error);
+            }
+            else {
+                error = Error("Cannot restore the current motion snapshot", nullptr, Error::kDomainTypeApplication);
+            }
+        }
+    }
 }
 
 void
@@ -53,8 +79,11 @@ MotionSnapshotCommand::read(const void *messagePtr)
     if (const Nanoem__Application__RedoSaveMotionSnapshotCommand *command =
             static_cast<const Nanoem__Application__Command *>(messagePtr)->redo_save_motion_snapshot) {
         Project *project = currentProject();
-        m_snapshot.first.deflate(command->current_motion.data, command->current_motion.len);
-        m_snapshot.second.deflate(command->last_motion.data, command->last_motion.len);
+        const ProtobufCBinaryData &currentMotion = command->current_motion, &lastMotion = command->last_motion;
+        const ByteArray current(currentMotion.data, currentMotion.data + currentMotion.len),
+            last(lastMotion.data, lastMotion.data + lastMotion.len);
+        m_snapshot.save(last, current, true);
+        project->addUndoSnapshotMemoryUsage(m_snapshot.memoryUsage());
         if (command->has_handle) {
             nanoem_u16_t handle = command->handle;
             if (Accessory *accessory = project->resolveRedoAccessory(handle)) {
@@ -62,6 +91,7 @@ MotionSnapshotCommand::read(const void *messagePtr)
             }
             else if (Model *model = project->resolveRedoModel(handle)) {
                 m_motion = project->resolveMotion(model);
+                m_modelHandle = model->handle();
             }
         }
         m_types = command->types;
@@ -85,8 +115,12 @@ MotionSnapshotCommand::write(void *messagePtr)
     Nanoem__Application__RedoSaveMotionSnapshotCommand *command =
         nanoem_new(Nanoem__Application__RedoSaveMotionSnapshotCommand);
     nanoem__application__redo_save_motion_snapshot_command__init(command);
-    m_snapshot.first.inflate(&command->current_motion);
-    m_snapshot.second.inflate(&command->last_motion);
+    ByteArray present, last, current;
+    Error error;
+    if (resolvePresent(present, error) && m_snapshot.restoreAll(present, last, current)) {
+        SnapshotData::copy(current, &command->current_motion);
+        SnapshotData::copy(last, &command->last_motion);
+    }
     command->types = m_types;
     if (const IDrawable *drawable = currentProject()->resolveDrawable(m_motion)) {
         command->handle = drawable->handle();
@@ -115,17 +149,40 @@ MotionSnapshotCommand::name() const NANOEM_DECL_NOEXCEPT
     return "MotionSnapshotCommand";
 }
 
+bool
+MotionSnapshotCommand::resolvePresent(ByteArray &present, Error &error)
+{
+    bool result = false;
+    if (!m_pendingCurrent.empty()) {
+        present = m_pendingCurrent;
+        result = true;
+    }
+    else if (currentProject()->containsMotion(m_motion)) {
+        if (const ByteArray *snapshot = currentProject()->findMotionUndoSnapshot(m_motion, m_modelHandle)) {
+            /* the motion is unchanged since the last undo or redo so the loaded bytes are the present state */
+            present = *snapshot;
+            result = true;
+        }
+        else {
+            /* keyframes of the model are saved only if the same model is passed as the snapshot is taken */
+            const Model *model = currentProject()->findModelByHandle(m_modelHandle);
+            result = m_motion->save(present, model, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
+        }
+    }
+    return result;
+}
+
 void
-MotionSnapshotCommand::execute(const LZ4Data &input, Error &error)
+MotionSnapshotCommand::execute(const ByteArray &input, Error &error)
 {
     Project *project = currentProject();
     if (project->containsMotion(m_motion)) {
-        ByteArray inflated;
-        if (input.inflate(inflated)) {
-            m_motion->clearAllKeyframes();
-            m_motion->load(inflated, 0, error);
-            m_motion->restoreState(m_state);
-            project->setBaseDuration(m_motion->duration());
+        m_motion->clearAllKeyframes();
+        m_motion->load(input, 0, error);
+        m_motion->restoreState(m_state);
+        project->setBaseDuration(m_motion->duration());
+        if (!error.hasReason()) {
+            project->setMotionUndoSnapshot(m_motion, m_modelHandle, input);
         }
     }
 }
@@ -134,9 +191,9 @@ MotionSnapshotCommand::MotionSnapshotCommand(Project *project)
     : BaseUndoCommand(project)
     , m_motion(0)
     , m_state(0)
+    , m_modelHandle(0)
     , m_types(0)
 {
-    m_snapshot.first.m_inflatedSize = m_snapshot.second.m_inflatedSize = 0;
 }
 
 MotionSnapshotCommand::MotionSnapshotCommand(
@@ -144,15 +201,17 @@ MotionSnapshotCommand::MotionSnapshotCommand(
     : BaseUndoCommand(motion->project())
     , m_motion(motion)
     , m_state(0)
+    , m_modelHandle(model ? model->handle() : 0)
     , m_types(types)
 {
-    ByteArray current;
+    Project *project = currentProject();
     Error error;
-    motion->save(current, model, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
+    motion->save(m_pendingCurrent, model, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
     motion->saveState(m_state);
-    m_snapshot.first.deflate(current);
-    m_snapshot.second.deflate(snapshot);
-    error.notify(currentProject()->eventPublisher());
+    m_snapshot.save(snapshot, m_pendingCurrent,
+        project->nextUndoSnapshotSequence() % SnapshotData::kCheckpointInterval == 0);
+    project->addUndoSnapshotMemoryUsage(m_snapshot.memoryUsage());
+    error.notify(project->eventPublisher());
 }
 
 } /* namespace command */
@@ -0,0 +1,329 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/command/SnapshotDelta.h"
+
+#include "emapp/private/CommonInclude.h"
+
+#include "bx/hash.h"
+
+namespace nanoem {
+namespace command {
+namespace {
+
+static const nanoem_u32_t kSignature = nanoem_fourcc('n', 'm', 'S', 'D');
+static const nanoem_rsize_t kBlockSize = 32;
+static const nanoem_u32_t kHashPrime = 0x01000193u;
+
+enum OperationType {
+    kOperationTypeCopy,
+    kOperationTypeInsert,
+};
+
+class Writer NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    Writer(ByteArray &bytes)
+        : m_bytes(bytes)
+    {
+    }
+
+    void
+    writeU8(nanoem_u8_t value)
+    {
+        m_bytes.push_back(value);
+    }
+    void
+    writeU32(nanoem_u32_t value)
+    {
+        for (int i = 0; i < 4; i++) {
+            m_bytes.push_back(nanoem_u8_t((value >> (i * 8)) & 0xff));
+        }
+    }
+    void
+    writeVarint(nanoem_u64_t value)
+    {
+        while (value >= 0x80) {
+            m_bytes.push_back(nanoem_u8_t(value | 0x80));
+            value >>= 7;
+        }
+        m_bytes.push_back(nanoem_u8_t(value));
+    }
+    void
+    writeBytes(const nanoem_u8_t *data, nanoem_rsize_t size)
+    {
+        const nanoem_rsize_t offset = m_bytes.size();
+        m_bytes.resize(offset + size);
+        memcpy(m_bytes.data() + offset, data, size);
+    }
+
+private:
+    ByteArray &m_bytes;
+};
+
+class Reader NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    Reader(const ByteArray &bytes)
+        : m_data(bytes.data())
+        , m_size(bytes.size())
+        , m_offset(0)
+    {
+    }
+
+    bool
+    readU8(nanoem_u8_t &value)
+    {
+        bool result = m_offset < m_size;
+        if (result) {
+            value = m_data[m_offset++];
+        }
+        return result;
+    }
+    bool
+    readU32(nanoem_u32_t &value)
+    {
+        bool result = m_offset + 4 <= m_size;
+        if (result) {
+            value = 0;
+            for (int i = 0; i < 4; i++) {
+                value |= nanoem_u32_t(m_data[m_offset++]) << (i * 8);
+            }
+        }
+        return result;
+    }
+    bool
+    readVarint(nanoem_u64_t &value)
+    {
+        value = 0;
+        for (int shift = 0; shift < 64 && m_offset < m_size; shift += 7) {
+            const nanoem_u8_t c = m_data[m_offset++];
+            value |= nanoem_u64_t(c & 0x7f) << shift;
+            if ((c & 0x80) == 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+    const nanoem_u8_t *
+    readBytes(nanoem_u64_t size)
+    {
+        const nanoem_u8_t *ptr = nullptr;
+        if (size <= m_size - m_offset) {
+            ptr = m_data + m_offset;
+            m_offset += nanoem_rsize_t(size);
+        }
+        return ptr;
+    }
+    bool
+    isEnd() const NANOEM_DECL_NOEXCEPT
+    {
+        return m_offset == m_size;
+    }
+
+private:
+    const nanoem_u8_t *m_data;
+    const nanoem_rsize_t m_size;
+    nanoem_rsize_t m_offset;
+};
+
+/* holds one offset of the base block per slot, collided blocks are simply dropped as they only lose a match */
+class BlockTable NANOEM_DECL_SEALED : private NonCopyable {
+public:
+    BlockTable(const ByteArray &base)
+        : m_shift(32)
+    {
+        const nanoem_rsize_t numBlocks = base.size() / kBlockSize;
+        nanoem_rsize_t capacity = 1;
+        while (capacity < numBlocks * 2) {
+            capacity <<= 1;
+            m_shift--;
+        }
+        m_offsets.resize(capacity);
+        for (nanoem_rsize_t i = 0; i < capacity; i++) {
+            m_offsets[i] = -1;
+        }
+        const nanoem_u8_t *ptr = base.data();
+        for (nanoem_rsize_t i = 0; i < numBlocks; i++) {
+            const nanoem_rsize_t offset = i * kBlockSize;
+            nanoem_i32_t &slot = m_offsets[index(hash(ptr + offset))];
+            if (slot < 0) {
+                slot = nanoem_i32_t(offset);
+            }
+        }
+    }
+
+    static nanoem_u32_t
+    hash(const nanoem_u8_t *ptr) NANOEM_DECL_NOEXCEPT
+    {
+        nanoem_u32_t value = 0;
+        for (nanoem_rsize_t i = 0; i < kBlockSize; i++) {
+            value = value * kHashPrime + ptr[i];
+        }
+        return value;
+    }
+    nanoem_i32_t
+    find(nanoem_u32_t value) const NANOEM_DECL_NOEXCEPT
+    {
+        return m_offsets[index(value)];
+    }
+
+private:
+    nanoem_rsize_t
+    index(nanoem_u32_t value) const NANOEM_DECL_NOEXCEPT
+    {
+        return m_shift < 32 ? nanoem_rsize_t((value * 0x9e3779b1u) >> m_shift) : 0;
+    }
+
+    tinystl::vector<nanoem_i32_t, TinySTLAllocator> m_offsets;
+    int m_shift;
+};
+
+static nanoem_u64_t
+encodeZigZag(nanoem_i64_t value) NANOEM_DECL_NOEXCEPT
+{
+    return (nanoem_u64_t(value) << 1) ^ nanoem_u64_t(value >> 63);
+}
+
+static nanoem_i64_t
+decodeZigZag(nanoem_u64_t value) NANOEM_DECL_NOEXCEPT
+{
+    return nanoem_i64_t(value >> 1) ^ -nanoem_i64_t(value & 1);
+}
+
+static void
+writeInsert(Writer &writer, const ByteArray &target, nanoem_rsize_t from, nanoem_rsize_t to)
+{
+    if (to > from) {
+        writer.writeU8(kOperationTypeInsert);
+        writer.writeVarint(to - from);
+        writer.writeBytes(target.data() + from, to - from);
+    }
+}
+
+static void
+writeCopy(Writer &writer, nanoem_rsize_t offset, nanoem_rsize_t size, nanoem_rsize_t &lastOffset)
+{
+    /* offsets are relative to the end of the previous copy as most of copies continue from there */
+    writer.writeU8(kOperationTypeCopy);
+    writer.writeVarint(encodeZigZag(nanoem_i64_t(offset) - nanoem_i64_t(lastOffset)));
+    writer.writeVarint(size);
+    lastOffset = offset + size;
+}
+
+} /* namespace anonymous */
+
+nanoem_u32_t
+SnapshotDelta::checksum(const ByteArray &bytes) NANOEM_DECL_NOEXCEPT
+{
+    bx::HashMurmur2A hash;
+    hash.begin();
+    hash.add(bytes.data(), Inline::saturateInt32(bytes.size()));
+    return hash.end();
+}
+
+void
+SnapshotDelta::encode(const ByteArray &base, const ByteArray &target, ByteArray &delta)
+{
+    Writer writer(delta);
+    delta.clear();
+    writer.writeU32(kSignature);
+    writer.writeU32(Inline::saturateInt32U(base.size()));
+    writer.writeU32(checksum(base));
+    writer.writeU32(Inline::saturateInt32U(target.size()));
+    writer.writeU32(checksum(target));
+    const nanoem_rsize_t baseSize = base.size(), targetSize = target.size();
+    const nanoem_u8_t *basePtr = base.data(), *targetPtr = target.data();
+    nanoem_rsize_t literalOffset = 0, position = 0, lastCopyOffset = 0;
+    if (baseSize >= kBlockSize && targetSize >= kBlockSize) {
+        const BlockTable table(base);
+        nanoem_u32_t outgoingFactor = 1, value = 0;
+        bool valid = false;
+        for (nanoem_rsize_t i = 1; i < kBlockSize; i++) {
+            outgoingFactor *= kHashPrime;
+        }
+        while (position + kBlockSize <= targetSize) {
+            if (!valid) {
+                value = BlockTable::hash(targetPtr + position);
+                valid = true;
+            }
+            const nanoem_i32_t found = table.find(value);
+            if (found >= 0 && memcmp(basePtr + found, targetPtr + position, kBlockSize) == 0) {
+                nanoem_rsize_t sourceBegin = nanoem_rsize_t(found), targetBegin = position;
+                while (targetBegin > literalOffset && sourceBegin > 0 &&
+                    targetPtr[targetBegin - 1] == basePtr[sourceBegin - 1]) {
+                    targetBegin--;
+                    sourceBegin--;
+                }
+                nanoem_rsize_t sourceEnd = nanoem_rsize_t(found) + kBlockSize, targetEnd = position + kBlockSize;
+                while (targetEnd < targetSize && sourceEnd < baseSize && targetPtr[targetEnd] == basePtr[sourceEnd]) {
+                    targetEnd++;
+                    sourceEnd++;
+                }
+                writeInsert(writer, target, literalOffset, targetBegin);
+                writeCopy(writer, sourceBegin, targetEnd - targetBegin, lastCopyOffset);
+                literalOffset = position = targetEnd;
+                valid = false;
+            }
+            else {
+                if (position + kBlockSize < targetSize) {
+                    value = (value - targetPtr[position] * outgoingFactor) * kHashPrime +
+                        targetPtr[position + kBlockSize];
+                }
+                position++;
+            }
+        }
+    }
+    writeInsert(writer, target, literalOffset, targetSize);
+}
+
+bool
+SnapshotDelta::decode(const ByteArray &base, const ByteArray &delta, ByteArray &target)
+{
+    Reader reader(delta);
+    nanoem_u32_t signature, baseSize, baseChecksum, targetSize, targetChecksum;
+    if (!(reader.readU32(signature) && signature == kSignature && reader.readU32(baseSize) &&
+            reader.readU32(baseChecksum) && reader.readU32(targetSize) && reader.readU32(targetChecksum))) {
+        return false;
+    }
+    else if (baseSize != base.size() || baseChecksum != checksum(base)) {
+        return false;
+    }
+    target.resize(targetSize);
+    const nanoem_u8_t *basePtr = base.data();
+    nanoem_u8_t *targetPtr = target.data();
+    nanoem_rsize_t offset = 0, lastCopyOffset = 0;
+    nanoem_u8_t type;
+    while (!reader.isEnd()) {
+        nanoem_u64_t value, size;
+        if (!(reader.readU8(type) && reader.readVarint(value))) {
+            return false;
+        }
+        else if (type == kOperationTypeCopy) {
+            const nanoem_i64_t source = nanoem_i64_t(lastCopyOffset) + decodeZigZag(value);
+            if (!reader.readVarint(size) || source < 0 || nanoem_u64_t(source) + size > baseSize ||
+                offset + size > targetSize) {
+                return false;
+            }
+            memcpy(targetPtr + offset, basePtr + source, nanoem_rsize_t(size));
+            lastCopyOffset = nanoem_rsize_t(source + size);
+            offset += nanoem_rsize_t(size);
+        }
+        else if (type == kOperationTypeInsert) {
+            const nanoem_u8_t *ptr = reader.readBytes(value);
+            if (!ptr || offset + value > targetSize) {
+                return false;
+            }
+            memcpy(targetPtr + offset, ptr, nanoem_rsize_t(value));
+            offset += nanoem_rsize_t(value);
+        }
+        else {
+            return false;
+        }
+    }
+    return offset == targetSize && checksum(target) == targetChecksum;
+}
+
+} /* namespace command */
+} /* namespace nanoem */
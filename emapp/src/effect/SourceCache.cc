@@ -0,0 +1,556 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/effect/SourceCache.h"
+
+#include "emapp/Error.h"
+#include "emapp/FileUtils.h"
+#include "emapp/StringUtils.h"
+#include "emapp/private/CommonInclude.h"
+
+#include "lz4/lib/lz4.h"
+
+namespace nanoem {
+
+#include "sha256.h"
+
+namespace effect {
+namespace {
+
+static const nanoem_u32_t kBlobSignature = nanoem_fourcc('n', 'm', 'C', 'E');
+static const nanoem_u32_t kManifestSignature = nanoem_fourcc('n', 'm', 'C', 'M');
+/* the index since 'nmCJ' has the source keys of manifests pointing each blob so older ones are ignored */
+static const nanoem_u32_t kIndexSignature = nanoem_fourcc('n', 'm', 'C', 'J');
+static const nanoem_rsize_t kIndexEntryMinimumSize =
+    sizeof(SourceCache::Digest) + sizeof(nanoem_u64_t) * 2 + sizeof(nanoem_u32_t);
+static const char kBlobExtension[] = "blob";
+static const char kManifestExtension[] = "manifest";
+static const char kIndexFilename[] = "index";
+
+static inline const char *
+skipSpaces(const char *ptr, const char *end) NANOEM_DECL_NOEXCEPT
+{
+    while (ptr < end && (*ptr == ' ' || *ptr == '\t')) {
+        ptr++;
+    }
+    return ptr;
+}
+
+static inline bool
+equalsDigest(const SourceCache::Digest &left, const SourceCache::Digest &right) NANOEM_DECL_NOEXCEPT
+{
+    return memcmp(left.m_value, right.m_value, sizeof(left.m_value)) == 0;
+}
+
+static bool
+containsDigest(const SourceCache::DigestList &digests, const SourceCache::Digest &value) NANOEM_DECL_NOEXCEPT
+{
+    for (SourceCache::DigestList::const_iterator it = digests.begin(), end = digests.end(); it != end; ++it) {
+        if (equalsDigest(*it, value)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void
+removeDigest(SourceCache::DigestList &digests, const SourceCache::Digest &value)
+{
+    for (SourceCache::DigestList::iterator it = digests.begin(), end = digests.end(); it != end; ++it) {
+        if (equalsDigest(*it, value)) {
+            digests.erase(it);
+            break;
+        }
+    }
+}
+
+static void
+updateDigest(SHA256_CTX &ctx, const String &value)
+{
+    const nanoem_u32_t length = Inline::saturateInt32U(value.size());
+    sha256_update(&ctx, reinterpret_cast<const nanoem_u8_t *>(&length), sizeof(length));
+    sha256_update(&ctx, reinterpret_cast<const nanoem_u8_t *>(value.c_str()), length);
+}
+
+} /* namespace anonymous */
+
+bool
+SourceCache::digestAllSources(const URI &fileURI, const String &environment, const ITranslator *translator,
+    DependencyList &dependencies, Digest &digest, Error &error)
+{
+    typedef tinystl::pair<String, String> PendingSource;
+    typedef tinystl::vector<PendingSource, TinySTLAllocator> PendingSourceList;
+    PendingSourceList pendingSources;
+    StringSet visitedPaths;
+    StringList includes;
+    ByteArray bytes;
+    SHA256_CTX ctx;
+    bool resolved = true;
+    sha256_init(&ctx);
+    updateDigest(ctx, environment);
+    /* the main source is hashed without its path and includes with their spelled names to be location independent */
+    pendingSources.push_back(tinystl::make_pair(fileURI.absolutePath(), String()));
+    for (nanoem_rsize_t offset = 0; offset < pendingSources.size() && resolved && !error.hasReason(); offset++) {
+        const PendingSource source(pendingSources[offset]);
+        const String &path = source.first;
+        if (visitedPaths.find(path) != visitedPaths.end()) {
+            continue;
+        }
+        visitedPaths.insert(path);
+        const URI &sourceURI = URI::createFromFilePath(path);
+        FileReaderScope scope(translator);
+        if (scope.open(sourceURI, error)) {
+            FileUtils::read(scope, bytes, error);
+        }
+        if (!error.hasReason()) {
+            Dependency dependency;
+            dependency.m_path = path;
+            dependency.m_size = bytes.size();
+            dependency.m_timestamp = FileUtils::timestamp(sourceURI);
+            dependencies.push_back(dependency);
+            updateDigest(ctx, source.second);
+            const nanoem_u32_t size = Inline::saturateInt32U(bytes.size());
+            sha256_update(&ctx, reinterpret_cast<const nanoem_u8_t *>(&size), sizeof(size));
+            sha256_update(&ctx, bytes.data(), size);
+            const String &basePath = URI::stringByDeletingLastPathComponent(path);
+            includes.clear();
+            parseAllIncludes(bytes, includes);
+            for (StringList::const_iterator it = includes.begin(), end = includes.end(); it != end; ++it) {
+                const String &includePath = FileUtils::canonicalizePath(basePath, *it);
+                if (FileUtils::exists(includePath.c_str())) {
+                    pendingSources.push_back(tinystl::make_pair(includePath, *it));
+                }
+                else {
+                    /* the compiler may find it elsewhere so the closure is unknown and the digest is not usable */
+                    resolved = false;
+                }
+            }
+        }
+    }
+    sha256_final(&ctx, digest.m_value);
+    return resolved && !error.hasReason();
+}
+
+void
+SourceCache::parseAllIncludes(const ByteArray &bytes, StringList &includes)
+{
+    static const char kIncludeDirective[] = "include";
+    static const nanoem_rsize_t kIncludeDirectiveLength = sizeof(kIncludeDirective) - 1;
+    const char *ptr = reinterpret_cast<const char *>(bytes.data()), *end = ptr + bytes.size();
+    while (ptr < end) {
+        const char *lineEnd = ptr;
+        while (lineEnd < end && *lineEnd != '\n') {
+            lineEnd++;
+        }
+        const char *p = skipSpaces(ptr, lineEnd);
+        if (p < lineEnd && *p == '#') {
+            p = skipSpaces(p + 1, lineEnd);
+            if (nanoem_rsize_t(lineEnd - p) > kIncludeDirectiveLength &&
+                StringUtils::equals(p, kIncludeDirective, kIncludeDirectiveLength)) {
+                p = skipSpaces(p + kIncludeDirectiveLength, lineEnd);
+                if (p < lineEnd && (*p == '"' || *p == '<')) {
+                    const char terminator = *p == '"' ? '"' : '>';
+                    const char *q = ++p;
+                    while (q < lineEnd && *q != terminator) {
+                        q++;
+                    }
+                    if (q < lineEnd && q > p) {
+                        includes.push_back(String(p, q - p));
+                    }
+                }
+            }
+        }
+        ptr = lineEnd + 1;
+    }
+}
+
+SourceCache::SourceCache(const URI &directoryURI, const ITranslator *translator)
+    : m_translator(translator)
+    , m_directoryURI(directoryURI)
+    , m_capacity(kDefaultCapacity)
+    , m_sequence(0)
+    , m_indexLoaded(false)
+{
+}
+
+SourceCache::~SourceCache() NANOEM_DECL_NOEXCEPT
+{
+}
+
+bool
+SourceCache::find(const URI &fileURI, ByteArray &output, Error &error)
+{
+    Digest sourceKey, contentKey;
+    DependencyList dependencies;
+    bool found = false;
+    resolveSourceKey(fileURI, sourceKey);
+    const bool upToDate = readManifest(sourceKey, contentKey, dependencies) && isUpToDate(dependencies);
+    bool digested = upToDate;
+    if (!upToDate) {
+        dependencies.clear();
+        digested = digestAllSources(fileURI, m_environment, m_translator, dependencies, contentKey, error);
+    }
+    nanoem_u64_t size;
+    if (digested && readBlob(contentKey, output, size)) {
+        Error localError;
+        if (!upToDate) {
+            /* sources are touched or the project is moved but the content is still the same */
+            writeManifest(sourceKey, contentKey, dependencies, localError);
+        }
+        touch(contentKey, sourceKey, size);
+        saveIndex(localError);
+        found = true;
+    }
+    return found;
+}
+
+void
+SourceCache::save(const URI &fileURI, const ByteArray &output, Error &error)
+{
+    Digest sourceKey, contentKey;
+    DependencyList dependencies;
+    if (digestAllSources(fileURI, m_environment, m_translator, dependencies, contentKey, error)) {
+        nanoem_u64_t size = 0;
+        resolveSourceKey(fileURI, sourceKey);
+        writeBlob(contentKey, output, size, error);
+        if (!error.hasReason()) {
+            writeManifest(sourceKey, contentKey, dependencies, error);
+            touch(contentKey, sourceKey, size);
+            evict();
+            saveIndex(error);
+        }
+    }
+}
+
+URI
+SourceCache::resolveManifestFileURI(const URI &fileURI) const
+{
+    Digest sourceKey;
+    resolveSourceKey(fileURI, sourceKey);
+    return resolveFileURI(sourceKey, kManifestExtension);
+}
+
+String
+SourceCache::environment() const
+{
+    return m_environment;
+}
+
+void
+SourceCache::setEnvironment(const String &value)
+{
+    m_environment = value;
+}
+
+nanoem_u64_t
+SourceCache::capacity() const NANOEM_DECL_NOEXCEPT
+{
+    return m_capacity;
+}
+
+void
+SourceCache::setCapacity(nanoem_u64_t value)
+{
+    m_capacity = value;
+}
+
+nanoem_u64_t
+SourceCache::usage() const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_u64_t value = 0;
+    for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+        value += it->m_size;
+    }
+    return value;
+}
+
+bool
+SourceCache::isUpToDate(const DependencyList &dependencies) NANOEM_DECL_NOEXCEPT
+{
+    bool upToDate = !dependencies.empty();
+    for (DependencyList::const_iterator it = dependencies.begin(), end = dependencies.end(); upToDate && it != end;
+         ++it) {
+        const char *path = it->m_path.c_str();
+        upToDate = FileUtils::fileSize(path) == it->m_size && FileUtils::timestamp(path) == it->m_timestamp;
+    }
+    return upToDate;
+}
+
+URI
+SourceCache::resolveFileURI(const Digest &key, const char *extension) const
+{
+    char buffer[kDigestSize * 2 + 1];
+    for (nanoem_rsize_t i = 0; i < kDigestSize; i++) {
+        nanoem_rsize_t offset = 2 * i;
+        StringUtils::format(buffer + offset, Inline::saturateInt32(sizeof(buffer) - offset), "%02x", key.m_value[i]);
+    }
+    String path(m_directoryURI.absolutePath());
+    path.append("/");
+    path.append(buffer);
+    path.append(".");
+    path.append(extension);
+    return URI::createFromFilePath(path);
+}
+
+void
+SourceCache::resolveSourceKey(const URI &fileURI, Digest &key) const
+{
+    SHA256_CTX ctx;
+    sha256_init(&ctx);
+    updateDigest(ctx, m_environment);
+    updateDigest(ctx, fileURI.absolutePath());
+    sha256_final(&ctx, key.m_value);
+}
+
+bool
+SourceCache::readManifest(const Digest &sourceKey, Digest &contentKey, DependencyList &dependencies)
+{
+    const URI &manifestURI = resolveFileURI(sourceKey, kManifestExtension);
+    Error error;
+    if (FileUtils::exists(manifestURI)) {
+        FileReaderScope scope(m_translator);
+        if (scope.open(manifestURI, error)) {
+            IFileReader *reader = scope.reader();
+            nanoem_u32_t signature = 0, numDependencies = 0;
+            FileUtils::readTyped(reader, signature, error);
+            if (signature == kManifestSignature) {
+                FileUtils::readTyped(reader, contentKey, error);
+                FileUtils::readTyped(reader, numDependencies, error);
+                for (nanoem_u32_t i = 0; i < numDependencies && !error.hasReason(); i++) {
+                    Dependency dependency;
+                    nanoem_u32_t length = 0;
+                    FileUtils::readTyped(reader, length, error);
+                    if (length > reader->size()) {
+                        break;
+                    }
+                    MutableString path(length + 1);
+                    FileUtils::read(reader, path.data(), length, error);
+                    path[length] = 0;
+                    dependency.m_path = path.data();
+                    FileUtils::readTyped(reader, dependency.m_size, error);
+                    FileUtils::readTyped(reader, dependency.m_timestamp, error);
+                    dependencies.push_back(dependency);
+                }
+            }
+        }
+    }
+    return !error.hasReason() && !dependencies.empty();
+}
+
+void
+SourceCache::writeManifest(
+    const Digest &sourceKey, const Digest &contentKey, const DependencyList &dependencies, Error &error)
+{
+    FileWriterScope scope;
+    if (scope.open(resolveFileURI(sourceKey, kManifestExtension), error)) {
+        IFileWriter *writer = scope.writer();
+        const nanoem_u32_t numDependencies = Inline::saturateInt32U(dependencies.size());
+        FileUtils::writeTyped(writer, kManifestSignature, error);
+        FileUtils::writeTyped(writer, contentKey, error);
+        FileUtils::writeTyped(writer, numDependencies, error);
+        for (DependencyList::const_iterator it = dependencies.begin(), end = dependencies.end(); it != end; ++it) {
+            const nanoem_u32_t length = Inline::saturateInt32U(it->m_path.size());
+            FileUtils::writeTyped(writer, length, error);
+            FileUtils::write(writer, it->m_path, error);
+            FileUtils::writeTyped(writer, it->m_size, error);
+            FileUtils::writeTyped(writer, it->m_timestamp, error);
+        }
+        if (!error.hasReason()) {
+            scope.commit(error);
+        }
+    }
+}
+
+bool
+SourceCache::readBlob(const Digest &contentKey, ByteArray &output, nanoem_u64_t &size)
+{
+    const URI &blobURI = resolveFileURI(contentKey, kBlobExtension);
+    Error error;
+    bool succeeded = false;
+    if (FileUtils::exists(blobURI)) {
+        FileReaderScope scope(m_translator);
+        if (scope.open(blobURI, error)) {
+            IFileReader *reader = scope.reader();
+            nanoem_u32_t signature = 0, inflatedSize = 0, deflatedSize = 0;
+            FileUtils::readTyped(reader, signature, error);
+            FileUtils::readTyped(reader, inflatedSize, error);
+            FileUtils::readTyped(reader, deflatedSize, error);
+            size = reader->size();
+            if (signature == kBlobSignature && deflatedSize <= size && !error.hasReason()) {
+                ByteArray deflated(deflatedSize);
+                Digest expectedChecksum, actualChecksum;
+                FileUtils::readTyped(reader, expectedChecksum, error);
+                FileUtils::read(reader, deflated.data(), deflatedSize, error);
+                SHA256_CTX ctx;
+                sha256_init(&ctx);
+                sha256_update(&ctx, deflated.data(), deflatedSize);
+                sha256_final(&ctx, actualChecksum.m_value);
+                if (!error.hasReason() && equalsDigest(expectedChecksum, actualChecksum)) {
+                    output.resize(inflatedSize);
+                    int actualSize = LZ4_decompress_safe(reinterpret_cast<const char *>(deflated.data()),
+                        reinterpret_cast<char *>(output.data()), deflatedSize, inflatedSize);
+                    succeeded = actualSize >= 0 && Inline::saturateInt32U(actualSize) == inflatedSize;
+                    if (!succeeded) {
+                        output.clear();
+                    }
+                }
+            }
+        }
+    }
+    return succeeded && !output.empty();
+}
+
+void
+SourceCache::writeBlob(const Digest &contentKey, const ByteArray &input, nanoem_u64_t &size, Error &error)
+{
+    const int inflatedSize = Inline::saturateInt32(input.size());
+    ByteArray deflated(LZ4_compressBound(inflatedSize));
+    const int deflatedSize = LZ4_compress_fast(reinterpret_cast<const char *>(input.data()),
+        reinterpret_cast<char *>(deflated.data()), inflatedSize, Inline::saturateInt32(deflated.size()), 1);
+    if (deflatedSize > 0) {
+        FileWriterScope scope;
+        if (scope.open(resolveFileURI(contentKey, kBlobExtension), error)) {
+            Digest checksum;
+            SHA256_CTX ctx;
+            sha256_init(&ctx);
+            sha256_update(&ctx, deflated.data(), deflatedSize);
+            sha256_final(&ctx, checksum.m_value);
+            IFileWriter *writer = scope.writer();
+            FileUtils::writeTyped(writer, kBlobSignature, error);
+            FileUtils::writeTyped(writer, Inline::saturateInt32U(inflatedSize), error);
+            FileUtils::writeTyped(writer, Inline::saturateInt32U(deflatedSize), error);
+            FileUtils::writeTyped(writer, checksum, error);
+            FileUtils::write(writer, deflated.data(), deflatedSize, error);
+            if (!error.hasReason()) {
+                scope.commit(error);
+                size = sizeof(nanoem_u32_t) * 3 + sizeof(checksum) + deflatedSize;
+            }
+        }
+    }
+}
+
+void
+SourceCache::loadIndex()
+{
+    if (!m_indexLoaded) {
+        String path(m_directoryURI.absolutePath());
+        path.append("/");
+        path.append(kIndexFilename);
+        const URI &indexURI = URI::createFromFilePath(path);
+        Error error;
+        if (FileUtils::exists(indexURI)) {
+            FileReaderScope scope(m_translator);
+            if (scope.open(indexURI, error)) {
+                IFileReader *reader = scope.reader();
+                nanoem_u32_t signature = 0, numEntries = 0;
+                FileUtils::readTyped(reader, signature, error);
+                FileUtils::readTyped(reader, numEntries, error);
+                if (signature == kIndexSignature && numEntries <= reader->size() / kIndexEntryMinimumSize) {
+                    for (nanoem_u32_t i = 0; i < numEntries && !error.hasReason(); i++) {
+                        Entry entry;
+                        nanoem_u32_t numSourceKeys = 0;
+                        FileUtils::readTyped(reader, entry.m_key, error);
+                        FileUtils::readTyped(reader, entry.m_size, error);
+                        FileUtils::readTyped(reader, entry.m_sequence, error);
+                        FileUtils::readTyped(reader, numSourceKeys, error);
+                        if (numSourceKeys > reader->size() / sizeof(Digest)) {
+                            break;
+                        }
+                        entry.m_sourceKeys.resize(numSourceKeys);
+                        for (nanoem_u32_t j = 0; j < numSourceKeys; j++) {
+                            FileUtils::readTyped(reader, entry.m_sourceKeys[j], error);
+                        }
+                        m_entries.push_back(entry);
+                        m_sequence = glm::max(m_sequence, entry.m_sequence);
+                    }
+                }
+            }
+        }
+        m_indexLoaded = true;
+    }
+}
+
+void
+SourceCache::saveIndex(Error &error)
+{
+    String path(m_directoryURI.absolutePath());
+    path.append("/");
+    path.append(kIndexFilename);
+    FileWriterScope scope;
+    if (scope.open(URI::createFromFilePath(path), error)) {
+        IFileWriter *writer = scope.writer();
+        const nanoem_u32_t numEntries = Inline::saturateInt32U(m_entries.size());
+        FileUtils::writeTyped(writer, kIndexSignature, error);
+        FileUtils::writeTyped(writer, numEntries, error);
+        for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+            const nanoem_u32_t numSourceKeys = Inline::saturateInt32U(it->m_sourceKeys.size());
+            FileUtils::writeTyped(writer, it->m_key, error);
+            FileUtils::writeTyped(writer, it->m_size, error);
+            FileUtils::writeTyped(writer, it->m_sequence, error);
+            FileUtils::writeTyped(writer, numSourceKeys, error);
+            for (DigestList::const_iterator it2 = it->m_sourceKeys.begin(), end2 = it->m_sourceKeys.end();
+                 it2 != end2; ++it2) {
+                FileUtils::writeTyped(writer, *it2, error);
+            }
+        }
+        if (!error.hasReason()) {
+            scope.commit(error);
+        }
+    }
+}
+
+void
+SourceCache::touch(const Digest &contentKey, const Digest &sourceKey, nanoem_u64_t size)
+{
+    loadIndex();
+    Entry *entryPtr = nullptr;
+    for (EntryList::iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+        if (equalsDigest(it->m_key, contentKey)) {
+            entryPtr = &*it;
+        }
+        else {
+            /* the manifest is rewritten to point the blob so evicting others must not delete it */
+            removeDigest(it->m_sourceKeys, sourceKey);
+        }
+    }
+    if (!entryPtr) {
+        Entry entry;
+        entry.m_key = contentKey;
+        m_entries.push_back(entry);
+        entryPtr = &m_entries.back();
+    }
+    if (!containsDigest(entryPtr->m_sourceKeys, sourceKey)) {
+        entryPtr->m_sourceKeys.push_back(sourceKey);
+    }
+    entryPtr->m_size = size;
+    entryPtr->m_sequence = ++m_sequence;
+}
+
+void
+SourceCache::evict()
+{
+    nanoem_u64_t total = usage();
+    /* the most recently used entry is always kept even if it exceeds the capacity by itself */
+    while (total > m_capacity && m_entries.size() > 1) {
+        EntryList::iterator oldest = m_entries.begin();
+        for (EntryList::iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+            if (it->m_sequence < oldest->m_sequence) {
+                oldest = it;
+            }
+        }
+        /* manifests are deleted with the blob so these never point the missing one */
+        for (DigestList::const_iterator it = oldest->m_sourceKeys.begin(), end = oldest->m_sourceKeys.end();
+             it != end; ++it) {
+            FileUtils::deleteFile(resolveFileURI(*it, kManifestExtension));
+        }
+        FileUtils::deleteFile(resolveFileURI(oldest->m_key, kBlobExtension));
+        total -= oldest->m_size;
+        m_entries.erase(oldest);
+    }
+}
+
+} /* namespace effect */
+} /* namespace nanoem */
@@ -950,7 +950,8 @@ CapturingPassState::transitDestruction(Project *project)
     case internal::CapturingPassState::kInitialized:
     case internal::CapturingPassState::kConfigured:
     case internal::CapturingPassState::kReady:
-    case internal::CapturingPassState::kBlitted: {
+    case internal::CapturingPassState::kBlitted:
+    case internal::CapturingPassState::kDraining: {
         cancel();
         break;
     }
@@ -1079,11 +1080,7 @@ CapturingPassState::readPassImage()
 {
     sg::read_pass(m_outputPass, m_frameStagingBuffer, m_frameImageData.data(), m_frameImageData.size());
     if (m_outputImageDescription.pixel_format == SG_PIXELFORMAT_RGBA8) {
-        nanoem_u32_t *dataPtr = reinterpret_cast<nanoem_u32_t *>(m_frameImageData.data());
-        for (size_t i = 0, size = m_frameImageData.size() / sizeof(*dataPtr); i < size; i++) {
-            nanoem_u32_t *ptr = dataPtr + i, v = *ptr;
-            *ptr = 0 | ((v & 0x000000ff) << 16) | (v & 0x0000ff00) | ((v & 0x00ff0000) >> 16) | (v & 0xff000000);
-        }
+        VideoEncodingPipeline::swizzleRGBA8(m_frameImageData.data(), m_frameImageData.size());
     }
 }
 
@@ -1175,6 +1172,9 @@ CapturingPassAsVideoState::CapturingPassAsVideoState(StateController *stateContr
     , m_encoderPluginPtr(nullptr)
     , m_videoRecorder(nullptr)
     , m_destroyingVideoRecorder(nullptr)
+    , m_pipeline(nullptr)
+    , m_stagingBufferOffset(0)
+    , m_numInflightReads(0)
     , m_endFrameIndex(project->duration())
     , m_amount(0)
 {
@@ -1213,6 +1213,9 @@ CapturingPassAsVideoState::start(Error &error)
                 NANOEM_APPLICATION_PLUGIN_ENCODER_OPTION_AUDIO_NUM_FREQUENCY, audio->sampleRate(), error);
         }
         if (m_encoderPluginPtr->open(m_fileURI, error)) {
+            createAllStagingBuffers();
+            m_pipeline = nanoem_new(VideoEncodingPipeline(this, VideoEncodingPipeline::kDefaultNumFrames));
+            m_pipeline->start();
             m_state = kInitialized;
         }
         else {
@@ -1262,10 +1265,25 @@ void
 CapturingPassAsVideoState::cancel()
 {
     Error error;
+    if (m_pipeline) {
+        /* drops queued frames instead of encoding them */
+        m_pipeline->cancel();
+    }
     stopEncoding(error);
     m_state = kCancelled;
 }
 
+void
+CapturingPassAsVideoState::save(Project *project)
+{
+    CapturingPassState::save(project);
+    /* simulates physics of the range at once and replays it so capturing is bound to skinning and rendering only */
+    if (project->isPhysicsSimulationEnabled() &&
+        !project->hasBakedPhysicsSimulation(m_startFrameIndex, m_endFrameIndex)) {
+        project->bakePhysicsSimulation(m_startFrameIndex, m_endFrameIndex);
+    }
+}
+
 void
 CapturingPassAsVideoState::restore(Project *project)
 {
@@ -1366,9 +1384,9 @@ CapturingPassAsVideoState::handleCaptureViaEncoderPlugin(Project *project, nanoe
     Error &error)
 {
     struct AsyncReadHandler {
-        AsyncReadHandler(CapturingPassAsVideoState *state, nanoem_frame_index_t videoFrameIndex)
+        AsyncReadHandler(CapturingPassAsVideoState *state, VideoEncodingPipeline::Frame *frame)
             : m_state(state)
-            , m_videoFrameIndex(videoFrameIndex)
+            , m_frame(frame)
         {
         }
         ~AsyncReadHandler()
@@ -1379,32 +1397,27 @@ CapturingPassAsVideoState::handleCaptureViaEncoderPlugin(Project *project, nanoe
         {
             AsyncReadHandler *self = static_cast<AsyncReadHandler *>(opaque);
             CapturingPassAsVideoState *state = self->m_state;
-            Error error;
-            if (state->m_frameImageData.size() == size) {
-                memcpy(state->m_frameImageData.data(), data, size);
-                if (state->m_outputImageDescription.pixel_format == SG_PIXELFORMAT_RGBA8) {
-                    nanoem_u32_t *dataPtr = reinterpret_cast<nanoem_u32_t *>(state->m_frameImageData.data());
-                    for (size_t i = 0, numPixels = size / sizeof(*dataPtr); i < numPixels; i++) {
-                        nanoem_u32_t *ptr = dataPtr + i, v = *ptr;
-                        *ptr = 0 | ((v & 0x000000ff) << 16) | (v & 0x0000ff00) | ((v & 0x00ff0000) >> 16) |
-                            (v & 0xff000000);
-                    }
+            state->m_numInflightReads--;
+            /* the frame has been already released with the pipeline when encoding is stopped */
+            if (VideoEncodingPipeline *pipeline = state->m_pipeline) {
+                VideoEncodingPipeline::Frame *frame = self->m_frame;
+                if (state->m_frameImageData.size() == size) {
+                    frame->m_videoData.resize(size);
+                    memcpy(frame->m_videoData.data(), data, size);
+                    state->enqueueFrame(frame);
                 }
-                if (!state->encodeVideoFrame(state->m_frameImageData, self->m_videoFrameIndex, error)) {
+                else {
+                    Error error;
+                    pipeline->discard(frame);
                     state->stopEncoding(error);
                     state->m_state = kCancelled;
                 }
             }
-            else {
-                state->stopEncoding(error);
-                state->m_state = kCancelled;
-            }
             nanoem_delete(self);
         }
         CapturingPassAsVideoState *m_state;
-        nanoem_frame_index_t m_videoFrameIndex;
+        VideoEncodingPipeline::Frame *m_frame;
     };
-    BX_UNUSED_1(error);
     m_blitter->blit(m_outputPass);
     if (m_state == kReady) {
         /* same as blit except without calculation of frame index */
@@ -1414,41 +1427,98 @@ CapturingPassAsVideoState::handleCaptureViaEncoderPlugin(Project *project, nanoe
         }
     }
     else if (m_state == kBlitted) {
-        if (sg::read_pass_async) {
-            AsyncReadHandler *handler = nanoem_new(AsyncReadHandler(this, videoFrameIndex));
-            sg::read_pass_async(m_outputPass, m_frameStagingBuffer, &AsyncReadHandler::handleReadPassAsync, handler);
+        VideoEncodingPipeline::Frame *frame = nullptr;
+        if (m_pipeline->isFailed()) {
+            stopEncoding(error);
+            m_state = kCancelled;
         }
-        else {
-            readPassImage();
-            if (!encodeVideoFrame(m_frameImageData, videoFrameIndex, error)) {
-                m_state = kCancelled;
+        /* keeps the current frame index to retry at the next tick when the encoder thread falls behind */
+        else if (m_numInflightReads < m_stagingBuffers.size() && (frame = m_pipeline->tryAcquire()) != nullptr) {
+            const sg_buffer stagingBuffer = m_stagingBuffers[m_stagingBufferOffset++ % m_stagingBuffers.size()];
+            frame->m_pts = videoFrameIndex;
+            if (sg::read_pass_async) {
+                AsyncReadHandler *handler = nanoem_new(AsyncReadHandler(this, frame));
+                m_numInflightReads++;
+                sg::read_pass_async(m_outputPass, stagingBuffer, &AsyncReadHandler::handleReadPassAsync, handler);
+            }
+            else {
+                frame->m_videoData.resize(m_frameImageData.size());
+                sg::read_pass(m_outputPass, stagingBuffer, frame->m_videoData.data(), frame->m_videoData.size());
+                enqueueFrame(frame);
+            }
+            calculateFrameIndex(deltaScaleFactor, m_amount, frameIndex);
+            if (frameIndex > m_endFrameIndex && m_numInflightReads > 0) {
+                m_state = kDraining;
+            }
+            else {
+                seekAndProgress(project, frameIndex, durationFrameIndices);
             }
         }
-        calculateFrameIndex(deltaScaleFactor, m_amount, frameIndex);
-        seekAndProgress(project, frameIndex, durationFrameIndices);
+    }
+    else if (m_state == kDraining && m_numInflightReads == 0) {
+        m_state = kFinished;
     }
 }
 
 bool
-CapturingPassAsVideoState::encodeVideoFrame(const ByteArray &frameData, nanoem_frame_index_t pts, Error &error)
+CapturingPassAsVideoState::encodeAudioFrame(
+    nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error)
 {
-    bool continuable = true;
-    if (m_encoderPluginPtr && (m_lastPTS == Motion::kMaxFrameIndex || pts > m_lastPTS)) {
+    return m_encoderPluginPtr->encodeAudioFrame(pts, data, size, error);
+}
+
+bool
+CapturingPassAsVideoState::encodeVideoFrame(
+    nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error)
+{
+    return m_encoderPluginPtr->encodeVideoFrame(pts, data, size, error);
+}
+
+void
+CapturingPassAsVideoState::createAllStagingBuffers()
+{
+    sg_buffer_desc desc;
+    Inline::clearZeroMemory(desc);
+    desc.size = m_frameImageData.size();
+    desc.usage = SG_USAGE_STREAM;
+    if (Inline::isDebugLabelEnabled()) {
+        desc.label = "@nanoem/CapturingPassAsVideoState/FrameStagingBuffer";
+    }
+    m_stagingBuffers.push_back(m_frameStagingBuffer);
+    for (nanoem_rsize_t i = 1; i < kNumStagingBuffers; i++) {
+        sg_buffer buffer = sg::make_buffer(&desc);
+        nanoem_assert(sg::query_buffer_state(buffer) == SG_RESOURCESTATE_VALID, "frame staging buffer must be valid");
+        SG_LABEL_BUFFER(buffer, desc.label);
+        m_stagingBuffers.push_back(buffer);
+    }
+}
+
+void
+CapturingPassAsVideoState::enqueueFrame(VideoEncodingPipeline::Frame *frame)
+{
+    const nanoem_frame_index_t pts = frame->m_pts;
+    if (m_lastPTS == Motion::kMaxFrameIndex || pts > m_lastPTS) {
+        if (m_outputImageDescription.pixel_format == SG_PIXELFORMAT_RGBA8) {
+            VideoEncodingPipeline::swizzleRGBA8(frame->m_videoData.data(), frame->m_videoData.size());
+        }
         const IAudioPlayer *audioPlayer = m_project->audioPlayer();
         const ByteArray *samplesPtr = audioPlayer->linearPCMSamples();
+        frame->m_audioData.clear();
         if (audioPlayer->isLoaded() && !samplesPtr->empty()) {
             const size_t bufferSize = size_t(audioPlayer->numChannels() * audioPlayer->sampleRate() *
                 (audioPlayer->bitsPerSample() / 8) * m_project->invertedPreferredMotionFPS());
             const size_t offset = size_t(pts * bufferSize);
-            ByteArray slice(bufferSize);
-            memcpy(slice.data(), samplesPtr->data() + offset, bufferSize);
-            continuable &=
-                m_encoderPluginPtr->encodeAudioFrame(nanoem_frame_index_t(pts), slice.data(), slice.size(), error);
+            if (offset + bufferSize <= samplesPtr->size()) {
+                frame->m_audioData.resize(bufferSize);
+                memcpy(frame->m_audioData.data(), samplesPtr->data() + offset, bufferSize);
+            }
         }
-        continuable &= m_encoderPluginPtr->encodeVideoFrame(pts, frameData.data(), frameData.size(), error);
+        m_pipeline->submit(frame);
         m_lastPTS = pts;
     }
-    return continuable;
+    else {
+        m_pipeline->discard(frame);
+    }
 }
 
 void
@@ -1496,6 +1566,10 @@ void
 CapturingPassAsVideoState::stopEncoding(Error &error)
 {
     if (m_encoderPluginPtr) {
+        if (m_pipeline) {
+            m_pipeline->finish(error);
+            nanoem_delete_safe(m_pipeline);
+        }
         m_encoderPluginPtr->close(error);
         m_encoderPluginPtr->wait();
         m_encoderPluginPtr = nullptr;
@@ -1507,6 +1581,11 @@ void
 CapturingPassAsVideoState::destroy()
 {
     CapturingPassState::destroy();
+    /* the first one is owned by CapturingPassState */
+    for (nanoem_rsize_t i = 1, numBuffers = m_stagingBuffers.size(); i < numBuffers; i++) {
+        sg::destroy_buffer(m_stagingBuffers[i]);
+    }
+    m_stagingBuffers.clear();
     if (m_destroyingVideoRecorder) {
         BaseApplicationService *application = m_stateControllerPtr->application();
         application->destroyVideoRecorder(m_destroyingVideoRecorder);
@@ -0,0 +1,224 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/ContentDigest.h"
+
+#include "emapp/internal/ParallelTaskDispatcher.h"
+#include "emapp/private/CommonInclude.h"
+
+#include "sha256.h"
+
+namespace nanoem {
+namespace internal {
+namespace {
+
+static const nanoem_rsize_t kFast128DigestSize = 16;
+
+static inline nanoem_u64_t
+rotateLeft64(nanoem_u64_t value, int shift) NANOEM_DECL_NOEXCEPT
+{
+    return (value << shift) | (value >> (64 - shift));
+}
+
+static inline nanoem_u64_t
+finalizeMix64(nanoem_u64_t value) NANOEM_DECL_NOEXCEPT
+{
+    value ^= value >> 33;
+    value *= 0xff51afd7ed558ccdULL;
+    value ^= value >> 33;
+    value *= 0xc4ceb9fe1a85ec53ULL;
+    value ^= value >> 33;
+    return value;
+}
+
+/* MurmurHash3_x64_128 with seed 0 */
+static void
+hashFast128(const nanoem_u8_t *data, nanoem_rsize_t size, nanoem_u8_t *digest) NANOEM_DECL_NOEXCEPT
+{
+    static const nanoem_u64_t c1 = 0x87c37b91114253d5ULL, c2 = 0x4cf5ad432745937fULL;
+    const nanoem_rsize_t numBlocks = size / 16;
+    nanoem_u64_t h1 = 0, h2 = 0, k1, k2;
+    for (nanoem_rsize_t i = 0; i < numBlocks; i++) {
+        memcpy(&k1, data + i * 16, sizeof(k1));
+        memcpy(&k2, data + i * 16 + 8, sizeof(k2));
+        k1 *= c1;
+        k1 = rotateLeft64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+        h1 = rotateLeft64(h1, 27);
+        h1 += h2;
+        h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2;
+        k2 = rotateLeft64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+        h2 = rotateLeft64(h2, 31);
+        h2 += h1;
+        h2 = h2 * 5 + 0x38495ab5;
+    }
+    const nanoem_u8_t *tail = data + numBlocks * 16;
+    const nanoem_rsize_t rest = size & 15;
+    k1 = k2 = 0;
+    for (nanoem_rsize_t i = rest; i > 8; i--) {
+        k2 |= nanoem_u64_t(tail[i - 1]) << ((i - 9) * 8);
+    }
+    if (rest > 8) {
+        k2 *= c2;
+        k2 = rotateLeft64(k2, 33);
+        k2 *= c1;
+        h2 ^= k2;
+    }
+    for (nanoem_rsize_t i = glm::min(rest, nanoem_rsize_t(8)); i > 0; i--) {
+        k1 |= nanoem_u64_t(tail[i - 1]) << ((i - 1) * 8);
+    }
+    if (rest > 0) {
+        k1 *= c1;
+        k1 = rotateLeft64(k1, 31);
+        k1 *= c2;
+        h1 ^= k1;
+    }
+    h1 ^= nanoem_u64_t(size);
+    h2 ^= nanoem_u64_t(size);
+    h1 += h2;
+    h2 += h1;
+    h1 = finalizeMix64(h1);
+    h2 = finalizeMix64(h2);
+    h1 += h2;
+    h2 += h1;
+    memcpy(digest, &h1, sizeof(h1));
+    memcpy(digest + sizeof(h1), &h2, sizeof(h2));
+}
+
+static void
+hashFast128ChunkDigests(ByteArray &chunkDigests, nanoem_u64_t totalSize, nanoem_u8_t *digest)
+{
+    for (nanoem_rsize_t i = 0; i < sizeof(totalSize); i++) {
+        chunkDigests.push_back(nanoem_u8_t((totalSize >> (i * 8)) & 0xff));
+    }
+    hashFast128(chunkDigests.data(), chunkDigests.size(), digest);
+}
+
+struct ParallelChunk {
+    const nanoem_u8_t *m_data;
+    nanoem_rsize_t m_size;
+    nanoem_u8_t *m_digests;
+};
+
+static void
+hashFast128Chunk(void *opaque, size_t index)
+{
+    const ParallelChunk *chunk = static_cast<const ParallelChunk *>(opaque);
+    const nanoem_rsize_t offset = index * ContentDigest::kFastChunkSize;
+    const nanoem_rsize_t size = glm::min(chunk->m_size - offset, ContentDigest::kFastChunkSize);
+    hashFast128(chunk->m_data + offset, size, chunk->m_digests + index * kFast128DigestSize);
+}
+
+} /* namespace anonymous */
+
+nanoem_rsize_t
+ContentDigest::digestSize(AlgorithmType value) NANOEM_DECL_NOEXCEPT
+{
+    return value == kAlgorithmTypeFast128 ? kFast128DigestSize : SHA256_BLOCK_SIZE;
+}
+
+void
+ContentDigest::calculate(AlgorithmType algorithm, const nanoem_u8_t *data, nanoem_rsize_t size,
+    ParallelTaskDispatcher *dispatcher, nanoem_u8_t *digest)
+{
+    if (algorithm == kAlgorithmTypeFast128 && dispatcher && size > kFastChunkSize) {
+        const nanoem_rsize_t numChunks = (size + kFastChunkSize - 1) / kFastChunkSize;
+        ByteArray chunkDigests(numChunks * kFast128DigestSize);
+        ParallelChunk chunk = { data, size, chunkDigests.data() };
+        dispatcher->dispatch(hashFast128Chunk, &chunk, numChunks);
+        hashFast128ChunkDigests(chunkDigests, size, digest);
+    }
+    else {
+        ContentDigest context(algorithm);
+        context.update(data, size);
+        context.finalize(digest);
+    }
+}
+
+ContentDigest::ContentDigest(AlgorithmType algorithm)
+    : m_algorithm(algorithm)
+    , m_context(nullptr)
+    , m_totalSize(0)
+{
+    if (m_algorithm == kAlgorithmTypeSHA256) {
+        SHA256_CTX *context = nanoem_new(SHA256_CTX);
+        sha256_init(context);
+        m_context = context;
+    }
+}
+
+ContentDigest::~ContentDigest() NANOEM_DECL_NOEXCEPT
+{
+    SHA256_CTX *context = static_cast<SHA256_CTX *>(m_context);
+    nanoem_delete(context);
+    m_context = nullptr;
+}
+
+void
+ContentDigest::update(const nanoem_u8_t *data, nanoem_rsize_t size)
+{
+    if (m_algorithm == kAlgorithmTypeSHA256) {
+        sha256_update(static_cast<SHA256_CTX *>(m_context), data, size);
+    }
+    else {
+        m_totalSize += size;
+        while (size > 0) {
+            if (m_pendingChunk.empty() && size >= kFastChunkSize) {
+                /* hashes the whole chunk in place without copying to the pending one */
+                appendChunkDigest(data, kFastChunkSize);
+                data += kFastChunkSize;
+                size -= kFastChunkSize;
+            }
+            else {
+                const nanoem_rsize_t copySize = glm::min(kFastChunkSize - m_pendingChunk.size(), size);
+                m_pendingChunk.insert(m_pendingChunk.end(), data, data + copySize);
+                data += copySize;
+                size -= copySize;
+                if (m_pendingChunk.size() == kFastChunkSize) {
+                    appendChunkDigest(m_pendingChunk.data(), m_pendingChunk.size());
+                    m_pendingChunk.clear();
+                }
+            }
+        }
+    }
+}
+
+void
+ContentDigest::finalize(nanoem_u8_t *digest)
+{
+    if (m_algorithm == kAlgorithmTypeSHA256) {
+        sha256_final(static_cast<SHA256_CTX *>(m_context), digest);
+    }
+    else {
+        /* empty contents are treated as a single empty chunk */
+        if (!m_pendingChunk.empty() || m_chunkDigests.empty()) {
+            appendChunkDigest(m_pendingChunk.data(), m_pendingChunk.size());
+            m_pendingChunk.clear();
+        }
+        hashFast128ChunkDigests(m_chunkDigests, m_totalSize, digest);
+    }
+}
+
+ContentDigest::AlgorithmType
+ContentDigest::algorithm() const NANOEM_DECL_NOEXCEPT
+{
+    return m_algorithm;
+}
+
+void
+ContentDigest::appendChunkDigest(const nanoem_u8_t *data, nanoem_rsize_t size)
+{
+    nanoem_u8_t digest[kFast128DigestSize];
+    hashFast128(data, size, digest);
+    m_chunkDigests.insert(m_chunkDigests.end(), digest, digest + sizeof(digest));
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
@@ -0,0 +1,235 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/DecodedImageCache.h"
+
+#include "emapp/internal/ContentDigest.h"
+#include "emapp/private/CommonInclude.h"
+
+namespace nanoem {
+namespace internal {
+
+DecodedImage::DecodedImage()
+{
+    Inline::clearZeroMemory(m_description);
+}
+
+void
+DecodedImage::assign(const sg_image_desc &desc)
+{
+    /* ranges may point to the buffer of the decoder to be freed soon so all of them are copied to own payloads */
+    nanoem_rsize_t numPayloads = 0;
+    for (int i = 0; i < SG_CUBEFACE_NUM; i++) {
+        for (int j = 0; j < SG_MAX_MIPMAPS; j++) {
+            numPayloads += desc.data.subimage[i][j].ptr ? 1 : 0;
+        }
+    }
+    m_description = desc;
+    m_payloads.clear();
+    m_payloads.resize(numPayloads);
+    nanoem_rsize_t offset = 0;
+    for (int i = 0; i < SG_CUBEFACE_NUM; i++) {
+        for (int j = 0; j < SG_MAX_MIPMAPS; j++) {
+            const sg_range &source = desc.data.subimage[i][j];
+            if (source.ptr) {
+                const nanoem_u8_t *dataPtr = static_cast<const nanoem_u8_t *>(source.ptr);
+                ByteArray &bytes = m_payloads[offset++];
+                bytes.assign(dataPtr, dataPtr + source.size);
+                sg_range &dest = m_description.data.subimage[i][j];
+                dest.ptr = bytes.data();
+                dest.size = bytes.size();
+            }
+        }
+    }
+}
+
+nanoem_rsize_t
+DecodedImage::sizeInBytes() const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_rsize_t size = 0;
+    for (ByteArrayList::const_iterator it = m_payloads.begin(), end = m_payloads.end(); it != end; ++it) {
+        size += it->size();
+    }
+    return size;
+}
+
+DecodedImageCache::Key
+DecodedImageCache::Key::create(
+    const nanoem_u8_t *data, nanoem_rsize_t size, nanoem_u32_t flags, ParallelTaskDispatcher *dispatcher)
+{
+    Key key;
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeFast128, data, size, dispatcher, key.m_digest);
+    key.m_flags = flags;
+    return key;
+}
+
+bool
+DecodedImageCache::Key::equals(const Key &value) const NANOEM_DECL_NOEXCEPT
+{
+    return m_flags == value.m_flags && memcmp(m_digest, value.m_digest, sizeof(m_digest)) == 0;
+}
+
+DecodedImageCache::DecodedImageCache(nanoem_rsize_t budget)
+    : m_budget(budget)
+    , m_memoryUsage(0)
+    , m_sequence(0)
+{
+}
+
+DecodedImageCache::~DecodedImageCache() NANOEM_DECL_NOEXCEPT
+{
+    for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+        Entry *entry = *it;
+        nanoem_delete(entry->m_image);
+        nanoem_delete(entry);
+    }
+    m_entries.clear();
+}
+
+const DecodedImage *
+DecodedImageCache::acquire(const Key &key)
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    const DecodedImage *image = nullptr;
+    if (Entry *entry = findEntry(key)) {
+        entry->m_numReferences++;
+        entry->m_sequence = ++m_sequence;
+        image = entry->m_image;
+    }
+    return image;
+}
+
+const DecodedImage *
+DecodedImageCache::insert(const Key &key, DecodedImage *image)
+{
+    nanoem_parameter_assert(image, "must not be nullptr");
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    Entry *entry = findEntry(key);
+    if (entry) {
+        /* another thread has decoded the same image while this one was decoding */
+        nanoem_delete(image);
+    }
+    else {
+        entry = nanoem_new(Entry);
+        entry->m_key = key;
+        entry->m_image = image;
+        entry->m_size = image->sizeInBytes();
+        entry->m_numReferences = 0;
+        m_entries.push_back(entry);
+        m_memoryUsage += entry->m_size;
+    }
+    entry->m_numReferences++;
+    entry->m_sequence = ++m_sequence;
+    evictUnreferencedEntries(m_budget);
+    return entry->m_image;
+}
+
+void
+DecodedImageCache::release(const DecodedImage *image)
+{
+    if (image) {
+        bx::MutexScope locker(m_mutex);
+        BX_UNUSED_1(locker);
+        for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+            Entry *entry = *it;
+            if (entry->m_image == image) {
+                nanoem_assert(entry->m_numReferences > 0, "must be referenced");
+                entry->m_numReferences--;
+                break;
+            }
+        }
+        evictUnreferencedEntries(m_budget);
+    }
+}
+
+void
+DecodedImageCache::purge()
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    evictUnreferencedEntries(0);
+}
+
+nanoem_rsize_t
+DecodedImageCache::budget() const NANOEM_DECL_NOEXCEPT
+{
+    return m_budget;
+}
+
+void
+DecodedImageCache::setBudget(nanoem_rsize_t value)
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    m_budget = value;
+    evictUnreferencedEntries(m_budget);
+}
+
+nanoem_rsize_t
+DecodedImageCache::memoryUsage() const NANOEM_DECL_NOEXCEPT
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    return m_memoryUsage;
+}
+
+nanoem_rsize_t
+DecodedImageCache::numEntries() const NANOEM_DECL_NOEXCEPT
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    return m_entries.size();
+}
+
+DecodedImageCache::Entry *
+DecodedImageCache::findEntry(const Key &key) NANOEM_DECL_NOEXCEPT
+{
+    Entry *found = nullptr;
+    for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+        Entry *entry = *it;
+        if (entry->m_key.equals(key)) {
+            found = entry;
+            break;
+        }
+    }
+    return found;
+}
+
+void
+DecodedImageCache::evictUnreferencedEntries(nanoem_rsize_t budget)
+{
+    while (m_memoryUsage > budget) {
+        nanoem_rsize_t index = m_entries.size();
+        nanoem_u64_t sequence = ~nanoem_u64_t(0);
+        for (nanoem_rsize_t i = 0, numEntries = m_entries.size(); i < numEntries; i++) {
+            const Entry *entry = m_entries[i];
+            if (entry->m_numReferences == 0 && entry->m_sequence < sequence) {
+                sequence = entry->m_sequence;
+                index = i;
+            }
+        }
+        if (index == m_entries.size()) {
+            /* all of remaining entries are in use */
+            break;
+        }
+        destroyEntry(index);
+    }
+}
+
+void
+DecodedImageCache::destroyEntry(nanoem_rsize_t index)
+{
+    Entry *entry = m_entries[index];
+    m_memoryUsage -= entry->m_size;
+    m_entries.erase(m_entries.begin() + index);
+    nanoem_delete(entry->m_image);
+    nanoem_delete(entry);
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
@@ -0,0 +1,178 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/FileContentDigestCache.h"
+
+#include "emapp/internal/ContentDigest.h"
+#include "emapp/private/CommonInclude.h"
+
+namespace nanoem {
+namespace internal {
+
+FileContentDigestCache::FileContentDigestCache()
+    : m_dispatcher("com.github.nanoem.gcd.digest")
+{
+}
+
+FileContentDigestCache::~FileContentDigestCache() NANOEM_DECL_NOEXCEPT
+{
+    releaseAllMappedFiles();
+}
+
+void
+FileContentDigestCache::prefetch(const URIList &fileURIs)
+{
+    PrefetchingFileList files;
+    for (URIList::const_iterator it = fileURIs.begin(), end = fileURIs.end(); it != end; ++it) {
+        const URI &fileURI = *it;
+        if (isCacheable(fileURI) && !findMappedFile(fileURI)) {
+            PrefetchingFile file;
+            file.m_fileURI = fileURI;
+            file.m_reader = nanoem_new(MappedFileReader(nullptr));
+            const Entry *cachedEntry = findEntry(fileURI);
+            file.m_hasCachedEntry = cachedEntry != nullptr;
+            if (cachedEntry) {
+                file.m_cachedEntry = *cachedEntry;
+            }
+            file.m_mapped = false;
+            files.push_back(file);
+        }
+    }
+    if (!files.empty()) {
+        /* each file is hashed serially on a worker so no dispatch is nested */
+        m_dispatcher.dispatch(handlePrefetchFile, files.data(), files.size());
+    }
+    for (PrefetchingFileList::const_iterator it = files.begin(), end = files.end(); it != end; ++it) {
+        if (it->m_mapped) {
+            insertEntry(it->m_fileURI, it->m_entry);
+            m_mappedFiles.insert(tinystl::make_pair(it->m_fileURI.absolutePath(), it->m_reader));
+        }
+        else {
+            nanoem_delete(it->m_reader);
+        }
+    }
+}
+
+bool
+FileContentDigestCache::calculate(const URI &fileURI, nanoem_u8_t *digest, Error &error)
+{
+    const Entry *cachedEntry = findEntry(fileURI);
+    bool succeeded = false;
+    if (cachedEntry && findMappedFile(fileURI)) {
+        /* the entry of the prefetched file is calculated from the mapped bytes so it is always up to date */
+        memcpy(digest, cachedEntry->m_digest, sizeof(cachedEntry->m_digest));
+        succeeded = true;
+    }
+    else {
+        MappedFileReader reader(nullptr);
+        if (reader.open(fileURI, error)) {
+            Entry entry;
+            calculateEntry(reader.bytes(), reader.size(), cachedEntry, &m_dispatcher, entry);
+            insertEntry(fileURI, entry);
+            memcpy(digest, entry.m_digest, sizeof(entry.m_digest));
+            succeeded = true;
+        }
+    }
+    return succeeded;
+}
+
+void
+FileContentDigestCache::update(const URI &fileURI, const nanoem_u8_t *data, nanoem_rsize_t size)
+{
+    if (isCacheable(fileURI)) {
+        Entry entry;
+        calculateEntry(data, size, findEntry(fileURI), &m_dispatcher, entry);
+        insertEntry(fileURI, entry);
+    }
+}
+
+MappedFileReader *
+FileContentDigestCache::findMappedFile(const URI &fileURI) NANOEM_DECL_NOEXCEPT
+{
+    MappedFileMap::const_iterator it = m_mappedFiles.find(fileURI.absolutePath());
+    return it != m_mappedFiles.end() ? it->second : nullptr;
+}
+
+void
+FileContentDigestCache::releaseAllMappedFiles()
+{
+    for (MappedFileMap::const_iterator it = m_mappedFiles.begin(), end = m_mappedFiles.end(); it != end; ++it) {
+        MappedFileReader *reader = it->second;
+        nanoem_delete(reader);
+    }
+    m_mappedFiles.clear();
+}
+
+void
+FileContentDigestCache::clear()
+{
+    releaseAllMappedFiles();
+    m_entries.clear();
+}
+
+nanoem_rsize_t
+FileContentDigestCache::numEntries() const NANOEM_DECL_NOEXCEPT
+{
+    return m_entries.size();
+}
+
+nanoem_rsize_t
+FileContentDigestCache::numMappedFiles() const NANOEM_DECL_NOEXCEPT
+{
+    return m_mappedFiles.size();
+}
+
+bool
+FileContentDigestCache::isCacheable(const URI &fileURI) NANOEM_DECL_NOEXCEPT
+{
+    /* the file inside of an archive cannot be opened by its path */
+    return !fileURI.isEmpty() && !fileURI.hasFragment();
+}
+
+void
+FileContentDigestCache::calculateEntry(const nanoem_u8_t *data, nanoem_rsize_t size, const Entry *cachedEntry,
+    ParallelTaskDispatcher *dispatcher, Entry &entry)
+{
+    entry.m_size = size;
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeFast128, data, size, dispatcher, entry.m_fastDigest);
+    if (cachedEntry && cachedEntry->m_size == entry.m_size &&
+        memcmp(cachedEntry->m_fastDigest, entry.m_fastDigest, sizeof(entry.m_fastDigest)) == 0) {
+        memcpy(entry.m_digest, cachedEntry->m_digest, sizeof(entry.m_digest));
+    }
+    else {
+        ContentDigest::calculate(ContentDigest::kAlgorithmTypeSHA256, data, size, nullptr, entry.m_digest);
+    }
+}
+
+void
+FileContentDigestCache::handlePrefetchFile(void *opaque, size_t index)
+{
+    PrefetchingFile &file = static_cast<PrefetchingFile *>(opaque)[index];
+    Error error;
+    if (file.m_reader->open(file.m_fileURI, error)) {
+        calculateEntry(file.m_reader->bytes(), file.m_reader->size(),
+            file.m_hasCachedEntry ? &file.m_cachedEntry : nullptr, nullptr, file.m_entry);
+        file.m_mapped = true;
+    }
+}
+
+const FileContentDigestCache::Entry *
+FileContentDigestCache::findEntry(const URI &fileURI) const
+{
+    EntryMap::const_iterator it = m_entries.find(fileURI.absolutePath());
+    return it != m_entries.end() ? &it->second : nullptr;
+}
+
+void
+FileContentDigestCache::insertEntry(const URI &fileURI, const Entry &entry)
+{
+    if (isCacheable(fileURI)) {
+        m_entries[fileURI.absolutePath()] = entry;
+    }
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
@@ -0,0 +1,188 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/FrameIndexBitmap.h"
+
+#include "emapp/private/CommonInclude.h"
+
+#include "bx/uint32_t.h"
+
+namespace nanoem {
+namespace internal {
+
+FrameIndexBitmap::FrameIndexBitmap()
+{
+}
+
+FrameIndexBitmap::~FrameIndexBitmap() NANOEM_DECL_NOEXCEPT
+{
+}
+
+bool
+FrameIndexBitmap::contains(nanoem_frame_index_t frameIndex) const NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_frame_index_t offset = frameIndex / kNumBitsPerWord;
+    const nanoem_rsize_t index = lowerBound(offset);
+    return index < m_words.size() && m_words[index].m_offset == offset &&
+        (m_words[index].m_bits & (nanoem_u64_t(1) << (frameIndex % kNumBitsPerWord))) != 0;
+}
+
+void
+FrameIndexBitmap::set(nanoem_frame_index_t frameIndex)
+{
+    assign(frameIndex, frameIndex, true);
+}
+
+void
+FrameIndexBitmap::reset(nanoem_frame_index_t frameIndex)
+{
+    assign(frameIndex, frameIndex, false);
+}
+
+void
+FrameIndexBitmap::setRange(nanoem_frame_index_t from, nanoem_frame_index_t to)
+{
+    if (from <= to) {
+        assign(from, to, true);
+    }
+}
+
+void
+FrameIndexBitmap::resetRange(nanoem_frame_index_t from, nanoem_frame_index_t to)
+{
+    if (from <= to) {
+        assign(from, to, false);
+    }
+}
+
+void
+FrameIndexBitmap::shift(nanoem_frame_index_t from, int delta)
+{
+    if (delta != 0) {
+        Motion::FrameIndexList frameIndices;
+        getAll(frameIndices);
+        resetRange(from, ~nanoem_frame_index_t(0));
+        if (delta < 0 && from > 0) {
+            const nanoem_frame_index_t distance = nanoem_frame_index_t(-delta);
+            resetRange(from > distance ? from - distance : 0, from - 1);
+        }
+        for (Motion::FrameIndexList::const_iterator it = frameIndices.begin(), end = frameIndices.end(); it != end;
+             ++it) {
+            const nanoem_frame_index_t frameIndex = *it;
+            if (frameIndex >= from && (delta > 0 || frameIndex >= nanoem_frame_index_t(-delta))) {
+                set(frameIndex + delta);
+            }
+        }
+    }
+}
+
+void
+FrameIndexBitmap::getAll(Motion::FrameIndexList &frameIndices) const
+{
+    for (WordList::const_iterator it = m_words.begin(), end = m_words.end(); it != end; ++it) {
+        const nanoem_frame_index_t base = it->m_offset * kNumBitsPerWord;
+        nanoem_u64_t bits = it->m_bits;
+        while (bits != 0) {
+            frameIndices.push_back(base + nanoem_frame_index_t(bx::uint64_cnttz(bits)));
+            bits &= bits - 1;
+        }
+    }
+}
+
+void
+FrameIndexBitmap::clear()
+{
+    m_words.clear();
+}
+
+nanoem_frame_index_t
+FrameIndexBitmap::first() const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_frame_index_t frameIndex = 0;
+    if (!m_words.empty()) {
+        const Word &word = m_words[0];
+        frameIndex = word.m_offset * kNumBitsPerWord + nanoem_frame_index_t(bx::uint64_cnttz(word.m_bits));
+    }
+    return frameIndex;
+}
+
+nanoem_rsize_t
+FrameIndexBitmap::count() const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_rsize_t numBits = 0;
+    for (WordList::const_iterator it = m_words.begin(), end = m_words.end(); it != end; ++it) {
+        numBits += nanoem_rsize_t(bx::uint64_cntbits(it->m_bits));
+    }
+    return numBits;
+}
+
+bool
+FrameIndexBitmap::isEmpty() const NANOEM_DECL_NOEXCEPT
+{
+    return m_words.empty();
+}
+
+nanoem_u64_t
+FrameIndexBitmap::mask(nanoem_frame_index_t from, nanoem_frame_index_t to) NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_u64_t upper = to >= kNumBitsPerWord - 1 ? ~nanoem_u64_t(0) : (nanoem_u64_t(1) << (to + 1)) - 1;
+    const nanoem_u64_t lower = (nanoem_u64_t(1) << from) - 1;
+    return upper & ~lower;
+}
+
+nanoem_rsize_t
+FrameIndexBitmap::lowerBound(nanoem_frame_index_t offset) const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_rsize_t low = 0, high = m_words.size();
+    while (low < high) {
+        const nanoem_rsize_t mid = low + ((high - low) >> 1);
+        if (m_words[mid].m_offset < offset) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+void
+FrameIndexBitmap::assign(nanoem_frame_index_t from, nanoem_frame_index_t to, bool value)
+{
+    const nanoem_frame_index_t fromOffset = from / kNumBitsPerWord, toOffset = to / kNumBitsPerWord;
+    nanoem_rsize_t index = lowerBound(fromOffset);
+    if (value) {
+        for (nanoem_frame_index_t offset = fromOffset; offset <= toOffset; offset++) {
+            const nanoem_u64_t bits = mask(offset == fromOffset ? from % kNumBitsPerWord : 0,
+                offset == toOffset ? to % kNumBitsPerWord : kNumBitsPerWord - 1);
+            if (index >= m_words.size() || m_words[index].m_offset != offset) {
+                m_words.insert(m_words.begin() + index, Word(offset));
+            }
+            m_words[index].m_bits |= bits;
+            index++;
+            if (offset == toOffset) {
+                break;
+            }
+        }
+    }
+    else {
+        /* only existing words are visited so resetting the whole timeline does not depend on its length */
+        while (index < m_words.size() && m_words[index].m_offset <= toOffset) {
+            Word &word = m_words[index];
+            word.m_bits &= ~mask(word.m_offset == fromOffset ? from % kNumBitsPerWord : 0,
+                word.m_offset == toOffset ? to % kNumBitsPerWord : kNumBitsPerWord - 1);
+            if (word.m_bits == 0) {
+                m_words.erase(m_words.begin() + index);
+            }
+            else {
+                index++;
+            }
+        }
+    }
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
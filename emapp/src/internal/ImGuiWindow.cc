@@ -1133,6 +1133,7 @@ ImGuiWindow::ImGuiWindow(BaseApplicationService *application)
     , m_modalDialogPressedButton(0)
     , m_projectKeyframeSelectorIndex(0)
     , m_modelKeyframeSelectorIndex(0)
+    , m_constraintHeatmapModelHandle(bx::kInvalidHandle)
     , m_requestClearAllModalDialogs(false)
     , m_draggingTimelineScrollBar(false)
     , m_lastKeyframeSelection(false)
@@ -4883,7 +4884,16 @@ ImGuiWindow::drawPrimitive2D(Project *project, IState *state, nanoem_u32_t flags
         state->onDrawPrimitive2D(&m_primitive2D);
     }
     Model *activeModel = project->activeModel();
-    if (activeModel && activeModel->isVisible()) {
+    const bool visible = activeModel && activeModel->isVisible();
+    if (m_constraintHeatmapModelHandle != bx::kInvalidHandle &&
+        (!visible || activeModel->handle() != m_constraintHeatmapModelHandle)) {
+        /* the model is no longer drawn with the heatmap so it stops capturing iteration results */
+        if (Model *lastModel = project->findModelByHandle(m_constraintHeatmapModelHandle)) {
+            lastModel->setAllConstraintIterationResultsCaptured(false);
+        }
+        m_constraintHeatmapModelHandle = bx::kInvalidHandle;
+    }
+    if (visible) {
         const Vector2SI32 deviceScaleCursor(project->deviceScaleMovingCursorPosition());
         Vector4 activeBoneColor(DrawUtils::kColorRed, 1);
         NoModalDialogWindowList::const_iterator it = m_dialogWindows.find(ModelParameterDialog::kIdentifier);
@@ -4898,7 +4908,10 @@ ImGuiWindow::drawPrimitive2D(Project *project, IState *state, nanoem_u32_t flags
         if (EnumUtils::isEnabled(IState::kDrawTypeConstraintConnections, flags)) {
             activeModel->drawConstraintConnections(&m_primitive2D, deviceScaleCursor);
         }
-        if (EnumUtils::isEnabled(IState::kDrawTypeConstraintHeatmaps, flags)) {
+        const bool drawConstraintHeatmaps = EnumUtils::isEnabled(IState::kDrawTypeConstraintHeatmaps, flags);
+        activeModel->setAllConstraintIterationResultsCaptured(drawConstraintHeatmaps);
+        m_constraintHeatmapModelHandle = drawConstraintHeatmaps ? activeModel->handle() : bx::kInvalidHandle;
+        if (drawConstraintHeatmaps) {
             activeModel->drawConstraintsHeatMap(&m_primitive2D);
         }
         if (EnumUtils::isEnabled(IState::kDrawTypeBoneMoveHandle, flags)) {
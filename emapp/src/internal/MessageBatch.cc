@@ -0,0 +1,154 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/MessageBatch.h"
+
+#include "emapp/private/CommonInclude.h"
+
+namespace nanoem {
+namespace internal {
+
+const nanoem_u32_t MessageBatch::kSignature = nanoem_fourcc('N', 'M', 'B', '1');
+
+MessageBatch::Statistics::Statistics()
+    : m_numBatches(0)
+    , m_numMessages(0)
+    , m_numCoalescedMessages(0)
+    , m_totalLatency(0)
+    , m_maxLatency(0)
+{
+}
+
+bool
+MessageBatch::dispatchAll(
+    const nanoem_u8_t *data, size_t size, pfn_dispatchMessage callback, void *userData, nanoem_u64_t *timestamp)
+{
+    Header header;
+    bool result = false;
+    if (size >= sizeof(header)) {
+        memcpy(&header, data, sizeof(header));
+        const nanoem_u8_t *begin = data + sizeof(header), *end = data + size, *ptr = begin;
+        nanoem_u32_t messageSize = 0;
+        result = header.m_signature == kSignature;
+        /* validate the whole frame before dispatching not to dispatch messages partially */
+        for (nanoem_u32_t i = 0; result && i < header.m_numMessages; i++) {
+            if (nanoem_rsize_t(end - ptr) >= sizeof(messageSize)) {
+                memcpy(&messageSize, ptr, sizeof(messageSize));
+                ptr += sizeof(messageSize);
+                result = messageSize <= nanoem_rsize_t(end - ptr);
+                ptr += result ? messageSize : 0;
+            }
+            else {
+                result = false;
+            }
+        }
+        if (result) {
+            ptr = begin;
+            for (nanoem_u32_t i = 0; i < header.m_numMessages; i++) {
+                memcpy(&messageSize, ptr, sizeof(messageSize));
+                ptr += sizeof(messageSize);
+                callback(userData, ptr, messageSize);
+                ptr += messageSize;
+            }
+            if (timestamp) {
+                *timestamp = header.m_timestamp;
+            }
+        }
+    }
+    return result;
+}
+
+MessageBatch::MessageBatch()
+    : m_numCoalescedMessages(0)
+{
+}
+
+MessageBatch::~MessageBatch() NANOEM_DECL_NOEXCEPT
+{
+}
+
+nanoem_u8_t *
+MessageBatch::allocate(nanoem_rsize_t size, nanoem_u32_t coalescingKey)
+{
+    if (coalescingKey != 0) {
+        EntryIndexMap::const_iterator it = m_coalescingEntryIndices.find(coalescingKey);
+        if (it != m_coalescingEntryIndices.end()) {
+            m_entries[it->second].m_superseded = true;
+            m_numCoalescedMessages++;
+        }
+        m_coalescingEntryIndices[coalescingKey] = m_entries.size();
+    }
+    Entry entry;
+    entry.m_offset = m_payload.size();
+    entry.m_size = size;
+    entry.m_superseded = false;
+    m_entries.push_back(entry);
+    m_payload.resize(entry.m_offset + size);
+    return m_payload.data() + entry.m_offset;
+}
+
+nanoem_rsize_t
+MessageBatch::encodedSize() const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_rsize_t size = sizeof(Header);
+    for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+        if (!it->m_superseded) {
+            size += sizeof(nanoem_u32_t) + it->m_size;
+        }
+    }
+    return size;
+}
+
+void
+MessageBatch::encode(nanoem_u64_t timestamp, nanoem_u8_t *data)
+{
+    Header header;
+    header.m_signature = kSignature;
+    header.m_numMessages = nanoem_u32_t(numMessages());
+    header.m_timestamp = timestamp;
+    memcpy(data, &header, sizeof(header));
+    nanoem_u8_t *ptr = data + sizeof(header);
+    for (EntryList::const_iterator it = m_entries.begin(), end = m_entries.end(); it != end; ++it) {
+        if (!it->m_superseded) {
+            const nanoem_u32_t size = nanoem_u32_t(it->m_size);
+            memcpy(ptr, &size, sizeof(size));
+            ptr += sizeof(size);
+            memcpy(ptr, m_payload.data() + it->m_offset, it->m_size);
+            ptr += it->m_size;
+        }
+    }
+    clear();
+}
+
+void
+MessageBatch::clear()
+{
+    m_payload.clear();
+    m_entries.clear();
+    m_coalescingEntryIndices.clear();
+    m_numCoalescedMessages = 0;
+}
+
+nanoem_rsize_t
+MessageBatch::numMessages() const NANOEM_DECL_NOEXCEPT
+{
+    return m_entries.size() - m_numCoalescedMessages;
+}
+
+nanoem_rsize_t
+MessageBatch::numCoalescedMessages() const NANOEM_DECL_NOEXCEPT
+{
+    return m_numCoalescedMessages;
+}
+
+bool
+MessageBatch::isEmpty() const NANOEM_DECL_NOEXCEPT
+{
+    return m_entries.empty();
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
@@ -7,10 +7,193 @@
 #include "emapp/internal/MotionKeyframeSelection.h"
 
 #include "emapp/EnumUtils.h"
-#include "emapp/ListUtils.h"
 
 namespace nanoem {
 namespace internal {
+namespace {
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_accessory_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionAccessoryKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_bone_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_camera_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_light_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionLightKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_model_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionModelKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_morph_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionMorphKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline nanoem_frame_index_t
+frameIndexOf(const nanoem_motion_self_shadow_keyframe_t *keyframe) NANOEM_DECL_NOEXCEPT
+{
+    return nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionSelfShadowKeyframeGetKeyframeObject(keyframe));
+}
+
+static inline void
+findKeyframe(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t frameIndex,
+    const nanoem_motion_accessory_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionFindAccessoryKeyframeObjectWithCursor(motion, cursor, frameIndex);
+}
+
+static inline void
+findKeyframe(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor,
+    nanoem_frame_index_t frameIndex, const nanoem_motion_bone_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionTrackFindBoneKeyframeObjectWithCursor(track, cursor, frameIndex);
+}
+
+static inline void
+findKeyframe(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t frameIndex,
+    const nanoem_motion_camera_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionFindCameraKeyframeObjectWithCursor(motion, cursor, frameIndex);
+}
+
+static inline void
+findKeyframe(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t frameIndex,
+    const nanoem_motion_light_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionFindLightKeyframeObjectWithCursor(motion, cursor, frameIndex);
+}
+
+static inline void
+findKeyframe(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t frameIndex,
+    const nanoem_motion_model_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionFindModelKeyframeObjectWithCursor(motion, cursor, frameIndex);
+}
+
+static inline void
+findKeyframe(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor,
+    nanoem_frame_index_t frameIndex, const nanoem_motion_morph_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionTrackFindMorphKeyframeObjectWithCursor(track, cursor, frameIndex);
+}
+
+static inline void
+findKeyframe(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t frameIndex,
+    const nanoem_motion_self_shadow_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionFindSelfShadowKeyframeObjectWithCursor(motion, cursor, frameIndex);
+}
+
+static bool
+findNextKeyframe(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor,
+    nanoem_frame_index_t frameIndex, const nanoem_motion_bone_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionTrackFindBoneKeyframeObjectWithCursor(track, cursor, frameIndex);
+    if (!keyframe) {
+        nanoem_motion_bone_keyframe_t *prevKeyframe = nullptr, *nextKeyframe = nullptr;
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, cursor, frameIndex, &prevKeyframe, &nextKeyframe);
+        /* the last keyframe is returned as the next one when no keyframe is after the frame index */
+        if (nextKeyframe && frameIndexOf(nextKeyframe) > frameIndex) {
+            keyframe = nextKeyframe;
+        }
+    }
+    return keyframe != nullptr;
+}
+
+static bool
+findNextKeyframe(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor,
+    nanoem_frame_index_t frameIndex, const nanoem_motion_morph_keyframe_t *&keyframe) NANOEM_DECL_NOEXCEPT
+{
+    keyframe = nanoemMotionTrackFindMorphKeyframeObjectWithCursor(track, cursor, frameIndex);
+    if (!keyframe) {
+        nanoem_motion_morph_keyframe_t *prevKeyframe = nullptr, *nextKeyframe = nullptr;
+        nanoemMotionTrackSearchClosestMorphKeyframesWithCursor(
+            track, cursor, frameIndex, &prevKeyframe, &nextKeyframe);
+        if (nextKeyframe && frameIndexOf(nextKeyframe) > frameIndex) {
+            keyframe = nextKeyframe;
+        }
+    }
+    return keyframe != nullptr;
+}
+
+template <typename TSource, typename TKeyframe>
+static void
+collectAllKeyframes(const TSource *source, const FrameIndexBitmap &selection,
+    tinystl::vector<const TKeyframe *, TinySTLAllocator> &keyframes)
+{
+    Motion::FrameIndexList frameIndices;
+    selection.getAll(frameIndices);
+    nanoem_motion_keyframe_cursor_t cursor;
+    nanoemMotionKeyframeCursorReset(&cursor);
+    for (Motion::FrameIndexList::const_iterator it = frameIndices.begin(), end = frameIndices.end(); it != end;
+         ++it) {
+        const TKeyframe *keyframe = nullptr;
+        findKeyframe(source, &cursor, *it, keyframe);
+        /* frame indices of removed keyframes are skipped */
+        if (keyframe) {
+            keyframes.push_back(keyframe);
+        }
+    }
+}
+
+template <typename TKeyframe>
+static void
+setStartOffset(const tinystl::vector<const TKeyframe *, TinySTLAllocator> &keyframes, int *startOffset)
+{
+    if (startOffset) {
+        nanoem_frame_index_t offset = keyframes.empty() ? 0 : frameIndexOf(keyframes[0]);
+        for (nanoem_rsize_t i = 1, numKeyframes = keyframes.size(); i < numKeyframes; i++) {
+            offset = glm::min(offset, frameIndexOf(keyframes[i]));
+        }
+        *startOffset = offset;
+    }
+}
+
+template <typename TKeyframe>
+static void
+setAllFrameIndicesInRange(TKeyframe *const *keyframes, nanoem_rsize_t numKeyframes, nanoem_frame_index_t start,
+    nanoem_frame_index_t end, FrameIndexBitmap &selection)
+{
+    /* global keyframes are ordered by the frame index so only keyframes in the range are visited */
+    nanoem_rsize_t low = 0, high = numKeyframes;
+    while (low < high) {
+        const nanoem_rsize_t mid = low + ((high - low) >> 1);
+        if (frameIndexOf(keyframes[mid]) < start) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    for (nanoem_rsize_t i = low; i < numKeyframes; i++) {
+        const nanoem_frame_index_t frameIndex = frameIndexOf(keyframes[i]);
+        if (frameIndex > end) {
+            break;
+        }
+        selection.set(frameIndex);
+    }
+}
+
+} /* namespace anonymous */
 
 MotionKeyframeSelection::MotionKeyframeSelection(Motion *parent)
     : m_parent(parent)
@@ -25,327 +208,290 @@ MotionKeyframeSelection::~MotionKeyframeSelection() NANOEM_DECL_NOEXCEPT
 void
 MotionKeyframeSelection::getAll(Motion::AccessoryKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_accessoryKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::AccessoryKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
-                 ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionAccessoryKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
-    }
+    keyframes.clear();
+    collectAllKeyframes(m_parent->data(), m_accessoryKeyframeSelection, keyframes);
+    setStartOffset(keyframes, startOffset);
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_accessory_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_accessoryKeyframeSelection.find(keyframe) != m_accessoryKeyframeSelection.end();
+    return keyframe && m_accessoryKeyframeSelection.contains(frameIndexOf(keyframe));
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_accessory_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionAccessoryKeyframeGetKeyframeObject(keyframe))) {
-        m_accessoryKeyframeSelection.insert(keyframe);
+        m_accessoryKeyframeSelection.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_accessory_keyframe_t *keyframe)
 {
-    m_accessoryKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        m_accessoryKeyframeSelection.reset(frameIndexOf(keyframe));
+    }
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_bone_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_boneKeyframeSelection.find(keyframe) != m_boneKeyframeSelection.end();
+    bool result = false;
+    if (keyframe) {
+        TrackMap::const_iterator it =
+            m_boneKeyframeSelection.find(nanoem_u32_t(nanoemMotionBoneKeyframeGetId(keyframe)));
+        result = it != m_boneKeyframeSelection.end() && it->second.m_frameIndices.contains(frameIndexOf(keyframe));
+    }
+    return result;
 }
 
 void
 MotionKeyframeSelection::getAll(Motion::BoneKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_boneKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::BoneKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
-                 ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionBoneKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
+    keyframes.clear();
+    for (TrackMap::const_iterator it = m_boneKeyframeSelection.begin(), end = m_boneKeyframeSelection.end(); it != end;
+         ++it) {
+        collectAllKeyframes<nanoem_motion_track_t, nanoem_motion_bone_keyframe_t>(
+            it->second.m_track, it->second.m_frameIndices, keyframes);
     }
+    setStartOffset(keyframes, startOffset);
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_bone_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionBoneKeyframeGetKeyframeObject(keyframe))) {
-        m_boneKeyframeSelection.insert(keyframe);
+        resolveBoneTrack(keyframe)->m_frameIndices.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_bone_keyframe_t *keyframe)
 {
-    m_boneKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        TrackMap::iterator it = m_boneKeyframeSelection.find(nanoem_u32_t(nanoemMotionBoneKeyframeGetId(keyframe)));
+        if (it != m_boneKeyframeSelection.end()) {
+            it->second.m_frameIndices.reset(frameIndexOf(keyframe));
+        }
+    }
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_camera_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_cameraKeyframeSelection.find(keyframe) != m_cameraKeyframeSelection.end();
+    return keyframe && m_cameraKeyframeSelection.contains(frameIndexOf(keyframe));
 }
 
 void
 MotionKeyframeSelection::getAll(Motion::CameraKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_cameraKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::CameraKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
-                 ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
-    }
+    keyframes.clear();
+    collectAllKeyframes(m_parent->data(), m_cameraKeyframeSelection, keyframes);
+    setStartOffset(keyframes, startOffset);
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_camera_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionCameraKeyframeGetKeyframeObject(keyframe))) {
-        m_cameraKeyframeSelection.insert(keyframe);
+        m_cameraKeyframeSelection.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_camera_keyframe_t *keyframe)
 {
-    m_cameraKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        m_cameraKeyframeSelection.reset(frameIndexOf(keyframe));
+    }
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_light_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_lightKeyframeSelection.find(keyframe) != m_lightKeyframeSelection.end();
+    return keyframe && m_lightKeyframeSelection.contains(frameIndexOf(keyframe));
 }
 
 void
 MotionKeyframeSelection::getAll(Motion::LightKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_lightKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::LightKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
-                 ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionLightKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
-    }
+    keyframes.clear();
+    collectAllKeyframes(m_parent->data(), m_lightKeyframeSelection, keyframes);
+    setStartOffset(keyframes, startOffset);
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_light_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionLightKeyframeGetKeyframeObject(keyframe))) {
-        m_lightKeyframeSelection.insert(keyframe);
+        m_lightKeyframeSelection.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_light_keyframe_t *keyframe)
 {
-    m_lightKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        m_lightKeyframeSelection.reset(frameIndexOf(keyframe));
+    }
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_model_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_modelKeyframeSelection.find(keyframe) != m_modelKeyframeSelection.end();
+    return keyframe && m_modelKeyframeSelection.contains(frameIndexOf(keyframe));
 }
 
 void
 MotionKeyframeSelection::getAll(Motion::ModelKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_modelKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::ModelKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
-                 ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionModelKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
-    }
+    keyframes.clear();
+    collectAllKeyframes(m_parent->data(), m_modelKeyframeSelection, keyframes);
+    setStartOffset(keyframes, startOffset);
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_model_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionModelKeyframeGetKeyframeObject(keyframe))) {
-        m_modelKeyframeSelection.insert(keyframe);
+        m_modelKeyframeSelection.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_model_keyframe_t *keyframe)
 {
-    m_modelKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        m_modelKeyframeSelection.reset(frameIndexOf(keyframe));
+    }
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_morph_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_morphKeyframeSelection.find(keyframe) != m_morphKeyframeSelection.end();
+    bool result = false;
+    if (keyframe) {
+        TrackMap::const_iterator it =
+            m_morphKeyframeSelection.find(nanoem_u32_t(nanoemMotionMorphKeyframeGetId(keyframe)));
+        result = it != m_morphKeyframeSelection.end() && it->second.m_frameIndices.contains(frameIndexOf(keyframe));
+    }
+    return result;
 }
 
 void
 MotionKeyframeSelection::getAll(Motion::MorphKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_morphKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::MorphKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end(); it != end;
-                 ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionMorphKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
+    keyframes.clear();
+    for (TrackMap::const_iterator it = m_morphKeyframeSelection.begin(), end = m_morphKeyframeSelection.end();
+         it != end; ++it) {
+        collectAllKeyframes<nanoem_motion_track_t, nanoem_motion_morph_keyframe_t>(
+            it->second.m_track, it->second.m_frameIndices, keyframes);
     }
+    setStartOffset(keyframes, startOffset);
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_morph_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionMorphKeyframeGetKeyframeObject(keyframe))) {
-        m_morphKeyframeSelection.insert(keyframe);
+        resolveMorphTrack(keyframe)->m_frameIndices.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_morph_keyframe_t *keyframe)
 {
-    m_morphKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        TrackMap::iterator it = m_morphKeyframeSelection.find(nanoem_u32_t(nanoemMotionMorphKeyframeGetId(keyframe)));
+        if (it != m_morphKeyframeSelection.end()) {
+            it->second.m_frameIndices.reset(frameIndexOf(keyframe));
+        }
+    }
 }
 
 bool
 MotionKeyframeSelection::contains(const nanoem_motion_self_shadow_keyframe_t *keyframe) const NANOEM_DECL_NOEXCEPT
 {
-    return m_selfShadowKeyframeSelection.find(keyframe) != m_selfShadowKeyframeSelection.end();
+    return keyframe && m_selfShadowKeyframeSelection.contains(frameIndexOf(keyframe));
 }
 
 void
 MotionKeyframeSelection::getAll(Motion::SelfShadowKeyframeList &keyframes, int *startOffset) const
 {
-    keyframes = ListUtils::toListFromSet(m_selfShadowKeyframeSelection);
-    if (startOffset) {
-        *startOffset = 0;
-        if (!keyframes.empty()) {
-            nanoem_frame_index_t offset = INT32_MAX;
-            for (Motion::SelfShadowKeyframeList::const_iterator it = keyframes.begin(), end = keyframes.end();
-                 it != end; ++it) {
-                nanoem_frame_index_t frameIndex =
-                    nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionSelfShadowKeyframeGetKeyframeObject(*it));
-                offset = glm::min(offset, frameIndex);
-            }
-            *startOffset = offset;
-        }
-    }
+    keyframes.clear();
+    collectAllKeyframes(m_parent->data(), m_selfShadowKeyframeSelection, keyframes);
+    setStartOffset(keyframes, startOffset);
 }
 
 void
 MotionKeyframeSelection::add(const nanoem_motion_self_shadow_keyframe_t *keyframe)
 {
     if (keyframe && isParentOf(nanoemMotionSelfShadowKeyframeGetKeyframeObject(keyframe))) {
-        m_selfShadowKeyframeSelection.insert(keyframe);
+        m_selfShadowKeyframeSelection.set(frameIndexOf(keyframe));
     }
 }
 
 void
 MotionKeyframeSelection::remove(const nanoem_motion_self_shadow_keyframe_t *keyframe)
 {
-    m_selfShadowKeyframeSelection.erase(keyframe);
+    if (keyframe) {
+        m_selfShadowKeyframeSelection.reset(frameIndexOf(keyframe));
+    }
 }
 
 void
 MotionKeyframeSelection::addAllKeyframes(nanoem_u32_t flags)
 {
     const nanoem_motion_t *opaque = m_parent->data();
+    const nanoem_frame_index_t maxFrameIndex = Motion::kMaxFrameIndex;
     nanoem_rsize_t numKeyframes;
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ACCESSORY)) {
         nanoem_motion_accessory_keyframe_t *const *accessoryKeyframes =
             nanoemMotionGetAllAccessoryKeyframeObjects(opaque, &numKeyframes);
-        for (nanoem_rsize_t i = 0; i < numKeyframes; i++) {
-            nanoem_motion_accessory_keyframe_t *keyframe = accessoryKeyframes[i];
-            m_accessoryKeyframeSelection.insert(keyframe);
-        }
+        setAllFrameIndicesInRange(accessoryKeyframes, numKeyframes, 0, maxFrameIndex, m_accessoryKeyframeSelection);
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_BONE)) {
         nanoem_motion_bone_keyframe_t *const *boneKeyframes =
             nanoemMotionGetAllBoneKeyframeObjects(opaque, &numKeyframes);
+        Track *track = nullptr;
         for (nanoem_rsize_t i = 0; i < numKeyframes; i++) {
-            nanoem_motion_bone_keyframe_t *keyframe = boneKeyframes[i];
-            m_boneKeyframeSelection.insert(keyframe);
+            const nanoem_motion_bone_keyframe_t *keyframe = boneKeyframes[i];
+            /* consecutive keyframes mostly belong to the same track so the track is resolved only when it changes */
+            if (!track ||
+                nanoemMotionBoneKeyframeGetId(keyframe) != nanoemMotionBoneKeyframeGetId(boneKeyframes[i - 1])) {
+                track = resolveBoneTrack(keyframe);
+            }
+            track->m_frameIndices.set(frameIndexOf(keyframe));
         }
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_CAMERA)) {
         nanoem_motion_camera_keyframe_t *const *cameraKeyframes =
             nanoemMotionGetAllCameraKeyframeObjects(opaque, &numKeyframes);
-        for (nanoem_rsize_t i = 0; i < numKeyframes; i++) {
-            nanoem_motion_camera_keyframe_t *keyframe = cameraKeyframes[i];
-            m_cameraKeyframeSelection.insert(keyframe);
-        }
+        setAllFrameIndicesInRange(cameraKeyframes, numKeyframes, 0, maxFrameIndex, m_cameraKeyframeSelection);
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_LIGHT)) {
         nanoem_motion_light_keyframe_t *const *lightKeyframes =
             nanoemMotionGetAllLightKeyframeObjects(opaque, &numKeyframes);
-        for (nanoem_rsize_t i = 0; i < numKeyframes; i++) {
-            nanoem_motion_light_keyframe_t *keyframe = lightKeyframes[i];
-            m_lightKeyframeSelection.insert(keyframe);
-        }
+        setAllFrameIndicesInRange(lightKeyframes, numKeyframes, 0, maxFrameIndex, m_lightKeyframeSelection);
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MODEL)) {
         nanoem_motion_model_keyframe_t *const *modelKeyframes =
             nanoemMotionGetAllModelKeyframeObjects(opaque, &numKeyframes);
-        for (nanoem_rsize_t i = 0; i < numKeyframes; i++) {
-            nanoem_motion_model_keyframe_t *keyframe = modelKeyframes[i];
-            m_modelKeyframeSelection.insert(keyframe);
-        }
+        setAllFrameIndicesInRange(modelKeyframes, numKeyframes, 0, maxFrameIndex, m_modelKeyframeSelection);
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MORPH)) {
         nanoem_motion_morph_keyframe_t *const *morphKeyframes =
             nanoemMotionGetAllMorphKeyframeObjects(opaque, &numKeyframes);
+        Track *track = nullptr;
         for (nanoem_rsize_t i = 0; i < numKeyframes; i++) {
-            nanoem_motion_morph_keyframe_t *keyframe = morphKeyframes[i];
-            m_morphKeyframeSelection.insert(keyframe);
+            const nanoem_motion_morph_keyframe_t *keyframe = morphKeyframes[i];
+            if (!track ||
+                nanoemMotionMorphKeyframeGetId(keyframe) != nanoemMotionMorphKeyframeGetId(morphKeyframes[i - 1])) {
+                track = resolveMorphTrack(keyframe);
+            }
+            track->m_frameIndices.set(frameIndexOf(keyframe));
         }
     }
 }
@@ -353,9 +499,10 @@ MotionKeyframeSelection::addAllKeyframes(nanoem_u32_t flags)
 void
 MotionKeyframeSelection::addAccessoryKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findAccessoryKeyframe(i));
-    }
+    nanoem_rsize_t numKeyframes;
+    nanoem_motion_accessory_keyframe_t *const *keyframes =
+        nanoemMotionGetAllAccessoryKeyframeObjects(m_parent->data(), &numKeyframes);
+    setAllFrameIndicesInRange(keyframes, numKeyframes, start, end, m_accessoryKeyframeSelection);
 }
 
 void
@@ -363,33 +510,53 @@ MotionKeyframeSelection::addBoneKeyframes(
     const nanoem_model_bone_t *bone, nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
     const nanoem_unicode_string_t *name = nanoemModelBoneGetName(bone, NANOEM_LANGUAGE_TYPE_FIRST_ENUM);
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findBoneKeyframe(name, i));
+    const nanoem_motion_track_t *track = nanoemMotionResolveBoneTrack(m_parent->data(), name);
+    const nanoem_motion_bone_keyframe_t *keyframe = nullptr;
+    nanoem_motion_keyframe_cursor_t cursor;
+    nanoemMotionKeyframeCursorReset(&cursor);
+    Track *selection = nullptr;
+    /* steps keyframes of the track instead of each frame index in the range */
+    for (nanoem_frame_index_t frameIndex = start; findNextKeyframe(track, &cursor, frameIndex, keyframe);) {
+        frameIndex = frameIndexOf(keyframe);
+        if (frameIndex > end) {
+            break;
+        }
+        if (!selection) {
+            selection = resolveBoneTrack(keyframe);
+        }
+        selection->m_frameIndices.set(frameIndex);
+        if (frameIndex == end) {
+            break;
+        }
+        frameIndex++;
     }
 }
 
 void
 MotionKeyframeSelection::addCameraKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findCameraKeyframe(i));
-    }
+    nanoem_rsize_t numKeyframes;
+    nanoem_motion_camera_keyframe_t *const *keyframes =
+        nanoemMotionGetAllCameraKeyframeObjects(m_parent->data(), &numKeyframes);
+    setAllFrameIndicesInRange(keyframes, numKeyframes, start, end, m_cameraKeyframeSelection);
 }
 
 void
 MotionKeyframeSelection::addLightKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findLightKeyframe(i));
-    }
+    nanoem_rsize_t numKeyframes;
+    nanoem_motion_light_keyframe_t *const *keyframes =
+        nanoemMotionGetAllLightKeyframeObjects(m_parent->data(), &numKeyframes);
+    setAllFrameIndicesInRange(keyframes, numKeyframes, start, end, m_lightKeyframeSelection);
 }
 
 void
 MotionKeyframeSelection::addModelKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findModelKeyframe(i));
-    }
+    nanoem_rsize_t numKeyframes;
+    nanoem_motion_model_keyframe_t *const *keyframes =
+        nanoemMotionGetAllModelKeyframeObjects(m_parent->data(), &numKeyframes);
+    setAllFrameIndicesInRange(keyframes, numKeyframes, start, end, m_modelKeyframeSelection);
 }
 
 void
@@ -397,16 +564,59 @@ MotionKeyframeSelection::addMorphKeyframes(
     const nanoem_model_morph_t *morph, nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
     const nanoem_unicode_string_t *name = nanoemModelMorphGetName(morph, NANOEM_LANGUAGE_TYPE_FIRST_ENUM);
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findMorphKeyframe(name, i));
+    const nanoem_motion_track_t *track = nanoemMotionResolveMorphTrack(m_parent->data(), name);
+    const nanoem_motion_morph_keyframe_t *keyframe = nullptr;
+    nanoem_motion_keyframe_cursor_t cursor;
+    nanoemMotionKeyframeCursorReset(&cursor);
+    Track *selection = nullptr;
+    for (nanoem_frame_index_t frameIndex = start; findNextKeyframe(track, &cursor, frameIndex, keyframe);) {
+        frameIndex = frameIndexOf(keyframe);
+        if (frameIndex > end) {
+            break;
+        }
+        if (!selection) {
+            selection = resolveMorphTrack(keyframe);
+        }
+        selection->m_frameIndices.set(frameIndex);
+        if (frameIndex == end) {
+            break;
+        }
+        frameIndex++;
     }
 }
 
 void
 MotionKeyframeSelection::addSelfShadowKeyframes(nanoem_frame_index_t start, nanoem_frame_index_t end)
 {
-    for (nanoem_frame_index_t i = start; i <= end; i++) {
-        add(m_parent->findSelfShadowKeyframe(i));
+    nanoem_rsize_t numKeyframes;
+    nanoem_motion_self_shadow_keyframe_t *const *keyframes =
+        nanoemMotionGetAllSelfShadowKeyframeObjects(m_parent->data(), &numKeyframes);
+    setAllFrameIndicesInRange(keyframes, numKeyframes, start, end, m_selfShadowKeyframeSelection);
+}
+
+void
+MotionKeyframeSelection::shiftAllKeyframes(nanoem_u32_t flags, nanoem_frame_index_t from, int delta)
+{
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ACCESSORY)) {
+        m_accessoryKeyframeSelection.shift(from, delta);
+    }
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_BONE)) {
+        shiftAllTracks(m_boneKeyframeSelection, from, delta);
+    }
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_CAMERA)) {
+        m_cameraKeyframeSelection.shift(from, delta);
+    }
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_LIGHT)) {
+        m_lightKeyframeSelection.shift(from, delta);
+    }
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MODEL)) {
+        m_modelKeyframeSelection.shift(from, delta);
+    }
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MORPH)) {
+        shiftAllTracks(m_morphKeyframeSelection, from, delta);
+    }
+    if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_SELFSHADOW)) {
+        m_selfShadowKeyframeSelection.shift(from, delta);
     }
 }
 
@@ -415,25 +625,25 @@ MotionKeyframeSelection::hasAllKeyframes(nanoem_u32_t flags) const NANOEM_DECL_N
 {
     bool hasSelection = false;
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ACCESSORY)) {
-        hasSelection |= !m_accessoryKeyframeSelection.empty();
+        hasSelection |= !m_accessoryKeyframeSelection.isEmpty();
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_BONE)) {
-        hasSelection |= !m_boneKeyframeSelection.empty();
+        hasSelection |= hasAnyTrack(m_boneKeyframeSelection);
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_CAMERA)) {
-        hasSelection |= !m_cameraKeyframeSelection.empty();
+        hasSelection |= !m_cameraKeyframeSelection.isEmpty();
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_LIGHT)) {
-        hasSelection |= !m_lightKeyframeSelection.empty();
+        hasSelection |= !m_lightKeyframeSelection.isEmpty();
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MODEL)) {
-        hasSelection |= !m_modelKeyframeSelection.empty();
+        hasSelection |= !m_modelKeyframeSelection.isEmpty();
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_MORPH)) {
-        hasSelection |= !m_morphKeyframeSelection.empty();
+        hasSelection |= hasAnyTrack(m_morphKeyframeSelection);
     }
     if (EnumUtils::isEnabled(flags, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_SELFSHADOW)) {
-        hasSelection |= !m_selfShadowKeyframeSelection.empty();
+        hasSelection |= !m_selfShadowKeyframeSelection.isEmpty();
     }
     return hasSelection;
 }
@@ -464,6 +674,44 @@ MotionKeyframeSelection::clearAllKeyframes(nanoem_u32_t flags)
     }
 }
 
+void
+MotionKeyframeSelection::shiftAllTracks(TrackMap &tracks, nanoem_frame_index_t from, int delta)
+{
+    for (TrackMap::iterator it = tracks.begin(), end = tracks.end(); it != end; ++it) {
+        it->second.m_frameIndices.shift(from, delta);
+    }
+}
+
+bool
+MotionKeyframeSelection::hasAnyTrack(const TrackMap &tracks) NANOEM_DECL_NOEXCEPT
+{
+    bool result = false;
+    for (TrackMap::const_iterator it = tracks.begin(), end = tracks.end(); !result && it != end; ++it) {
+        result = !it->second.m_frameIndices.isEmpty();
+    }
+    return result;
+}
+
+MotionKeyframeSelection::Track *
+MotionKeyframeSelection::resolveBoneTrack(const nanoem_motion_bone_keyframe_t *keyframe)
+{
+    Track &track = m_boneKeyframeSelection[nanoem_u32_t(nanoemMotionBoneKeyframeGetId(keyframe))];
+    if (!track.m_track) {
+        track.m_track = nanoemMotionResolveBoneTrack(m_parent->data(), nanoemMotionBoneKeyframeGetName(keyframe));
+    }
+    return &track;
+}
+
+MotionKeyframeSelection::Track *
+MotionKeyframeSelection::resolveMorphTrack(const nanoem_motion_morph_keyframe_t *keyframe)
+{
+    Track &track = m_morphKeyframeSelection[nanoem_u32_t(nanoemMotionMorphKeyframeGetId(keyframe))];
+    if (!track.m_track) {
+        track.m_track = nanoemMotionResolveMorphTrack(m_parent->data(), nanoemMotionMorphKeyframeGetName(keyframe));
+    }
+    return &track;
+}
+
 bool
 MotionKeyframeSelection::isParentOf(const nanoem_motion_keyframe_object_t *ko) const NANOEM_DECL_NOEXCEPT
 {
@@ -0,0 +1,84 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/ParallelTaskDispatcher.h"
+
+#include "emapp/private/CommonInclude.h"
+
+#if defined(NANOEM_ENABLE_TBB)
+#include "tbb/tbb.h"
+#endif /* NANOEM_ENABLE_TBB */
+#if defined(__APPLE__)
+#include <dispatch/dispatch.h>
+#endif /* __APPLE__ */
+
+namespace nanoem {
+namespace internal {
+
+ParallelTaskDispatcher::ParallelTaskDispatcher(const char *label)
+    : m_queue(nullptr)
+{
+#if defined(__APPLE__)
+#ifdef NDEBUG
+    BX_UNUSED_1(label);
+    m_queue = dispatch_queue_create(nullptr, DISPATCH_QUEUE_CONCURRENT);
+#else
+    m_queue = dispatch_queue_create(label, DISPATCH_QUEUE_CONCURRENT);
+#endif /* NDEBUG */
+#else
+    BX_UNUSED_1(label);
+#endif /* __APPLE__ */
+}
+
+ParallelTaskDispatcher::~ParallelTaskDispatcher() NANOEM_DECL_NOEXCEPT
+{
+#if defined(__APPLE__)
+    if (dispatch_queue_t queue = static_cast<dispatch_queue_t>(m_queue)) {
+        m_queue = nullptr;
+        dispatch_release(queue);
+    }
+#endif /* __APPLE__ */
+}
+
+void
+ParallelTaskDispatcher::dispatch(Iterator iterator, void *opaque, size_t iterations)
+{
+#if defined(NANOEM_ENABLE_TBB)
+    struct ParallelExecutor {
+        ParallelExecutor(Iterator iterator, void *opaque)
+            : m_iterator(iterator)
+            , m_opaque(opaque)
+        {
+        }
+        void
+        operator()(const tbb::blocked_range<size_t> &range) const
+        {
+            for (size_t it = range.begin(), end = range.end(); it != end; ++it) {
+                m_iterator(m_opaque, it);
+            }
+        }
+        Iterator m_iterator;
+        void *m_opaque;
+    } executor(iterator, opaque);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, iterations), executor);
+#elif defined(__APPLE__)
+    dispatch_queue_t queue = static_cast<dispatch_queue_t>(m_queue);
+    dispatch_apply_f(iterations, queue, opaque, iterator);
+#else /* NANOEM_ENABLE_TBB */
+#if defined(NANOEM_ENABLE_OPENMP)
+    const int numIterations = Inline::saturateInt32(iterations);
+#pragma omp parallel for
+    for (int i = 0; i < numIterations; i++) {
+#else
+    for (size_t i = 0; i < iterations; i++) {
+#endif /* NANOEM_ENABLE_OPENMP */
+        iterator(opaque, i);
+    }
+#endif /* NANOEM_ENABLE_TBB */
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
@@ -0,0 +1,465 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/PhysicsBakeCache.h"
+
+#include "emapp/Error.h"
+#include "emapp/FileUtils.h"
+#include "emapp/private/CommonInclude.h"
+
+#include "lz4/lib/lz4.h"
+
+namespace nanoem {
+namespace internal {
+namespace {
+
+static const nanoem_u32_t kFileMagic = nanoem_fourcc('n', 'm', 'P', 'B');
+static const nanoem_u32_t kFileVersion = 3;
+static const nanoem_rsize_t kTransformSize = sizeof(nanoem_i16_t) * 4 + sizeof(nanoem_f32_t) * 3;
+/* keeps the inflated size of a chunk within 32bit */
+static const nanoem_u32_t kMaxNumRigidBodies = 0xffffffffu / (kTransformSize * PhysicsBakeCache::kNumFramesPerChunk);
+
+/* every read is bounded by the rest of the file so broken lengths never allocate or read beyond it */
+template <typename T>
+static bool
+readBounded(IReader *reader, T &value, nanoem_rsize_t &rest, Error &error)
+{
+    bool succeeded = false;
+    if (rest >= sizeof(value) && FileUtils::readTyped(reader, value, error) == nanoem_i32_t(sizeof(value))) {
+        rest -= sizeof(value);
+        succeeded = true;
+    }
+    return succeeded;
+}
+
+static bool
+readBounded(IReader *reader, ByteArray &bytes, nanoem_u32_t size, nanoem_rsize_t &rest, Error &error)
+{
+    bool succeeded = false;
+    if (rest >= size) {
+        bytes.resize(size);
+        if (FileUtils::read(reader, bytes.data(), bytes.size(), error) == Inline::saturateInt32(size)) {
+            rest -= size;
+            succeeded = true;
+        }
+    }
+    return succeeded;
+}
+
+static inline nanoem_i16_t
+quantizeSNorm16(nanoem_f32_t value) NANOEM_DECL_NOEXCEPT
+{
+    return nanoem_i16_t(glm::round(glm::clamp(value, -1.0f, 1.0f) * 32767.0f));
+}
+
+static void
+encodeTransform(const Matrix4x4 &transform, nanoem_u8_t *ptr) NANOEM_DECL_NOEXCEPT
+{
+    Quaternion orientation(glm::quat_cast(Matrix3x3(transform)));
+    /* q and -q are the same rotation so the sign is fixed to keep interpolation between frames on the short path */
+    if (orientation.w < 0) {
+        orientation = -orientation;
+    }
+    const nanoem_i16_t components[] = { quantizeSNorm16(orientation.x), quantizeSNorm16(orientation.y),
+        quantizeSNorm16(orientation.z), quantizeSNorm16(orientation.w) };
+    const Vector3 position(transform[3]);
+    memcpy(ptr, components, sizeof(components));
+    memcpy(ptr + sizeof(components), glm::value_ptr(position), sizeof(position));
+}
+
+static void
+decodeTransform(const nanoem_u8_t *ptr, Matrix4x4 &transform) NANOEM_DECL_NOEXCEPT
+{
+    nanoem_i16_t components[4];
+    Vector3 position;
+    memcpy(components, ptr, sizeof(components));
+    memcpy(glm::value_ptr(position), ptr + sizeof(components), sizeof(position));
+    const nanoem_f32_t scale = 1.0f / 32767.0f;
+    const Quaternion orientation(
+        components[3] * scale, components[0] * scale, components[1] * scale, components[2] * scale);
+    transform = glm::mat4_cast(glm::normalize(orientation));
+    transform[3] = Vector4(position, 1);
+}
+
+} /* namespace anonymous */
+
+nanoem_u64_t
+PhysicsBakeCache::digest(const void *data, nanoem_rsize_t size, nanoem_u64_t seed) NANOEM_DECL_NOEXCEPT
+{
+    /* 64bit FNV-1a as the signature is the only guard against replaying a stale track loaded from the file */
+    const nanoem_u8_t *ptr = static_cast<const nanoem_u8_t *>(data);
+    nanoem_u64_t value = seed;
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        value = (value ^ ptr[i]) * 1099511628211ull;
+    }
+    return value;
+}
+
+PhysicsBakeCache::Chunk::Chunk()
+    : m_frameMask(0)
+    , m_inflatedSize(0)
+{
+}
+
+bool
+PhysicsBakeCache::Chunk::contains(nanoem_frame_index_t offset) const NANOEM_DECL_NOEXCEPT
+{
+    return (m_frameMask & (nanoem_u64_t(1) << offset)) != 0;
+}
+
+PhysicsBakeCache::Track::Track(nanoem_u64_t signature, nanoem_rsize_t numRigidBodies)
+    : m_signature(signature)
+    , m_numFrames(0)
+    , m_numRigidBodies(numRigidBodies)
+{
+}
+
+PhysicsBakeCache::Track::~Track() NANOEM_DECL_NOEXCEPT
+{
+    for (ChunkMap::const_iterator it = m_chunks.begin(), end = m_chunks.end(); it != end; ++it) {
+        nanoem_delete(it->second);
+    }
+    m_chunks.clear();
+}
+
+nanoem_rsize_t
+PhysicsBakeCache::Track::frameSize() const NANOEM_DECL_NOEXCEPT
+{
+    return m_numRigidBodies * kTransformSize;
+}
+
+const PhysicsBakeCache::Chunk *
+PhysicsBakeCache::Track::findChunk(nanoem_frame_index_t frameIndex) const NANOEM_DECL_NOEXCEPT
+{
+    ChunkMap::const_iterator it = m_chunks.find(frameIndex / kNumFramesPerChunk);
+    const Chunk *chunk = it != m_chunks.end() ? it->second : nullptr;
+    return chunk && chunk->contains(frameIndex % kNumFramesPerChunk) ? chunk : nullptr;
+}
+
+PhysicsBakeCache::PhysicsBakeCache()
+    : m_inflatedChunk(nullptr)
+{
+}
+
+PhysicsBakeCache::~PhysicsBakeCache() NANOEM_DECL_NOEXCEPT
+{
+    clear();
+}
+
+void
+PhysicsBakeCache::begin(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies)
+{
+    TrackMap::iterator it = m_tracks.find(handle);
+    if (it != m_tracks.end()) {
+        Track *track = it->second;
+        if (track->m_signature == signature && track->m_numRigidBodies == numRigidBodies) {
+            return;
+        }
+        nanoem_delete(track);
+        m_tracks.erase(it);
+    }
+    m_tracks.insert(tinystl::make_pair(handle, nanoem_new(Track(signature, numRigidBodies))));
+    m_inflatedChunk = nullptr;
+}
+
+void
+PhysicsBakeCache::record(nanoem_u16_t handle, nanoem_frame_index_t frameIndex, const Matrix4x4 *transforms)
+{
+    TrackMap::const_iterator it = m_tracks.find(handle);
+    if (it != m_tracks.end()) {
+        Track *track = it->second;
+        const nanoem_u32_t chunkIndex = frameIndex / kNumFramesPerChunk, offset = frameIndex % kNumFramesPerChunk;
+        const nanoem_rsize_t frameSize = track->frameSize();
+        ChunkMap::const_iterator it2 = track->m_chunks.find(chunkIndex);
+        Chunk *chunk = nullptr;
+        if (it2 != track->m_chunks.end()) {
+            chunk = it2->second;
+            if (chunk->m_inflatedBytes.empty() && !chunk->m_deflatedBytes.empty()) {
+                /* re-recording the committed chunk */
+                inflateChunk(chunk, chunk->m_inflatedBytes);
+                chunk->m_deflatedBytes.clear();
+            }
+        }
+        else {
+            chunk = nanoem_new(Chunk);
+            track->m_chunks.insert(tinystl::make_pair(chunkIndex, chunk));
+        }
+        chunk->m_inflatedBytes.resize(frameSize * kNumFramesPerChunk);
+        nanoem_u8_t *ptr = chunk->m_inflatedBytes.data() + frameSize * offset;
+        for (nanoem_rsize_t i = 0, numRigidBodies = track->m_numRigidBodies; i < numRigidBodies; i++) {
+            encodeTransform(transforms[i], ptr + kTransformSize * i);
+        }
+        chunk->m_frameMask |= nanoem_u64_t(1) << offset;
+        track->m_numFrames = glm::max(track->m_numFrames, nanoem_u32_t(frameIndex + 1));
+        if (m_inflatedChunk == chunk) {
+            m_inflatedChunk = nullptr;
+        }
+        if (offset == kNumFramesPerChunk - 1) {
+            deflateChunk(chunk);
+        }
+    }
+}
+
+void
+PhysicsBakeCache::commit()
+{
+    for (TrackMap::const_iterator it = m_tracks.begin(), end = m_tracks.end(); it != end; ++it) {
+        const ChunkMap &chunks = it->second->m_chunks;
+        for (ChunkMap::const_iterator it2 = chunks.begin(), end2 = chunks.end(); it2 != end2; ++it2) {
+            Chunk *chunk = it2->second;
+            if (!chunk->m_inflatedBytes.empty()) {
+                deflateChunk(chunk);
+            }
+        }
+    }
+}
+
+bool
+PhysicsBakeCache::contains(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies,
+    nanoem_frame_index_t frameIndex) const NANOEM_DECL_NOEXCEPT
+{
+    const Track *track = findTrack(handle, signature, numRigidBodies);
+    return track && track->findChunk(frameIndex);
+}
+
+bool
+PhysicsBakeCache::restore(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies,
+    nanoem_frame_index_t frameIndex, Matrix4x4 *transforms)
+{
+    bool restored = false;
+    if (const Track *track = findTrack(handle, signature, numRigidBodies)) {
+        if (const Chunk *chunk = track->findChunk(frameIndex)) {
+            const ByteArray *bytes = &chunk->m_inflatedBytes;
+            if (bytes->empty()) {
+                /* scrubbing mostly stays in the same chunk so the last inflated one is reused */
+                if (m_inflatedChunk != chunk) {
+                    m_inflatedChunk = inflateChunk(chunk, m_inflatedBytes) ? chunk : nullptr;
+                }
+                bytes = m_inflatedChunk ? &m_inflatedBytes : nullptr;
+            }
+            if (bytes) {
+                const nanoem_rsize_t frameSize = track->frameSize();
+                const nanoem_u8_t *ptr = bytes->data() + frameSize * (frameIndex % kNumFramesPerChunk);
+                for (nanoem_rsize_t i = 0; i < numRigidBodies; i++) {
+                    decodeTransform(ptr + kTransformSize * i, transforms[i]);
+                }
+                restored = true;
+            }
+        }
+    }
+    return restored;
+}
+
+void
+PhysicsBakeCache::invalidate(nanoem_u16_t handle)
+{
+    TrackMap::iterator it = m_tracks.find(handle);
+    if (it != m_tracks.end()) {
+        nanoem_delete(it->second);
+        m_tracks.erase(it);
+        m_inflatedChunk = nullptr;
+    }
+}
+
+void
+PhysicsBakeCache::clear()
+{
+    for (TrackMap::const_iterator it = m_tracks.begin(), end = m_tracks.end(); it != end; ++it) {
+        nanoem_delete(it->second);
+    }
+    m_tracks.clear();
+    m_inflatedBytes.clear();
+    m_inflatedChunk = nullptr;
+}
+
+bool
+PhysicsBakeCache::load(IReader *reader, const NameHandleMap &handles, Error &error)
+{
+    nanoem_rsize_t rest = reader->size();
+    nanoem_u32_t magic = 0, version = 0, numTracks = 0;
+    if (!readBounded(reader, magic, rest, error) || !readBounded(reader, version, rest, error) ||
+        magic != kFileMagic || version != kFileVersion) {
+        error = Error("Not a baked physics simulation file", 0, Error::kDomainTypeApplication);
+        return false;
+    }
+    clear();
+    bool succeeded = readBounded(reader, numTracks, rest, error);
+    for (nanoem_u32_t i = 0; succeeded && i < numTracks; i++) {
+        nanoem_u32_t nameLength = 0, numRigidBodies = 0;
+        nanoem_u64_t signature = 0;
+        ByteArray nameBytes;
+        succeeded = readBounded(reader, nameLength, rest, error) &&
+            readBounded(reader, nameBytes, nameLength, rest, error) && readBounded(reader, signature, rest, error) &&
+            readBounded(reader, numRigidBodies, rest, error) && numRigidBodies > 0 &&
+            numRigidBodies <= kMaxNumRigidBodies;
+        if (succeeded) {
+            const String name(reinterpret_cast<const char *>(nameBytes.data()), nameBytes.size());
+            Track *track = nanoem_new(Track(signature, numRigidBodies));
+            succeeded = loadTrack(reader, rest, track, error);
+            NameHandleMap::const_iterator it = handles.find(name);
+            if (succeeded && it != handles.end()) {
+                /* the signature is compared on restore so a track of the edited model is never replayed */
+                invalidate(it->second);
+                m_tracks.insert(tinystl::make_pair(it->second, track));
+            }
+            else {
+                /* the track of the model not in the project is skipped */
+                nanoem_delete(track);
+            }
+        }
+    }
+    if (!succeeded) {
+        clear();
+        if (!error.hasReason()) {
+            error = Error("The baked physics simulation file is broken", 0, Error::kDomainTypeApplication);
+        }
+    }
+    return succeeded;
+}
+
+bool
+PhysicsBakeCache::save(IWriter *writer, const HandleNameMap &names, Error &error) const
+{
+    FileUtils::writeTyped(writer, kFileMagic, error);
+    FileUtils::writeTyped(writer, kFileVersion, error);
+    nanoem_u32_t numTracks = 0;
+    for (TrackMap::const_iterator it = m_tracks.begin(), end = m_tracks.end(); it != end; ++it) {
+        numTracks += names.find(it->first) != names.end() ? 1 : 0;
+    }
+    FileUtils::writeTyped(writer, numTracks, error);
+    for (TrackMap::const_iterator it = m_tracks.begin(), end = m_tracks.end(); it != end && !error.hasReason(); ++it) {
+        HandleNameMap::const_iterator it3 = names.find(it->first);
+        if (it3 == names.end()) {
+            continue;
+        }
+        const String &name = it3->second;
+        const Track *track = it->second;
+        nanoem_u32_t numChunks = 0;
+        for (ChunkMap::const_iterator it2 = track->m_chunks.begin(), end2 = track->m_chunks.end(); it2 != end2;
+             ++it2) {
+            numChunks += it2->second->m_deflatedBytes.empty() ? 0 : 1;
+        }
+        FileUtils::writeTyped(writer, nanoem_u32_t(name.size()), error);
+        FileUtils::write(writer, name, error);
+        FileUtils::writeTyped(writer, track->m_signature, error);
+        FileUtils::writeTyped(writer, nanoem_u32_t(track->m_numRigidBodies), error);
+        FileUtils::writeTyped(writer, track->m_numFrames, error);
+        FileUtils::writeTyped(writer, numChunks, error);
+        /* chunks being recorded are written after commit */
+        for (ChunkMap::const_iterator it2 = track->m_chunks.begin(), end2 = track->m_chunks.end(); it2 != end2;
+             ++it2) {
+            const Chunk *chunk = it2->second;
+            if (!chunk->m_deflatedBytes.empty()) {
+                FileUtils::writeTyped(writer, it2->first, error);
+                FileUtils::writeTyped(writer, chunk->m_frameMask, error);
+                FileUtils::writeTyped(writer, chunk->m_inflatedSize, error);
+                FileUtils::writeTyped(writer, nanoem_u32_t(chunk->m_deflatedBytes.size()), error);
+                FileUtils::write(writer, chunk->m_deflatedBytes, error);
+            }
+        }
+    }
+    return !error.hasReason();
+}
+
+nanoem_rsize_t
+PhysicsBakeCache::numTracks() const NANOEM_DECL_NOEXCEPT
+{
+    return m_tracks.size();
+}
+
+nanoem_rsize_t
+PhysicsBakeCache::memoryUsage() const NANOEM_DECL_NOEXCEPT
+{
+    nanoem_rsize_t size = m_inflatedBytes.size();
+    for (TrackMap::const_iterator it = m_tracks.begin(), end = m_tracks.end(); it != end; ++it) {
+        const ChunkMap &chunks = it->second->m_chunks;
+        for (ChunkMap::const_iterator it2 = chunks.begin(), end2 = chunks.end(); it2 != end2; ++it2) {
+            const Chunk *chunk = it2->second;
+            size += chunk->m_deflatedBytes.size() + chunk->m_inflatedBytes.size();
+        }
+    }
+    return size;
+}
+
+bool
+PhysicsBakeCache::loadTrack(IReader *reader, nanoem_rsize_t &rest, Track *track, Error &error)
+{
+    nanoem_u32_t numChunks = 0;
+    bool succeeded =
+        readBounded(reader, track->m_numFrames, rest, error) && readBounded(reader, numChunks, rest, error);
+    const nanoem_u32_t numFrames = track->m_numFrames;
+    const nanoem_u32_t numChunksInTrack =
+        nanoem_u32_t((nanoem_u64_t(numFrames) + kNumFramesPerChunk - 1) / kNumFramesPerChunk);
+    const nanoem_u64_t chunkSize = nanoem_u64_t(track->frameSize()) * kNumFramesPerChunk;
+    for (nanoem_u32_t i = 0; succeeded && i < numChunks; i++) {
+        nanoem_u32_t chunkIndex = 0, deflatedSize = 0;
+        Chunk *chunk = nanoem_new(Chunk);
+        succeeded = readBounded(reader, chunkIndex, rest, error) &&
+            readBounded(reader, chunk->m_frameMask, rest, error) &&
+            readBounded(reader, chunk->m_inflatedSize, rest, error) && readBounded(reader, deflatedSize, rest, error) &&
+            readBounded(reader, chunk->m_deflatedBytes, deflatedSize, rest, error);
+        if (succeeded) {
+            /* frames beyond the track must not be marked as restoring them reads out of the inflated chunk */
+            const nanoem_u32_t restFrames =
+                chunkIndex < numChunksInTrack ? numFrames - chunkIndex * kNumFramesPerChunk : 0;
+            const nanoem_u64_t validFrameMask =
+                restFrames < kNumFramesPerChunk ? (nanoem_u64_t(1) << restFrames) - 1 : ~nanoem_u64_t(0);
+            succeeded = restFrames > 0 && chunk->m_frameMask != 0 &&
+                (chunk->m_frameMask & ~validFrameMask) == 0 && chunk->m_inflatedSize == chunkSize &&
+                !chunk->m_deflatedBytes.empty() && track->m_chunks.find(chunkIndex) == track->m_chunks.end();
+        }
+        if (succeeded) {
+            track->m_chunks.insert(tinystl::make_pair(chunkIndex, chunk));
+        }
+        else {
+            nanoem_delete(chunk);
+        }
+    }
+    return succeeded;
+}
+
+void
+PhysicsBakeCache::deflateChunk(Chunk *chunk)
+{
+    const int inflatedSize = Inline::saturateInt32(chunk->m_inflatedBytes.size());
+    chunk->m_deflatedBytes.resize(LZ4_compressBound(inflatedSize));
+    const int deflatedSize = LZ4_compress_fast(reinterpret_cast<const char *>(chunk->m_inflatedBytes.data()),
+        reinterpret_cast<char *>(chunk->m_deflatedBytes.data()), inflatedSize,
+        Inline::saturateInt32(chunk->m_deflatedBytes.size()), 1);
+    if (deflatedSize > 0) {
+        chunk->m_deflatedBytes.resize(deflatedSize);
+        chunk->m_deflatedBytes.shrink_to_fit();
+        chunk->m_inflatedSize = nanoem_u32_t(inflatedSize);
+        chunk->m_inflatedBytes.clear();
+        chunk->m_inflatedBytes.shrink_to_fit();
+    }
+    else {
+        /* keeps the chunk inflated as fallback */
+        chunk->m_deflatedBytes.clear();
+    }
+}
+
+bool
+PhysicsBakeCache::inflateChunk(const Chunk *chunk, ByteArray &bytes)
+{
+    bytes.resize(chunk->m_inflatedSize);
+    const int inflatedSize = LZ4_decompress_safe(reinterpret_cast<const char *>(chunk->m_deflatedBytes.data()),
+        reinterpret_cast<char *>(bytes.data()), Inline::saturateInt32(chunk->m_deflatedBytes.size()),
+        Inline::saturateInt32(bytes.size()));
+    return inflatedSize == Inline::saturateInt32(chunk->m_inflatedSize);
+}
+
+const PhysicsBakeCache::Track *
+PhysicsBakeCache::findTrack(nanoem_u16_t handle, nanoem_u64_t signature, nanoem_rsize_t numRigidBodies) const
+    NANOEM_DECL_NOEXCEPT
+{
+    TrackMap::const_iterator it = m_tracks.find(handle);
+    const Track *track = it != m_tracks.end() ? it->second : nullptr;
+    return track && track->m_signature == signature && track->m_numRigidBodies == numRigidBodies ? track : nullptr;
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
@@ -0,0 +1,245 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "emapp/internal/VideoEncodingPipeline.h"
+
+#include "emapp/private/CommonInclude.h"
+
+#include "bx/simd_t.h"
+
+namespace nanoem {
+namespace internal {
+namespace {
+
+static inline nanoem_u32_t
+swizzleRGBA8Pixel(nanoem_u32_t v) NANOEM_DECL_NOEXCEPT
+{
+    return (v & 0xff00ff00) | ((v & 0x000000ff) << 16) | ((v & 0x00ff0000) >> 16);
+}
+
+} /* namespace anonymous */
+
+void
+VideoEncodingPipeline::swizzleRGBA8(nanoem_u8_t *data, nanoem_rsize_t size) NANOEM_DECL_NOEXCEPT
+{
+    nanoem_u32_t *dataPtr = reinterpret_cast<nanoem_u32_t *>(data);
+    nanoem_rsize_t numPixels = size / sizeof(*dataPtr), offset = 0;
+    /* simd_ld/simd_st require 16 bytes aligned address */
+    while (offset < numPixels && (reinterpret_cast<uintptr_t>(dataPtr + offset) & 0xf) != 0) {
+        dataPtr[offset] = swizzleRGBA8Pixel(dataPtr[offset]);
+        offset++;
+    }
+    const bx::simd128_t ga = bx::simd_isplat(0xff00ff00), lo = bx::simd_isplat(0x000000ff);
+    for (; offset + 4 <= numPixels; offset += 4) {
+        nanoem_u32_t *ptr = dataPtr + offset;
+        const bx::simd128_t v = bx::simd_ld(ptr);
+        const bx::simd128_t b = bx::simd_sll(bx::simd_and(v, lo), 16), r = bx::simd_and(bx::simd_srl(v, 16), lo);
+        bx::simd_st(ptr, bx::simd_or(bx::simd_and(v, ga), bx::simd_or(b, r)));
+    }
+    for (; offset < numPixels; offset++) {
+        dataPtr[offset] = swizzleRGBA8Pixel(dataPtr[offset]);
+    }
+}
+
+VideoEncodingPipeline::VideoEncodingPipeline(IEncoder *encoder, nanoem_rsize_t numFrames)
+    : m_encoder(encoder)
+    , m_cancelled(false)
+    , m_failed(false)
+    , m_running(false)
+{
+    for (nanoem_rsize_t i = 0; i < numFrames; i++) {
+        Frame *frame = nanoem_new(Frame);
+        frame->m_pts = 0;
+        m_allFrames.push_back(frame);
+        m_freeFrames.push_back(frame);
+        m_freeSemaphore.post();
+    }
+}
+
+VideoEncodingPipeline::~VideoEncodingPipeline() NANOEM_DECL_NOEXCEPT
+{
+    Error error;
+    cancel();
+    finish(error);
+    for (FrameList::const_iterator it = m_allFrames.begin(), end = m_allFrames.end(); it != end; ++it) {
+        Frame *frame = *it;
+        nanoem_delete(frame);
+    }
+    m_allFrames.clear();
+}
+
+void
+VideoEncodingPipeline::start()
+{
+    if (!m_running) {
+        m_running = true;
+#if BX_CONFIG_SUPPORTS_THREADING
+        m_thread.init(execute, this, 0, "com.github.nanoem.VideoEncoder");
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    }
+}
+
+VideoEncodingPipeline::Frame *
+VideoEncodingPipeline::acquire()
+{
+#if BX_CONFIG_SUPPORTS_THREADING
+    m_freeSemaphore.wait();
+    return popFreeFrame();
+#else
+    return tryAcquire();
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+}
+
+VideoEncodingPipeline::Frame *
+VideoEncodingPipeline::tryAcquire()
+{
+#if BX_CONFIG_SUPPORTS_THREADING
+    return m_freeSemaphore.wait(0) ? popFreeFrame() : nullptr;
+#else
+    return popFreeFrame();
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+}
+
+void
+VideoEncodingPipeline::submit(Frame *frame)
+{
+    nanoem_parameter_assert(frame, "must not be nullptr");
+#if BX_CONFIG_SUPPORTS_THREADING
+    if (m_running) {
+        {
+            bx::MutexScope locker(m_mutex);
+            BX_UNUSED_1(locker);
+            m_queuedFrames.push_back(frame);
+        }
+        m_queueSemaphore.post();
+    }
+    else {
+        discard(frame);
+    }
+#else
+    encode(frame);
+    discard(frame);
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+}
+
+void
+VideoEncodingPipeline::discard(Frame *frame)
+{
+    nanoem_parameter_assert(frame, "must not be nullptr");
+    {
+        bx::MutexScope locker(m_mutex);
+        BX_UNUSED_1(locker);
+        m_freeFrames.push_back(frame);
+    }
+    m_freeSemaphore.post();
+}
+
+void
+VideoEncodingPipeline::cancel()
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    m_cancelled = true;
+}
+
+bool
+VideoEncodingPipeline::finish(Error &error)
+{
+    if (m_running) {
+#if BX_CONFIG_SUPPORTS_THREADING
+        /* wakes the worker without any frame to stop after all of queued frames are encoded */
+        m_queueSemaphore.post();
+        m_thread.shutdown();
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+        m_running = false;
+    }
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    if (m_failed) {
+        error = m_error;
+    }
+    return !m_failed;
+}
+
+bool
+VideoEncodingPipeline::isFailed() const NANOEM_DECL_NOEXCEPT
+{
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    return m_failed;
+}
+
+#if BX_CONFIG_SUPPORTS_THREADING
+nanoem_i32_t
+VideoEncodingPipeline::execute(bx::Thread * /* thread */, void *userData)
+{
+    VideoEncodingPipeline *self = static_cast<VideoEncodingPipeline *>(userData);
+    while (true) {
+        self->m_queueSemaphore.wait();
+        Frame *frame = nullptr;
+        {
+            bx::MutexScope locker(self->m_mutex);
+            BX_UNUSED_1(locker);
+            if (!self->m_queuedFrames.empty()) {
+                frame = self->m_queuedFrames.front();
+                self->m_queuedFrames.erase(self->m_queuedFrames.begin());
+            }
+        }
+        if (!frame) {
+            break;
+        }
+        self->encode(frame);
+        self->discard(frame);
+    }
+    return 0;
+}
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+
+VideoEncodingPipeline::Frame *
+VideoEncodingPipeline::popFreeFrame()
+{
+    Frame *frame = nullptr;
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    if (!m_freeFrames.empty()) {
+        frame = m_freeFrames.back();
+        m_freeFrames.pop_back();
+    }
+    return frame;
+}
+
+void
+VideoEncodingPipeline::encode(Frame *frame)
+{
+    bool encodable;
+    {
+        bx::MutexScope locker(m_mutex);
+        BX_UNUSED_1(locker);
+        encodable = !m_cancelled && !m_failed;
+    }
+    /* the encoder is called without the lock so the caller can acquire and submit frames meanwhile */
+    if (encodable) {
+        Error error;
+        bool continuable = true;
+        if (!frame->m_audioData.empty()) {
+            continuable &= m_encoder->encodeAudioFrame(
+                frame->m_pts, frame->m_audioData.data(), frame->m_audioData.size(), error);
+        }
+        if (continuable) {
+            continuable &= m_encoder->encodeVideoFrame(
+                frame->m_pts, frame->m_videoData.data(), frame->m_videoData.size(), error);
+        }
+        if (!continuable) {
+            bx::MutexScope locker(m_mutex);
+            BX_UNUSED_1(locker);
+            m_error = error;
+            m_failed = true;
+        }
+    }
+}
+
+} /* namespace internal */
+} /* namespace nanoem */
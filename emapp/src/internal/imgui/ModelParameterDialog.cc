@@ -327,7 +327,7 @@ struct LoadWeightFileCallback : IFileManager::QueryFileDialogCallbacks {
     struct WeightRow {
         void readColumn(const char *s, const char *e, int columnIndex, const Model *activeModel,
             nanoem_unicode_string_factory_t *factory);
-        void apply(nanoem_model_vertex_t *vertexPtr) const;
+        void apply(nanoem_model_vertex_t *vertexPtr, Model *activeModel) const;
         Vector3 m_origin;
         Vector3 m_normal;
         const nanoem_model_bone_t *m_bones[4];
@@ -342,7 +342,8 @@ struct LoadWeightFileCallback : IFileManager::QueryFileDialogCallbacks {
     static void handleAccept(const URI &fileURI, Project *project, Error &error, void *opaque);
     static int compareWeightRow(const void *a, const void *b) NANOEM_DECL_NOEXCEPT;
     static int compareOrigin(const Vector3 &a, const Vector3 &b) NANOEM_DECL_NOEXCEPT;
-    static bool applyVertex(const WeightRowList &rows, nanoem_model_vertex_t *vertexPtr) NANOEM_DECL_NOEXCEPT;
+    static bool applyVertex(
+        const WeightRowList &rows, nanoem_model_vertex_t *vertexPtr, Model *activeModel) NANOEM_DECL_NOEXCEPT;
 
     LoadWeightFileCallback(BaseNonModalDialogWindow *parent);
     ~LoadWeightFileCallback() NANOEM_DECL_NOEXCEPT;
@@ -390,7 +391,7 @@ LoadWeightFileCallback::handleAccept(const URI &fileURI, Project *project, Error
                 for (model::Vertex::Set::const_iterator it = vertexSet->begin(), end = vertexSet->end(); it != end;
                      ++it) {
                     nanoem_model_vertex_t *vertexPtr = const_cast<nanoem_model_vertex_t *>(*it);
-                    if (applyVertex(weightRows, vertexPtr)) {
+                    if (applyVertex(weightRows, vertexPtr, activeModel)) {
                         appliedNumVertices++;
                     }
                 }
@@ -400,7 +401,7 @@ LoadWeightFileCallback::handleAccept(const URI &fileURI, Project *project, Error
                     nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
                 for (nanoem_rsize_t i = 0; i < numVertices; i++) {
                     nanoem_model_vertex_t *vertexPtr = vertices[i];
-                    if (applyVertex(weightRows, vertexPtr)) {
+                    if (applyVertex(weightRows, vertexPtr, activeModel)) {
                         appliedNumVertices++;
                     }
                 }
@@ -477,9 +478,9 @@ LoadWeightFileCallback::WeightRow::readColumn(
 }
 
 void
-LoadWeightFileCallback::WeightRow::apply(nanoem_model_vertex_t *vertexPtr) const
+LoadWeightFileCallback::WeightRow::apply(nanoem_model_vertex_t *vertexPtr, Model *activeModel) const
 {
-    command::ScopedMutableVertex vertex(vertexPtr);
+    command::ScopedMutableVertex vertex(activeModel, vertexPtr);
     nanoemMutableModelVertexSetOrigin(vertex, glm::value_ptr(Vector4(m_origin, 1)));
     nanoemMutableModelVertexSetNormal(vertex, glm::value_ptr(Vector4(m_normal, 0)));
     nanoemMutableModelVertexSetSdefC(vertex, glm::value_ptr(Vector4(m_sdefC, 0)));
@@ -524,7 +525,8 @@ LoadWeightFileCallback::compareOrigin(const Vector3 &a, const Vector3 &b) NANOEM
 }
 
 bool
-LoadWeightFileCallback::applyVertex(const WeightRowList &rows, nanoem_model_vertex_t *vertexPtr) NANOEM_DECL_NOEXCEPT
+LoadWeightFileCallback::applyVertex(
+    const WeightRowList &rows, nanoem_model_vertex_t *vertexPtr, Model *activeModel) NANOEM_DECL_NOEXCEPT
 {
     WeightRow r;
     Inline::clearZeroMemory(r);
@@ -532,7 +534,7 @@ LoadWeightFileCallback::applyVertex(const WeightRowList &rows, nanoem_model_vert
     bool result = false;
     if (const WeightRow *row =
             static_cast<const WeightRow *>(bsearch(&r, rows.data(), rows.size(), sizeof(rows[0]), compareWeightRow))) {
-        row->apply(vertexPtr);
+        row->apply(vertexPtr, activeModel);
         result = true;
     }
     else {
@@ -546,7 +548,7 @@ LoadWeightFileCallback::applyVertex(const WeightRowList &rows, nanoem_model_vert
             }
         }
         if (nearest < kEpsilon && found) {
-            found->apply(vertexPtr);
+            found->apply(vertexPtr, activeModel);
             result = true;
         }
     }
@@ -1427,7 +1429,7 @@ ModelParameterDialog::layoutVertexBoneSelection(const char *label, nanoem_rsize_
             const nanoem_model_bone_t *bonePtr = bones[j];
             const model::Bone *bone = model::Bone::cast(bonePtr);
             if (bone && ImGui::Selectable(bone->nameConstString(), bonePtr == vertexBonePtr)) {
-                command::ScopedMutableVertex scoped(vertexPtr);
+                command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
                 nanoemMutableModelVertexSetBoneObject(scoped, bonePtr, i);
             }
         }
@@ -1474,7 +1476,7 @@ ModelParameterDialog::layoutVertexBoneWeights(nanoem_rsize_t numItems, nanoem_mo
         nanoem_f32_t weight = nanoemModelVertexGetBoneWeight(vertexPtr, i);
         StringUtils::format(label, sizeof(label), "##weight%jd", i);
         if (ImGui::SliderFloat(label, &weight, 0, 1)) {
-            command::ScopedMutableVertex scoped(vertexPtr);
+            command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
             nanoemMutableModelVertexSetBoneWeight(scoped, weight, i);
         }
         ImGui::PopItemWidth();
@@ -1724,7 +1726,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.origin"));
         Vector4 value(glm::make_vec4(nanoemModelVertexGetOrigin(vertexPtr)));
         if (ImGui::InputFloat3("##origin", glm::value_ptr(value))) {
-            command::ScopedMutableVertex scoped(vertexPtr);
+            command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
             nanoemMutableModelVertexSetOrigin(scoped, glm::value_ptr(value));
         }
     }
@@ -1732,7 +1734,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.normal"));
         Vector4 value(glm::make_vec4(nanoemModelVertexGetNormal(vertexPtr)));
         if (ImGui::InputFloat3("##normal", glm::value_ptr(value))) {
-            command::ScopedMutableVertex scoped(vertexPtr);
+            command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
             nanoemMutableModelVertexSetNormal(scoped, glm::value_ptr(value));
         }
     }
@@ -1740,7 +1742,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.texcoord"));
         Vector4 value(glm::make_vec4(nanoemModelVertexGetTexCoord(vertexPtr)));
         if (ImGui::InputFloat2("##texcoord", glm::value_ptr(value))) {
-            command::ScopedMutableVertex scoped(vertexPtr);
+            command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
             nanoemMutableModelVertexSetTexCoord(scoped, glm::value_ptr(value));
         }
     }
@@ -1763,7 +1765,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
         ImGui::SameLine();
         Vector4 value(glm::make_vec4(nanoemModelVertexGetAdditionalUV(vertexPtr, m_vertexCandidateUVAIndex)));
         if (ImGui::InputFloat4("##uva-value", glm::value_ptr(value))) {
-            command::ScopedMutableVertex scoped(vertexPtr);
+            command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
             nanoemMutableModelVertexSetAdditionalUV(scoped, glm::value_ptr(value), m_vertexCandidateUVAIndex);
         }
     }
@@ -1784,7 +1786,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.edge"));
         nanoem_f32_t width = nanoemModelVertexGetEdgeSize(vertexPtr);
         if (ImGui::InputFloat("##edge", &width)) {
-            command::ScopedMutableVertex scoped(vertexPtr);
+            command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
             nanoemMutableModelVertexSetEdgeSize(scoped, width);
         }
     }
@@ -1796,7 +1798,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
             for (int i = NANOEM_MODEL_VERTEX_TYPE_FIRST_ENUM; i < NANOEM_MODEL_VERTEX_TYPE_MAX_ENUM; i++) {
                 const nanoem_model_vertex_type_t type = static_cast<nanoem_model_vertex_type_t>(i);
                 if (ImGui::Selectable(selectedVertexType(type), type == value)) {
-                    command::ScopedMutableVertex scoped(vertexPtr);
+                    command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
                     nanoemMutableModelVertexSetType(scoped, type);
                 }
             }
@@ -1830,7 +1832,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
                 ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.sdef.r0"));
                 Vector4 value(glm::make_vec4(nanoemModelVertexGetSdefR0(vertexPtr)));
                 if (ImGui::InputFloat3("##sdef.r0", glm::value_ptr(value))) {
-                    command::ScopedMutableVertex scoped(vertexPtr);
+                    command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
                     nanoemMutableModelVertexSetSdefR0(scoped, glm::value_ptr(value));
                 }
             }
@@ -1838,7 +1840,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
                 ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.sdef.r1"));
                 Vector4 value(glm::make_vec4(nanoemModelVertexGetSdefR1(vertexPtr)));
                 if (ImGui::InputFloat3("##sdef.r1", glm::value_ptr(value))) {
-                    command::ScopedMutableVertex scoped(vertexPtr);
+                    command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
                     nanoemMutableModelVertexSetSdefR1(scoped, glm::value_ptr(value));
                 }
             }
@@ -1846,7 +1848,7 @@ ModelParameterDialog::layoutVertexPropertyPane(nanoem_model_vertex_t *vertexPtr)
                 ImGui::TextUnformatted(tr("nanoem.gui.model.edit.vertex.sdef.c"));
                 Vector4 value(glm::make_vec4(nanoemModelVertexGetSdefC(vertexPtr)));
                 if (ImGui::InputFloat3("##sdef.c", glm::value_ptr(value))) {
-                    command::ScopedMutableVertex scoped(vertexPtr);
+                    command::ScopedMutableVertex scoped(m_activeModel, vertexPtr);
                     nanoemMutableModelVertexSetSdefC(scoped, glm::value_ptr(value));
                 }
             }
@@ -2300,7 +2302,7 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelMaterialGetName(materialPtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMaterial scoped(materialPtr);
+        command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
         nanoemMutableModelMaterialSetName(scoped, scope.value(), language, &status);
         if (model::Material *material = model::Material::cast(materialPtr)) {
             material->resetLanguage(materialPtr, project->unicodeStringFactory(), language);
@@ -2311,7 +2313,7 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.material.ambient.color"));
         Vector4 value(glm::make_vec4(nanoemModelMaterialGetAmbientColor(materialPtr)));
         if (ImGui::ColorEdit3("##ambient", glm::value_ptr(value))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoemMutableModelMaterialSetAmbientColor(scoped, glm::value_ptr(value));
         }
     }
@@ -2320,7 +2322,7 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
         Vector4 value(glm::make_vec3(nanoemModelMaterialGetDiffuseColor(materialPtr)),
             nanoemModelMaterialGetDiffuseOpacity(materialPtr));
         if (ImGui::ColorEdit4("##diffuse", glm::value_ptr(value))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoemMutableModelMaterialSetDiffuseColor(scoped, glm::value_ptr(value));
             nanoemMutableModelMaterialSetDiffuseOpacity(scoped, value.w);
         }
@@ -2329,7 +2331,7 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.material.specular.color"));
         Vector4 value(glm::make_vec4(nanoemModelMaterialGetSpecularColor(materialPtr)));
         if (ImGui::ColorEdit3("##specular", glm::value_ptr(value))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoemMutableModelMaterialSetSpecularColor(scoped, glm::value_ptr(value));
         }
     }
@@ -2339,13 +2341,13 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
         Vector4 value(glm::make_vec3(nanoemModelMaterialGetEdgeColor(materialPtr)),
             nanoemModelMaterialGetEdgeOpacity(materialPtr));
         if (ImGui::ColorEdit4("##edge.color", glm::value_ptr(value))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoemMutableModelMaterialSetEdgeColor(scoped, glm::value_ptr(value));
             nanoemMutableModelMaterialSetEdgeOpacity(scoped, value.w);
         }
         nanoem_f32_t width = nanoemModelMaterialGetEdgeSize(materialPtr);
         if (ImGui::SliderFloat("##edge.size", &width, 0.0f, 0.0f, "Size: %.3f")) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoemMutableModelMaterialSetEdgeSize(scoped, width);
         }
     }
@@ -2353,17 +2355,17 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.material.primitive.type"));
         if (ImGui::BeginCombo("##primitive", selectedMaterialPrimitiveType(materialPtr))) {
             if (ImGui::Selectable(tr("nanoem.gui.model.edit.material.primitive.triangle"))) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetLineDrawEnabled(scoped, false);
                 nanoemMutableModelMaterialSetPointDrawEnabled(scoped, false);
             }
             if (ImGui::Selectable(tr("nanoem.gui.model.edit.material.primitive.line"))) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetLineDrawEnabled(scoped, true);
                 nanoemMutableModelMaterialSetPointDrawEnabled(scoped, false);
             }
             if (ImGui::Selectable(tr("nanoem.gui.model.edit.material.primitive.point"))) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetLineDrawEnabled(scoped, false);
                 nanoemMutableModelMaterialSetPointDrawEnabled(scoped, true);
             }
@@ -2380,7 +2382,7 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
                 const nanoem_model_material_sphere_map_texture_type_t type =
                     static_cast<nanoem_model_material_sphere_map_texture_type_t>(i);
                 if (ImGui::Selectable(selectedMaterialSphereMapType(type), value == type)) {
-                    command::ScopedMutableMaterial scoped(materialPtr);
+                    command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                     nanoemMutableModelMaterialSetSphereMapTextureType(scoped, type);
                 }
             }
@@ -2394,49 +2396,49 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
         {
             bool value = nanoemModelMaterialIsToonShared(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.shared-toon"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetToonShared(scoped, value);
             }
         }
         {
             bool value = nanoemModelMaterialIsEdgeEnabled(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.edge"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetEdgeEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelMaterialIsCullingDisabled(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.disable-culling"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetCullingDisabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelMaterialIsShadowMapEnabled(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.self-shadow"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetShadowMapEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelMaterialIsCastingShadowEnabled(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.casting-shadow"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetCastingShadowEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelMaterialIsCastingShadowMapEnabled(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.casting-self-shadow"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetCastingShadowMapEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelMaterialIsVertexColorEnabled(materialPtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.material.property.vertex-color"), &value)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoemMutableModelMaterialSetVertexColorEnabled(scoped, value);
             }
         }
@@ -2537,19 +2539,19 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
             ImGui::Separator();
         }
         if (diffuseImage && ImGui::MenuItem(tr("nanoem.gui.model.edit.action.material.texture.diffuse.clear"))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoem_status_t status = NANOEM_STATUS_SUCCESS;
             nanoemMutableModelMaterialSetDiffuseTextureObject(scoped, nullptr, &status);
             material->setDiffuseImage(nullptr);
         }
         if (sphereMapImage && ImGui::MenuItem(tr("nanoem.gui.model.edit.action.material.texture.spheremap.clear"))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoem_status_t status = NANOEM_STATUS_SUCCESS;
             nanoemMutableModelMaterialSetSphereMapTextureObject(scoped, nullptr, &status);
             material->setSphereMapImage(nullptr);
         }
         if (hasOwnToonTexture && ImGui::MenuItem(tr("nanoem.gui.model.edit.action.material.texture.toon.clear"))) {
-            command::ScopedMutableMaterial scoped(materialPtr);
+            command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
             nanoem_status_t status = NANOEM_STATUS_SUCCESS;
             nanoemMutableModelMaterialSetToonTextureObject(scoped, nullptr, &status);
             material->setToonImage(nullptr);
@@ -2589,7 +2591,7 @@ ModelParameterDialog::layoutMaterialPropertyPane(nanoem_model_material_t *materi
                 ImVec2(ImGui::GetContentRegionAvail().x, ImGui::GetTextLineHeightWithSpacing() * 5))) {
             StringUtils::UnicodeStringScope s(factory);
             if (StringUtils::tryGetString(factory, clobBuffer.data(), s)) {
-                command::ScopedMutableMaterial scoped(materialPtr);
+                command::ScopedMutableMaterial scoped(m_activeModel, materialPtr);
                 nanoem_status_t status = NANOEM_STATUS_SUCCESS;
                 nanoemMutableModelMaterialSetClob(scoped, s.value(), &status);
             }
@@ -2961,7 +2963,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelBoneGetName(bonePtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableBone scoped(bonePtr);
+        command::ScopedMutableBone scoped(m_activeModel, bonePtr);
         nanoemMutableModelBoneSetName(scoped, scope.value(), language, &status);
         if (model::Bone *bone = model::Bone::cast(bonePtr)) {
             bone->resetLanguage(bonePtr, project->unicodeStringFactory(), language);
@@ -2972,7 +2974,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.bone.origin"));
         Vector4 value(glm::make_vec4(nanoemModelBoneGetOrigin(bonePtr)));
         if (ImGui::InputFloat3("##origin", glm::value_ptr(value))) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             nanoemMutableModelBoneSetOrigin(scoped, glm::value_ptr(value));
         }
     }
@@ -2986,12 +2988,12 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
         bool value = nanoemModelBoneHasDestinationBone(bonePtr) != 0;
         ImGui::BeginGroup();
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.bone.destination.bone"), value)) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             nanoemMutableModelBoneSetTargetBoneObject(scoped, nanoemModelBoneGetTargetBoneObject(bonePtr));
         }
         ImGui::SameLine();
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.bone.destination.origin"), value ? false : true)) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             const Vector4 copy(glm::make_vec4(nanoemModelBoneGetDestinationOrigin(bonePtr)));
             nanoemMutableModelBoneSetDestinationOrigin(scoped, glm::value_ptr(copy));
         }
@@ -3002,7 +3004,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
         else {
             Vector3 origin(glm::make_vec3(nanoemModelBoneGetDestinationOrigin(bonePtr)));
             if (ImGui::DragFloat3("##destination.origin", glm::value_ptr(origin))) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetDestinationOrigin(scoped, glm::value_ptr(origin));
             }
         }
@@ -3014,7 +3016,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.bone.stage"));
         int stageIndex = nanoemModelBoneGetStageIndex(bonePtr);
         if (ImGui::InputInt("##stage", &stageIndex)) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             nanoemMutableModelBoneSetStageIndex(scoped, stageIndex);
         }
     }
@@ -3024,70 +3026,70 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
         {
             bool value = nanoemModelBoneIsVisible(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.visible"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetVisible(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneIsMovable(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.movable"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetMovable(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneIsRotateable(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.rotateable"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetRotateable(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneIsUserHandleable(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.user-handleable"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetUserHandleable(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneHasLocalInherent(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.inherent.local"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetLocalInherentEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneIsAffectedByPhysicsSimulation(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.affected-by-physics-simulation"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetAffectedByPhysicsSimulation(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneHasInherentTranslation(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.inherent.translation"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetInherentTranslationEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneHasInherentOrientation(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.inherent.orientation"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetInherentOrientationEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneHasFixedAxis(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.has-fixed-axis"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetFixedAxisEnabled(scoped, value);
             }
         }
         {
             bool value = nanoemModelBoneHasLocalAxes(bonePtr) != 0;
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.has-local-axes"), &value)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetLocalAxesEnabled(scoped, value);
             }
         }
@@ -3096,7 +3098,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.inverse-kinematics"), &value)) {
                 nanoem_status_t status = NANOEM_STATUS_SUCCESS;
                 command::ScopedMutableModel sm(m_activeModel, &status);
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetConstraintEnabled(scoped, value);
                 nanoem_mutable_model_constraint_t *constraint = nullptr;
                 if (value) {
@@ -3126,7 +3128,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
             StringUtils::format(
                 buffer, sizeof(buffer), "%s: %%.2f", tr("nanoem.gui.model.edit.bone.inherent.coefficient"));
             if (ImGui::DragFloat("##coefficient", &coefficient, 1.0f, 0.0, 0.0f, buffer)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetInherentCoefficient(scoped, coefficient);
             }
         }
@@ -3145,7 +3147,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
             ImGui::SameLine();
             Vector3 axis(glm::make_vec3(nanoemModelBoneGetFixedAxis(bonePtr)));
             if (ImGui::DragFloat3("##axis", glm::value_ptr(axis), 1.0f, 0.0f, 1.0f)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetFixedAxis(scoped, glm::value_ptr(axis));
             }
             ImGui::EndGroup();
@@ -3168,7 +3170,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
             Vector3 axisX(glm::make_vec3(nanoemModelBoneGetLocalXAxis(bonePtr)));
             ImGui::TextUnformatted(tr("nanoem.gui.model.edit.bone.local-axis.x"));
             if (ImGui::DragFloat3("##axis.x", glm::value_ptr(axisX), 1.0f, 0.0f, 1.0f)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetLocalXAxis(scoped, glm::value_ptr(axisX));
             }
             StringUtils::format(buffer, sizeof(buffer), "%s##properties.local-axes.z.op.button", ImGuiWindow::kFACogs);
@@ -3183,7 +3185,7 @@ ModelParameterDialog::layoutBonePropertyPane(nanoem_model_bone_t *bonePtr, Proje
             ImGui::TextUnformatted(tr("nanoem.gui.model.edit.bone.local-axis.z"));
             Vector3 axisZ(glm::make_vec3(nanoemModelBoneGetLocalZAxis(bonePtr)));
             if (ImGui::DragFloat3("##axis.z", glm::value_ptr(axisZ), 1.0f, 0.0f, 1.0f)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 nanoemMutableModelBoneSetLocalZAxis(scoped, glm::value_ptr(axisZ));
             }
             ImGui::EndGroup();
@@ -3219,7 +3221,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
                         const nanoem_model_bone_t *targetBonePtr = bones[i];
                         targetBone = model::Bone::cast(targetBonePtr);
                         if (targetBone && ImGui::Selectable(targetBone->nameConstString())) {
-                            command::ScopedMutableConstraint scoped(constraintPtr);
+                            command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                             nanoemMutableModelConstraintSetTargetBoneObject(scoped, targetBonePtr);
                         }
                     }
@@ -3240,7 +3242,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             ImGui::SameLine();
             if (ImGui::BeginCombo("##constriant.effector", effectorBone ? effectorBone->nameConstString() : "(none)")) {
                 if (ImGui::Selectable("(none)", !effectorBone)) {
-                    command::ScopedMutableConstraint scoped(constraintPtr);
+                    command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                     nanoemMutableModelConstraintSetEffectorBoneObject(scoped, nullptr);
                 }
                 for (nanoem_rsize_t i = 0; i < numBones; i++) {
@@ -3248,7 +3250,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
                     const model::Bone *candidateBone = model::Bone::cast(candidateBonePtr);
                     if (candidateBone &&
                         ImGui::Selectable(candidateBone->nameConstString(), candidateBone == effectorBone)) {
-                        command::ScopedMutableConstraint scoped(constraintPtr);
+                        command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                         nanoemMutableModelConstraintSetEffectorBoneObject(scoped, candidateBonePtr);
                     }
                 }
@@ -3260,7 +3262,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             StringUtils::format(
                 buffer, sizeof(buffer), "%s: %%d", tr("nanoem.gui.model.edit.bone.constraint.iteration"));
             if (ImGui::DragInt("##constraint.iterations", &value, 1.0f, 0, 0xff, buffer)) {
-                command::ScopedMutableConstraint scoped(constraintPtr);
+                command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                 nanoemMutableModelConstraintSetNumIterations(scoped, value);
             }
         }
@@ -3268,7 +3270,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             nanoem_f32_t value = glm::degrees(nanoemModelConstraintGetAngleLimit(constraintPtr));
             StringUtils::format(buffer, sizeof(buffer), "%s: %%.3f", tr("nanoem.gui.model.edit.bone.constraint.angle"));
             if (ImGui::SliderFloat("##constraint.angle", &value, -90, 90, buffer)) {
-                command::ScopedMutableConstraint scoped(constraintPtr);
+                command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                 nanoemMutableModelConstraintSetAngleLimit(scoped, glm::radians(value));
             }
         }
@@ -3332,7 +3334,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.bone.constraint.joints.add"),
                     ImGui::GetContentRegionAvail().x * 0.5f, manipulatable)) {
                 nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-                command::ScopedMutableConstraint scoped(constraintPtr);
+                command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                 nanoem_mutable_model_constraint_joint_t *joint =
                     nanoemMutableModelConstraintJointCreate(scoped, &status);
                 nanoemMutableModelConstraintJointSetBoneObject(joint, bones[m_constraintJointCandidateIndex]);
@@ -3345,7 +3347,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.bone.constraint.joints.remove"),
                     ImGui::GetContentRegionAvail().x, m_constraintJointIndex < numJoints)) {
                 nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-                command::ScopedMutableConstraint scoped(constraintPtr);
+                command::ScopedMutableConstraint scoped(m_activeModel, constraintPtr);
                 nanoem_mutable_model_constraint_joint_t *joint =
                     nanoemMutableModelConstraintJointCreateAsReference(joints[m_constraintJointIndex], &status);
                 nanoemMutableModelConstraintRemoveJointObject(scoped, joint, &status);
@@ -3359,7 +3361,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
         {
             bool value = nanoemModelConstraintJointHasAngleLimit(jointPtr);
             if (ImGui::Checkbox(tr("nanoem.gui.model.edit.bone.constraint.joint.angle-limit"), &value)) {
-                command::ScopedMutableConstraintJoint scoped(jointPtr);
+                command::ScopedMutableConstraintJoint scoped(m_activeModel, jointPtr);
                 nanoemMutableModelConstraintJointSetAngleLimitEnabled(scoped, value ? 1 : 0);
             }
         }
@@ -3367,7 +3369,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             Vector3 lowerLimit(glm::degrees(glm::make_vec3(nanoemModelConstraintJointGetLowerLimit(jointPtr))));
             ImGui::TextUnformatted(tr("nanoem.gui.model.edit.bone.constraint.joint.angle-limit.lower"));
             if (ImGui::DragFloat3("##joint.upper", glm::value_ptr(lowerLimit), 1.0f, 0.0f, 180.0f)) {
-                command::ScopedMutableConstraintJoint scoped(jointPtr);
+                command::ScopedMutableConstraintJoint scoped(m_activeModel, jointPtr);
                 nanoemMutableModelConstraintJointSetLowerLimit(scoped, glm::value_ptr(glm::radians(lowerLimit)));
             }
         }
@@ -3375,7 +3377,7 @@ ModelParameterDialog::layoutBoneConstraintPanel(nanoem_model_bone_t *bonePtr, Pr
             Vector3 upperLimit(glm::degrees(glm::make_vec3(nanoemModelConstraintJointGetUpperLimit(jointPtr))));
             ImGui::TextUnformatted(tr("nanoem.gui.model.edit.bone.constraint.joint.angle-limit.upper"));
             if (ImGui::DragFloat3("##joint.lower", glm::value_ptr(upperLimit), 1.0f, 0.0f, 180.0f)) {
-                command::ScopedMutableConstraintJoint scoped(jointPtr);
+                command::ScopedMutableConstraintJoint scoped(m_activeModel, jointPtr);
                 nanoemMutableModelConstraintJointSetUpperLimit(scoped, glm::value_ptr(glm::radians(upperLimit)));
             }
         }
@@ -3635,7 +3637,7 @@ ModelParameterDialog::layoutMorphPropertyPane(nanoem_model_morph_t *morphPtr, Pr
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelMorphGetName(morphPtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoemMutableModelMorphSetName(scoped, scope.value(), language, &status);
         if (model::Morph *morph = model::Morph::cast(morphPtr)) {
             morph->resetLanguage(morphPtr, project->unicodeStringFactory(), language);
@@ -3649,7 +3651,7 @@ ModelParameterDialog::layoutMorphPropertyPane(nanoem_model_morph_t *morphPtr, Pr
             for (int i = NANOEM_MODEL_MORPH_CATEGORY_FIRST_ENUM; i < NANOEM_MODEL_MORPH_CATEGORY_MAX_ENUM; i++) {
                 const nanoem_model_morph_category_t type = static_cast<nanoem_model_morph_category_t>(i);
                 if (ImGui::Selectable(selectedMorphCategory(type), value == type)) {
-                    command::ScopedMutableMorph scoped(morphPtr);
+                    command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
                     nanoemMutableModelMorphSetCategory(scoped, type);
                 }
             }
@@ -3663,7 +3665,7 @@ ModelParameterDialog::layoutMorphPropertyPane(nanoem_model_morph_t *morphPtr, Pr
             for (int i = NANOEM_MODEL_MORPH_TYPE_FIRST_ENUM; i < NANOEM_MODEL_MORPH_TYPE_MAX_ENUM; i++) {
                 const nanoem_model_morph_type_t type = static_cast<nanoem_model_morph_type_t>(i);
                 if (ImGui::Selectable(selectedMorphType(type), value == type)) {
-                    command::ScopedMutableMorph scoped(morphPtr);
+                    command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
                     nanoemMutableModelMorphSetType(scoped, type);
                 }
             }
@@ -3771,7 +3773,7 @@ ModelParameterDialog::layoutMorphBonePropertyPane(const ImVec2 &propertyWindowSi
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.bone.add"), ImGui::GetContentRegionAvail().x * 0.5f,
             m_morphItemCandidateBoneIndex < numBones)) {
         nanoem_status_t status;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_bone_t *item = nanoemMutableModelMorphBoneCreate(scoped, &status);
         nanoemMutableModelMorphBoneSetBoneObject(item, bones[m_morphItemCandidateBoneIndex]);
         nanoemMutableModelMorphInsertBoneMorphObject(scoped, item, -1, &status);
@@ -3783,7 +3785,7 @@ ModelParameterDialog::layoutMorphBonePropertyPane(const ImVec2 &propertyWindowSi
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.bone.remove"), ImGui::GetContentRegionAvail().x,
             m_morphItemIndex < numItems)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_bone_t *item =
             nanoemMutableModelMorphBoneCreateAsReference(items[m_morphItemIndex], &status);
         nanoemMutableModelMorphRemoveBoneMorphObject(scoped, item, &status);
@@ -3805,7 +3807,7 @@ ModelParameterDialog::layoutMorphBonePropertyPane(const ImVec2 &propertyWindowSi
         Vector4 translation(glm::make_vec4(nanoemModelMorphBoneGetTranslation(morphBonePtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.bone.translation"));
         if (ImGui::DragFloat3("##bone.translation", glm::value_ptr(translation), 1.0f, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphBone scoped(morphBonePtr);
+            command::ScopedMutableMorphBone scoped(m_activeModel, morphBonePtr);
             nanoemMutableModelMorphBoneSetTranslation(scoped, glm::value_ptr(translation));
         }
     }
@@ -3814,7 +3816,7 @@ ModelParameterDialog::layoutMorphBonePropertyPane(const ImVec2 &propertyWindowSi
         Vector3 angles(glm::degrees(glm::eulerAngles(orientation)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.bone.orientation"));
         if (ImGui::DragFloat3("##bone.orientation", glm::value_ptr(angles), 1.0f, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphBone scoped(morphBonePtr);
+            command::ScopedMutableMorphBone scoped(m_activeModel, morphBonePtr);
             nanoemMutableModelMorphBoneSetOrientation(scoped, glm::value_ptr(glm::quat(glm::radians(angles))));
         }
     }
@@ -3876,7 +3878,7 @@ ModelParameterDialog::layoutMorphFlipPropertyPane(const ImVec2 &propertyWindowSi
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.flip.add"), ImGui::GetContentRegionAvail().x * 0.5f,
             m_morphItemCandidateMorphIndex < numMorphs)) {
         nanoem_status_t status;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_flip_t *item = nanoemMutableModelMorphFlipCreate(scoped, &status);
         nanoemMutableModelMorphFlipSetMorphObject(item, morphs[m_morphItemCandidateMorphIndex]);
         nanoemMutableModelMorphInsertFlipMorphObject(scoped, item, -1, &status);
@@ -3888,7 +3890,7 @@ ModelParameterDialog::layoutMorphFlipPropertyPane(const ImVec2 &propertyWindowSi
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.flip.remove"), ImGui::GetContentRegionAvail().x,
             m_morphItemIndex < numItems)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_flip_t *item =
             nanoemMutableModelMorphFlipCreateAsReference(items[m_morphItemIndex], &status);
         nanoemMutableModelMorphRemoveFlipMorphObject(scoped, item, &status);
@@ -3910,7 +3912,7 @@ ModelParameterDialog::layoutMorphFlipPropertyPane(const ImVec2 &propertyWindowSi
         nanoem_f32_t weight = nanoemModelMorphFlipGetWeight(morphFlipPtr);
         StringUtils::format(buffer, sizeof(buffer), "%s %%.3f", tr("nanoem.gui.model.edit.morph.flip.weight"));
         if (ImGui::SliderFloat("##flip.weight", &weight, 0.0f, 0.0f, buffer)) {
-            command::ScopedMutableMorphFlip scoped(morphFlipPtr);
+            command::ScopedMutableMorphFlip scoped(m_activeModel, morphFlipPtr);
             nanoemMutableModelMorphFlipSetWeight(scoped, weight);
         }
     }
@@ -3972,7 +3974,7 @@ ModelParameterDialog::layoutMorphGroupPropertyPane(const ImVec2 &propertyWindowS
     if (ImGuiWindow::handleButton(
             tr("nanoem.gui.model.edit.morph.group.add"), ImGui::GetContentRegionAvail().x * 0.5f, true)) {
         nanoem_status_t status;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_group_t *item = nanoemMutableModelMorphGroupCreate(scoped, &status);
         nanoemMutableModelMorphGroupSetMorphObject(item, morphs[m_morphItemCandidateMorphIndex]);
         nanoemMutableModelMorphInsertGroupMorphObject(scoped, item, -1, &status);
@@ -3984,7 +3986,7 @@ ModelParameterDialog::layoutMorphGroupPropertyPane(const ImVec2 &propertyWindowS
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.group.remove"), ImGui::GetContentRegionAvail().x,
             m_morphItemIndex < numItems)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_group_t *item =
             nanoemMutableModelMorphGroupCreateAsReference(items[m_morphItemIndex], &status);
         nanoemMutableModelMorphRemoveGroupMorphObject(scoped, item, &status);
@@ -4006,7 +4008,7 @@ ModelParameterDialog::layoutMorphGroupPropertyPane(const ImVec2 &propertyWindowS
         nanoem_f32_t weight = nanoemModelMorphGroupGetWeight(morphGroupPtr);
         StringUtils::format(buffer, sizeof(buffer), "%s %%.3f", tr("nanoem.gui.model.edit.morph.group.weight"));
         if (ImGui::SliderFloat("##group.weight", &weight, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphGroup scoped(morphGroupPtr);
+            command::ScopedMutableMorphGroup scoped(m_activeModel, morphGroupPtr);
             nanoemMutableModelMorphGroupSetWeight(scoped, weight);
         }
     }
@@ -4069,7 +4071,7 @@ ModelParameterDialog::layoutMorphImpulsePropertyPane(const ImVec2 &propertyWindo
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.impulse.add"),
             ImGui::GetContentRegionAvail().x * 0.5f, m_morphItemCandidateRigidBodyIndex < numRigidBodies)) {
         nanoem_status_t status;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_impulse_t *item = nanoemMutableModelMorphImpulseCreate(scoped, &status);
         nanoemMutableModelMorphImpulseSetRigidBodyObject(item, rigidBodies[m_morphItemCandidateRigidBodyIndex]);
         nanoemMutableModelMorphInsertImpulseMorphObject(scoped, item, -1, &status);
@@ -4081,7 +4083,7 @@ ModelParameterDialog::layoutMorphImpulsePropertyPane(const ImVec2 &propertyWindo
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.impulse.remove"), ImGui::GetContentRegionAvail().x,
             m_morphItemIndex < numItems)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_impulse_t *item =
             nanoemMutableModelMorphImpulseCreateAsReference(items[m_morphItemIndex], &status);
         nanoemMutableModelMorphRemoveImpulseMorphObject(scoped, item, &status);
@@ -4103,7 +4105,7 @@ ModelParameterDialog::layoutMorphImpulsePropertyPane(const ImVec2 &propertyWindo
         Vector4 torque(glm::make_vec4(nanoemModelMorphImpulseGetTorque(morphImpulsePtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.impulse.torque"));
         if (ImGui::DragFloat3("##impulse.torque", glm::value_ptr(torque), 1.0f, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphImpulse scoped(morphImpulsePtr);
+            command::ScopedMutableMorphImpulse scoped(m_activeModel, morphImpulsePtr);
             nanoemMutableModelMorphImpulseSetTorque(scoped, glm::value_ptr(torque));
         }
     }
@@ -4111,7 +4113,7 @@ ModelParameterDialog::layoutMorphImpulsePropertyPane(const ImVec2 &propertyWindo
         Vector4 torque(glm::make_vec4(nanoemModelMorphImpulseGetVelocity(morphImpulsePtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.impulse.velocity"));
         if (ImGui::DragFloat3("##impulse.velocity", glm::value_ptr(torque), 1.0f, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphImpulse scoped(morphImpulsePtr);
+            command::ScopedMutableMorphImpulse scoped(m_activeModel, morphImpulsePtr);
             nanoemMutableModelMorphImpulseSetVelocity(scoped, glm::value_ptr(torque));
         }
     }
@@ -4119,7 +4121,7 @@ ModelParameterDialog::layoutMorphImpulsePropertyPane(const ImVec2 &propertyWindo
         bool isLocal = nanoemModelMorphImpulseIsLocal(morphImpulsePtr) != 0;
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.impulse.local"));
         if (ImGui::Checkbox("##impuluse.local", &isLocal)) {
-            command::ScopedMutableMorphImpulse scoped(morphImpulsePtr);
+            command::ScopedMutableMorphImpulse scoped(m_activeModel, morphImpulsePtr);
             nanoemMutableModelMorphImpulseSetLocal(scoped, isLocal ? 1 : 0);
         }
     }
@@ -4180,7 +4182,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.material.add"),
             ImGui::GetContentRegionAvail().x * 0.5f, m_morphItemCandidateMaterialIndex < numMaterials)) {
         nanoem_status_t status;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_material_t *item = nanoemMutableModelMorphMaterialCreate(scoped, &status);
         nanoemMutableModelMorphMaterialSetMaterialObject(item, materials[m_morphItemCandidateMaterialIndex]);
         nanoemMutableModelMorphInsertMaterialMorphObject(scoped, item, -1, &status);
@@ -4192,7 +4194,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
     if (ImGuiWindow::handleButton(tr("nanoem.gui.model.edit.morph.material.remove"), ImGui::GetContentRegionAvail().x,
             m_morphItemIndex < numItems)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableMorph scoped(morphPtr);
+        command::ScopedMutableMorph scoped(m_activeModel, morphPtr);
         nanoem_mutable_model_morph_material_t *item =
             nanoemMutableModelMorphMaterialCreateAsReference(items[m_morphItemIndex], &status);
         nanoemMutableModelMorphRemoveMaterialMorphObject(scoped, item, &status);
@@ -4220,7 +4222,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
                 const nanoem_model_morph_material_operation_type_t type =
                     static_cast<nanoem_model_morph_material_operation_type_t>(i);
                 if (ImGui::Selectable(selectedMorphMaterialOperationType(type), value == type)) {
-                    command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+                    command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
                     nanoemMutableModelMorphMaterialSetOperationType(scoped, type);
                 }
             }
@@ -4231,7 +4233,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         Vector4 ambientColor(glm::make_vec4(nanoemModelMorphMaterialGetAmbientColor(morphMaterialPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.ambient.color"));
         if (ImGui::ColorEdit3("##material.ambient.color", glm::value_ptr(ambientColor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetAmbientColor(scoped, glm::value_ptr(ambientColor));
         }
     }
@@ -4240,7 +4242,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
             nanoemModelMorphMaterialGetDiffuseOpacity(morphMaterialPtr));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.diffuse.color"));
         if (ImGui::ColorEdit4("##material.diffuse.color", glm::value_ptr(diffuseColor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetDiffuseColor(scoped, glm::value_ptr(diffuseColor));
             nanoemMutableModelMorphMaterialSetDiffuseOpacity(scoped, diffuseColor.w);
         }
@@ -4249,7 +4251,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         Vector4 specularColor(glm::make_vec4(nanoemModelMorphMaterialGetSpecularColor(morphMaterialPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.specular.color"));
         if (ImGui::ColorEdit3("##material.specular.color", glm::value_ptr(specularColor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetSpecularColor(scoped, glm::value_ptr(specularColor));
         }
     }
@@ -4257,7 +4259,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         nanoem_f32_t specularPower = nanoemModelMorphMaterialGetSpecularPower(morphMaterialPtr);
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.specular.power"));
         if (ImGui::DragFloat("##material.specular.power", &specularPower)) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetSpecularPower(scoped, specularPower);
         }
     }
@@ -4267,7 +4269,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
             nanoemModelMorphMaterialGetEdgeOpacity(morphMaterialPtr));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.edge.color"));
         if (ImGui::ColorEdit4("##material.edge.color", glm::value_ptr(edgeColor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetEdgeColor(scoped, glm::value_ptr(edgeColor));
             nanoemMutableModelMorphMaterialSetEdgeOpacity(scoped, edgeColor.w);
         }
@@ -4276,7 +4278,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         nanoem_f32_t edgeSize = nanoemModelMorphMaterialGetEdgeSize(morphMaterialPtr);
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.edge.size"));
         if (ImGui::DragFloat("##material.edge.size", &edgeSize)) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetEdgeSize(scoped, edgeSize);
         }
     }
@@ -4285,7 +4287,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         Vector4 blendFactor(glm::make_vec4(nanoemModelMorphMaterialGetDiffuseTextureBlend(morphMaterialPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.blend.diffuse"));
         if (ImGui::ColorEdit4("##material.blend.diffuse", glm::value_ptr(blendFactor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetDiffuseTextureBlend(scoped, glm::value_ptr(blendFactor));
         }
     }
@@ -4293,7 +4295,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         Vector4 blendFactor(glm::make_vec4(nanoemModelMorphMaterialGetSphereMapTextureBlend(morphMaterialPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.blend.sphere-map"));
         if (ImGui::ColorEdit4("##material.blend.sphere-map", glm::value_ptr(blendFactor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetSphereMapTextureBlend(scoped, glm::value_ptr(blendFactor));
         }
     }
@@ -4301,7 +4303,7 @@ ModelParameterDialog::layoutMorphMaterialPropertyPane(const ImVec2 &propertyWind
         Vector4 blendFactor(glm::make_vec4(nanoemModelMorphMaterialGetToonTextureBlend(morphMaterialPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.material.blend.toon"));
         if (ImGui::ColorEdit4("##material.blend.toon", glm::value_ptr(blendFactor))) {
-            command::ScopedMutableMorphMaterial scoped(morphMaterialPtr);
+            command::ScopedMutableMorphMaterial scoped(m_activeModel, morphMaterialPtr);
             nanoemMutableModelMorphMaterialSetToonTextureBlend(scoped, glm::value_ptr(blendFactor));
         }
     }
@@ -4347,7 +4349,7 @@ ModelParameterDialog::layoutMorphUVPropertyPane(const ImVec2 &propertyWindowSize
         Vector4 position(glm::make_vec4(nanoemModelMorphUVGetPosition(morphUVPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.uv.position"));
         if (ImGui::DragFloat4("##uv.position", glm::value_ptr(position), 1.0f, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphUV scoped(morphUVPtr);
+            command::ScopedMutableMorphUV scoped(m_activeModel, morphUVPtr);
             nanoemMutableModelMorphUVSetPosition(scoped, glm::value_ptr(position));
         }
     }
@@ -4393,7 +4395,7 @@ ModelParameterDialog::layoutMorphVertexPropertyPane(const ImVec2 &propertyWindow
         Vector4 position(glm::make_vec4(nanoemModelMorphVertexGetPosition(morphVertexPtr)));
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.morph.vertex.position"));
         if (ImGui::DragFloat3("##vertex.position", glm::value_ptr(position), 1.0f, 0.0f, 0.0f)) {
-            command::ScopedMutableMorphVertex scoped(morphVertexPtr);
+            command::ScopedMutableMorphVertex scoped(m_activeModel, morphVertexPtr);
             nanoemMutableModelMorphVertexSetPosition(scoped, glm::value_ptr(position));
         }
     }
@@ -4525,7 +4527,7 @@ ModelParameterDialog::layoutLabelPropertyPane(nanoem_model_label_t *labelPtr, Pr
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelLabelGetName(labelPtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableLabel scoped(labelPtr);
+        command::ScopedMutableLabel scoped(m_activeModel, labelPtr);
         nanoemMutableModelLabelSetName(scoped, scope.value(), language, &status);
         if (model::Label *label = model::Label::cast(labelPtr)) {
             label->resetLanguage(labelPtr, project->unicodeStringFactory(), language);
@@ -4535,7 +4537,7 @@ ModelParameterDialog::layoutLabelPropertyPane(nanoem_model_label_t *labelPtr, Pr
     {
         bool value = nanoemModelLabelIsSpecial(labelPtr) != 0;
         if (ImGuiWindow::handleCheckBox(tr("nanoem.gui.model.edit.label.special"), &value, m_labelIndex > 0)) {
-            command::ScopedMutableLabel scoped(labelPtr);
+            command::ScopedMutableLabel scoped(m_activeModel, labelPtr);
             nanoemMutableModelLabelSetSpecial(scoped, value);
         }
     }
@@ -4616,7 +4618,7 @@ ModelParameterDialog::layoutLabelPropertyPane(nanoem_model_label_t *labelPtr, Pr
                 m_labelIndex > 0 &&
                     (m_labelItemCandidateBoneIndex < numBones || m_labelItemCandidateMorphIndex < numMorphs))) {
             nanoem_status_t status;
-            command::ScopedMutableLabel scoped(labelPtr);
+            command::ScopedMutableLabel scoped(m_activeModel, labelPtr);
             nanoem_mutable_model_label_item_t *item = nullptr;
             if (m_labelItemCandidateBoneIndex < numBones) {
                 item = nanoemMutableModelLabelItemCreateFromBoneObject(
@@ -4637,7 +4639,7 @@ ModelParameterDialog::layoutLabelPropertyPane(nanoem_model_label_t *labelPtr, Pr
         if (ImGuiWindow::handleButton(
                 "Remove", ImGui::GetContentRegionAvail().x, m_labelIndex > 0 && m_labelItemIndex < numItems)) {
             nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-            command::ScopedMutableLabel scoped(labelPtr);
+            command::ScopedMutableLabel scoped(m_activeModel, labelPtr);
             nanoem_mutable_model_label_item_t *item =
                 nanoemMutableModelLabelItemCreateAsReference(items[m_labelItemIndex], &status);
             nanoemMutableModelLabelRemoveItemObject(scoped, item, &status);
@@ -4912,7 +4914,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelRigidBodyGetName(rigidBodyPtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+        command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
         nanoemMutableModelRigidBodySetName(scoped, scope.value(), language, &status);
         if (model::RigidBody *rigidBody = model::RigidBody::cast(rigidBodyPtr)) {
             rigidBody->resetLanguage(rigidBodyPtr, project->unicodeStringFactory(), language);
@@ -4938,7 +4940,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
                     StringUtils::format(
                         buffer, sizeof(buffer), "%s##item[%lu].name", candidateBone->nameConstString(), i);
                     if (ImGui::Selectable(candidateBone->nameConstString(), candidateBone == bone)) {
-                        command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+                        command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
                         nanoemMutableModelRigidBodySetBoneObject(scoped, candidateBonePtr);
                     }
                 }
@@ -4950,7 +4952,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.rigid-body.origin"));
         Vector4 value(glm::make_vec4(nanoemModelRigidBodyGetOrigin(rigidBodyPtr)));
         if (ImGui::InputFloat3("##origin", glm::value_ptr(value))) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetOrigin(scoped, glm::value_ptr(value));
         }
     }
@@ -4958,7 +4960,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.rigid-body.orientation"));
         Vector4 value(glm::make_vec4(nanoemModelRigidBodyGetOrientation(rigidBodyPtr)));
         if (ImGui::InputFloat3("##orientation", glm::value_ptr(value))) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetOrientation(scoped, glm::value_ptr(value));
         }
     }
@@ -4966,7 +4968,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.rigid-body.shape.size"));
         Vector4 value(glm::make_vec4(nanoemModelRigidBodyGetShapeSize(rigidBodyPtr)));
         if (ImGui::InputFloat3("##size", glm::value_ptr(value))) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetShapeSize(scoped, glm::value_ptr(value));
         }
     }
@@ -4975,19 +4977,19 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         nanoem_model_rigid_body_shape_type_t value = nanoemModelRigidBodyGetShapeType(rigidBodyPtr);
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.rigid-body.shape-type.sphere"),
                 value == NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_SPHERE)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetShapeType(scoped, NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_SPHERE);
         }
         ImGui::SameLine();
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.rigid-body.shape-type.box"),
                 value == NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_BOX)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetShapeType(scoped, NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_BOX);
         }
         ImGui::SameLine();
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.rigid-body.shape-type.capsule"),
                 value == NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_CAPSULE)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetShapeType(scoped, NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_CAPSULE);
         }
     }
@@ -4996,19 +4998,19 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         nanoem_model_rigid_body_transform_type_t value = nanoemModelRigidBodyGetTransformType(rigidBodyPtr);
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.rigid-body.object-type.static"),
                 value == NANOEM_MODEL_RIGID_BODY_TRANSFORM_TYPE_FROM_BONE_TO_SIMULATION)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetTransformType(
                 scoped, NANOEM_MODEL_RIGID_BODY_TRANSFORM_TYPE_FROM_BONE_TO_SIMULATION);
         }
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.rigid-body.object-type.dynamic"),
                 value == NANOEM_MODEL_RIGID_BODY_TRANSFORM_TYPE_FROM_SIMULATION_TO_BONE)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetTransformType(
                 scoped, NANOEM_MODEL_RIGID_BODY_TRANSFORM_TYPE_FROM_SIMULATION_TO_BONE);
         }
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.rigid-body.object-type.kinematic"),
                 value == NANOEM_MODEL_RIGID_BODY_TRANSFORM_TYPE_FROM_BONE_ORIENTATION_AND_SIMULATION_TO_BONE)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetTransformType(
                 scoped, NANOEM_MODEL_RIGID_BODY_TRANSFORM_TYPE_FROM_BONE_ORIENTATION_AND_SIMULATION_TO_BONE);
         }
@@ -5018,7 +5020,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.rigid-body.mass"));
         nanoem_f32_t value = nanoemModelRigidBodyGetMass(rigidBodyPtr);
         if (ImGui::InputFloat("##mass", &value)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetMass(scoped, value);
         }
     }
@@ -5026,7 +5028,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         StringUtils::format(buffer, sizeof(buffer), "%s: %%.3f", tr("nanoem.gui.model.edit.rigid-body.linear-damping"));
         nanoem_f32_t value = nanoemModelRigidBodyGetLinearDamping(rigidBodyPtr);
         if (ImGui::SliderFloat("##damping.linear", &value, 0.0f, 1.0f, buffer)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetLinearDamping(scoped, value);
         }
     }
@@ -5035,7 +5037,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
             buffer, sizeof(buffer), "%s: %%.3f", tr("nanoem.gui.model.edit.rigid-body.angular-damping"));
         nanoem_f32_t value = nanoemModelRigidBodyGetAngularDamping(rigidBodyPtr);
         if (ImGui::SliderFloat("##damping.angular", &value, 0.0f, 1.0f, buffer)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetAngularDamping(scoped, value);
         }
     }
@@ -5043,7 +5045,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         StringUtils::format(buffer, sizeof(buffer), "%s: %%.3f", tr("nanoem.gui.model.edit.rigid-body.friction"));
         nanoem_f32_t value = nanoemModelRigidBodyGetFriction(rigidBodyPtr);
         if (ImGui::SliderFloat("##friction", &value, 0.0f, 1.0f, buffer)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetFriction(scoped, value);
         }
     }
@@ -5051,7 +5053,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         StringUtils::format(buffer, sizeof(buffer), "%s: %%.3f", tr("nanoem.gui.model.edit.rigid-body.restitution"));
         nanoem_f32_t value = nanoemModelRigidBodyGetRestitution(rigidBodyPtr);
         if (ImGui::SliderFloat("##restitution", &value, 0.0f, 1.0f, buffer)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetRestitution(scoped, value);
         }
     }
@@ -5060,7 +5062,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.rigid-body.collision.group"));
         int value = nanoemModelRigidBodyGetCollisionGroupId(rigidBodyPtr);
         if (ImGui::DragInt("##collision.group", &value, 0.05f, 0, 15)) {
-            command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+            command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
             nanoemMutableModelRigidBodySetCollisionGroupId(scoped, value);
         }
     }
@@ -5073,7 +5075,7 @@ ModelParameterDialog::layoutRigidBodyPropertyPane(nanoem_model_rigid_body_t *rig
             int offset = i + 1;
             StringUtils::format(buffer, sizeof(buffer), "%d##collision.mask.%d", offset, offset);
             if (ImGui::CheckboxFlags(buffer, &flags, 1 << i)) {
-                command::ScopedMutableRigidBody scoped(rigidBodyPtr);
+                command::ScopedMutableRigidBody scoped(m_activeModel, rigidBodyPtr);
                 nanoemMutableModelRigidBodySetCollisionMask(scoped, ~flags);
             }
             ImGui::NextColumn();
@@ -5313,7 +5315,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelJointGetName(jointPtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableJoint scoped(jointPtr);
+        command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
         nanoemMutableModelJointSetName(scoped, scope.value(), language, &status);
         if (model::Joint *joint = model::Joint::cast(jointPtr)) {
             joint->resetLanguage(jointPtr, project->unicodeStringFactory(), language);
@@ -5329,7 +5331,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.origin"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetOrigin(jointPtr)));
         if (ImGui::InputFloat3("##origin", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetOrigin(scoped, glm::value_ptr(value));
         }
     }
@@ -5337,7 +5339,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.orientation"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetOrientation(jointPtr)));
         if (ImGui::InputFloat3("##orientation", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetOrientation(scoped, glm::value_ptr(value));
         }
     }
@@ -5349,7 +5351,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
             for (int i = NANOEM_MODEL_JOINT_TYPE_FIRST_ENUM; i < NANOEM_MODEL_JOINT_TYPE_MAX_ENUM; i++) {
                 const nanoem_model_joint_type_t type = static_cast<nanoem_model_joint_type_t>(i);
                 if (ImGui::Selectable(selectedJointType(type), value == type)) {
-                    command::ScopedMutableJoint scoped(jointPtr);
+                    command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
                     nanoemMutableModelJointSetType(scoped, type);
                 }
             }
@@ -5360,7 +5362,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.linear.stiffness"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetLinearStiffness(jointPtr)));
         if (ImGui::InputFloat3("##linear.stiffness", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetLinearStiffness(scoped, glm::value_ptr(value));
         }
     }
@@ -5368,7 +5370,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.linear.upper"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetLinearUpperLimit(jointPtr)));
         if (ImGui::InputFloat3("##linear.upper", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetLinearUpperLimit(scoped, glm::value_ptr(value));
         }
     }
@@ -5376,7 +5378,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.linear.lower"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetLinearLowerLimit(jointPtr)));
         if (ImGui::InputFloat3("##linear.lower", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetLinearLowerLimit(scoped, glm::value_ptr(value));
         }
     }
@@ -5384,7 +5386,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.angular.stiffness"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetAngularStiffness(jointPtr)));
         if (ImGui::InputFloat3("##angular.stiffness", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetAngularStiffness(scoped, glm::value_ptr(value));
         }
     }
@@ -5392,7 +5394,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.angular.upper"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetAngularUpperLimit(jointPtr)));
         if (ImGui::InputFloat3("##angular.upper", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetAngularUpperLimit(scoped, glm::value_ptr(value));
         }
     }
@@ -5400,7 +5402,7 @@ ModelParameterDialog::layoutJointPropertyPane(nanoem_model_joint_t *jointPtr, Pr
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.joint.angular.lower"));
         Vector4 value(glm::make_vec4(nanoemModelJointGetAngularLowerLimit(jointPtr)));
         if (ImGui::InputFloat3("##angular.lower", glm::value_ptr(value))) {
-            command::ScopedMutableJoint scoped(jointPtr);
+            command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
             nanoemMutableModelJointSetAngularLowerLimit(scoped, glm::value_ptr(value));
         }
     }
@@ -5539,7 +5541,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
     ImGui::PushItemWidth(-1);
     if (layoutName(nanoemModelSoftBodyGetName(softBodyPtr, language), project, scope)) {
         nanoem_status_t status = NANOEM_STATUS_SUCCESS;
-        command::ScopedMutableSoftBody scoped(softBodyPtr);
+        command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
         nanoemMutableModelSoftBodySetName(scoped, scope.value(), language, &status);
         if (model::SoftBody *softBody = model::SoftBody::cast(softBodyPtr)) {
             softBody->resetLanguage(softBodyPtr, project->unicodeStringFactory(), language);
@@ -5565,7 +5567,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
                     StringUtils::format(
                         buffer, sizeof(buffer), "%s##item[%lu].name", candidateMaterial->nameConstString(), i);
                     if (ImGui::Selectable(candidateMaterial->nameConstString(), candidateMaterial == material)) {
-                        command::ScopedMutableSoftBody scoped(softBodyPtr);
+                        command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
                         nanoemMutableModelSoftBodySetMaterialObject(scoped, candidateMaterialPtr);
                     }
                 }
@@ -5579,13 +5581,13 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         nanoem_model_soft_body_shape_type_t value = nanoemModelSoftBodyGetShapeType(softBodyPtr);
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.soft-body.shape-type.tri-mesh"),
                 value == NANOEM_MODEL_SOFT_BODY_SHAPE_TYPE_TRI_MESH)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetShapeType(scoped, NANOEM_MODEL_SOFT_BODY_SHAPE_TYPE_TRI_MESH);
         }
         ImGui::SameLine();
         if (ImGui::RadioButton(tr("nanoem.gui.model.edit.soft-body.shape-type.rope"),
                 value == NANOEM_MODEL_SOFT_BODY_SHAPE_TYPE_ROPE)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetShapeType(scoped, NANOEM_MODEL_SOFT_BODY_SHAPE_TYPE_ROPE);
         }
     }
@@ -5598,7 +5600,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
                 const nanoem_model_soft_body_aero_model_type_t type =
                     static_cast<nanoem_model_soft_body_aero_model_type_t>(i);
                 if (ImGui::Selectable(selectedSoftBodyAeroModelType(type), value == type)) {
-                    command::ScopedMutableSoftBody scoped(softBodyPtr);
+                    command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
                     nanoemMutableModelSoftBodySetAeroModel(scoped, type);
                 }
             }
@@ -5610,7 +5612,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.collision-group-id"));
         int value = nanoemModelSoftBodyGetCollisionGroupId(softBodyPtr);
         if (ImGui::DragInt("##collision.group", &value, 0.05f, 0, 15)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetCollisionGroupId(scoped, value);
         }
     }
@@ -5623,7 +5625,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
             int offset = i + 1;
             StringUtils::format(buffer, sizeof(buffer), "%d##collision.mask.%d", offset, offset);
             if (ImGui::CheckboxFlags(buffer, &flags, 1 << i)) {
-                command::ScopedMutableSoftBody scoped(softBodyPtr);
+                command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
                 nanoemMutableModelSoftBodySetCollisionMask(scoped, ~flags);
             }
             ImGui::NextColumn();
@@ -5635,7 +5637,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.total-mass"));
         nanoem_f32_t value = nanoemModelSoftBodyGetTotalMass(softBodyPtr);
         if (ImGui::InputFloat("##total-mass", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetTotalMass(scoped, value);
         }
     }
@@ -5643,7 +5645,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.collision-margin"));
         nanoem_f32_t value = nanoemModelSoftBodyGetCollisionMargin(softBodyPtr);
         if (ImGui::InputFloat("##collision-margin", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetCollisionMargin(scoped, value);
         }
     }
@@ -5652,7 +5654,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.velocity-correction-factor"));
         nanoem_f32_t value = nanoemModelSoftBodyGetVelocityCorrectionFactor(softBodyPtr);
         if (ImGui::InputFloat("##velocity-correction-factor", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetVelocityCorrectionFactor(scoped, value);
         }
     }
@@ -5660,7 +5662,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.damping-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetDampingCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##damping-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetDampingCoefficient(scoped, value);
         }
     }
@@ -5668,7 +5670,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.drag-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetDragCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##drag-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetDragCoefficient(scoped, value);
         }
     }
@@ -5676,7 +5678,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.lift-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetLiftCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##lift-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetLiftCoefficient(scoped, value);
         }
     }
@@ -5684,7 +5686,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.pressure-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetPressureCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##pressure-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetPressureCoefficient(scoped, value);
         }
     }
@@ -5692,7 +5694,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.volume-conversation-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetVolumeConversationCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##volume-conversation-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetVolumeConversationCoefficient(scoped, value);
         }
     }
@@ -5700,7 +5702,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.dynamic-friction-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetDynamicFrictionCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##dynamic-friction-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetDynamicFrictionCoefficient(scoped, value);
         }
     }
@@ -5708,7 +5710,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.pose-matching-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetPoseMatchingCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##pose-matching-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetPoseMatchingCoefficient(scoped, value);
         }
     }
@@ -5716,7 +5718,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.rigid-contact-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetRigidContactHardness(softBodyPtr);
         if (ImGui::InputFloat("##rigid-contact-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetRigidContactHardness(scoped, value);
         }
     }
@@ -5724,7 +5726,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.kinetic-contact-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetKineticContactHardness(softBodyPtr);
         if (ImGui::InputFloat("##kinetic-contact-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetKineticContactHardness(scoped, value);
         }
     }
@@ -5732,7 +5734,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-contact-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftContactHardness(softBodyPtr);
         if (ImGui::InputFloat("##soft-contact-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftContactHardness(scoped, value);
         }
     }
@@ -5740,7 +5742,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.anchor-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetAnchorHardness(softBodyPtr);
         if (ImGui::InputFloat("##anchor-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetAnchorHardness(scoped, value);
         }
     }
@@ -5748,7 +5750,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-vs-kinetic-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftVSKineticHardness(softBodyPtr);
         if (ImGui::InputFloat("##soft-vs-kinetic-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftVSKineticHardness(scoped, value);
         }
     }
@@ -5756,7 +5758,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-vs-rigid-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftVSRigidHardness(softBodyPtr);
         if (ImGui::InputFloat("##soft-vs-rigid-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftVSRigidHardness(scoped, value);
         }
     }
@@ -5764,7 +5766,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-vs-soft-hardness"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftVSSoftHardness(softBodyPtr);
         if (ImGui::InputFloat("##soft-vs-soft-hardness", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftVSSoftHardness(scoped, value);
         }
     }
@@ -5772,7 +5774,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-vs-kinetic-impulse-split"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftVSKineticImpulseSplit(softBodyPtr);
         if (ImGui::InputFloat("##soft-vs-kinetic-impulse-split", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftVSKineticImpulseSplit(scoped, value);
         }
     }
@@ -5780,7 +5782,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-vs-rigid-impulse-split"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftVSRigidImpulseSplit(softBodyPtr);
         if (ImGui::InputFloat("##soft-vs-rigid-impulse-split", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftVSRigidImpulseSplit(scoped, value);
         }
     }
@@ -5788,7 +5790,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.soft-vs-soft-impulse-split"));
         nanoem_f32_t value = nanoemModelSoftBodyGetSoftVSSoftImpulseSplit(softBodyPtr);
         if (ImGui::InputFloat("##soft-vs-kinetic-soft-split", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetSoftVSSoftImpulseSplit(scoped, value);
         }
     }
@@ -5796,7 +5798,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.linear-stiffness-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetLinearStiffnessCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##linear-stiffness-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetLinearStiffnessCoefficient(scoped, value);
         }
     }
@@ -5804,7 +5806,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.angular-stiffness-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetAngularStiffnessCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##angular-stiffness-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetAngularStiffnessCoefficient(scoped, value);
         }
     }
@@ -5812,7 +5814,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.volume-stiffness-coefficient"));
         nanoem_f32_t value = nanoemModelSoftBodyGetVolumeStiffnessCoefficient(softBodyPtr);
         if (ImGui::InputFloat("##volume-stiffness-coefficient", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetVolumeStiffnessCoefficient(scoped, value);
         }
     }
@@ -5820,7 +5822,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.bending-constraints-distance"));
         int value = nanoemModelSoftBodyGetBendingConstraintsDistance(softBodyPtr);
         if (ImGui::InputInt("##bending-constraints-distance", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetBendingConstraintsDistance(scoped, value);
         }
     }
@@ -5828,7 +5830,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.cluster-count"));
         int value = nanoemModelSoftBodyGetClusterCount(softBodyPtr);
         if (ImGui::InputInt("##cluster-count", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetClusterCount(scoped, value);
         }
     }
@@ -5836,7 +5838,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.velocity-solver-iterations"));
         int value = nanoemModelSoftBodyGetVelocitySolverIterations(softBodyPtr);
         if (ImGui::InputInt("##velocity-solver-iterations", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetVelocitySolverIterations(scoped, value);
         }
     }
@@ -5844,7 +5846,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.position-solver-iterations"));
         int value = nanoemModelSoftBodyGetVelocitySolverIterations(softBodyPtr);
         if (ImGui::InputInt("##position-solver-iterations", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetPositionsSolverIterations(scoped, value);
         }
     }
@@ -5852,7 +5854,7 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.drift-solver-iterations"));
         int value = nanoemModelSoftBodyGetDriftSolverIterations(softBodyPtr);
         if (ImGui::InputInt("##drift-solver-iterations", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetDriftSolverIterations(scoped, value);
         }
     }
@@ -5860,28 +5862,28 @@ ModelParameterDialog::layoutSoftBodyPropertyPane(nanoem_model_soft_body_t *softB
         ImGui::TextUnformatted(tr("nanoem.gui.model.edit.soft-body.cluster-solver-iterations"));
         int value = nanoemModelSoftBodyGetClusterSolverIterations(softBodyPtr);
         if (ImGui::InputInt("##cluster-solver-iterations", &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetClusterSolverIterations(scoped, value);
         }
     }
     {
         bool value = nanoemModelSoftBodyIsBendingConstraintsEnabled(softBodyPtr) != 0;
         if (ImGui::Checkbox(tr("nanoem.gui.model.edit.soft-body.bending-constraints-enabled"), &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetBendingConstraintsEnabled(scoped, value);
         }
     }
     {
         bool value = nanoemModelSoftBodyIsClustersEnabled(softBodyPtr) != 0;
         if (ImGui::Checkbox(tr("nanoem.gui.model.edit.soft-body.clusters-enabled"), &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetClustersEnabled(scoped, value);
         }
     }
     {
         bool value = nanoemModelSoftBodyIsRandomizeConstraintsNeeded(softBodyPtr) != 0;
         if (ImGui::Checkbox(tr("nanoem.gui.model.edit.soft-body.randomize-constraints-enabled"), &value)) {
-            command::ScopedMutableSoftBody scoped(softBodyPtr);
+            command::ScopedMutableSoftBody scoped(m_activeModel, softBodyPtr);
             nanoemMutableModelSoftBodySetRandomizeConstraintsNeeded(scoped, value);
         }
     }
@@ -5945,14 +5947,14 @@ ModelParameterDialog::layoutBoneComboBox(const char *id, const nanoem_model_bone
         nanoem_rsize_t numBones;
         nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(m_activeModel->data(), &numBones);
         if (ImGui::Selectable("(none)", !hasBone)) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             setBoneCallback(scoped, nullptr);
         }
         for (nanoem_rsize_t i = 0; i < numBones; i++) {
             const nanoem_model_bone_t *candidateBonePtr = bones[i];
             const model::Bone *candidateBone = model::Bone::cast(candidateBonePtr);
             if (candidateBone && ImGui::Selectable(candidateBone->nameConstString(), candidateBone == baseBone)) {
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 setBoneCallback(scoped, candidateBonePtr);
             }
         }
@@ -5983,7 +5985,7 @@ ModelParameterDialog::layoutRigidBodyComboBox(const char *id, const nanoem_model
             if (const model::RigidBody *candidateBody = model::RigidBody::cast(candidateBodyPtr)) {
                 StringUtils::format(buffer, sizeof(buffer), "%s##item[%lu].name", candidateBody->nameConstString(), i);
                 if (ImGui::Selectable(buffer, candidateBody == rigidBody)) {
-                    command::ScopedMutableJoint scoped(jointPtr);
+                    command::ScopedMutableJoint scoped(m_activeModel, jointPtr);
                     setRigidBodyCallback(scoped, candidateBodyPtr);
                 }
             }
@@ -6002,7 +6004,7 @@ ModelParameterDialog::layoutBoneAxisMenuItems(
         const Vector4 direction(glm::normalize(glm::make_vec3(nanoemModelBoneGetOrigin(parentBonePtr)) -
                                     glm::make_vec3(nanoemModelBoneGetOrigin(bonePtr))),
             0);
-        command::ScopedMutableBone scoped(bonePtr);
+        command::ScopedMutableBone scoped(m_activeModel, bonePtr);
         setBoneAxisCallback(scoped, glm::value_ptr(direction));
     }
     const nanoem_model_bone_t *targetBonePtr = nanoemModelBoneGetTargetBoneObject(bonePtr);
@@ -6010,7 +6012,7 @@ ModelParameterDialog::layoutBoneAxisMenuItems(
         const Vector4 direction(glm::normalize(glm::make_vec3(nanoemModelBoneGetOrigin(targetBonePtr)) -
                                     glm::make_vec3(nanoemModelBoneGetOrigin(bonePtr))),
             0);
-        command::ScopedMutableBone scoped(bonePtr);
+        command::ScopedMutableBone scoped(m_activeModel, bonePtr);
         setBoneAxisCallback(scoped, glm::value_ptr(direction));
     }
     if (ImGui::BeginMenu(tr("nanoem.gui.model.edit.action.bone.axis.select"))) {
@@ -6024,7 +6026,7 @@ ModelParameterDialog::layoutBoneAxisMenuItems(
                 const Vector4 direction(glm::normalize(glm::make_vec3(nanoemModelBoneGetOrigin(candidateBonePtr)) -
                                             glm::make_vec3(nanoemModelBoneGetOrigin(bonePtr))),
                     0);
-                command::ScopedMutableBone scoped(bonePtr);
+                command::ScopedMutableBone scoped(m_activeModel, bonePtr);
                 setBoneAxisCallback(scoped, glm::value_ptr(glm::vec4(0)));
             }
         }
@@ -6033,15 +6035,15 @@ ModelParameterDialog::layoutBoneAxisMenuItems(
     ImGui::Separator();
     if (ImGui::BeginMenu(tr("nanoem.gui.model.edit.action.bone.axis.global"))) {
         if (ImGui::MenuItem("X")) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             setBoneAxisCallback(scoped, glm::value_ptr(Vector4(Constants::kUnitX, 0)));
         }
         if (ImGui::MenuItem("Y")) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             setBoneAxisCallback(scoped, glm::value_ptr(Vector4(Constants::kUnitY, 0)));
         }
         if (ImGui::MenuItem("Z")) {
-            command::ScopedMutableBone scoped(bonePtr);
+            command::ScopedMutableBone scoped(m_activeModel, bonePtr);
             setBoneAxisCallback(scoped, glm::value_ptr(Vector4(Constants::kUnitZ, 0)));
         }
         ImGui::EndMenu();
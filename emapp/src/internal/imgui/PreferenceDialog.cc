@@ -8,6 +8,7 @@
 
 #include "emapp/Error.h"
 #include "emapp/Grid.h"
+#include "emapp/PhysicsEngine.h"
 #include "emapp/private/CommonInclude.h"
 
 #include "undo/undo.h"
@@ -226,6 +227,7 @@ PreferenceDialog::draw(Project *project)
             ImGui::TextUnformatted("Application Preference");
             if (ImGui::Button("Initialize##preferences.reset", ImVec2(-1, 0))) {
                 preference.setUndoSoftLimit(ApplicationPreference::kUndoSoftLimitDefaultValue);
+                preference.setUndoMemoryBudget(ApplicationPreference::kUndoMemoryBudgetDefaultValue);
                 preference.setGFXBufferPoolSize(ApplicationPreference::kGFXBufferPoolSizeDefaultValue);
                 preference.setGFXImagePoolSize(ApplicationPreference::kGFXImagePoolSizeDefaultValue);
                 preference.setGFXShaderPoolSize(ApplicationPreference::kGFXShaderPoolSizeDefaultValue);
@@ -242,6 +244,23 @@ PreferenceDialog::draw(Project *project)
                 }
             }
             addSeparator();
+            {
+                int value = preference.undoMemoryBudget();
+                ImGui::TextUnformatted("Undo Memory Budget (MB)");
+                if (ImGui::DragInt("##preference.undo.memory", &value, 1.0f, 16, 0x4000)) {
+                    preference.setUndoMemoryBudget(value);
+                    project->setUndoSnapshotMemoryBudget(nanoem_u64_t(value) * 1024 * 1024);
+                }
+            }
+            addSeparator();
+            {
+                bool value = preference.isPhysicsIslandEnabled();
+                if (ImGui::Checkbox("Step Physics Simulation per Model##preference.physics.island", &value)) {
+                    preference.setPhysicsIslandEnabled(value);
+                    project->physicsEngine()->setIslandEnabled(value);
+                }
+            }
+            addSeparator();
             {
                 int value = preference.gfxBufferPoolSize();
                 ImGui::TextUnformatted("Buffer Pool Size");
@@ -231,6 +231,10 @@ void UberMotionKeyframeSelection::addSelfShadowKeyframes(nanoem_frame_index_t, n
 {
 }
 
+void UberMotionKeyframeSelection::shiftAllKeyframes(nanoem_u32_t, nanoem_frame_index_t, int)
+{
+}
+
 } /* namespace imgui */
 } /* namespace internal */
 } /* namespace nanoem */
@@ -329,17 +329,17 @@ Archive::loadModel(const String &entryPath, Error &error)
 bool
 Archive::loadAllMotions(const Archiver::EntryList &motionList, Error &error)
 {
-    bool continuable = true;
-    for (Archiver::EntryList::const_iterator it = motionList.begin(), end = motionList.end(); it != end && continuable;
-         ++it) {
-        const Archiver::Entry &entry = *it;
-        continuable &= loadMotion(entry, error);
+    ByteArrayList bytesList;
+    /* motions are inflated concurrently but loaded in order as they replace the project motions */
+    bool continuable = m_archiver->extractAll(motionList, bytesList, error);
+    for (nanoem_rsize_t i = 0, numMotions = motionList.size(); i < numMotions && continuable; i++) {
+        continuable &= loadMotion(motionList[i], bytesList[i], error);
     }
     return continuable;
 }
 
 bool
-Archive::loadMotion(const Archiver::Entry &entry, Error &error)
+Archive::loadMotion(const Archiver::Entry &entry, const ByteArray &bytes, Error &error)
 {
     Motion *motion = m_project->createMotion(), *lastMotion = nullptr;
     bool continuable = true;
@@ -347,15 +347,12 @@ Archive::loadMotion(const Archiver::Entry &entry, Error &error)
         const char *filename = entry.filenamePtr();
         const String name(filename, size_t(extension - filename - 1));
         motion->setFormat(extension);
-        Archiver::Entry motionEntry;
-        ByteArray bytes;
         if (!m_progress->tryLoadingItem(filename)) {
             error = Error::cancelled();
             continuable = false;
         }
         else {
-            continuable &= m_archiver->findEntry(entry.m_path, motionEntry, error) &&
-                m_archiver->extract(motionEntry, bytes, error) && !bytes.empty() && motion->load(bytes, 0, error);
+            continuable &= !bytes.empty() && motion->load(bytes, 0, error);
             if (continuable) {
                 motion->setFileURI(URI::createFromFilePath(m_fileURI.absolutePath(), entry.m_path));
                 if (name == String("Camera")) {
@@ -22,6 +22,9 @@
 #include "emapp/ShadowCamera.h"
 #include "emapp/StringUtils.h"
 #include "emapp/UUID.h"
+#include "emapp/internal/ContentDigest.h"
+#include "emapp/internal/FileContentDigestCache.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
 #include "emapp/internal/project/Archive.h"
 #include "emapp/private/CommonInclude.h"
 
@@ -237,7 +240,10 @@ struct Native::Context {
     void load(const Nanoem__Project__Project *p, FileType fileType, Error &error, Project::IDiagnostics *diagnostics);
 
     String canonicalizeFilePath(const URI &fileURI);
-    static void calculateFileContentDigest(IReader *reader, ProtobufCBinaryData &checksum);
+    bool calculateFileContentDigest(const URI &fileURI, ProtobufCBinaryData &checksum, Error &error);
+    void addFileContentDigest(
+        const Nanoem__Project__URI *uri, StringSet &paths, FileContentDigestCache::URIList &fileURIs);
+    void prefetchAllFileContentDigests(const Nanoem__Project__Project *p, FileType fileType);
     bool testFileContentDigest(const URI &fileURI, const ProtobufCBinaryData &checksum, Error &error) const;
     Nanoem__Project__Audio *saveAudio(FileType fileType, Error &error);
     Nanoem__Project__Camera *saveCamera();
@@ -1306,8 +1312,11 @@ Native::Context::load(
     Project::ModelList transformOrderList(p->n_models);
     HandleMap handles;
     Model *activeModelPtr = nullptr;
+    prefetchAllFileContentDigests(p, fileType);
     loadAllAccessories(p, drawableOrderList, handles, fileType, error, diagnostics);
     loadAllModels(p, activeModelPtr, drawableOrderList, transformOrderList, handles, fileType, error, diagnostics);
+    /* the prefetched files have been loaded from their mapped bytes so they are no longer needed */
+    m_project->fileContentDigestCache()->releaseAllMappedFiles();
     bool needsRestart = false;
     loadAllMotions(p, handles, needsRestart, error);
     if (needsRestart) {
@@ -1356,39 +1365,95 @@ Native::Context::canonicalizeFilePath(const URI &fileURI)
     return path;
 }
 
+bool
+Native::Context::calculateFileContentDigest(const URI &fileURI, ProtobufCBinaryData &checksum, Error &error)
+{
+    /* SHA-256 is calculated again only when the contents differ from the ones recorded on loading */
+    nanoem_u8_t value[SHA256_BLOCK_SIZE];
+    bool succeeded = m_project->fileContentDigestCache()->calculate(fileURI, value, error);
+    if (succeeded) {
+        checksum.len = sizeof(value);
+        checksum.data = new nanoem_u8_t[checksum.len];
+        memcpy(checksum.data, value, checksum.len);
+    }
+    return succeeded;
+}
+
 void
-Native::Context::calculateFileContentDigest(IReader *reader, ProtobufCBinaryData &checksum)
+Native::Context::addFileContentDigest(
+    const Nanoem__Project__URI *uri, StringSet &paths, FileContentDigestCache::URIList &fileURIs)
 {
-    SHA256_CTX ctx;
-    Error error;
-    nanoem_u8_t buffer[Inline::kReadingFileContentsBufferSize];
-    nanoem_i32_t actualReadSize;
-    sha256_init(&ctx);
-    while ((actualReadSize = FileUtils::read(reader, buffer, sizeof(buffer), error)) > 0) {
-        sha256_update(&ctx, buffer, actualReadSize);
+    bool isAbsolutePath = true;
+    const URI fileURI(toURI(uri, m_project->fileURI(), isAbsolutePath));
+    if (!fileURI.isEmpty() && !fileURI.hasFragment()) {
+        const String path(fileURI.absolutePath());
+        if (paths.find(path) == paths.end() && FileUtils::exists(fileURI)) {
+            paths.insert(path);
+            fileURIs.push_back(fileURI);
+        }
+    }
+}
+
+void
+Native::Context::prefetchAllFileContentDigests(const Nanoem__Project__Project *p, FileType fileType)
+{
+    StringSet paths;
+    FileContentDigestCache::URIList fileURIs;
+    for (nanoem_rsize_t i = 0, numAccessories = p->n_accessories; i < numAccessories; i++) {
+        const Nanoem__Project__Accessory *a = p->accessories[i];
+        bool loadable = false;
+        if (fileType == kFileTypeArchive) {
+            loadable = a->name && !m_project->findAccessoryByName(a->name);
+        }
+        else if (fileType == kFileTypeData) {
+            loadable = a->has_accessory_handle && !m_project->findAccessoryByHandle(a->accessory_handle);
+        }
+        if (loadable) {
+            addFileContentDigest(a->file_uri, paths, fileURIs);
+        }
+    }
+    for (nanoem_rsize_t i = 0, numModels = p->n_models; i < numModels; i++) {
+        const Nanoem__Project__Model *m = p->models[i];
+        bool loadable = false, attachable = false;
+        if (fileType == kFileTypeArchive) {
+            attachable = m->name != nullptr;
+            loadable = attachable && !m_project->findModelByName(m->name);
+        }
+        else if (fileType == kFileTypeData) {
+            attachable = m->has_model_handle != 0;
+            loadable = attachable && !m_project->findModelByHandle(m->model_handle);
+        }
+        if (loadable) {
+            addFileContentDigest(m->file_uri, paths, fileURIs);
+        }
+        if (attachable) {
+            for (nanoem_rsize_t j = 0, numAttachments = m->n_material_effect_attachments; j < numAttachments; j++) {
+                addFileContentDigest(m->material_effect_attachments[j]->file_uri, paths, fileURIs);
+            }
+        }
     }
-    checksum.len = SHA256_BLOCK_SIZE;
-    checksum.data = new nanoem_u8_t[checksum.len];
-    sha256_final(&ctx, checksum.data);
+    /*
+     * only mapping and hashing run concurrently. parsing models, accessories and motions still runs serially on
+     * the calling thread as these are created with the project unicode factory that is kept by the parsed objects
+     * and motions are embedded in the project so there is nothing to prefetch for them
+     */
+    m_project->fileContentDigestCache()->prefetch(fileURIs);
 }
 
 bool
 Native::Context::testFileContentDigest(const URI &fileURI, const ProtobufCBinaryData &checksum, Error &error) const
 {
-    FileReaderScope scope(nullptr);
-    bool fileChecksumPassed = false;
-    if (scope.open(fileURI, error)) {
-        ProtobufCBinaryData binary;
-        calculateFileContentDigest(scope.reader(), binary);
-        fileChecksumPassed = checksum.len == binary.len && memcmp(checksum.data, binary.data, binary.len) == 0;
-        if (!fileChecksumPassed) {
-            char reason[Error::kMaxRecoverySuggestionLength];
-            StringUtils::format(reason, sizeof(reason),
-                m_project->translator()->translate("nanoem.window.dialog.error.file-content-digest.reason"),
-                fileURI.absolutePathConstString());
-            error = Error(reason, "", Error::kDomainTypeApplication);
-        }
-        delete[] binary.data;
+    nanoem_u8_t value[SHA256_BLOCK_SIZE];
+    bool fileChecksumPassed = false, opened = m_project->fileContentDigestCache()->calculate(fileURI, value, error);
+    if (opened) {
+        fileChecksumPassed = checksum.len == sizeof(value) && memcmp(checksum.data, value, sizeof(value)) == 0;
+    }
+    if (opened && !fileChecksumPassed) {
+        char reason[Error::kMaxRecoverySuggestionLength];
+        StringUtils::format(reason, sizeof(reason),
+            m_project->translator()->translate("nanoem.window.dialog.error.file-content-digest.reason"),
+            fileURI.absolutePathConstString());
+        error = Error(reason, "", Error::kDomainTypeApplication);
     }
     return fileChecksumPassed;
 }
@@ -1402,11 +1467,9 @@ Native::Context::saveAudio(FileType fileType, Error &error)
     const URI fileURI(audioPtr->fileURI());
     audio->file_uri = newURI(m_project, fileURI, Archive::kBGMEntryPath, fileType);
     audio->volume = audioPtr->volumeGain();
-    FileReaderScope scope(m_project->translator());
     if (fileType == kFileTypeData && m_includeAudioVideoFileContentDigest && !fileURI.isEmpty() &&
-        scope.open(fileURI, error)) {
+        calculateFileContentDigest(fileURI, audio->file_checksum, error)) {
         audio->has_file_checksum = 1;
-        calculateFileContentDigest(scope.reader(), audio->file_checksum);
     }
     return audio;
 }
@@ -1578,11 +1641,9 @@ Native::Context::saveVideo(FileType fileType, Error &error)
         video->file_uri = nanoem_new(Nanoem__Project__URI);
         nanoem__project__uri__init(video->file_uri);
     }
-    FileReaderScope scope(m_project->translator());
     if (fileType == kFileTypeData && m_includeAudioVideoFileContentDigest && !fileURI.isEmpty() &&
-        scope.open(fileURI, error)) {
+        calculateFileContentDigest(fileURI, video->file_checksum, error)) {
         video->has_file_checksum = 1;
-        calculateFileContentDigest(scope.reader(), video->file_checksum);
     }
     video->scale_factor = m_project->backgroundVideoScaleFactor();
     return video;
@@ -1615,10 +1676,9 @@ Native::Context::saveAccessory(Accessory *accessory, FileType fileType, Error &e
     ao->accessory_handle = accessory->handle();
     const URI fileURI(accessory->fileURI());
     ao->file_uri = newURI(m_project, fileURI, ao->path_for_legacy_compatibility, fileType);
-    FileReaderScope scope(m_project->translator());
-    if (fileType == kFileTypeData && !fileURI.isEmpty() && scope.open(fileURI, error)) {
+    if (fileType == kFileTypeData && !fileURI.isEmpty() &&
+        calculateFileContentDigest(fileURI, ao->file_checksum, error)) {
         ao->has_file_checksum = 1;
-        calculateFileContentDigest(scope.reader(), ao->file_checksum);
     }
     if (const Effect *effect = m_project->resolveEffect(accessory)) {
         const StringList includePaths(effect->allIncludePaths());
@@ -1668,7 +1728,6 @@ void
 Native::Context::saveAllModelMaterialAttachments(
     Nanoem__Project__Model *mo, Model *model, FileType fileType, Error &error)
 {
-    FileReaderScope scope(m_project->translator());
     nanoem_rsize_t numMaterials;
     nanoem_model_material_t *const *materials = nanoemModelGetAllMaterialObjects(model->data(), &numMaterials);
     if (numMaterials > 0) {
@@ -1688,9 +1747,9 @@ Native::Context::saveAllModelMaterialAttachments(
                     copyString(attachment->path_for_legacy_compatibility, "");
                     attachment->file_uri =
                         newURI(m_project, fileURI, attachment->path_for_legacy_compatibility, fileType);
-                    if (fileType == kFileTypeData && !fileURI.isEmpty() && scope.open(fileURI, error)) {
+                    if (fileType == kFileTypeData && !fileURI.isEmpty() &&
+                        calculateFileContentDigest(fileURI, attachment->file_checksum, error)) {
                         attachment->has_file_checksum = 1;
-                        calculateFileContentDigest(scope.reader(), attachment->file_checksum);
                     }
                 }
             }
@@ -1735,10 +1794,9 @@ Native::Context::saveModel(Model *model, FileType fileType, Error &error)
     mo->model_handle = model->handle();
     const URI fileURI(model->fileURI());
     mo->file_uri = newURI(m_project, fileURI, mo->path_for_legacy_compatibility, fileType);
-    FileReaderScope scope(m_project->translator());
-    if (fileType == kFileTypeData && !fileURI.isEmpty() && scope.open(fileURI, error)) {
+    if (fileType == kFileTypeData && !fileURI.isEmpty() &&
+        calculateFileContentDigest(fileURI, mo->file_checksum, error)) {
         mo->has_file_checksum = 1;
-        calculateFileContentDigest(scope.reader(), mo->file_checksum);
     }
     saveAllModelMaterialAttachments(mo, model, fileType, error);
     saveAllIncludeEffectSources(mo, model);
@@ -1913,10 +1971,9 @@ Native::Context::saveOffscreenRenderTargetEffect(
                 copyString(attachment->path, filename);
                 const URI fileURI(effect->fileURI());
                 attachment->file_uri = newURI(m_project, fileURI, filename, fileType);
-                FileReaderScope scope(m_project->translator());
-                if (fileType == kFileTypeData && !fileURI.isEmpty() && scope.open(fileURI, error)) {
+                if (fileType == kFileTypeData && !fileURI.isEmpty() &&
+                    calculateFileContentDigest(fileURI, attachment->file_checksum, error)) {
                     attachment->has_file_checksum = 1;
-                    calculateFileContentDigest(scope.reader(), attachment->file_checksum);
                 }
                 const StringList includePaths(effect->allIncludePaths());
                 if (!includePaths.empty()) {
@@ -2056,6 +2113,20 @@ Native::Context::findDrawable(nanoem_u32_t value)
     return it != m_drawables.end() ? it->second : nullptr;
 }
 
+bool
+Native::pack(const Nanoem__Project__Project *message, ByteArray &bytes)
+{
+    const size_t packedSize = nanoem__project__project__get_packed_size(message);
+    bytes.resize(packedSize);
+    return nanoem__project__project__pack(message, bytes.data()) == packedSize;
+}
+
+void
+Native::release(Nanoem__Project__Project *message) NANOEM_DECL_NOEXCEPT
+{
+    Context::release(message);
+}
+
 Native::Native(Project *project)
     : m_context(nanoem_new(Context(project)))
 {
@@ -2088,16 +2159,10 @@ bool
 Native::save(ByteArray &bytes, FileType fileType, Error &error)
 {
     bool succeeded = false;
-    Nanoem__Project__Project *p = Context::allocate();
-    if (m_context->save(p, fileType, error) && protobuf_c_message_check(&p->base)) {
-        const size_t packedSize = nanoem__project__project__get_packed_size(p);
-        bytes.resize(packedSize);
-        succeeded = nanoem__project__project__pack(p, bytes.data()) == packedSize;
-        Nanoem__Project__Project *v = nanoem__project__project__unpack(g_protobufc_allocator, packedSize, bytes.data());
-        succeeded = v != nullptr;
-        nanoem__project__project__free_unpacked(v, g_protobufc_allocator);
-    }
-    Context::release(p);
+    if (Nanoem__Project__Project *p = capture(fileType, error)) {
+        succeeded = pack(p, bytes);
+        release(p);
+    }
     if (!succeeded && !error.hasReason()) {
         const ITranslator *translator = m_context->m_project->translator();
         error = Error(translator->translate("nanoem.error.project.save.reason"),
@@ -2106,6 +2171,17 @@ Native::save(ByteArray &bytes, FileType fileType, Error &error)
     return succeeded;
 }
 
+Nanoem__Project__Project *
+Native::capture(FileType fileType, Error &error)
+{
+    Nanoem__Project__Project *p = Context::allocate();
+    if (!m_context->save(p, fileType, error) || !protobuf_c_message_check(&p->base)) {
+        Context::release(p);
+        p = nullptr;
+    }
+    return p;
+}
+
 const Project::IncludeEffectSourceMap *
 Native::findIncludeEffectSource(const IDrawable *drawable) const
 {
@@ -551,12 +551,10 @@ PMM::Context::handleLoadingModel(void *user_data, const nanoem_unicode_string_t
 {
     Context *self = static_cast<Context *>(user_data);
     nanoem_model_t *model = nullptr;
-    FileReaderScope scope(self->m_project->translator());
+    MappedFileReader reader(self->m_project->translator());
     Error error;
-    if (scope.open(self->resolveFileURI(path), error)) {
-        ByteArray bytes;
-        FileUtils::read(scope, bytes, error);
-        nanoem_buffer_t *buffer = nanoemBufferCreate(bytes.data(), bytes.size(), status);
+    if (reader.open(self->resolveFileURI(path), error)) {
+        nanoem_buffer_t *buffer = nanoemBufferCreate(reader.bytes(), reader.size(), status);
         model = nanoemModelCreate(factory, status);
         nanoemModelLoadFromBuffer(model, buffer, status);
         nanoemBufferDestroy(buffer);
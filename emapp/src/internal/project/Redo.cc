@@ -15,7 +15,9 @@
 #include "emapp/IFileManager.h"
 #include "emapp/IModalDialog.h"
 #include "emapp/Project.h"
+#include "emapp/StringUtils.h"
 #include "emapp/ThreadedApplicationService.h"
+#include "emapp/internal/project/Native.h"
 #include "emapp/private/CommonInclude.h"
 
 #include "bx/readerwriter.h"
@@ -30,7 +32,91 @@ namespace nanoem {
 namespace internal {
 namespace project {
 
+namespace {
+
+static const nanoem_rsize_t kRecordHeaderSize =
+    sizeof(nanoem_u32_t) /* sequence */ + sizeof(nanoem_u16_t) /* type */ + sizeof(nanoem_u32_t) /* size */;
+static const nanoem_rsize_t kIndexRecordSize = kRecordHeaderSize + sizeof(nanoem_i64_t) /* restart offset */ +
+    sizeof(nanoem_u32_t) /* last sequence */ + sizeof(nanoem_u32_t) /* record size */ +
+    sizeof(nanoem_u32_t) /* magic */;
+
+static void
+writeRecordHeader(IWriter *writer, nanoem_u32_t sequence, nanoem_u16_t type, nanoem_u32_t size, Error &error)
+{
+    FileUtils::writeTyped(writer, sequence, error);
+    FileUtils::writeTyped(writer, type, error);
+    FileUtils::writeTyped(writer, size, error);
+}
+
+static int
+deflateChunk(const nanoem_u8_t *data, nanoem_rsize_t size, ByteArray &output)
+{
+    output.resize(LZ4_compressBound(Inline::saturateInt32(size)));
+    return LZ4_compress_fast(reinterpret_cast<const char *>(data), reinterpret_cast<char *>(output.data()),
+        Inline::saturateInt32(size), Inline::saturateInt32(output.size()), 1);
+}
+
+} /* namespace anonymous */
+
+struct Redo::RecordHeader {
+    nanoem_u32_t m_sequence;
+    nanoem_u32_t m_size;
+    nanoem_u16_t m_type;
+};
+
+struct Redo::Index {
+    nanoem_i64_t m_restartOffset;
+    nanoem_u32_t m_lastSequence;
+};
+
 const nanoem_u32_t Redo::kFileMagic = nanoem_fourcc('n', 'm', 'C', 'S');
+const nanoem_u32_t Redo::kIndexMagic = nanoem_fourcc('n', 'm', 'C', 'I');
+const nanoem_u16_t Redo::kRecordTypeCheckpoint = 0xfffe;
+const nanoem_u16_t Redo::kRecordTypeIndex = 0xffff;
+
+void
+Redo::writeCommandRecord(
+    IWriter *writer, nanoem_u32_t sequence, nanoem_u16_t type, const ByteArray &command, Error &error)
+{
+    ByteArray compressed;
+    int compressedSize = deflateChunk(command.data(), command.size(), compressed);
+    if (compressedSize > 0) {
+        writeRecordHeader(writer, sequence, type, compressedSize, error);
+        FileUtils::write(writer, compressed.data(), compressedSize, error);
+    }
+    else {
+        writeRecordHeader(writer, sequence, 0, 0, error);
+    }
+}
+
+void
+Redo::writeCheckpointRecord(
+    IWriter *writer, nanoem_u32_t sequence, const ByteArray &snapshot, nanoem_rsize_t snapshotSize, Error &error)
+{
+    ByteArray compressed;
+    int compressedSize = deflateChunk(snapshot.data(), snapshot.size(), compressed);
+    if (compressedSize > 0) {
+        const nanoem_u32_t inflatedSize = Inline::saturateInt32U(snapshot.size()),
+                           projectSize = Inline::saturateInt32U(snapshotSize);
+        writeRecordHeader(writer, sequence, kRecordTypeCheckpoint,
+            nanoem_u32_t(sizeof(inflatedSize) + sizeof(projectSize) + compressedSize), error);
+        FileUtils::writeTyped(writer, inflatedSize, error);
+        FileUtils::writeTyped(writer, projectSize, error);
+        FileUtils::write(writer, compressed.data(), compressedSize, error);
+    }
+}
+
+void
+Redo::writeIndexRecord(IWriter *writer, nanoem_u32_t sequence, nanoem_i64_t restartOffset, Error &error)
+{
+    /* the record size and the magic come last to find the index record by seeking from the end of the file */
+    const nanoem_u32_t recordSize = nanoem_u32_t(kIndexRecordSize);
+    writeRecordHeader(writer, sequence, kRecordTypeIndex, nanoem_u32_t(kIndexRecordSize - kRecordHeaderSize), error);
+    FileUtils::writeTyped(writer, restartOffset, error);
+    FileUtils::writeTyped(writer, sequence, error);
+    FileUtils::writeTyped(writer, recordSize, error);
+    FileUtils::writeTyped(writer, kIndexMagic, error);
+}
 
 Redo::Redo(Project *project)
     : m_project(project)
@@ -41,39 +127,71 @@ Redo::~Redo() NANOEM_DECL_NOEXCEPT
 {
 }
 
+nanoem_i64_t
+Redo::restoreCheckpoint(ISeekableReader *reader, BaseApplicationService *application, Error &error)
+{
+    nanoem_i64_t offset = 0;
+    nanoem_u32_t sig;
+    Error ignorable;
+    /* the file may be the one still written by the journal of the project */
+    m_project->flushRedoJournal(ignorable);
+    reader->seek(0, ISeekable::kSeekTypeBegin, error);
+    if (FileUtils::readTyped(reader, sig, error) == sizeof(sig) && sig == kFileMagic) {
+        Index index;
+        findIndex(reader, index, error);
+        offset = index.m_restartOffset;
+        reader->seek(offset, ISeekable::kSeekTypeBegin, error);
+        RecordHeader header;
+        if (readRecordHeader(reader, header, error) && header.m_type == kRecordTypeCheckpoint) {
+            ByteArray payload(header.m_size);
+            const nanoem_i32_t payloadSize = Inline::saturateInt32(payload.size());
+            if (FileUtils::read(reader, payload.data(), payload.size(), error) == payloadSize &&
+                restoreSnapshot(payload, application, error)) {
+                offset += kRecordHeaderSize + header.m_size;
+            }
+            else {
+                /* falls back to replay all records from the first one */
+                offset = sizeof(sig);
+            }
+        }
+    }
+    return offset;
+}
+
 void
 Redo::loadAll(ISeekableReader *reader, BaseApplicationService *application, Error &error)
 {
-    nanoem_u32_t sig;
-    nanoem_u16_t commandType;
-    if (FileUtils::readTyped(reader, sig, error) && sig == kFileMagic) {
-        nanoem_u32_t offset = 0, count = 0, lastSequnce = 0, deflatedCommandSize, sequence;
-        getCountOffset(reader, count, offset, error);
+    const nanoem_i64_t offset = restoreCheckpoint(reader, application, error);
+    if (offset > 0) {
+        nanoem_u32_t lastSequnce = 0;
+        reader->seek(offset, ISeekable::kSeekTypeBegin, error);
         m_project->setWritingRedoMessageDisabled(true);
         ByteArray deflated, inflated;
-        while (FileUtils::readTyped(reader, sequence, error) == sizeof(sequence)) {
-            FileUtils::readTyped(reader, commandType, error);
-            FileUtils::readTyped(reader, deflatedCommandSize, error);
-            if (isAccepted(commandType)) {
-                deflated.resize(deflatedCommandSize);
-                FileUtils::read(reader, deflated.data(), Inline::saturateInt32(deflated.size()), error);
-                if (offset <= sequence && (lastSequnce == 0 || lastSequnce < sequence)) {
+        RecordHeader header;
+        while (readRecordHeader(reader, header, error)) {
+            if (isAccepted(header.m_type)) {
+                deflated.resize(header.m_size);
+                if (FileUtils::read(reader, deflated.data(), deflated.size(), error) !=
+                    Inline::saturateInt32(deflated.size())) {
+                    break;
+                }
+                if (lastSequnce == 0 || lastSequnce < header.m_sequence) {
                     inflateChunk(deflated, inflated);
                     application->dispatchCommandMessage(inflated.data(), inflated.size(), m_project,
-                        commandType == NANOEM__APPLICATION__COMMAND__TYPE_UNDO);
+                        header.m_type == NANOEM__APPLICATION__COMMAND__TYPE_UNDO);
                 }
             }
             else {
-                reader->seek(deflatedCommandSize, ISeekable::kSeekTypeCurrent, error);
+                reader->seek(header.m_size, ISeekable::kSeekTypeCurrent, error);
             }
-            lastSequnce = sequence;
+            lastSequnce = header.m_sequence;
         }
         m_project->setWritingRedoMessageDisabled(false);
     }
 }
 
 void
-Redo::loadAllAsync(ISeekableReader *reader, IModalDialog *dialog, bool *cancelled, Error &error)
+Redo::loadAllAsync(ISeekableReader *reader, nanoem_i64_t offset, IModalDialog *dialog, bool *cancelled, Error &error)
 {
     int commandStreamSocket = nn_socket(AF_SP, NN_PUB);
     int eventStreamSocket = nn_socket(AF_SP, NN_SUB);
@@ -81,12 +199,16 @@ Redo::loadAllAsync(ISeekableReader *reader, IModalDialog *dialog, bool *cancelle
     nn_connect(eventStreamSocket, ThreadedApplicationService::kEventStreamURI);
     nn_setsockopt(eventStreamSocket, NN_SUB, NN_SUB_SUBSCRIBE, "", 0);
     nanoem_u32_t sig;
-    nanoem_u16_t commandType;
-    if (FileUtils::readTyped(reader, sig, error) && sig == kFileMagic) {
-        nanoem_u32_t offset = 0, count = 0, lastSequnce = 0, deflatedCommandSize, sequence;
-        getCountOffset(reader, count, offset, error);
+    reader->seek(0, ISeekable::kSeekTypeBegin, error);
+    if (offset > 0 && FileUtils::readTyped(reader, sig, error) && sig == kFileMagic) {
+        nanoem_u32_t firstSequence = 0, lastSequnce = 0;
+        Index index;
+        findIndex(reader, index, error);
         dialog->setProgress(0);
         m_project->setWritingRedoMessageDisabled(true);
+        Error ignorable;
+        /* no more records are queued from here so the replayed file is never interleaved with the journal */
+        m_project->flushRedoJournal(ignorable);
         const URI &fileURI = m_project->redoFileURI();
         IFileWriter *writer = nullptr;
         if (!fileURI.isEmpty()) {
@@ -94,27 +216,43 @@ Redo::loadAllAsync(ISeekableReader *reader, IModalDialog *dialog, bool *cancelle
             writer = FileUtils::createFileWriter();
             if (writer->open(fileURI, false, error)) {
                 FileUtils::writeTyped(writer, kFileMagic, error);
+                /* the restored checkpoint is carried over as the replayed records depend on it */
+                if (offset > index.m_restartOffset) {
+                    ByteArray checkpoint(nanoem_rsize_t(offset - index.m_restartOffset));
+                    reader->seek(index.m_restartOffset, ISeekable::kSeekTypeBegin, error);
+                    FileUtils::read(reader, checkpoint.data(), checkpoint.size(), error);
+                    FileUtils::write(writer, checkpoint, error);
+                }
             }
 #endif
         }
+        reader->seek(offset, ISeekable::kSeekTypeBegin, error);
         ByteArray deflated, inflated;
-        while (!*cancelled && FileUtils::readTyped(reader, sequence, error) == sizeof(sequence)) {
-            FileUtils::readTyped(reader, commandType, error);
-            FileUtils::readTyped(reader, deflatedCommandSize, error);
-            if (isAccepted(commandType)) {
-                deflated.resize(deflatedCommandSize);
-                FileUtils::read(reader, deflated.data(), Inline::saturateInt32(deflated.size()), error);
-                if (offset <= sequence && (lastSequnce == 0 || lastSequnce < sequence)) {
+        RecordHeader header;
+        while (!*cancelled && readRecordHeader(reader, header, error)) {
+            if (isAccepted(header.m_type)) {
+                deflated.resize(header.m_size);
+                if (FileUtils::read(reader, deflated.data(), deflated.size(), error) !=
+                    Inline::saturateInt32(deflated.size())) {
+                    break;
+                }
+                if (lastSequnce == 0 || lastSequnce < header.m_sequence) {
+                    if (firstSequence == 0) {
+                        firstSequence = header.m_sequence;
+                    }
                     inflateChunk(deflated, inflated);
-                    sendCommandMessage(commandStreamSocket, inflated, commandType, writer, sequence);
+                    sendCommandMessage(commandStreamSocket, inflated, header.m_type, writer, header.m_sequence);
                     waitEventMessage(commandStreamSocket, eventStreamSocket, cancelled);
-                    dialog->setProgress(nanoem_f32_t((sequence - offset) / nanoem_f64_t(count - offset)));
+                    if (index.m_lastSequence > firstSequence) {
+                        dialog->setProgress(nanoem_f32_t(
+                            (header.m_sequence - firstSequence) / nanoem_f64_t(index.m_lastSequence - firstSequence)));
+                    }
                 }
             }
             else {
-                reader->seek(deflatedCommandSize, ISeekable::kSeekTypeCurrent, error);
+                reader->seek(header.m_size, ISeekable::kSeekTypeCurrent, error);
             }
-            lastSequnce = sequence;
+            lastSequnce = header.m_sequence;
         }
         if (writer) {
             Error error;
@@ -135,39 +273,14 @@ Redo::loadAllAsync(ISeekableReader *reader, IModalDialog *dialog, bool *cancelle
 bool
 Redo::save(IWriter *writer, nanoem_u32_t sequence, const Nanoem__Application__Command *command, Error &error)
 {
-    bool saved = false;
-    if (!saved) {
-        ByteArray bytes;
-        bytes.resize(nanoem__application__command__get_packed_size(command));
-        nanoem__application__command__pack(command, bytes.data());
-        if (sequence == 0) {
-            FileUtils::writeTyped(writer, kFileMagic, error);
-        }
-        ByteArray compressed;
-        compressed.reserve(LZ4_compressBound(Inline::saturateInt32(bytes.size())));
-        int compressedSize =
-            LZ4_compress_fast(reinterpret_cast<const char *>(bytes.data()), reinterpret_cast<char *>(compressed.data()),
-                Inline::saturateInt32(bytes.size()), Inline::saturateInt32(compressed.capacity()), 1);
-        if (compressedSize > 0) {
-            bytes.clear();
-            const nanoem_u16_t type = nanoem_u16_t(command->type_case);
-            MemoryWriter memoryWriter(&bytes);
-            FileUtils::writeTyped(&memoryWriter, sequence, error);
-            FileUtils::writeTyped(&memoryWriter, type, error);
-            FileUtils::writeTyped(&memoryWriter, compressedSize, error);
-            FileUtils::write(&memoryWriter, compressed.data(), compressedSize, error);
-            FileUtils::write(writer, bytes, error);
-        }
-        else {
-            const nanoem_u16_t type = 0;
-            const nanoem_u32_t size = 0;
-            FileUtils::writeTyped(writer, sequence, error);
-            FileUtils::writeTyped(writer, type, error);
-            FileUtils::writeTyped(writer, size, error);
-        }
-        saved = !error.hasReason();
+    ByteArray bytes;
+    bytes.resize(nanoem__application__command__get_packed_size(command));
+    nanoem__application__command__pack(command, bytes.data());
+    if (sequence == 0) {
+        FileUtils::writeTyped(writer, kFileMagic, error);
     }
-    return saved;
+    writeCommandRecord(writer, sequence, nanoem_u16_t(command->type_case), bytes, error);
+    return !error.hasReason();
 }
 
 bool
@@ -224,21 +337,105 @@ Redo::isAccepted(nanoem_u32_t value) NANOEM_DECL_NOEXCEPT
     }
 }
 
+bool
+Redo::readRecordHeader(ISeekableReader *reader, RecordHeader &header, Error &error)
+{
+    return FileUtils::readTyped(reader, header.m_sequence, error) == sizeof(header.m_sequence) &&
+        FileUtils::readTyped(reader, header.m_type, error) == sizeof(header.m_type) &&
+        FileUtils::readTyped(reader, header.m_size, error) == sizeof(header.m_size);
+}
+
+bool
+Redo::readIndex(ISeekableReader *reader, Index &index, Error &error)
+{
+    const nanoem_rsize_t size = reader->size();
+    nanoem_u32_t recordSize, magic, lastSequence;
+    nanoem_i64_t restartOffset;
+    RecordHeader header;
+    bool found = false;
+    if (size >= sizeof(kFileMagic) + kIndexRecordSize) {
+        reader->seek(nanoem_i64_t(size - sizeof(recordSize) - sizeof(magic)), ISeekable::kSeekTypeBegin, error);
+        FileUtils::readTyped(reader, recordSize, error);
+        FileUtils::readTyped(reader, magic, error);
+        if (magic == kIndexMagic && recordSize == kIndexRecordSize) {
+            reader->seek(nanoem_i64_t(size - recordSize), ISeekable::kSeekTypeBegin, error);
+            /* zero restart offset means that the writer has lost the last one so records must be scanned */
+            if (readRecordHeader(reader, header, error) && header.m_type == kRecordTypeIndex &&
+                FileUtils::readTyped(reader, restartOffset, error) == sizeof(restartOffset) &&
+                FileUtils::readTyped(reader, lastSequence, error) == sizeof(lastSequence) &&
+                restartOffset >= nanoem_i64_t(sizeof(kFileMagic)) && restartOffset < nanoem_i64_t(size)) {
+                index.m_restartOffset = restartOffset;
+                index.m_lastSequence = lastSequence;
+                found = true;
+            }
+        }
+    }
+    return found;
+}
+
 void
-Redo::getCountOffset(ISeekableReader *reader, nanoem_u32_t &count, nanoem_u32_t &offset, Error &error)
-{
-    nanoem_u32_t deflatedCommandSize, sequence;
-    nanoem_u16_t commandType;
-    while (FileUtils::readTyped(reader, sequence, error) == sizeof(sequence)) {
-        FileUtils::readTyped(reader, commandType, error);
-        if (commandType == NANOEM__APPLICATION__COMMAND__TYPE_SAVE_POINT) {
-            offset = count;
+Redo::scanAllRecords(ISeekableReader *reader, Index &index, Error &error)
+{
+    nanoem_i64_t offset = sizeof(kFileMagic);
+    RecordHeader header;
+    reader->seek(offset, ISeekable::kSeekTypeBegin, error);
+    while (readRecordHeader(reader, header, error)) {
+        if (header.m_type == kRecordTypeCheckpoint || header.m_type == NANOEM__APPLICATION__COMMAND__TYPE_SAVE_POINT) {
+            index.m_restartOffset = offset;
         }
-        FileUtils::readTyped(reader, deflatedCommandSize, error);
-        reader->seek(deflatedCommandSize, ISeekable::kSeekTypeCurrent, error);
-        count++;
+        if (isAccepted(header.m_type)) {
+            index.m_lastSequence = header.m_sequence;
+        }
+        reader->seek(header.m_size, ISeekable::kSeekTypeCurrent, error);
+        offset += kRecordHeaderSize + header.m_size;
     }
-    reader->seek(4, ISeekable::kSeekTypeBegin, error);
+}
+
+nanoem_i64_t
+Redo::findRestartOffset(ISeekableReader *reader, Error &error)
+{
+    Index index;
+    findIndex(reader, index, error);
+    return index.m_restartOffset;
+}
+
+void
+Redo::findIndex(ISeekableReader *reader, Index &index, Error &error)
+{
+    index.m_restartOffset = sizeof(kFileMagic);
+    index.m_lastSequence = 0;
+    /* the journal written before the index record was introduced or interrupted while writing has no trailing index */
+    if (!readIndex(reader, index, error)) {
+        scanAllRecords(reader, index, error);
+    }
+}
+
+bool
+Redo::restoreSnapshot(const ByteArray &payload, BaseApplicationService *application, Error &error)
+{
+    nanoem_u32_t inflatedSize = 0, projectSize = 0;
+    bool succeeded = false;
+    if (payload.size() > sizeof(inflatedSize) + sizeof(projectSize)) {
+        memcpy(&inflatedSize, payload.data(), sizeof(inflatedSize));
+        memcpy(&projectSize, payload.data() + sizeof(inflatedSize), sizeof(projectSize));
+        const nanoem_rsize_t offset = sizeof(inflatedSize) + sizeof(projectSize);
+        ByteArray inflated(inflatedSize);
+        const int decompressedSize = LZ4_decompress_safe(reinterpret_cast<const char *>(payload.data() + offset),
+            reinterpret_cast<char *>(inflated.data()), Inline::saturateInt32(payload.size() - offset),
+            Inline::saturateInt32(inflated.size()));
+        if (decompressedSize == Inline::saturateInt32(inflatedSize) && projectSize <= inflatedSize) {
+            m_project->setWritingRedoMessageDisabled(true);
+            succeeded = m_project->loadFromBinary(
+                inflated.data(), projectSize, Project::kBinaryFormatNative, error, nullptr);
+            if (succeeded) {
+                /* the save point without the file binds drawable handles of the journal to the restored ones */
+                application->dispatchCommandMessage(
+                    inflated.data() + projectSize, inflatedSize - projectSize, m_project, false);
+            }
+            m_project->setWritingRedoMessageDisabled(false);
+        }
+    }
+    return succeeded;
 }
 
 void
@@ -318,6 +515,265 @@ Redo::waitEventMessage(int commandStreamSocket, int eventStreamSocket, bool *can
     }
 }
 
+RedoJournal::RedoJournal(const URI &fileURI, nanoem_u32_t checkpointInterval)
+    : m_fileURI(fileURI)
+    , m_numRecordsSinceRestart(0)
+    , m_checkpointInterval(checkpointInterval)
+    , m_numPendingRecords(0)
+    , m_numFlushWaiters(0)
+    , m_running(false)
+    , m_endOffset(0)
+    , m_restartOffset(sizeof(Redo::kFileMagic))
+    , m_lastSequence(0)
+{
+}
+
+RedoJournal::~RedoJournal() NANOEM_DECL_NOEXCEPT
+{
+    stop();
+}
+
+void
+RedoJournal::start()
+{
+    if (!m_running) {
+        m_running = true;
+#if BX_CONFIG_SUPPORTS_THREADING
+        char name[Inline::kNameStackBufferSize];
+        StringUtils::format(name, sizeof(name), "%s.RedoJournal", ThreadedApplicationService::kOrganizationDomain);
+        m_thread.init(execute, this, 0, name);
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    }
+}
+
+void
+RedoJournal::append(nanoem_u32_t sequence, const Nanoem__Application__Command *command, Error &error)
+{
+    Record *record = nanoem_new(Record);
+    record->m_body.resize(nanoem__application__command__get_packed_size(command));
+    nanoem__application__command__pack(command, record->m_body.data());
+    record->m_snapshot = nullptr;
+    record->m_sequence = sequence;
+    record->m_type = nanoem_u16_t(command->type_case);
+    if (record->m_type == NANOEM__APPLICATION__COMMAND__TYPE_SAVE_POINT) {
+        m_numRecordsSinceRestart = 0;
+    }
+    else {
+        m_numRecordsSinceRestart++;
+    }
+    enqueue(record, error);
+}
+
+void
+RedoJournal::appendCheckpoint(nanoem_u32_t sequence, const Nanoem__Application__Command *command,
+    Nanoem__Project__Project *snapshot, Error &error)
+{
+    Record *record = nanoem_new(Record);
+    record->m_body.resize(nanoem__application__command__get_packed_size(command));
+    nanoem__application__command__pack(command, record->m_body.data());
+    record->m_snapshot = snapshot;
+    record->m_sequence = sequence;
+    record->m_type = Redo::kRecordTypeCheckpoint;
+    m_numRecordsSinceRestart = 0;
+    enqueue(record, error);
+}
+
+void
+RedoJournal::flush(Error &error)
+{
+#if BX_CONFIG_SUPPORTS_THREADING
+    bool waiting = false;
+    {
+        bx::MutexScope locker(m_mutex);
+        BX_UNUSED_1(locker);
+        waiting = m_running && m_numPendingRecords > 0;
+        if (waiting) {
+            m_numFlushWaiters++;
+        }
+    }
+    if (waiting) {
+        m_flushSemaphore.wait();
+    }
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    bx::MutexScope locker(m_mutex);
+    BX_UNUSED_1(locker);
+    if (m_error.hasReason()) {
+        error = m_error;
+        m_error = Error();
+    }
+}
+
+void
+RedoJournal::stop()
+{
+    if (m_running) {
+#if BX_CONFIG_SUPPORTS_THREADING
+        {
+            bx::MutexScope locker(m_mutex);
+            BX_UNUSED_1(locker);
+            m_running = false;
+        }
+        /* wakes the writer to write all of queued records before stopping */
+        m_queueSemaphore.post();
+        m_thread.shutdown();
+#else
+        m_running = false;
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    }
+}
+
+bool
+RedoJournal::isCheckpointRequired() const NANOEM_DECL_NOEXCEPT
+{
+    return m_checkpointInterval > 0 && m_numRecordsSinceRestart >= m_checkpointInterval;
+}
+
+nanoem_u32_t
+RedoJournal::checkpointInterval() const NANOEM_DECL_NOEXCEPT
+{
+    return m_checkpointInterval;
+}
+
+void
+RedoJournal::setCheckpointInterval(nanoem_u32_t value)
+{
+    m_checkpointInterval = value;
+}
+
+#if BX_CONFIG_SUPPORTS_THREADING
+nanoem_i32_t
+RedoJournal::execute(bx::Thread * /* thread */, void *userData)
+{
+    RedoJournal *self = static_cast<RedoJournal *>(userData);
+    bool running = true;
+    while (running) {
+        self->m_queueSemaphore.wait();
+        RecordList records;
+        {
+            bx::MutexScope locker(self->m_mutex);
+            BX_UNUSED_1(locker);
+            records.swap(self->m_queuedRecords);
+            running = self->m_running;
+        }
+        if (!records.empty()) {
+            self->writeAllRecords(records);
+            destroyAllRecords(records);
+            bx::MutexScope locker(self->m_mutex);
+            BX_UNUSED_1(locker);
+            self->m_numPendingRecords -= nanoem_u32_t(records.size());
+            if (self->m_numPendingRecords == 0) {
+                /* wakes all of callers waiting the queue to be drained */
+                for (nanoem_u32_t i = 0; i < self->m_numFlushWaiters; i++) {
+                    self->m_flushSemaphore.post();
+                }
+                self->m_numFlushWaiters = 0;
+            }
+        }
+    }
+    return 0;
+}
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+
+void
+RedoJournal::destroyAllRecords(const RecordList &records) NANOEM_DECL_NOEXCEPT
+{
+    for (RecordList::const_iterator it = records.begin(), end = records.end(); it != end; ++it) {
+        Record *record = *it;
+        if (record->m_snapshot) {
+            Native::release(record->m_snapshot);
+        }
+        nanoem_delete(record);
+    }
+}
+
+void
+RedoJournal::enqueue(Record *record, Error &error)
+{
+#if BX_CONFIG_SUPPORTS_THREADING
+    if (m_running) {
+        {
+            bx::MutexScope locker(m_mutex);
+            BX_UNUSED_1(locker);
+            m_queuedRecords.push_back(record);
+            m_numPendingRecords++;
+            /* the failure of the previous group commit is reported to the next caller */
+            if (m_error.hasReason()) {
+                error = m_error;
+                m_error = Error();
+            }
+        }
+        m_queueSemaphore.post();
+        record = nullptr;
+    }
+#endif /* BX_CONFIG_SUPPORTS_THREADING */
+    if (record) {
+        RecordList records;
+        records.push_back(record);
+        writeAllRecords(records);
+        destroyAllRecords(records);
+        error = m_error;
+        m_error = Error();
+    }
+}
+
+void
+RedoJournal::writeAllRecords(const RecordList &records)
+{
+    Error error;
+    IFileWriter *writer = FileUtils::createFileWriter();
+    if (writer->open(m_fileURI, true, error)) {
+        const nanoem_i64_t offset = writer->seek(0, ISeekable::kSeekTypeEnd, error);
+        ByteArray bytes;
+        MemoryWriter memoryWriter(&bytes);
+        if (offset != m_endOffset) {
+            /* the file is truncated or rewritten by others so the last restart point is found from the file again */
+            m_restartOffset = sizeof(Redo::kFileMagic);
+            if (offset > 0) {
+                FileReaderScope scope(nullptr);
+                Error ignorable;
+                if (scope.open(m_fileURI, ignorable)) {
+                    m_restartOffset = Redo::findRestartOffset(scope.reader(), ignorable);
+                }
+            }
+        }
+        if (offset == 0) {
+            FileUtils::writeTyped(&memoryWriter, Redo::kFileMagic, error);
+        }
+        for (RecordList::const_iterator it = records.begin(), end = records.end(); it != end; ++it) {
+            const Record *record = *it;
+            const nanoem_i64_t recordOffset = offset + nanoem_i64_t(bytes.size());
+            if (record->m_type == Redo::kRecordTypeCheckpoint) {
+                /* the snapshot is packed here to keep serializing the whole project off the caller */
+                ByteArray payload;
+                if (Native::pack(record->m_snapshot, payload)) {
+                    const nanoem_rsize_t snapshotSize = payload.size();
+                    payload.insert(payload.end(), record->m_body.begin(), record->m_body.end());
+                    Redo::writeCheckpointRecord(&memoryWriter, record->m_sequence, payload, snapshotSize, error);
+                    m_restartOffset = recordOffset;
+                }
+            }
+            else {
+                Redo::writeCommandRecord(&memoryWriter, record->m_sequence, record->m_type, record->m_body, error);
+                if (record->m_type == NANOEM__APPLICATION__COMMAND__TYPE_SAVE_POINT) {
+                    m_restartOffset = recordOffset;
+                }
+            }
+            m_lastSequence = record->m_sequence;
+        }
+        Redo::writeIndexRecord(&memoryWriter, m_lastSequence, m_restartOffset, error);
+        if (FileUtils::write(writer, bytes, error) == Inline::saturateInt32(bytes.size())) {
+            m_endOffset = offset + nanoem_i64_t(bytes.size());
+        }
+        writer->close(error);
+    }
+    FileUtils::destroyFileWriter(writer);
+    if (error.hasReason()) {
+        bx::MutexScope locker(m_mutex);
+        BX_UNUSED_1(locker);
+        m_error = error;
+    }
+}
+
 } /* namespace project */
 } /* namespace internal */
 } /* namespace nanoem */
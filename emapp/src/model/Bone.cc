@@ -28,11 +28,14 @@ enum PrivateStateFlags {
     kPrivateStateLinearInterpolationOrientation = 1 << 4,
     kPrivateStateDirty = 1 << 5,
     kPrivateStateEditingMasked = 1 << 6,
+    kPrivateStateTransformDirty = 1 << 7,
+    kPrivateStateMorphTranslationReset = 1 << 8,
+    kPrivateStateMorphOrientationReset = 1 << 9,
     kPrivateStateReserved = 1 << 31,
 };
 static const nanoem_u32_t kPrivateStateInitialValue = kPrivateStateLinearInterpolationTranslationX |
     kPrivateStateLinearInterpolationTranslationY | kPrivateStateLinearInterpolationTranslationZ |
-    kPrivateStateLinearInterpolationOrientation;
+    kPrivateStateLinearInterpolationOrientation | kPrivateStateTransformDirty;
 
 static inline void
 identify(bx::float4x4_t *o) NANOEM_DECL_NOEXCEPT
@@ -125,13 +128,20 @@ Bone::resetLanguage(
     if (m_name.empty()) {
         m_name = m_canonicalName;
     }
+    /* the name of the bone may be changed so the motion track must be resolved again */
+    m_resolvedMotion = nullptr;
+    m_motionTrack = nullptr;
+    m_motionCursor.reset();
 }
 
 void
 Bone::resetLocalTransform() NANOEM_DECL_NOEXCEPT
 {
-    m_localOrientation = m_localInherentOrientation = Constants::kZeroQ;
-    m_localTranslation = m_localInherentTranslation = Constants::kZeroV3;
+    /* local transform of the clean bone is kept since it's still the result of the unchanged inputs */
+    if (isTransformDirty()) {
+        m_localOrientation = m_localInherentOrientation = Constants::kZeroQ;
+        m_localTranslation = m_localInherentTranslation = Constants::kZeroV3;
+    }
     for (size_t i = 0; i < BX_COUNTOF(m_bezierControlPoints); i++) {
         nanoem_motion_bone_keyframe_interpolation_type_t type =
             static_cast<nanoem_motion_bone_keyframe_interpolation_type_t>(i);
@@ -143,16 +153,31 @@ Bone::resetLocalTransform() NANOEM_DECL_NOEXCEPT
 void
 Bone::resetUserTransform() NANOEM_DECL_NOEXCEPT
 {
-    m_localUserOrientation = Constants::kZeroQ;
-    m_localUserTranslation = Constants::kZeroV3;
+    setLocalUserOrientation(Constants::kZeroQ);
+    setLocalUserTranslation(Constants::kZeroV3);
     setDirty(false);
 }
 
 void
 Bone::resetMorphTransform() NANOEM_DECL_NOEXCEPT
 {
-    m_localMorphOrientation = Constants::kZeroQ;
-    m_localMorphTranslation = Constants::kZeroV3;
+    /*
+     * bone morphs are reset and deformed again on every frame so the reset is deferred to keep the last values.
+     * the bone becomes dirty only if the morph sets different values or resolveMorphTransform finds it not set
+     */
+    EnumUtils::setEnabled(kPrivateStateMorphTranslationReset, m_states, true);
+    EnumUtils::setEnabled(kPrivateStateMorphOrientationReset, m_states, true);
+}
+
+void
+Bone::resolveMorphTransform() NANOEM_DECL_NOEXCEPT
+{
+    if (EnumUtils::isEnabled(kPrivateStateMorphTranslationReset, m_states)) {
+        setLocalMorphTranslation(Constants::kZeroV3);
+    }
+    if (EnumUtils::isEnabled(kPrivateStateMorphOrientationReset, m_states)) {
+        setLocalMorphOrientation(Constants::kZeroQ);
+    }
 }
 
 void
@@ -161,9 +186,11 @@ Bone::synchronizeMotion(const Motion *motion, const nanoem_model_bone_t *bone,
 {
     nanoem_parameter_assert(bone, "must not be nullptr");
     FrameTransform t0(FrameTransform::kInitialFrameTransform), t1(FrameTransform::kInitialFrameTransform);
-    synchronizeTransform(motion, bone, rigidBodyPtr, frameIndex, t0);
+    const nanoem_motion_track_t *track = motionTrack(motion, bone);
+    nanoem_motion_keyframe_cursor_t *cursor = motionKeyframeCursor(motion);
+    synchronizeTransform(motion, track, cursor, bone, rigidBodyPtr, frameIndex, t0);
     if (amount > 0) {
-        synchronizeTransform(motion, bone, nullptr, frameIndex + 1, t1);
+        synchronizeTransform(motion, track, cursor, bone, nullptr, frameIndex + 1, t1);
         setLocalUserTranslation(glm::mix(t0.m_translation, t1.m_translation, amount));
         setLocalUserOrientation(glm::slerp(t0.m_orientation, t1.m_orientation, amount));
         for (size_t i = 0; i < BX_COUNTOF(m_bezierControlPoints); i++) {
@@ -185,6 +212,35 @@ Bone::synchronizeMotion(const Motion *motion, const nanoem_model_bone_t *bone,
     }
 }
 
+void
+Bone::resolveMotionTrack(const Motion *motion, const nanoem_model_bone_t *bone) NANOEM_DECL_NOEXCEPT
+{
+    nanoem_parameter_assert(bone, "must not be nullptr");
+    const nanoem_motion_t *opaque = motion ? motion->data() : nullptr;
+    m_motionTrack =
+        nanoemMotionResolveBoneTrack(opaque, nanoemModelBoneGetName(bone, NANOEM_LANGUAGE_TYPE_FIRST_ENUM));
+    m_numResolvedMotionTracks = nanoemMotionGetNumBoneTracks(opaque);
+    m_resolvedMotion = opaque;
+}
+
+const nanoem_motion_track_t *
+Bone::motionTrack(const Motion *motion, const nanoem_model_bone_t *bone) NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_motion_t *opaque = motion ? motion->data() : nullptr;
+    /* a track is never removed but may be created after resolving so recheck only when it's not found */
+    if (m_resolvedMotion != opaque ||
+        (!m_motionTrack && m_numResolvedMotionTracks != nanoemMotionGetNumBoneTracks(opaque))) {
+        resolveMotionTrack(motion, bone);
+    }
+    return m_motionTrack;
+}
+
+nanoem_motion_keyframe_cursor_t *
+Bone::motionKeyframeCursor(const Motion *motion) NANOEM_DECL_NOEXCEPT
+{
+    return m_motionCursor.resolve(motion);
+}
+
 void
 Bone::updateLocalOrientation(const nanoem_model_bone_t *bone, const Model *model) NANOEM_DECL_NOEXCEPT
 {
@@ -219,18 +275,18 @@ Bone::updateLocalOrientation(const nanoem_model_bone_t *bone, const Model *model
             }
         }
         if (model && model->isConstraintJointBoneActive(bone)) {
-            m_localOrientation = glm::normalize(m_constraintJointOrientation * m_localMorphOrientation * orientation);
+            m_localOrientation = glm::normalize(m_constraintJointOrientation * localMorphOrientation() * orientation);
         }
         else {
-            m_localOrientation = glm::normalize(m_localMorphOrientation * m_localUserOrientation * orientation);
+            m_localOrientation = glm::normalize(localMorphOrientation() * m_localUserOrientation * orientation);
         }
         m_localInherentOrientation = orientation;
     }
     else if (model && model->isConstraintJointBoneActive(bone)) {
-        m_localOrientation = glm::normalize(m_constraintJointOrientation * m_localMorphOrientation);
+        m_localOrientation = glm::normalize(m_constraintJointOrientation * localMorphOrientation());
     }
     else {
-        m_localOrientation = glm::normalize(m_localMorphOrientation * m_localUserOrientation);
+        m_localOrientation = glm::normalize(localMorphOrientation() * m_localUserOrientation);
     }
 }
 
@@ -258,7 +314,7 @@ Bone::updateLocalTranslation(const nanoem_model_bone_t *bone) NANOEM_DECL_NOEXCE
         }
         m_localInherentTranslation = translation;
     }
-    translation += m_localMorphTranslation;
+    translation += localMorphTranslation();
     m_localTranslation = translation;
 }
 
@@ -268,8 +324,8 @@ Bone::updateLocalMorphTransform(const nanoem_model_morph_bone_t *morph, nanoem_f
     nanoem_parameter_assert(morph, "must not be nullptr");
     const Vector3 translation(toVector3(nanoemModelMorphBoneGetTranslation(morph)));
     const Quaternion orientation(toQuaternion(nanoemModelMorphBoneGetOrientation(morph)));
-    m_localMorphTranslation = glm::mix(Constants::kZeroV3, translation, weight);
-    m_localMorphOrientation = glm::slerp(Constants::kZeroQ, orientation, weight);
+    setLocalMorphTranslation(glm::mix(Constants::kZeroV3, translation, weight));
+    setLocalMorphOrientation(glm::slerp(Constants::kZeroQ, orientation, weight));
 }
 
 void
@@ -307,6 +363,7 @@ Bone::updateLocalTransform(
     m_matrices.m_localTransform = localTransform;
     translate(-boneOrigin, &m_matrices.m_worldTransform, &m_matrices.m_skinningTransform);
     shrink3x3(&m_matrices.m_worldTransform, &m_matrices.m_normalTransform);
+    setTransformDirty(true);
 }
 
 void
@@ -315,7 +372,7 @@ Bone::applyAllLocalTransform(const nanoem_model_bone_t *bone, const Model *model
     updateLocalOrientation(bone, model);
     updateLocalTranslation(bone);
     updateLocalTransform(bone);
-    solveConstraint(bone);
+    solveConstraint(bone, model);
 }
 
 void
@@ -364,6 +421,7 @@ Bone::updateSkinningTransform(const nanoem_model_bone_t *bone, const bx::float4x
     m_matrices.m_skinningTransform = *value;
     translate(origin(bone), value, &m_matrices.m_worldTransform);
     shrink3x3(&m_matrices.m_worldTransform, &m_matrices.m_normalTransform);
+    setTransformDirty(true);
 }
 
 String
@@ -414,6 +472,32 @@ Bone::setEditingMasked(bool value)
     EnumUtils::setEnabled(kPrivateStateEditingMasked, m_states, value);
 }
 
+bool
+Bone::isTransformDirty() const NANOEM_DECL_NOEXCEPT
+{
+    return EnumUtils::isEnabled(kPrivateStateTransformDirty, m_states);
+}
+
+void
+Bone::setTransformDirty(bool value) NANOEM_DECL_NOEXCEPT
+{
+    EnumUtils::setEnabled(kPrivateStateTransformDirty, m_states, value);
+}
+
+nanoem_u64_t
+Bone::transformSequence() const NANOEM_DECL_NOEXCEPT
+{
+    return m_transformSequence;
+}
+
+void
+Bone::setTransformSequence(nanoem_u64_t value) NANOEM_DECL_NOEXCEPT
+{
+    /* the bone becomes clean until any of its inputs is changed and dependents compare the sequence with their own */
+    m_transformSequence = value;
+    setTransformDirty(false);
+}
+
 void
 Bone::constrainOrientation(
     const Vector3 &upperLimit, const Vector3 &lowerLimit, Quaternion &orientation) NANOEM_DECL_NOEXCEPT
@@ -629,7 +713,8 @@ Bone::localInherentOrientation() const NANOEM_DECL_NOEXCEPT
 Quaternion
 Bone::localMorphOrientation() const NANOEM_DECL_NOEXCEPT
 {
-    return m_localMorphOrientation;
+    return EnumUtils::isEnabled(kPrivateStateMorphOrientationReset, m_states) ? Constants::kZeroQ
+                                                                              : m_localMorphOrientation;
 }
 
 Quaternion
@@ -647,7 +732,10 @@ Bone::constraintJointOrientation() const NANOEM_DECL_NOEXCEPT
 void
 Bone::setConstraintJointOrientation(const Quaternion &value)
 {
-    m_constraintJointOrientation = value;
+    if (m_constraintJointOrientation != value) {
+        m_constraintJointOrientation = value;
+        setTransformDirty(true);
+    }
 }
 
 Vector3
@@ -665,7 +753,8 @@ Bone::localInherentTranslation() const NANOEM_DECL_NOEXCEPT
 Vector3
 Bone::localMorphTranslation() const NANOEM_DECL_NOEXCEPT
 {
-    return m_localMorphTranslation;
+    return EnumUtils::isEnabled(kPrivateStateMorphTranslationReset, m_states) ? Constants::kZeroV3
+                                                                              : m_localMorphTranslation;
 }
 
 Vector3
@@ -677,25 +766,40 @@ Bone::localUserTranslation() const NANOEM_DECL_NOEXCEPT
 void
 Bone::setLocalUserOrientation(const Quaternion &value)
 {
-    m_localUserOrientation = value;
+    if (m_localUserOrientation != value) {
+        m_localUserOrientation = value;
+        setTransformDirty(true);
+    }
 }
 
 void
 Bone::setLocalUserTranslation(const Vector3 &value)
 {
-    m_localUserTranslation = value;
+    if (m_localUserTranslation != value) {
+        m_localUserTranslation = value;
+        setTransformDirty(true);
+    }
 }
 
 void
 Bone::setLocalMorphOrientation(const Quaternion &value)
 {
-    m_localMorphOrientation = value;
+    /* compared with the value of the last evaluation even if the reset is pending */
+    EnumUtils::setEnabled(kPrivateStateMorphOrientationReset, m_states, false);
+    if (m_localMorphOrientation != value) {
+        m_localMorphOrientation = value;
+        setTransformDirty(true);
+    }
 }
 
 void
 Bone::setLocalMorphTranslation(const Vector3 &value)
 {
-    m_localMorphTranslation = value;
+    EnumUtils::setEnabled(kPrivateStateMorphTranslationReset, m_states, false);
+    if (m_localMorphTranslation != value) {
+        m_localMorphTranslation = value;
+        setTransformDirty(true);
+    }
 }
 
 Vector4U8
@@ -771,12 +875,13 @@ Bone::destroy(void *opaque, nanoem_model_object_t * /* object */) NANOEM_DECL_NO
 }
 
 void
-Bone::synchronizeTransform(const Motion *motion, const nanoem_model_bone_t *bone,
+Bone::synchronizeTransform(const Motion *motion, const nanoem_motion_track_t *track,
+    nanoem_motion_keyframe_cursor_t *cursor, const nanoem_model_bone_t *bone,
     const nanoem_model_rigid_body_t *rigidBodyPtr, nanoem_frame_index_t frameIndex, FrameTransform &transform)
 {
     nanoem_parameter_assert(bone, "must not be nullptr");
-    const nanoem_unicode_string_t *name = nanoemModelBoneGetName(bone, NANOEM_LANGUAGE_TYPE_FIRST_ENUM);
-    if (const nanoem_motion_bone_keyframe_t *keyframe = motion->findBoneKeyframe(name, frameIndex)) {
+    if (const nanoem_motion_bone_keyframe_t *keyframe =
+            nanoemMotionTrackFindBoneKeyframeObjectWithCursor(track, cursor, frameIndex)) {
         transform.m_translation = toVector3(keyframe);
         transform.m_orientation = toQuaternion(keyframe);
         for (int i = NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_FIRST_ENUM;
@@ -791,7 +896,7 @@ Bone::synchronizeTransform(const Motion *motion, const nanoem_model_bone_t *bone
     }
     else {
         nanoem_motion_bone_keyframe_t *prevKeyframe, *nextKeyframe;
-        nanoemMotionSearchClosestBoneKeyframes(motion->data(), name, frameIndex, &prevKeyframe, &nextKeyframe);
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, cursor, frameIndex, &prevKeyframe, &nextKeyframe);
         if (prevKeyframe && nextKeyframe) {
             const nanoem_motion_bone_keyframe_t *interpolateKeyframe = nextKeyframe;
             const Vector3 translation0(toVector3(prevKeyframe)), translation1(toVector3(nextKeyframe));
@@ -863,17 +968,6 @@ Bone::createConstraintUnitAxes(const Vector3 &radians, const Vector3 &lowerLimit
     z = glm::angleAxis(r.z, Constants::kUnitZ);
 }
 
-void
-Bone::constrainOrientation(const nanoem_model_constraint_joint_t *joint, Quaternion &orientation) NANOEM_DECL_NOEXCEPT
-{
-    nanoem_parameter_assert(joint, "must not be nullptr");
-    if (nanoemModelConstraintJointHasAngleLimit(joint)) {
-        const Vector3 upperLimit(glm::make_vec3(nanoemModelConstraintJointGetUpperLimit(joint)));
-        const Vector3 lowerLimit(glm::make_vec3(nanoemModelConstraintJointGetLowerLimit(joint)));
-        constrainOrientation(upperLimit, lowerLimit, orientation);
-    }
-}
-
 Vector3
 Bone::toVector3(const nanoem_f32_t *value) NANOEM_DECL_NOEXCEPT
 {
@@ -887,11 +981,10 @@ Bone::toQuaternion(const nanoem_f32_t *value) NANOEM_DECL_NOEXCEPT
 }
 
 void
-Bone::solveConstraint(const nanoem_model_constraint_t *constraintPtr, int numIterations)
+Bone::solveConstraint(const nanoem_model_constraint_t *constraintPtr, int numIterations, const Model *model)
 {
     nanoem_parameter_assert(constraintPtr, "must not be nullptr");
-    nanoem_rsize_t numJoints;
-    nanoem_model_constraint_joint_t *const *joints = nanoemModelConstraintGetAllJointObjects(constraintPtr, &numJoints);
+    nanoem_parameter_assert(model, "must not be nullptr");
     const nanoem_model_bone_t *targetBonePtr = nanoemModelConstraintGetTargetBoneObject(constraintPtr);
     const nanoem_model_bone_t *effectorBonePtr = nanoemModelConstraintGetEffectorBoneObject(constraintPtr);
     const nanoem_f32_t angleLimit = nanoemModelConstraintGetAngleLimit(constraintPtr);
@@ -901,39 +994,30 @@ Bone::solveConstraint(const nanoem_model_constraint_t *constraintPtr, int numIte
     if (!targetBone || !effectorBone || !constraintUserData) {
         return;
     }
+    /* joints are resolved in Model::resolveAllConstraintJoints before solving so the factory is never used here */
+    const Constraint::ResolvedJointList &joints =
+        constraintUserData->resolveAllJoints(constraintPtr, model->project()->unicodeStringFactory());
+    const nanoem_rsize_t numJoints = joints.size();
+    const bool captured = constraintUserData->isIterationResultCaptured();
     const Vector4 targetBonePosition(targetBone->worldTransformOrigin(), 1);
+    Constraint::Joint scratch;
+    int numSolvedIterations = numIterations;
     for (int i = 0; i < numIterations; i++) {
         const bool firstIteration = i == 0;
         for (nanoem_rsize_t j = 0; j < numJoints; j++) {
-            const nanoem_model_constraint_joint_t *joint = joints[j];
-            Bone *jointBone = Bone::cast(nanoemModelConstraintJointGetBoneObject(joint));
-            Constraint::Joint *jointResult = constraintUserData->jointIterationResult(joint, i);
+            const Constraint::ResolvedJoint &joint = joints[j];
+            Bone *jointBone = joint.m_bone;
+            Constraint::Joint *jointResult =
+                captured ? constraintUserData->jointIterationResult(joint.m_opaque, i) : &scratch;
             const Vector4 effectorBonePosition(effectorBone->worldTransformOrigin(), 1);
             if (jointBone &&
                 !Constraint::solveAxisAngle(
                     jointBone->worldTransform(), effectorBonePosition, targetBonePosition, jointResult)) {
-                const nanoem_model_bone_t *bone = nanoemModelConstraintJointGetBoneObject(joint);
-                if (nanoemModelBoneHasFixedAxis(bone)) {
-                    const Vector3 axis(glm::make_vec3(nanoemModelBoneGetFixedAxis(bone)));
-                    if (!glm::isNull(axis, Constants::kEpsilon)) {
-                        jointResult->setAxis(glm::normalize(axis));
-                    }
+                if (!glm::isNull(joint.m_fixedAxis, Constants::kEpsilon)) {
+                    jointResult->setAxis(joint.m_fixedAxis);
                 }
-                else if (firstIteration && nanoemModelConstraintJointHasAngleLimit(joint)) {
-                    static const Vector3 kEpsilon(Constants::kEpsilonVec3);
-                    const glm::bvec3 hasUpperLimit(glm::lessThanEqual(
-                        glm::abs(glm::make_vec3(nanoemModelConstraintJointGetUpperLimit(joint))), kEpsilon));
-                    const glm::bvec3 hasLowerLimit(glm::lessThanEqual(
-                        glm::abs(glm::make_vec3(nanoemModelConstraintJointGetLowerLimit(joint))), kEpsilon));
-                    if (hasLowerLimit.y && hasUpperLimit.y && hasLowerLimit.z && hasUpperLimit.z) {
-                        jointResult->setAxis(Constants::kUnitX);
-                    }
-                    else if (hasLowerLimit.x && hasUpperLimit.x && hasLowerLimit.z && hasUpperLimit.z) {
-                        jointResult->setAxis(Constants::kUnitY);
-                    }
-                    else if (hasLowerLimit.x && hasUpperLimit.x && hasLowerLimit.y && hasUpperLimit.y) {
-                        jointResult->setAxis(Constants::kUnitZ);
-                    }
+                else if (firstIteration && !glm::isNull(joint.m_limitedAxis, Constants::kEpsilon)) {
+                    jointResult->setAxis(joint.m_limitedAxis);
                 }
                 nanoem_f32_t newAngleLimit = angleLimit * (j + 1);
                 const Quaternion orientation(
@@ -945,33 +1029,42 @@ Bone::solveConstraint(const nanoem_model_constraint_t *constraintPtr, int numIte
                 else {
                     mixedOrientation = jointBone->constraintJointOrientation() * orientation;
                 }
-                constrainOrientation(joint, mixedOrientation);
+                if (joint.m_hasAngleLimit) {
+                    constrainOrientation(joint.m_upperLimit, joint.m_lowerLimit, mixedOrientation);
+                }
                 jointBone->setConstraintJointOrientation(glm::normalize(mixedOrientation));
                 for (int k = Inline::saturateInt32(j); k >= 0; k--) {
-                    const nanoem_model_constraint_joint_t *upperJoint = joints[k];
-                    const nanoem_model_bone_t *upperJointBonePtr = nanoemModelConstraintJointGetBoneObject(upperJoint);
-                    Bone *upperJointBone = Bone::cast(upperJointBonePtr);
-                    upperJointBone->updateLocalTransform(upperJointBonePtr, upperJointBone->localTranslation(),
+                    const Constraint::ResolvedJoint &upperJoint = joints[k];
+                    Bone *upperJointBone = upperJoint.m_bone;
+                    upperJointBone->updateLocalTransform(upperJoint.m_bonePtr, upperJointBone->localTranslation(),
                         upperJointBone->constraintJointOrientation());
                 }
-                jointResult->setTransform(jointBone->worldTransform());
                 effectorBone->updateLocalTransform(effectorBonePtr);
-                Constraint::Joint *effectorResult = constraintUserData->effectorIterationResult(joint, i);
-                effectorResult->setTransform(effectorBone->worldTransform());
+                if (captured) {
+                    jointResult->setTransform(jointBone->worldTransform());
+                    Constraint::Joint *effectorResult = constraintUserData->effectorIterationResult(joint.m_opaque, i);
+                    effectorResult->setTransform(effectorBone->worldTransform());
+                }
             }
         }
+        /* captured iterations stop at the same one so the heatmap shows only the iterations actually solved */
+        if (Constraint::isConverged(effectorBone->worldTransformOrigin(), targetBone->worldTransformOrigin())) {
+            numSolvedIterations = i + 1;
+            break;
+        }
     }
+    constraintUserData->setNumSolvedIterations(numSolvedIterations);
 }
 
 void
-Bone::solveConstraint(const nanoem_model_bone_t *bone)
+Bone::solveConstraint(const nanoem_model_bone_t *bone, const Model *model)
 {
     nanoem_parameter_assert(bone, "must not be nullptr");
     const nanoem_model_constraint_t *constraintPtr = nanoemModelBoneGetConstraintObject(bone);
     if (const Constraint *constraint = Constraint::cast(constraintPtr)) {
         if (constraint->isEnabled()) {
             const int numIterations = nanoemModelConstraintGetNumIterations(constraintPtr);
-            solveConstraint(constraintPtr, numIterations);
+            solveConstraint(constraintPtr, numIterations, model);
         }
         else {
             nanoem_rsize_t numJoints;
@@ -995,6 +1088,10 @@ Bone::Bone(const PlaceHolder & /* holder */) NANOEM_DECL_NOEXCEPT : m_localOrien
                                                                     m_localInherentTranslation(Constants::kZeroV3),
                                                                     m_localMorphTranslation(Constants::kZeroV3),
                                                                     m_localUserTranslation(Constants::kZeroV3),
+                                                                    m_resolvedMotion(nullptr),
+                                                                    m_motionTrack(nullptr),
+                                                                    m_numResolvedMotionTracks(0),
+                                                                    m_transformSequence(0),
                                                                     m_states(kPrivateStateInitialValue)
 {
     Inline::clearZeroMemory(m_bezierControlPoints);
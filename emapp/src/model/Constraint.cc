@@ -21,6 +21,8 @@ namespace {
 
 enum PrivateStateFlags {
     kPrivateStateEnabled = 1 << 1,
+    kPrivateStateIterationResultCaptured = 1 << 2,
+    kPrivateStateJointResolved = 1 << 3,
     kPrivateStateReserved = 1 << 31,
 };
 static const nanoem_u32_t kPrivateStateInitialValue = kPrivateStateEnabled;
@@ -131,6 +133,14 @@ Constraint::hasUnitXConstraint(
             reinterpret_cast<const char *>(buffer), reinterpret_cast<const char *>(model::Bone::kRightKneeInJapanese));
 }
 
+bool
+Constraint::isConverged(const Vector3 &effectorPosition, const Vector3 &targetPosition) NANOEM_DECL_NOEXCEPT
+{
+    static const nanoem_f32_t kConvergedDistance = 1e-4f;
+    const Vector3 delta(effectorPosition - targetPosition);
+    return glm::dot(delta, delta) < kConvergedDistance * kConvergedDistance;
+}
+
 void
 Constraint::bind(nanoem_model_constraint_t *constraintPtr)
 {
@@ -174,6 +184,61 @@ Constraint::initialize(const nanoem_model_constraint_t *constraintPtr)
     }
 }
 
+const Constraint::ResolvedJointList &
+Constraint::resolveAllJoints(const nanoem_model_constraint_t *constraintPtr, nanoem_unicode_string_factory_t *factory)
+{
+    /* everything below depends only on the model so these are resolved once instead of each iteration */
+    nanoem_parameter_assert(constraintPtr, "must not be nullptr");
+    if (!EnumUtils::isEnabled(kPrivateStateJointResolved, m_states)) {
+        nanoem_rsize_t numJoints;
+        nanoem_model_constraint_joint_t *const *joints =
+            nanoemModelConstraintGetAllJointObjects(constraintPtr, &numJoints);
+        static const Vector3 kEpsilon(Constants::kEpsilonVec3);
+        m_resolvedJoints.clear();
+        for (nanoem_rsize_t i = 0; i < numJoints; i++) {
+            const nanoem_model_constraint_joint_t *joint = joints[i];
+            const nanoem_model_bone_t *bonePtr = nanoemModelConstraintJointGetBoneObject(joint);
+            ResolvedJoint resolved;
+            resolved.m_opaque = joint;
+            resolved.m_bonePtr = bonePtr;
+            resolved.m_bone = Bone::cast(bonePtr);
+            resolved.m_upperLimit = glm::make_vec3(nanoemModelConstraintJointGetUpperLimit(joint));
+            resolved.m_lowerLimit = glm::make_vec3(nanoemModelConstraintJointGetLowerLimit(joint));
+            resolved.m_fixedAxis = resolved.m_limitedAxis = Constants::kZeroV3;
+            resolved.m_hasAngleLimit = nanoemModelConstraintJointHasAngleLimit(joint) != 0;
+            resolved.m_hasUnitXConstraint = bonePtr && hasUnitXConstraint(bonePtr, factory);
+            if (bonePtr && nanoemModelBoneHasFixedAxis(bonePtr)) {
+                const Vector3 axis(glm::make_vec3(nanoemModelBoneGetFixedAxis(bonePtr)));
+                if (!glm::isNull(axis, Constants::kEpsilon)) {
+                    resolved.m_fixedAxis = glm::normalize(axis);
+                }
+            }
+            else if (resolved.m_hasAngleLimit) {
+                const glm::bvec3 hasUpperLimit(glm::lessThanEqual(glm::abs(resolved.m_upperLimit), kEpsilon));
+                const glm::bvec3 hasLowerLimit(glm::lessThanEqual(glm::abs(resolved.m_lowerLimit), kEpsilon));
+                if (hasLowerLimit.y && hasUpperLimit.y && hasLowerLimit.z && hasUpperLimit.z) {
+                    resolved.m_limitedAxis = Constants::kUnitX;
+                }
+                else if (hasLowerLimit.x && hasUpperLimit.x && hasLowerLimit.z && hasUpperLimit.z) {
+                    resolved.m_limitedAxis = Constants::kUnitY;
+                }
+                else if (hasLowerLimit.x && hasUpperLimit.x && hasLowerLimit.y && hasUpperLimit.y) {
+                    resolved.m_limitedAxis = Constants::kUnitZ;
+                }
+            }
+            m_resolvedJoints.push_back(resolved);
+        }
+        EnumUtils::setEnabled(kPrivateStateJointResolved, m_states, true);
+    }
+    return m_resolvedJoints;
+}
+
+void
+Constraint::invalidateAllJoints()
+{
+    EnumUtils::setEnabled(kPrivateStateJointResolved, m_states, false);
+}
+
 const Constraint::JointIterationResult *
 Constraint::jointIterationResult() const NANOEM_DECL_NOEXCEPT
 {
@@ -234,6 +299,30 @@ Constraint::setEnabled(bool value)
     EnumUtils::setEnabled(kPrivateStateEnabled, m_states, value);
 }
 
+bool
+Constraint::isIterationResultCaptured() const NANOEM_DECL_NOEXCEPT
+{
+    return EnumUtils::isEnabled(kPrivateStateIterationResultCaptured, m_states);
+}
+
+void
+Constraint::setIterationResultCaptured(bool value)
+{
+    EnumUtils::setEnabled(kPrivateStateIterationResultCaptured, m_states, value);
+}
+
+nanoem_rsize_t
+Constraint::numSolvedIterations() const NANOEM_DECL_NOEXCEPT
+{
+    return m_numSolvedIterations;
+}
+
+void
+Constraint::setNumSolvedIterations(nanoem_rsize_t value)
+{
+    m_numSolvedIterations = value;
+}
+
 void
 Constraint::destroy(void *opaque, nanoem_model_object_t * /* constraintPtr */) NANOEM_DECL_NOEXCEPT
 {
@@ -242,7 +331,8 @@ Constraint::destroy(void *opaque, nanoem_model_object_t * /* constraintPtr */) N
     nanoem_delete(self);
 }
 
-Constraint::Constraint(const PlaceHolder & /* holder */) NANOEM_DECL_NOEXCEPT : m_states(kPrivateStateEnabled)
+Constraint::Constraint(const PlaceHolder & /* holder */) NANOEM_DECL_NOEXCEPT : m_numSolvedIterations(0),
+                                                                                 m_states(kPrivateStateEnabled)
 {
 }
 
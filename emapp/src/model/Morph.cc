@@ -9,8 +9,11 @@
 #include "emapp/Constants.h"
 #include "emapp/Motion.h"
 #include "emapp/StringUtils.h"
+#include "emapp/model/Vertex.h"
 #include "emapp/private/CommonInclude.h"
 
+#include "glm/gtx/vector_query.hpp"
+
 namespace nanoem {
 namespace model {
 
@@ -44,6 +47,10 @@ Morph::resetLanguage(
     if (m_name.empty()) {
         m_name = m_canonicalName;
     }
+    /* the name of the morph may be changed so the motion track must be resolved again */
+    m_resolvedMotion = nullptr;
+    m_motionTrack = nullptr;
+    m_motionCursor.reset();
 }
 
 void
@@ -59,9 +66,11 @@ Morph::synchronizeMotion(
 {
     nanoem_parameter_assert(name, "must not be nullptr");
     nanoem_f32_t w0, w1;
-    synchronizeWeight(motion, frameIndex, name, w0);
+    const nanoem_motion_track_t *track = motionTrack(motion, name);
+    nanoem_motion_keyframe_cursor_t *cursor = m_motionCursor.resolve(motion);
+    synchronizeWeight(track, cursor, frameIndex, w0);
     if (amount > 0) {
-        synchronizeWeight(motion, frameIndex + 1, name, w1);
+        synchronizeWeight(track, cursor, frameIndex + 1, w1);
         setWeight(glm::mix(w0, w1, amount));
     }
     else {
@@ -69,6 +78,28 @@ Morph::synchronizeMotion(
     }
 }
 
+void
+Morph::resolveMotionTrack(const Motion *motion, const nanoem_unicode_string_t *name) NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_motion_t *opaque = motion ? motion->data() : nullptr;
+    m_motionTrack = nanoemMotionResolveMorphTrack(opaque, name);
+    m_numResolvedMotionTracks = nanoemMotionGetNumMorphTracks(opaque);
+    m_resolvedMotion = opaque;
+    m_resolvedName = name;
+}
+
+const nanoem_motion_track_t *
+Morph::motionTrack(const Motion *motion, const nanoem_unicode_string_t *name) NANOEM_DECL_NOEXCEPT
+{
+    const nanoem_motion_t *opaque = motion ? motion->data() : nullptr;
+    /* a track is never removed but may be created after resolving so recheck only when it's not found */
+    if (m_resolvedMotion != opaque || m_resolvedName != name ||
+        (!m_motionTrack && m_numResolvedMotionTracks != nanoemMotionGetNumMorphTracks(opaque))) {
+        resolveMotionTrack(motion, name);
+    }
+    return m_motionTrack;
+}
+
 int
 Morph::index(const nanoem_model_morph_t *morphPtr) NANOEM_DECL_NOEXCEPT
 {
@@ -128,6 +159,41 @@ Morph::canonicalNameConstString() const NANOEM_DECL_NOEXCEPT
     return m_canonicalName.c_str();
 }
 
+void
+Morph::deformAllVertices(const nanoem_model_morph_t *morph, nanoem_f32_t weight)
+{
+    nanoem_parameter_assert(morph, "must not be nullptr");
+    if (!m_deltaResolved) {
+        resolveAllVertexDeltas(morph);
+    }
+    Vertex *const *vertices = m_deltaVertices.data();
+    const bx::simd128_t *deltas = m_deltas.data();
+    const bx::simd128_t w = bx::simd_splat(weight);
+    const nanoem_rsize_t numDeltas = m_deltas.size();
+    if (m_deltaIndex < 0) {
+        for (nanoem_rsize_t i = 0; i < numDeltas; i++) {
+            Vertex::SIMD &v = vertices[i]->m_simd;
+            v.m_delta = bx::simd_madd(deltas[i], w, v.m_delta);
+        }
+    }
+    else {
+        const int index = m_deltaIndex;
+        for (nanoem_rsize_t i = 0; i < numDeltas; i++) {
+            Vertex::SIMD &v = vertices[i]->m_simd;
+            v.m_deltaUVA[index] = bx::simd_madd(deltas[i], w, v.m_deltaUVA[index]);
+        }
+    }
+}
+
+void
+Morph::invalidateAllVertexDeltas()
+{
+    m_deltaVertices.clear();
+    m_deltas.clear();
+    m_deltaIndex = -1;
+    m_deltaResolved = false;
+}
+
 bool
 Morph::isDirty() const NANOEM_DECL_NOEXCEPT
 {
@@ -176,16 +242,16 @@ Morph::destroy(void *opaque, nanoem_model_object_t * /* morph */) NANOEM_DECL_NO
 }
 
 void
-Morph::synchronizeWeight(
-    const Motion *motion, nanoem_frame_index_t frameIndex, const nanoem_unicode_string_t *name, nanoem_f32_t &weight)
+Morph::synchronizeWeight(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor,
+    nanoem_frame_index_t frameIndex, nanoem_f32_t &weight)
 {
-    nanoem_parameter_assert(name, "must not be nullptr");
-    if (const nanoem_motion_morph_keyframe_t *keyframe = motion->findMorphKeyframe(name, frameIndex)) {
+    if (const nanoem_motion_morph_keyframe_t *keyframe =
+            nanoemMotionTrackFindMorphKeyframeObjectWithCursor(track, cursor, frameIndex)) {
         weight = nanoemMotionMorphKeyframeGetWeight(keyframe);
     }
     else {
         nanoem_motion_morph_keyframe_t *prevKeyframe, *nextKeyframe;
-        nanoemMotionSearchClosestMorphKeyframes(motion->data(), name, frameIndex, &prevKeyframe, &nextKeyframe);
+        nanoemMotionTrackSearchClosestMorphKeyframesWithCursor(track, cursor, frameIndex, &prevKeyframe, &nextKeyframe);
         if (prevKeyframe && nextKeyframe) {
             const nanoem_f32_t &coef = Motion::coefficient(prevKeyframe, nextKeyframe, frameIndex);
             weight = glm::mix(nanoemMotionMorphKeyframeGetWeight(prevKeyframe),
@@ -197,7 +263,50 @@ Morph::synchronizeWeight(
     }
 }
 
-Morph::Morph(const PlaceHolder & /* holder */) NANOEM_DECL_NOEXCEPT : m_weight(0), m_dirty(false)
+void
+Morph::resolveAllVertexDeltas(const nanoem_model_morph_t *morph)
+{
+    /* packs the vertices and their offsets into the streams to skip resolving them and zero offsets at each deform */
+    const nanoem_model_morph_type_t type = nanoemModelMorphGetType(morph);
+    nanoem_rsize_t numChildren;
+    invalidateAllVertexDeltas();
+    if (type == NANOEM_MODEL_MORPH_TYPE_VERTEX) {
+        const nanoem_model_morph_vertex_t *const *children =
+            nanoemModelMorphGetAllVertexMorphObjects(morph, &numChildren);
+        for (nanoem_rsize_t i = 0; i < numChildren; i++) {
+            const nanoem_model_morph_vertex_t *child = children[i];
+            const nanoem_f32_t *position = nanoemModelMorphVertexGetPosition(child);
+            Vertex *vertex = Vertex::cast(nanoemModelMorphVertexGetVertexObject(child));
+            if (vertex && !glm::isNull(glm::make_vec3(position), 0.0f)) {
+                m_deltaVertices.push_back(vertex);
+                m_deltas.push_back(bx::simd_ld(position[0], position[1], position[2], 0));
+            }
+        }
+    }
+    else if (type >= NANOEM_MODEL_MORPH_TYPE_TEXTURE && type <= NANOEM_MODEL_MORPH_TYPE_UVA4) {
+        const nanoem_model_morph_uv_t *const *children = nanoemModelMorphGetAllUVMorphObjects(morph, &numChildren);
+        for (nanoem_rsize_t i = 0; i < numChildren; i++) {
+            const nanoem_model_morph_uv_t *child = children[i];
+            const nanoem_f32_t *position = nanoemModelMorphUVGetPosition(child);
+            Vertex *vertex = Vertex::cast(nanoemModelMorphUVGetVertexObject(child));
+            if (vertex && !glm::isNull(glm::make_vec4(position), 0.0f)) {
+                m_deltaVertices.push_back(vertex);
+                m_deltas.push_back(bx::simd_ld(position[0], position[1], position[2], position[3]));
+            }
+        }
+        m_deltaIndex = static_cast<int>(type) - static_cast<int>(NANOEM_MODEL_MORPH_TYPE_TEXTURE);
+    }
+    m_deltaResolved = true;
+}
+
+Morph::Morph(const PlaceHolder & /* holder */) NANOEM_DECL_NOEXCEPT : m_resolvedMotion(nullptr),
+                                                                      m_resolvedName(nullptr),
+                                                                      m_motionTrack(nullptr),
+                                                                      m_numResolvedMotionTracks(0),
+                                                                      m_deltaIndex(-1),
+                                                                      m_weight(0),
+                                                                      m_dirty(false),
+                                                                      m_deltaResolved(false)
 {
 }
 
@@ -442,6 +442,13 @@ RigidBody::worldTransform() const NANOEM_DECL_NOEXCEPT
     return value;
 }
 
+void
+RigidBody::setWorldTransform(const Matrix4x4 &value) NANOEM_DECL_NOEXCEPT
+{
+    nanoem_physics_motion_state_t *state = m_physicsEngine->motionState(m_physicsRigidBody);
+    m_physicsEngine->setWorldTransform(state, glm::value_ptr(value));
+}
+
 Matrix4x4
 RigidBody::initialTransform() const NANOEM_DECL_NOEXCEPT
 {
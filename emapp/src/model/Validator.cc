@@ -11,6 +11,7 @@
 #include "emapp/Model.h"
 #include "emapp/Project.h"
 #include "emapp/StringUtils.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
 #include "emapp/model/Joint.h"
 #include "emapp/model/Label.h"
 #include "emapp/model/SoftBody.h"
@@ -25,6 +26,9 @@ static const char kUnknownName[] = "(unknown)";
 
 } /* anonymous namespace */
 
+const nanoem_rsize_t Validator::kNumVerticesPerChunk = 4096;
+const nanoem_rsize_t Validator::kNumFacesPerChunk = 4096;
+
 bool
 Validator::validateParentBone(
     const nanoem_model_bone_t *bonePtr, const nanoem_model_bone_t *parentBonePtr) NANOEM_DECL_NOEXCEPT
@@ -205,26 +209,138 @@ Validator::validateNameInShiftJIS(const nanoem_unicode_string_t *value, nanoem_r
 }
 
 Validator::Validator()
+    : m_dispatcher(nullptr)
+    , m_model(nullptr)
+    , m_filter(0)
+    , m_generation(0)
 {
+    m_dispatcher = nanoem_new(internal::ParallelTaskDispatcher("com.github.nanoem.gcd.model.validator"));
 }
 
 Validator::~Validator() NANOEM_DECL_NOEXCEPT
 {
+    nanoem_delete_safe(m_dispatcher);
 }
 
 void
 Validator::validate(const Model *model, nanoem_u32_t filter, DiagnosticsList &result)
 {
-    validateModelInfo(model, filter, result);
-    validateAllVertexObjects(model, filter, result);
-    validateAllFaces(model, filter, result);
-    validateAllMaterialObjects(model, filter, result);
-    validateAllBoneObjects(model, filter, result);
-    validateAllLabelObjects(model, filter, result);
-    validateAllMorphObjects(model, filter, result);
-    validateAllRigidBodyObjects(model, filter, result);
-    validateAllJointObjects(model, filter, result);
-    validateAllSoftBodyObjects(model, filter, result);
+    const nanoem_model_t *opaque = model->data();
+    nanoem_rsize_t numIndices, numObjects;
+    const nanoem_u32_t *indices = nanoemModelGetAllVertexIndices(opaque, &numIndices);
+    const bool reset = m_model != model || m_filter != filter || model->allObjectsEditGeneration() > m_generation;
+    if (reset) {
+        invalidate();
+    }
+    /* objects inserted, removed or reordered change the object list itself */
+    bool changed[Model::kEditObjectTypeMaxEnum];
+    changed[Model::kEditObjectTypeModel] = true;
+    changed[Model::kEditObjectTypeVertex] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllVertexObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeVertex]);
+    changed[Model::kEditObjectTypeFace] = updateVertexIndexList(indices, numIndices, m_vertexIndices);
+    changed[Model::kEditObjectTypeMaterial] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllMaterialObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeMaterial]);
+    changed[Model::kEditObjectTypeBone] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllBoneObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeBone]);
+    changed[Model::kEditObjectTypeMorph] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllMorphObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeMorph]);
+    changed[Model::kEditObjectTypeLabel] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllLabelObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeLabel]);
+    changed[Model::kEditObjectTypeRigidBody] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllRigidBodyObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeRigidBody]);
+    changed[Model::kEditObjectTypeJoint] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllJointObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeJoint]);
+    changed[Model::kEditObjectTypeSoftBody] = updateObjectList(
+        reinterpret_cast<const void *const *>(nanoemModelGetAllSoftBodyObjects(opaque, &numObjects)), numObjects,
+        m_objects[Model::kEditObjectTypeSoftBody]);
+    /* some checks refer objects of the other type so these must be revalidated together */
+    changed[Model::kEditObjectTypeFace] |= changed[Model::kEditObjectTypeVertex];
+    changed[Model::kEditObjectTypeMaterial] |= changed[Model::kEditObjectTypeFace];
+    changed[Model::kEditObjectTypeLabel] |= changed[Model::kEditObjectTypeBone] || changed[Model::kEditObjectTypeMorph];
+    for (int i = Model::kEditObjectTypeFirstEnum; i < Model::kEditObjectTypeMaxEnum; i++) {
+        const Model::EditObjectType type = static_cast<Model::EditObjectType>(i);
+        if (reset || (type != Model::kEditObjectTypeVertex && isEdited(model, type))) {
+            changed[type] = true;
+        }
+    }
+    /* vertices refer bones so all of them are revalidated when any bone is changed */
+    TaskList tasks;
+    addAllVertexTasks(
+        model, filter, changed[Model::kEditObjectTypeVertex] || changed[Model::kEditObjectTypeBone], tasks);
+    if (changed[Model::kEditObjectTypeFace]) {
+        addAllFaceTasks(model, filter, tasks);
+    }
+    if (!tasks.empty()) {
+        m_dispatcher->dispatch(handleValidationTask, tasks.data(), tasks.size());
+    }
+    /* names are converted with the shared unicode string factory so the rest are validated serially */
+    if (changed[Model::kEditObjectTypeModel]) {
+        m_diagnostics[Model::kEditObjectTypeModel].clear();
+        validateModelInfo(model, filter, m_diagnostics[Model::kEditObjectTypeModel]);
+    }
+    if (changed[Model::kEditObjectTypeMaterial]) {
+        m_diagnostics[Model::kEditObjectTypeMaterial].clear();
+        validateAllMaterialObjects(model, filter, m_diagnostics[Model::kEditObjectTypeMaterial]);
+    }
+    if (changed[Model::kEditObjectTypeBone]) {
+        m_diagnostics[Model::kEditObjectTypeBone].clear();
+        validateAllBoneObjects(model, filter, m_diagnostics[Model::kEditObjectTypeBone]);
+    }
+    if (changed[Model::kEditObjectTypeLabel]) {
+        m_diagnostics[Model::kEditObjectTypeLabel].clear();
+        validateAllLabelObjects(model, filter, m_diagnostics[Model::kEditObjectTypeLabel]);
+    }
+    if (changed[Model::kEditObjectTypeMorph]) {
+        m_diagnostics[Model::kEditObjectTypeMorph].clear();
+        validateAllMorphObjects(model, filter, m_diagnostics[Model::kEditObjectTypeMorph]);
+    }
+    if (changed[Model::kEditObjectTypeRigidBody]) {
+        m_diagnostics[Model::kEditObjectTypeRigidBody].clear();
+        validateAllRigidBodyObjects(model, filter, m_diagnostics[Model::kEditObjectTypeRigidBody]);
+    }
+    if (changed[Model::kEditObjectTypeJoint]) {
+        m_diagnostics[Model::kEditObjectTypeJoint].clear();
+        validateAllJointObjects(model, filter, m_diagnostics[Model::kEditObjectTypeJoint]);
+    }
+    if (changed[Model::kEditObjectTypeSoftBody]) {
+        m_diagnostics[Model::kEditObjectTypeSoftBody].clear();
+        validateAllSoftBodyObjects(model, filter, m_diagnostics[Model::kEditObjectTypeSoftBody]);
+    }
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeModel], result);
+    appendAllDiagnostics(m_vertexChunkDiagnostics, result);
+    appendAllDiagnostics(m_faceChunkDiagnostics, result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeFace], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeMaterial], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeBone], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeLabel], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeMorph], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeRigidBody], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeJoint], result);
+    appendAllDiagnostics(m_diagnostics[Model::kEditObjectTypeSoftBody], result);
+    m_model = model;
+    m_filter = filter;
+    m_generation = model->editGeneration();
+}
+
+void
+Validator::invalidate()
+{
+    for (int i = Model::kEditObjectTypeFirstEnum; i < Model::kEditObjectTypeMaxEnum; i++) {
+        m_objects[i].clear();
+        m_diagnostics[i].clear();
+    }
+    m_vertexIndices.clear();
+    m_vertexChunkDiagnostics.clear();
+    m_faceChunkDiagnostics.clear();
+    m_model = nullptr;
+    m_generation = 0;
 }
 
 void
@@ -537,12 +653,145 @@ Validator::validateModelInfo(const Model *model, nanoem_u32_t filter, Diagnostic
 }
 
 void
-Validator::validateAllVertexObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result)
+Validator::handleValidationTask(void *opaque, size_t index)
+{
+    const Task &task = static_cast<const Task *>(opaque)[index];
+    task.m_result->clear();
+    switch (task.m_type) {
+    case Model::kEditObjectTypeVertex: {
+        validateAllVertexObjects(task.m_model, task.m_offset, task.m_size, task.m_filter, *task.m_result);
+        break;
+    }
+    case Model::kEditObjectTypeFace: {
+        validateAllFaces(task.m_model, task.m_offset, task.m_size, task.m_filter, *task.m_result);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void
+Validator::appendAllDiagnostics(const DiagnosticsListArray &source, DiagnosticsList &result)
+{
+    for (DiagnosticsListArray::const_iterator it = source.begin(), end = source.end(); it != end; ++it) {
+        appendAllDiagnostics(*it, result);
+    }
+}
+
+void
+Validator::appendAllDiagnostics(const DiagnosticsList &source, DiagnosticsList &result)
+{
+    result.insert(result.end(), source.begin(), source.end());
+}
+
+bool
+Validator::updateObjectList(const void *const *objects, nanoem_rsize_t numObjects, ObjectList &cachedObjects)
+{
+    bool changed = false;
+    if (cachedObjects.size() != numObjects ||
+        (numObjects > 0 && memcmp(cachedObjects.data(), objects, sizeof(*objects) * numObjects) != 0)) {
+        cachedObjects.resize(numObjects);
+        if (numObjects > 0) {
+            memcpy(cachedObjects.data(), objects, sizeof(*objects) * numObjects);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool
+Validator::updateVertexIndexList(
+    const nanoem_u32_t *indices, nanoem_rsize_t numIndices, VertexIndexList &cachedIndices)
+{
+    bool changed = false;
+    if (cachedIndices.size() != numIndices ||
+        (numIndices > 0 && memcmp(cachedIndices.data(), indices, sizeof(*indices) * numIndices) != 0)) {
+        cachedIndices.resize(numIndices);
+        if (numIndices > 0) {
+            memcpy(cachedIndices.data(), indices, sizeof(*indices) * numIndices);
+        }
+        changed = true;
+    }
+    return changed;
+}
+
+bool
+Validator::isEdited(const Model *model, Model::EditObjectType type) const NANOEM_DECL_NOEXCEPT
+{
+    return model->lastEditGeneration(type) > m_generation;
+}
+
+void
+Validator::addAllVertexTasks(const Model *model, nanoem_u32_t filter, bool structureChanged, TaskList &tasks)
+{
+    nanoem_rsize_t numVertices;
+    nanoemModelGetAllVertexObjects(model->data(), &numVertices);
+    const nanoem_rsize_t numChunks = (numVertices + kNumVerticesPerChunk - 1) / kNumVerticesPerChunk;
+    ByteArray dirtyChunks(numChunks);
+    if (numChunks > 0) {
+        memset(dirtyChunks.data(), structureChanged ? 1 : 0, numChunks);
+    }
+    if (structureChanged) {
+        m_vertexChunkDiagnostics.clear();
+        m_vertexChunkDiagnostics.resize(numChunks);
+    }
+    else if (isEdited(model, Model::kEditObjectTypeVertex)) {
+        model::Vertex::List vertices;
+        model->getAllEditedVertexObjects(m_generation, vertices);
+        for (model::Vertex::List::const_iterator it = vertices.begin(), end = vertices.end(); it != end; ++it) {
+            const int index = model::Vertex::index(*it);
+            if (index >= 0 && nanoem_rsize_t(index) < numVertices) {
+                dirtyChunks[index / kNumVerticesPerChunk] = 1;
+            }
+        }
+    }
+    for (nanoem_rsize_t i = 0; i < numChunks; i++) {
+        if (dirtyChunks[i]) {
+            const nanoem_rsize_t offset = i * kNumVerticesPerChunk;
+            Task task = { Model::kEditObjectTypeVertex, model, offset,
+                glm::min(numVertices - offset, kNumVerticesPerChunk), filter, &m_vertexChunkDiagnostics[i] };
+            tasks.push_back(task);
+        }
+    }
+}
+
+void
+Validator::addAllFaceTasks(const Model *model, nanoem_u32_t filter, TaskList &tasks)
+{
+    nanoem_rsize_t numIndices;
+    nanoemModelGetAllVertexIndices(model->data(), &numIndices);
+    DiagnosticsList &result = m_diagnostics[Model::kEditObjectTypeFace];
+    Diagnostics diag;
+    diag.u.m_vertexPtr = nullptr;
+    result.clear();
+    m_faceChunkDiagnostics.clear();
+    if (numIndices % 3 != 0 && testDiagnosticsSeverity(kSeverityTypeFatal, filter, &diag)) {
+        diag.m_message = kMessageTypeFaceNotTriangulated;
+        result.push_back(diag);
+    }
+    else {
+        const nanoem_rsize_t numFaces = numIndices / 3,
+                             numChunks = (numFaces + kNumFacesPerChunk - 1) / kNumFacesPerChunk;
+        m_faceChunkDiagnostics.resize(numChunks);
+        for (nanoem_rsize_t i = 0; i < numChunks; i++) {
+            const nanoem_rsize_t offset = i * kNumFacesPerChunk;
+            Task task = { Model::kEditObjectTypeFace, model, offset, glm::min(numFaces - offset, kNumFacesPerChunk),
+                filter, &m_faceChunkDiagnostics[i] };
+            tasks.push_back(task);
+        }
+        validateAllUnusedVertexObjects(model, filter, result);
+    }
+}
+
+void
+Validator::validateAllVertexObjects(const Model *model, nanoem_rsize_t offset, nanoem_rsize_t size,
+    nanoem_u32_t filter, DiagnosticsList &result)
 {
     nanoem_rsize_t numVertices;
     nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(model->data(), &numVertices);
     Diagnostics diag;
-    for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+    for (nanoem_rsize_t i = offset, last = glm::min(offset + size, numVertices); i < last; i++) {
         const nanoem_model_vertex_t *vertexPtr = vertices[i];
         diag.u.m_vertexPtr = vertexPtr;
         if (!validateVector3(nanoemModelVertexGetOrigin(vertexPtr), filter, &diag)) {
@@ -610,49 +859,57 @@ Validator::validateAllVertexObjects(const Model *model, nanoem_u32_t filter, Dia
 }
 
 void
-Validator::validateAllFaces(const Model *model, nanoem_u32_t filter, DiagnosticsList &result)
+Validator::validateAllFaces(const Model *model, nanoem_rsize_t offset, nanoem_rsize_t size, nanoem_u32_t filter,
+    DiagnosticsList &result)
 {
     nanoem_rsize_t numVertices, numIndices;
     nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(model->data(), &numVertices);
     const nanoem_u32_t *indices = nanoemModelGetAllVertexIndices(model->data(), &numIndices);
     Diagnostics diag;
     diag.u.m_vertexPtr = nullptr;
-    if (numIndices % 3 != 0 && testDiagnosticsSeverity(kSeverityTypeFatal, filter, &diag)) {
-        diag.m_message = kMessageTypeFaceNotTriangulated;
-        result.push_back(diag);
-    }
-    else {
-        typedef tinystl::unordered_set<int, TinySTLAllocator> VertexIndexSet;
-        VertexIndexSet vertexIndexSet;
-        for (nanoem_rsize_t i = 0; i < numVertices; i++) {
-            int vertexIndex = model::Vertex::index(vertices[i]);
-            if (vertexIndex >= 0) {
-                vertexIndexSet.insert(vertexIndex);
-            }
-        }
-        for (nanoem_rsize_t i = 0; i < numIndices; i += 3) {
-            for (nanoem_rsize_t j = 0; j < 3; j++) {
-                nanoem_u32_t vertexIndex = indices[i + j];
-                if (vertexIndex < numVertices) {
-                    const nanoem_model_vertex_t *vertexPtr = vertices[vertexIndex];
-                    if (vertexPtr == nullptr && testDiagnosticsSeverity(kSeverityTypeError, filter, &diag)) {
-                        diag.m_message = kMessageTypeFaceNullVertexObject;
-                        result.push_back(diag);
-                    }
-                }
-                else if (testDiagnosticsSeverity(kSeverityTypeError, filter, &diag)) {
-                    diag.m_message = kMessageTypeFaceVertexObjectOutOfBound;
+    for (nanoem_rsize_t i = offset * 3, last = glm::min((offset + size) * 3, numIndices - numIndices % 3); i < last;
+         i += 3) {
+        for (nanoem_rsize_t j = 0; j < 3; j++) {
+            nanoem_u32_t vertexIndex = indices[i + j];
+            if (vertexIndex < numVertices) {
+                const nanoem_model_vertex_t *vertexPtr = vertices[vertexIndex];
+                if (vertexPtr == nullptr && testDiagnosticsSeverity(kSeverityTypeError, filter, &diag)) {
+                    diag.m_message = kMessageTypeFaceNullVertexObject;
                     result.push_back(diag);
                 }
-                vertexIndexSet.erase(vertexIndex);
+            }
+            else if (testDiagnosticsSeverity(kSeverityTypeError, filter, &diag)) {
+                diag.m_message = kMessageTypeFaceVertexObjectOutOfBound;
+                result.push_back(diag);
+            }
+        }
+    }
+}
+
+void
+Validator::validateAllUnusedVertexObjects(const Model *model, nanoem_u32_t filter, DiagnosticsList &result)
+{
+    nanoem_rsize_t numVertices, numIndices;
+    nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(model->data(), &numVertices);
+    const nanoem_u32_t *indices = nanoemModelGetAllVertexIndices(model->data(), &numIndices);
+    Diagnostics diag;
+    diag.u.m_vertexPtr = nullptr;
+    if (testDiagnosticsSeverity(kSeverityTypeInfo, filter, &diag)) {
+        /* a flag per vertex is used instead of the set of vertex indices to report these in the index order */
+        ByteArray usedVertices(numVertices);
+        if (numVertices > 0) {
+            memset(usedVertices.data(), 0, numVertices);
+        }
+        for (nanoem_rsize_t i = 0, last = numIndices - numIndices % 3; i < last; i++) {
+            const nanoem_u32_t vertexIndex = indices[i];
+            if (vertexIndex < numVertices) {
+                usedVertices[vertexIndex] = 1;
             }
         }
-        if (!vertexIndexSet.empty() && testDiagnosticsSeverity(kSeverityTypeInfo, filter, &diag)) {
-            diag.m_message = kMessageTypeFaceVertexObjectNotUsed;
-            for (VertexIndexSet::const_iterator it = vertexIndexSet.begin(), end = vertexIndexSet.end(); it != end;
-                 ++it) {
-                const nanoem_model_vertex_t *vertexPtr = vertices[*it];
-                diag.u.m_vertexPtr = vertexPtr;
+        diag.m_message = kMessageTypeFaceVertexObjectNotUsed;
+        for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+            if (!usedVertices[i]) {
+                diag.u.m_vertexPtr = vertices[i];
                 result.push_back(diag);
             }
         }
@@ -104,6 +104,7 @@ Vertex::setupBoneBinding(nanoem_model_vertex_t *vertexPtr, Model *model)
     default:
         break;
     }
+    model->invalidateAllSkinningBatches();
 }
 
 int
@@ -212,8 +213,8 @@ Vertex::deform(const nanoem_model_morph_vertex_t *morph, nanoem_f32_t weight) NA
 void
 Vertex::deform(const nanoem_model_morph_uv_t *morph, int index, nanoem_f32_t weight) NANOEM_DECL_NOEXCEPT
 {
-    m_simd.m_deltaUVA[index] = bx::simd_add(
-        m_simd.m_delta, bx::simd_mul(bx::simd_ld(nanoemModelMorphUVGetPosition(morph)), bx::simd_splat(weight)));
+    m_simd.m_deltaUVA[index] = bx::simd_add(m_simd.m_deltaUVA[index],
+        bx::simd_mul(bx::simd_ld(nanoemModelMorphUVGetPosition(morph)), bx::simd_splat(weight)));
 }
 
 void
@@ -7,6 +7,7 @@
 #include "emapp/plugin/EffectPlugin.h"
 
 #include "emapp/Error.h"
+#include "emapp/FileUtils.h"
 #include "emapp/IEventPublisher.h"
 #include "emapp/StringUtils.h"
 #include "emapp/URI.h"
@@ -19,6 +20,7 @@ namespace plugin {
 EffectPlugin::EffectPlugin(IEventPublisher *publisher)
     : BasePlugin(publisher)
     , m_compiler(nullptr)
+    , m_revision(0)
     , _effectCompilerInitialize(nullptr)
     , _effectCompilerCreate(nullptr)
     , _effectCompilerGetOption(nullptr)
@@ -59,6 +61,7 @@ EffectPlugin::load(const URI &fileURI)
     _effectCompilerDestroyBinary = nanoemApplicationPluginEffectCompilerDestroyBinary;
     _effectCompilerDestroy = nanoemApplicationPluginEffectCompilerDestroy;
     _effectCompilerTerminate = nanoemApplicationPluginEffectCompilerTerminate;
+    m_revision = nanoemApplicationPluginEffectCompilerGetABIVersion();
     _effectCompilerInitialize();
 #else /* NANOEM_ENABLE_STATIC_BUNDLE_PLUGIN */
     bool succeeded = m_handle != nullptr;
@@ -98,6 +101,7 @@ EffectPlugin::load(const URI &fileURI)
                     _effectCompilerGetABIVersion(), NANOEM_APPLICATION_PLUGIN_EFFECT_COMPILER_ABI_VERSION_MAJOR)) {
                 m_handle = handle;
                 m_name = fileURI.lastPathComponent();
+                m_revision = FileUtils::timestamp(fileURI) ^ _effectCompilerGetABIVersion();
                 _effectCompilerInitialize();
                 succeeded = true;
             }
@@ -216,6 +220,12 @@ EffectPlugin::availableExtensions() const
     return extensionList;
 }
 
+nanoem_u64_t
+EffectPlugin::revision() const NANOEM_DECL_NOEXCEPT
+{
+    return m_revision;
+}
+
 const char *
 EffectPlugin::failureReason() const NANOEM_DECL_NOEXCEPT
 {
@@ -7,6 +7,8 @@
 #include "../common.h"
 
 #include <assert.h>
+#include <algorithm>
+#include <vector>
 
 #include "emapp/emapp.h"
 #include "emapp/internal/StubEventPublisher.h"
@@ -23,6 +25,9 @@ using namespace nanoem;
 
 namespace test {
 
+/* projects whose journal may be still writing the redo file to be recovered */
+static std::vector<Project *> s_recoverableProjects;
+
 class FileManager : public DefaultFileManager {
 public:
     FileManager(BaseApplicationService *applicationPtr);
@@ -109,6 +114,8 @@ TestScope::Object::Object(BaseApplicationService *applicationPtr)
 
 TestScope::Object::~Object()
 {
+    std::vector<Project *> &projects = s_recoverableProjects;
+    projects.erase(std::remove(projects.begin(), projects.end(), m_project), projects.end());
     m_applicationPtr->destroyProject(m_project);
     m_project = nullptr;
 }
@@ -277,6 +284,7 @@ TestScope::Object::withRecoverable(const char *path)
 {
     FileUtils::deleteFile(path);
     m_project->setRedoFileURI(URI::createFromFilePath(path));
+    s_recoverableProjects.push_back(m_project);
     return m_project;
 }
 
@@ -506,8 +514,17 @@ void
 TestScope::recover(Project *project, const char *path)
 {
     Error error;
+    const URI fileURI(URI::createFromFilePath(path));
+    for (std::vector<Project *>::const_iterator it = s_recoverableProjects.begin(), end = s_recoverableProjects.end();
+         it != end; ++it) {
+        Project *recoverableProject = *it;
+        if (recoverableProject->redoFileURI().equalsTo(fileURI)) {
+            /* records are written on the journal thread so they must be drained before reading */
+            recoverableProject->flushRedoJournal(error);
+        }
+    }
     IFileReader *reader = FileUtils::createFileReader(m_application->translator());
-    bool result = reader->open(URI::createFromFilePath(path), error);
+    bool result = reader->open(fileURI, error);
     BX_UNUSED_1(result);
     assert(result);
     internal::project::Redo redo(project);
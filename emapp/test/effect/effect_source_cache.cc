@@ -0,0 +1,136 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/FileUtils.h"
+#include "emapp/effect/SourceCache.h"
+
+using namespace nanoem;
+
+namespace {
+
+/* the cache keeps its own index file so it must not share the output directory with other tests */
+static const char kCacheDirectoryPath[] = NANOEM_TEST_OUTPUT_PATH "/effect_source_cache";
+
+static void
+writeSource(const URI &fileURI, const char *source)
+{
+    FILE *fp = fopen(fileURI.absolutePathConstString(), "wb");
+    REQUIRE(fp);
+    fwrite(source, strlen(source), 1, fp);
+    fclose(fp);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("effect_source_cache_parse_all_includes", "[emapp][effect]")
+{
+    static const char kSource[] = "#include \"a.fxsub\"\n"
+                                  "  #  include <b.fxh>\r\n"
+                                  "// #include \"c.fxsub\"\n"
+                                  "#include\n"
+                                  "#define include \"d.fxsub\"\n"
+                                  "\t#include \"../e.fx\"";
+    ByteArray bytes(sizeof(kSource) - 1);
+    memcpy(bytes.data(), kSource, bytes.size());
+    StringList includes;
+    effect::SourceCache::parseAllIncludes(bytes, includes);
+    REQUIRE(includes.size() == 3);
+    CHECK(includes[0] == String("a.fxsub"));
+    CHECK(includes[1] == String("b.fxh"));
+    CHECK(includes[2] == String("../e.fx"));
+}
+
+TEST_CASE("effect_source_cache_digest_all_sources", "[emapp][effect]")
+{
+    const URI fileURI(URI::createFromFilePath(NANOEM_TEST_FIXTURE_PATH "/effects/parameters/material/color.fx"));
+    effect::SourceCache::DependencyList dependencies;
+    effect::SourceCache::Digest digest0, digest1, digest2;
+    Error error;
+    CHECK(effect::SourceCache::digestAllSources(fileURI, "env0", nullptr, dependencies, digest0, error));
+    REQUIRE(dependencies.size() == 2);
+    CHECK(dependencies[0].m_path == fileURI.absolutePath());
+    CHECK(dependencies[1].m_path == String(NANOEM_TEST_FIXTURE_PATH "/effects/parameters/shaders.fx"));
+    CHECK(dependencies[1].m_size == FileUtils::fileSize(dependencies[1].m_path.c_str()));
+    dependencies.clear();
+    CHECK(effect::SourceCache::digestAllSources(fileURI, "env0", nullptr, dependencies, digest1, error));
+    CHECK(memcmp(digest0.m_value, digest1.m_value, sizeof(digest0.m_value)) == 0);
+    dependencies.clear();
+    CHECK(effect::SourceCache::digestAllSources(fileURI, "env1", nullptr, dependencies, digest2, error));
+    CHECK(memcmp(digest0.m_value, digest2.m_value, sizeof(digest0.m_value)) != 0);
+    CHECK_FALSE(error.hasReason());
+}
+
+TEST_CASE("effect_source_cache_find_and_save", "[emapp][effect]")
+{
+    const URI directoryURI(URI::createFromFilePath(kCacheDirectoryPath)),
+        colorURI(URI::createFromFilePath(NANOEM_TEST_FIXTURE_PATH "/effects/parameters/material/color.fx")),
+        texturesURI(URI::createFromFilePath(NANOEM_TEST_FIXTURE_PATH "/effects/parameters/material/textures.fx"));
+    ByteArray input(4096), output;
+    for (nanoem_rsize_t i = 0; i < input.size(); i++) {
+        input[i] = nanoem_u8_t(i % 7);
+    }
+    Error error;
+    effect::SourceCache cache(directoryURI, nullptr);
+    cache.setEnvironment("effect_source_cache_find_and_save");
+    SECTION("hit after save")
+    {
+        cache.save(colorURI, input, error);
+        REQUIRE_FALSE(error.hasReason());
+        CHECK(cache.find(colorURI, output, error));
+        REQUIRE(output.size() == input.size());
+        CHECK(memcmp(output.data(), input.data(), input.size()) == 0);
+    }
+    SECTION("miss with the different environment")
+    {
+        cache.save(colorURI, input, error);
+        cache.setEnvironment("effect_source_cache_find_and_save_another");
+        CHECK_FALSE(cache.find(colorURI, output, error));
+        CHECK_FALSE(error.hasReason());
+    }
+    SECTION("evict least recently used")
+    {
+        cache.setCapacity(1);
+        cache.save(colorURI, input, error);
+        cache.save(texturesURI, input, error);
+        REQUIRE_FALSE(error.hasReason());
+        CHECK_FALSE(cache.find(colorURI, output, error));
+        CHECK(cache.find(texturesURI, output, error));
+        CHECK(cache.usage() > 0);
+    }
+    SECTION("evict manifests with the blob")
+    {
+        cache.setCapacity(1);
+        cache.save(colorURI, input, error);
+        REQUIRE_FALSE(error.hasReason());
+        CHECK(FileUtils::exists(cache.resolveManifestFileURI(colorURI)));
+        cache.save(texturesURI, input, error);
+        REQUIRE_FALSE(error.hasReason());
+        CHECK_FALSE(FileUtils::exists(cache.resolveManifestFileURI(colorURI)));
+        CHECK(FileUtils::exists(cache.resolveManifestFileURI(texturesURI)));
+    }
+}
+
+TEST_CASE("effect_source_cache_unresolved_include", "[emapp][effect]")
+{
+    const URI directoryURI(URI::createFromFilePath(kCacheDirectoryPath)),
+        fileURI(URI::createFromFilePath(kCacheDirectoryPath "/unresolved.fx"));
+    writeSource(fileURI, "#include \"missing.fxsub\"\n");
+    effect::SourceCache::DependencyList dependencies;
+    effect::SourceCache::Digest digest;
+    ByteArray input(64), output;
+    Error error;
+    CHECK_FALSE(effect::SourceCache::digestAllSources(fileURI, "env0", nullptr, dependencies, digest, error));
+    CHECK_FALSE(error.hasReason());
+    effect::SourceCache cache(directoryURI, nullptr);
+    cache.setEnvironment("effect_source_cache_unresolved_include");
+    cache.save(fileURI, input, error);
+    CHECK_FALSE(error.hasReason());
+    CHECK_FALSE(FileUtils::exists(cache.resolveManifestFileURI(fileURI)));
+    CHECK_FALSE(cache.find(fileURI, output, error));
+    CHECK_FALSE(error.hasReason());
+}
@@ -0,0 +1,151 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Archiver.h"
+#include "emapp/FileUtils.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static const char kPNGSignature[] = "\x89PNG\r\n\x1a\n";
+
+static ByteArray
+createNoise(nanoem_rsize_t size, const char *signature = nullptr, nanoem_rsize_t length = 0)
+{
+    ByteArray bytes(size);
+    nanoem_u32_t seed = 0x1337;
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bytes[i] = nanoem_u8_t(seed >> 24);
+    }
+    if (signature) {
+        memcpy(bytes.data(), signature, length);
+    }
+    return bytes;
+}
+
+static ByteArray
+createText(nanoem_rsize_t size)
+{
+    static const char kText[] = "the quick brown fox jumps over the lazy dog\n";
+    ByteArray bytes(size);
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        bytes[i] = nanoem_u8_t(kText[i % (sizeof(kText) - 1)]);
+    }
+    return bytes;
+}
+
+static bool
+isSameBytes(const ByteArray &a, const ByteArray &b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size()) == 0);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("archiver_is_incompressible", "[emapp][misc]")
+{
+    static const char kJPEGSignature[] = "\xff\xd8\xff\xe0";
+    static const char kOggSignature[] = "OggS";
+    static const char kWebPSignature[] = "RIFF\x10\x00\x00\x00WEBP";
+    static const char kMP4Signature[] = "\x00\x00\x00\x18"
+                                        "ftypmp42";
+    CHECK(Archiver::isIncompressible(createNoise(64, kPNGSignature, sizeof(kPNGSignature) - 1).data(), 64));
+    CHECK(Archiver::isIncompressible(createNoise(64, kJPEGSignature, sizeof(kJPEGSignature) - 1).data(), 64));
+    CHECK(Archiver::isIncompressible(createNoise(64, kOggSignature, sizeof(kOggSignature) - 1).data(), 64));
+    CHECK(Archiver::isIncompressible(createNoise(64, kWebPSignature, sizeof(kWebPSignature) - 1).data(), 64));
+    CHECK(Archiver::isIncompressible(createNoise(64, kMP4Signature, sizeof(kMP4Signature) - 1).data(), 64));
+    static const char kMP3Signature[] = "\xff\xfb\x90\x64";
+    static const char kADTSSignature[] = "\xff\xf1\x50\x80";
+    CHECK(Archiver::isIncompressible(createNoise(64, kMP3Signature, sizeof(kMP3Signature) - 1).data(), 64));
+    CHECK(Archiver::isIncompressible(createNoise(64, kADTSSignature, sizeof(kADTSSignature) - 1).data(), 64));
+    CHECK_FALSE(Archiver::isIncompressible(createText(64).data(), 64));
+    /* UTF-16 text starting with BOM must not be taken as MPEG audio frame sync */
+    ByteArray utf16(createText(64));
+    for (nanoem_rsize_t i = 2; i < utf16.size(); i += 2) {
+        utf16[i] = utf16[i / 2];
+        utf16[i + 1] = 0;
+    }
+    utf16[0] = 0xff;
+    utf16[1] = 0xfe;
+    CHECK_FALSE(Archiver::isIncompressible(utf16.data(), utf16.size()));
+    utf16[1] = 0xff;
+    CHECK_FALSE(Archiver::isIncompressible(utf16.data(), utf16.size()));
+    CHECK_FALSE(Archiver::isIncompressible(createText(64).data(), 8));
+    ByteArray dds(createNoise(128, "DDS ", 4));
+    dds[80] = 0x4;
+    CHECK(Archiver::isIncompressible(dds.data(), dds.size()));
+    /* uncompressed DDS is deflated */
+    dds[80] = 0x40;
+    CHECK_FALSE(Archiver::isIncompressible(dds.data(), dds.size()));
+}
+
+TEST_CASE("archiver_add_and_extract_all_entries", "[emapp][misc]")
+{
+    static const char *const kPaths[] = { "text.txt", "image.png", "noise.bin", "empty.txt" };
+    ByteArrayList contents;
+    contents.push_back(createText(300000));
+    contents.push_back(createNoise(100000, kPNGSignature, sizeof(kPNGSignature) - 1));
+    contents.push_back(createNoise(50000));
+    contents.push_back(ByteArray());
+    ByteArray bytes;
+    Error error;
+    {
+        MemoryWriter writer(&bytes);
+        Archiver archiver(&writer);
+        REQUIRE(archiver.open(error));
+        for (nanoem_rsize_t i = 0; i < contents.size(); i++) {
+            Archiver::Entry entry;
+            entry.m_path = kPaths[i];
+            CHECK(archiver.addEntry(entry, contents[i], error));
+        }
+        CHECK(archiver.close(error));
+        CHECK_FALSE(error.hasReason());
+    }
+    MemoryReader reader(&bytes);
+    Archiver archiver(&reader);
+    REQUIRE(archiver.open(error));
+    const Archiver::EntryList &entries = archiver.allEntries(error);
+    REQUIRE(entries.size() == contents.size());
+    for (nanoem_rsize_t i = 0; i < entries.size(); i++) {
+        /* written in the added order even though they are compressed concurrently */
+        CHECK(entries[i].m_path == String(kPaths[i]));
+        CHECK(entries[i].m_uncompressedSize == contents[i].size());
+    }
+    CHECK(entries[0].m_compressedSize < entries[0].m_uncompressedSize);
+    CHECK(entries[1].m_compressedSize == entries[1].m_uncompressedSize);
+    CHECK(entries[2].m_compressedSize == entries[2].m_uncompressedSize);
+    Archiver::EntryList requests(entries);
+    Archiver::Entry missing;
+    missing.m_path = "missing.txt";
+    requests.push_back(missing);
+    ByteArrayList extracted;
+    CHECK(archiver.extractAll(entries, extracted, error));
+    CHECK_FALSE(error.hasReason());
+    /* the missing entry is reported but does not stop extracting the rest */
+    requests.insert(requests.begin(), missing);
+    CHECK_FALSE(archiver.extractAll(requests, extracted, error));
+    CHECK(error.hasReason());
+    CHECK(strstr(error.reasonConstString(), "missing.txt") != nullptr);
+    error = Error();
+    REQUIRE(extracted.size() == requests.size());
+    for (nanoem_rsize_t i = 0; i < contents.size(); i++) {
+        CHECK(isSameBytes(extracted[i + 1], contents[i]));
+    }
+    CHECK(extracted.front().empty());
+    CHECK(extracted.back().empty());
+    Archiver::Entry entry;
+    ByteArray single;
+    REQUIRE(archiver.findEntry("text.txt", entry, error));
+    CHECK(archiver.extract(entry, single, error));
+    CHECK(isSameBytes(single, contents[0]));
+    CHECK(archiver.close(error));
+    CHECK_FALSE(error.hasReason());
+}
@@ -0,0 +1,95 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/BezierCurve.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static nanoem_f32_t
+referenceValue(const Vector2 &c0, const Vector2 &c1, nanoem_f32_t x)
+{
+    nanoem_f64_t lower = 0, upper = 1, t = 0.5;
+    for (int i = 0; i < 64; i++) {
+        t = (lower + upper) * 0.5;
+        const nanoem_f64_t it = 1.0 - t, bx = (3 * it * it * t * c0.x + 3 * it * t * t * c1.x) / 127.0 + t * t * t;
+        if (bx < x) {
+            lower = t;
+        }
+        else {
+            upper = t;
+        }
+    }
+    const nanoem_f64_t it = 1.0 - t;
+    return nanoem_f32_t((3 * it * it * t * c0.y + 3 * it * t * t * c1.y) / 127.0 + t * t * t);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("beziercurve_value_linear", "[emapp][misc]")
+{
+    const BezierCurve curve(Vector2U8(20, 20), Vector2U8(107, 107), 30);
+    CHECK(curve.value(0.0f) == Approx(0.0f).margin(1e-5f));
+    CHECK(curve.value(0.25f) == Approx(0.25f).margin(1e-5f));
+    CHECK(curve.value(0.5f) == Approx(0.5f).margin(1e-5f));
+    CHECK(curve.value(1.0f) == Approx(1.0f).margin(1e-5f));
+    CHECK(curve.value(-1.0f) == Approx(0.0f).margin(1e-5f));
+    CHECK(curve.value(2.0f) == Approx(1.0f).margin(1e-5f));
+    CHECK(curve.length() == 30);
+}
+
+TEST_CASE("beziercurve_value_compare_reference", "[emapp][misc]")
+{
+    static const nanoem_u8_t kParameters[][4] = {
+        { 0, 0, 0, 0 },
+        { 127, 0, 127, 0 },
+        { 0, 127, 0, 127 },
+        { 127, 127, 0, 0 },
+        { 64, 0, 64, 127 },
+        { 10, 100, 30, 120 },
+    };
+    for (size_t i = 0; i < BX_COUNTOF(kParameters); i++) {
+        const nanoem_u8_t *p = kParameters[i];
+        const Vector2 c0(p[0], p[1]), c1(p[2], p[3]);
+        const BezierCurve curve(c0, c1, 16);
+        for (int j = 0; j <= 100; j++) {
+            const nanoem_f32_t x = j / 100.0f;
+            CHECK(curve.value(x) == Approx(referenceValue(c0, c1, x)).margin(1e-4f));
+        }
+    }
+}
+
+TEST_CASE("beziercurve_to_hash", "[emapp][misc]")
+{
+    static const nanoem_u8_t kParameters0[] = { 20, 20, 107, 107 }, kParameters1[] = { 107, 107, 20, 20 },
+                             kParameters2[] = { 20, 20, 107, 107 };
+    CHECK(BezierCurve::toHash(kParameters0, 30) != BezierCurve::toHash(kParameters1, 30));
+    CHECK(BezierCurve::toHash(kParameters0, 30) == BezierCurve::toHash(kParameters2, 30));
+    CHECK(BezierCurve::toHash(kParameters0, 30) != BezierCurve::toHash(kParameters0, 60));
+}
+
+TEST_CASE("beziercurve_resolve_with_interval", "[emapp][misc]")
+{
+    static const nanoem_u8_t kParameters[] = { 20, 20, 107, 107 };
+    TestScope scope;
+    {
+        ProjectPtr first = scope.createProject();
+        Project *project = first->m_project;
+        const BezierCurve *curve0 = project->resolveBezierCurve(kParameters, 30),
+                          *curve1 = project->resolveBezierCurve(kParameters, 60);
+        REQUIRE(curve0);
+        REQUIRE(curve1);
+        CHECK(curve0 != curve1);
+        CHECK(curve0->length() == 30);
+        CHECK(curve1->length() == 60);
+        CHECK(project->resolveBezierCurve(kParameters, 30) == curve0);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,164 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/FileUtils.h"
+#include "emapp/internal/ContentDigest.h"
+#include "emapp/internal/FileContentDigestCache.h"
+#include "emapp/internal/ParallelTaskDispatcher.h"
+
+using namespace nanoem;
+using namespace internal;
+
+namespace {
+
+static ByteArray
+createNoise(nanoem_rsize_t size)
+{
+    ByteArray bytes(size);
+    nanoem_u32_t seed = 0x1337;
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bytes[i] = nanoem_u8_t(seed >> 24);
+    }
+    return bytes;
+}
+
+static void
+writeFile(const URI &fileURI, const ByteArray &bytes)
+{
+    FILE *fp = fopen(fileURI.absolutePathConstString(), "wb");
+    REQUIRE(fp);
+    fwrite(bytes.data(), bytes.size(), 1, fp);
+    fclose(fp);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("content_digest_sha256", "[emapp][misc]")
+{
+    static const nanoem_u8_t kExpected[] = { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde,
+        0x5d, 0xae, 0x22, 0x23, 0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00,
+        0x15, 0xad };
+    const nanoem_u8_t *data = reinterpret_cast<const nanoem_u8_t *>("abc");
+    nanoem_u8_t digest[ContentDigest::kMaxDigestSize];
+    CHECK(ContentDigest::digestSize(ContentDigest::kAlgorithmTypeSHA256) == sizeof(kExpected));
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeSHA256, data, 3, nullptr, digest);
+    CHECK(memcmp(digest, kExpected, sizeof(kExpected)) == 0);
+    ContentDigest context(ContentDigest::kAlgorithmTypeSHA256);
+    context.update(data, 1);
+    context.update(data + 1, 2);
+    context.finalize(digest);
+    CHECK(memcmp(digest, kExpected, sizeof(kExpected)) == 0);
+}
+
+TEST_CASE("content_digest_fast128_streaming_equals_parallel", "[emapp][misc]")
+{
+    static const nanoem_rsize_t kSizes[] = { 0, 1, 16, ContentDigest::kFastChunkSize - 1,
+        ContentDigest::kFastChunkSize, ContentDigest::kFastChunkSize + 1, ContentDigest::kFastChunkSize * 3 + 42 };
+    const nanoem_rsize_t digestSize = ContentDigest::digestSize(ContentDigest::kAlgorithmTypeFast128);
+    CHECK(digestSize == 16);
+    ParallelTaskDispatcher dispatcher("com.github.nanoem.gcd.test.digest");
+    for (auto size : kSizes) {
+        const ByteArray bytes(createNoise(size));
+        nanoem_u8_t parallel[ContentDigest::kMaxDigestSize], serial[ContentDigest::kMaxDigestSize],
+            streaming[ContentDigest::kMaxDigestSize];
+        ContentDigest::calculate(ContentDigest::kAlgorithmTypeFast128, bytes.data(), size, &dispatcher, parallel);
+        ContentDigest::calculate(ContentDigest::kAlgorithmTypeFast128, bytes.data(), size, nullptr, serial);
+        /* odd sized updates straddle chunk boundaries */
+        ContentDigest context(ContentDigest::kAlgorithmTypeFast128);
+        for (nanoem_rsize_t offset = 0, step = 7777; offset < size; offset += step, step = step * 3 % 100003 + 1) {
+            context.update(bytes.data() + offset, glm::min(step, size - offset));
+        }
+        context.finalize(streaming);
+        INFO("size=" << size);
+        CHECK(memcmp(parallel, serial, digestSize) == 0);
+        CHECK(memcmp(parallel, streaming, digestSize) == 0);
+    }
+    nanoem_u8_t a[ContentDigest::kMaxDigestSize], b[ContentDigest::kMaxDigestSize];
+    ByteArray bytes(createNoise(ContentDigest::kFastChunkSize * 2));
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeFast128, bytes.data(), bytes.size(), &dispatcher, a);
+    bytes.back() ^= 0x1;
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeFast128, bytes.data(), bytes.size(), &dispatcher, b);
+    CHECK(memcmp(a, b, digestSize) != 0);
+}
+
+TEST_CASE("file_content_digest_cache_detects_modification", "[emapp][misc]")
+{
+    const URI fileURI(URI::createFromFilePath(NANOEM_TEST_OUTPUT_PATH "/file_content_digest_cache.bin"));
+    ByteArray bytes(createNoise(4096));
+    writeFile(fileURI, bytes);
+    FileContentDigestCache cache;
+    nanoem_u8_t expected[FileContentDigestCache::kDigestSize], actual[FileContentDigestCache::kDigestSize];
+    Error error;
+    cache.update(fileURI, bytes.data(), bytes.size());
+    CHECK(cache.numEntries() == 1);
+    REQUIRE(cache.calculate(fileURI, actual, error));
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeSHA256, bytes.data(), bytes.size(), nullptr, expected);
+    CHECK(memcmp(actual, expected, sizeof(expected)) == 0);
+    /* the same size is detected by the contents regardless of the resolution of the timestamp */
+    bytes[42] ^= 0x1;
+    writeFile(fileURI, bytes);
+    REQUIRE(cache.calculate(fileURI, actual, error));
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeSHA256, bytes.data(), bytes.size(), nullptr, expected);
+    CHECK(memcmp(actual, expected, sizeof(expected)) == 0);
+    bytes.push_back(0x42);
+    writeFile(fileURI, bytes);
+    REQUIRE(cache.calculate(fileURI, actual, error));
+    ContentDigest::calculate(ContentDigest::kAlgorithmTypeSHA256, bytes.data(), bytes.size(), nullptr, expected);
+    CHECK(memcmp(actual, expected, sizeof(expected)) == 0);
+    CHECK(cache.numEntries() == 1);
+    CHECK_FALSE(error.hasReason());
+    /* entries inside of archives are never cached */
+    const URI archivedURI(URI::createFromFilePath(fileURI.absolutePath(), "Model/model.pmx"));
+    cache.update(archivedURI, bytes.data(), bytes.size());
+    CHECK(cache.numEntries() == 1);
+    cache.clear();
+    CHECK(cache.numEntries() == 0);
+}
+
+TEST_CASE("file_content_digest_cache_prefetch_keeps_mapped_files", "[emapp][misc]")
+{
+    static const char *const kFilenames[] = { "/file_content_digest_prefetch_0.bin",
+        "/file_content_digest_prefetch_1.bin" };
+    FileContentDigestCache::URIList fileURIs;
+    ByteArrayList contents;
+    for (nanoem_rsize_t i = 0; i < BX_COUNTOF(kFilenames); i++) {
+        String path(NANOEM_TEST_OUTPUT_PATH);
+        path.append(kFilenames[i]);
+        const URI fileURI(URI::createFromFilePath(path));
+        contents.push_back(createNoise(ContentDigest::kFastChunkSize * (i + 1) + 123));
+        writeFile(fileURI, contents.back());
+        fileURIs.push_back(fileURI);
+    }
+    const URI missingURI(URI::createFromFilePath(NANOEM_TEST_OUTPUT_PATH "/file_content_digest_prefetch_missing.bin"));
+    fileURIs.push_back(missingURI);
+    FileContentDigestCache cache;
+    cache.prefetch(fileURIs);
+    CHECK(cache.numEntries() == contents.size());
+    CHECK(cache.numMappedFiles() == contents.size());
+    CHECK_FALSE(cache.findMappedFile(missingURI));
+    Error error;
+    for (nanoem_rsize_t i = 0; i < contents.size(); i++) {
+        const ByteArray &bytes = contents[i];
+        /* loaders take the same bytes whose digest has been prefetched */
+        MappedFileReader *reader = cache.findMappedFile(fileURIs[i]);
+        REQUIRE(reader);
+        REQUIRE(reader->size() == bytes.size());
+        CHECK(memcmp(reader->bytes(), bytes.data(), bytes.size()) == 0);
+        nanoem_u8_t expected[FileContentDigestCache::kDigestSize], actual[FileContentDigestCache::kDigestSize];
+        ContentDigest::calculate(ContentDigest::kAlgorithmTypeSHA256, bytes.data(), bytes.size(), nullptr, expected);
+        REQUIRE(cache.calculate(fileURIs[i], actual, error));
+        CHECK(memcmp(actual, expected, sizeof(expected)) == 0);
+    }
+    cache.releaseAllMappedFiles();
+    CHECK(cache.numMappedFiles() == 0);
+    CHECK_FALSE(cache.findMappedFile(fileURIs[0]));
+    /* the digests are still recorded after the mapped files are released */
+    CHECK(cache.numEntries() == contents.size());
+    CHECK_FALSE(error.hasReason());
+}
@@ -0,0 +1,99 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/internal/DecodedImageCache.h"
+
+using namespace nanoem;
+using namespace internal;
+
+namespace {
+
+static DecodedImageCache::Key
+createKey(nanoem_u8_t seed, nanoem_u32_t flags)
+{
+    const nanoem_u8_t bytes[] = { seed, nanoem_u8_t(seed + 1), nanoem_u8_t(seed + 2), nanoem_u8_t(seed + 3) };
+    return DecodedImageCache::Key::create(bytes, sizeof(bytes), flags, nullptr);
+}
+
+static DecodedImage *
+createImage(nanoem_rsize_t size)
+{
+    ByteArray pixels(size, 0x7f);
+    sg_image_desc desc;
+    memset(&desc, 0, sizeof(desc));
+    desc.width = desc.height = 1;
+    desc.data.subimage[0][0].ptr = pixels.data();
+    desc.data.subimage[0][0].size = pixels.size();
+    DecodedImage *image = nanoem_new(DecodedImage);
+    image->assign(desc);
+    return image;
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("decoded_image_cache_own_payloads", "[emapp][misc]")
+{
+    DecodedImage *image = createImage(64);
+    const sg_range &range = image->m_description.data.subimage[0][0];
+    REQUIRE(image->m_payloads.size() == 1);
+    CHECK(range.ptr == image->m_payloads[0].data());
+    CHECK(range.size == 64);
+    CHECK(image->sizeInBytes() == 64);
+    nanoem_delete(image);
+}
+
+TEST_CASE("decoded_image_cache_share_by_content", "[emapp][misc]")
+{
+    DecodedImageCache cache(1024);
+    CHECK_FALSE(cache.acquire(createKey(1, 0)));
+    const DecodedImage *image = cache.insert(createKey(1, 0), createImage(16));
+    REQUIRE(image);
+    CHECK(cache.acquire(createKey(1, 0)) == image);
+    CHECK_FALSE(cache.acquire(createKey(1, 2)));
+    CHECK_FALSE(cache.acquire(createKey(2, 0)));
+    SECTION("concurrent insertion of the same content")
+    {
+        CHECK(cache.insert(createKey(1, 0), createImage(16)) == image);
+        cache.release(image);
+        CHECK(cache.numEntries() == 1);
+        CHECK(cache.memoryUsage() == 16);
+    }
+    cache.release(image);
+    cache.release(image);
+    CHECK(cache.numEntries() == 1);
+    cache.purge();
+    CHECK(cache.numEntries() == 0);
+    CHECK(cache.memoryUsage() == 0);
+}
+
+TEST_CASE("decoded_image_cache_evict_least_recently_used", "[emapp][misc]")
+{
+    DecodedImageCache cache(100);
+    cache.release(cache.insert(createKey(1, 0), createImage(40)));
+    cache.release(cache.insert(createKey(2, 0), createImage(40)));
+    cache.release(cache.acquire(createKey(1, 0)));
+    cache.release(cache.insert(createKey(3, 0), createImage(40)));
+    CHECK(cache.numEntries() == 2);
+    CHECK(cache.memoryUsage() == 80);
+    const DecodedImage *image = cache.acquire(createKey(1, 0));
+    CHECK(image);
+    cache.release(image);
+    CHECK_FALSE(cache.acquire(createKey(2, 0)));
+}
+
+TEST_CASE("decoded_image_cache_keep_referenced_over_budget", "[emapp][misc]")
+{
+    DecodedImageCache cache(0);
+    const DecodedImage *image = cache.insert(createKey(1, 0), createImage(256));
+    CHECK(cache.memoryUsage() == 256);
+    CHECK(cache.acquire(createKey(1, 0)) == image);
+    cache.release(image);
+    CHECK(cache.numEntries() == 1);
+    cache.release(image);
+    CHECK(cache.numEntries() == 0);
+}
@@ -58,3 +58,32 @@ TEST_CASE("fileutils_relative_path", "[emapp][misc]")
     CHECK(FileUtils::relativePath("D:/path/to/relative", "D:/base") == String("../path/to/relative"));
     CHECK(FileUtils::relativePath("D:/path/to/relative", "C:/base") == String());
 }
+
+TEST_CASE("fileutils_mapped_file_reader", "[emapp][misc]")
+{
+    const URI fileURI(URI::createFromFilePath(NANOEM_TEST_FIXTURE_PATH "/test.pmx"));
+    Error error;
+    ByteArray expected;
+    {
+        FileReaderScope scope(nullptr);
+        REQUIRE(scope.open(fileURI, error));
+        FileUtils::read(scope, expected, error);
+        REQUIRE_FALSE(error.hasReason());
+    }
+    MappedFileReader reader(nullptr);
+    /* fixtures on removable or network storage are read instead of mapped and both must return the same bytes */
+    REQUIRE(reader.open(fileURI, error));
+    CHECK(reader.fileURI().absolutePath() == fileURI.absolutePath());
+    REQUIRE(reader.size() == expected.size());
+    CHECK(memcmp(reader.bytes(), expected.data(), expected.size()) == 0);
+    nanoem_u8_t chunk[4];
+    reader.seek(4, ISeekable::kSeekTypeBegin, error);
+    CHECK(reader.read(chunk, sizeof(chunk), error) == sizeof(chunk));
+    CHECK(memcmp(chunk, expected.data() + 4, sizeof(chunk)) == 0);
+    reader.seek(-2, ISeekable::kSeekTypeEnd, error);
+    CHECK(reader.read(chunk, sizeof(chunk), error) == 2);
+    CHECK(reader.close(error));
+    CHECK(reader.size() == 0);
+    CHECK_FALSE(reader.open(URI::createFromFilePath(NANOEM_TEST_FIXTURE_PATH "/not_found.pmx"), error));
+    CHECK(error.hasReason());
+}
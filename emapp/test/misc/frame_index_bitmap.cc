@@ -0,0 +1,112 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/internal/FrameIndexBitmap.h"
+
+using namespace nanoem;
+using namespace internal;
+
+TEST_CASE("frame_index_bitmap_set_and_reset", "[emapp][misc]")
+{
+    FrameIndexBitmap bitmap;
+    CHECK(bitmap.isEmpty());
+    CHECK(bitmap.count() == 0);
+    bitmap.set(0);
+    bitmap.set(63);
+    bitmap.set(64);
+    bitmap.set(1339);
+    CHECK(bitmap.contains(0));
+    CHECK(bitmap.contains(63));
+    CHECK(bitmap.contains(64));
+    CHECK(bitmap.contains(1339));
+    CHECK_FALSE(bitmap.contains(1));
+    CHECK_FALSE(bitmap.contains(1340));
+    CHECK(bitmap.count() == 4);
+    CHECK(bitmap.first() == 0);
+    bitmap.reset(0);
+    bitmap.reset(42);
+    CHECK_FALSE(bitmap.contains(0));
+    CHECK(bitmap.first() == 63);
+    CHECK(bitmap.count() == 3);
+    bitmap.clear();
+    CHECK(bitmap.isEmpty());
+}
+
+TEST_CASE("frame_index_bitmap_range", "[emapp][misc]")
+{
+    FrameIndexBitmap bitmap;
+    bitmap.setRange(10, 200);
+    CHECK(bitmap.count() == 191);
+    CHECK_FALSE(bitmap.contains(9));
+    CHECK(bitmap.contains(10));
+    CHECK(bitmap.contains(200));
+    CHECK_FALSE(bitmap.contains(201));
+    bitmap.resetRange(60, 130);
+    CHECK(bitmap.count() == 120);
+    CHECK(bitmap.contains(59));
+    CHECK_FALSE(bitmap.contains(60));
+    CHECK_FALSE(bitmap.contains(130));
+    CHECK(bitmap.contains(131));
+    /* an inverted range does nothing */
+    bitmap.setRange(300, 299);
+    CHECK(bitmap.count() == 120);
+    bitmap.resetRange(0, ~nanoem_frame_index_t(0));
+    CHECK(bitmap.isEmpty());
+}
+
+TEST_CASE("frame_index_bitmap_get_all_is_ordered", "[emapp][misc]")
+{
+    static const nanoem_frame_index_t kFrameIndices[] = { 4096, 1, 65, 64, 1339, 0 };
+    FrameIndexBitmap bitmap;
+    for (auto it : kFrameIndices) {
+        bitmap.set(it);
+    }
+    Motion::FrameIndexList frameIndices;
+    bitmap.getAll(frameIndices);
+    REQUIRE(frameIndices.size() == 6);
+    CHECK(frameIndices[0] == 0);
+    CHECK(frameIndices[1] == 1);
+    CHECK(frameIndices[2] == 64);
+    CHECK(frameIndices[3] == 65);
+    CHECK(frameIndices[4] == 1339);
+    CHECK(frameIndices[5] == 4096);
+}
+
+TEST_CASE("frame_index_bitmap_shift", "[emapp][misc]")
+{
+    FrameIndexBitmap bitmap;
+    bitmap.set(1);
+    bitmap.set(10);
+    bitmap.set(63);
+    SECTION("backward")
+    {
+        bitmap.shift(10, 1);
+        CHECK(bitmap.contains(1));
+        CHECK_FALSE(bitmap.contains(10));
+        CHECK(bitmap.contains(11));
+        CHECK_FALSE(bitmap.contains(63));
+        CHECK(bitmap.contains(64));
+        CHECK(bitmap.count() == 3);
+    }
+    SECTION("forward")
+    {
+        /* the frame index just before the shifted range is overwritten */
+        bitmap.shift(11, -1);
+        CHECK(bitmap.contains(1));
+        CHECK_FALSE(bitmap.contains(10));
+        CHECK(bitmap.contains(62));
+        CHECK(bitmap.count() == 2);
+    }
+    SECTION("underflow")
+    {
+        bitmap.shift(0, -5);
+        CHECK(bitmap.contains(5));
+        CHECK(bitmap.contains(58));
+        CHECK(bitmap.count() == 2);
+    }
+}
@@ -0,0 +1,72 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/StringUtils.h"
+#include "emapp/internal/MessageBatch.h"
+
+using namespace nanoem;
+using namespace internal;
+
+namespace {
+
+static void
+appendMessage(MessageBatch &batch, const char *text, nanoem_u32_t key)
+{
+    const nanoem_rsize_t size = StringUtils::length(text);
+    memcpy(batch.allocate(size, key), text, size);
+}
+
+static void
+collectMessage(void *userData, const nanoem_u8_t *data, size_t size)
+{
+    StringList *messages = static_cast<StringList *>(userData);
+    messages->push_back(String(reinterpret_cast<const char *>(data), size));
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("message_batch_roundtrip", "[emapp][misc]")
+{
+    MessageBatch batch;
+    CHECK(batch.isEmpty());
+    appendMessage(batch, "seek0", 28);
+    appendMessage(batch, "add_model", 0);
+    appendMessage(batch, "add_model", 0);
+    appendMessage(batch, "seek1", 28);
+    CHECK(batch.numMessages() == 3);
+    CHECK(batch.numCoalescedMessages() == 1);
+    ByteArray bytes(batch.encodedSize());
+    batch.encode(1339, bytes.data());
+    CHECK(batch.isEmpty());
+    StringList messages;
+    nanoem_u64_t timestamp = 0;
+    CHECK(MessageBatch::dispatchAll(bytes.data(), bytes.size(), collectMessage, &messages, &timestamp));
+    CHECK(timestamp == 1339);
+    REQUIRE(messages.size() == 3);
+    /* the superseded message is dropped and the latest one is kept at its own position */
+    CHECK_THAT(messages[0].c_str(), Catch::Equals("add_model"));
+    CHECK_THAT(messages[1].c_str(), Catch::Equals("add_model"));
+    CHECK_THAT(messages[2].c_str(), Catch::Equals("seek1"));
+}
+
+TEST_CASE("message_batch_reject_malformed", "[emapp][misc]")
+{
+    MessageBatch batch;
+    appendMessage(batch, "undo_change", 13);
+    ByteArray bytes(batch.encodedSize());
+    batch.encode(0, bytes.data());
+    StringList messages;
+    /* truncated frame must not dispatch any message */
+    CHECK_FALSE(MessageBatch::dispatchAll(bytes.data(), bytes.size() - 1, collectMessage, &messages, nullptr));
+    /* not a batch */
+    const nanoem_u8_t single[] = { 0x08, 0x01, 0x10, 0x02, 0x18, 0x03, 0x20, 0x04, 0x28, 0x05, 0x30, 0x06, 0x38, 0x07,
+        0x40, 0x08 };
+    CHECK_FALSE(MessageBatch::dispatchAll(single, sizeof(single), collectMessage, &messages, nullptr));
+    CHECK_FALSE(MessageBatch::dispatchAll(single, 4, collectMessage, &messages, nullptr));
+    CHECK(messages.empty());
+}
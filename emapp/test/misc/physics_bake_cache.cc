@@ -0,0 +1,200 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Constants.h"
+#include "emapp/FileUtils.h"
+#include "emapp/internal/PhysicsBakeCache.h"
+
+#include "glm/gtc/matrix_transform.hpp"
+
+using namespace nanoem;
+using namespace internal;
+
+namespace {
+
+static const nanoem_rsize_t kNumRigidBodies = 3;
+
+static void
+createTransforms(nanoem_frame_index_t frameIndex, Matrix4x4 *transforms)
+{
+    for (nanoem_rsize_t i = 0; i < kNumRigidBodies; i++) {
+        const nanoem_f32_t value = nanoem_f32_t(frameIndex + i);
+        const Quaternion orientation(glm::angleAxis(value * 0.1f, glm::normalize(Vector3(1, value, 2))));
+        transforms[i] = glm::translate(Constants::kIdentity, Vector3(value, -value, value * 0.5f)) *
+            glm::mat4_cast(orientation);
+    }
+}
+
+static bool
+equalsTransform(const Matrix4x4 &left, const Matrix4x4 &right)
+{
+    bool result = true;
+    for (int i = 0; i < 4; i++) {
+        for (int j = 0; j < 4; j++) {
+            result &= glm::abs(left[i][j] - right[i][j]) < 1e-3f;
+        }
+    }
+    return result;
+}
+
+static void
+recordAllFrames(PhysicsBakeCache &cache, nanoem_u16_t handle, nanoem_frame_index_t from, nanoem_frame_index_t to)
+{
+    Matrix4x4 transforms[kNumRigidBodies];
+    for (nanoem_frame_index_t i = from; i <= to; i++) {
+        createTransforms(i, transforms);
+        cache.record(handle, i, transforms);
+    }
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("physics_bake_cache_restore_recorded_frames", "[emapp][misc]")
+{
+    PhysicsBakeCache cache;
+    const nanoem_u16_t handle = 1;
+    const nanoem_frame_index_t lastFrameIndex = PhysicsBakeCache::kNumFramesPerChunk * 2 + 5;
+    cache.begin(handle, 42, kNumRigidBodies);
+    recordAllFrames(cache, handle, 0, lastFrameIndex);
+    /* both of the deflated chunks and the one still being recorded */
+    Matrix4x4 expected[kNumRigidBodies], actual[kNumRigidBodies];
+    for (nanoem_frame_index_t i = 0; i <= lastFrameIndex; i++) {
+        createTransforms(i, expected);
+        REQUIRE(cache.restore(handle, 42, kNumRigidBodies, i, actual));
+        for (nanoem_rsize_t j = 0; j < kNumRigidBodies; j++) {
+            CHECK(equalsTransform(expected[j], actual[j]));
+        }
+    }
+    cache.commit();
+    createTransforms(lastFrameIndex, expected);
+    REQUIRE(cache.restore(handle, 42, kNumRigidBodies, lastFrameIndex, actual));
+    CHECK(equalsTransform(expected[0], actual[0]));
+    CHECK_FALSE(cache.contains(handle, 42, kNumRigidBodies, lastFrameIndex + 1));
+    CHECK_FALSE(cache.restore(handle, 42, kNumRigidBodies, lastFrameIndex + 1, actual));
+}
+
+TEST_CASE("physics_bake_cache_reject_mismatched_track", "[emapp][misc]")
+{
+    PhysicsBakeCache cache;
+    const nanoem_u16_t handle = 1;
+    cache.begin(handle, 42, kNumRigidBodies);
+    recordAllFrames(cache, handle, 0, 10);
+    CHECK(cache.contains(handle, 42, kNumRigidBodies, 10));
+    CHECK_FALSE(cache.contains(handle, 43, kNumRigidBodies, 10));
+    CHECK_FALSE(cache.contains(handle, 42, kNumRigidBodies + 1, 10));
+    CHECK_FALSE(cache.contains(nanoem_u16_t(handle + 1), 42, kNumRigidBodies, 10));
+    /* keeps recorded frames while the signature is unchanged */
+    cache.begin(handle, 42, kNumRigidBodies);
+    CHECK(cache.contains(handle, 42, kNumRigidBodies, 10));
+    cache.begin(handle, 43, kNumRigidBodies);
+    CHECK_FALSE(cache.contains(handle, 43, kNumRigidBodies, 10));
+    cache.invalidate(handle);
+    CHECK(cache.numTracks() == 0);
+}
+
+TEST_CASE("physics_bake_cache_save_and_load", "[emapp][misc]")
+{
+    PhysicsBakeCache cache, loaded;
+    const String name("model");
+    const nanoem_u16_t handle = 1, unnamedHandle = 2, loadedHandle = 7;
+    const nanoem_frame_index_t lastFrameIndex = PhysicsBakeCache::kNumFramesPerChunk + 3;
+    PhysicsBakeCache::HandleNameMap names;
+    PhysicsBakeCache::NameHandleMap handles;
+    names.insert(tinystl::make_pair(handle, name));
+    handles.insert(tinystl::make_pair(name, loadedHandle));
+    ByteArray bytes;
+    Error error;
+    cache.begin(handle, 42, kNumRigidBodies);
+    recordAllFrames(cache, handle, 0, lastFrameIndex);
+    /* the track without the name is not saved */
+    cache.begin(unnamedHandle, 42, kNumRigidBodies);
+    recordAllFrames(cache, unnamedHandle, 0, lastFrameIndex);
+    cache.commit();
+    MemoryWriter writer(&bytes);
+    CHECK(cache.save(&writer, names, error));
+    SECTION("tracks are mapped to the handles of the session loading them")
+    {
+        MemoryReader reader(&bytes);
+        CHECK(loaded.load(&reader, handles, error));
+        CHECK_FALSE(error.hasReason());
+        CHECK(loaded.numTracks() == 1);
+        Matrix4x4 expected[kNumRigidBodies], actual[kNumRigidBodies];
+        for (nanoem_frame_index_t i = 0; i <= lastFrameIndex; i++) {
+            createTransforms(i, expected);
+            REQUIRE(loaded.restore(loadedHandle, 42, kNumRigidBodies, i, actual));
+            CHECK(equalsTransform(expected[kNumRigidBodies - 1], actual[kNumRigidBodies - 1]));
+        }
+        /* the stale track is rejected by the signature */
+        CHECK_FALSE(loaded.contains(loadedHandle, 43, kNumRigidBodies, 0));
+    }
+    SECTION("tracks of the models not in the project are skipped")
+    {
+        MemoryReader reader(&bytes);
+        CHECK(loaded.load(&reader, PhysicsBakeCache::NameHandleMap(), error));
+        CHECK_FALSE(error.hasReason());
+        CHECK(loaded.numTracks() == 0);
+    }
+    SECTION("not a baked file")
+    {
+        ByteArray broken(bytes.begin(), bytes.begin() + 4);
+        broken[0] = 0;
+        MemoryReader brokenReader(&broken);
+        CHECK_FALSE(loaded.load(&brokenReader, handles, error));
+        CHECK(error.hasReason());
+    }
+}
+
+TEST_CASE("physics_bake_cache_load_rejects_broken_lengths", "[emapp][misc]")
+{
+    PhysicsBakeCache cache;
+    const String name("model");
+    const nanoem_u16_t handle = 1;
+    PhysicsBakeCache::HandleNameMap names;
+    PhysicsBakeCache::NameHandleMap handles;
+    names.insert(tinystl::make_pair(handle, name));
+    handles.insert(tinystl::make_pair(name, handle));
+    ByteArray bytes;
+    Error error;
+    cache.begin(handle, 42, kNumRigidBodies);
+    recordAllFrames(cache, handle, 0, PhysicsBakeCache::kNumFramesPerChunk + 3);
+    cache.commit();
+    MemoryWriter writer(&bytes);
+    REQUIRE(cache.save(&writer, names, error));
+    /* magic, version, number of tracks, name length and name come first */
+    const nanoem_rsize_t nameLengthOffset = sizeof(nanoem_u32_t) * 3,
+                         trackOffset = nameLengthOffset + sizeof(nanoem_u32_t) + name.size(),
+                         numFramesOffset = trackOffset + sizeof(nanoem_u64_t) + sizeof(nanoem_u32_t),
+                         chunkOffset = numFramesOffset + sizeof(nanoem_u32_t) * 2,
+                         inflatedSizeOffset = chunkOffset + sizeof(nanoem_u32_t) + sizeof(nanoem_u64_t);
+    SECTION("name length exceeding the file")
+    {
+        const nanoem_u32_t value = 0xffffffffu;
+        memcpy(bytes.data() + nameLengthOffset, &value, sizeof(value));
+    }
+    SECTION("frames beyond the track")
+    {
+        const nanoem_u32_t value = 1;
+        memcpy(bytes.data() + numFramesOffset, &value, sizeof(value));
+    }
+    SECTION("inflated size not matching the number of rigid bodies")
+    {
+        nanoem_u32_t value;
+        memcpy(&value, bytes.data() + inflatedSizeOffset, sizeof(value));
+        value += 1;
+        memcpy(bytes.data() + inflatedSizeOffset, &value, sizeof(value));
+    }
+    SECTION("truncated chunk")
+    {
+        bytes.resize(bytes.size() - 1);
+    }
+    PhysicsBakeCache loaded;
+    MemoryReader reader(&bytes);
+    CHECK_FALSE(loaded.load(&reader, handles, error));
+    CHECK(error.hasReason());
+    CHECK(loaded.numTracks() == 0);
+}
@@ -0,0 +1,107 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/command/SnapshotDelta.h"
+
+using namespace nanoem;
+using namespace command;
+
+namespace {
+
+static void
+fillBytes(ByteArray &bytes, nanoem_rsize_t size, nanoem_u32_t seed)
+{
+    bytes.resize(size);
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        seed = seed * 1664525u + 1013904223u;
+        bytes[i] = nanoem_u8_t(seed >> 24);
+    }
+}
+
+static bool
+isSame(const ByteArray &left, const ByteArray &right)
+{
+    return left.size() == right.size() && (left.empty() || memcmp(left.data(), right.data(), left.size()) == 0);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("snapshot_delta_roundtrip_in_place_edits", "[emapp][misc]")
+{
+    ByteArray base, target, delta, output;
+    fillBytes(base, 0x40000, 42);
+    target = base;
+    for (nanoem_rsize_t i = 0; i < 32; i++) {
+        target[(i * 7919) % target.size()] ^= 0xff;
+    }
+    SnapshotDelta::encode(base, target, delta);
+    CHECK(delta.size() < target.size() / 16);
+    REQUIRE(SnapshotDelta::decode(base, delta, output));
+    CHECK(isSame(output, target));
+}
+
+TEST_CASE("snapshot_delta_roundtrip_insert_and_remove", "[emapp][misc]")
+{
+    ByteArray base, target, delta, output, chunk;
+    fillBytes(base, 0x20000, 7);
+    fillBytes(chunk, 100, 13);
+    target.insert(target.end(), base.begin(), base.begin() + 0x8000);
+    target.insert(target.end(), chunk.begin(), chunk.end());
+    target.insert(target.end(), base.begin() + 0x9000, base.end());
+    SECTION("forward")
+    {
+        SnapshotDelta::encode(base, target, delta);
+        CHECK(delta.size() < 1024);
+        REQUIRE(SnapshotDelta::decode(base, delta, output));
+        CHECK(isSame(output, target));
+    }
+    SECTION("backward")
+    {
+        SnapshotDelta::encode(target, base, delta);
+        CHECK(delta.size() < 0x2000);
+        REQUIRE(SnapshotDelta::decode(target, delta, output));
+        CHECK(isSame(output, base));
+    }
+}
+
+TEST_CASE("snapshot_delta_roundtrip_empty", "[emapp][misc]")
+{
+    ByteArray empty, bytes, delta, output;
+    fillBytes(bytes, 1000, 1);
+    SnapshotDelta::encode(empty, bytes, delta);
+    REQUIRE(SnapshotDelta::decode(empty, delta, output));
+    CHECK(isSame(output, bytes));
+    SnapshotDelta::encode(bytes, empty, delta);
+    REQUIRE(SnapshotDelta::decode(bytes, delta, output));
+    CHECK(output.empty());
+}
+
+TEST_CASE("snapshot_delta_reject_wrong_base", "[emapp][misc]")
+{
+    ByteArray base, target, delta, output;
+    fillBytes(base, 0x1000, 3);
+    target = base;
+    target[0x800] ^= 1;
+    SnapshotDelta::encode(base, target, delta);
+    SECTION("different content")
+    {
+        ByteArray other(base);
+        other[0] ^= 1;
+        CHECK_FALSE(SnapshotDelta::decode(other, delta, output));
+    }
+    SECTION("different size")
+    {
+        ByteArray other(base.begin(), base.end() - 1);
+        CHECK_FALSE(SnapshotDelta::decode(other, delta, output));
+    }
+    SECTION("truncated delta")
+    {
+        delta.resize(delta.size() / 2);
+        CHECK_FALSE(SnapshotDelta::decode(base, delta, output));
+    }
+}
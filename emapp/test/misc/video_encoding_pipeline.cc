@@ -0,0 +1,123 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/internal/VideoEncodingPipeline.h"
+
+using namespace nanoem;
+using namespace internal;
+
+namespace {
+
+class RecordingEncoder : public VideoEncodingPipeline::IEncoder {
+public:
+    RecordingEncoder(nanoem_frame_index_t failedPTS)
+        : m_failedPTS(failedPTS)
+    {
+    }
+    bool
+    encodeAudioFrame(nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) NANOEM_DECL_OVERRIDE
+    {
+        BX_UNUSED_3(data, size, error);
+        m_audioFrames.push_back(pts);
+        return true;
+    }
+    bool
+    encodeVideoFrame(nanoem_frame_index_t pts, const nanoem_u8_t *data, size_t size, Error &error) NANOEM_DECL_OVERRIDE
+    {
+        bool result = pts != m_failedPTS && size == 4 && data[0] == nanoem_u8_t(pts);
+        if (result) {
+            m_videoFrames.push_back(pts);
+        }
+        else {
+            error = Error("failed", 0, Error::kDomainTypeApplication);
+        }
+        return result;
+    }
+    tinystl::vector<nanoem_frame_index_t, TinySTLAllocator> m_audioFrames;
+    tinystl::vector<nanoem_frame_index_t, TinySTLAllocator> m_videoFrames;
+    const nanoem_frame_index_t m_failedPTS;
+};
+
+static void
+submitFrame(VideoEncodingPipeline &pipeline, nanoem_frame_index_t pts, bool audio)
+{
+    VideoEncodingPipeline::Frame *frame = pipeline.acquire();
+    REQUIRE(frame);
+    frame->m_pts = pts;
+    frame->m_videoData.resize(4);
+    frame->m_videoData[0] = nanoem_u8_t(pts);
+    frame->m_audioData.resize(audio ? 8 : 0);
+    pipeline.submit(frame);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("video_encoding_pipeline_swizzle_rgba8", "[emapp][misc]")
+{
+    ByteArray bytes(4 * 37 + 4), expected;
+    for (nanoem_rsize_t i = 0; i < bytes.size(); i++) {
+        bytes[i] = nanoem_u8_t(i * 13 + 1);
+    }
+    expected = bytes;
+    for (nanoem_rsize_t i = 4; i < expected.size(); i += 4) {
+        nanoem_u8_t *pixel = expected.data() + i;
+        const nanoem_u8_t r = pixel[0];
+        pixel[0] = pixel[2];
+        pixel[2] = r;
+    }
+    /* starts from the unaligned offset to cover both of the scalar and the vectorized path */
+    VideoEncodingPipeline::swizzleRGBA8(bytes.data() + 4, bytes.size() - 4);
+    CHECK(memcmp(bytes.data(), expected.data(), bytes.size()) == 0);
+}
+
+TEST_CASE("video_encoding_pipeline_encode_in_order", "[emapp][misc]")
+{
+    RecordingEncoder encoder(~nanoem_frame_index_t(0));
+    VideoEncodingPipeline pipeline(&encoder, 3);
+    Error error;
+    pipeline.start();
+    for (nanoem_frame_index_t i = 0; i < 64; i++) {
+        submitFrame(pipeline, i, (i % 2) == 0);
+    }
+    CHECK(pipeline.finish(error));
+    CHECK_FALSE(error.hasReason());
+    REQUIRE(encoder.m_videoFrames.size() == 64);
+    REQUIRE(encoder.m_audioFrames.size() == 32);
+    for (nanoem_frame_index_t i = 0; i < 64; i++) {
+        CHECK(encoder.m_videoFrames[i] == i);
+    }
+}
+
+TEST_CASE("video_encoding_pipeline_stop_at_failure", "[emapp][misc]")
+{
+    RecordingEncoder encoder(3);
+    VideoEncodingPipeline pipeline(&encoder, 2);
+    Error error;
+    pipeline.start();
+    for (nanoem_frame_index_t i = 0; i < 16; i++) {
+        submitFrame(pipeline, i, false);
+    }
+    CHECK_FALSE(pipeline.finish(error));
+    CHECK(pipeline.isFailed());
+    CHECK(error.hasReason());
+    CHECK(encoder.m_videoFrames.size() == 3);
+}
+
+TEST_CASE("video_encoding_pipeline_bounded_frames", "[emapp][misc]")
+{
+    RecordingEncoder encoder(~nanoem_frame_index_t(0));
+    VideoEncodingPipeline pipeline(&encoder, 2);
+    VideoEncodingPipeline::Frame *frame0 = pipeline.tryAcquire(), *frame1 = pipeline.tryAcquire();
+    CHECK(frame0);
+    CHECK(frame1);
+    CHECK_FALSE(pipeline.tryAcquire());
+    pipeline.discard(frame0);
+    CHECK(pipeline.tryAcquire() == frame0);
+    pipeline.discard(frame0);
+    pipeline.discard(frame1);
+}
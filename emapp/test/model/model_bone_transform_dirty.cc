@@ -0,0 +1,230 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/PhysicsEngine.h"
+#include "emapp/model/Bone.h"
+#include "emapp/model/Morph.h"
+
+#include "nanoem/ext/mutable.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static void
+checkSameAsEvaluatingAllBones(Model *model)
+{
+    nanoem_rsize_t numBones;
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllOrderedBoneObjects(model->data(), &numBones);
+    tinystl::vector<Matrix4x4, TinySTLAllocator> incrementalTransforms;
+    for (nanoem_rsize_t i = 0; i < numBones; i++) {
+        incrementalTransforms.push_back(model::Bone::cast(bones[i])->worldTransform());
+    }
+    for (nanoem_rsize_t i = 0; i < numBones; i++) {
+        model::Bone::cast(bones[i])->setTransformDirty(true);
+    }
+    model->performAllBonesTransform();
+    for (nanoem_rsize_t i = 0; i < numBones; i++) {
+        const Matrix4x4 transform(model::Bone::cast(bones[i])->worldTransform());
+        for (int j = 0; j < 4; j++) {
+            CHECK_THAT(incrementalTransforms[i][j], Equals(transform[j]));
+        }
+    }
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("model_bone_transform_dirty_incremental_evaluation", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        activeModel->performAllBonesTransform();
+        nanoem_rsize_t numBones;
+        nanoem_model_bone_t *const *bones = nanoemModelGetAllOrderedBoneObjects(activeModel->data(), &numBones);
+        const nanoem_model_bone_t *bonePtr = TestScope::findFirstBone(activeModel);
+        model::Bone *bone = model::Bone::cast(bonePtr);
+        /* assigning the same value must not make the bone dirty */
+        bone->setLocalUserTranslation(bone->localUserTranslation());
+        CHECK_FALSE(bone->isTransformDirty());
+        bone->setLocalUserTranslation(Vector3(1, 2, 3));
+        CHECK(bone->isTransformDirty());
+        activeModel->performAllBonesTransform();
+        CHECK_FALSE(bone->isTransformDirty());
+        tinystl::vector<Matrix4x4, TinySTLAllocator> incrementalTransforms;
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            incrementalTransforms.push_back(model::Bone::cast(bones[i])->worldTransform());
+        }
+        /* the result must be the same as the one evaluating all of the bones */
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            model::Bone::cast(bones[i])->setTransformDirty(true);
+        }
+        activeModel->performAllBonesTransform();
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            const Matrix4x4 transform(model::Bone::cast(bones[i])->worldTransform());
+            for (int j = 0; j < 4; j++) {
+                CHECK_THAT(incrementalTransforms[i][j], Equals(transform[j]));
+            }
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_bone_transform_dirty_motion_playback", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        const nanoem_model_bone_t *bonePtr = TestScope::findFirstBone(activeModel);
+        const model::Bone *bone = model::Bone::cast(bonePtr);
+        Motion *motion = project->resolveMotion(activeModel);
+        {
+            nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+            nanoem_mutable_motion_t *mutableMotion = nanoemMutableMotionCreateAsReference(motion->data(), &status);
+            const nanoem_unicode_string_t *name = nanoemModelBoneGetName(bonePtr, NANOEM_LANGUAGE_TYPE_FIRST_ENUM);
+            nanoem_mutable_motion_bone_keyframe_t *keyframe =
+                nanoemMutableMotionBoneKeyframeCreate(motion->data(), &status);
+            const Vector4 translation(10, 0, 0, 0);
+            nanoemMutableMotionBoneKeyframeSetTranslation(keyframe, glm::value_ptr(translation));
+            nanoemMutableMotionAddBoneKeyframe(mutableMotion, keyframe, name, 10, &status);
+            nanoemMutableMotionSortAllKeyframes(mutableMotion);
+            nanoemMutableMotionBoneKeyframeDestroy(keyframe);
+            nanoemMutableMotionDestroy(mutableMotion);
+            motion->setDirty(true);
+        }
+        project->seek(5, true);
+        CHECK(bone->localUserTranslation().x > 0);
+        CHECK(bone->localUserTranslation().x < 10);
+        checkSameAsEvaluatingAllBones(activeModel);
+        const nanoem_u64_t sequence = bone->transformSequence();
+        project->seek(10, true);
+        CHECK_THAT(bone->localUserTranslation(), Equals(Vector3(10, 0, 0)));
+        CHECK(bone->transformSequence() > sequence);
+        checkSameAsEvaluatingAllBones(activeModel);
+        project->seek(0, true);
+        CHECK_THAT(bone->localUserTranslation(), Equals(Vector3(0)));
+        checkSameAsEvaluatingAllBones(activeModel);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_bone_transform_dirty_parent_moves_children", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        activeModel->performAllBonesTransform();
+        nanoem_rsize_t numBones;
+        nanoem_model_bone_t *const *bones = nanoemModelGetAllOrderedBoneObjects(activeModel->data(), &numBones);
+        const nanoem_model_bone_t *childBonePtr = nullptr, *parentBonePtr = nullptr;
+        for (nanoem_rsize_t i = 0; i < numBones && !childBonePtr; i++) {
+            if (const nanoem_model_bone_t *bonePtr = nanoemModelBoneGetParentBoneObject(bones[i])) {
+                childBonePtr = bones[i];
+                parentBonePtr = bonePtr;
+            }
+        }
+        REQUIRE(childBonePtr);
+        const model::Bone *childBone = model::Bone::cast(childBonePtr);
+        const Vector3 origin(childBone->worldTransformOrigin());
+        const nanoem_u64_t sequence = childBone->transformSequence();
+        model::Bone::cast(parentBonePtr)->setLocalUserTranslation(Vector3(0, 10, 0));
+        /* only the parent is marked and the child follows its sequence */
+        CHECK_FALSE(childBone->isTransformDirty());
+        activeModel->performAllBonesTransform();
+        CHECK(childBone->transformSequence() > sequence);
+        CHECK(childBone->worldTransformOrigin() != origin);
+        checkSameAsEvaluatingAllBones(activeModel);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_bone_transform_dirty_physics_feedback", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        PhysicsEngine *engine = project->physicsEngine();
+        engine->setSimulationMode(PhysicsEngine::kSimulationModeEnableAnytime);
+        activeModel->performAllBonesTransform();
+        nanoem_rsize_t numRigidBodies;
+        nanoem_model_rigid_body_t *const *rigidBodies =
+            nanoemModelGetAllRigidBodyObjects(activeModel->data(), &numRigidBodies);
+        tinystl::vector<nanoem_u64_t, TinySTLAllocator> sequences;
+        for (nanoem_rsize_t i = 0; i < numRigidBodies; i++) {
+            const model::Bone *bone = model::Bone::cast(nanoemModelRigidBodyGetBoneObject(rigidBodies[i]));
+            sequences.push_back(bone ? bone->transformSequence() : 0);
+        }
+        engine->stepSimulation(1.0f / 60.0f);
+        activeModel->synchronizeAllRigidBodiesTransformFeedbackFromSimulation(PhysicsEngine::kRigidBodyFollowBoneSkip);
+        for (nanoem_rsize_t i = 0; i < numRigidBodies; i++) {
+            const model::Bone *bone = model::Bone::cast(nanoemModelRigidBodyGetBoneObject(rigidBodies[i]));
+            /* bones written by the feedback must advance the sequence to evaluate their children again */
+            if (bone && bone->isTransformDirty()) {
+                CHECK(bone->transformSequence() > sequences[i]);
+            }
+        }
+        engine->setSimulationMode(PhysicsEngine::kSimulationModeDisable);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_bone_transform_dirty_bone_morph", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        nanoem_rsize_t numMorphs, numChildren = 0;
+        nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(activeModel->data(), &numMorphs);
+        const nanoem_model_morph_t *morphPtr = nullptr;
+        const nanoem_model_morph_bone_t *const *children = nullptr;
+        for (nanoem_rsize_t i = 0; i < numMorphs && !morphPtr; i++) {
+            if (nanoemModelMorphGetType(morphs[i]) == NANOEM_MODEL_MORPH_TYPE_BONE) {
+                children = nanoemModelMorphGetAllBoneMorphObjects(morphs[i], &numChildren);
+                morphPtr = numChildren > 0 ? morphs[i] : nullptr;
+            }
+        }
+        if (morphPtr) {
+            model::Morph *morph = model::Morph::cast(morphPtr);
+            const model::Bone *bone = model::Bone::cast(nanoemModelMorphBoneGetBoneObject(children[0]));
+            morph->setWeight(1.0f);
+            activeModel->resetAllMorphDeformStates();
+            activeModel->deformAllMorphs(false);
+            activeModel->performAllBonesTransform();
+            /* deforming the same weight again must not make the bone dirty */
+            activeModel->resetAllMorphDeformStates();
+            activeModel->deformAllMorphs(false);
+            CHECK_FALSE(bone->isTransformDirty());
+            activeModel->performAllBonesTransform();
+            checkSameAsEvaluatingAllBones(activeModel);
+            /* the reset is applied when the morph no longer sets the bone */
+            morph->setWeight(0.0f);
+            activeModel->resetAllMorphDeformStates();
+            activeModel->performAllBonesTransform();
+            CHECK_THAT(bone->localMorphTranslation(), Equals(Vector3(0)));
+            checkSameAsEvaluatingAllBones(activeModel);
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,109 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/model/Bone.h"
+#include "emapp/model/Constraint.h"
+
+using namespace nanoem;
+using namespace test;
+
+TEST_CASE("model_constraint_resolve_all_joints", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        nanoem_unicode_string_factory_t *factory = project->unicodeStringFactory();
+        nanoem_rsize_t numConstraints, numJoints;
+        nanoem_model_constraint_t *const *constraints =
+            nanoemModelGetAllConstraintObjects(activeModel->data(), &numConstraints);
+        for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+            const nanoem_model_constraint_t *constraintPtr = constraints[i];
+            model::Constraint *constraint = model::Constraint::cast(constraintPtr);
+            nanoem_model_constraint_joint_t *const *joints =
+                nanoemModelConstraintGetAllJointObjects(constraintPtr, &numJoints);
+            const model::Constraint::ResolvedJointList &resolvedJoints =
+                constraint->resolveAllJoints(constraintPtr, factory);
+            REQUIRE(resolvedJoints.size() == numJoints);
+            for (nanoem_rsize_t j = 0; j < numJoints; j++) {
+                const model::Constraint::ResolvedJoint &joint = resolvedJoints[j];
+                const nanoem_model_bone_t *bonePtr = nanoemModelConstraintJointGetBoneObject(joints[j]);
+                CHECK(joint.m_opaque == joints[j]);
+                CHECK(joint.m_bonePtr == bonePtr);
+                CHECK(joint.m_hasUnitXConstraint == model::Constraint::hasUnitXConstraint(bonePtr, factory));
+                CHECK(joint.m_hasAngleLimit == (nanoemModelConstraintJointHasAngleLimit(joints[j]) != 0));
+            }
+            /* resolved joints are reused until these are invalidated */
+            CHECK(&constraint->resolveAllJoints(constraintPtr, factory) == &resolvedJoints);
+            constraint->invalidateAllJoints();
+            CHECK(constraint->resolveAllJoints(constraintPtr, factory).size() == numJoints);
+        }
+        activeModel->setAllConstraintIterationResultsCaptured(true);
+        for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+            CHECK(model::Constraint::cast(constraints[i])->isIterationResultCaptured());
+        }
+        activeModel->setAllConstraintIterationResultsCaptured(false);
+        activeModel->performAllBonesTransform();
+        CHECK(model::Constraint::isConverged(Vector3(1, 2, 3), Vector3(1, 2, 3)));
+        CHECK_FALSE(model::Constraint::isConverged(Vector3(1, 2, 3), Vector3(1, 2, 4)));
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_constraint_capturing_iterations_keeps_result", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        nanoem_rsize_t numConstraints, numBones;
+        nanoem_model_constraint_t *const *constraints =
+            nanoemModelGetAllConstraintObjects(activeModel->data(), &numConstraints);
+        nanoem_model_bone_t *const *bones = nanoemModelGetAllOrderedBoneObjects(activeModel->data(), &numBones);
+        for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+            const nanoem_model_bone_t *targetBonePtr = nanoemModelConstraintGetTargetBoneObject(constraints[i]);
+            if (model::Bone *targetBone = model::Bone::cast(targetBonePtr)) {
+                targetBone->setLocalUserTranslation(Vector3(0, 0.5f, -0.5f));
+            }
+        }
+        activeModel->performAllBonesTransform();
+        tinystl::vector<Matrix4x4, TinySTLAllocator> transforms;
+        tinystl::vector<nanoem_rsize_t, TinySTLAllocator> iterations;
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            transforms.push_back(model::Bone::cast(bones[i])->worldTransform());
+        }
+        for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+            const model::Constraint *constraint = model::Constraint::cast(constraints[i]);
+            CHECK(constraint->numSolvedIterations() <=
+                nanoem_rsize_t(nanoemModelConstraintGetNumIterations(constraints[i])));
+            iterations.push_back(constraint->numSolvedIterations());
+        }
+        /* showing the iterations must not change the solved result nor the iteration where it stopped */
+        activeModel->setAllConstraintIterationResultsCaptured(true);
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            model::Bone::cast(bones[i])->setTransformDirty(true);
+        }
+        activeModel->performAllBonesTransform();
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            const Matrix4x4 transform(model::Bone::cast(bones[i])->worldTransform());
+            for (int j = 0; j < 4; j++) {
+                CHECK_THAT(transforms[i][j], Equals(transform[j]));
+            }
+        }
+        for (nanoem_rsize_t i = 0; i < numConstraints; i++) {
+            CHECK(model::Constraint::cast(constraints[i])->numSolvedIterations() == iterations[i]);
+        }
+        activeModel->setAllConstraintIterationResultsCaptured(false);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,130 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/model/Morph.h"
+#include "emapp/model/Vertex.h"
+
+#include "nanoem/ext/mutable.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static Vector4
+toVector4(const bx::simd128_t &value)
+{
+    return Vector4(bx::simd_x(value), bx::simd_y(value), bx::simd_z(value), bx::simd_w(value));
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("model_morph_vertex_deltas_accumulate_active_morphs", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        activeModel->resetAllMorphs();
+        activeModel->resetAllVertices();
+        nanoem_rsize_t numMorphs, numVertices, numChildren;
+        nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(activeModel->data(), &numMorphs);
+        nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
+        tinystl::vector<Vector4, TinySTLAllocator> expectedDeltas(numVertices * 6, Vector4(0));
+        for (nanoem_rsize_t i = 0; i < numMorphs; i++) {
+            const nanoem_model_morph_t *morphPtr = morphs[i];
+            const nanoem_model_morph_type_t type = nanoemModelMorphGetType(morphPtr);
+            /* every other morph stays inactive to check that only active morphs are accumulated */
+            const nanoem_f32_t weight = (i % 2) == 0 ? 0.5f : 0.0f;
+            if (type == NANOEM_MODEL_MORPH_TYPE_VERTEX) {
+                model::Morph::cast(morphPtr)->setWeight(weight);
+                const nanoem_model_morph_vertex_t *const *children =
+                    nanoemModelMorphGetAllVertexMorphObjects(morphPtr, &numChildren);
+                for (nanoem_rsize_t j = 0; j < numChildren; j++) {
+                    const nanoem_model_morph_vertex_t *child = children[j];
+                    const int index = model::Vertex::index(nanoemModelMorphVertexGetVertexObject(child));
+                    expectedDeltas[index * 6] +=
+                        Vector4(glm::make_vec3(nanoemModelMorphVertexGetPosition(child)), 0) * weight;
+                }
+            }
+            else if (type >= NANOEM_MODEL_MORPH_TYPE_TEXTURE && type <= NANOEM_MODEL_MORPH_TYPE_UVA4) {
+                const int offset = 1 + type - NANOEM_MODEL_MORPH_TYPE_TEXTURE;
+                model::Morph::cast(morphPtr)->setWeight(weight);
+                const nanoem_model_morph_uv_t *const *children =
+                    nanoemModelMorphGetAllUVMorphObjects(morphPtr, &numChildren);
+                for (nanoem_rsize_t j = 0; j < numChildren; j++) {
+                    const nanoem_model_morph_uv_t *child = children[j];
+                    const int index = model::Vertex::index(nanoemModelMorphUVGetVertexObject(child));
+                    expectedDeltas[index * 6 + offset] +=
+                        glm::make_vec4(nanoemModelMorphUVGetPosition(child)) * weight;
+                }
+            }
+        }
+        activeModel->deformAllMorphs(true);
+        for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+            const model::Vertex *vertex = model::Vertex::cast(vertices[i]);
+            CHECK_THAT(toVector4(vertex->m_simd.m_delta), Equals(expectedDeltas[i * 6]));
+            for (int j = 0; j < 5; j++) {
+                CHECK_THAT(toVector4(vertex->m_simd.m_deltaUVA[j]), Equals(expectedDeltas[i * 6 + j + 1]));
+            }
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_morph_vertex_deltas_resolved_again_after_editing", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        project->setActiveModel(activeModel);
+        nanoem_rsize_t numMorphs, numChildren = 0;
+        nanoem_model_morph_t *const *morphs = nanoemModelGetAllMorphObjects(activeModel->data(), &numMorphs);
+        const nanoem_model_morph_t *morphPtr = nullptr;
+        nanoem_model_morph_vertex_t *child = nullptr;
+        for (nanoem_rsize_t i = 0; i < numMorphs && !morphPtr; i++) {
+            if (nanoemModelMorphGetType(morphs[i]) == NANOEM_MODEL_MORPH_TYPE_VERTEX) {
+                const nanoem_model_morph_vertex_t *const *children =
+                    nanoemModelMorphGetAllVertexMorphObjects(morphs[i], &numChildren);
+                if (numChildren > 0) {
+                    morphPtr = morphs[i];
+                    child = const_cast<nanoem_model_morph_vertex_t *>(children[0]);
+                }
+            }
+        }
+        REQUIRE(morphPtr);
+        const model::Vertex *vertex = model::Vertex::cast(nanoemModelMorphVertexGetVertexObject(child));
+        const Vector4 origin(glm::make_vec3(nanoemModelMorphVertexGetPosition(child)), 0);
+        /* the packed deltas are resolved on the first deformation */
+        model::Morph::cast(morphPtr)->setWeight(1.0f);
+        activeModel->resetAllVertices();
+        activeModel->deformAllMorphs(false);
+        CHECK_THAT(toVector4(vertex->m_simd.m_delta), Equals(origin));
+        const Vector4 edited(origin + Vector4(1, 2, 3, 0));
+        project->setModelEditingEnabled(true);
+        {
+            nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+            nanoem_mutable_model_morph_vertex_t *mutableChild =
+                nanoemMutableModelMorphVertexCreateAsReference(child, &status);
+            nanoemMutableModelMorphVertexSetPosition(mutableChild, glm::value_ptr(edited));
+            nanoemMutableModelMorphVertexDestroy(mutableChild);
+        }
+        project->setModelEditingEnabled(false);
+        vertex = model::Vertex::cast(nanoemModelMorphVertexGetVertexObject(child));
+        activeModel->resetAllVertices();
+        activeModel->deformAllMorphs(false);
+        CHECK_THAT(toVector4(vertex->m_simd.m_delta), Equals(edited));
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,108 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/PhysicsEngine.h"
+#include "emapp/model/Bone.h"
+
+using namespace nanoem;
+using namespace test;
+
+TEST_CASE("model_physics_island_split_and_merge", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *firstModel = o->createModel();
+        Model *secondModel = o->createModel();
+        project->addModel(firstModel);
+        project->addModel(secondModel);
+        PhysicsEngine *engine = project->physicsEngine();
+        nanoem_rsize_t numRigidBodies;
+        nanoemModelGetAllRigidBodyObjects(firstModel->data(), &numRigidBodies);
+        /* islands without any rigid bodies are not counted so models having no rigid bodies stay in the shared */
+        const nanoem_rsize_t numModelIslands = numRigidBodies > 0 && engine->isAvailable() ? 1 : 0;
+        CHECK(engine->numIslands() == 1);
+        engine->setIslandEnabled(true);
+        CHECK(engine->numIslands() == 1 + numModelIslands * 2);
+        engine->mergeIslands(firstModel->data(), secondModel->data());
+        CHECK(engine->numIslands() == 1 + numModelIslands);
+        engine->stepSimulation(1.0f / 60.0f);
+        engine->setIslandEnabled(false);
+        CHECK(engine->numIslands() == 1);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_physics_island_merge_overlapping", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *firstModel = o->createModel();
+        Model *secondModel = o->createModel();
+        project->addModel(firstModel);
+        project->addModel(secondModel);
+        PhysicsEngine *engine = project->physicsEngine();
+        nanoem_rsize_t numRigidBodies;
+        nanoemModelGetAllRigidBodyObjects(firstModel->data(), &numRigidBodies);
+        const nanoem_rsize_t numModelIslands = numRigidBodies > 0 && engine->isAvailable() ? 1 : 0;
+        engine->setIslandEnabled(true);
+        CHECK(engine->numIslands() == 1 + numModelIslands * 2);
+        /* both models are placed at the same origin so rigid bodies of these overlap each other */
+        engine->stepSimulation(1.0f / 60.0f);
+        CHECK(engine->numIslands() == 1 + numModelIslands);
+        engine->setIslandEnabled(false);
+        CHECK(engine->numIslands() == 1);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+/* run this with the TSan build type to detect races between islands stepped concurrently */
+TEST_CASE("model_physics_island_step_concurrently", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *firstModel = o->createModel();
+        Model *secondModel = o->createModel();
+        project->addModel(firstModel);
+        project->addModel(secondModel);
+        PhysicsEngine *engine = project->physicsEngine();
+        nanoem_rsize_t numRigidBodies, numBones;
+        nanoemModelGetAllRigidBodyObjects(firstModel->data(), &numRigidBodies);
+        const nanoem_rsize_t numModelIslands = numRigidBodies > 0 && engine->isAvailable() ? 1 : 0;
+        /* moves the second model away so rigid bodies of both models never overlap and are never merged */
+        nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(secondModel->data(), &numBones);
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            const nanoem_model_bone_t *bonePtr = bones[i];
+            model::Bone *bone = model::Bone::cast(bonePtr);
+            if (bone && !nanoemModelBoneGetParentBoneObject(bonePtr)) {
+                bone->setLocalUserTranslation(Vector3(1000, 0, 0));
+            }
+        }
+        secondModel->performAllBonesTransform();
+        secondModel->initializeAllRigidBodiesTransformFeedback();
+        engine->setIslandEnabled(true);
+        REQUIRE(engine->numIslands() == 1 + numModelIslands * 2);
+        for (int i = 0; i < 60; i++) {
+            engine->stepSimulation(1.0f / 60.0f);
+            firstModel->synchronizeAllRigidBodiesTransformFeedbackFromSimulation(
+                PhysicsEngine::kRigidBodyFollowBoneSkip);
+            secondModel->synchronizeAllRigidBodiesTransformFeedbackFromSimulation(
+                PhysicsEngine::kRigidBodyFollowBoneSkip);
+        }
+        CHECK(engine->numIslands() == 1 + numModelIslands * 2);
+        engine->setIslandEnabled(false);
+        CHECK(engine->numIslands() == 1);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,126 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/model/Bone.h"
+#include "emapp/model/Vertex.h"
+
+#include "nanoem/ext/mutable.h"
+
+namespace nanoem {
+namespace internal {
+
+class SkinningBatchTester {
+public:
+    static void
+    performAllSkinningBatches(Model *model, nanoem_u8_t *ptr, nanoem_rsize_t numVertices)
+    {
+        model->performAllSkinningBatches(ptr, numVertices);
+    }
+};
+
+} /* namespace internal */
+} /* namespace nanoem */
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static Vector3
+toVector3(const bx::simd128_t &value)
+{
+    return Vector3(bx::simd_x(value), bx::simd_y(value), bx::simd_z(value));
+}
+
+static void
+checkAllSkinningBatches(Model *activeModel)
+{
+    nanoem_rsize_t numVertices;
+    nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
+    tinystl::vector<Vector3, TinySTLAllocator> expectedPositions(numVertices), expectedNormals(numVertices);
+    for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+        bx::simd128_t p, n;
+        Model::VertexUnit::performSkinningByType(model::Vertex::cast(vertices[i]), &p, &n);
+        expectedPositions[i] = toVector3(p);
+        expectedNormals[i] = toVector3(n);
+    }
+    ByteArray bytes(sizeof(Model::VertexUnit) * numVertices);
+    internal::SkinningBatchTester::performAllSkinningBatches(activeModel, bytes.data(), numVertices);
+    const Model::VertexUnit *units = reinterpret_cast<const Model::VertexUnit *>(bytes.data());
+    for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+        CHECK_THAT(toVector3(units[i].m_position), Equals(expectedPositions[i]));
+        CHECK_THAT(toVector3(units[i].m_normal), Equals(expectedNormals[i]));
+    }
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("model_skinning_batch_equals_per_vertex_skinning", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        CHECK(project->drawType() == IDrawable::kDrawTypeColor);
+        activeModel->resetAllVertices();
+        nanoem_rsize_t numBones;
+        nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(activeModel->data(), &numBones);
+        for (nanoem_rsize_t i = 0; i < numBones; i++) {
+            model::Bone *bone = model::Bone::cast(bones[i]);
+            const nanoem_f32_t value = nanoem_f32_t(i + 1);
+            bone->setLocalUserTranslation(Vector3(value * 0.1f, -value * 0.2f, value * 0.05f));
+            bone->setLocalUserOrientation(glm::angleAxis(value * 0.1f, glm::normalize(Vector3(1, value, 2))));
+        }
+        activeModel->performAllBonesTransform();
+        SECTION("bucketed by the vertex type")
+        {
+            checkAllSkinningBatches(activeModel);
+        }
+        SECTION("blended vertices are skinned four at once")
+        {
+            nanoem_rsize_t numVertices;
+            nanoem_model_vertex_t *const *vertices =
+                nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
+            nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+            for (nanoem_rsize_t i = 0; i < numVertices; i++) {
+                static const nanoem_f32_t kWeights[] = { 0.25f, 0.0f, 0.5f, 1.0f, 0.75f };
+                const nanoem_f32_t weight = kWeights[i % BX_COUNTOF(kWeights)];
+                nanoem_mutable_model_vertex_t *vertex = nanoemMutableModelVertexCreateAsReference(vertices[i], &status);
+                nanoemMutableModelVertexSetType(vertex, NANOEM_MODEL_VERTEX_TYPE_BDEF2);
+                nanoemMutableModelVertexSetBoneWeight(vertex, weight, 0);
+                nanoemMutableModelVertexSetBoneWeight(vertex, 1.0f - weight, 1);
+                nanoemMutableModelVertexDestroy(vertex);
+                model::Vertex *v = model::Vertex::cast(vertices[i]);
+                v->initialize(vertices[i]);
+                v->setupBoneBinding(vertices[i], activeModel);
+            }
+            activeModel->invalidateAllSkinningBatches();
+            checkAllSkinningBatches(activeModel);
+        }
+        SECTION("the vertex type is changed after bucketing")
+        {
+            checkAllSkinningBatches(activeModel);
+            nanoem_rsize_t numVertices;
+            nanoem_model_vertex_t *const *vertices =
+                nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
+            nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+            for (nanoem_rsize_t i = 0; i < numVertices; i += 3) {
+                nanoem_mutable_model_vertex_t *vertex = nanoemMutableModelVertexCreateAsReference(vertices[i], &status);
+                nanoemMutableModelVertexSetType(vertex, NANOEM_MODEL_VERTEX_TYPE_BDEF1);
+                nanoemMutableModelVertexDestroy(vertex);
+            }
+            /* the stale batches take the slow path first and then are rebuilt on the next call */
+            checkAllSkinningBatches(activeModel);
+            checkAllSkinningBatches(activeModel);
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,160 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/command/ModelObjectCommand.h"
+#include "emapp/model/Validator.h"
+
+#include "nanoem/ext/mutable.h"
+
+#include <limits>
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static const nanoem_u32_t kAllSeverities = model::Validator::kSeverityTypeInfo |
+    model::Validator::kSeverityTypeWarning | model::Validator::kSeverityTypeError |
+    model::Validator::kSeverityTypeFatal;
+
+static void
+checkSameDiagnostics(const model::Validator::DiagnosticsList &a, const model::Validator::DiagnosticsList &b)
+{
+    REQUIRE(a.size() == b.size());
+    for (nanoem_rsize_t i = 0, size = a.size(); i < size; i++) {
+        CHECK(a[i].m_message == b[i].m_message);
+        CHECK(a[i].m_severity == b[i].m_severity);
+        CHECK(a[i].u.m_vertexPtr == b[i].u.m_vertexPtr);
+    }
+}
+
+static bool
+containsDiagnostics(const model::Validator::DiagnosticsList &diagnostics, model::Validator::MessageType message,
+    const nanoem_model_vertex_t *vertexPtr)
+{
+    bool found = false;
+    for (model::Validator::DiagnosticsList::const_iterator it = diagnostics.begin(), end = diagnostics.end();
+         it != end; ++it) {
+        if (it->m_message == message && it->u.m_vertexPtr == vertexPtr) {
+            found = true;
+        }
+    }
+    return found;
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("model_validator_incremental", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        model::Validator *validator = activeModel->validator();
+        CHECK(activeModel->validator() == validator);
+        model::Validator::DiagnosticsList first, second;
+        validator->validate(activeModel, kAllSeverities, first);
+        validator->validate(activeModel, kAllSeverities, second);
+        checkSameDiagnostics(first, second);
+        nanoem_rsize_t numVertices;
+        nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
+        REQUIRE(numVertices > 0);
+        nanoem_model_vertex_t *vertexPtr = vertices[numVertices - 1];
+        {
+            nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+            nanoem_mutable_model_vertex_t *vertex = nanoemMutableModelVertexCreateAsReference(vertexPtr, &status);
+            const Vector4 origin(std::numeric_limits<nanoem_f32_t>::quiet_NaN(), 0, 0, 1);
+            nanoemMutableModelVertexSetOrigin(vertex, glm::value_ptr(origin));
+            nanoemMutableModelVertexDestroy(vertex);
+        }
+        /* not revalidated until the vertex is marked as edited */
+        const nanoem_u32_t generation = activeModel->editGeneration();
+        model::Validator::DiagnosticsList stale;
+        validator->validate(activeModel, kAllSeverities, stale);
+        checkSameDiagnostics(first, stale);
+        activeModel->markObjectEdited(Model::kEditObjectTypeVertex, vertexPtr);
+        CHECK(activeModel->editGeneration() > generation);
+        CHECK(activeModel->lastEditGeneration(Model::kEditObjectTypeVertex) == activeModel->editGeneration());
+        CHECK(activeModel->lastEditGeneration(Model::kEditObjectTypeBone) < activeModel->editGeneration());
+        model::Vertex::List editedVertices;
+        activeModel->getAllEditedVertexObjects(generation, editedVertices);
+        REQUIRE(editedVertices.size() == 1);
+        CHECK(editedVertices[0] == vertexPtr);
+        model::Validator::DiagnosticsList incremental, full;
+        validator->validate(activeModel, kAllSeverities, incremental);
+        CHECK(incremental.size() == first.size() + 1);
+        {
+            model::Validator fresh;
+            fresh.validate(activeModel, kAllSeverities, full);
+        }
+        checkSameDiagnostics(incremental, full);
+        CHECK(containsDiagnostics(incremental, model::Validator::kMessageTypePrimitiveFloatNaN, vertexPtr));
+        activeModel->markAllObjectsEdited();
+        CHECK(activeModel->allObjectsEditGeneration() == activeModel->editGeneration());
+        editedVertices.clear();
+        activeModel->getAllEditedVertexObjects(generation, editedVertices);
+        CHECK(editedVertices.empty());
+        model::Validator::DiagnosticsList revalidated;
+        validator->validate(activeModel, kAllSeverities, revalidated);
+        checkSameDiagnostics(full, revalidated);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("model_validator_incremental_scoped_mutable_objects", "[emapp][model]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        model::Validator *validator = activeModel->validator();
+        model::Validator::DiagnosticsList first, result, full;
+        validator->validate(activeModel, kAllSeverities, first);
+        nanoem_rsize_t numVertices;
+        nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(activeModel->data(), &numVertices);
+        REQUIRE(numVertices > 0);
+        nanoem_model_vertex_t *vertexPtr = vertices[0];
+        SECTION("editing a vertex through the scoped object revalidates it")
+        {
+            {
+                command::ScopedMutableVertex vertex(activeModel, vertexPtr);
+                const Vector4 origin(std::numeric_limits<nanoem_f32_t>::quiet_NaN(), 0, 0, 1);
+                nanoemMutableModelVertexSetOrigin(vertex, glm::value_ptr(origin));
+            }
+            validator->validate(activeModel, kAllSeverities, result);
+            CHECK(containsDiagnostics(result, model::Validator::kMessageTypePrimitiveFloatNaN, vertexPtr));
+        }
+        SECTION("editing a bone through the scoped object revalidates vertices")
+        {
+            {
+                nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+                nanoem_mutable_model_vertex_t *vertex = nanoemMutableModelVertexCreateAsReference(vertexPtr, &status);
+                nanoemMutableModelVertexSetType(vertex, NANOEM_MODEL_VERTEX_TYPE_BDEF1);
+                nanoemMutableModelVertexSetBoneObject(vertex, nullptr, 0);
+                nanoemMutableModelVertexDestroy(vertex);
+            }
+            {
+                nanoem_model_bone_t *bonePtr = const_cast<nanoem_model_bone_t *>(TestScope::findFirstBone(activeModel));
+                const Vector4 origin(glm::make_vec3(nanoemModelBoneGetOrigin(bonePtr)), 1);
+                command::ScopedMutableBone bone(activeModel, bonePtr);
+                nanoemMutableModelBoneSetOrigin(bone, glm::value_ptr(origin));
+            }
+            validator->validate(activeModel, kAllSeverities, result);
+            CHECK(containsDiagnostics(result, model::Validator::kMessageTypeVertexNullBoneObject, vertexPtr));
+        }
+        model::Validator fresh;
+        fresh.validate(activeModel, kAllSeverities, full);
+        checkSameDiagnostics(result, full);
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,81 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+
+using namespace nanoem;
+using namespace test;
+
+TEST_CASE("project_model_transform_levels", "[emapp][project]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *firstModel = o->createModel();
+        Model *secondModel = o->createModel();
+        Model *thirdModel = o->createModel();
+        firstModel->setName("first");
+        secondModel->setName("second");
+        thirdModel->setName("third");
+        project->addModel(firstModel);
+        project->addModel(secondModel);
+        project->addModel(thirdModel);
+        Project::ModelList models;
+        models.push_back(firstModel);
+        models.push_back(secondModel);
+        models.push_back(thirdModel);
+        Project::ModelTransformLevelList levels;
+        SECTION("models without outside parents share the same level")
+        {
+            Project::computeAllModelTransformLevels(models, levels);
+            REQUIRE(levels.size() == 3);
+            CHECK(levels[0] == 0);
+            CHECK(levels[1] == 0);
+            CHECK(levels[2] == 0);
+        }
+        SECTION("a model referring the preceding model is transformed after it")
+        {
+            secondModel->setOutsideParent(TestScope::findFirstBone(secondModel), StringPair("first", "bone"));
+            Project::computeAllModelTransformLevels(models, levels);
+            REQUIRE(levels.size() == 3);
+            CHECK(levels[0] == 0);
+            CHECK(levels[1] == 1);
+            CHECK(levels[2] == 0);
+        }
+        SECTION("a model referring the following model is transformed before it")
+        {
+            firstModel->setOutsideParent(TestScope::findFirstBone(firstModel), StringPair("third", "bone"));
+            Project::computeAllModelTransformLevels(models, levels);
+            REQUIRE(levels.size() == 3);
+            CHECK(levels[0] == 0);
+            CHECK(levels[1] == 0);
+            CHECK(levels[2] == 1);
+        }
+        SECTION("chained outside parents are transformed in the order")
+        {
+            secondModel->setOutsideParent(TestScope::findFirstBone(secondModel), StringPair("first", "bone"));
+            thirdModel->setOutsideParent(TestScope::findFirstBone(thirdModel), StringPair("second", "bone"));
+            Project::computeAllModelTransformLevels(models, levels);
+            REQUIRE(levels.size() == 3);
+            CHECK(levels[0] == 0);
+            CHECK(levels[1] == 1);
+            CHECK(levels[2] == 2);
+        }
+        SECTION("an outside parent of the unknown model is ignored")
+        {
+            secondModel->setOutsideParent(TestScope::findFirstBone(secondModel), StringPair("unknown", "bone"));
+            Project::computeAllModelTransformLevels(models, levels);
+            REQUIRE(levels.size() == 3);
+            CHECK(levels[0] == 0);
+            CHECK(levels[1] == 0);
+            CHECK(levels[2] == 0);
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
@@ -0,0 +1,144 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/CommandRegistrator.h"
+#include "emapp/Model.h"
+#include "emapp/internal/project/Redo.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static void
+registerBoneKeyframe(Project *project, Model *model, nanoem_frame_index_t frameIndex, const Vector3 &translation)
+{
+    CommandRegistrator registrator(project);
+    project->seek(frameIndex, true);
+    model::Bone *bone = model::Bone::cast(model->activeBone());
+    bone->setLocalUserTranslation(translation);
+    bone->setDirty(true);
+    model->performAllBonesTransform();
+    registrator.registerAddBoneKeyframesCommandBySelectedBoneSet(model);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("project_redo_checkpoint", "[emapp][project]")
+{
+    {
+        TestScope scope;
+        ProjectPtr first = scope.createProject();
+        Project *firstProject = first->withRecoverable();
+        firstProject->setRedoCheckpointInterval(1);
+        firstProject->setBezierCurveAdjustmentEnabled(false);
+        Model *activeModel = first->createModel();
+        firstProject->addModel(activeModel);
+        firstProject->setActiveModel(activeModel);
+        registerBoneKeyframe(firstProject, activeModel, 1337, Vector3(0.1, 0.2, 0.3));
+        firstProject->writeRedoCheckpoint();
+        /* written after the checkpoint so only these are replayed */
+        registerBoneKeyframe(firstProject, activeModel, 42, Vector3(0.4, 0.5, 0.6));
+    }
+    INFO("restore the checkpoint only")
+    {
+        TestScope scope;
+        ProjectPtr second = scope.createProject();
+        Project *secondProject = second->m_project;
+        Error error;
+        IFileReader *reader = FileUtils::createFileReader(secondProject->translator());
+        REQUIRE(reader->open(URI::createFromFilePath("test.redo"), error));
+        internal::project::Redo redo(secondProject);
+        const nanoem_i64_t offset = redo.restoreCheckpoint(reader, scope.application(), error);
+        CHECK(offset > nanoem_i64_t(sizeof(internal::project::Redo::kFileMagic)));
+        CHECK(nanoem_rsize_t(offset) < reader->size());
+        FileUtils::destroyFileReader(reader);
+        REQUIRE(secondProject->allModels()->size() == 1);
+        Model *model = secondProject->allModels()->data()[0];
+        CHECK(second->findBoneKeyframe(model, 1337));
+        CHECK_FALSE(second->findBoneKeyframe(model, 42));
+    }
+    INFO("recover the checkpoint and the tail")
+    {
+        TestScope scope;
+        ProjectPtr third = scope.createProject();
+        Project *thirdProject = third->m_project;
+        scope.recover(thirdProject);
+        REQUIRE(thirdProject->allModels()->size() == 1);
+        Model *model = thirdProject->allModels()->data()[0];
+        const nanoem_motion_bone_keyframe_t *keyframe = third->findBoneKeyframe(model, 1337);
+        REQUIRE(keyframe);
+        CHECK_THAT(glm::make_vec3(nanoemMotionBoneKeyframeGetTranslation(keyframe)), Equals(Vector3(0.1, 0.2, 0.3)));
+        keyframe = third->findBoneKeyframe(model, 42);
+        REQUIRE(keyframe);
+        CHECK_THAT(glm::make_vec3(nanoemMotionBoneKeyframeGetTranslation(keyframe)), Equals(Vector3(0.4, 0.5, 0.6)));
+    }
+}
+
+TEST_CASE("project_redo_journal_flush", "[emapp][project]")
+{
+    TestScope scope;
+    ProjectPtr first = scope.createProject();
+    Project *firstProject = first->withRecoverable();
+    firstProject->setRedoCheckpointInterval(1);
+    firstProject->setBezierCurveAdjustmentEnabled(false);
+    Model *activeModel = first->createModel();
+    firstProject->addModel(activeModel);
+    firstProject->setActiveModel(activeModel);
+    registerBoneKeyframe(firstProject, activeModel, 1337, Vector3(0.1, 0.2, 0.3));
+    /* the snapshot is packed on the journal thread after the checkpoint is requested */
+    firstProject->writeRedoCheckpoint();
+    registerBoneKeyframe(firstProject, activeModel, 42, Vector3(0.4, 0.5, 0.6));
+    Error error;
+    firstProject->flushRedoJournal(error);
+    CHECK_FALSE(error.hasReason());
+    {
+        /* all of records are readable while the first project is still alive */
+        ProjectPtr second = scope.createProject();
+        Project *secondProject = second->m_project;
+        IFileReader *reader = FileUtils::createFileReader(secondProject->translator());
+        REQUIRE(reader->open(URI::createFromFilePath("test.redo"), error));
+        internal::project::Redo redo(secondProject);
+        CHECK(redo.restoreCheckpoint(reader, scope.application(), error) > 0);
+        FileUtils::destroyFileReader(reader);
+        REQUIRE(secondProject->allModels()->size() == 1);
+        CHECK(second->findBoneKeyframe(secondProject->allModels()->data()[0], 1337));
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
+
+TEST_CASE("project_redo_find_restart_offset", "[emapp][project]")
+{
+    using internal::project::Redo;
+    ByteArray bytes, body(16, 0x2a);
+    MemoryWriter writer(&bytes);
+    Error error;
+    FileUtils::writeTyped(&writer, Redo::kFileMagic, error);
+    Redo::writeCommandRecord(&writer, 1, 1, body, error);
+    const nanoem_i64_t checkpointOffset = nanoem_i64_t(bytes.size());
+    Redo::writeCheckpointRecord(&writer, 2, body, body.size(), error);
+    Redo::writeCommandRecord(&writer, 3, 1, body, error);
+    SECTION("the trailing index is used")
+    {
+        Redo::writeIndexRecord(&writer, 3, checkpointOffset, error);
+        MemoryReader reader(&bytes);
+        CHECK(Redo::findRestartOffset(&reader, error) == checkpointOffset);
+    }
+    SECTION("records are scanned if the trailing index has no restart offset")
+    {
+        Redo::writeIndexRecord(&writer, 3, 0, error);
+        MemoryReader reader(&bytes);
+        CHECK(Redo::findRestartOffset(&reader, error) == checkpointOffset);
+    }
+    SECTION("records are scanned without any trailing index")
+    {
+        MemoryReader reader(&bytes);
+        CHECK(Redo::findRestartOffset(&reader, error) == checkpointOffset);
+    }
+    CHECK_FALSE(error.hasReason());
+}
@@ -0,0 +1,68 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/model/Bone.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static bool
+isSameSkeleton(const Model *left, const Model *right)
+{
+    nanoem_rsize_t numLeftBones, numRightBones;
+    nanoem_model_bone_t *const *leftBones = nanoemModelGetAllBoneObjects(left->data(), &numLeftBones);
+    nanoem_model_bone_t *const *rightBones = nanoemModelGetAllBoneObjects(right->data(), &numRightBones);
+    bool same = numLeftBones == numRightBones;
+    for (nanoem_rsize_t i = 0; same && i < numLeftBones; i++) {
+        const model::Bone *leftBone = model::Bone::cast(leftBones[i]), *rightBone = model::Bone::cast(rightBones[i]);
+        same = leftBone && rightBone && leftBone->worldTransform() == rightBone->worldTransform();
+    }
+    return same;
+}
+
+} /* namespace anonymous */
+
+/* run this with the TSan build type to detect races between models synchronized concurrently */
+TEST_CASE("project_synchronize_all_motions_in_parallel", "[emapp][project]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *models[4];
+        for (size_t i = 0; i < BX_COUNTOF(models); i++) {
+            models[i] = o->createModel();
+            project->addModel(models[i]);
+        }
+        SECTION("models are transformed same as the serial one")
+        {
+            project->synchronizeAllMotions(0, 0, PhysicsEngine::kSimulationTimingBefore);
+            project->synchronizeAllMotions(0, 0, PhysicsEngine::kSimulationTimingAfter);
+            for (size_t i = 1; i < BX_COUNTOF(models); i++) {
+                CHECK(isSameSkeleton(models[0], models[i]));
+            }
+        }
+        SECTION("constraint joints are resolved again in editing mode")
+        {
+            project->setActiveModel(models[0]);
+            project->setModelEditingEnabled(true);
+            for (nanoem_frame_index_t frameIndex = 0; frameIndex < 3; frameIndex++) {
+                project->synchronizeAllMotions(frameIndex, 0, PhysicsEngine::kSimulationTimingBefore);
+                project->synchronizeAllMotions(frameIndex, 0, PhysicsEngine::kSimulationTimingAfter);
+            }
+            for (size_t i = 1; i < BX_COUNTOF(models); i++) {
+                CHECK(isSameSkeleton(models[0], models[i]));
+            }
+            project->setModelEditingEnabled(false);
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
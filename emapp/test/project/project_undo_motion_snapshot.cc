@@ -0,0 +1,81 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Motion.h"
+#include "emapp/command/MotionSnapshotCommand.h"
+
+#include "nanoem/ext/mutable.h"
+#include "undo/undo.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static undo_command_t *
+addCameraKeyframe(Motion *motion, nanoem_frame_index_t frameIndex)
+{
+    ByteArray snapshot;
+    Error error;
+    motion->save(snapshot, nullptr, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutableMotion = nanoemMutableMotionCreateAsReference(motion->data(), &status);
+    nanoem_mutable_motion_camera_keyframe_t *keyframe =
+        nanoemMutableMotionCameraKeyframeCreate(motion->data(), &status);
+    nanoemMutableMotionAddCameraKeyframe(mutableMotion, keyframe, frameIndex, &status);
+    nanoemMutableMotionSortAllKeyframes(mutableMotion);
+    nanoemMutableMotionCameraKeyframeDestroy(keyframe);
+    nanoemMutableMotionDestroy(mutableMotion);
+    motion->setDirty(true);
+    return command::MotionSnapshotCommand::create(
+        motion, nullptr, snapshot, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_CAMERA);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("project_undo_motion_snapshot_without_serializing_present", "[emapp][project]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Motion *motion = project->cameraMotion();
+        for (nanoem_frame_index_t i = 1; i <= 3; i++) {
+            project->pushUndo(addCameraKeyframe(motion, i * 10));
+        }
+        /* the loaded bytes of the last redo are reused as the present state */
+        CHECK(project->findMotionUndoSnapshot(motion, 0));
+        SECTION("undo and redo all of the commands")
+        {
+            for (int i = 0; i < 3; i++) {
+                project->handleUndoAction();
+            }
+            CHECK_FALSE(motion->findCameraKeyframe(10));
+            CHECK_FALSE(motion->findCameraKeyframe(20));
+            CHECK_FALSE(motion->findCameraKeyframe(30));
+            for (int i = 0; i < 3; i++) {
+                project->handleRedoAction();
+            }
+            CHECK(motion->findCameraKeyframe(10));
+            CHECK(motion->findCameraKeyframe(20));
+            CHECK(motion->findCameraKeyframe(30));
+        }
+        SECTION("the present state is serialized again after the motion is edited")
+        {
+            project->handleUndoAction();
+            motion->setDirty(true);
+            CHECK_FALSE(project->findMotionUndoSnapshot(motion, 0));
+            project->handleUndoAction();
+            CHECK(motion->findCameraKeyframe(10));
+            CHECK_FALSE(motion->findCameraKeyframe(20));
+            CHECK_FALSE(motion->findCameraKeyframe(30));
+            CHECK(project->findMotionUndoSnapshot(motion, 0));
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
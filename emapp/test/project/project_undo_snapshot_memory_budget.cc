@@ -0,0 +1,115 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of emapp component and it's licensed under Mozilla Public License. see LICENSE.md for more details.
+ */
+
+#include "../common.h"
+
+#include "emapp/Model.h"
+#include "emapp/Motion.h"
+#include "emapp/command/MotionSnapshotCommand.h"
+
+#include "nanoem/ext/mutable.h"
+#include "undo/undo.h"
+
+using namespace nanoem;
+using namespace test;
+
+namespace {
+
+static undo_command_t *
+addCameraKeyframe(Motion *motion, nanoem_frame_index_t frameIndex)
+{
+    ByteArray snapshot;
+    Error error;
+    motion->save(snapshot, nullptr, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutableMotion = nanoemMutableMotionCreateAsReference(motion->data(), &status);
+    nanoem_mutable_motion_camera_keyframe_t *keyframe =
+        nanoemMutableMotionCameraKeyframeCreate(motion->data(), &status);
+    nanoemMutableMotionAddCameraKeyframe(mutableMotion, keyframe, frameIndex, &status);
+    nanoemMutableMotionSortAllKeyframes(mutableMotion);
+    nanoemMutableMotionCameraKeyframeDestroy(keyframe);
+    nanoemMutableMotionDestroy(mutableMotion);
+    return command::MotionSnapshotCommand::create(
+        motion, nullptr, snapshot, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_CAMERA);
+}
+
+static undo_command_t *
+addBoneKeyframe(Motion *motion, const Model *model, nanoem_frame_index_t frameIndex)
+{
+    ByteArray snapshot;
+    Error error;
+    motion->save(snapshot, model, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_ALL, error);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutableMotion = nanoemMutableMotionCreateAsReference(motion->data(), &status);
+    nanoem_mutable_motion_bone_keyframe_t *keyframe = nanoemMutableMotionBoneKeyframeCreate(motion->data(), &status);
+    const nanoem_unicode_string_t *name =
+        nanoemModelBoneGetName(TestScope::findFirstBone(model), NANOEM_LANGUAGE_TYPE_FIRST_ENUM);
+    nanoemMutableMotionAddBoneKeyframe(mutableMotion, keyframe, name, frameIndex, &status);
+    nanoemMutableMotionSortAllKeyframes(mutableMotion);
+    nanoemMutableMotionBoneKeyframeDestroy(keyframe);
+    nanoemMutableMotionDestroy(mutableMotion);
+    return command::MotionSnapshotCommand::create(motion, model, snapshot, NANOEM_MUTABLE_MOTION_KEYFRAME_TYPE_BONE);
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("project_undo_snapshot_memory_budget_evicts_oldest_across_stacks", "[emapp][project]")
+{
+    TestScope scope;
+    {
+        ProjectPtr o = scope.createProject();
+        Project *project = o->m_project;
+        Model *activeModel = o->createModel();
+        project->addModel(activeModel);
+        project->setActiveModel(activeModel);
+        Motion *cameraMotion = project->cameraMotion();
+        Motion *modelMotion = project->resolveMotion(activeModel);
+        const nanoem_model_bone_t *bonePtr = TestScope::findFirstBone(activeModel);
+        undo_stack_t *projectStack = project->undoStack(), *modelStack = activeModel->undoStack();
+        /* every snapshot exceeds the budget so only the latest command of the pushed stack survives */
+        project->setUndoSnapshotMemoryBudget(1);
+        project->pushUndo(addCameraKeyframe(cameraMotion, 42));
+        CHECK(undoStackGetOffset(projectStack) == 1);
+        CHECK(project->undoSnapshotMemoryUsage() > 0);
+        SECTION("the oldest command of the other stack is dropped first")
+        {
+            activeModel->pushUndo(addBoneKeyframe(modelMotion, activeModel, 43));
+            CHECK(undoStackGetOffset(projectStack) == 0);
+            CHECK(undoStackGetOffset(modelStack) == 1);
+            CHECK(cameraMotion->findCameraKeyframe(42));
+            /* the surviving command still undoes and redoes */
+            undoStackUndo(modelStack);
+            CHECK_FALSE(o->findBoneKeyframe(activeModel, bonePtr, 43));
+            undoStackRedo(modelStack);
+            CHECK(o->findBoneKeyframe(activeModel, bonePtr, 43));
+        }
+        SECTION("the latest command of the pushed stack is kept")
+        {
+            project->pushUndo(addCameraKeyframe(cameraMotion, 44));
+            CHECK(undoStackGetOffset(projectStack) == 1);
+            undoStackUndo(projectStack);
+            CHECK(cameraMotion->findCameraKeyframe(42));
+            CHECK_FALSE(cameraMotion->findCameraKeyframe(44));
+            undoStackRedo(projectStack);
+            CHECK(cameraMotion->findCameraKeyframe(44));
+        }
+        SECTION("nothing is dropped within the budget")
+        {
+            project->setUndoSnapshotMemoryBudget(Project::kDefaultUndoSnapshotMemoryBudget);
+            activeModel->pushUndo(addBoneKeyframe(modelMotion, activeModel, 43));
+            project->pushUndo(addCameraKeyframe(cameraMotion, 44));
+            CHECK(undoStackGetOffset(projectStack) == 2);
+            CHECK(undoStackGetOffset(modelStack) == 1);
+            undoStackUndo(projectStack);
+            undoStackUndo(projectStack);
+            CHECK_FALSE(cameraMotion->findCameraKeyframe(42));
+            CHECK_FALSE(cameraMotion->findCameraKeyframe(44));
+            undoStackRedo(projectStack);
+            CHECK(cameraMotion->findCameraKeyframe(42));
+        }
+    }
+    CHECK_FALSE(scope.hasAnyError());
+}
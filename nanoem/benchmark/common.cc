@@ -0,0 +1,335 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of nanoem component and it's licensed under MIT license. see LICENSE.md for more details.
+ */
+
+#include "./common.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace nanoem {
+namespace benchmark {
+namespace {
+
+static nanoem_u64_t s_throughputItems = 0;
+static nanoem_u64_t s_throughputBytes = 0;
+
+static void
+normalizeWeights(nanoem_f32_t *weights, nanoem_rsize_t size)
+{
+    nanoem_f32_t sum = 0;
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        sum += weights[i];
+    }
+    for (nanoem_rsize_t i = 0; i < size; i++) {
+        weights[i] /= sum;
+    }
+}
+
+static void
+generateAllBones(nanoem_mutable_model_t *model, nanoem_unicode_string_factory_t *factory,
+    const ModelParameters &parameters, Random &random, std::vector<const nanoem_model_bone_t *> &bones)
+{
+    nanoem_model_t *origin = nanoemMutableModelGetOriginObject(model);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    char name[32];
+    for (nanoem_rsize_t i = 0; i < parameters.m_numBones; i++) {
+        nanoem_mutable_model_bone_t *bone = nanoemMutableModelBoneCreate(origin, &status);
+        const nanoem_f32_t position[] = { random.uniform(-10, 10), random.uniform(0, 20), random.uniform(-10, 10), 0 };
+        boneName(i, name, sizeof(name));
+        StringScope s(factory, name);
+        nanoemMutableModelBoneSetName(bone, s.value(), NANOEM_LANGUAGE_TYPE_JAPANESE, &status);
+        nanoemMutableModelBoneSetName(bone, s.value(), NANOEM_LANGUAGE_TYPE_ENGLISH, &status);
+        nanoemMutableModelBoneSetOrigin(bone, position);
+        /* bones form a binary tree to make the hierarchy as deep as log2(N) */
+        nanoemMutableModelBoneSetParentBoneObject(bone, i > 0 ? bones[(i - 1) / 2] : NULL);
+        nanoemMutableModelBoneSetRotateable(bone, 1);
+        nanoemMutableModelBoneSetMovable(bone, 1);
+        nanoemMutableModelBoneSetVisible(bone, 1);
+        nanoemMutableModelBoneSetUserHandleable(bone, 1);
+        nanoemMutableModelInsertBoneObject(model, bone, -1, &status);
+        bones.push_back(nanoemMutableModelBoneGetOriginObject(bone));
+        nanoemMutableModelBoneDestroy(bone);
+    }
+}
+
+static void
+generateAllVertices(nanoem_mutable_model_t *model, const ModelParameters &parameters, Random &random,
+    const std::vector<const nanoem_model_bone_t *> &bones, std::vector<const nanoem_model_vertex_t *> &vertices)
+{
+    nanoem_model_t *origin = nanoemMutableModelGetOriginObject(model);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    const bool isPMX = parameters.m_format != NANOEM_MODEL_FORMAT_TYPE_PMD_1_0;
+    const nanoem_rsize_t numInfluences = isPMX ? 4 : 2, numBones = bones.size();
+    for (nanoem_rsize_t i = 0; i < parameters.m_numVertices; i++) {
+        nanoem_mutable_model_vertex_t *vertex = nanoemMutableModelVertexCreate(origin, &status);
+        const nanoem_f32_t position[] = { random.uniform(-10, 10), random.uniform(0, 20), random.uniform(-10, 10), 0 },
+                           normal[] = { 0, 1, 0, 0 }, texcoord[] = { random.uniform(0, 1), random.uniform(0, 1), 0, 0 };
+        nanoem_f32_t weights[4];
+        nanoemMutableModelVertexSetOrigin(vertex, position);
+        nanoemMutableModelVertexSetNormal(vertex, normal);
+        nanoemMutableModelVertexSetTexCoord(vertex, texcoord);
+        nanoemMutableModelVertexSetType(
+            vertex, isPMX ? NANOEM_MODEL_VERTEX_TYPE_BDEF4 : NANOEM_MODEL_VERTEX_TYPE_BDEF2);
+        for (nanoem_rsize_t j = 0; j < numInfluences; j++) {
+            weights[j] = random.uniform(0.05f, 1.0f);
+        }
+        normalizeWeights(weights, numInfluences);
+        for (nanoem_rsize_t j = 0; j < numInfluences; j++) {
+            nanoemMutableModelVertexSetBoneObject(vertex, numBones > 0 ? bones[random.next() % numBones] : NULL, j);
+            nanoemMutableModelVertexSetBoneWeight(vertex, weights[j], j);
+        }
+        nanoemMutableModelInsertVertexObject(model, vertex, -1, &status);
+        vertices.push_back(nanoemMutableModelVertexGetOriginObject(vertex));
+        nanoemMutableModelVertexDestroy(vertex);
+    }
+}
+
+static void
+generateAllMaterials(nanoem_mutable_model_t *model, const ModelParameters &parameters, Random &random)
+{
+    nanoem_model_t *origin = nanoemMutableModelGetOriginObject(model);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    const nanoem_rsize_t numVertices = parameters.m_numVertices, numMaterials = parameters.m_numMaterials,
+                         numTriangles = numVertices, numIndices = numTriangles * 3;
+    std::vector<nanoem_u32_t> indices(numIndices);
+    for (nanoem_rsize_t i = 0; i < numIndices; i++) {
+        indices[i] = nanoem_u32_t(random.next() % numVertices);
+    }
+    nanoemMutableModelSetVertexIndices(model, indices.data(), numIndices, &status);
+    nanoem_rsize_t rest = numTriangles;
+    for (nanoem_rsize_t i = 0; i < numMaterials; i++) {
+        nanoem_mutable_model_material_t *material = nanoemMutableModelMaterialCreate(origin, &status);
+        const nanoem_rsize_t numMaterialTriangles = i < numMaterials - 1 ? numTriangles / numMaterials : rest;
+        nanoemMutableModelMaterialSetNumVertexIndices(material, numMaterialTriangles * 3);
+        nanoemMutableModelInsertMaterialObject(model, material, -1, &status);
+        nanoemMutableModelMaterialDestroy(material);
+        rest -= numMaterialTriangles;
+    }
+}
+
+static void
+generateAllMorphs(nanoem_mutable_model_t *model, nanoem_unicode_string_factory_t *factory,
+    const ModelParameters &parameters, Random &random, const std::vector<const nanoem_model_vertex_t *> &vertices)
+{
+    nanoem_model_t *origin = nanoemMutableModelGetOriginObject(model);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    const nanoem_rsize_t numVertices = vertices.size();
+    char name[32];
+    for (nanoem_rsize_t i = 0; i < parameters.m_numMorphs; i++) {
+        nanoem_mutable_model_morph_t *morph = nanoemMutableModelMorphCreate(origin, &status);
+        morphName(i, name, sizeof(name));
+        StringScope s(factory, name);
+        nanoemMutableModelMorphSetName(morph, s.value(), NANOEM_LANGUAGE_TYPE_JAPANESE, &status);
+        nanoemMutableModelMorphSetName(morph, s.value(), NANOEM_LANGUAGE_TYPE_ENGLISH, &status);
+        nanoemMutableModelMorphSetType(morph, NANOEM_MODEL_MORPH_TYPE_VERTEX);
+        nanoemMutableModelMorphSetCategory(
+            morph, nanoem_model_morph_category_t(NANOEM_MODEL_MORPH_CATEGORY_EYEBROW + i % 4));
+        for (nanoem_rsize_t j = 0; j < parameters.m_numMorphVertices && numVertices > 0; j++) {
+            nanoem_mutable_model_morph_vertex_t *item = nanoemMutableModelMorphVertexCreate(morph, &status);
+            const nanoem_f32_t position[] = { random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1), 0 };
+            nanoemMutableModelMorphVertexSetVertexObject(item, vertices[random.next() % numVertices]);
+            nanoemMutableModelMorphVertexSetPosition(item, position);
+            nanoemMutableModelMorphInsertVertexMorphObject(morph, item, -1, &status);
+            nanoemMutableModelMorphVertexDestroy(item);
+        }
+        nanoemMutableModelInsertMorphObject(model, morph, -1, &status);
+        nanoemMutableModelMorphDestroy(morph);
+    }
+}
+
+} /* namespace anonymous */
+
+Random::Random(nanoem_u32_t seed)
+    : m_state(seed != 0 ? seed : 0x9e3779b9u)
+{
+}
+
+nanoem_u32_t
+Random::next()
+{
+    m_state ^= m_state << 13;
+    m_state ^= m_state >> 17;
+    m_state ^= m_state << 5;
+    return m_state;
+}
+
+nanoem_f32_t
+Random::uniform(nanoem_f32_t lower, nanoem_f32_t upper)
+{
+    return lower + (upper - lower) * ((next() >> 8) * (1.0f / 16777216.0f));
+}
+
+ModelParameters::ModelParameters(nanoem_model_format_type_t format)
+    : m_format(format)
+    , m_numVertices(65536)
+    , m_numMaterials(16)
+    , m_numBones(format == NANOEM_MODEL_FORMAT_TYPE_PMD_1_0 ? 128 : 512)
+    , m_numMorphs(format == NANOEM_MODEL_FORMAT_TYPE_PMD_1_0 ? 0 : 128)
+    , m_numMorphVertices(256)
+    , m_seed(0x6e616e6fu)
+{
+}
+
+MotionParameters::MotionParameters()
+    : m_numBones(512)
+    , m_numMorphs(128)
+    , m_numKeyframes(64)
+    , m_interval(5)
+    , m_seed(0x656d6d6fu)
+{
+}
+
+StringScope::StringScope(nanoem_unicode_string_factory_t *factory, const char *value)
+    : m_factory(factory)
+    , m_value(nullptr)
+{
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    m_value = nanoemUnicodeStringFactoryCreateString(
+        factory, reinterpret_cast<const nanoem_u8_t *>(value), strlen(value), &status);
+}
+
+StringScope::~StringScope()
+{
+    nanoemUnicodeStringFactoryDestroyString(m_factory, m_value);
+}
+
+const nanoem_unicode_string_t *
+StringScope::value() const
+{
+    return m_value;
+}
+
+void
+boneName(nanoem_rsize_t index, char *buffer, nanoem_rsize_t size)
+{
+    snprintf(buffer, size, "bone%04u", nanoem_u32_t(index));
+}
+
+void
+morphName(nanoem_rsize_t index, char *buffer, nanoem_rsize_t size)
+{
+    snprintf(buffer, size, "morph%04u", nanoem_u32_t(index));
+}
+
+nanoem_mutable_model_t *
+generateModel(nanoem_unicode_string_factory_t *factory, const ModelParameters &parameters)
+{
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_model_t *model = nanoemMutableModelCreate(factory, &status);
+    const bool isPMX = parameters.m_format != NANOEM_MODEL_FORMAT_TYPE_PMD_1_0;
+    Random random(parameters.m_seed);
+    std::vector<const nanoem_model_bone_t *> bones;
+    std::vector<const nanoem_model_vertex_t *> vertices;
+    nanoemMutableModelSetFormatType(model, parameters.m_format);
+    nanoemMutableModelSetCodecType(model, isPMX ? NANOEM_CODEC_TYPE_UTF16 : NANOEM_CODEC_TYPE_SJIS);
+    generateAllBones(model, factory, parameters, random, bones);
+    generateAllVertices(model, parameters, random, bones, vertices);
+    generateAllMaterials(model, parameters, random);
+    /* PMD vertex morphs are relative to the base morph that cannot be composed with the mutable API */
+    if (isPMX) {
+        generateAllMorphs(model, factory, parameters, random, vertices);
+    }
+    return model;
+}
+
+nanoem_mutable_motion_t *
+generateMotion(nanoem_unicode_string_factory_t *factory, const MotionParameters &parameters)
+{
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *motion = nanoemMutableMotionCreate(factory, &status);
+    nanoem_motion_t *origin = nanoemMutableMotionGetOriginObject(motion);
+    Random random(parameters.m_seed);
+    char name[32];
+    for (nanoem_rsize_t i = 0; i < parameters.m_numBones; i++) {
+        boneName(i, name, sizeof(name));
+        StringScope s(factory, name);
+        for (nanoem_rsize_t j = 0; j < parameters.m_numKeyframes; j++) {
+            nanoem_mutable_motion_bone_keyframe_t *keyframe = nanoemMutableMotionBoneKeyframeCreate(origin, &status);
+            const nanoem_f32_t translation[] = { random.uniform(-1, 1), random.uniform(-1, 1),
+                random.uniform(-1, 1), 0 };
+            nanoem_f32_t orientation[] = { random.uniform(-1, 1), random.uniform(-1, 1), random.uniform(-1, 1),
+                random.uniform(-1, 1) };
+            nanoem_f32_t length = 0;
+            for (int k = 0; k < 4; k++) {
+                length += orientation[k] * orientation[k];
+            }
+            length = sqrtf(length);
+            for (int k = 0; k < 4; k++) {
+                orientation[k] /= length;
+            }
+            nanoemMutableMotionBoneKeyframeSetTranslation(keyframe, translation);
+            nanoemMutableMotionBoneKeyframeSetOrientation(keyframe, orientation);
+            for (int k = NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_FIRST_ENUM;
+                 k < NANOEM_MOTION_BONE_KEYFRAME_INTERPOLATION_TYPE_MAX_ENUM; k++) {
+                const nanoem_u8_t interpolation[] = { nanoem_u8_t(random.next() % 128),
+                    nanoem_u8_t(random.next() % 128), nanoem_u8_t(random.next() % 128),
+                    nanoem_u8_t(random.next() % 128) };
+                nanoemMutableMotionBoneKeyframeSetInterpolation(
+                    keyframe, nanoem_motion_bone_keyframe_interpolation_type_t(k), interpolation);
+            }
+            nanoemMutableMotionAddBoneKeyframe(
+                motion, keyframe, s.value(), nanoem_frame_index_t(j * parameters.m_interval), &status);
+            nanoemMutableMotionBoneKeyframeDestroy(keyframe);
+        }
+    }
+    for (nanoem_rsize_t i = 0; i < parameters.m_numMorphs; i++) {
+        morphName(i, name, sizeof(name));
+        StringScope s(factory, name);
+        for (nanoem_rsize_t j = 0; j < parameters.m_numKeyframes; j++) {
+            nanoem_mutable_motion_morph_keyframe_t *keyframe = nanoemMutableMotionMorphKeyframeCreate(origin, &status);
+            nanoemMutableMotionMorphKeyframeSetWeight(keyframe, random.uniform(0, 1));
+            nanoemMutableMotionAddMorphKeyframe(
+                motion, keyframe, s.value(), nanoem_frame_index_t(j * parameters.m_interval), &status);
+            nanoemMutableMotionMorphKeyframeDestroy(keyframe);
+        }
+    }
+    return motion;
+}
+
+void
+saveModel(nanoem_mutable_model_t *model, Bytes &bytes)
+{
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_buffer_t *mutableBuffer = nanoemMutableBufferCreate(&status);
+    nanoemMutableModelSaveToBuffer(model, mutableBuffer, &status);
+    nanoem_buffer_t *buffer = nanoemMutableBufferCreateBufferObject(mutableBuffer, &status);
+    const nanoem_u8_t *ptr = nanoemBufferGetDataPtr(buffer);
+    bytes.assign(ptr, ptr + nanoemBufferGetLength(buffer));
+    nanoemBufferDestroy(buffer);
+    nanoemMutableBufferDestroy(mutableBuffer);
+}
+
+void
+saveMotion(nanoem_mutable_motion_t *motion, Bytes &bytes)
+{
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_buffer_t *mutableBuffer = nanoemMutableBufferCreate(&status);
+    nanoemMutableMotionSaveToBuffer(motion, mutableBuffer, &status);
+    nanoem_buffer_t *buffer = nanoemMutableBufferCreateBufferObject(mutableBuffer, &status);
+    const nanoem_u8_t *ptr = nanoemBufferGetDataPtr(buffer);
+    bytes.assign(ptr, ptr + nanoemBufferGetLength(buffer));
+    nanoemBufferDestroy(buffer);
+    nanoemMutableBufferDestroy(mutableBuffer);
+}
+
+void
+setThroughput(nanoem_u64_t items, nanoem_u64_t bytes)
+{
+    s_throughputItems = items;
+    s_throughputBytes = bytes;
+}
+
+void
+consumeThroughput(nanoem_u64_t &items, nanoem_u64_t &bytes)
+{
+    items = s_throughputItems;
+    bytes = s_throughputBytes;
+    s_throughputItems = s_throughputBytes = 0;
+}
+
+} /* namespace benchmark */
+} /* namespace nanoem */
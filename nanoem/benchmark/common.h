@@ -0,0 +1,87 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of nanoem component and it's licensed under MIT license. see LICENSE.md for more details.
+ */
+
+#pragma once
+#ifndef NANOEM_BENCHMARK_COMMON_H_
+#define NANOEM_BENCHMARK_COMMON_H_
+
+/* catch */
+#include "catch2/catch.hpp"
+
+/* nanoem core */
+#include "nanoem/nanoem.h"
+
+/* nanoem mutable extension */
+#include "nanoem/ext/mutable.h"
+
+#include <vector>
+
+namespace nanoem {
+namespace benchmark {
+
+typedef std::vector<nanoem_u8_t> Bytes;
+
+/* xorshift32 to generate the same inputs on every platform and every run */
+class Random {
+public:
+    Random(nanoem_u32_t seed);
+
+    nanoem_u32_t next();
+    nanoem_f32_t uniform(nanoem_f32_t lower, nanoem_f32_t upper);
+
+private:
+    nanoem_u32_t m_state;
+};
+
+struct ModelParameters {
+    ModelParameters(nanoem_model_format_type_t format);
+    nanoem_model_format_type_t m_format;
+    nanoem_rsize_t m_numVertices;
+    nanoem_rsize_t m_numMaterials;
+    nanoem_rsize_t m_numBones;
+    nanoem_rsize_t m_numMorphs;
+    nanoem_rsize_t m_numMorphVertices;
+    nanoem_u32_t m_seed;
+};
+
+struct MotionParameters {
+    MotionParameters();
+    nanoem_rsize_t m_numBones;
+    nanoem_rsize_t m_numMorphs;
+    nanoem_rsize_t m_numKeyframes;
+    nanoem_frame_index_t m_interval;
+    nanoem_u32_t m_seed;
+};
+
+class StringScope {
+public:
+    StringScope(nanoem_unicode_string_factory_t *factory, const char *value);
+    ~StringScope();
+
+    const nanoem_unicode_string_t *value() const;
+
+private:
+    nanoem_unicode_string_factory_t *m_factory;
+    nanoem_unicode_string_t *m_value;
+};
+
+/* names of generated bones and morphs are shared between models and motions so that motions can bind to models */
+void boneName(nanoem_rsize_t index, char *buffer, nanoem_rsize_t size);
+void morphName(nanoem_rsize_t index, char *buffer, nanoem_rsize_t size);
+
+nanoem_mutable_model_t *generateModel(nanoem_unicode_string_factory_t *factory, const ModelParameters &parameters);
+nanoem_mutable_motion_t *generateMotion(nanoem_unicode_string_factory_t *factory, const MotionParameters &parameters);
+void saveModel(nanoem_mutable_model_t *model, Bytes &bytes);
+void saveMotion(nanoem_mutable_motion_t *motion, Bytes &bytes);
+
+/* declares amount of work per iteration of the next BENCHMARK to be reported as throughput */
+void setThroughput(nanoem_u64_t items, nanoem_u64_t bytes);
+void consumeThroughput(nanoem_u64_t &items, nanoem_u64_t &bytes);
+
+} /* namespace benchmark */
+} /* namespace nanoem */
+
+#endif /* NANOEM_BENCHMARK_COMMON_H_ */
@@ -0,0 +1,110 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of nanoem component and it's licensed under MIT license. see LICENSE.md for more details.
+ */
+
+#include "./common.h"
+
+using namespace nanoem::benchmark;
+
+namespace {
+
+class ModelFixture {
+public:
+    ModelFixture(const ModelParameters &parameters)
+        : m_factory(nullptr)
+        , m_model(nullptr)
+    {
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        m_factory = nanoemUnicodeStringFactoryCreate(&status);
+        m_model = generateModel(m_factory, parameters);
+        saveModel(m_model, m_bytes);
+    }
+    ~ModelFixture()
+    {
+        nanoemMutableModelDestroy(m_model);
+        nanoemUnicodeStringFactoryDestroy(m_factory);
+    }
+
+    nanoem_unicode_string_factory_t *m_factory;
+    nanoem_mutable_model_t *m_model;
+    Bytes m_bytes;
+};
+
+static void
+benchmarkLoadModel(const char *name, const ModelParameters &parameters)
+{
+    ModelFixture fixture(parameters);
+    {
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        nanoem_model_t *model = nanoemModelCreate(fixture.m_factory, &status);
+        nanoem_buffer_t *buffer = nanoemBufferCreate(fixture.m_bytes.data(), fixture.m_bytes.size(), &status);
+        CHECK(nanoemModelLoadFromBuffer(model, buffer, &status));
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+        nanoemBufferDestroy(buffer);
+        nanoemModelDestroy(model);
+    }
+    setThroughput(1, fixture.m_bytes.size());
+    BENCHMARK_ADVANCED(name)(Catch::Benchmark::Chronometer meter)
+    {
+        const int numRuns = meter.runs();
+        std::vector<nanoem_model_t *> models(numRuns);
+        std::vector<nanoem_buffer_t *> buffers(numRuns);
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        for (int i = 0; i < numRuns; i++) {
+            models[i] = nanoemModelCreate(fixture.m_factory, &status);
+            buffers[i] = nanoemBufferCreate(fixture.m_bytes.data(), fixture.m_bytes.size(), &status);
+        }
+        meter.measure([&](int i) { return nanoemModelLoadFromBuffer(models[i], buffers[i], &status); });
+        for (int i = 0; i < numRuns; i++) {
+            nanoemBufferDestroy(buffers[i]);
+            nanoemModelDestroy(models[i]);
+        }
+    };
+}
+
+static void
+benchmarkSaveModel(const char *name, const ModelParameters &parameters)
+{
+    ModelFixture fixture(parameters);
+    setThroughput(1, fixture.m_bytes.size());
+    BENCHMARK_ADVANCED(name)(Catch::Benchmark::Chronometer meter)
+    {
+        const int numRuns = meter.runs();
+        std::vector<nanoem_mutable_buffer_t *> buffers(numRuns);
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        for (int i = 0; i < numRuns; i++) {
+            buffers[i] = nanoemMutableBufferCreateWithReservedSize(fixture.m_bytes.size(), &status);
+        }
+        meter.measure([&](int i) {
+            nanoemMutableModelSaveToBuffer(fixture.m_model, buffers[i], &status);
+            return status;
+        });
+        for (int i = 0; i < numRuns; i++) {
+            nanoemMutableBufferDestroy(buffers[i]);
+        }
+    };
+}
+
+} /* namespace anonymous */
+
+TEST_CASE("benchmark_model_load_pmx", "[nanoem][benchmark]")
+{
+    benchmarkLoadModel("nanoemModelLoadFromBuffer/PMX", ModelParameters(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0));
+}
+
+TEST_CASE("benchmark_model_load_pmd", "[nanoem][benchmark]")
+{
+    benchmarkLoadModel("nanoemModelLoadFromBuffer/PMD", ModelParameters(NANOEM_MODEL_FORMAT_TYPE_PMD_1_0));
+}
+
+TEST_CASE("benchmark_model_save_pmx", "[nanoem][benchmark]")
+{
+    benchmarkSaveModel("nanoemMutableModelSaveToBuffer/PMX", ModelParameters(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0));
+}
+
+TEST_CASE("benchmark_model_save_pmd", "[nanoem][benchmark]")
+{
+    benchmarkSaveModel("nanoemMutableModelSaveToBuffer/PMD", ModelParameters(NANOEM_MODEL_FORMAT_TYPE_PMD_1_0));
+}
@@ -0,0 +1,119 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of nanoem component and it's licensed under MIT license. see LICENSE.md for more details.
+ */
+
+#include "./common.h"
+
+#include <string.h>
+
+using namespace nanoem::benchmark;
+
+namespace {
+
+class MotionFixture {
+public:
+    MotionFixture(const MotionParameters &parameters)
+        : m_factory(nullptr)
+        , m_motion(nullptr)
+    {
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        m_factory = nanoemUnicodeStringFactoryCreate(&status);
+        m_motion = generateMotion(m_factory, parameters);
+        saveMotion(m_motion, m_bytes);
+    }
+    ~MotionFixture()
+    {
+        nanoemMutableMotionDestroy(m_motion);
+        nanoemUnicodeStringFactoryDestroy(m_factory);
+    }
+
+    nanoem_unicode_string_factory_t *m_factory;
+    nanoem_mutable_motion_t *m_motion;
+    Bytes m_bytes;
+};
+
+} /* namespace anonymous */
+
+TEST_CASE("benchmark_motion_load_vmd", "[nanoem][benchmark]")
+{
+    MotionFixture fixture((MotionParameters()));
+    REQUIRE(!fixture.m_bytes.empty());
+    setThroughput(1, fixture.m_bytes.size());
+    BENCHMARK_ADVANCED("nanoemMotionLoadFromBuffer/VMD")(Catch::Benchmark::Chronometer meter)
+    {
+        const int numRuns = meter.runs();
+        std::vector<nanoem_motion_t *> motions(numRuns);
+        std::vector<nanoem_buffer_t *> buffers(numRuns);
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        for (int i = 0; i < numRuns; i++) {
+            motions[i] = nanoemMotionCreate(fixture.m_factory, &status);
+            buffers[i] = nanoemBufferCreate(fixture.m_bytes.data(), fixture.m_bytes.size(), &status);
+        }
+        meter.measure([&](int i) { return nanoemMotionLoadFromBuffer(motions[i], buffers[i], 0, &status); });
+        for (int i = 0; i < numRuns; i++) {
+            nanoemBufferDestroy(buffers[i]);
+            nanoemMotionDestroy(motions[i]);
+        }
+    };
+}
+
+TEST_CASE("benchmark_motion_save_vmd", "[nanoem][benchmark]")
+{
+    MotionFixture fixture((MotionParameters()));
+    setThroughput(1, fixture.m_bytes.size());
+    BENCHMARK_ADVANCED("nanoemMutableMotionSaveToBuffer/VMD")(Catch::Benchmark::Chronometer meter)
+    {
+        const int numRuns = meter.runs();
+        std::vector<nanoem_mutable_buffer_t *> buffers(numRuns);
+        nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+        for (int i = 0; i < numRuns; i++) {
+            buffers[i] = nanoemMutableBufferCreateWithReservedSize(fixture.m_bytes.size(), &status);
+        }
+        meter.measure([&](int i) {
+            nanoemMutableMotionSaveToBuffer(fixture.m_motion, buffers[i], &status);
+            return status;
+        });
+        for (int i = 0; i < numRuns; i++) {
+            nanoemMutableBufferDestroy(buffers[i]);
+        }
+    };
+}
+
+TEST_CASE("benchmark_motion_search_closest_bone_keyframes", "[nanoem][benchmark]")
+{
+    const MotionParameters parameters;
+    MotionFixture fixture(parameters);
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_motion_t *motion = nanoemMotionCreate(fixture.m_factory, &status);
+    nanoem_buffer_t *buffer = nanoemBufferCreate(fixture.m_bytes.data(), fixture.m_bytes.size(), &status);
+    REQUIRE(nanoemMotionLoadFromBuffer(motion, buffer, 0, &status));
+    nanoemBufferDestroy(buffer);
+    const nanoem_frame_index_t duration = nanoemMotionGetMaxFrameIndex(motion);
+    std::vector<nanoem_unicode_string_t *> names(parameters.m_numBones);
+    char name[32];
+    for (nanoem_rsize_t i = 0; i < parameters.m_numBones; i++) {
+        boneName(i, name, sizeof(name));
+        names[i] = nanoemUnicodeStringFactoryCreateString(
+            fixture.m_factory, reinterpret_cast<const nanoem_u8_t *>(name), strlen(name), &status);
+    }
+    /* queries every frame including ones between keyframes to sweep the whole timeline as playback does */
+    setThroughput(nanoem_u64_t(parameters.m_numBones) * (duration + 1), 0);
+    BENCHMARK("nanoemMotionSearchClosestBoneKeyframes")
+    {
+        nanoem_rsize_t found = 0;
+        for (nanoem_rsize_t i = 0; i < parameters.m_numBones; i++) {
+            for (nanoem_frame_index_t j = 0; j <= duration; j++) {
+                nanoem_motion_bone_keyframe_t *prev = nullptr, *next = nullptr;
+                nanoemMotionSearchClosestBoneKeyframes(motion, names[i], j, &prev, &next);
+                found += (prev != nullptr) + (next != nullptr);
+            }
+        }
+        return found;
+    };
+    for (nanoem_rsize_t i = 0; i < parameters.m_numBones; i++) {
+        nanoemUnicodeStringFactoryDestroyString(fixture.m_factory, names[i]);
+    }
+    nanoemMotionDestroy(motion);
+}
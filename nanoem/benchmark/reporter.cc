@@ -0,0 +1,186 @@
+/*
+   Copyright (c) 2015-2021 hkrn All rights reserved
+
+   This file is part of nanoem component and it's licensed under MIT license. see LICENSE.md for more details.
+ */
+
+#define CATCH_CONFIG_EXTERNAL_INTERFACES
+#include "./common.h"
+
+#include <iomanip>
+
+using namespace nanoem::benchmark;
+
+namespace {
+
+/*
+ * Catch2 has no JSON reporter so this collects all benchmark statistics and emits them as one JSON document on the
+ * end of the run. Use with "--reporter json --out benchmark.json" to compare results between revisions.
+ */
+class JsonReporter : public Catch::StreamingReporterBase<JsonReporter> {
+public:
+    static std::string
+    getDescription()
+    {
+        return "Reports benchmark results as JSON";
+    }
+
+    JsonReporter(const Catch::ReporterConfig &config)
+        : StreamingReporterBase(config)
+        , m_numFailures(0)
+    {
+    }
+
+    void
+    assertionStarting(const Catch::AssertionInfo &) override
+    {
+    }
+    bool
+    assertionEnded(const Catch::AssertionStats &stats) override
+    {
+        if (!stats.assertionResult.isOk()) {
+            m_numFailures++;
+        }
+        return true;
+    }
+    void
+    benchmarkPreparing(const std::string &name) override
+    {
+        Result result;
+        result.m_name = name;
+        result.m_testCase = currentTestCaseInfo ? currentTestCaseInfo->name : std::string();
+        consumeThroughput(result.m_items, result.m_bytes);
+        m_results.push_back(result);
+    }
+    void
+    benchmarkStarting(const Catch::BenchmarkInfo &info) override
+    {
+        Result &result = m_results.back();
+        result.m_iterations = info.iterations;
+        result.m_samples = info.samples;
+    }
+    void
+    benchmarkEnded(const Catch::BenchmarkStats<> &stats) override
+    {
+        Result &result = m_results.back();
+        result.m_mean = stats.mean.point.count();
+        result.m_meanLower = stats.mean.lower_bound.count();
+        result.m_meanUpper = stats.mean.upper_bound.count();
+        result.m_standardDeviation = stats.standardDeviation.point.count();
+        result.m_outlierVariance = stats.outlierVariance;
+        result.m_completed = true;
+    }
+    void
+    benchmarkFailed(const std::string &) override
+    {
+        m_numFailures++;
+    }
+    void
+    testRunEnded(const Catch::TestRunStats &stats) override
+    {
+        std::ostream &s = stream;
+        s << std::setprecision(17);
+        s << "{\n  \"context\": {\n";
+        s << "    \"name\": ";
+        writeString(stats.runInfo.name);
+        s << ",\n    \"catch2\": \"" << CATCH_VERSION_MAJOR << "." << CATCH_VERSION_MINOR << "."
+          << CATCH_VERSION_PATCH << "\",\n";
+        s << "    \"failures\": " << m_numFailures << "\n  },\n  \"benchmarks\": [";
+        for (size_t i = 0, numResults = m_results.size(); i < numResults; i++) {
+            const Result &result = m_results[i];
+            s << (i > 0 ? ",\n" : "\n") << "    {\n      \"name\": ";
+            writeString(result.m_name);
+            s << ",\n      \"test_case\": ";
+            writeString(result.m_testCase);
+            s << ",\n      \"completed\": " << (result.m_completed ? "true" : "false");
+            s << ",\n      \"samples\": " << result.m_samples;
+            s << ",\n      \"iterations\": " << result.m_iterations;
+            s << ",\n      \"mean_ns\": " << result.m_mean;
+            s << ",\n      \"mean_lower_bound_ns\": " << result.m_meanLower;
+            s << ",\n      \"mean_upper_bound_ns\": " << result.m_meanUpper;
+            s << ",\n      \"standard_deviation_ns\": " << result.m_standardDeviation;
+            s << ",\n      \"outlier_variance\": " << result.m_outlierVariance;
+            if (result.m_items > 0 && result.m_mean > 0) {
+                s << ",\n      \"items_per_iteration\": " << result.m_items;
+                s << ",\n      \"items_per_second\": " << result.m_items * 1e9 / result.m_mean;
+            }
+            if (result.m_bytes > 0 && result.m_mean > 0) {
+                s << ",\n      \"bytes_per_iteration\": " << result.m_bytes;
+                s << ",\n      \"bytes_per_second\": " << result.m_bytes * 1e9 / result.m_mean;
+            }
+            s << "\n    }";
+        }
+        s << "\n  ]\n}\n";
+        StreamingReporterBase::testRunEnded(stats);
+    }
+
+private:
+    struct Result {
+        Result()
+            : m_items(0)
+            , m_bytes(0)
+            , m_iterations(0)
+            , m_samples(0)
+            , m_mean(0)
+            , m_meanLower(0)
+            , m_meanUpper(0)
+            , m_standardDeviation(0)
+            , m_outlierVariance(0)
+            , m_completed(false)
+        {
+        }
+        std::string m_name;
+        std::string m_testCase;
+        nanoem_u64_t m_items;
+        nanoem_u64_t m_bytes;
+        int m_iterations;
+        int m_samples;
+        double m_mean;
+        double m_meanLower;
+        double m_meanUpper;
+        double m_standardDeviation;
+        double m_outlierVariance;
+        bool m_completed;
+    };
+
+    void
+    writeString(const std::string &value)
+    {
+        std::ostream &s = stream;
+        s << '"';
+        for (std::string::const_iterator it = value.begin(), end = value.end(); it != end; ++it) {
+            const char c = *it;
+            switch (c) {
+            case '"':
+                s << "\\\"";
+                break;
+            case '\\':
+                s << "\\\\";
+                break;
+            case '\n':
+                s << "\\n";
+                break;
+            case '\t':
+                s << "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    s << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c) << std::dec
+                      << std::setfill(' ');
+                }
+                else {
+                    s << c;
+                }
+                break;
+            }
+        }
+        s << '"';
+    }
+
+    std::vector<Result> m_results;
+    size_t m_numFailures;
+};
+
+} /* namespace anonymous */
+
+CATCH_REGISTER_REPORTER("json", JsonReporter)
@@ -369,7 +369,9 @@ nanoemMotionReadBoneKeyframeBundleUnitNMD(nanoem_motion_t *motion, const Nanoem_
     nanoem_unicode_string_factory_t *factory = motion->factory;
     nanoem_motion_bone_keyframe_t *bone_keyframe;
     nanoem_rsize_t num_bone_keyframes, num_local_tracks, i;
-    nanoem_motion_track_t track;
+    nanoem_motion_track_t *track;
+    nanoem_motion_track_index_t track_id;
+    nanoem_unicode_string_t *name;
     int ret;
     num_bone_keyframes = motion->num_bone_keyframes = bone_keyframe_bundle_message->n_keyframes;
     if (num_bone_keyframes > 0) {
@@ -381,14 +383,18 @@ nanoemMotionReadBoneKeyframeBundleUnitNMD(nanoem_motion_t *motion, const Nanoem_
             num_local_tracks = bone_keyframe_bundle_message->n_local_tracks;
             for (i = 0; i < num_local_tracks; i++) {
                 track_message = bone_keyframe_bundle_message->local_tracks[i];
-                track.name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) track_message->name, nanoem_crt_strlen(track_message->name), NANOEM_CODEC_TYPE_UTF8, status);
+                name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) track_message->name, nanoem_crt_strlen(track_message->name), NANOEM_CODEC_TYPE_UTF8, status);
                 if (!nanoem_status_ptr_has_error(status)) {
-                    track.factory = factory;
-                    track.id = (nanoem_motion_track_index_t) track_message->index;
-                    track.keyframes = kh_init_keyframe_map();
-                    kh_put_motion_track_bundle(motion->local_bone_motion_track_bundle, track, &ret);
-                    if (ret >= 0 && motion->local_bone_motion_track_allocated_id < track.id) {
-                        motion->local_bone_motion_track_allocated_id = track.id;
+                    track_id = (nanoem_motion_track_index_t) track_message->index;
+                    track = nanoemMotionTrackCreate(name, track_id, factory, status);
+                    if (nanoem_is_null(track)) {
+                        nanoemUtilDestroyString(name, factory);
+                        motion->num_bone_keyframes = i;
+                        break;
+                    }
+                    nanoemMotionTrackBundlePutTrack(motion->local_bone_motion_track_bundle, track, &ret);
+                    if (ret >= 0 && motion->local_bone_motion_track_allocated_id < track_id) {
+                        motion->local_bone_motion_track_allocated_id = track_id;
                     }
                     else if (ret < 0) {
                         motion->num_bone_keyframes = i;
@@ -685,7 +691,9 @@ nanoemMotionReadMorphKeyframeBundleUnitNMD(nanoem_motion_t *motion, const Nanoem
     nanoem_unicode_string_factory_t *factory = motion->factory;
     nanoem_motion_morph_keyframe_t *morph_keyframe;
     nanoem_rsize_t num_morph_keyframes, num_local_tracks, i;
-    nanoem_motion_track_t track;
+    nanoem_motion_track_t *track;
+    nanoem_motion_track_index_t track_id;
+    nanoem_unicode_string_t *name;
     int ret;
     num_morph_keyframes = motion->num_morph_keyframes = morph_keyframe_bundle_message->n_keyframes;
     if (num_morph_keyframes > 0) {
@@ -697,14 +705,18 @@ nanoemMotionReadMorphKeyframeBundleUnitNMD(nanoem_motion_t *motion, const Nanoem
             num_local_tracks = morph_keyframe_bundle_message->n_local_tracks;
             for (i = 0; i < num_local_tracks; i++) {
                 track_message = morph_keyframe_bundle_message->local_tracks[i];
-                track.name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) track_message->name, nanoem_crt_strlen(track_message->name), NANOEM_CODEC_TYPE_UTF8, status);
+                name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) track_message->name, nanoem_crt_strlen(track_message->name), NANOEM_CODEC_TYPE_UTF8, status);
                 if (!nanoem_status_ptr_has_error(status)) {
-                    track.factory = factory;
-                    track.id = (nanoem_motion_track_index_t) track_message->index;
-                    track.keyframes = kh_init_keyframe_map();
-                    kh_put_motion_track_bundle(motion->local_morph_motion_track_bundle, track, &ret);
-                    if (ret >= 0 && motion->local_morph_motion_track_allocated_id < track.id) {
-                        motion->local_morph_motion_track_allocated_id = track.id;
+                    track_id = (nanoem_motion_track_index_t) track_message->index;
+                    track = nanoemMotionTrackCreate(name, track_id, factory, status);
+                    if (nanoem_is_null(track)) {
+                        nanoemUtilDestroyString(name, factory);
+                        motion->num_morph_keyframes = i;
+                        break;
+                    }
+                    nanoemMotionTrackBundlePutTrack(motion->local_morph_motion_track_bundle, track, &ret);
+                    if (ret >= 0 && motion->local_morph_motion_track_allocated_id < track_id) {
+                        motion->local_morph_motion_track_allocated_id = track_id;
                     }
                     else if (ret < 0) {
                         motion->num_morph_keyframes = i;
@@ -777,6 +789,33 @@ nanoemMotionReadSelfShadowKeyframeBundleUnitNMD(nanoem_motion_t *motion, const N
     }
 }
 
+static void
+nanoemMotionSortAllKeyframesNMD(nanoem_motion_t *motion)
+{
+    /* keyframes in NMD are not guaranteed to be ordered but they are searched with binary search as VMD does */
+    if (motion->num_accessory_keyframes > 1) {
+        nanoem_crt_qsort(motion->accessory_keyframes, motion->num_accessory_keyframes, sizeof(*motion->accessory_keyframes), nanoemMotionCompareKeyframe);
+    }
+    if (motion->num_bone_keyframes > 1) {
+        nanoem_crt_qsort(motion->bone_keyframes, motion->num_bone_keyframes, sizeof(*motion->bone_keyframes), nanoemMotionCompareKeyframe);
+    }
+    if (motion->num_camera_keyframes > 1) {
+        nanoem_crt_qsort(motion->camera_keyframes, motion->num_camera_keyframes, sizeof(*motion->camera_keyframes), nanoemMotionCompareKeyframe);
+    }
+    if (motion->num_light_keyframes > 1) {
+        nanoem_crt_qsort(motion->light_keyframes, motion->num_light_keyframes, sizeof(*motion->light_keyframes), nanoemMotionCompareKeyframe);
+    }
+    if (motion->num_model_keyframes > 1) {
+        nanoem_crt_qsort(motion->model_keyframes, motion->num_model_keyframes, sizeof(*motion->model_keyframes), nanoemMotionCompareKeyframe);
+    }
+    if (motion->num_morph_keyframes > 1) {
+        nanoem_crt_qsort(motion->morph_keyframes, motion->num_morph_keyframes, sizeof(*motion->morph_keyframes), nanoemMotionCompareKeyframe);
+    }
+    if (motion->num_self_shadow_keyframes > 1) {
+        nanoem_crt_qsort(motion->self_shadow_keyframes, motion->num_self_shadow_keyframes, sizeof(*motion->self_shadow_keyframes), nanoemMotionCompareKeyframe);
+    }
+}
+
 nanoem_bool_t APIENTRY
 nanoemMotionLoadFromBufferNMD(nanoem_motion_t *motion, nanoem_buffer_t *buffer, nanoem_frame_index_t offset, nanoem_status_t *status)
 {
@@ -784,7 +823,9 @@ nanoemMotionLoadFromBufferNMD(nanoem_motion_t *motion, nanoem_buffer_t *buffer,
     Nanoem__Motion__KeyframeBundleUnit *keyframe_bundle;
     Nanoem__Motion__Track *track_message;
     nanoem_unicode_string_factory_t *factory;
-    nanoem_motion_track_t track;
+    nanoem_motion_track_t *track;
+    nanoem_motion_track_index_t track_id;
+    nanoem_unicode_string_t *name;
     nanoem_rsize_t num_keyframe_bundles, num_global_tracks, i;
     const char *target_object_name;
     int ret;
@@ -804,14 +845,18 @@ nanoemMotionLoadFromBufferNMD(nanoem_motion_t *motion, nanoem_buffer_t *buffer,
                 motion->target_model_name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) target_object_name, target_object_name ? nanoem_crt_strlen(target_object_name) : 0, NANOEM_CODEC_TYPE_UTF8, status);
                 for (i = 0; i < num_global_tracks; i++) {
                     track_message = motion_message->global_tracks[i];
-                    track.name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) track_message->name, nanoem_crt_strlen(track_message->name), NANOEM_CODEC_TYPE_UTF8, status);
+                    name = nanoemUnicodeStringFactoryCreateStringWithEncoding(factory, (const nanoem_u8_t *) track_message->name, nanoem_crt_strlen(track_message->name), NANOEM_CODEC_TYPE_UTF8, status);
                     if (!nanoem_status_ptr_has_error(status)) {
-                        track.factory = factory;
-                        track.id = (nanoem_motion_track_index_t) track_message->index;
-                        track.keyframes = kh_init_keyframe_map();
-                        kh_put_motion_track_bundle(motion->global_motion_track_bundle, track, &ret);
-                        if (motion->global_motion_track_allocated_id < track.id) {
-                            motion->global_motion_track_allocated_id = track.id;
+                        track_id = (nanoem_motion_track_index_t) track_message->index;
+                        track = nanoemMotionTrackCreate(name, track_id, factory, status);
+                        if (nanoem_is_not_null(track)) {
+                            nanoemMotionTrackBundlePutTrack(motion->global_motion_track_bundle, track, &ret);
+                            if (motion->global_motion_track_allocated_id < track_id) {
+                                motion->global_motion_track_allocated_id = track_id;
+                            }
+                        }
+                        else {
+                            nanoemUtilDestroyString(name, factory);
                         }
                     }
                 }
@@ -862,6 +907,7 @@ nanoemMotionLoadFromBufferNMD(nanoem_motion_t *motion, nanoem_buffer_t *buffer,
                         break;
                     }
                 }
+                nanoemMotionSortAllKeyframesNMD(motion);
             }
             nanoem__motion__motion__free_unpacked(motion_message, &__nanoem_protobuf_allocator);
         }
@@ -1016,7 +1062,7 @@ nanoemMutableMotionWriteBoneTrackBundleNMD(const nanoem_motion_t *motion, Nanoem
                 track_message = track_bundle_message[i++] = (Nanoem__Motion__Track *) nanoem_calloc(1, sizeof(*track_message), status);
                 if (nanoem_is_not_null(track_message)) {
                     nanoem__motion__track__init(track_message);
-                    track = &kh_key(track_bundle, it);
+                    track = kh_key(track_bundle, it);
                     bytes = (char *) nanoemUnicodeStringFactoryGetByteArrayEncoding(factory, track->name, &length, NANOEM_CODEC_TYPE_UTF8, &st);
                     if (st == NANOEM_STATUS_SUCCESS) {
                         track_message->index = (uint64_t) track->id;
@@ -1404,7 +1450,7 @@ nanoemMutableMotionWriteMorphTrackBundleNMD(const nanoem_motion_t *motion, Nanoe
                 track_message = track_bundle_message[i++] = (Nanoem__Motion__Track *) nanoem_calloc(1, sizeof(*track_message), status);
                 if (nanoem_is_not_null(track_message)) {
                     nanoem__motion__track__init(track_message);
-                    track = &kh_key(track_bundle, it);
+                    track = kh_key(track_bundle, it);
                     bytes = (char *) nanoemUnicodeStringFactoryGetByteArrayEncoding(factory, track->name, &length, NANOEM_CODEC_TYPE_UTF8, status);
                     if (bytes) {
                         track_message->index = (uint64_t) track->id;
@@ -1550,7 +1596,7 @@ nanoemMutableMotionWriteGlobalTrackBundleNMD(const nanoem_motion_t *motion, Nano
                         track_message = track_bundle_message[i++] = (Nanoem__Motion__Track *) nanoem_calloc(1, sizeof(*track_message), status);
                         if (nanoem_is_not_null(track_message)) {
                             nanoem__motion__track__init(track_message);
-                            track = &kh_key(track_bundle, it);
+                            track = kh_key(track_bundle, it);
                             bytes = (char *) nanoemUnicodeStringFactoryGetByteArrayEncoding(factory, track->name, &length, NANOEM_CODEC_TYPE_UTF8, &st);
                             if (st == NANOEM_STATUS_SUCCESS) {
                                 track_message->index = (uint64_t) track->id;
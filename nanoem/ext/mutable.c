@@ -753,19 +753,10 @@ nanoemMotionSelfShadowKeyframeSaveToBuffer(const nanoem_motion_self_shadow_keyfr
 static void
 nanoemMotionTrackBundleRemoveKeyframe(kh_motion_track_bundle_t *bundle, nanoem_frame_index_t frame_index, nanoem_unicode_string_t *name, nanoem_unicode_string_factory_t *factory)
 {
-    kh_keyframe_map_t *keyframes = NULL;
-    nanoem_motion_track_t track;
-    khiter_t it;
+    nanoem_motion_track_t *track;
     if (nanoem_is_not_null(bundle) && nanoem_is_not_null(name) && nanoem_is_not_null(factory)) {
-        track.factory = factory;
-        track.id = 0;
-        track.keyframes = NULL;
-        track.name = name;
-        it = kh_get_motion_track_bundle(bundle, track);
-        if (it != kh_end(bundle)) {
-            keyframes = kh_key(bundle, it).keyframes;
-            kh_del_keyframe_map(keyframes, kh_get_keyframe_map(keyframes, frame_index));
-        }
+        track = nanoemMotionTrackBundleFindTrack(bundle, name, factory);
+        nanoemMotionTrackRemoveKeyframe(track, frame_index);
     }
 }
 
@@ -2829,6 +2820,8 @@ nanoemMutableMotionSortAllKeyframes(nanoem_mutable_motion_t *motion)
             nanoem_crt_qsort(origin->self_shadow_keyframes, origin->num_self_shadow_keyframes, sizeof(*origin->self_shadow_keyframes), nanoemMotionCompareKeyframe);
             nanoemMutableMotionSetMaxFrameIndex(origin, nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionSelfShadowKeyframeGetKeyframeObject(origin->self_shadow_keyframes[origin->num_self_shadow_keyframes - 1])));
         }
+        nanoemMotionTrackBundleSortAllKeyframes(origin->local_bone_motion_track_bundle);
+        nanoemMotionTrackBundleSortAllKeyframes(origin->local_morph_motion_track_bundle);
     }
 }
 
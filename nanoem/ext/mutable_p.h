@@ -29,7 +29,6 @@
 #define NANOEM_MUTABLE_STATIC_ASSERT(cond, message)
 #endif /* __STDC_VERSION__ >= 201112L */
 
-#define nanoem_crt_memmove(dst, src, size) memmove((dst), (src), (size))
 #define nanoem_crt_memset(dst, c, size) memset((dst), (c), (size))
 
 static const char
@@ -533,9 +532,19 @@ static void
 nanoemMotionKeyframeObjectArrayAddObject(nanoem_motion_keyframe_object_t ***items, nanoem_motion_keyframe_object_t *item, nanoem_frame_index_t frame_index, nanoem_rsize_t *num_items, nanoem_rsize_t *num_allocated_items, nanoem_status_t *status)
 {
     nanoem_motion_keyframe_object_t **new_items, **old_items = *items;
+    nanoem_rsize_t offset, last;
     new_items = (nanoem_motion_keyframe_object_t **) nanoemMutableObjectArrayResize(old_items, num_allocated_items, num_items, status);
     if (nanoem_is_not_null(new_items)) {
-        new_items[*num_items - 1] = item;
+        /* keep keyframes ordered by frame index to search them with binary search */
+        last = *num_items - 1;
+        offset = nanoemMotionKeyframeObjectArrayLowerBound(new_items, last, frame_index + 1);
+        if (offset < last && frame_index != NANOEM_FRAME_INDEX_MAX_SIZE) {
+            nanoem_crt_memmove(&new_items[offset + 1], &new_items[offset], (last - offset) * sizeof(item));
+        }
+        else {
+            offset = last;
+        }
+        new_items[offset] = item;
         *items = new_items;
         item->frame_index = frame_index;
         nanoem_status_ptr_assign_succeeded(status);
@@ -606,11 +606,85 @@ nanoemModelCompareBonePMX(const void *a, const void *b)
     return right->u.flags.is_affected_by_physics_simulation ? NANOEM_MODEL_OBJECT_NOT_FOUND : 1;
 }
 
+NANOEM_DECL_INLINE static nanoem_rsize_t
+nanoemModelArenaAlignSize(nanoem_rsize_t size)
+{
+    return (size + 15) & ~((nanoem_rsize_t) 15);
+}
+
+static void
+nanoemModelArenaReserve(nanoem_model_t *model, nanoem_rsize_t num_objects, nanoem_rsize_t size)
+{
+    nanoem_model_arena_block_t *block;
+    nanoem_rsize_t header_size = nanoemModelArenaAlignSize(sizeof(*block)), object_size = nanoemModelArenaAlignSize(size);
+    if (model->is_arena_enabled && num_objects <= (NANOEM_RSIZE_MAX - header_size) / object_size) {
+        /* fallback to allocate each object separately if the slab block cannot be allocated */
+        block = (nanoem_model_arena_block_t *) nanoem_calloc(1, header_size + num_objects * object_size, NULL);
+        if (nanoem_is_not_null(block)) {
+            block->capacity = num_objects * object_size;
+            block->next = model->arena_blocks;
+            model->arena_blocks = block;
+        }
+    }
+}
+
+static void
+nanoemModelArenaDestroy(nanoem_model_t *model)
+{
+    nanoem_model_arena_block_t *block = model->arena_blocks, *next_block;
+    while (nanoem_is_not_null(block)) {
+        next_block = block->next;
+        if (block->num_live_objects == 0) {
+            nanoem_free(block);
+        }
+        else {
+            /* objects removed from the model may outlive it so the last one releases the block */
+            block->is_orphaned = nanoem_true;
+            block->next = NULL;
+        }
+        block = next_block;
+    }
+    model->arena_blocks = NULL;
+}
+
+static void *
+nanoemModelObjectAllocate(const nanoem_model_t *model, nanoem_rsize_t size, nanoem_status_t *status)
+{
+    nanoem_model_arena_block_t *block = nanoem_is_not_null(model) ? model->arena_blocks : NULL;
+    nanoem_model_object_t *object;
+    nanoem_rsize_t object_size = nanoemModelArenaAlignSize(size);
+    if (nanoem_is_not_null(block) && object_size <= block->capacity - block->offset) {
+        object = (nanoem_model_object_t *) ((nanoem_u8_t *) block + nanoemModelArenaAlignSize(sizeof(*block)) + block->offset);
+        object->arena_block = block;
+        block->offset += object_size;
+        block->num_live_objects++;
+    }
+    else {
+        object = (nanoem_model_object_t *) nanoem_calloc(1, size, status);
+    }
+    return object;
+}
+
+static void
+nanoemModelObjectRelease(nanoem_model_object_t *object)
+{
+    nanoem_model_arena_block_t *block = object->arena_block;
+    if (nanoem_is_not_null(block)) {
+        block->num_live_objects--;
+        if (block->is_orphaned && block->num_live_objects == 0) {
+            nanoem_free(block);
+        }
+    }
+    else {
+        nanoem_free(object);
+    }
+}
+
 nanoem_model_vertex_t *
 nanoemModelVertexCreate(const nanoem_model_t *model, nanoem_status_t *status)
 {
     nanoem_model_vertex_t *vertex;
-    vertex = (nanoem_model_vertex_t *) nanoem_calloc(1, sizeof(*vertex), status);
+    vertex = (nanoem_model_vertex_t *) nanoemModelObjectAllocate(model, sizeof(*vertex), status);
     if (nanoem_is_not_null(vertex)) {
         nanoemModelObjectInitialize(&vertex->base, model);
         vertex->type = NANOEM_MODEL_VERTEX_TYPE_UNKNOWN;
@@ -628,6 +702,7 @@ nanoemModelParseVertexBlockPMD(nanoem_model_t *model, nanoem_buffer_t *buffer, n
         model->vertices = (nanoem_model_vertex_t **) nanoem_calloc(num_vertices, sizeof(*model->vertices), status);
         if (nanoem_is_not_null(model->vertices)) {
             model->num_vertices = num_vertices;
+            nanoemModelArenaReserve(model, num_vertices, sizeof(nanoem_model_vertex_t));
             for (i = 0; i < num_vertices; i++) {
                 vertex = nanoemModelVertexCreate(model, status);
                 nanoemModelVertexParsePMD(vertex, buffer, status);
@@ -680,6 +755,7 @@ nanoemModelParseMaterialBlockPMD(nanoem_model_t *model, nanoem_buffer_t *buffer,
         model->materials = (nanoem_model_material_t **) nanoem_calloc(num_materials, sizeof(*model->materials), status);
         if (nanoem_is_not_null(model->materials)) {
             model->num_materials = num_materials;
+            nanoemModelArenaReserve(model, num_materials, sizeof(nanoem_model_material_t));
             for (i = 0; i < num_materials; i++) {
                 material = nanoemModelMaterialCreate(model, status);
                 nanoemModelMaterialParsePMD(material, buffer, status);
@@ -792,6 +868,7 @@ nanoemModelParseBoneBlockPMD(nanoem_model_t *model, nanoem_buffer_t *buffer, nan
         model->ordered_bones = (nanoem_model_bone_t **) nanoem_calloc(num_bones, sizeof(*model->ordered_bones), status);
         if (nanoem_is_not_null(model->bones) && nanoem_is_not_null(model->ordered_bones)) {
             model->num_bones = num_bones;
+            nanoemModelArenaReserve(model, num_bones, sizeof(nanoem_model_bone_t));
             for (i = 0; i < num_bones; i++) {
                 bone = nanoemModelBoneCreate(model, status);
                 nanoemModelBoneParsePMD(bone, buffer, status);
@@ -850,6 +927,7 @@ nanoemModelParseMorphBlockPMD(nanoem_model_t *model, nanoem_buffer_t *buffer, na
         model->morphs = (nanoem_model_morph_t **) nanoem_calloc(num_morphs, sizeof(*model->morphs), status);
         if (nanoem_is_not_null(model->morphs)) {
             model->num_morphs = num_morphs;
+            nanoemModelArenaReserve(model, num_morphs, sizeof(nanoem_model_morph_t));
             for (i = 0; i < num_morphs; i++) {
                 morph = nanoemModelMorphCreate(model, status);
                 nanoemModelMorphParsePMD(morph, buffer, status);
@@ -1048,6 +1126,7 @@ nanoemModelParseRigidBodyBlockPMD(nanoem_model_t *model, nanoem_buffer_t *buffer
         model->rigid_bodies = (nanoem_model_rigid_body_t **) nanoem_calloc(num_rigid_bodies, sizeof(*model->rigid_bodies), status);
         if (nanoem_is_not_null(model->rigid_bodies)) {
             model->num_rigid_bodies = num_rigid_bodies;
+            nanoemModelArenaReserve(model, num_rigid_bodies, sizeof(nanoem_model_rigid_body_t));
             for (i = 0; i < num_rigid_bodies; i++) {
                 rigid_body = nanoemModelRigidBodyCreate(model, status);
                 nanoemModelRigidBodyParsePMD(rigid_body, buffer, status);
@@ -1073,6 +1152,7 @@ nanoemModelParseJointBlockPMD(nanoem_model_t *model, nanoem_buffer_t *buffer, na
         model->joints = (nanoem_model_joint_t **) nanoem_calloc(num_joints, sizeof(*model->rigid_bodies), status);
         if (nanoem_is_not_null(model->joints)) {
             model->num_joints = num_joints;
+            nanoemModelArenaReserve(model, num_joints, sizeof(nanoem_model_joint_t));
             for (i = 0; i < num_joints; i++) {
                 joint = nanoemModelJointCreate(model, status);
                 nanoemModelJointParsePMD(joint, buffer, status);
@@ -1154,6 +1234,7 @@ nanoemModelParseVertexBlockPMX(nanoem_model_t *model, nanoem_buffer_t *buffer, n
         model->vertices = (nanoem_model_vertex_t **) nanoem_calloc(num_vertices, sizeof(*model->vertices), status);
         if (nanoem_is_not_null(model->vertices)) {
             model->num_vertices = num_vertices;
+            nanoemModelArenaReserve(model, num_vertices, sizeof(nanoem_model_vertex_t));
             for (i = 0; i < num_vertices; i++) {
                 vertex = nanoemModelVertexCreate(model, status);
                 nanoemModelVertexParsePMX(vertex, buffer, status);
@@ -1232,6 +1313,7 @@ nanoemModelParseMaterialBlockPMX(nanoem_model_t *model, nanoem_buffer_t *buffer,
         model->materials = (nanoem_model_material_t **) nanoem_calloc(num_materials, sizeof(*model->materials), status);
         if (nanoem_is_not_null(model->materials)) {
             model->num_materials = num_materials;
+            nanoemModelArenaReserve(model, num_materials, sizeof(nanoem_model_material_t));
             for (i = 0; i < num_materials; i++) {
                 material = nanoemModelMaterialCreate(model, status);
                 nanoemModelMaterialParsePMX(material, buffer, status);
@@ -1258,6 +1340,7 @@ nanoemModelParseBoneBlockPMX(nanoem_model_t *model, nanoem_buffer_t *buffer, nan
         model->ordered_bones = (nanoem_model_bone_t **) nanoem_calloc(num_bones, sizeof(*model->ordered_bones), status);
         if (nanoem_is_not_null(model->bones) && nanoem_is_not_null(model->ordered_bones)) {
             model->num_bones = num_bones;
+            nanoemModelArenaReserve(model, num_bones, sizeof(nanoem_model_bone_t));
             for (i = 0; i < num_bones; i++) {
                 bone = nanoemModelBoneCreate(model, status);
                 nanoemModelBoneParsePMX(bone, buffer, status);
@@ -1289,6 +1372,7 @@ nanoemModelParseMorphBlockPMX(nanoem_model_t *model, nanoem_buffer_t *buffer, na
         model->morphs = (nanoem_model_morph_t **) nanoem_calloc(num_morphs, sizeof(*model->morphs), status);
         if (nanoem_is_not_null(model->morphs)) {
             model->num_morphs = num_morphs;
+            nanoemModelArenaReserve(model, num_morphs, sizeof(nanoem_model_morph_t));
             for (i = 0; i < num_morphs; i++) {
                 morph = nanoemModelMorphCreate(model, status);
                 nanoemModelMorphParsePMX(morph, buffer, status);
@@ -1339,6 +1423,7 @@ nanoemModelParseRigidBodyBlockPMX(nanoem_model_t *model, nanoem_buffer_t *buffer
         model->rigid_bodies = (nanoem_model_rigid_body_t **) nanoem_calloc(num_rigid_bodies, sizeof(*model->rigid_bodies), status);
         if (nanoem_is_not_null(model->rigid_bodies)) {
             model->num_rigid_bodies = num_rigid_bodies;
+            nanoemModelArenaReserve(model, num_rigid_bodies, sizeof(nanoem_model_rigid_body_t));
             for (i = 0; i < num_rigid_bodies; i++) {
                 rigid_body = nanoemModelRigidBodyCreate(model, status);
                 nanoemModelRigidBodyParsePMX(rigid_body, buffer, status);
@@ -1364,6 +1449,7 @@ nanoemModelParseJointBlockPMX(nanoem_model_t *model, nanoem_buffer_t *buffer, na
         model->joints = (nanoem_model_joint_t **) nanoem_calloc(num_joints, sizeof(*model->joints), status);
         if (nanoem_is_not_null(model->joints)) {
             model->num_joints = num_joints;
+            nanoemModelArenaReserve(model, num_joints, sizeof(nanoem_model_joint_t));
             for (i = 0; i < num_joints; i++) {
                 joint = nanoemModelJointCreate(model, status);
                 nanoemModelJointParsePMX(joint, buffer,status);
@@ -1565,7 +1651,7 @@ nanoemModelVertexDestroy(nanoem_model_vertex_t *vertex)
 {
     if (nanoem_is_not_null(vertex)) {
         nanoemModelObjectDestroy(&vertex->base);
-        nanoem_free(vertex);
+        nanoemModelObjectRelease(&vertex->base);
     }
 }
 
@@ -1573,7 +1659,7 @@ nanoem_model_material_t *
 nanoemModelMaterialCreate(const nanoem_model_t *model, nanoem_status_t *status)
 {
     nanoem_model_material_t *material;
-    material = (nanoem_model_material_t *) nanoem_calloc(1, sizeof(*material), status);
+    material = (nanoem_model_material_t *) nanoemModelObjectAllocate(model, sizeof(*material), status);
     if (nanoem_is_not_null(material)) {
         nanoemModelObjectInitialize(&material->base, model);
         material->sphere_map_texture_type = NANOEM_MODEL_MATERIAL_SPHERE_MAP_TEXTURE_UNKNOWN;
@@ -1740,7 +1826,7 @@ nanoemModelMaterialDestroy(nanoem_model_material_t *material)
             nanoemUtilDestroyString(material->name_en, factory);
             nanoemUtilDestroyString(material->clob, factory);
         }
-        nanoem_free(material);
+        nanoemModelObjectRelease(&material->base);
     }
 }
 
@@ -1748,7 +1834,7 @@ nanoem_model_bone_t *
 nanoemModelBoneCreate(const nanoem_model_t *model, nanoem_status_t *status)
 {
     nanoem_model_bone_t *bone;
-    bone = (nanoem_model_bone_t *) nanoem_calloc(1, sizeof(*bone), status);
+    bone = (nanoem_model_bone_t *) nanoemModelObjectAllocate(model, sizeof(*bone), status);
     if (nanoem_is_not_null(bone)) {
         nanoemModelObjectInitialize(&bone->base, model);
         bone->parent_bone_index = NANOEM_MODEL_OBJECT_NOT_FOUND;
@@ -1907,7 +1993,7 @@ nanoemModelBoneDestroy(nanoem_model_bone_t *bone)
             nanoemUtilDestroyString(bone->name_ja, factory);
             nanoemUtilDestroyString(bone->name_en, factory);
         }
-        nanoem_free(bone);
+        nanoemModelObjectRelease(&bone->base);
     }
 }
 
@@ -2241,7 +2327,7 @@ nanoem_model_morph_t *
 nanoemModelMorphCreate(const nanoem_model_t *model, nanoem_status_t *status)
 {
     nanoem_model_morph_t *morph;
-    morph = (nanoem_model_morph_t *) nanoem_calloc(1, sizeof(*morph), status);
+    morph = (nanoem_model_morph_t *) nanoemModelObjectAllocate(model, sizeof(*morph), status);
     if (nanoem_is_not_null(morph)) {
         nanoemModelObjectInitialize(&morph->base, model);
         morph->category = NANOEM_MODEL_MORPH_CATEGORY_UNKNOWN;
@@ -2780,7 +2866,7 @@ nanoemModelMorphDestroy(nanoem_model_morph_t *morph)
             nanoemUtilDestroyString(morph->name_en, factory);
         }
         nanoemModelObjectDestroy(&morph->base);
-        nanoem_free(morph);
+        nanoemModelObjectRelease(&morph->base);
     }
 }
 
@@ -2908,7 +2994,7 @@ nanoem_model_rigid_body_t *
 nanoemModelRigidBodyCreate(const nanoem_model_t *model, nanoem_status_t *status)
 {
     nanoem_model_rigid_body_t *rigid_body;
-    rigid_body = (nanoem_model_rigid_body_t *) nanoem_calloc(1, sizeof(*rigid_body), status);
+    rigid_body = (nanoem_model_rigid_body_t *) nanoemModelObjectAllocate(model, sizeof(*rigid_body), status);
     if (nanoem_is_not_null(rigid_body)) {
         nanoemModelObjectInitialize(&rigid_body->base, model);
         rigid_body->shape_type = NANOEM_MODEL_RIGID_BODY_SHAPE_TYPE_UNKNOWN;
@@ -3011,7 +3097,7 @@ nanoemModelRigidBodyDestroy(nanoem_model_rigid_body_t *rigid_body)
             nanoemUtilDestroyString(rigid_body->name_en, factory);
         }
         nanoemModelObjectDestroy(&rigid_body->base);
-        nanoem_free(rigid_body);
+        nanoemModelObjectRelease(&rigid_body->base);
     }
 }
 
@@ -3019,7 +3105,7 @@ nanoem_model_joint_t *
 nanoemModelJointCreate(const nanoem_model_t *model, nanoem_status_t *status)
 {
     nanoem_model_joint_t *joint;
-    joint = (nanoem_model_joint_t *) nanoem_calloc(1, sizeof(*joint), status);
+    joint = (nanoem_model_joint_t *) nanoemModelObjectAllocate(model, sizeof(*joint), status);
     if (nanoem_is_not_null(joint)) {
         nanoemModelObjectInitialize(&joint->base, model);
         joint->type = NANOEM_MODEL_JOINT_TYPE_UNKNOWN;
@@ -3114,7 +3200,7 @@ nanoemModelJointDestroy(nanoem_model_joint_t *joint)
             nanoemUtilDestroyString(joint->name_en, factory);
         }
         nanoemModelObjectDestroy(&joint->base);
-        nanoem_free(joint);
+        nanoemModelObjectRelease(&joint->base);
     }
 }
 
@@ -4812,6 +4898,20 @@ nanoemModelCreate(nanoem_unicode_string_factory_t *factory, nanoem_status_t *sta
     return model;
 }
 
+nanoem_bool_t APIENTRY
+nanoemModelIsArenaEnabled(const nanoem_model_t *model)
+{
+    return nanoem_is_not_null(model) ? model->is_arena_enabled : nanoem_false;
+}
+
+void APIENTRY
+nanoemModelSetArenaEnabled(nanoem_model_t *model, nanoem_bool_t value)
+{
+    if (nanoem_is_not_null(model)) {
+        model->is_arena_enabled = value;
+    }
+}
+
 nanoem_bool_t APIENTRY
 nanoemModelLoadFromBufferPMD(nanoem_model_t *model, nanoem_buffer_t *buffer, nanoem_status_t *status)
 {
@@ -5235,31 +5335,147 @@ nanoemModelDestroy(nanoem_model_t *model)
             }
             nanoem_free(model->soft_bodies);
         }
+        nanoemModelArenaDestroy(model);
         nanoem_free(model);
     }
 }
 
+nanoem_motion_track_t *
+nanoemMotionTrackCreate(nanoem_unicode_string_t *name, nanoem_motion_track_index_t id, nanoem_unicode_string_factory_t *factory, nanoem_status_t *status)
+{
+    nanoem_motion_track_t *track;
+    track = (nanoem_motion_track_t *) nanoem_calloc(1, sizeof(*track), status);
+    if (nanoem_is_not_null(track)) {
+        track->id = id;
+        track->factory = factory;
+        track->name = name;
+    }
+    return track;
+}
+
+void
+nanoemMotionTrackAddKeyframe(nanoem_motion_track_t *track, nanoem_motion_keyframe_object_t *keyframe, nanoem_frame_index_t frame_index, int *ret)
+{
+    nanoem_motion_keyframe_object_t **keyframes;
+    nanoem_rsize_t num_keyframes, num_allocated_keyframes, offset;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    *ret = -1;
+    if (nanoem_is_not_null(track) && nanoem_is_not_null(keyframe)) {
+        keyframes = track->keyframes;
+        num_keyframes = track->num_keyframes;
+        /* keyframes are usually appended in order of frame index */
+        if (num_keyframes == 0 || keyframes[num_keyframes - 1]->frame_index < frame_index) {
+            offset = num_keyframes;
+        }
+        else {
+            offset = nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, frame_index);
+            if (keyframes[offset]->frame_index == frame_index) {
+                /* replace the existing keyframe at the same frame index */
+                keyframes[offset] = keyframe;
+                *ret = 0;
+                return;
+            }
+        }
+        if (num_keyframes >= track->num_allocated_keyframes) {
+            num_allocated_keyframes = num_keyframes > 0 ? num_keyframes * 2 : 4;
+            keyframes = (nanoem_motion_keyframe_object_t **) nanoem_realloc(keyframes, sizeof(*keyframes) * num_allocated_keyframes, &status);
+            if (nanoem_is_null(keyframes)) {
+                return;
+            }
+            track->keyframes = keyframes;
+            track->num_allocated_keyframes = num_allocated_keyframes;
+        }
+        if (offset < num_keyframes) {
+            nanoem_crt_memmove(&keyframes[offset + 1], &keyframes[offset], (num_keyframes - offset) * sizeof(*keyframes));
+        }
+        keyframes[offset] = keyframe;
+        track->num_keyframes = num_keyframes + 1;
+        *ret = 1;
+    }
+}
+
+void
+nanoemMotionTrackRemoveKeyframe(nanoem_motion_track_t *track, nanoem_frame_index_t frame_index)
+{
+    nanoem_motion_keyframe_object_t **keyframes;
+    nanoem_rsize_t num_keyframes, offset;
+    if (nanoem_is_not_null(track)) {
+        keyframes = track->keyframes;
+        num_keyframes = track->num_keyframes;
+        offset = nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, frame_index);
+        if (offset < num_keyframes && keyframes[offset]->frame_index == frame_index) {
+            nanoem_crt_memmove(&keyframes[offset], &keyframes[offset + 1], (num_keyframes - offset - 1) * sizeof(*keyframes));
+            track->num_keyframes = num_keyframes - 1;
+        }
+    }
+}
+
+void
+nanoemMotionTrackDestroy(nanoem_motion_track_t *track)
+{
+    if (nanoem_is_not_null(track)) {
+        nanoemUtilDestroyString(track->name, track->factory);
+        if (nanoem_is_not_null(track->keyframes)) {
+            nanoem_free(track->keyframes);
+        }
+        nanoem_free(track);
+    }
+}
+
 void
 nanoemMotionTrackBundleAddKeyframe(kh_motion_track_bundle_t *bundle, nanoem_motion_keyframe_object_t *keyframe, nanoem_frame_index_t frame_index, const nanoem_unicode_string_t *name, nanoem_unicode_string_factory_t *factory, int *ret)
 {
-    union nanoem_const_to_mutable_unicode_string_cast_t {
-        const nanoem_unicode_string_t *s;
-        nanoem_unicode_string_t *m;
-    } u;
-    kh_keyframe_map_t *keyframes;
-    nanoem_motion_track_t track;
-    khiter_t it, it2;
-    if (nanoem_is_not_null(bundle) && nanoem_is_not_null(name) && nanoem_is_not_null(factory)) {
-        u.s = name;
-        track.factory = factory;
-        track.id = 0;
-        track.keyframes = NULL;
-        track.name = u.m;
-        it = kh_get_motion_track_bundle(bundle, track);
-        if (it != kh_end(bundle)) {
-            keyframes = kh_key(bundle, it).keyframes;
-            it2 = kh_put_keyframe_map(keyframes, frame_index, ret);
-            kh_val(keyframes, it2) = keyframe;
+    nanoem_motion_track_t *track = nanoemMotionTrackBundleFindTrack(bundle, name, factory);
+    if (nanoem_is_not_null(track)) {
+        nanoemMotionTrackAddKeyframe(track, keyframe, frame_index, ret);
+    }
+}
+
+void
+nanoemMotionTrackBundlePutTrack(kh_motion_track_bundle_t *bundle, nanoem_motion_track_t *track, int *ret)
+{
+    kh_put_motion_track_bundle(bundle, track, ret);
+    if (*ret <= 0) {
+        /* the same track is already exist or failed to allocate */
+        nanoemMotionTrackDestroy(track);
+    }
+}
+
+static int
+nanoemMotionTrackCompareKeyframe(const void *a, const void *b)
+{
+    int result = nanoemMotionCompareKeyframe(a, b);
+    if (result == 0) {
+        result = (*(const nanoem_motion_keyframe_object_t *const *) a)->index - (*(const nanoem_motion_keyframe_object_t *const *) b)->index;
+    }
+    return result;
+}
+
+void
+nanoemMotionTrackBundleSortAllKeyframes(kh_motion_track_bundle_t *bundle)
+{
+    nanoem_motion_track_t *track;
+    nanoem_motion_keyframe_object_t **keyframes;
+    nanoem_rsize_t num_keyframes, i, j;
+    khiter_t it, end;
+    if (nanoem_is_not_null(bundle)) {
+        for (it = kh_begin(bundle), end = kh_end(bundle); it != end; it++) {
+            if (kh_exist(bundle, it)) {
+                track = kh_key(bundle, it);
+                keyframes = track->keyframes;
+                num_keyframes = track->num_keyframes;
+                if (num_keyframes > 1) {
+                    nanoem_crt_qsort(keyframes, num_keyframes, sizeof(*keyframes), nanoemMotionTrackCompareKeyframe);
+                    /* keep the last keyframe of the same frame index */
+                    for (i = 1, j = 0; i < num_keyframes; i++) {
+                        if (keyframes[i]->frame_index != keyframes[j]->frame_index) {
+                            j++;
+                        }
+                        keyframes[j] = keyframes[i];
+                    }
+                    track->num_keyframes = j + 1;
+                }
+            }
         }
     }
 }
@@ -5268,14 +5484,12 @@ void
 nanoemMotionTrackBundleDestroy(kh_motion_track_bundle_t *bundle, nanoem_unicode_string_factory_t *factory)
 {
     khiter_t it, end;
-    nanoem_unicode_string_t *name;
+    nanoem_mark_unused(factory);
     if (nanoem_is_not_null(bundle)) {
         end = kh_end(bundle);
         for (it = kh_begin(bundle); it != end; it++) {
             if (kh_exist(bundle, it)) {
-                name = kh_key(bundle, it).name;
-                nanoemUtilDestroyString(name, factory);
-                kh_destroy_keyframe_map(kh_key(bundle, it).keyframes);
+                nanoemMotionTrackDestroy(kh_key(bundle, it));
             }
         }
         kh_destroy_motion_track_bundle(bundle);
@@ -6823,20 +7037,14 @@ nanoem_motion_bone_keyframe_t *const *APIENTRY
 nanoemMotionExtractBoneTrackKeyframes(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_rsize_t *num_keyframes, nanoem_status_t *status)
 {
     nanoem_motion_bone_keyframe_t **keyframes = NULL;
-    kh_keyframe_map_t *keyframes_map;
-    khiter_t it, end;
-    nanoem_rsize_t i = 0;
+    const nanoem_motion_track_t *track;
     if (nanoem_is_not_null(motion)) {
-        keyframes_map = nanoemMotionFindKeyframesMap(motion->local_bone_motion_track_bundle, name, motion->factory);
-        if (keyframes_map) {
-            keyframes = (nanoem_motion_bone_keyframe_t **) nanoem_calloc(kh_size(keyframes_map), sizeof(*keyframes), status);
+        track = nanoemMotionTrackBundleFindTrack(motion->local_bone_motion_track_bundle, name, motion->factory);
+        if (track) {
+            keyframes = (nanoem_motion_bone_keyframe_t **) nanoem_calloc(track->num_keyframes, sizeof(*keyframes), status);
             if (nanoem_is_not_null(keyframes)) {
-                for (it = kh_begin(keyframes_map), end = kh_end(keyframes_map); it != end; it++) {
-                    if (kh_exist(keyframes_map, it)) {
-                        keyframes[i++] = (nanoem_motion_bone_keyframe_t *) kh_val(keyframes_map, it);
-                    }
-                }
-                *num_keyframes = kh_size(keyframes_map);
+                nanoem_crt_memcpy(keyframes, track->keyframes, track->num_keyframes * sizeof(*keyframes));
+                *num_keyframes = track->num_keyframes;
                 return keyframes;
             }
         }
@@ -6851,20 +7059,14 @@ nanoem_motion_morph_keyframe_t *const *APIENTRY
 nanoemMotionExtractMorphTrackKeyframes(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_rsize_t *num_keyframes, nanoem_status_t *status)
 {
     nanoem_motion_morph_keyframe_t **keyframes = NULL;
-    kh_keyframe_map_t *keyframes_map;
-    khiter_t it, end;
-    nanoem_rsize_t i = 0;
+    const nanoem_motion_track_t *track;
     if (nanoem_is_not_null(motion)) {
-        keyframes_map = nanoemMotionFindKeyframesMap(motion->local_morph_motion_track_bundle, name, motion->factory);
-        if (keyframes_map) {
-            keyframes = (nanoem_motion_morph_keyframe_t **) nanoem_calloc(kh_size(keyframes_map), sizeof(*keyframes), status);
+        track = nanoemMotionTrackBundleFindTrack(motion->local_morph_motion_track_bundle, name, motion->factory);
+        if (track) {
+            keyframes = (nanoem_motion_morph_keyframe_t **) nanoem_calloc(track->num_keyframes, sizeof(*keyframes), status);
             if (nanoem_is_not_null(keyframes)) {
-                for (it = kh_begin(keyframes_map), end = kh_end(keyframes_map); it != end; it++) {
-                    if (kh_exist(keyframes_map, it)) {
-                        keyframes[i++] = (nanoem_motion_morph_keyframe_t *) kh_val(keyframes_map, it);
-                    }
-                }
-                *num_keyframes = kh_size(keyframes_map);
+                nanoem_crt_memcpy(keyframes, track->keyframes, track->num_keyframes * sizeof(*keyframes));
+                *num_keyframes = track->num_keyframes;
                 return keyframes;
             }
         }
@@ -6894,19 +7096,7 @@ nanoemMotionFindAccessoryKeyframeObject(const nanoem_motion_t *motion, nanoem_fr
 const nanoem_motion_bone_keyframe_t *APIENTRY
 nanoemMotionFindBoneKeyframeObject(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_frame_index_t index)
 {
-    nanoem_motion_bone_keyframe_t *keyframe = NULL;
-    kh_keyframe_map_t *keyframes_map;
-    khiter_t it;
-    if (nanoem_is_not_null(motion)) {
-        keyframes_map = nanoemMotionFindKeyframesMap(motion->local_bone_motion_track_bundle, name, motion->factory);
-        if (keyframes_map) {
-            it = kh_get_keyframe_map(keyframes_map, index);
-            if (it != kh_end(keyframes_map)) {
-                keyframe = (nanoem_motion_bone_keyframe_t *) kh_val(keyframes_map, it);
-            }
-        }
-    }
-    return keyframe;
+    return nanoemMotionTrackFindBoneKeyframeObject(nanoemMotionResolveBoneTrack(motion, name), index);
 }
 
 const nanoem_motion_camera_keyframe_t *APIENTRY
@@ -6960,19 +7150,7 @@ nanoemMotionFindModelKeyframeObject(const nanoem_motion_t *motion, nanoem_frame_
 const nanoem_motion_morph_keyframe_t *APIENTRY
 nanoemMotionFindMorphKeyframeObject(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_frame_index_t index)
 {
-    nanoem_motion_morph_keyframe_t *keyframe = NULL;
-    kh_keyframe_map_t *keyframes_map;
-    khiter_t it;
-    if (nanoem_is_not_null(motion)) {
-        keyframes_map = nanoemMotionFindKeyframesMap(motion->local_morph_motion_track_bundle, name, motion->factory);
-        if (keyframes_map) {
-            it = kh_get_keyframe_map(keyframes_map, index);
-            if (it != kh_end(keyframes_map)) {
-                keyframe = (nanoem_motion_morph_keyframe_t *) kh_val(keyframes_map, it);
-            }
-        }
-    }
-    return keyframe;
+    return nanoemMotionTrackFindMorphKeyframeObject(nanoemMotionResolveMorphTrack(motion, name), index);
 }
 
 const nanoem_motion_self_shadow_keyframe_t *APIENTRY
@@ -6994,10 +7172,6 @@ nanoemMotionFindSelfShadowKeyframeObject(const nanoem_motion_t *motion, nanoem_f
 void APIENTRY
 nanoemMotionSearchClosestAccessoryKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_accessory_keyframe_t **prev_keyframe, nanoem_motion_accessory_keyframe_t **next_keyframe)
 {
-    nanoem_motion_accessory_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    nanoem_motion_accessory_keyframe_t *const *accessory_keyframes;
-    nanoem_rsize_t num_accessory_keyframes, i;
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
@@ -7005,31 +7179,23 @@ nanoemMotionSearchClosestAccessoryKeyframes(const nanoem_motion_t *motion, nanoe
         *next_keyframe = NULL;
     }
     if (nanoem_is_not_null(motion)) {
-        accessory_keyframes = motion->accessory_keyframes;
-        num_accessory_keyframes = motion->num_accessory_keyframes;
-        for (i = 0; i < num_accessory_keyframes; i++) {
-            current_keyframe = accessory_keyframes[i];
-            nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                base_index,
-                &prev_nearest,
-                &next_nearest,
-                (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                (nanoem_motion_keyframe_object_t **) next_keyframe,
-                (nanoem_motion_keyframe_object_t **) &last_keyframe);
-        }
-        if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-            *next_keyframe = last_keyframe;
-        }
+        nanoemMotionKeyframeObjectArraySearchClosest((nanoem_motion_keyframe_object_t *const *) motion->accessory_keyframes,
+            motion->num_accessory_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
     }
 }
 
 void APIENTRY
 nanoemMotionSearchClosestBoneKeyframes(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_frame_index_t base_index, nanoem_motion_bone_keyframe_t **prev_keyframe, nanoem_motion_bone_keyframe_t **next_keyframe)
 {
-    nanoem_motion_bone_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    kh_keyframe_map_t *keyframes_map;
-    khiter_t it, end;
+    nanoemMotionTrackSearchClosestBoneKeyframes(nanoemMotionResolveBoneTrack(motion, name), base_index, prev_keyframe, next_keyframe);
+}
+
+void APIENTRY
+nanoemMotionSearchClosestCameraKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_camera_keyframe_t **prev_keyframe, nanoem_motion_camera_keyframe_t **next_keyframe)
+{
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
@@ -7037,34 +7203,17 @@ nanoemMotionSearchClosestBoneKeyframes(const nanoem_motion_t *motion, const nano
         *next_keyframe = NULL;
     }
     if (nanoem_is_not_null(motion)) {
-        keyframes_map = nanoemMotionFindKeyframesMap(motion->local_bone_motion_track_bundle, name, motion->factory);
-        if (keyframes_map) {
-            for (it = kh_begin(keyframes_map), end = kh_end(keyframes_map); it != end; it++) {
-                if (kh_exist(keyframes_map, it)) {
-                    current_keyframe = (nanoem_motion_bone_keyframe_t *) kh_val(keyframes_map, it);
-                    nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                        base_index,
-                        &prev_nearest,
-                        &next_nearest,
-                        (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                        (nanoem_motion_keyframe_object_t **) next_keyframe,
-                        (nanoem_motion_keyframe_object_t **) &last_keyframe);
-                }
-            }
-            if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-                *next_keyframe = last_keyframe;
-            }
-        }
+        nanoemMotionKeyframeObjectArraySearchClosest((nanoem_motion_keyframe_object_t *const *) motion->camera_keyframes,
+            motion->num_camera_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
     }
 }
 
 void APIENTRY
-nanoemMotionSearchClosestCameraKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_camera_keyframe_t **prev_keyframe, nanoem_motion_camera_keyframe_t **next_keyframe)
+nanoemMotionSearchClosestLightKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_light_keyframe_t **prev_keyframe, nanoem_motion_light_keyframe_t **next_keyframe)
 {
-    nanoem_motion_camera_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    nanoem_motion_camera_keyframe_t *const *camera_keyframes;
-    nanoem_rsize_t num_camera_keyframes, i;
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
@@ -7072,31 +7221,17 @@ nanoemMotionSearchClosestCameraKeyframes(const nanoem_motion_t *motion, nanoem_f
         *next_keyframe = NULL;
     }
     if (nanoem_is_not_null(motion)) {
-        camera_keyframes = motion->camera_keyframes;
-        num_camera_keyframes = motion->num_camera_keyframes;
-        for (i = 0; i < num_camera_keyframes; i++) {
-            current_keyframe = camera_keyframes[i];
-            nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                base_index,
-                &prev_nearest,
-                &next_nearest,
-                (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                (nanoem_motion_keyframe_object_t **) next_keyframe,
-                (nanoem_motion_keyframe_object_t **) &last_keyframe);
-        }
-        if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-            *next_keyframe = last_keyframe;
-        }
+        nanoemMotionKeyframeObjectArraySearchClosest((nanoem_motion_keyframe_object_t *const *) motion->light_keyframes,
+            motion->num_light_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
     }
 }
 
 void APIENTRY
-nanoemMotionSearchClosestLightKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_light_keyframe_t **prev_keyframe, nanoem_motion_light_keyframe_t **next_keyframe)
+nanoemMotionSearchClosestModelKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_model_keyframe_t **prev_keyframe, nanoem_motion_model_keyframe_t **next_keyframe)
 {
-    nanoem_motion_light_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    nanoem_motion_light_keyframe_t *const *light_keyframes;
-    nanoem_rsize_t num_light_keyframes, i;
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
@@ -7104,31 +7239,23 @@ nanoemMotionSearchClosestLightKeyframes(const nanoem_motion_t *motion, nanoem_fr
         *next_keyframe = NULL;
     }
     if (nanoem_is_not_null(motion)) {
-        light_keyframes = motion->light_keyframes;
-        num_light_keyframes = motion->num_light_keyframes;
-        for (i = 0; i < num_light_keyframes; i++) {
-            current_keyframe = light_keyframes[i];
-            nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                base_index,
-                &prev_nearest,
-                &next_nearest,
-                (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                (nanoem_motion_keyframe_object_t **) next_keyframe,
-                (nanoem_motion_keyframe_object_t **) &last_keyframe);
-        }
-        if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-            *next_keyframe = last_keyframe;
-        }
+        nanoemMotionKeyframeObjectArraySearchClosest((nanoem_motion_keyframe_object_t *const *) motion->model_keyframes,
+            motion->num_model_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
     }
 }
 
 void APIENTRY
-nanoemMotionSearchClosestModelKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_model_keyframe_t **prev_keyframe, nanoem_motion_model_keyframe_t **next_keyframe)
+nanoemMotionSearchClosestMorphKeyframes(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_frame_index_t base_index, nanoem_motion_morph_keyframe_t **prev_keyframe, nanoem_motion_morph_keyframe_t **next_keyframe)
+{
+    nanoemMotionTrackSearchClosestMorphKeyframes(nanoemMotionResolveMorphTrack(motion, name), base_index, prev_keyframe, next_keyframe);
+}
+
+void APIENTRY
+nanoemMotionSearchClosestSelfShadowKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_self_shadow_keyframe_t **prev_keyframe, nanoem_motion_self_shadow_keyframe_t **next_keyframe)
 {
-    nanoem_motion_model_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    nanoem_motion_model_keyframe_t *const *model_keyframes;
-    nanoem_rsize_t num_model_keyframes, i;
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
@@ -7136,66 +7263,180 @@ nanoemMotionSearchClosestModelKeyframes(const nanoem_motion_t *motion, nanoem_fr
         *next_keyframe = NULL;
     }
     if (nanoem_is_not_null(motion)) {
-        model_keyframes = motion->model_keyframes;
-        num_model_keyframes = motion->num_model_keyframes;
-        for (i = 0; i < num_model_keyframes; i++) {
-            current_keyframe = model_keyframes[i];
-            nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                base_index,
-                &prev_nearest,
-                &next_nearest,
-                (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                (nanoem_motion_keyframe_object_t **) next_keyframe,
-                (nanoem_motion_keyframe_object_t **) &last_keyframe);
+        nanoemMotionKeyframeObjectArraySearchClosest((nanoem_motion_keyframe_object_t *const *) motion->self_shadow_keyframes,
+            motion->num_self_shadow_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+const nanoem_motion_track_t *APIENTRY
+nanoemMotionResolveBoneTrack(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name)
+{
+    return nanoem_is_not_null(motion) ? nanoemMotionTrackBundleFindTrack(motion->local_bone_motion_track_bundle, name, motion->factory) : NULL;
+}
+
+const nanoem_motion_track_t *APIENTRY
+nanoemMotionResolveMorphTrack(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name)
+{
+    return nanoem_is_not_null(motion) ? nanoemMotionTrackBundleFindTrack(motion->local_morph_motion_track_bundle, name, motion->factory) : NULL;
+}
+
+nanoem_rsize_t APIENTRY
+nanoemMotionGetNumBoneTracks(const nanoem_motion_t *motion)
+{
+    return nanoem_is_not_null(motion) && nanoem_is_not_null(motion->local_bone_motion_track_bundle) ? kh_size(motion->local_bone_motion_track_bundle) : 0;
+}
+
+nanoem_rsize_t APIENTRY
+nanoemMotionGetNumMorphTracks(const nanoem_motion_t *motion)
+{
+    return nanoem_is_not_null(motion) && nanoem_is_not_null(motion->local_morph_motion_track_bundle) ? kh_size(motion->local_morph_motion_track_bundle) : 0;
+}
+
+const nanoem_motion_bone_keyframe_t *APIENTRY
+nanoemMotionTrackFindBoneKeyframeObject(const nanoem_motion_track_t *track, nanoem_frame_index_t index)
+{
+    nanoem_motion_bone_keyframe_t *keyframe = NULL;
+    nanoem_rsize_t offset;
+    if (nanoem_is_not_null(track)) {
+        offset = nanoemMotionKeyframeObjectArrayLowerBound(track->keyframes, track->num_keyframes, index);
+        if (offset < track->num_keyframes && track->keyframes[offset]->frame_index == index) {
+            keyframe = (nanoem_motion_bone_keyframe_t *) track->keyframes[offset];
         }
-        if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-            *next_keyframe = last_keyframe;
+    }
+    return keyframe;
+}
+
+const nanoem_motion_morph_keyframe_t *APIENTRY
+nanoemMotionTrackFindMorphKeyframeObject(const nanoem_motion_track_t *track, nanoem_frame_index_t index)
+{
+    nanoem_motion_morph_keyframe_t *keyframe = NULL;
+    nanoem_rsize_t offset;
+    if (nanoem_is_not_null(track)) {
+        offset = nanoemMotionKeyframeObjectArrayLowerBound(track->keyframes, track->num_keyframes, index);
+        if (offset < track->num_keyframes && track->keyframes[offset]->frame_index == index) {
+            keyframe = (nanoem_motion_morph_keyframe_t *) track->keyframes[offset];
         }
     }
+    return keyframe;
 }
 
 void APIENTRY
-nanoemMotionSearchClosestMorphKeyframes(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name, nanoem_frame_index_t base_index, nanoem_motion_morph_keyframe_t **prev_keyframe, nanoem_motion_morph_keyframe_t **next_keyframe)
+nanoemMotionTrackSearchClosestBoneKeyframes(const nanoem_motion_track_t *track, nanoem_frame_index_t base_index, nanoem_motion_bone_keyframe_t **prev_keyframe, nanoem_motion_bone_keyframe_t **next_keyframe)
 {
-    nanoem_motion_morph_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    kh_keyframe_map_t *keyframes_map;
-    khiter_t it, end;
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
     if (nanoem_is_not_null(next_keyframe)) {
         *next_keyframe = NULL;
     }
+    if (nanoem_is_not_null(track)) {
+        nanoemMotionKeyframeObjectArraySearchClosest(track->keyframes,
+            track->num_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionTrackSearchClosestMorphKeyframes(const nanoem_motion_track_t *track, nanoem_frame_index_t base_index, nanoem_motion_morph_keyframe_t **prev_keyframe, nanoem_motion_morph_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(track)) {
+        nanoemMotionKeyframeObjectArraySearchClosest(track->keyframes,
+            track->num_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionKeyframeCursorReset(nanoem_motion_keyframe_cursor_t *cursor)
+{
+    if (nanoem_is_not_null(cursor)) {
+        cursor->keyframes = NULL;
+        cursor->num_keyframes = 0;
+        cursor->offset = 0;
+    }
+}
+
+const nanoem_motion_accessory_keyframe_t *APIENTRY
+nanoemMotionFindAccessoryKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_accessory_keyframe_t *keyframe = NULL;
     if (nanoem_is_not_null(motion)) {
-        keyframes_map = nanoemMotionFindKeyframesMap(motion->local_morph_motion_track_bundle, name, motion->factory);
-        if (keyframes_map) {
-            for (it = kh_begin(keyframes_map), end = kh_end(keyframes_map); it != end; it++) {
-                if (kh_exist(keyframes_map, it)) {
-                    current_keyframe = (nanoem_motion_morph_keyframe_t *) kh_val(keyframes_map, it);
-                    nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                        base_index,
-                        &prev_nearest,
-                        &next_nearest,
-                        (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                        (nanoem_motion_keyframe_object_t **) next_keyframe,
-                        (nanoem_motion_keyframe_object_t **) &last_keyframe);
-                }
-            }
-            if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-                *next_keyframe = last_keyframe;
-            }
-        }
+        keyframe = (nanoem_motion_accessory_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->accessory_keyframes,
+            motion->num_accessory_keyframes,
+            index);
     }
+    return keyframe;
+}
+
+const nanoem_motion_camera_keyframe_t *APIENTRY
+nanoemMotionFindCameraKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_camera_keyframe_t *keyframe = NULL;
+    if (nanoem_is_not_null(motion)) {
+        keyframe = (nanoem_motion_camera_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->camera_keyframes,
+            motion->num_camera_keyframes,
+            index);
+    }
+    return keyframe;
+}
+
+const nanoem_motion_light_keyframe_t *APIENTRY
+nanoemMotionFindLightKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_light_keyframe_t *keyframe = NULL;
+    if (nanoem_is_not_null(motion)) {
+        keyframe = (nanoem_motion_light_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->light_keyframes,
+            motion->num_light_keyframes,
+            index);
+    }
+    return keyframe;
+}
+
+const nanoem_motion_model_keyframe_t *APIENTRY
+nanoemMotionFindModelKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_model_keyframe_t *keyframe = NULL;
+    if (nanoem_is_not_null(motion)) {
+        keyframe = (nanoem_motion_model_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->model_keyframes,
+            motion->num_model_keyframes,
+            index);
+    }
+    return keyframe;
+}
+
+const nanoem_motion_self_shadow_keyframe_t *APIENTRY
+nanoemMotionFindSelfShadowKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_self_shadow_keyframe_t *keyframe = NULL;
+    if (nanoem_is_not_null(motion)) {
+        keyframe = (nanoem_motion_self_shadow_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->self_shadow_keyframes,
+            motion->num_self_shadow_keyframes,
+            index);
+    }
+    return keyframe;
 }
 
 void APIENTRY
-nanoemMotionSearchClosestSelfShadowKeyframes(const nanoem_motion_t *motion, nanoem_frame_index_t base_index, nanoem_motion_self_shadow_keyframe_t **prev_keyframe, nanoem_motion_self_shadow_keyframe_t **next_keyframe)
+nanoemMotionSearchClosestAccessoryKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_accessory_keyframe_t **prev_keyframe, nanoem_motion_accessory_keyframe_t **next_keyframe)
 {
-    nanoem_motion_self_shadow_keyframe_t *current_keyframe, *last_keyframe = NULL;
-    nanoem_frame_index_t prev_nearest = NANOEM_FRAME_INDEX_MAX_SIZE, next_nearest = NANOEM_FRAME_INDEX_MAX_SIZE;
-    nanoem_motion_self_shadow_keyframe_t *const *self_shadow_keyframes;
-    nanoem_rsize_t num_self_shadow_keyframes, i;
     if (nanoem_is_not_null(prev_keyframe)) {
         *prev_keyframe = NULL;
     }
@@ -7203,21 +7444,146 @@ nanoemMotionSearchClosestSelfShadowKeyframes(const nanoem_motion_t *motion, nano
         *next_keyframe = NULL;
     }
     if (nanoem_is_not_null(motion)) {
-        self_shadow_keyframes = motion->self_shadow_keyframes;
-        num_self_shadow_keyframes = motion->num_self_shadow_keyframes;
-        for (i = 0; i < num_self_shadow_keyframes; i++) {
-            current_keyframe = self_shadow_keyframes[i];
-            nanoemMotionGetNearestKeyframes(&current_keyframe->base,
-                base_index,
-                &prev_nearest,
-                &next_nearest,
-                (nanoem_motion_keyframe_object_t **) prev_keyframe,
-                (nanoem_motion_keyframe_object_t **) next_keyframe,
-                (nanoem_motion_keyframe_object_t **) &last_keyframe);
-        }
-        if (nanoem_is_not_null(next_keyframe) && !*next_keyframe) {
-            *next_keyframe = last_keyframe;
-        }
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->accessory_keyframes,
+            motion->num_accessory_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionSearchClosestCameraKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_camera_keyframe_t **prev_keyframe, nanoem_motion_camera_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(motion)) {
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->camera_keyframes,
+            motion->num_camera_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionSearchClosestLightKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_light_keyframe_t **prev_keyframe, nanoem_motion_light_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(motion)) {
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->light_keyframes,
+            motion->num_light_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionSearchClosestModelKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_model_keyframe_t **prev_keyframe, nanoem_motion_model_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(motion)) {
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->model_keyframes,
+            motion->num_model_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionSearchClosestSelfShadowKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_self_shadow_keyframe_t **prev_keyframe, nanoem_motion_self_shadow_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(motion)) {
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            (nanoem_motion_keyframe_object_t *const *) motion->self_shadow_keyframes,
+            motion->num_self_shadow_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+const nanoem_motion_bone_keyframe_t *APIENTRY
+nanoemMotionTrackFindBoneKeyframeObjectWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_bone_keyframe_t *keyframe = NULL;
+    if (nanoem_is_not_null(track)) {
+        keyframe = (nanoem_motion_bone_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor, track->keyframes, track->num_keyframes, index);
+    }
+    return keyframe;
+}
+
+const nanoem_motion_morph_keyframe_t *APIENTRY
+nanoemMotionTrackFindMorphKeyframeObjectWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index)
+{
+    nanoem_motion_morph_keyframe_t *keyframe = NULL;
+    if (nanoem_is_not_null(track)) {
+        keyframe = (nanoem_motion_morph_keyframe_t *) nanoemMotionKeyframeObjectArrayFindWithCursor(cursor, track->keyframes, track->num_keyframes, index);
+    }
+    return keyframe;
+}
+
+void APIENTRY
+nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_bone_keyframe_t **prev_keyframe, nanoem_motion_bone_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(track)) {
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            track->keyframes,
+            track->num_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
+    }
+}
+
+void APIENTRY
+nanoemMotionTrackSearchClosestMorphKeyframesWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_morph_keyframe_t **prev_keyframe, nanoem_motion_morph_keyframe_t **next_keyframe)
+{
+    if (nanoem_is_not_null(prev_keyframe)) {
+        *prev_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(next_keyframe)) {
+        *next_keyframe = NULL;
+    }
+    if (nanoem_is_not_null(track)) {
+        nanoemMotionKeyframeObjectArraySearchClosestWithCursor(cursor,
+            track->keyframes,
+            track->num_keyframes,
+            base_index,
+            (nanoem_motion_keyframe_object_t **) prev_keyframe,
+            (nanoem_motion_keyframe_object_t **) next_keyframe);
     }
 }
 
@@ -1201,6 +1201,14 @@ nanoemModelSoftBodyGetModelObjectMutable(nanoem_model_soft_body_t *body);
 
 NANOEM_DECL_API nanoem_model_t *APIENTRY
 nanoemModelCreate(nanoem_unicode_string_factory_t *factory, nanoem_status_t *status);
+/**
+ * Vertices, materials, bones, morphs, rigid bodies and joints loaded while the arena is enabled are carved
+ * contiguously from slab blocks owned by the model instead of allocating each object separately.
+ */
+NANOEM_DECL_API nanoem_bool_t APIENTRY
+nanoemModelIsArenaEnabled(const nanoem_model_t *model);
+NANOEM_DECL_API void APIENTRY
+nanoemModelSetArenaEnabled(nanoem_model_t *model, nanoem_bool_t value);
 NANOEM_DECL_API nanoem_bool_t APIENTRY
 nanoemModelLoadFromBufferPMD(nanoem_model_t *model, nanoem_buffer_t *buffer, nanoem_status_t *status);
 NANOEM_DECL_API nanoem_bool_t APIENTRY
@@ -1262,8 +1270,23 @@ NANOEM_DECL_OPAQUE(nanoem_motion_morph_keyframe_t);
 NANOEM_DECL_OPAQUE(nanoem_motion_physics_world_keyframe_t);
 NANOEM_DECL_OPAQUE(nanoem_motion_self_shadow_keyframe_t);
 NANOEM_DECL_OPAQUE(nanoem_motion_t);
+NANOEM_DECL_OPAQUE(nanoem_motion_track_t);
 typedef nanoem_u32_t nanoem_frame_index_t;
 
+/**
+ * \brief Position of the last keyframe search
+ *
+ * A cursor steps from the last searched position to find keyframes at the next base index in constant time while
+ * frames advance sequentially, and falls back to the binary search on a large seek or once keyframes are changed.
+ * Members are private and the cursor must be initialized with ::nanoemMotionKeyframeCursorReset before use.
+ * A cursor must be used only with one track or one kind of global keyframes.
+ */
+typedef struct nanoem_motion_keyframe_cursor_t {
+    const void *keyframes;
+    nanoem_rsize_t num_keyframes;
+    nanoem_rsize_t offset;
+} nanoem_motion_keyframe_cursor_t;
+
 NANOEM_DECL_ENUM(nanoem_i32_t, nanoem_motion_format_type_t){
     NANOEM_MOTION_FORMAT_TYPE_UNKNOWN = -1,
     NANOEM_MOTION_FORMAT_TYPE_FIRST_ENUM,
@@ -1582,6 +1605,69 @@ NANOEM_DECL_API void APIENTRY
 nanoemMotionDestroy(nanoem_motion_t *motion);
 /** @} */
 
+/**
+ * \defgroup nanoem_motion_track Motion Track
+ *
+ * Track handles are owned by the motion and valid until it is destroyed. Tracks are never removed,
+ * so a name resolved to NULL must be resolved again once the number of tracks changes.
+ * @{
+ */
+NANOEM_DECL_API const nanoem_motion_track_t *APIENTRY
+nanoemMotionResolveBoneTrack(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name);
+NANOEM_DECL_API const nanoem_motion_track_t *APIENTRY
+nanoemMotionResolveMorphTrack(const nanoem_motion_t *motion, const nanoem_unicode_string_t *name);
+NANOEM_DECL_API nanoem_rsize_t APIENTRY
+nanoemMotionGetNumBoneTracks(const nanoem_motion_t *motion);
+NANOEM_DECL_API nanoem_rsize_t APIENTRY
+nanoemMotionGetNumMorphTracks(const nanoem_motion_t *motion);
+NANOEM_DECL_API const nanoem_motion_bone_keyframe_t *APIENTRY
+nanoemMotionTrackFindBoneKeyframeObject(const nanoem_motion_track_t *track, nanoem_frame_index_t index);
+NANOEM_DECL_API const nanoem_motion_morph_keyframe_t *APIENTRY
+nanoemMotionTrackFindMorphKeyframeObject(const nanoem_motion_track_t *track, nanoem_frame_index_t index);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionTrackSearchClosestBoneKeyframes(const nanoem_motion_track_t *track, nanoem_frame_index_t base_index, nanoem_motion_bone_keyframe_t **prev_keyframe, nanoem_motion_bone_keyframe_t **next_keyframe);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionTrackSearchClosestMorphKeyframes(const nanoem_motion_track_t *track, nanoem_frame_index_t base_index, nanoem_motion_morph_keyframe_t **prev_keyframe, nanoem_motion_morph_keyframe_t **next_keyframe);
+/** @} */
+
+/**
+ * \defgroup nanoem_motion_keyframe_cursor Motion Keyframe Cursor
+ *
+ * Same as the Find and SearchClosest functions without the cursor but amortized O(1) for sequential base indices.
+ * @{
+ */
+NANOEM_DECL_API void APIENTRY
+nanoemMotionKeyframeCursorReset(nanoem_motion_keyframe_cursor_t *cursor);
+NANOEM_DECL_API const nanoem_motion_accessory_keyframe_t *APIENTRY
+nanoemMotionFindAccessoryKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API const nanoem_motion_camera_keyframe_t *APIENTRY
+nanoemMotionFindCameraKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API const nanoem_motion_light_keyframe_t *APIENTRY
+nanoemMotionFindLightKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API const nanoem_motion_model_keyframe_t *APIENTRY
+nanoemMotionFindModelKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API const nanoem_motion_self_shadow_keyframe_t *APIENTRY
+nanoemMotionFindSelfShadowKeyframeObjectWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionSearchClosestAccessoryKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_accessory_keyframe_t **prev_keyframe, nanoem_motion_accessory_keyframe_t **next_keyframe);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionSearchClosestCameraKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_camera_keyframe_t **prev_keyframe, nanoem_motion_camera_keyframe_t **next_keyframe);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionSearchClosestLightKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_light_keyframe_t **prev_keyframe, nanoem_motion_light_keyframe_t **next_keyframe);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionSearchClosestModelKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_model_keyframe_t **prev_keyframe, nanoem_motion_model_keyframe_t **next_keyframe);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionSearchClosestSelfShadowKeyframesWithCursor(const nanoem_motion_t *motion, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_self_shadow_keyframe_t **prev_keyframe, nanoem_motion_self_shadow_keyframe_t **next_keyframe);
+NANOEM_DECL_API const nanoem_motion_bone_keyframe_t *APIENTRY
+nanoemMotionTrackFindBoneKeyframeObjectWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API const nanoem_motion_morph_keyframe_t *APIENTRY
+nanoemMotionTrackFindMorphKeyframeObjectWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t index);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_bone_keyframe_t **prev_keyframe, nanoem_motion_bone_keyframe_t **next_keyframe);
+NANOEM_DECL_API void APIENTRY
+nanoemMotionTrackSearchClosestMorphKeyframesWithCursor(const nanoem_motion_track_t *track, nanoem_motion_keyframe_cursor_t *cursor, nanoem_frame_index_t base_index, nanoem_motion_morph_keyframe_t **prev_keyframe, nanoem_motion_morph_keyframe_t **next_keyframe);
+/** @} */
+
 /**
  * \defgroup nanoem_userdata Custom User Data
  * @{
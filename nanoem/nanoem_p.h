@@ -35,6 +35,7 @@
 
 #define nanoem_crt_memcmp(left, right, size) memcmp((left), (right), (size))
 #define nanoem_crt_memcpy(dst, src, size) memcpy((dst), (src), (size))
+#define nanoem_crt_memmove(dst, src, size) memmove((dst), (src), (size))
 #define nanoem_crt_strcmp(left, right) strcmp((left), (right))
 #define nanoem_crt_strncpy(dst, src, size) strncpy((dst), (src), (size))
 #define nanoem_crt_strchr(str, chr) strchr((str), (chr))
@@ -241,24 +242,25 @@ static const char
 
 KHASH_INIT(annotation, char *, char *, 1, kh_str_hash_func, kh_str_hash_equal)
 KHASH_INIT(string_cache, char *, nanoem_i32_t, 1, kh_str_hash_func, kh_str_hash_equal)
-KHASH_MAP_INIT_INT(keyframe_map, nanoem_motion_keyframe_object_t *)
 
 enum {
     nanoem_false,
     nanoem_true
 };
 
-typedef struct nanoem_motion_track_t nanoem_motion_track_t;
 typedef int nanoem_motion_track_index_t;
 struct nanoem_motion_track_t {
     nanoem_motion_track_index_t id;
     nanoem_unicode_string_factory_t *factory;
     nanoem_unicode_string_t *name;
-    kh_keyframe_map_t *keyframes;
+    /* keyframes of the track ordered by frame index (no duplicated frame index) */
+    nanoem_motion_keyframe_object_t **keyframes;
+    nanoem_rsize_t num_keyframes;
+    nanoem_rsize_t num_allocated_keyframes;
 };
-#define nanoem_motion_track_hash_equal(a, b) ((a).factory->compare((a).factory->opaque_data, (a).name, (b).name) == 0)
-#define nanoem_motion_track_hash_func(a) ((a).factory->hash((a).factory->opaque_data, (a).name))
-KHASH_INIT(motion_track_bundle, nanoem_motion_track_t, char, 0, nanoem_motion_track_hash_func, nanoem_motion_track_hash_equal)
+#define nanoem_motion_track_hash_equal(a, b) ((a)->factory->compare((a)->factory->opaque_data, (a)->name, (b)->name) == 0)
+#define nanoem_motion_track_hash_func(a) ((a)->factory->hash((a)->factory->opaque_data, (a)->name))
+KHASH_INIT(motion_track_bundle, nanoem_motion_track_t *, char, 0, nanoem_motion_track_hash_func, nanoem_motion_track_hash_equal)
 
 
 struct nanoem_f128_components_t {
@@ -293,6 +295,15 @@ struct nanoem_info_t {
     unsigned int padding : 1;
 };
 
+typedef struct nanoem_model_arena_block_t nanoem_model_arena_block_t;
+struct nanoem_model_arena_block_t {
+    nanoem_model_arena_block_t *next;
+    nanoem_rsize_t capacity;
+    nanoem_rsize_t offset;
+    nanoem_rsize_t num_live_objects;
+    nanoem_bool_t is_orphaned;
+};
+
 struct nanoem_model_t {
     nanoem_f32_t version;
     nanoem_u8_t info_length;
@@ -325,6 +336,8 @@ struct nanoem_model_t {
     nanoem_model_joint_t **joints;
     nanoem_rsize_t num_soft_bodies;
     nanoem_model_soft_body_t **soft_bodies;
+    nanoem_model_arena_block_t *arena_blocks;
+    nanoem_bool_t is_arena_enabled;
     nanoem_user_data_t *user_data;
 };
 
@@ -338,6 +351,7 @@ struct nanoem_model_object_t {
         const nanoem_model_soft_body_t *soft_body;
     } parent;
     nanoem_user_data_t *user_data;
+    nanoem_model_arena_block_t *arena_block;
 };
 
 struct nanoem_model_vertex_t {
@@ -1052,9 +1066,21 @@ nanoemMotionSelfShadowKeyframeDestroy(nanoem_motion_self_shadow_keyframe_t *keyf
 
 NANOEM_DECL_INTERNAL void
 nanoemStringCacheDestroy(kh_string_cache_t *cache);
+NANOEM_DECL_INTERNAL nanoem_motion_track_t *
+nanoemMotionTrackCreate(nanoem_unicode_string_t *name, nanoem_motion_track_index_t id, nanoem_unicode_string_factory_t *factory, nanoem_status_t *status);
+NANOEM_DECL_INTERNAL void
+nanoemMotionTrackAddKeyframe(nanoem_motion_track_t *track, nanoem_motion_keyframe_object_t *keyframe, nanoem_frame_index_t frame_index, int *ret);
+NANOEM_DECL_INTERNAL void
+nanoemMotionTrackRemoveKeyframe(nanoem_motion_track_t *track, nanoem_frame_index_t frame_index);
+NANOEM_DECL_INTERNAL void
+nanoemMotionTrackDestroy(nanoem_motion_track_t *track);
 NANOEM_DECL_INTERNAL void
 nanoemMotionTrackBundleAddKeyframe(kh_motion_track_bundle_t *bundle, nanoem_motion_keyframe_object_t *keyframe, nanoem_frame_index_t frame_index, const nanoem_unicode_string_t *name, nanoem_unicode_string_factory_t *factory, int *ret);
 NANOEM_DECL_INTERNAL void
+nanoemMotionTrackBundlePutTrack(kh_motion_track_bundle_t *bundle, nanoem_motion_track_t *track, int *ret);
+NANOEM_DECL_INTERNAL void
+nanoemMotionTrackBundleSortAllKeyframes(kh_motion_track_bundle_t *bundle);
+NANOEM_DECL_INTERNAL void
 nanoemMotionTrackBundleDestroy(kh_motion_track_bundle_t *bundle, nanoem_unicode_string_factory_t *factory);
 
 nanoem_pragma_diagnostics_push();
@@ -1245,8 +1271,7 @@ nanoemMotionTrackBundleResolveName(const kh_motion_track_bundle_t *bundle, int i
     if (nanoem_is_not_null(bundle)) {
         end = kh_end(bundle);
         for (it = kh_begin(bundle); it != end; it++) {
-            track = &kh_key(bundle, it);
-            if (kh_exist(bundle, it) && track->id == id) {
+            if (kh_exist(bundle, it) && (track = kh_key(bundle, it))->id == id) {
                 s = track->name;
                 break;
             }
@@ -1284,25 +1309,34 @@ nanoemBufferReadIntegerNullable(nanoem_buffer_t *buffer, nanoem_rsize_t size, na
 static nanoem_motion_track_index_t
 nanoemMotionTrackBundleResolveId(kh_motion_track_bundle_t *bundle, nanoem_unicode_string_t *name, nanoem_unicode_string_factory_t *factory, nanoem_motion_track_index_t *allocated_id, nanoem_unicode_string_t **found_name, int *ret)
 {
-    nanoem_motion_track_t pair;
+    nanoem_motion_track_t key, *track;
     khiter_t it;
     nanoem_motion_track_index_t id = 0;
-    pair.factory = factory;
-    pair.id = 0;
-    pair.keyframes = NULL;
-    pair.name = name;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    key.factory = factory;
+    key.name = name;
     *found_name = NULL;
     if (nanoem_is_not_null(bundle) && nanoem_is_not_null(name) && nanoem_is_not_null(factory)) {
-        it = kh_get_motion_track_bundle(bundle, pair);
+        it = kh_get_motion_track_bundle(bundle, &key);
         if (it != kh_end(bundle)) {
-            id = kh_key(bundle, it).id;
-            *found_name = kh_key(bundle, it).name;
+            track = kh_key(bundle, it);
+            id = track->id;
+            *found_name = track->name;
         }
         else {
-            id = pair.id = (++*allocated_id);
-            pair.name = name;
-            pair.keyframes = kh_init_keyframe_map();
-            kh_put_motion_track_bundle(bundle, pair, ret);
+            track = nanoemMotionTrackCreate(name, *allocated_id + 1, factory, &status);
+            if (nanoem_is_not_null(track)) {
+                id = ++*allocated_id;
+                kh_put_motion_track_bundle(bundle, track, ret);
+                if (*ret < 0) {
+                    /* the name is owned by the caller on failure */
+                    track->name = NULL;
+                    nanoemMotionTrackDestroy(track);
+                }
+            }
+            else {
+                *ret = -1;
+            }
         }
     }
     return id;
@@ -1337,28 +1371,25 @@ nanoemMotionSetMaxFrameIndex(nanoem_motion_t *motion, const nanoem_motion_keyfra
     }
 }
 
-NANOEM_DECL_INLINE static kh_keyframe_map_t *
-nanoemMotionFindKeyframesMap(kh_motion_track_bundle_t *track_bundle, const nanoem_unicode_string_t *name, nanoem_unicode_string_factory_t *factory)
+NANOEM_DECL_INLINE static nanoem_motion_track_t *
+nanoemMotionTrackBundleFindTrack(const kh_motion_track_bundle_t *track_bundle, const nanoem_unicode_string_t *name, nanoem_unicode_string_factory_t *factory)
 {
-    nanoem_motion_track_t track;
-    kh_keyframe_map_t *keyframes_map = NULL;
+    nanoem_motion_track_t key, *track = NULL;
     khiter_t it;
     union nanoem_const_to_mutable_unicode_string_cast_t {
         const nanoem_unicode_string_t *s;
         nanoem_unicode_string_t *m;
     } u;
-    if (nanoem_is_not_null(name)) {
+    if (nanoem_is_not_null(track_bundle) && nanoem_is_not_null(name)) {
         u.s = name;
-        track.factory = factory;
-        track.name = u.m;
-        track.id = 0;
-        track.keyframes = NULL;
-        it = kh_get_motion_track_bundle(track_bundle, track);
+        key.factory = factory;
+        key.name = u.m;
+        it = kh_get_motion_track_bundle(track_bundle, &key);
         if (it != kh_end(track_bundle)) {
-            keyframes_map = kh_key(track_bundle, it).keyframes;
+            track = kh_key(track_bundle, it);
         }
     }
-    return keyframes_map;
+    return track;
 }
 
 NANOEM_DECL_INLINE static int
@@ -1376,23 +1407,122 @@ nanoemMotionCompareKeyframe(const void *a, const void *b)
     return left->frame_index - right->frame_index;
 }
 
+/* returns the first offset of keyframes whose frame index is not less than base_frame_index */
+NANOEM_DECL_INLINE static nanoem_rsize_t
+nanoemMotionKeyframeObjectArrayLowerBound(nanoem_motion_keyframe_object_t *const *keyframes, nanoem_rsize_t num_keyframes, nanoem_frame_index_t base_frame_index)
+{
+    nanoem_rsize_t low = 0, high = num_keyframes, mid;
+    while (low < high) {
+        mid = low + ((high - low) >> 1);
+        if (keyframes[mid]->frame_index < base_frame_index) {
+            low = mid + 1;
+        }
+        else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+/* keyframes must be ordered by frame index. next_keyframe is assigned the last keyframe if no keyframe is found after base_frame_index */
 static void
-nanoemMotionGetNearestKeyframes(nanoem_motion_keyframe_object_t *keyframe, nanoem_frame_index_t base_frame_index,
-    nanoem_frame_index_t *prev_nearest, nanoem_frame_index_t *next_nearest,
-    nanoem_motion_keyframe_object_t **prev_keyframe, nanoem_motion_keyframe_object_t **next_keyframe,
-    nanoem_motion_keyframe_object_t **last_keyframe)
+nanoemMotionKeyframeObjectArraySearchClosest(nanoem_motion_keyframe_object_t *const *keyframes, nanoem_rsize_t num_keyframes, nanoem_frame_index_t base_frame_index,
+    nanoem_motion_keyframe_object_t **prev_keyframe, nanoem_motion_keyframe_object_t **next_keyframe)
+{
+    nanoem_rsize_t offset;
+    if (num_keyframes > 0 && nanoem_is_not_null(keyframes)) {
+        offset = nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, base_frame_index);
+        if (prev_keyframe && offset > 0) {
+            *prev_keyframe = keyframes[nanoemMotionKeyframeObjectArrayLowerBound(keyframes, offset, keyframes[offset - 1]->frame_index)];
+        }
+        if (next_keyframe) {
+            while (offset < num_keyframes && keyframes[offset]->frame_index == base_frame_index) {
+                offset++;
+            }
+            if (offset >= num_keyframes) {
+                offset = nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, keyframes[num_keyframes - 1]->frame_index);
+            }
+            *next_keyframe = keyframes[offset];
+        }
+    }
+}
+
+/* steps from the last offset over at most NANOEM_MOTION_KEYFRAME_CURSOR_MAX_STEPS keyframes before the binary search */
+#define NANOEM_MOTION_KEYFRAME_CURSOR_MAX_STEPS 4
+
+/* returns the same offset as nanoemMotionKeyframeObjectArrayLowerBound and remembers it to the cursor */
+static nanoem_rsize_t
+nanoemMotionKeyframeCursorSeek(nanoem_motion_keyframe_cursor_t *cursor, nanoem_motion_keyframe_object_t *const *keyframes, nanoem_rsize_t num_keyframes, nanoem_frame_index_t base_frame_index)
 {
-    const nanoem_frame_index_t frame_index = keyframe->frame_index;
-    if (prev_keyframe && base_frame_index > frame_index && base_frame_index - *prev_nearest > base_frame_index - frame_index) {
-        *prev_nearest = frame_index;
-        *prev_keyframe = keyframe;
+    nanoem_rsize_t offset, num_steps = 0;
+    if (nanoem_is_null(cursor)) {
+        return nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, base_frame_index);
+    }
+    if (cursor->keyframes == keyframes && cursor->num_keyframes == num_keyframes && cursor->offset <= num_keyframes) {
+        offset = cursor->offset;
+        while (offset < num_keyframes && keyframes[offset]->frame_index < base_frame_index && num_steps < NANOEM_MOTION_KEYFRAME_CURSOR_MAX_STEPS) {
+            offset++;
+            num_steps++;
+        }
+        while (offset > 0 && keyframes[offset - 1]->frame_index >= base_frame_index && num_steps < NANOEM_MOTION_KEYFRAME_CURSOR_MAX_STEPS) {
+            offset--;
+            num_steps++;
+        }
+        /* verifies neighbors instead of trusting the cursor since keyframes may be replaced without changing the count */
+        if ((offset < num_keyframes && keyframes[offset]->frame_index < base_frame_index) || (offset > 0 && keyframes[offset - 1]->frame_index >= base_frame_index)) {
+            offset = nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, base_frame_index);
+        }
+    }
+    else {
+        offset = nanoemMotionKeyframeObjectArrayLowerBound(keyframes, num_keyframes, base_frame_index);
     }
-    else if (next_keyframe && base_frame_index < frame_index && *next_nearest - base_frame_index> frame_index - base_frame_index) {
-        *next_nearest = frame_index;
-        *next_keyframe = keyframe;
+    cursor->keyframes = keyframes;
+    cursor->num_keyframes = num_keyframes;
+    cursor->offset = offset;
+    return offset;
+}
+
+static nanoem_motion_keyframe_object_t *
+nanoemMotionKeyframeObjectArrayFindWithCursor(nanoem_motion_keyframe_cursor_t *cursor, nanoem_motion_keyframe_object_t *const *keyframes, nanoem_rsize_t num_keyframes, nanoem_frame_index_t frame_index)
+{
+    nanoem_motion_keyframe_object_t *keyframe = NULL;
+    nanoem_rsize_t offset;
+    if (num_keyframes > 0 && nanoem_is_not_null(keyframes)) {
+        offset = nanoemMotionKeyframeCursorSeek(cursor, keyframes, num_keyframes, frame_index);
+        if (offset < num_keyframes && keyframes[offset]->frame_index == frame_index) {
+            keyframe = keyframes[offset];
+        }
     }
-    if (!*last_keyframe || (*last_keyframe && frame_index > (*last_keyframe)->frame_index)) {
-        *last_keyframe = keyframe;
+    return keyframe;
+}
+
+/* same as nanoemMotionKeyframeObjectArraySearchClosest but steps over keyframes at the same frame index linearly */
+static void
+nanoemMotionKeyframeObjectArraySearchClosestWithCursor(nanoem_motion_keyframe_cursor_t *cursor, nanoem_motion_keyframe_object_t *const *keyframes, nanoem_rsize_t num_keyframes, nanoem_frame_index_t base_frame_index,
+    nanoem_motion_keyframe_object_t **prev_keyframe, nanoem_motion_keyframe_object_t **next_keyframe)
+{
+    nanoem_rsize_t offset, prev_offset;
+    if (num_keyframes > 0 && nanoem_is_not_null(keyframes)) {
+        offset = nanoemMotionKeyframeCursorSeek(cursor, keyframes, num_keyframes, base_frame_index);
+        if (prev_keyframe && offset > 0) {
+            prev_offset = offset - 1;
+            while (prev_offset > 0 && keyframes[prev_offset - 1]->frame_index == keyframes[prev_offset]->frame_index) {
+                prev_offset--;
+            }
+            *prev_keyframe = keyframes[prev_offset];
+        }
+        if (next_keyframe) {
+            while (offset < num_keyframes && keyframes[offset]->frame_index == base_frame_index) {
+                offset++;
+            }
+            if (offset >= num_keyframes) {
+                offset = num_keyframes - 1;
+                while (offset > 0 && keyframes[offset - 1]->frame_index == keyframes[offset]->frame_index) {
+                    offset--;
+                }
+            }
+            *next_keyframe = keyframes[offset];
+        }
     }
 }
 
@@ -203,3 +203,153 @@ TEST_CASE("mutable_bone_keyframe_generate_nmd", "[nanoem]")
         CHECK(nanoemMotionBoneKeyframeIsPhysicsSimulationEnabled(generated_keyframe) == nanoem_false);
     }
 }
+
+TEST_CASE("mutable_bone_keyframe_search_closest", "[nanoem]")
+{
+    static const nanoem_frame_index_t frame_indices[] = { 30, 10, 50, 20, 40 };
+    MotionScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutable_motion = scope.newMotion();
+    nanoem_motion_t *origin = nanoemMutableMotionGetOriginObject(mutable_motion);
+    nanoem_unicode_string_t *name = scope.newString("bone_keyframe");
+    nanoem_unicode_string_t *other_name = scope.newString("other_bone_keyframe");
+    nanoem_mutable_motion_bone_keyframe_t *keyframes[5];
+    for (int i = 0; i < 5; i++) {
+        keyframes[i] = scope.newBoneKeyframe();
+        nanoemMutableMotionAddBoneKeyframe(mutable_motion, keyframes[i], name, frame_indices[i], &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+    }
+    nanoemMutableMotionAddBoneKeyframe(mutable_motion, scope.newBoneKeyframe(), other_name, 25, &status);
+    CHECK(status == NANOEM_STATUS_SUCCESS);
+    nanoem_motion_bone_keyframe_t *prev_keyframe, *next_keyframe;
+    SECTION("keyframes should be searched in order of frame index")
+    {
+        nanoemMotionSearchClosestBoneKeyframes(origin, name, 25, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[3]));
+        CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[0]));
+        nanoemMotionSearchClosestBoneKeyframes(origin, name, 30, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[3]));
+        CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[4]));
+        nanoemMotionSearchClosestBoneKeyframes(origin, name, 5, &prev_keyframe, &next_keyframe);
+        CHECK_FALSE(prev_keyframe);
+        CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[1]));
+        nanoemMotionSearchClosestBoneKeyframes(origin, name, 60, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[2]));
+        CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[2]));
+        CHECK(nanoemMotionFindBoneKeyframeObject(origin, name, 40) ==
+            nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[4]));
+        CHECK_FALSE(nanoemMotionFindBoneKeyframeObject(origin, name, 25));
+    }
+    SECTION("removed keyframe should not be searched")
+    {
+        nanoemMutableMotionRemoveBoneKeyframe(mutable_motion, keyframes[0], &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+        nanoemMotionSearchClosestBoneKeyframes(origin, name, 25, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[3]));
+        CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframes[4]));
+        CHECK_FALSE(nanoemMotionFindBoneKeyframeObject(origin, name, 30));
+    }
+}
+
+TEST_CASE("mutable_bone_keyframe_resolve_track", "[nanoem]")
+{
+    MotionScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutable_motion = scope.newMotion();
+    nanoem_motion_t *origin = nanoemMutableMotionGetOriginObject(mutable_motion);
+    nanoem_unicode_string_t *name = scope.newString("bone_keyframe");
+    nanoem_unicode_string_t *other_name = scope.newString("other_bone_keyframe");
+    CHECK_FALSE(nanoemMotionResolveBoneTrack(origin, name));
+    CHECK(nanoemMotionGetNumBoneTracks(origin) == 0);
+    nanoem_mutable_motion_bone_keyframe_t *keyframe0 = scope.newBoneKeyframe(), *keyframe1 = scope.newBoneKeyframe();
+    nanoemMutableMotionAddBoneKeyframe(mutable_motion, keyframe0, name, 10, &status);
+    CHECK(status == NANOEM_STATUS_SUCCESS);
+    const nanoem_motion_track_t *track = nanoemMotionResolveBoneTrack(origin, name);
+    CHECK(track);
+    CHECK(nanoemMotionGetNumBoneTracks(origin) == 1);
+    CHECK_FALSE(nanoemMotionResolveBoneTrack(origin, other_name));
+    CHECK_FALSE(nanoemMotionResolveMorphTrack(origin, name));
+    nanoemMutableMotionAddBoneKeyframe(mutable_motion, keyframe1, name, 20, &status);
+    CHECK(status == NANOEM_STATUS_SUCCESS);
+    nanoemMutableMotionAddBoneKeyframe(mutable_motion, scope.newBoneKeyframe(), other_name, 15, &status);
+    CHECK(status == NANOEM_STATUS_SUCCESS);
+    CHECK(nanoemMotionGetNumBoneTracks(origin) == 2);
+    /* resolved track should be kept even if another track is created */
+    CHECK(nanoemMotionResolveBoneTrack(origin, name) == track);
+    CHECK(nanoemMotionTrackFindBoneKeyframeObject(track, 10) ==
+        nanoemMutableMotionBoneKeyframeGetOriginObject(keyframe0));
+    CHECK_FALSE(nanoemMotionTrackFindBoneKeyframeObject(track, 15));
+    nanoem_motion_bone_keyframe_t *prev_keyframe, *next_keyframe;
+    nanoemMotionTrackSearchClosestBoneKeyframes(track, 15, &prev_keyframe, &next_keyframe);
+    CHECK(prev_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframe0));
+    CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframe1));
+    nanoemMotionTrackSearchClosestBoneKeyframes(NULL, 15, &prev_keyframe, &next_keyframe);
+    CHECK_FALSE(prev_keyframe);
+    CHECK_FALSE(next_keyframe);
+    CHECK_FALSE(nanoemMotionTrackFindBoneKeyframeObject(NULL, 10));
+}
+
+TEST_CASE("mutable_bone_keyframe_search_closest_with_cursor", "[nanoem]")
+{
+    MotionScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutable_motion = scope.newMotion();
+    nanoem_motion_t *origin = nanoemMutableMotionGetOriginObject(mutable_motion);
+    nanoem_unicode_string_t *name = scope.newString("bone_keyframe");
+    for (nanoem_frame_index_t i = 0; i < 32; i++) {
+        nanoemMutableMotionAddBoneKeyframe(mutable_motion, scope.newBoneKeyframe(), name, i * 7 + (i % 3), &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+    }
+    const nanoem_motion_track_t *track = nanoemMotionResolveBoneTrack(origin, name);
+    REQUIRE(track);
+    nanoem_motion_keyframe_cursor_t cursor;
+    nanoemMotionKeyframeCursorReset(&cursor);
+    nanoem_motion_bone_keyframe_t *prev_keyframe, *next_keyframe, *expected_prev_keyframe, *expected_next_keyframe;
+    /* forward, backward and then seeking should be same as the search without the cursor */
+    static const nanoem_frame_index_t seek_indices[] = { 3, 200, 1, 150, 151, 20, 0, 300 };
+    nanoem_frame_index_t frame_indices[512];
+    nanoem_rsize_t num_frame_indices = 0;
+    for (nanoem_frame_index_t i = 0; i < 240; i++) {
+        frame_indices[num_frame_indices++] = i;
+    }
+    for (nanoem_frame_index_t i = 240; i > 0; i--) {
+        frame_indices[num_frame_indices++] = i - 1;
+    }
+    for (size_t i = 0; i < sizeof(seek_indices) / sizeof(seek_indices[0]); i++) {
+        frame_indices[num_frame_indices++] = seek_indices[i];
+    }
+    for (nanoem_rsize_t i = 0; i < num_frame_indices; i++) {
+        const nanoem_frame_index_t frame_index = frame_indices[i];
+        nanoemMotionTrackSearchClosestBoneKeyframes(track, frame_index, &expected_prev_keyframe, &expected_next_keyframe);
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, &cursor, frame_index, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == expected_prev_keyframe);
+        CHECK(next_keyframe == expected_next_keyframe);
+        CHECK(nanoemMotionTrackFindBoneKeyframeObjectWithCursor(track, &cursor, frame_index) ==
+            nanoemMotionTrackFindBoneKeyframeObject(track, frame_index));
+    }
+    SECTION("after the keyframes are changed")
+    {
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, &cursor, 100, &prev_keyframe, &next_keyframe);
+        nanoem_mutable_motion_bone_keyframe_t *keyframe = scope.newBoneKeyframe();
+        nanoemMutableMotionAddBoneKeyframe(mutable_motion, keyframe, name, 101, &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, &cursor, 100, &prev_keyframe, &next_keyframe);
+        CHECK(next_keyframe == nanoemMutableMotionBoneKeyframeGetOriginObject(keyframe));
+        nanoemMutableMotionRemoveBoneKeyframe(mutable_motion, keyframe, &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+        nanoemMotionTrackSearchClosestBoneKeyframes(track, 100, &expected_prev_keyframe, &expected_next_keyframe);
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, &cursor, 100, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == expected_prev_keyframe);
+        CHECK(next_keyframe == expected_next_keyframe);
+    }
+    SECTION("null track and cursor")
+    {
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(NULL, &cursor, 15, &prev_keyframe, &next_keyframe);
+        CHECK_FALSE(prev_keyframe);
+        CHECK_FALSE(next_keyframe);
+        nanoemMotionTrackSearchClosestBoneKeyframes(track, 15, &expected_prev_keyframe, &expected_next_keyframe);
+        nanoemMotionTrackSearchClosestBoneKeyframesWithCursor(track, NULL, 15, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == expected_prev_keyframe);
+        CHECK(next_keyframe == expected_next_keyframe);
+    }
+}
@@ -202,3 +202,90 @@ TEST_CASE("mutable_camera_keyframe_generate_nmd", "[nanoem]")
         CHECK(nanoemMotionCameraKeyframeIsPerspectiveView(generated_keyframe));
     }
 }
+
+TEST_CASE("mutable_camera_keyframe_search_closest", "[nanoem]")
+{
+    static const nanoem_frame_index_t frame_indices[] = { 30, 10, 50, 20, 40 };
+    MotionScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutable_motion = scope.newMotion();
+    nanoem_motion_t *origin = nanoemMutableMotionGetOriginObject(mutable_motion);
+    nanoem_mutable_motion_camera_keyframe_t *keyframes[5];
+    for (int i = 0; i < 5; i++) {
+        keyframes[i] = scope.newCameraKeyframe();
+        nanoemMutableMotionAddCameraKeyframe(mutable_motion, keyframes[i], frame_indices[i], &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+    }
+    nanoem_motion_camera_keyframe_t *prev_keyframe, *next_keyframe;
+    nanoemMotionSearchClosestCameraKeyframes(origin, 25, &prev_keyframe, &next_keyframe);
+    CHECK(prev_keyframe == nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[3]));
+    CHECK(next_keyframe == nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[0]));
+    nanoemMotionSearchClosestCameraKeyframes(origin, 40, &prev_keyframe, &next_keyframe);
+    CHECK(prev_keyframe == nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[0]));
+    CHECK(next_keyframe == nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[2]));
+    nanoemMotionSearchClosestCameraKeyframes(origin, 99, &prev_keyframe, &next_keyframe);
+    CHECK(prev_keyframe == nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[2]));
+    CHECK(next_keyframe == nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[2]));
+    CHECK(nanoemMotionFindCameraKeyframeObject(origin, 20) ==
+        nanoemMutableMotionCameraKeyframeGetOriginObject(keyframes[3]));
+}
+
+TEST_CASE("mutable_camera_keyframe_search_closest_nmd", "[nanoem]")
+{
+    static const nanoem_frame_index_t frame_indices[] = { 30, 10, 50, 20, 40 };
+    MotionScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_buffer_t *mutable_buffer = scope.newBuffer();
+    {
+        nanoem_mutable_motion_t *mutable_motion = scope.newMotion();
+        for (int i = 0; i < 5; i++) {
+            nanoem_mutable_motion_camera_keyframe_t *keyframe = scope.newCameraKeyframe();
+            nanoemMutableMotionCameraKeyframeSetDistance(keyframe, nanoem_f32_t(frame_indices[i]));
+            nanoemMutableMotionAddCameraKeyframe(mutable_motion, keyframe, frame_indices[i], &status);
+            CHECK(status == NANOEM_STATUS_SUCCESS);
+        }
+        nanoemMutableMotionSaveToBufferNMD(mutable_motion, mutable_buffer, &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+    }
+    nanoem_motion_t *new_motion = nanoemMutableMotionGetOriginObject(scope.newMotion());
+    nanoem_buffer_t *buffer = scope.newBuffer(mutable_buffer);
+    nanoemMotionLoadFromBufferNMD(new_motion, buffer, 0, &status);
+    CHECK(status == NANOEM_STATUS_SUCCESS);
+    nanoem_rsize_t num_keyframes;
+    nanoem_motion_camera_keyframe_t *const *keyframes = nanoemMotionGetAllCameraKeyframeObjects(new_motion, &num_keyframes);
+    REQUIRE(num_keyframes == 5);
+    for (nanoem_rsize_t i = 1; i < num_keyframes; i++) {
+        CHECK(nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(keyframes[i - 1])) <
+            nanoemMotionKeyframeObjectGetFrameIndex(nanoemMotionCameraKeyframeGetKeyframeObject(keyframes[i])));
+    }
+    nanoem_motion_camera_keyframe_t *prev_keyframe, *next_keyframe;
+    nanoemMotionSearchClosestCameraKeyframes(new_motion, 25, &prev_keyframe, &next_keyframe);
+    REQUIRE(prev_keyframe);
+    REQUIRE(next_keyframe);
+    CHECK(nanoemMotionCameraKeyframeGetDistance(prev_keyframe) == Approx(20));
+    CHECK(nanoemMotionCameraKeyframeGetDistance(next_keyframe) == Approx(30));
+}
+
+TEST_CASE("mutable_camera_keyframe_search_closest_with_cursor", "[nanoem]")
+{
+    static const nanoem_frame_index_t frame_indices[] = { 30, 10, 50, 20, 40 };
+    MotionScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    nanoem_mutable_motion_t *mutable_motion = scope.newMotion();
+    nanoem_motion_t *origin = nanoemMutableMotionGetOriginObject(mutable_motion);
+    for (int i = 0; i < 5; i++) {
+        nanoemMutableMotionAddCameraKeyframe(mutable_motion, scope.newCameraKeyframe(), frame_indices[i], &status);
+        CHECK(status == NANOEM_STATUS_SUCCESS);
+    }
+    nanoem_motion_keyframe_cursor_t cursor;
+    nanoemMotionKeyframeCursorReset(&cursor);
+    nanoem_motion_camera_keyframe_t *prev_keyframe, *next_keyframe, *expected_prev_keyframe, *expected_next_keyframe;
+    for (nanoem_frame_index_t i = 0; i < 60; i++) {
+        nanoemMotionSearchClosestCameraKeyframes(origin, i, &expected_prev_keyframe, &expected_next_keyframe);
+        nanoemMotionSearchClosestCameraKeyframesWithCursor(origin, &cursor, i, &prev_keyframe, &next_keyframe);
+        CHECK(prev_keyframe == expected_prev_keyframe);
+        CHECK(next_keyframe == expected_next_keyframe);
+        CHECK(nanoemMotionFindCameraKeyframeObjectWithCursor(origin, &cursor, i) ==
+            nanoemMotionFindCameraKeyframeObject(origin, i));
+    }
+}
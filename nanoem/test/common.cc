@@ -928,7 +928,7 @@ ModelScope::copyJoint(nanoem_model_format_type_t format, size_t offset)
 }
 
 void
-ModelScope::copy(nanoem_model_format_type_t format)
+ModelScope::copy(nanoem_model_format_type_t format, bool arena)
 {
     nanoem_status_t status = NANOEM_STATUS_SUCCESS;
     nanoem_mutable_buffer_t *mutable_buffer = nanoemMutableBufferCreate(&status);
@@ -938,6 +938,7 @@ ModelScope::copy(nanoem_model_format_type_t format)
     assert(status == NANOEM_STATUS_SUCCESS);
     nanoemModelDestroy(m_copy);
     m_copy = nanoemModelCreate(m_factory, &status);
+    nanoemModelSetArenaEnabled(m_copy, arena);
     nanoem_buffer_t *buffer = nanoemMutableBufferCreateBufferObject(mutable_buffer, &status);
     nanoemModelLoadFromBuffer(m_copy, buffer, &status);
     nanoemMutableBufferDestroy(mutable_buffer);
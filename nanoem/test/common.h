@@ -247,7 +247,7 @@ public:
         nanoem_model_format_type_t format = NANOEM_MODEL_FORMAT_TYPE_PMX_2_0, size_t offset = 0);
     const nanoem_model_joint_t *copyJoint(
         nanoem_model_format_type_t format = NANOEM_MODEL_FORMAT_TYPE_PMX_2_0, size_t offset = 0);
-    void copy(nanoem_model_format_type_t format);
+    void copy(nanoem_model_format_type_t format, bool arena = false);
 
     nanoem_mutable_model_t *currentModel();
     nanoem_model_t *origin();
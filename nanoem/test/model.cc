@@ -114,3 +114,46 @@ TEST_CASE("mutable_model_copy_name", "[nanoem]")
         }
     }
 }
+
+TEST_CASE("model_arena_load_and_remove", "[nanoem]")
+{
+    ModelScope scope;
+    nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+    scope.newModel();
+    for (int i = 0; i < 4; i++) {
+        const nanoem_f32_t origin[] = { nanoem_f32_t(i), 0, 0, 0 };
+        nanoemMutableModelVertexSetOrigin(scope.appendedVertex(), origin);
+    }
+    static const nanoem_u32_t kVertexIndices[] = { 0, 1, 2, 1, 2, 3 };
+    nanoemMutableModelSetVertexIndices(scope.currentModel(), kVertexIndices, 6, &status);
+    scope.appendedBone("bone0");
+    scope.appendedBone("bone1");
+    scope.copy(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0, true);
+    nanoem_model_t *model = scope.reference();
+    CHECK(nanoemModelIsArenaEnabled(model));
+    nanoem_rsize_t num_vertices, num_bones;
+    nanoem_model_vertex_t *const *vertices = nanoemModelGetAllVertexObjects(model, &num_vertices);
+    nanoem_model_bone_t *const *bones = nanoemModelGetAllBoneObjects(model, &num_bones);
+    REQUIRE(num_vertices == 4);
+    REQUIRE(num_bones == 2);
+    for (nanoem_rsize_t i = 0; i < num_vertices; i++) {
+        CHECK(nanoemModelVertexGetOrigin(vertices[i])[0] == Approx(i));
+        if (i > 0) {
+            /* vertices are carved from the same slab block in order */
+            CHECK(vertices[i - 1] < vertices[i]);
+        }
+    }
+    CHECK(bones[0] < bones[1]);
+    CHECK_THAT(scope.describe(nanoemModelBoneGetName(bones[1], NANOEM_LANGUAGE_TYPE_FIRST_ENUM)),
+        Catch::Equals("bone1"));
+    /* the removed vertex must outlive the model */
+    nanoem_mutable_model_t *mutable_model = nanoemMutableModelCreateAsReference(model, &status);
+    nanoem_mutable_model_vertex_t *mutable_vertex = nanoemMutableModelVertexCreateAsReference(vertices[1], &status);
+    nanoemMutableModelRemoveVertexObject(mutable_model, mutable_vertex, &status);
+    CHECK(status == NANOEM_STATUS_SUCCESS);
+    nanoemMutableModelDestroy(mutable_model);
+    scope.copy(NANOEM_MODEL_FORMAT_TYPE_PMX_2_0);
+    CHECK_FALSE(nanoemModelIsArenaEnabled(scope.reference()));
+    CHECK(nanoemModelVertexGetOrigin(nanoemMutableModelVertexGetOriginObject(mutable_vertex))[0] == Approx(1));
+    nanoemMutableModelVertexDestroy(mutable_vertex);
+}
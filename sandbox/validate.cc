@@ -11,8 +11,22 @@
 #include "nanodxm/nanodxm.h"
 
 #include <errno.h>
+#include <stdarg.h>
 #include <stdio.h>
 #include <string.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
 
 NANOEM_DECL_API nanoem_unicode_string_factory_t *APIENTRY nanoemUnicodeStringFactoryCreateEXT(nanoem_status_t *status);
 NANOEM_DECL_API void APIENTRY nanoemUnicodeStringFactoryDestroyEXT(nanoem_unicode_string_factory_t *factory);
@@ -280,6 +294,17 @@ stringify_nanodxm_status(nanodxm_status_t code)
     }
 }
 
+static void
+report(std::string &output, const char *format, ...)
+{
+    char buffer[1024];
+    va_list ap;
+    va_start(ap, format);
+    vsnprintf(buffer, sizeof(buffer), format, ap);
+    va_end(ap);
+    output.append(buffer);
+}
+
 static bool
 slurpFile(const char *path, nanoem_u8_t *&data, size_t &size)
 {
@@ -297,7 +322,7 @@ slurpFile(const char *path, nanoem_u8_t *&data, size_t &size)
 }
 
 static void
-validateModel(nanoem_unicode_string_factory_t *factory, const char *path)
+validateModel(nanoem_unicode_string_factory_t *factory, const char *path, std::string &output)
 {
     nanoem_u8_t *data = 0;
     size_t size = 0;
@@ -306,10 +331,10 @@ validateModel(nanoem_unicode_string_factory_t *factory, const char *path)
         nanoem_model_t *model = nanoemModelCreate(factory, &status);
         nanoem_buffer_t *buffer = nanoemBufferCreate(data, size, &status);
         if (nanoemModelLoadFromBuffer(model, buffer, &status)) {
-            fprintf(stdout, "[OK] %s loaded successfully\n", path);
+            report(output, "[OK] %s loaded successfully\n", path);
         }
         else {
-            fprintf(stdout, "[NG] %s cannot be loaded: %s\n", path, stringify_nanoem_status(status));
+            report(output, "[NG] %s cannot be loaded: %s\n", path, stringify_nanoem_status(status));
         }
         if (const char *p = strrchr(path, '.')) {
             if (strcmp(p, ".pmd") == 0) {
@@ -318,10 +343,10 @@ validateModel(nanoem_unicode_string_factory_t *factory, const char *path)
                 nanoem_mutable_model_t *converted =
                     nanoemModelConverterExecute(converter, NANOEM_MODEL_FORMAT_TYPE_PMX_2_0, &mutable_status);
                 if (mutable_status == NANOEM_STATUS_SUCCESS) {
-                    fprintf(stdout, "[OK] %s loaded successfully\n", path);
+                    report(output, "[OK] %s loaded successfully\n", path);
                 }
                 else {
-                    fprintf(stdout, "[NG] %s cannot be converted: %s\n", path,
+                    report(output, "[NG] %s cannot be converted: %s\n", path,
                         stringify_nanoem_mutable_status(mutable_status));
                 }
                 nanoemMutableModelDestroy(converted);
@@ -333,12 +358,12 @@ validateModel(nanoem_unicode_string_factory_t *factory, const char *path)
         delete[] data;
     }
     else {
-        fprintf(stdout, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
+        report(output, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
     }
 }
 
 static void
-validateMotion(nanoem_unicode_string_factory_t *factory, const char *path)
+validateMotion(nanoem_unicode_string_factory_t *factory, const char *path, std::string &output)
 {
     nanoem_u8_t *data = 0;
     size_t size = 0;
@@ -347,22 +372,22 @@ validateMotion(nanoem_unicode_string_factory_t *factory, const char *path)
         nanoem_motion_t *motion = nanoemMotionCreate(factory, &status);
         nanoem_buffer_t *buffer = nanoemBufferCreate(data, size, &status);
         if (nanoemMotionLoadFromBuffer(motion, buffer, 0, &status)) {
-            fprintf(stdout, "[OK] %s loaded successfully\n", path);
+            report(output, "[OK] %s loaded successfully\n", path);
         }
         else {
-            fprintf(stdout, "[NG] %s cannot be loaded: %s\n", path, stringify_nanoem_status(status));
+            report(output, "[NG] %s cannot be loaded: %s\n", path, stringify_nanoem_status(status));
         }
         nanoemBufferDestroy(buffer);
         nanoemMotionDestroy(motion);
         delete[] data;
     }
     else {
-        fprintf(stdout, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
+        report(output, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
     }
 }
 
 static void
-validateDocument(nanoem_unicode_string_factory_t *factory, const char *path)
+validateDocument(nanoem_unicode_string_factory_t *factory, const char *path, std::string &output)
 {
     nanoem_u8_t *data = 0;
     size_t size = 0;
@@ -371,22 +396,22 @@ validateDocument(nanoem_unicode_string_factory_t *factory, const char *path)
         nanoem_document_t *document = nanoemDocumentCreate(factory, &status);
         nanoem_buffer_t *buffer = nanoemBufferCreate(data, size, &status);
         if (nanoemDocumentLoadFromBuffer(document, buffer, &status)) {
-            fprintf(stdout, "[OK] %s loaded successfully\n", path);
+            report(output, "[OK] %s loaded successfully\n", path);
         }
         else {
-            fprintf(stdout, "[NG] %s cannot be loaded: %s\n", path, stringify_nanoem_status(status));
+            report(output, "[NG] %s cannot be loaded: %s\n", path, stringify_nanoem_status(status));
         }
         nanoemBufferDestroy(buffer);
         nanoemDocumentDestroy(document);
         delete[] data;
     }
     else {
-        fprintf(stdout, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
+        report(output, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
     }
 }
 
 static void
-validateAccessory(const char *path)
+validateAccessory(const char *path, std::string &output)
 {
     nanoem_u8_t *data = 0;
     size_t size = 0;
@@ -395,35 +420,35 @@ validateAccessory(const char *path)
         nanodxm_buffer_t *buffer = nanodxmBufferCreate(data, size);
         nanodxm_status_t status = nanodxmDocumentParse(document, buffer);
         if (status == NANODXM_STATUS_SUCCESS) {
-            fprintf(stdout, "[OK] %s loaded successfully\n", path);
+            report(output, "[OK] %s loaded successfully\n", path);
         }
         else {
-            fprintf(stdout, "[NG] %s cannot be loaded: %s\n", path, stringify_nanodxm_status(status));
+            report(output, "[NG] %s cannot be loaded: %s\n", path, stringify_nanodxm_status(status));
         }
         nanodxmBufferDestroy(buffer);
         nanodxmDocumentDestroy(document);
         delete[] data;
     }
     else {
-        fprintf(stdout, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
+        report(output, "[NG] %s cannot be opened: %s\n", path, strerror(errno));
     }
 }
 
 static void
-processFile(nanoem_unicode_string_factory_t *factory, const char *path)
+processFile(nanoem_unicode_string_factory_t *factory, const char *path, std::string &output)
 {
     if (const char *p = strrchr(path, '.')) {
         if (strcmp(p, ".pmd") == 0 || strcmp(p, ".pmx") == 0) {
-            validateModel(factory, path);
+            validateModel(factory, path, output);
         }
         else if (strcmp(p, ".vmd") == 0) {
-            validateMotion(factory, path);
+            validateMotion(factory, path, output);
         }
         else if (strcmp(p, ".pmm") == 0) {
-            validateDocument(factory, path);
+            validateDocument(factory, path, output);
         }
         else if (strcmp(p, ".x") == 0) {
-            validateAccessory(path);
+            validateAccessory(path, output);
         }
     }
 }
@@ -436,12 +461,81 @@ validateAllFiles(nanoem_unicode_string_factory_t *factory, const char *path)
         while (!feof(fp)) {
             fgets(buffer, sizeof(buffer), fp);
             buffer[strcspn(buffer, "\r\n")] = 0;
-            processFile(factory, buffer);
+            std::string output;
+            processFile(factory, buffer, output);
+            fputs(output.c_str(), stdout);
         }
         fclose(fp);
     }
 }
 
+static bool
+isDirectory(const char *path)
+{
+    struct stat st;
+    return stat(path, &st) == 0 && (st.st_mode & S_IFMT) == S_IFDIR;
+}
+
+static void
+listAllFiles(const char *path, std::vector<std::string> &filePaths)
+{
+#if defined(_WIN32)
+    WIN32_FIND_DATAA data;
+    const std::string pattern(std::string(path) + "\\*");
+    HANDLE handle = FindFirstFileA(pattern.c_str(), &data);
+    if (handle != INVALID_HANDLE_VALUE) {
+        do {
+            if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0) {
+                filePaths.push_back(std::string(path) + "\\" + data.cFileName);
+            }
+        } while (FindNextFileA(handle, &data));
+        FindClose(handle);
+    }
+#else
+    if (DIR *dir = opendir(path)) {
+        while (const struct dirent *entry = readdir(dir)) {
+            const std::string filePath(std::string(path) + "/" + entry->d_name);
+            if (entry->d_name[0] != '.' && !isDirectory(filePath.c_str())) {
+                filePaths.push_back(filePath);
+            }
+        }
+        closedir(dir);
+    }
+#endif
+    /* readdir order depends on the filesystem so sort to make the report reproducible */
+    std::sort(filePaths.begin(), filePaths.end());
+}
+
+static void
+validateDirectory(const char *path)
+{
+    std::vector<std::string> filePaths;
+    listAllFiles(path, filePaths);
+    std::vector<std::string> outputs(filePaths.size());
+    std::atomic<size_t> next(0);
+    const size_t numThreads = std::max(std::min(size_t(std::thread::hardware_concurrency()), filePaths.size()),
+        size_t(1));
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; i++) {
+        threads.push_back(std::thread([&filePaths, &outputs, &next]() {
+            /* each worker owns its factory since the converter state is not shared safely across threads */
+            nanoem_status_t status = NANOEM_STATUS_SUCCESS;
+            nanoem_unicode_string_factory_t *factory = nanoemUnicodeStringFactoryCreateEXT(&status);
+            for (size_t index = next++; index < filePaths.size(); index = next++) {
+                processFile(factory, filePaths[index].c_str(), outputs[index]);
+            }
+            nanoemUnicodeStringFactoryDestroyEXT(factory);
+        }));
+    }
+    for (std::vector<std::thread>::iterator it = threads.begin(), end = threads.end(); it != end; ++it) {
+        it->join();
+    }
+    /* printed in the sorted order regardless of which worker finished first */
+    for (std::vector<std::string>::const_iterator it = outputs.begin(), end = outputs.end(); it != end; ++it) {
+        fputs(it->c_str(), stdout);
+    }
+}
+
 static void
 parsePortableFloatMap(const char *path)
 {
@@ -469,7 +563,10 @@ main(int argc, char *argv[])
 {
     if (argc > 1) {
         const char *path = argv[1];
-        if (const char *p = strrchr(path, '.')) {
+        if (isDirectory(path)) {
+            validateDirectory(path);
+        }
+        else if (const char *p = strrchr(path, '.')) {
             nanoem_status_t status = NANOEM_STATUS_SUCCESS;
             nanoem_unicode_string_factory_t *factory = nanoemUnicodeStringFactoryCreateEXT(&status);
             if (strcmp(p, ".txt") == 0) {
@@ -479,13 +576,15 @@ main(int argc, char *argv[])
                 parsePortableFloatMap(path);
             }
             else {
-                processFile(factory, path);
+                std::string output;
+                processFile(factory, path, output);
+                fputs(output.c_str(), stdout);
             }
             nanoemUnicodeStringFactoryDestroyEXT(factory);
         }
     }
     else {
-        fprintf(stdout, "usage: %s [model_list_path] [motion_list_path]\n", argv[0]);
+        fprintf(stdout, "usage: %s [model_list_path|model_directory_path] [motion_list_path]\n", argv[0]);
     }
     return 0;
 }
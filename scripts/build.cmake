@@ -122,6 +122,7 @@ function(compile_bullet _cmake_build_type _generator _toolset_option _arch_optio
                                            -DUSE_GRAPHICAL_BENCHMARK=OFF
                                            -DUSE_MSVC_INCREMENTAL_LINKING=OFF
                                            -DUSE_MSVC_RUNTIME_LIBRARY_DLL=OFF
+                                           -DCMAKE_PROJECT_BULLET_PHYSICS_INCLUDE=${CMAKE_CURRENT_SOURCE_DIR}/cmake/bullet-no-profile.cmake
                                            -DCMAKE_BUILD_TYPE=${_cmake_build_type}
                                            -DCMAKE_CONFIGURATION_TYPES=${_cmake_build_type}
                                            -DCMAKE_INSTALL_PREFIX=${_build_path}/install-root